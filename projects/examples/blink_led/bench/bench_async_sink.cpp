@@ -0,0 +1,150 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_sink.h"
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "tick_jitter.h"
+
+/**
+ * @brief Tick-time cost of trace output through each async_sink backend
+ *
+ * Runs a 1 kHz tick loop over a bank of controllers that writes one trace
+ * line per channel per tick, and records how long each tick's work took
+ * (update + trace + flush/poll). Two destinations:
+ * - file: a regular file (default /tmp; pass a directory on a real disk)
+ * - slow: a pipe whose reader stalls periodically, standing in for a slow disk
+ *
+ * Usage: bench_async_sink [seconds_per_run] [--dir PATH]
+ */
+struct null_pin {
+    void set(bool state) { do_not_optimize(state); }
+};
+
+static std::size_t const CHANNELS = 16;
+
+// Drains the pipe every 10 ms but stalls for 500 ms once a second, like a
+// disk during writeback: a writer that fills the 64 KB pipe waits it out
+static void stalling_reader(int fd, std::atomic<bool> const& stop) {
+    ::fcntl(fd, F_SETFL, O_NONBLOCK);
+    char buffer[4096];
+    for (uint32_t round = 0; !stop.load(std::memory_order_relaxed); ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(round % 100 == 99 ? 500 : 10));
+        while (::read(fd, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+}
+
+struct run_result {
+    tick_jitter_histogram tick_time;
+    uint64_t bytes_written;
+    uint64_t bytes_dropped;
+};
+
+static void measure(int fd, sink_backend backend, uint32_t seconds, run_result& result) {
+    null_pin pin;
+    std::vector<blink_controller<null_pin> > controllers;
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        controllers.push_back(blink_controller<null_pin>(pin, 50 + i, 25 + i));
+    }
+
+    async_sink sink;
+    if (!sink.open(fd, backend)) {
+        std::printf("  (%s unavailable)\n", sink_backend_name(backend));
+        return;
+    }
+
+    result.tick_time.reset();
+    periodic_ticker ticker(std::chrono::milliseconds(1));
+    uint32_t const ticks = seconds * 1000;
+    char line[64];
+    for (uint32_t t = 0; t < ticks; ++t) {
+        ticker.wait_next();
+        periodic_ticker::clock::time_point const start = periodic_ticker::clock::now();
+        for (std::size_t i = 0; i < CHANNELS; ++i) {
+            controllers[i].update(t);
+            int const length = std::snprintf(line, sizeof(line), "%u,%u,%u\n", t,
+                                             static_cast<unsigned>(i),
+                                             controllers[i].is_on() ? 1u : 0u);
+            sink.write(line, static_cast<std::size_t>(length));
+        }
+        sink.flush();
+        result.tick_time.record(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(periodic_ticker::clock::now() -
+                                                                  start)
+                .count()));
+    }
+    sink.close();
+    result.bytes_written = sink.get_bytes_written();
+    result.bytes_dropped = sink.get_bytes_dropped();
+}
+
+static void print_row(char const* target, sink_backend backend, run_result const& result) {
+    tick_jitter_histogram const& h = result.tick_time;
+    std::printf("%-6s %-10s %8.1f %8u %8u %8u %10llu %10llu\n", target, sink_backend_name(backend),
+                h.get_mean_us(), h.percentile_us(50.0), h.percentile_us(99.0), h.get_max_us(),
+                static_cast<unsigned long long>(result.bytes_written / 1024),
+                static_cast<unsigned long long>(result.bytes_dropped / 1024));
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = 3;
+    std::string dir = "/tmp";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            seconds = static_cast<uint32_t>(std::atoi(argv[i]));
+        }
+    }
+
+    sink_backend const backends[] = {sink_backend::blocking, sink_backend::thread,
+                                     sink_backend::io_uring};
+
+    std::printf("=== tick time with %zu trace lines per 1 kHz tick, %us per run ===\n", CHANNELS,
+                seconds);
+    std::printf("%-6s %-10s %8s %8s %8s %8s %10s %10s\n", "target", "backend", "mean_us",
+                "p50_us", "p99_us", "max_us", "written_kb", "dropped_kb");
+
+    for (std::size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+        std::string path = dir + "/bench_async_sinkXXXXXX";
+        int const fd = ::mkstemp(&path[0]);
+        if (fd < 0) {
+            std::perror("mkstemp");
+            return 1;
+        }
+        ::unlink(path.c_str());
+        run_result result = {};
+        measure(fd, backends[b], seconds, result);
+        print_row("file", backends[b], result);
+        ::close(fd);
+    }
+
+    for (std::size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+        int fds[2];
+        if (::pipe(fds) != 0) {
+            std::perror("pipe");
+            return 1;
+        }
+        std::atomic<bool> stop(false);
+        std::thread reader(stalling_reader, fds[0], std::cref(stop));
+        run_result result = {};
+        measure(fds[1], backends[b], seconds, result);
+        print_row("slow", backends[b], result);
+        stop.store(true);
+        ::close(fds[1]);
+        reader.join();
+        ::close(fds[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "audio_envelope.h"
+#include "bench_harness.h"
+#include "wav_file.h"
+
+/**
+ * @brief Throughput of the audio envelope path
+ *
+ *   - Block loudness: SSE2/NEON envelope_block() against the scalar
+ *     reference on 256-frame stereo blocks
+ *   - Pipeline: a 60 s, 48 kHz stereo WAV read from disk, measured and
+ *     queued, reported as a multiple of real time
+ */
+static std::size_t const BLOCK_SAMPLES = 512;
+static uint32_t const RATE = 48000;
+static uint32_t const SECONDS = 60;
+
+int main() {
+    std::vector<int16_t> samples(BLOCK_SAMPLES * 64);
+    std::srand(3);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<int16_t>(std::rand() % 65536 - 32768);
+    }
+    std::size_t const blocks = samples.size() / BLOCK_SAMPLES;
+
+    std::printf("=== envelope block (%zu samples) ===\n", BLOCK_SAMPLES);
+    bench_result const simd = run_bench("envelope_block (SIMD)", 2000000, [&](uint32_t i) {
+        do_not_optimize(envelope_block(&samples[(i % blocks) * BLOCK_SAMPLES], BLOCK_SAMPLES));
+    });
+    bench_result const scalar = run_bench("envelope_block_scalar", 2000000, [&](uint32_t i) {
+        do_not_optimize(
+            envelope_block_scalar(&samples[(i % blocks) * BLOCK_SAMPLES], BLOCK_SAMPLES));
+    });
+    bench_result const results[2] = {simd, scalar};
+    for (int r = 0; r < 2; ++r) {
+        std::printf("%-40s %12.1f ns/block %10.0f Msamples/s\n", results[r].name,
+                    results[r].ns_per_op(), BLOCK_SAMPLES * 1000.0 / results[r].ns_per_op());
+    }
+
+    // 60 s stereo tone with a slow tremolo
+    char path[] = "/tmp/bench_audio_envelopeXXXXXX";
+    int const fd = ::mkstemp(path);
+    if (fd < 0) {
+        return 1;
+    }
+    wav_format format;
+    format.encoding = wav_format::PCM;
+    format.channels = 2;
+    format.sample_rate = RATE;
+    std::vector<int16_t> track(static_cast<std::size_t>(RATE) * SECONDS * 2);
+    for (std::size_t f = 0; f < track.size() / 2; ++f) {
+        double const t = static_cast<double>(f) / RATE;
+        double const level = 0.5 + 0.5 * std::sin(2.0 * M_PI * 2.0 * t);
+        track[2 * f] = static_cast<int16_t>(20000.0 * level * std::sin(2.0 * M_PI * 440.0 * t));
+        track[2 * f + 1] = track[2 * f];
+    }
+    uint8_t header[WAV_HEADER_SIZE];
+    uint32_t const bytes = static_cast<uint32_t>(track.size() * 2);
+    wav_build_header(header, format, bytes);
+    bool const written = ::write(fd, header, sizeof(header)) == WAV_HEADER_SIZE &&
+                         ::write(fd, track.data(), bytes) == static_cast<ssize_t>(bytes);
+    ::close(fd);
+    if (!written) {
+        ::unlink(path);
+        return 1;
+    }
+
+    std::printf("=== pipeline (%u s, %u Hz stereo WAV) ===\n", SECONDS, RATE);
+    uint32_t levels = 0;
+    bench_result const pipeline = run_bench("read + measure + queue", 5, [&](uint32_t) {
+        wav_reader wav;
+        wav.open(path);
+        audio_envelope<256, 64> envelope(wav, {5, 80, 2.0f, false});
+        envelope.start(0);
+        for (uint32_t now = 0; !envelope.is_finished(); now += 10) {
+            envelope.pump(now + 100);
+            levels += envelope.sample(now);
+        }
+    });
+    ::unlink(path);
+    print_result(pipeline);
+    std::printf("%-40s %12.0f x realtime\n", "pipeline", SECONDS * 1e9 / pipeline.ns_per_op());
+    do_not_optimize(levels);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "beat_timebase.h"
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "output_bank.h"
+
+/**
+ * @brief Cost of beat-synchronized timing on the tick path
+ *
+ * Tempo map: 512 segments (a live-recorded click drifting every beat).
+ *   - ms_to_tick alone: 1 ms playback steps (cursor) against random times
+ *     (binary search after every jump)
+ *   - 4096 channels per tick: converting per channel, converting once per
+ *     tick and sharing the beat position, and the millisecond
+ *     blink_controller as the baseline
+ */
+typedef tempo_map<512> bench_map;
+
+static std::size_t const CHANNELS = 4096;
+
+static bench_map make_map() {
+    bench_map map;
+    for (uint32_t beat = 1; beat < 512; ++beat) {
+        map.add(beat * BEAT_PPQ, 480000 + (beat * 7919) % 40000);
+    }
+    return map;
+}
+
+int main() {
+    bench_map map = make_map();
+    uint32_t const song_ms = map.tick_to_ms(511 * BEAT_PPQ);
+
+    std::printf("=== beat timebase (512 tempo segments, %u ms song) ===\n", song_ms);
+    print_result(run_bench("ms_to_tick: playback (cursor)", 20000000, [&](uint32_t i) {
+        do_not_optimize(map.ms_to_tick(i % song_ms));
+    }));
+    print_result(run_bench("ms_to_tick: random (binary search)", 20000000, [&](uint32_t i) {
+        do_not_optimize(map.ms_to_tick((i * 2654435761u) % song_ms));
+    }));
+
+    output_bank<CHANNELS> bank;
+    std::vector<bank_pin> pins;
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        pins.push_back(bank.channel(c));
+    }
+    std::vector<beat_blink_controller<bank_pin> > beats;
+    std::vector<blink_controller<bank_pin> > millis;
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        uint32_t const eighths = 1 + c % 4;
+        beats.push_back(beat_blink_controller<bank_pin>(pins[c], eighths * BEAT_PPQ / 2,
+                                                        eighths * BEAT_PPQ / 2));
+        millis.push_back(blink_controller<bank_pin>(pins[c], eighths * 250, eighths * 250));
+    }
+
+    uint64_t const TICKS = 20000;
+    bench_result per_channel = run_bench("4096 ch: convert per channel", TICKS, [&](uint32_t t) {
+        uint32_t const now_ms = t % song_ms;
+        for (std::size_t c = 0; c < CHANNELS; ++c) {
+            beats[c].update(map.ms_to_tick(now_ms));
+        }
+    });
+    beat_timebase<bench_map> clock(map);
+    clock.start(0);
+    bench_result shared = run_bench("4096 ch: convert once per tick", TICKS, [&](uint32_t t) {
+        uint32_t const tick = clock.update(t % song_ms);
+        for (std::size_t c = 0; c < CHANNELS; ++c) {
+            beats[c].update(tick);
+        }
+    });
+    bench_result baseline = run_bench("4096 ch: blink_controller (ms)", TICKS, [&](uint32_t t) {
+        for (std::size_t c = 0; c < CHANNELS; ++c) {
+            millis[c].update(t);
+        }
+    });
+    bench_result const results[3] = {per_channel, shared, baseline};
+    for (int r = 0; r < 3; ++r) {
+        std::printf("%-40s %12.2f us/tick %10.2f ns/channel\n", results[r].name,
+                    results[r].ns_per_op() / 1000.0, results[r].ns_per_op() / CHANNELS);
+    }
+    do_not_optimize(bank.words()[0]);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "bench_harness.h"
+#include "binary_log.h"
+#include "console_simulator.h"
+
+/**
+ * @brief Hot-path cost of a log call: binary record vs text formatting
+ *
+ * The binary logger only stores a formatter pointer, the format pointer and
+ * the raw arguments. Calls are timed in batches that fit the ring, with the
+ * (untimed) decoder draining between batches, so no call is a cheap drop.
+ * Compared against formatting the same line with snprintf and with an
+ * ostringstream, as the demo loop did before.
+ */
+static void discard(void*, char const* text, std::size_t length) {
+    do_not_optimize(text);
+    do_not_optimize(length);
+}
+
+template<typename body_t>
+static bench_result run_logged(char const* name, binary_logger& logger, body_t body) {
+    static uint32_t const BATCH = 32768;
+    static uint32_t const BATCHES = 64;
+    double total_ns = 0.0;
+    for (uint32_t b = 0; b < BATCHES; ++b) {
+        auto const start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BATCH; ++i) {
+            body(b * BATCH + i);
+        }
+        auto const end = std::chrono::steady_clock::now();
+        total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+        logger.drain();
+    }
+    return bench_result{name, static_cast<uint64_t>(BATCH) * BATCHES, total_ns};
+}
+
+int main() {
+    static uint64_t const ITERATIONS = 2000000;
+
+    log_output const output = {&discard, nullptr};
+    binary_logger logger(output, 1 << 16);
+    log_ring& log = *logger.attach();
+
+    std::printf("=== log call cost ===\n");
+
+    print_result(run_logged("binary_log 2 args", logger, [&](uint32_t i) {
+        log.log("[%ums] LED: %s", i, console_led_pin::state_label((i & 1) != 0));
+    }));
+    print_result(run_logged("binary_log 6 args", logger, [&](uint32_t i) {
+        log.log("%u %u %d %d %f %s", i, i + 1, -1, 7, 0.5, "x");
+    }));
+    std::printf("  (dropped: %llu)\n", static_cast<unsigned long long>(logger.get_dropped()));
+
+    char line[128];
+    print_result(run_bench("snprintf", ITERATIONS, [&](uint32_t i) {
+        std::snprintf(line, sizeof(line), "[%ums] LED: %s", i,
+                      console_led_pin::state_label((i & 1) != 0));
+        do_not_optimize(line[0]);
+    }));
+
+    print_result(run_bench("ostringstream (format_output)", ITERATIONS, [&](uint32_t i) {
+        std::string const text = console_led_pin::format_output(i, (i & 1) != 0);
+        do_not_optimize(text.size());
+    }));
+    return 0;
+}
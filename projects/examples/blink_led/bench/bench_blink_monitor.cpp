@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "blink_monitor.h"
+
+/**
+ * @brief Writer-side cost of publishing a bank of controllers to a monitor
+ *
+ * Each tick updates every controller; the monitored variant also publishes
+ * a seqlock frame. Reported per tick and per channel.
+ */
+struct null_pin {
+    void set(bool state) { do_not_optimize(state); }
+};
+
+int main() {
+    static std::size_t const CHANNELS = 1024;
+    constexpr uint64_t TICKS = 100000;
+
+    null_pin pin;
+    std::vector<blink_controller<null_pin> > controllers;
+    controllers.reserve(CHANNELS);
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        controllers.push_back(blink_controller<null_pin>(pin, 20 + i % 50, 10 + i % 30));
+    }
+    static blink_monitor<CHANNELS> monitor;
+
+    std::printf("=== blink_monitor writer overhead (%zu channels, 1 tick = 1 ms) ===\n",
+                CHANNELS);
+
+    bench_result const bare = run_bench("update() x channels", TICKS, [&](uint32_t t) {
+        for (std::size_t i = 0; i < CHANNELS; ++i) {
+            controllers[i].update(t);
+        }
+    });
+    print_result(bare);
+
+    bench_result const monitored =
+        run_bench("update() x channels + publish()", TICKS, [&](uint32_t t) {
+            uint32_t const now = static_cast<uint32_t>(TICKS) + t;
+            for (std::size_t i = 0; i < CHANNELS; ++i) {
+                controllers[i].update(now);
+            }
+            monitor.publish(controllers.data(), now);
+        });
+    print_result(monitored);
+
+    std::printf("publish overhead: %.2f ns/channel/tick\n",
+                (monitored.ns_per_op() - bare.ns_per_op()) / CHANNELS);
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <cstdio>
+
+#include "atomic_blink_timing.h"
+#include "bench_harness.h"
+#include "blink_controller.h"
+
+/**
+ * @brief Cost of lock-free retiming on the tick path
+ *
+ * Compares a bare update() against apply_to() + update(), with and without
+ * a pending phase shift. The difference is the per-tick price of accepting
+ * live retiming from a control thread.
+ */
+struct null_pin {
+    void set(bool state) { do_not_optimize(state); }
+};
+
+int main() {
+    constexpr uint64_t ITERATIONS = 50000000;
+    null_pin pin;
+
+    std::printf("=== blink_controller retiming overhead ===\n");
+
+    blink_controller<null_pin> bare(pin, 10, 5);
+    print_result(run_bench("update()", ITERATIONS, [&](uint32_t t) { bare.update(t); }));
+
+    blink_controller<null_pin> retimed(pin, 10, 5);
+    atomic_blink_timing timing(10, 5);
+    print_result(run_bench("apply_to() + update()", ITERATIONS, [&](uint32_t t) {
+        timing.apply_to(retimed);
+        retimed.update(t);
+    }));
+
+    blink_controller<null_pin> shifted(pin, 10, 5);
+    atomic_blink_timing shifting(10, 5);
+    print_result(run_bench("shift_phase() + apply_to() + update()", ITERATIONS, [&](uint32_t t) {
+        shifting.shift_phase(1);
+        shifting.apply_to(shifted);
+        shifted.update(t);
+    }));
+
+    return 0;
+}
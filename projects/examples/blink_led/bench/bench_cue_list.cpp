@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_harness.h"
+#include "cue_list.h"
+#include "fade_controller.h"
+#include "output_bank.h"
+
+/**
+ * @brief GO and jump latency on a 2000-cue show
+ *
+ * 512 channels, each bound to a fade_controller on a level_bank. Every cue
+ * changes 1-24 channels. Jumps go to random cues, as an operator skipping
+ * around in rehearsal. The snapshot interval trades memory for jump cost;
+ * an interval larger than the show is the replay-from-the-top baseline.
+ */
+static std::size_t const CHANNELS = 512;
+static std::size_t const CUES = 2000;
+static std::size_t const CHANGES = CUES * 24;
+
+typedef fade_controller<level_pin> bench_fade;
+
+// Same random show for every snapshot interval
+template<typename show_t>
+static void record(show_t& show, std::vector<bench_fade>& fades) {
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        show.bind(c, fades[c]);
+    }
+    std::srand(1);
+    for (std::size_t i = 0; i < CUES; ++i) {
+        show.add_cue(static_cast<uint32_t>((i + 1) * 1000), 3000);
+        for (int k = 1 + std::rand() % 24; k > 0; --k) {
+            show.add_change(static_cast<std::size_t>(std::rand()) % CHANNELS,
+                            static_cast<uint8_t>(std::rand()));
+        }
+    }
+    show.compile();
+}
+
+template<std::size_t interval_v>
+static void bench_jumps(char const* name, std::vector<bench_fade>& fades) {
+    typedef cue_list<bench_fade, CHANNELS, CUES, CHANGES, interval_v> show_t;
+    static show_t show;
+    record(show, fades);
+    bench_result const jump = run_bench(name, 20000, [&](uint32_t i) {
+        show.jump(static_cast<uint32_t>((i * 2654435761u) % CUES + 1) * 1000, i, 0);
+    });
+    std::printf("%-40s %10.2f us/jump %10zu snapshot bytes\n", jump.name,
+                jump.ns_per_op() / 1000.0, show_t::SNAPSHOT_COUNT * CHANNELS);
+}
+
+int main() {
+    level_bank<CHANNELS> bank;
+    std::vector<level_pin> pins;
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        pins.push_back(bank.channel(c));
+    }
+    std::vector<bench_fade> fades;
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        fades.push_back(bench_fade(pins[c], 0));
+    }
+
+    std::printf("=== cue list (%zu cues, %zu channels) ===\n", CUES, CHANNELS);
+    static cue_list<bench_fade, CHANNELS, CUES, CHANGES> show;
+    record(show, fades);
+    print_result(run_bench("GO (through the show, wrapping)", 200000, [&](uint32_t i) {
+        if (!show.go(i)) {
+            show.jump_to_position(0, i, 0);
+        }
+    }));
+
+    bench_jumps<1>("jump: snapshot every cue", fades);
+    bench_jumps<32>("jump: snapshot every 32 cues", fades);
+    bench_jumps<256>("jump: snapshot every 256 cues", fades);
+    bench_jumps<CUES + 1>("jump: replay from the top", fades);
+    do_not_optimize(bank.levels()[0]);
+    return 0;
+}
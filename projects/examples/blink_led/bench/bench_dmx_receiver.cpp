@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "dmx_merge.h"
+#include "dmx_receiver.h"
+#include "fade_controller.h"
+#include "output_bank.h"
+#include "udp_socket.h"
+
+/**
+ * @brief E1.31 / Art-Net receive path: packets/s and receive-to-output latency
+ *
+ *   - in memory: parse + merge + patch per 512-slot packet, no sockets
+ *   - loopback burst: a sender thread blasts full universes at the receiver;
+ *     packets/s delivered and datagrams dropped by the kernel
+ *   - loopback latency: paced packets carrying their send time; time from
+ *     sendto() to the patched outputs being written (p50/p99/max)
+ * The show patches 256 slots on each of two universes: 256 bank channels,
+ * 128 fades and 128 blink rates in total.
+ */
+typedef std::chrono::steady_clock bench_clock;
+typedef dmx_patch<output_bank<256>, fade_controller<level_pin>, blink_controller<bank_pin>, 1024>
+    bench_patch;
+
+static uint8_t const CID[16] = {0xBE, 0x4C, 0x11};
+static uint16_t const UNIVERSES = 2;
+
+static uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     bench_clock::now().time_since_epoch())
+                                     .count());
+}
+
+struct bench_show {
+    bench_show() {
+        for (uint16_t u = 1; u <= UNIVERSES; ++u) {
+            merger.subscribe(u);
+        }
+        for (std::size_t i = 0; i < 128; ++i) {
+            level_pins.push_back(levels.channel(i));
+            blink_pins.push_back(blink_bank.channel(i));
+        }
+        for (std::size_t i = 0; i < 128; ++i) {
+            fades.push_back(fade_controller<level_pin>(level_pins[i], 100));
+            blinks.push_back(blink_controller<bank_pin>(blink_pins[i], 500, 500));
+        }
+        for (uint16_t u = 1; u <= UNIVERSES; ++u) {
+            uint16_t slot = 1;
+            for (std::size_t i = 0; i < 128; ++i) {
+                patch.map_channel(u, slot++, bank, (u - 1) * 128 + i);
+            }
+            for (std::size_t i = 0; i < 64; ++i) {
+                patch.map_fade(u, slot++, fades[(u - 1) * 64 + i]);
+            }
+            for (std::size_t i = 0; i < 64; ++i) {
+                patch.map_blink(u, slot++, blinks[(u - 1) * 64 + i]);
+            }
+        }
+    }
+
+    static void on_packet(void* context, dmx_packet const& packet, uint8_t const* source_id) {
+        bench_show& show = *static_cast<bench_show*>(context);
+        uint32_t const now_ms = static_cast<uint32_t>(now_ns() / 1000000);
+        if (show.merger.accept(packet, source_id, now_ms)) {
+            show.patch.apply(packet.universe, show.merger.get_slots(packet.universe),
+                             show.merger.get_slot_count(packet.universe), now_ms);
+        }
+        if (show.record_latency && packet.slot_count >= 8) {
+            // Slots 504-511 carry the send time
+            uint64_t sent = 0;
+            std::memcpy(&sent, packet.slots + 504, sizeof(sent));
+            show.latencies_us.push_back((now_ns() - sent) / 1000.0);
+        }
+        ++show.packets;
+    }
+
+    dmx_merger<UNIVERSES> merger;
+    bench_patch patch;
+    output_bank<256> bank;
+    output_bank<128> blink_bank;
+    level_bank<128> levels;
+    std::vector<level_pin> level_pins;
+    std::vector<bank_pin> blink_pins;
+    std::vector<fade_controller<level_pin> > fades;
+    std::vector<blink_controller<bank_pin> > blinks;
+    bool record_latency = false;
+    std::vector<double> latencies_us;
+    uint64_t packets = 0;
+};
+
+static std::size_t build_packet(uint8_t* wire, bool artnet, uint16_t universe, uint8_t sequence,
+                                uint8_t const* slots) {
+    return artnet ? artnet_build(wire, DMX_MAX_PACKET_SIZE, universe, sequence, slots, 512)
+                  : e131_build(wire, DMX_MAX_PACKET_SIZE, CID, "bench", universe, 100, sequence,
+                               0, slots, 512);
+}
+
+static void bench_in_memory(bool artnet) {
+    bench_show show;
+    std::vector<std::vector<uint8_t> > packets;
+    uint8_t slots[512];
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (std::size_t s = 0; s < sizeof(slots); ++s) {
+            slots[s] = static_cast<uint8_t>(i * 31 + s);
+        }
+        uint8_t wire[DMX_MAX_PACKET_SIZE];
+        std::size_t const length = build_packet(wire, artnet, static_cast<uint16_t>(1 + i % 2),
+                                                static_cast<uint8_t>(i / 2), slots);
+        packets.push_back(std::vector<uint8_t>(wire, wire + length));
+    }
+    uint8_t const source_id[16] = {127, 0, 0, 1};
+    bench_result const result = run_bench(
+        artnet ? "in memory: Art-Net parse+merge+patch" : "in memory: E1.31 parse+merge+patch",
+        200000, [&](uint32_t i) {
+            std::vector<uint8_t> const& wire = packets[i % packets.size()];
+            dmx_packet packet;
+            if (dmx_parse(wire.data(), wire.size(), packet)) {
+                uint8_t const* id = packet.cid != nullptr ? packet.cid : source_id;
+                bench_show::on_packet(&show, packet, id);
+            }
+        });
+    print_result(result);
+    do_not_optimize(show.bank.words()[0]);
+}
+
+// Receive until the sender has finished and the sockets stay quiet for 50 ms
+static void drain_until_quiet(dmx_receiver& receiver, bench_show& show,
+                              std::atomic<bool> const& done, bench_clock::time_point& last) {
+    for (;;) {
+        bool const finished = done.load();
+        if (receiver.wait(finished ? 50 : 10)) {
+            if (receiver.receive(&bench_show::on_packet, &show) > 0) {
+                last = bench_clock::now();
+            }
+        } else if (finished) {
+            return;
+        }
+    }
+}
+
+static void bench_loopback_burst(bool artnet) {
+    dmx_receiver receiver;
+    if (!receiver.open(0, 0)) {
+        std::printf("no UDP sockets available\n");
+        return;
+    }
+    bench_show show;
+    uint16_t const port = artnet ? receiver.get_artnet_port() : receiver.get_e131_port();
+    static uint32_t const PACKETS = 100000;
+    std::atomic<bool> done(false);
+
+    bench_clock::time_point const start = bench_clock::now();
+    std::thread sender([&]() {
+        udp_sender target;
+        target.connect(INADDR_LOOPBACK, port);
+        uint8_t slots[512] = {};
+        uint8_t wire[DMX_MAX_PACKET_SIZE];
+        for (uint32_t i = 0; i < PACKETS; ++i) {
+            slots[0] = static_cast<uint8_t>(i);
+            std::size_t const length = build_packet(wire, artnet, static_cast<uint16_t>(1 + i % 2),
+                                                    static_cast<uint8_t>(i / 2), slots);
+            target.send(wire, length);
+        }
+        done.store(true);
+    });
+    bench_clock::time_point last = start;
+    drain_until_quiet(receiver, show, done, last);
+    double const seconds = std::chrono::duration<double>(last - start).count();
+    sender.join();
+
+    std::printf("%-40s %12.0f pkt/s %9llu of %u received, %llu dropped\n",
+                artnet ? "loopback burst: Art-Net" : "loopback burst: E1.31",
+                show.packets / seconds,
+                static_cast<unsigned long long>(show.packets), PACKETS,
+                static_cast<unsigned long long>(PACKETS - show.packets));
+}
+
+static void bench_loopback_latency(uint32_t interval_us) {
+    dmx_receiver receiver;
+    if (!receiver.open(0, 0)) {
+        std::printf("no UDP sockets available\n");
+        return;
+    }
+    bench_show show;
+    show.record_latency = true;
+    uint16_t const port = receiver.get_e131_port();
+    static uint32_t const PACKETS = 5000;
+    std::atomic<bool> done(false);
+
+    std::thread sender([&]() {
+        udp_sender target;
+        target.connect(INADDR_LOOPBACK, port);
+        uint8_t slots[512] = {};
+        uint8_t wire[DMX_MAX_PACKET_SIZE];
+        for (uint32_t i = 0; i < PACKETS; ++i) {
+            slots[0] = static_cast<uint8_t>(i);
+            uint64_t const sent = now_ns();
+            std::memcpy(slots + 504, &sent, sizeof(sent));
+            std::size_t const length = build_packet(wire, false, 1, static_cast<uint8_t>(i), slots);
+            target.send(wire, length);
+            std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+        }
+        done.store(true);
+    });
+    bench_clock::time_point last;
+    drain_until_quiet(receiver, show, done, last);
+    sender.join();
+
+    std::vector<double>& latencies = show.latencies_us;
+    if (latencies.empty()) {
+        std::printf("no packets received\n");
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    char label[64];
+    std::snprintf(label, sizeof(label), "loopback latency: 1 pkt per %u us", interval_us);
+    std::printf("%-40s p50 %7.1f us  p99 %7.1f us  max %8.1f us  (%zu pkts)\n", label,
+                latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100],
+                latencies.back(), latencies.size());
+}
+
+int main() {
+    std::printf("=== DMX receive path (512-slot universes, 512 patched outputs) ===\n");
+    bench_in_memory(false);
+    bench_in_memory(true);
+    bench_loopback_burst(false);
+    bench_loopback_burst(true);
+    bench_loopback_latency(1000);
+    bench_loopback_latency(100);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "bench_harness.h"
+#include "event_reactor.h"
+#include "tick_jitter.h"
+
+/**
+ * @brief Reactor dispatch latency and throughput with local stand-in peers
+ *
+ * - Latency: a peer thread sends timestamped 8-byte messages over a Unix
+ *   socketpair at ~1 kHz; the handler records send-to-dispatch delay.
+ * - Throughput: the peer blasts messages as fast as possible.
+ * - Timer: repeated 1 ms one-shot ticks, recording wakeup lateness.
+ */
+typedef std::chrono::steady_clock bench_clock;
+
+static uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now().time_since_epoch())
+            .count());
+}
+
+struct latency_sink {
+    int fd;
+    uint64_t received;
+    tick_jitter_histogram latency;
+
+    static void on_event(void* context, uint32_t) {
+        latency_sink* const self = static_cast<latency_sink*>(context);
+        uint64_t stamps[64];
+        ssize_t const n = ::read(self->fd, stamps, sizeof(stamps));
+        if (n <= 0) {
+            return;
+        }
+        uint64_t const now = now_ns();
+        std::size_t const count = static_cast<std::size_t>(n) / sizeof(uint64_t);
+        for (std::size_t i = 0; i < count; ++i) {
+            self->latency.record(static_cast<uint32_t>((now - stamps[i]) / 1000));
+        }
+        self->received += count;
+    }
+};
+
+struct timer_sink {
+    event_reactor* reactor;
+    uint64_t armed_at_ns;
+    uint32_t remaining;
+    tick_jitter_histogram lateness;
+
+    static void on_tick(void* context, uint32_t) {
+        timer_sink* const self = static_cast<timer_sink*>(context);
+        uint64_t const late_ns = now_ns() - self->armed_at_ns - 1000000;
+        self->lateness.record(static_cast<uint32_t>(late_ns / 1000));
+        if (--self->remaining == 0) {
+            self->reactor->stop();
+            return;
+        }
+        self->armed_at_ns = now_ns();
+        self->reactor->arm_tick(1);
+    }
+};
+
+static void print_latency(char const* label, tick_jitter_histogram const& h) {
+    std::printf("%-28s n=%-8llu mean=%.1fus p50=%uus p99=%uus max=%uus\n", label,
+                static_cast<unsigned long long>(h.get_count()), h.get_mean_us(),
+                h.percentile_us(50.0), h.percentile_us(99.0), h.get_max_us());
+}
+
+static void run_socket(uint32_t messages, bool paced) {
+    int sockets[2];
+    ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+    event_reactor reactor;
+    reactor.open();
+
+    static latency_sink sink;
+    sink.fd = sockets[0];
+    sink.received = 0;
+    sink.latency.reset();
+    event_handler handler;
+    handler.callback = &latency_sink::on_event;
+    handler.context = &sink;
+    reactor.watch(sockets[0], EPOLLIN, handler);
+
+    std::thread peer([&]() {
+        for (uint32_t i = 0; i < messages; ++i) {
+            uint64_t const stamp = now_ns();
+            ssize_t const n = ::write(sockets[1], &stamp, sizeof(stamp));
+            do_not_optimize(n);
+            if (paced) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+
+    uint64_t const start = now_ns();
+    while (sink.received < messages) {
+        reactor.run_once(100);
+    }
+    uint64_t const elapsed = now_ns() - start;
+    peer.join();
+
+    if (paced) {
+        print_latency("socket send->dispatch", sink.latency);
+    } else {
+        std::printf("%-28s %llu msgs in %.1f ms = %.0f msgs/s\n", "socket throughput",
+                    static_cast<unsigned long long>(messages), elapsed / 1e6,
+                    messages * 1e9 / elapsed);
+    }
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+}
+
+int main() {
+    std::printf("=== event_reactor dispatch ===\n");
+    run_socket(2000, true);
+    run_socket(1000000, false);
+
+    event_reactor reactor;
+    reactor.open();
+    static timer_sink timers;
+    timers.reactor = &reactor;
+    timers.remaining = 2000;
+    event_handler handler;
+    handler.callback = &timer_sink::on_tick;
+    handler.context = &timers;
+    reactor.set_tick_handler(handler);
+    timers.armed_at_ns = now_ns();
+    reactor.arm_tick(1);
+    reactor.run();
+    print_latency("timerfd 1ms tick lateness", timers.lateness);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @brief Minimal benchmark helpers (no external dependencies)
+ *
+ * Benchmarks are plain executables that print one line per measurement:
+ *
+ *   bench_result r = run_bench("update", 1000000, [&](uint32_t i) { c.update(i); });
+ *   print_result(r);
+ *
+ * Results are wall-clock averages over the whole run; they are meant for
+ * before/after comparisons on the same machine, not absolute claims.
+ */
+struct bench_result {
+    char const* name;
+    uint64_t iterations;
+    double total_ns;
+
+    double ns_per_op() const { return iterations == 0 ? 0.0 : total_ns / iterations; }
+    double ops_per_sec() const { return total_ns <= 0.0 ? 0.0 : iterations * 1e9 / total_ns; }
+};
+
+/**
+ * @brief Prevent the optimizer from discarding a computed value
+ */
+template<typename value_t>
+inline void do_not_optimize(value_t const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Time a callable over a number of iterations
+ *
+ * @param name Label printed with the result
+ * @param iterations Number of calls to body(i)
+ * @param body Callable taking the iteration index (uint32_t)
+ */
+template<typename body_t>
+bench_result run_bench(char const* name, uint64_t iterations, body_t body) {
+    auto const start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        body(static_cast<uint32_t>(i));
+    }
+    auto const end = std::chrono::steady_clock::now();
+    double const ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return bench_result{name, iterations, ns};
+}
+
+inline void print_result(bench_result const& result) {
+    std::printf("%-40s %12.2f ns/op %14.0f ops/s\n", result.name, result.ns_per_op(),
+                result.ops_per_sec());
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_harness.h"
+#include "led_grid.h"
+#include "led_layout.h"
+
+/**
+ * @brief Localized flash: grid query plus evaluation vs a full scan
+ *
+ * LEDs are scattered through a 20 x 10 x 3 m house. The effect is a flash
+ * around a sensor: every LED within the radius gets a level falling off
+ * with distance. The full scan tests every LED; the grid (50 cm cells)
+ * tests only the LEDs in the cells around the sensor. Sensors move between
+ * iterations. Times are per flash.
+ */
+static float random_between(float low, float high) {
+    return low + (high - low) * static_cast<float>(std::rand()) / RAND_MAX;
+}
+
+static uint8_t flash_level(float distance_squared, float inverse_r2) {
+    return static_cast<uint8_t>(255.0f * (1.0f - distance_squared * inverse_r2));
+}
+
+int main() {
+    std::size_t const counts[] = {10000, 50000, 200000};
+    float const radii[] = {0.25f, 0.5f, 1.0f, 2.0f, 4.0f};
+    std::srand(31);
+    std::vector<led_position> sensors(64);
+    for (std::size_t s = 0; s < sensors.size(); ++s) {
+        sensors[s].x = random_between(0, 20);
+        sensors[s].y = random_between(0, 10);
+        sensors[s].z = random_between(0, 3);
+    }
+
+    for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        std::size_t const count = counts[c];
+        led_layout layout;
+        for (std::size_t i = 0; i < count; ++i) {
+            layout.add({random_between(0, 20), random_between(0, 10), random_between(0, 3)});
+        }
+        std::vector<uint8_t> levels(count);
+        bench_result const built =
+            run_bench("build", 5, [&](uint32_t) { led_grid const grid(layout, 0.5f); });
+        led_grid const grid(layout, 0.5f);
+        std::printf("\n=== %zu LEDs: grid build %.2f ms, %zu cells of %.2f m ===\n", count,
+                    built.ns_per_op() / 1e6, grid.get_cell_count(), grid.get_cell_size());
+        std::printf("%-8s %10s %14s %14s %9s\n", "radius", "LEDs hit", "full scan", "grid",
+                    "speedup");
+
+        float const* const x = layout.x();
+        float const* const y = layout.y();
+        float const* const z = layout.z();
+        for (std::size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); ++r) {
+            float const radius = radii[r];
+            float const r2 = radius * radius;
+            float const inverse_r2 = 1.0f / r2;
+            uint64_t hits = 0;
+            bench_result const scan = run_bench("full scan", 200, [&](uint32_t i) {
+                led_position const& p = sensors[i % sensors.size()];
+                for (std::size_t k = 0; k < count; ++k) {
+                    float const dx = x[k] - p.x;
+                    float const dy = y[k] - p.y;
+                    float const dz = z[k] - p.z;
+                    float const d2 = dx * dx + dy * dy + dz * dz;
+                    if (d2 <= r2) {
+                        levels[k] = flash_level(d2, inverse_r2);
+                        ++hits;
+                    }
+                }
+                do_not_optimize(levels[0]);
+            });
+            bench_result const indexed = run_bench("grid", 20000, [&](uint32_t i) {
+                led_position const& p = sensors[i % sensors.size()];
+                grid.for_each_in_radius(p, radius, [&](uint32_t led, float d2) {
+                    levels[led] = flash_level(d2, inverse_r2);
+                });
+                do_not_optimize(levels[0]);
+            });
+            std::printf("%6.2f m %10.0f %11.1f us %11.2f us %8.0fx\n", radius,
+                        static_cast<double>(hits) / scan.iterations, scan.ns_per_op() / 1e3,
+                        indexed.ns_per_op() / 1e3, scan.ns_per_op() / indexed.ns_per_op());
+        }
+    }
+    return 0;
+}
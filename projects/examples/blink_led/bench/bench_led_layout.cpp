@@ -0,0 +1,119 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bench_harness.h"
+#include "led_layout.h"
+#include "pixel_shader.h"
+#include "shader_expression.h"
+
+/**
+ * @brief Moving waves over a 50k-LED house from precomputed geometry tables
+ *
+ * LEDs are scattered through a 20 x 10 x 3 m volume. Each frame draws a
+ * wave sweeping along the house and a ring wave spreading from a point:
+ * - per-LED 3D math: positions as {x, y, z} structs, dot product or sqrt
+ *   and std::sin for every LED every frame
+ * - layout_wave() over a projection or distance table built once
+ * - the same wave as a pixel_shader over the table ("r = wave(x - t)")
+ * Reported in ns/LED; table construction is measured separately.
+ */
+static std::size_t const LEDS = 50000;
+
+int main() {
+    led_layout layout;
+    std::vector<led_position> positions(LEDS);
+    std::srand(17);
+    for (std::size_t i = 0; i < LEDS; ++i) {
+        positions[i].x = 20.0f * std::rand() / RAND_MAX;
+        positions[i].y = 10.0f * std::rand() / RAND_MAX;
+        positions[i].z = 3.0f * std::rand() / RAND_MAX;
+        layout.add(positions[i]);
+    }
+    std::vector<uint8_t> levels(LEDS);
+    led_position const direction = {0.8f, 0.6f, 0.0f};  // Unit length
+    led_position const origin = {12.0f, 4.0f, 0.0f};
+
+    std::printf("=== geometry tables, %zu LEDs ===\n", LEDS);
+    geometry_table along;
+    geometry_table radius;
+    geometry_table around;
+    bench_result const build_along = run_bench("projections()", 20, [&](uint32_t) {
+        along = layout.projections(direction, origin);
+    });
+    bench_result const build_radius = run_bench("distances()", 20, [&](uint32_t) {
+        radius = layout.distances(origin);
+    });
+    bench_result const build_around = run_bench("angles()", 20, [&](uint32_t) {
+        around = layout.angles(origin, {0, 0, 1});
+    });
+    bench_result const builds[] = {build_along, build_radius, build_around};
+    for (std::size_t k = 0; k < 3; ++k) {
+        std::printf("%-36s %9.2f ms %8.2f ns/LED\n", builds[k].name, builds[k].ns_per_op() / 1e6,
+                    builds[k].ns_per_op() / LEDS);
+    }
+
+    std::printf("\n=== moving wave per frame ===\n");
+    float const cycles = 0.5f;  // Waves per meter
+    bench_result const sweep_3d = run_bench("sweep, per-LED 3D math", 200, [&](uint32_t i) {
+        float const phase = i * 0.01f;
+        for (std::size_t k = 0; k < LEDS; ++k) {
+            led_position const& p = positions[k];
+            float const d = (p.x - origin.x) * direction.x + (p.y - origin.y) * direction.y +
+                            (p.z - origin.z) * direction.z;
+            float const s = std::sin(6.2831853f * (d * cycles - phase));
+            levels[k] = static_cast<uint8_t>((s + 1.0f) * 127.5f);
+        }
+        do_not_optimize(levels[0]);
+    });
+    bench_result const ring_3d = run_bench("ring, per-LED 3D math", 200, [&](uint32_t i) {
+        float const phase = i * 0.01f;
+        for (std::size_t k = 0; k < LEDS; ++k) {
+            led_position const& p = positions[k];
+            float const dx = p.x - origin.x;
+            float const dy = p.y - origin.y;
+            float const dz = p.z - origin.z;
+            float const d = std::sqrt(dx * dx + dy * dy + dz * dz);
+            float const s = std::sin(6.2831853f * (d * cycles - phase));
+            levels[k] = static_cast<uint8_t>((s + 1.0f) * 127.5f);
+        }
+        do_not_optimize(levels[0]);
+    });
+    bench_result const sweep_table = run_bench("sweep, projection table", 1000, [&](uint32_t i) {
+        layout_wave(along, SHADER_ONE / 2, static_cast<int32_t>(i * 655), levels.data());
+        do_not_optimize(levels[0]);
+    });
+    bench_result const ring_table = run_bench("ring, distance table", 1000, [&](uint32_t i) {
+        layout_wave(radius, SHADER_ONE / 2, static_cast<int32_t>(i * 655), levels.data());
+        do_not_optimize(levels[0]);
+    });
+    bench_result const spin_table = run_bench("spin, angle table", 1000, [&](uint32_t i) {
+        layout_wave(around, 3 * SHADER_ONE, static_cast<int32_t>(i * 655), levels.data());
+        do_not_optimize(levels[0]);
+    });
+
+    char const* const text = "r = wave(x * 0.5 - t)";
+    shader_program program;
+    shader_error error;
+    compile_shader(text, std::strlen(text), program, error);
+    static pixel_shader<> shader;
+    bench_result const ring_shader = run_bench("ring, pixel_shader on table", 1000,
+                                               [&](uint32_t i) {
+        shader_inputs const inputs = {radius.data(), nullptr, static_cast<int32_t>(i * 655)};
+        shader.evaluate(program, inputs, LEDS, levels.data(), nullptr, nullptr);
+        do_not_optimize(levels[0]);
+    });
+
+    bench_result const frames[] = {sweep_3d, ring_3d, sweep_table, ring_table, spin_table,
+                                   ring_shader};
+    for (std::size_t k = 0; k < sizeof(frames) / sizeof(frames[0]); ++k) {
+        std::printf("%-36s %9.1f us/frame %8.2f ns/LED\n", frames[k].name,
+                    frames[k].ns_per_op() / 1e3, frames[k].ns_per_op() / LEDS);
+    }
+    std::printf("\ntable memory: %zu KB per table (%zu bytes/LED)\n",
+                along.size() * sizeof(int32_t) / 1024, sizeof(int32_t));
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench_harness.h"
+#include "noise_field.h"
+
+/**
+ * @brief Noise samples per second: scalar calls vs SIMD batches, and the 8-bit variant
+ *
+ * 64k samples per iteration over a 256 x 256 grid of Q16.16 coordinates
+ * (about 0.1 cell apart, like LED positions in meters with 1 m cells).
+ * The 8-bit variant is timed on the host only; its AVR cost is given as
+ * an operation count (no AVR toolchain here to measure cycles).
+ */
+static std::size_t const SAMPLES = 65536;
+
+struct null_pin {
+    void set(bool state) { do_not_optimize(state); }
+};
+
+static void report(bench_result const& result, std::size_t per_iteration) {
+    double const ns = result.ns_per_op() / per_iteration;
+    std::printf("%-32s %8.2f ns/sample %9.1f M samples/s\n", result.name, ns, 1e3 / ns);
+}
+
+int main() {
+    std::vector<int32_t> x(SAMPLES);
+    std::vector<int32_t> y(SAMPLES);
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+        x[i] = static_cast<int32_t>((i % 256) * 6554);
+        y[i] = static_cast<int32_t>((i / 256) * 6554);
+    }
+    std::vector<uint16_t> out(SAMPLES);
+    std::vector<uint8_t> out8(SAMPLES);
+
+    std::printf("=== 16-bit noise (host) ===\n");
+    report(run_bench("noise_1d, scalar", 200, [&](uint32_t t) {
+               for (std::size_t i = 0; i < SAMPLES; ++i) {
+                   out[i] = noise_1d(x[i] + static_cast<int32_t>(t), 1);
+               }
+               do_not_optimize(out[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise_1d_batch", 200, [&](uint32_t t) {
+               noise_1d_batch(x.data(), SAMPLES, t, out.data());
+               do_not_optimize(out[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise_2d, scalar", 200, [&](uint32_t t) {
+               for (std::size_t i = 0; i < SAMPLES; ++i) {
+                   out[i] = noise_2d(x[i], y[i], t);
+               }
+               do_not_optimize(out[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise_2d_batch", 200, [&](uint32_t t) {
+               noise_2d_batch(x.data(), y.data(), SAMPLES, t, out.data());
+               do_not_optimize(out[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise_3d, scalar", 200, [&](uint32_t t) {
+               int32_t const z = static_cast<int32_t>(t * 3000);
+               for (std::size_t i = 0; i < SAMPLES; ++i) {
+                   out[i] = noise_3d(x[i], y[i], z, 1);
+               }
+               do_not_optimize(out[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise_3d_batch", 200, [&](uint32_t t) {
+               noise_3d_batch(x.data(), y.data(), static_cast<int32_t>(t * 3000), SAMPLES, 1,
+                              out.data());
+               do_not_optimize(out[0]);
+           }),
+           SAMPLES);
+
+    std::printf("\n=== 8-bit noise (AVR variant, timed on host) ===\n");
+    report(run_bench("noise8_1d", 200, [&](uint32_t t) {
+               for (std::size_t i = 0; i < SAMPLES; ++i) {
+                   out8[i] = noise8_1d(static_cast<uint16_t>(i * 26 + t));
+               }
+               do_not_optimize(out8[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise8_2d", 200, [&](uint32_t t) {
+               for (std::size_t i = 0; i < SAMPLES; ++i) {
+                   out8[i] = noise8_2d(static_cast<uint16_t>((i % 256) * 26 + t),
+                                       static_cast<uint16_t>((i / 256) * 26));
+               }
+               do_not_optimize(out8[0]);
+           }),
+           SAMPLES);
+    report(run_bench("noise8_3d", 200, [&](uint32_t t) {
+               for (std::size_t i = 0; i < SAMPLES; ++i) {
+                   out8[i] = noise8_3d(static_cast<uint16_t>((i % 256) * 26),
+                                       static_cast<uint16_t>((i / 256) * 26),
+                                       static_cast<uint16_t>(t * 13));
+               }
+               do_not_optimize(out8[0]);
+           }),
+           SAMPLES);
+    null_pin pin;
+    flicker_controller<null_pin> candle(pin, 100, 255, 8);
+    print_result(run_bench("flicker_controller::update", 10000000,
+                           [&](uint32_t i) { candle.update(i); }));
+
+    std::printf("\nAVR cost (operation counts, not measured):\n");
+    std::printf("  noise8_1d: 2 PROGMEM reads, 4 8x8 multiplies, ~60 cycles\n");
+    std::printf("  noise8_2d: 8 PROGMEM reads, 10 8x8 multiplies, ~170 cycles\n");
+    std::printf("  noise8_3d: 2 x noise8_2d, 2 reads, 4 multiplies, ~400 cycles\n");
+    std::printf("  table: 256 bytes of flash; flicker_controller: 14 bytes of RAM\n");
+    return 0;
+}
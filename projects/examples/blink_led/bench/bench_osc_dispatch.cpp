@@ -0,0 +1,207 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "osc_dispatch.h"
+#include "osc_message.h"
+#include "udp_socket.h"
+
+/**
+ * @brief OSC dispatch rate for a show-sized address space
+ *
+ * 256 routes ("/channel/N/rate", "/channel/N/level", "/cue/N/go" ...):
+ *   - dispatch only: hash-table lookup of a literal address, a cached pattern,
+ *     an uncached pattern (matched against every route), and a linear
+ *     strcmp() route list as the baseline a naive receiver would use
+ *   - parse+dispatch: osc_walk_packet over a message and a 16-message bundle
+ *   - loopback: messages/s through udp_batch_receiver + scheduler
+ */
+typedef std::chrono::steady_clock bench_clock;
+typedef osc_dispatcher<256> bench_dispatcher;
+
+static std::size_t const ROUTES = 256;
+static uint64_t handled = 0;
+
+static void on_message(void*, osc_message const& message) {
+    handled += message.argument_count;
+}
+
+static std::vector<std::vector<char> > route_addresses() {
+    char const* const kinds[4] = {"rate", "level", "phase", "go"};
+    std::vector<std::vector<char> > addresses;
+    for (std::size_t i = 0; i < ROUTES; ++i) {
+        char address[64];
+        std::snprintf(address, sizeof(address), "/%s/%u/%s", i < 192 ? "channel" : "cue",
+                      static_cast<unsigned>(i / 4), kinds[i % 4]);
+        addresses.push_back(std::vector<char>(address, address + std::strlen(address) + 1));
+    }
+    return addresses;
+}
+
+static std::vector<uint8_t> build_message(char const* address) {
+    uint8_t buffer[128];
+    osc_message_writer writer(buffer, sizeof(buffer));
+    writer.begin(address, "if");
+    writer.add_int32(250);
+    writer.add_float(0.5f);
+    std::size_t const length = writer.finish();
+    return std::vector<uint8_t>(buffer, buffer + length);
+}
+
+// What a receiver without a table does: strcmp every route
+struct linear_routes {
+    std::vector<std::vector<char> > addresses;
+
+    std::size_t dispatch(osc_message const& message) {
+        for (std::size_t i = 0; i < addresses.size(); ++i) {
+            if (std::strcmp(addresses[i].data(), message.address) == 0) {
+                on_message(nullptr, message);
+                return 1;
+            }
+        }
+        return 0;
+    }
+};
+
+template<typename dispatch_t>
+static void bench_dispatch(char const* name, dispatch_t& dispatcher,
+                           std::vector<std::vector<uint8_t> > const& packets,
+                           uint64_t iterations) {
+    std::vector<osc_message> messages(packets.size());
+    for (std::size_t i = 0; i < packets.size(); ++i) {
+        osc_parse_message(packets[i].data(), packets[i].size(), messages[i]);
+    }
+    bench_result const result = run_bench(name, iterations, [&](uint32_t i) {
+        do_not_optimize(dispatcher.dispatch(messages[i % messages.size()]));
+    });
+    print_result(result);
+}
+
+struct dispatch_visitor {
+    bench_dispatcher* dispatcher;
+
+    void on_message(osc_message const& message, uint64_t) { dispatcher->dispatch(message); }
+};
+
+static void bench_parse_dispatch(bench_dispatcher& osc,
+                                 std::vector<std::vector<char> > const& addresses) {
+    std::vector<uint8_t> const single = build_message(addresses[100].data());
+    std::vector<uint8_t> bundle(2048);
+    osc_bundle_writer writer(bundle.data(), bundle.size(), OSC_TIMETAG_IMMEDIATE);
+    for (std::size_t i = 0; i < 16; ++i) {
+        std::vector<uint8_t> const message = build_message(addresses[i * 13].data());
+        writer.add(message.data(), message.size());
+    }
+    bundle.resize(writer.finish());
+
+    dispatch_visitor visitor = {&osc};
+    print_result(run_bench("parse+dispatch: one message", 2000000, [&](uint32_t) {
+        do_not_optimize(osc_walk_packet(single.data(), single.size(), visitor));
+    }));
+    bench_result result = run_bench("parse+dispatch: 16-message bundle", 200000, [&](uint32_t) {
+        do_not_optimize(osc_walk_packet(bundle.data(), bundle.size(), visitor));
+    });
+    result.iterations *= 16;  // Report per message
+    print_result(result);
+}
+
+struct loopback_show {
+    osc_scheduler<bench_dispatcher> scheduler;
+    uint64_t packets;
+
+    explicit loopback_show(bench_dispatcher& osc) : scheduler(osc), packets(0) {}
+
+    static void on_datagram(void* context, uint8_t const* data, std::size_t length,
+                            sockaddr_in const&) {
+        loopback_show& show = *static_cast<loopback_show*>(context);
+        show.scheduler.process(data, length, 0);
+        ++show.packets;
+    }
+};
+
+static void bench_loopback(bench_dispatcher& osc,
+                           std::vector<std::vector<char> > const& addresses) {
+    udp_batch_receiver<512> socket;
+    if (!socket.open(0)) {
+        std::printf("no UDP sockets available\n");
+        return;
+    }
+    loopback_show show(osc);
+    static uint32_t const PACKETS = 200000;
+    std::atomic<bool> done(false);
+    uint16_t const port = socket.get_port();
+
+    bench_clock::time_point const start = bench_clock::now();
+    std::thread sender([&]() {
+        udp_sender target;
+        target.connect(INADDR_LOOPBACK, port);
+        std::vector<std::vector<uint8_t> > messages;
+        for (std::size_t i = 0; i < addresses.size(); ++i) {
+            messages.push_back(build_message(addresses[i].data()));
+        }
+        for (uint32_t i = 0; i < PACKETS; ++i) {
+            std::vector<uint8_t> const& message = messages[i % messages.size()];
+            target.send(message.data(), message.size());
+        }
+        done.store(true);
+    });
+    // Receive until the sender has finished and the socket stays quiet for 50 ms
+    bench_clock::time_point last = start;
+    for (;;) {
+        bool const finished = done.load();
+        if (socket.wait(finished ? 50 : 10)) {
+            if (socket.receive(&loopback_show::on_datagram, &show) > 0) {
+                last = bench_clock::now();
+            }
+        } else if (finished) {
+            break;
+        }
+    }
+    double const seconds = std::chrono::duration<double>(last - start).count();
+    sender.join();
+
+    std::printf("%-40s %12.0f msg/s %9llu of %u received\n", "loopback: parse+dispatch",
+                show.packets / seconds, static_cast<unsigned long long>(show.packets), PACKETS);
+}
+
+int main() {
+    std::vector<std::vector<char> > const addresses = route_addresses();
+    bench_dispatcher osc;
+    linear_routes linear;
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        osc.add(addresses[i].data(), &on_message, nullptr);
+        linear.addresses.push_back(addresses[i]);
+    }
+
+    std::vector<std::vector<uint8_t> > literals;
+    for (std::size_t i = 0; i < addresses.size(); i += 7) {
+        literals.push_back(build_message(addresses[i].data()));
+    }
+    std::vector<std::vector<uint8_t> > patterns;
+    patterns.push_back(build_message("/channel/*/rate"));
+    patterns.push_back(build_message("/channel/{1,2,3}/level"));
+    patterns.push_back(build_message("/cue/[5-6]?/go"));
+    // More distinct patterns than the cache holds: every dispatch re-matches
+    std::vector<std::vector<uint8_t> > uncached;
+    for (int i = 0; i < 16; ++i) {
+        char pattern[64];
+        std::snprintf(pattern, sizeof(pattern), "/channel/%d*/%s", i % 8 + 1,
+                      i < 8 ? "rate" : "level");
+        uncached.push_back(build_message(pattern));
+    }
+
+    std::printf("=== OSC dispatch (%zu routes) ===\n", ROUTES);
+    bench_dispatch("dispatch: literal, hash table", osc, literals, 5000000);
+    bench_dispatch("dispatch: literal, linear strcmp", linear, literals, 5000000);
+    bench_dispatch("dispatch: pattern, cached", osc, patterns, 1000000);
+    bench_dispatch("dispatch: pattern, uncached", osc, uncached, 100000);
+    bench_parse_dispatch(osc, addresses);
+    bench_loopback(osc, addresses);
+    do_not_optimize(handled);
+    return 0;
+}
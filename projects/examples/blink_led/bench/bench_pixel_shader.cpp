@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "bench_harness.h"
+#include "output_bank.h"
+#include "pixel_shader.h"
+#include "shader_expression.h"
+
+/**
+ * @brief Compiled block shaders vs a per-pixel tree-walking interpreter
+ *
+ * A 128x128 matrix (16384 pixels) with x, y layout coordinates, one frame
+ * per iteration at a moving t, for shaders from a one-liner to a
+ * distance-field pattern. Both evaluators produce identical frames; the
+ * figure of merit is pixels per second.
+ */
+static std::size_t const SIDE = 128;
+static std::size_t const PIXELS = SIDE * SIDE;
+
+struct bench_shader {
+    char const* name;
+    char const* text;
+};
+
+static bench_shader const SHADERS[] = {
+    {"rainbow chase", "r = wave(u + t / 4); g = wave(u + t / 4 + 0.33); b = wave(u - t / 3)"},
+    {"plasma",
+     "v = sin(x * 10 + t) + sin(y * 8 - t * 2) + sin((x + y) * 6 + t)\n"
+     "r = wave(v / 6); g = wave(v / 6 + 0.3); b = 1 - r"},
+    {"ripple rings",
+     "d = abs(x - 0.5) * abs(x - 0.5) + abs(y - 0.5) * abs(y - 0.5)\n"
+     "ring = tri(d * 12 - t) > 0.8\n"
+     "r = ring * wave(t / 5); g = ring * 0.2; b = max(0, 0.5 - d) * 2"},
+};
+
+int main() {
+    std::vector<int32_t> x(PIXELS);
+    std::vector<int32_t> y(PIXELS);
+    for (std::size_t i = 0; i < PIXELS; ++i) {
+        x[i] = static_cast<int32_t>((i % SIDE) * SHADER_ONE / SIDE);
+        y[i] = static_cast<int32_t>((i / SIDE) * SHADER_ONE / SIDE);
+    }
+    static rgb_bank<PIXELS> frame;
+    static rgb_bank<PIXELS> reference;
+    static pixel_shader<> shader;
+
+    std::printf("=== pixel_shader, %zu pixels per frame ===\n", PIXELS);
+    for (std::size_t s = 0; s < sizeof(SHADERS) / sizeof(SHADERS[0]); ++s) {
+        shader_expression expression;
+        shader_program program;
+        shader_error error;
+        std::size_t const length = std::strlen(SHADERS[s].text);
+        if (!parse_shader(SHADERS[s].text, length, expression, error) ||
+            !generate_shader(expression, program, error)) {
+            std::printf("%s: line %u column %u: %s\n", SHADERS[s].name, error.line, error.column,
+                        error.message);
+            return 1;
+        }
+        std::printf("\n%s: %u tree nodes, %u scalar + %u block instructions\n", SHADERS[s].name,
+                    expression.count, program.scalar_count, program.vector_count);
+
+        bench_result const walked = run_bench("tree walker", 20, [&](uint32_t i) {
+            shader_inputs const inputs = {x.data(), y.data(), static_cast<int32_t>(i * 3000)};
+            evaluate_shader_tree(expression, inputs, PIXELS, reference.red(), reference.green(),
+                                 reference.blue());
+        });
+        bench_result const compiled = run_bench("compiled blocks", 200, [&](uint32_t i) {
+            shader_inputs const inputs = {x.data(), y.data(), static_cast<int32_t>(i * 3000)};
+            shader.evaluate(program, inputs, PIXELS, frame.red(), frame.green(), frame.blue());
+        });
+        shader_inputs const same = {x.data(), y.data(), 12345};
+        evaluate_shader_tree(expression, same, PIXELS, reference.red(), reference.green(),
+                             reference.blue());
+        shader.evaluate(program, same, PIXELS, frame.red(), frame.green(), frame.blue());
+        bench_result const results[] = {walked, compiled};
+        for (std::size_t k = 0; k < 2; ++k) {
+            double const frame_ns = results[k].ns_per_op();
+            std::printf("  %-24s %9.1f us/frame %8.2f ns/pixel %9.1f Mpixel/s\n",
+                        results[k].name, frame_ns / 1e3, frame_ns / PIXELS,
+                        PIXELS / frame_ns * 1e3);
+        }
+        std::printf("  speedup %.1fx, frames %s\n", walked.ns_per_op() / compiled.ns_per_op(),
+                    std::memcmp(frame.red(), reference.red(), PIXELS) == 0 &&
+                            std::memcmp(frame.green(), reference.green(), PIXELS) == 0 &&
+                            std::memcmp(frame.blue(), reference.blue(), PIXELS) == 0
+                        ? "match"
+                        : "DIFFER");
+    }
+
+    // Q16.16 multiply kernel alone
+    std::vector<int32_t> product(PIXELS);
+    bench_result const mul = run_bench("shader_mul_array", 2000, [&](uint32_t) {
+        shader_mul_array(product.data(), x.data(), y.data(), PIXELS);
+        do_not_optimize(product[0]);
+    });
+    std::printf("\n%-26s %8.2f ns/pixel\n", mul.name, mul.ns_per_op() / PIXELS);
+    return 0;
+}
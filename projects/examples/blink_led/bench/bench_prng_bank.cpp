@@ -0,0 +1,75 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_harness.h"
+#include "output_bank.h"
+#include "prng_bank.h"
+
+/**
+ * @brief One random draw per channel: prng_bank vs a std::mt19937 per channel
+ *
+ * Each iteration advances every channel once, either keeping the values
+ * (step) or turning them into sparkle bits at a 2% chance (draw_bits /
+ * sparkle pass). The std::mt19937 baseline is the obvious per-channel
+ * version: one engine per channel, called in a loop, bits set one at a time.
+ * Each engine refills its 624-word state every 624 draws; the timed runs
+ * stay inside one refill, so the baseline is if anything flattered.
+ */
+template<std::size_t channels_v>
+static void run(char const* title) {
+    static prng_bank<channels_v> random(1);
+    static output_bank<channels_v> bank;
+    sparkle_controller<channels_v> sparkle(bank, 1, 20, 1311);
+    std::vector<std::mt19937> engines;
+    engines.reserve(channels_v);
+    for (std::size_t c = 0; c < channels_v; ++c) {
+        engines.push_back(std::mt19937(static_cast<uint32_t>(c + 1)));
+        do_not_optimize(engines[c]());  // Run the first state refill outside the timing
+    }
+    std::vector<uint32_t> values(channels_v);
+    uint32_t const threshold = 1311u << 16;
+
+    std::printf("\n=== %s ===\n", title);
+    bench_result const mt_step = run_bench("mt19937 per channel, values", 100, [&](uint32_t) {
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            values[c] = engines[c]();
+        }
+        do_not_optimize(values[0]);
+    });
+    bench_result const bank_step = run_bench("prng_bank::step", 2000, [&](uint32_t) {
+        random.step();
+        do_not_optimize(random.values()[0]);
+    });
+    bench_result const mt_bits = run_bench("mt19937 per channel, bits", 100, [&](uint32_t) {
+        bank.clear();
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            bank.set(c, engines[c]() < threshold);
+        }
+        do_not_optimize(bank.words()[0]);
+    });
+    bench_result const bank_bits = run_bench("prng_bank::draw_bits", 2000, [&](uint32_t) {
+        random.draw_bits(threshold, bank.words());
+        do_not_optimize(bank.words()[0]);
+    });
+    bench_result const pass = run_bench("sparkle_controller::pass", 2000, [&](uint32_t) {
+        sparkle.pass();
+        do_not_optimize(bank.words()[0]);
+    });
+    bench_result const results[] = {mt_step, bank_step, mt_bits, bank_bits, pass};
+    for (std::size_t k = 0; k < sizeof(results) / sizeof(results[0]); ++k) {
+        std::printf("%-32s %9.1f us/pass %7.3f ns/channel\n", results[k].name,
+                    results[k].ns_per_op() / 1e3, results[k].ns_per_op() / channels_v);
+    }
+    std::printf("speedup: values %.1fx, bits %.1fx\n", mt_step.ns_per_op() / bank_step.ns_per_op(),
+                mt_bits.ns_per_op() / bank_bits.ns_per_op());
+}
+
+int main() {
+    run<4096>("4096 channels");
+    run<65536>("65536 channels");
+    std::printf("\nstate per channel: prng_bank %zu bytes, std::mt19937 %zu bytes\n",
+                sizeof(uint32_t), sizeof(std::mt19937));
+    return 0;
+}
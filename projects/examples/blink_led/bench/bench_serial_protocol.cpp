@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "serial_protocol.h"
+
+/**
+ * @brief Parser cost per byte vs the time a byte takes on the wire
+ *
+ * At 115200 baud a byte arrives every 86.8 us and at 1 Mbaud every 10 us;
+ * the parser (COBS decode + CRC) and the full command server must stay far
+ * below that to leave the loop free for controller updates. Host numbers;
+ * scale by roughly 50-100x for a 16 MHz AVR.
+ */
+struct null_pin {
+    void set(bool) {}
+};
+
+struct null_serial {
+    int available() const { return 0; }
+    int read() { return -1; }
+    std::size_t write(uint8_t const*, std::size_t length) { return length; }
+};
+
+int main() {
+    static uint32_t const FRAMES = 4096;
+
+    std::vector<uint8_t> stream;
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        serial_frame_builder<> builder;
+        builder.begin(serial_message::set_durations, static_cast<uint8_t>(i),
+                      static_cast<uint8_t>(i % 4));
+        builder.put_u32(100 + i);
+        builder.put_u32(200 + i);
+        uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+        std::size_t const length = builder.finish(wire, sizeof(wire));
+        stream.insert(stream.end(), wire, wire + length);
+    }
+    std::size_t const frame_bytes = stream.size() / FRAMES;
+
+    std::printf("=== serial protocol (%zu-byte set_durations frames) ===\n", frame_bytes);
+
+    uint8_t table_data[64];
+    for (std::size_t i = 0; i < sizeof(table_data); ++i) {
+        table_data[i] = static_cast<uint8_t>(i * 7);
+    }
+    bench_result const crc = run_bench("crc16 64 bytes", 1000000, [&](uint32_t i) {
+        table_data[0] = static_cast<uint8_t>(i);
+        do_not_optimize(crc16(table_data, sizeof(table_data)));
+    });
+    print_result(crc);
+
+    serial_parser<> parser;
+    serial_frame frame;
+    bench_result const parse = run_bench("parser per byte", stream.size() * 64, [&](uint32_t i) {
+        bool const done = parser.push(stream[i % stream.size()], frame);
+        do_not_optimize(done);
+    });
+    print_result(parse);
+
+    null_pin pins[4];
+    blink_controller<null_pin> controllers[4] = {
+        blink_controller<null_pin>(pins[0], 10, 10), blink_controller<null_pin>(pins[1], 10, 10),
+        blink_controller<null_pin>(pins[2], 10, 10), blink_controller<null_pin>(pins[3], 10, 10)};
+    null_serial serial;
+    serial_command_server<blink_controller<null_pin>, null_serial> server(controllers, 4, serial);
+    bench_result const serve =
+        run_bench("server per byte (parse+apply+ack)", stream.size() * 64,
+                  [&](uint32_t i) { server.feed(stream[i % stream.size()], i); });
+    print_result(serve);
+    do_not_optimize(server.get_command_count());
+
+    std::printf("\n%-10s %14s %14s %16s\n", "baud", "byte time ns", "server ns/B", "line cmds/s");
+    uint32_t const bauds[] = {115200, 1000000};
+    for (uint32_t b = 0; b < 2; ++b) {
+        double const byte_ns = 10.0 * 1e9 / bauds[b];
+        std::printf("%-10u %14.0f %14.2f %16.0f  (CPU %.3f%%)\n", bauds[b], byte_ns,
+                    serve.ns_per_op(), bauds[b] / 10.0 / frame_bytes,
+                    100.0 * serve.ns_per_op() / byte_ns);
+    }
+    std::printf("  (parser crc errors: %u, framing errors: %u)\n", parser.get_crc_errors(),
+                parser.get_framing_errors());
+    return 0;
+}
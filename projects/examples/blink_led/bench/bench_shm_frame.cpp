@@ -0,0 +1,73 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "shm_frame.h"
+
+/**
+ * @brief Shared-memory frame publication throughput
+ *
+ * Measures the tick-thread cost of publish() with an idle region and with a
+ * reader copying frames as fast as it can, for several bank sizes. Half of
+ * the channel words change every frame.
+ */
+static void run_size(uint32_t channel_count) {
+    std::string const name = "/hw2_bench_shm_" + std::to_string(::getpid());
+    shm_frame_writer writer;
+    if (!writer.create(name.c_str(), channel_count)) {
+        std::printf("cannot create shared memory region\n");
+        return;
+    }
+    std::vector<uint32_t> words(writer.get_word_count());
+    uint64_t const frames = 2000000000ull / (channel_count + 1000);
+    char label[64];
+
+    std::snprintf(label, sizeof(label), "publish %u ch (no reader)", channel_count);
+    print_result(run_bench(label, frames, [&](uint32_t f) {
+        for (std::size_t i = 0; i < words.size(); i += 2) {
+            words[i] = f;
+        }
+        writer.publish(words.data(), f);
+    }));
+
+    shm_frame_reader reader;
+    reader.open(name.c_str());
+    std::atomic<bool> done(false);
+    uint64_t reads = 0;
+    std::thread consumer([&]() {
+        std::vector<uint32_t> copy(reader.get_word_count());
+        shm_frame_info info;
+        while (!done.load(std::memory_order_relaxed)) {
+            reader.read(copy.data(), info);
+            ++reads;
+        }
+    });
+
+    std::snprintf(label, sizeof(label), "publish %u ch (busy reader)", channel_count);
+    bench_result const busy = run_bench(label, frames, [&](uint32_t f) {
+        for (std::size_t i = 0; i < words.size(); i += 2) {
+            words[i] = f;
+        }
+        writer.publish(words.data(), f);
+    });
+    done.store(true);
+    consumer.join();
+    print_result(busy);
+    std::printf("%-40s %12.0f frames/s\n", "  reader consistent copies", reads * 1e9 / busy.total_ns);
+
+    shm_frame_writer::unlink(name.c_str());
+}
+
+int main() {
+    std::printf("=== shm_frame publication throughput ===\n");
+    run_size(64);
+    run_size(1024);
+    run_size(65536);
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "output_bank.h"
+#include "show_playback.h"
+
+/**
+ * @brief Seek latency on an hour-long show with 10k channels
+ *
+ * Every channel is retimed or phase-shifted about once a minute (600k
+ * events). For each checkpoint interval: memory, prepare() time and the
+ * latency of seeks to random times. The baseline is the per-millisecond
+ * loop that seeking used to need, timed over 10 s of show and scaled to
+ * an average seek (30 minutes in).
+ */
+static std::size_t const CHANNELS = 10000;
+static uint32_t const HOUR_MS = 3600000;
+
+typedef blink_controller<bank_pin> bench_controller;
+
+static std::vector<show_event> make_events() {
+    std::vector<show_event> events;
+    std::srand(7);
+    uint32_t time = 0;
+    while (time < HOUR_MS) {
+        show_event event;
+        event.time_ms = time;
+        event.channel = static_cast<uint32_t>(std::rand() % CHANNELS);
+        if (std::rand() % 4 != 0) {
+            event.type = show_event_type::set_durations;
+            event.a = static_cast<uint32_t>(50 + std::rand() % 2000);
+            event.b = static_cast<uint32_t>(50 + std::rand() % 2000);
+        } else {
+            event.type = show_event_type::shift_phase;
+            event.a = static_cast<uint32_t>(std::rand() % 400 - 200);
+            event.b = 0;
+        }
+        events.push_back(event);
+        time += static_cast<uint32_t>(std::rand() % 12);  // ~6 ms apart
+    }
+    return events;
+}
+
+static std::vector<bench_controller> make_controllers(std::vector<bank_pin>& pins) {
+    std::vector<bench_controller> controllers;
+    controllers.reserve(CHANNELS);
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        controllers.push_back(bench_controller(pins[c], 100 + c % 900, 100 + c % 700));
+    }
+    return controllers;
+}
+
+int main() {
+    static output_bank<CHANNELS> bank;
+    std::vector<bank_pin> pins;
+    for (std::size_t c = 0; c < CHANNELS; ++c) {
+        pins.push_back(bank.channel(c));
+    }
+    std::vector<show_event> const events = make_events();
+    std::printf("=== show playback (1 h, %zu channels, %zu events) ===\n", CHANNELS,
+                events.size());
+
+    uint32_t const intervals[] = {30000, 60000, 300000, HOUR_MS + 1};
+    for (uint32_t interval : intervals) {
+        std::vector<bench_controller> controllers = make_controllers(pins);
+        show_playback<bench_controller> show(controllers.data(), CHANNELS);
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            show.add_event(events[i]);
+        }
+        auto const start = std::chrono::steady_clock::now();
+        show.prepare(HOUR_MS, interval, std::size_t(1) << 30);
+        double const prepare_ms = std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count();
+        char name[64];
+        std::snprintf(name, sizeof(name), "seek, checkpoint every %u s",
+                      show.get_checkpoint_interval() / 1000);
+        bench_result const seek = run_bench(name, 200, [&](uint32_t i) {
+            show.seek((i * 2654435761u) % HOUR_MS);
+        });
+        std::printf("%-40s %9.2f ms/seek %8.1f MB %9.0f ms prepare\n", seek.name,
+                    seek.ns_per_op() / 1e6, show.get_checkpoint_bytes() / 1048576.0,
+                    prepare_ms);
+    }
+
+    // Baseline: per-millisecond playback from zero
+    std::vector<bench_controller> controllers = make_controllers(pins);
+    std::size_t next = 0;
+    bench_result const step = run_bench("per-ms replay", 10000, [&](uint32_t now) {
+        for (; next < events.size() && events[next].time_ms == now; ++next) {
+            show_event const& event = events[next];
+            if (event.type == show_event_type::set_durations) {
+                controllers[event.channel].set_durations(event.a, event.b);
+            } else {
+                controllers[event.channel].shift_phase(static_cast<int32_t>(event.a));
+            }
+        }
+        for (std::size_t c = 0; c < CHANNELS; ++c) {
+            controllers[c].update(now);
+        }
+    });
+    std::printf("%-40s %9.2f ms/seek (%.1f us per show ms)\n", "per-ms replay to 30 min",
+                step.ns_per_op() * (HOUR_MS / 2) / 1e6, step.ns_per_op() / 1000.0);
+    do_not_optimize(bank.words()[0]);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "fade_controller.h"
+#include "output_bank.h"
+#include "show_script.h"
+#include "show_vm.h"
+
+/**
+ * @brief Show script compiler and bytecode interpreter throughput
+ *
+ * - Interpreter: a level/fade/blink/stop/wait mix in a loop that never
+ *   yields, run in large instruction budgets, with channels bound to
+ *   fade_controllers on a level_bank and unbound (decode and dispatch only)
+ * - update() for 64 blinking channels, the per-tick cost of a running show
+ * - Compiler: a generated 100k-line script
+ * - Footprint: bytecode for a sample show, VM RAM on this host and for AVR
+ *   (field sizes with 2-byte pointers; no AVR toolchain here to measure)
+ */
+typedef fade_controller<level_pin> bench_fade;
+
+static char const* const SAMPLE_SHOW =
+    "# Hallway scare: porch flicker, then a fog-lit reveal on the motion sensor\n"
+    "channel porch 0\n"
+    "channel fog 1\n"
+    "channel eyes 2\n"
+    "loop\n"
+    "  blink porch 40ms 160ms 200\n"
+    "  fade fog 30 2s\n"
+    "  wait trigger 0\n"
+    "  level porch off\n"
+    "  fade fog 255 250ms\n"
+    "  repeat 6\n"
+    "    level eyes on\n"
+    "    wait 80\n"
+    "    level eyes off\n"
+    "    wait 120\n"
+    "  end\n"
+    "  fade fog 0 3s\n"
+    "  wait 5s\n"
+    "end\n";
+
+static std::size_t compile(char const* text, uint8_t* out, std::size_t capacity) {
+    show_script_error error;
+    std::size_t const size = compile_show_script(text, std::strlen(text), out, capacity, error);
+    if (size == 0) {
+        std::printf("compile error line %u: %s\n", error.line, error.message);
+    }
+    return size;
+}
+
+template<bool bound_v>
+static void bench_interpreter(char const* name) {
+    static level_bank<4> levels;
+    std::vector<level_pin> pins;
+    std::vector<bench_fade> fades;
+    for (std::size_t c = 0; c < 4; ++c) {
+        pins.push_back(levels.channel(c));
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+        fades.push_back(bench_fade(pins[c], 0));
+    }
+    uint8_t bytecode[64];
+    std::size_t const size = compile(
+        "loop\n level 0 10\n level 1 200\n fade 2 128 100\n blink 3 10 10\n stop 3\n"
+        " wait 0\nend\n",
+        bytecode, sizeof(bytecode));
+    static show_vm<bench_fade, 4, 65536> vm;
+    if (bound_v) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            vm.bind(c, fades[c]);
+        }
+    }
+    vm.load(bytecode, size);
+    vm.start(0);
+    uint32_t const ops_before = vm.get_op_count();
+    bench_result const result = run_bench(name, 200, [&](uint32_t i) { vm.update(i); });
+    uint32_t const ops = vm.get_op_count() - ops_before;
+    std::printf("%-40s %12.2f ns/op %14.0f ops/s\n", name, result.total_ns / ops,
+                ops * 1e9 / result.total_ns);
+    do_not_optimize(levels.get(0));
+}
+
+int main() {
+    std::printf("=== show_vm interpreter ===\n");
+    bench_interpreter<false>("op mix, unbound channels");
+    bench_interpreter<true>("op mix, fade_controller channels");
+
+    // Running show tick: 64 blinking channels, script waiting
+    static level_bank<64> levels;
+    std::vector<level_pin> pins;
+    for (std::size_t c = 0; c < 64; ++c) {
+        pins.push_back(levels.channel(c));
+    }
+    std::vector<bench_fade> fades;
+    for (std::size_t c = 0; c < 64; ++c) {
+        fades.push_back(bench_fade(pins[c], 0));
+    }
+    std::string script;
+    for (std::size_t c = 0; c < 64; ++c) {
+        script += "blink " + std::to_string(c) + " " + std::to_string(50 + c) + " " +
+                  std::to_string(200 - c) + "\n";
+    }
+    script += "loop\n wait 1s\nend\n";
+    std::vector<uint8_t> bytecode(1024);
+    std::size_t size = compile(script.c_str(), bytecode.data(), bytecode.size());
+    static show_vm<bench_fade, 64> vm;
+    for (std::size_t c = 0; c < 64; ++c) {
+        vm.bind(c, fades[c]);
+    }
+    vm.load(bytecode.data(), size);
+    vm.start(0);
+    print_result(run_bench("update(), 64 blinking channels", 2000000,
+                           [&](uint32_t i) { vm.update(i); }));
+    do_not_optimize(levels.get(0));
+
+    // Compiler throughput
+    std::printf("\n=== show_script compiler ===\n");
+    std::string big;
+    for (uint32_t i = 0; i < 100000; ++i) {
+        big += i % 4 == 0   ? "fade 3 200 1.5s\n"
+               : i % 4 == 1 ? "  blink 7 120ms 80ms 90  # flicker\n"
+               : i % 4 == 2 ? "wait 250\n"
+                            : "level 12 on\n";
+    }
+    bytecode.resize(big.size());
+    bench_result const compiled = run_bench("compile 100k lines", 20, [&](uint32_t) {
+        size = compile(big.c_str(), bytecode.data(), bytecode.size());
+    });
+    std::printf("%-40s %9.2f ms %11.0f MB/s text\n", compiled.name, compiled.ns_per_op() / 1e6,
+                big.size() / (compiled.ns_per_op() / 1e9) / 1e6);
+
+    // Footprint
+    std::printf("\n=== footprint ===\n");
+    size = compile(SAMPLE_SHOW, bytecode.data(), bytecode.size());
+    std::printf("sample show: %zu bytes of script, %zu bytes of bytecode\n",
+                std::strlen(SAMPLE_SHOW), size);
+    std::size_t const avr_registers = 2 + 2 + 2 + 2 + 4 + 4 + 1 + 1 + SHOW_VM_MAX_DEPTH * 8;
+    std::size_t const avr_channel = 4 + 4 + 4 + 1 + 1 + 1 + 2;
+    std::printf("VM RAM, 8 channels: %zu bytes on this host, %zu bytes on AVR\n",
+                sizeof(show_vm<bench_fade, 8>), avr_registers + 8 * avr_channel);
+    std::printf("VM RAM, 64 channels: %zu bytes on this host, %zu bytes on AVR\n",
+                sizeof(show_vm<bench_fade, 64>), avr_registers + 64 * avr_channel);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench_harness.h"
+#include "smf_import.h"
+
+/**
+ * @brief SMF cue import: parse cost and timing accuracy on a large file
+ *
+ * The file is format 1 with a tempo track (a tempo change every bar, as a
+ * live-recorded click produces) and 16 note/CC tracks, about 100k events:
+ *   - import: sizing pass + conversion into a cue array, per file
+ *   - tick_to_ms: random lookups in the tempo map
+ *   - drift: the same file timed with a float seconds accumulator (what a
+ *     naive importer does), compared with the exact import
+ */
+static uint16_t const DIVISION = 480;
+static uint32_t const TRACKS = 16;
+static uint32_t const EVENTS_PER_TRACK = 6250;
+static uint32_t const TICKS_PER_BAR = 4 * DIVISION;
+
+static void put_vlq(std::vector<uint8_t>& out, uint32_t value) {
+    uint8_t groups[5];
+    int count = 0;
+    do {
+        groups[count++] = value & 0x7F;
+        value >>= 7;
+    } while (value != 0);
+    while (count > 1) {
+        out.push_back(groups[--count] | 0x80);
+    }
+    out.push_back(groups[0]);
+}
+
+static void put_track(std::vector<uint8_t>& file, std::vector<uint8_t> const& track) {
+    uint32_t const size = static_cast<uint32_t>(track.size());
+    uint8_t const chunk[8] = {'M', 'T', 'r', 'k', static_cast<uint8_t>(size >> 24),
+                              static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 8),
+                              static_cast<uint8_t>(size)};
+    file.insert(file.end(), chunk, chunk + sizeof(chunk));
+    file.insert(file.end(), track.begin(), track.end());
+}
+
+// Tempo drifting around 120 BPM, changing every bar
+static uint32_t tempo_of_bar(uint32_t bar) {
+    return 500000 + (bar * 7919) % 20011 - 10000;
+}
+
+static std::vector<uint8_t> build_file(uint32_t& last_tick) {
+    uint8_t const header[14] = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1,
+                                0, static_cast<uint8_t>(TRACKS + 1),
+                                static_cast<uint8_t>(DIVISION >> 8),
+                                static_cast<uint8_t>(DIVISION)};
+    std::vector<uint8_t> file(header, header + sizeof(header));
+
+    // Note tracks: 16th notes and CC sweeps, offset per track
+    std::vector<std::vector<uint8_t> > tracks(TRACKS);
+    last_tick = 0;
+    for (uint32_t t = 0; t < TRACKS; ++t) {
+        std::vector<uint8_t>& track = tracks[t];
+        uint32_t tick = 0;
+        for (uint32_t e = 0; e < EVENTS_PER_TRACK; ++e) {
+            uint32_t const delta = e == 0 ? t * 7 : (e % 2 == 0 ? 120 : 0);
+            tick += delta;
+            put_vlq(track, delta);
+            if (e % 4 == 3) {
+                uint8_t const event[3] = {static_cast<uint8_t>(0xB0 | (t & 0x0F)), 1,
+                                          static_cast<uint8_t>(e & 0x7F)};
+                track.insert(track.end(), event, event + 3);
+            } else {
+                uint8_t const event[3] = {static_cast<uint8_t>(0x90 | (t & 0x0F)),
+                                          static_cast<uint8_t>(36 + e % 48),
+                                          static_cast<uint8_t>(e % 2 == 0 ? 100 : 0)};
+                track.insert(track.end(), event, event + 3);
+            }
+        }
+        uint8_t const end[4] = {0, 0xFF, 0x2F, 0};
+        track.insert(track.end(), end, end + 4);
+        last_tick = tick > last_tick ? tick : last_tick;
+    }
+
+    std::vector<uint8_t> tempo_track;
+    for (uint32_t bar = 0; bar * TICKS_PER_BAR <= last_tick; ++bar) {
+        put_vlq(tempo_track, bar == 0 ? 0 : TICKS_PER_BAR);
+        uint32_t const tempo = tempo_of_bar(bar);
+        uint8_t const event[6] = {0xFF, 0x51, 0x03, static_cast<uint8_t>(tempo >> 16),
+                                  static_cast<uint8_t>(tempo >> 8), static_cast<uint8_t>(tempo)};
+        tempo_track.insert(tempo_track.end(), event, event + 6);
+    }
+    uint8_t const end[4] = {0, 0xFF, 0x2F, 0};
+    tempo_track.insert(tempo_track.end(), end, end + 4);
+
+    put_track(file, tempo_track);
+    for (uint32_t t = 0; t < TRACKS; ++t) {
+        put_track(file, tracks[t]);
+    }
+    return file;
+}
+
+int main() {
+    uint32_t last_tick = 0;
+    std::vector<uint8_t> const file = build_file(last_tick);
+    smf_importer<32, 2048> importer;
+    std::size_t count = 0;
+    if (!importer.import(file.data(), file.size(), nullptr, 0, count)) {
+        std::printf("import failed\n");
+        return 1;
+    }
+    std::vector<midi_cue> cues(count);
+
+    std::printf("=== SMF import (%zu cues, %zu tempo changes, %zu KiB, %u ms long) ===\n", count,
+                importer.get_tempo_map().get_segment_count(), file.size() / 1024,
+                importer.get_tempo_map().tick_to_ms(last_tick));
+    bench_result result = run_bench("import: size + convert, per file", 50, [&](uint32_t) {
+        importer.import(file.data(), file.size(), nullptr, 0, count);
+        importer.import(file.data(), file.size(), cues.data(), cues.size(), count);
+        do_not_optimize(cues[count - 1].time_ms);
+    });
+    print_result(result);
+    std::printf("%-40s %12.2f ms/file %12.1f ns/cue\n", "import: 100k-event file",
+                result.ns_per_op() / 1e6, result.ns_per_op() / count);
+
+    smf_tempo_map<2048> const& map = importer.get_tempo_map();
+    print_result(run_bench("tick_to_ms: random tick", 5000000, [&](uint32_t i) {
+        do_not_optimize(map.tick_to_ms((i * 2654435761u) % last_tick));
+    }));
+
+    // Naive importer: seconds += delta * tempo / division, in float and double
+    float seconds_f = 0.0f;
+    double seconds_d = 0.0;
+    double worst_f = 0.0;
+    double worst_d = 0.0;
+    for (uint32_t tick = 0; tick <= last_tick; tick += 120) {
+        double const exact = map.tick_to_elapsed(tick) / (DIVISION * 1000.0);
+        worst_f = std::fmax(worst_f, std::fabs(seconds_f * 1000.0 - exact));
+        worst_d = std::fmax(worst_d, std::fabs(seconds_d * 1000.0 - exact));
+        uint32_t const tempo = tempo_of_bar(tick / TICKS_PER_BAR);
+        seconds_f += 120.0f * tempo / DIVISION / 1e6f;
+        seconds_d += 120.0 * tempo / DIVISION / 1e6;
+    }
+    std::printf("%-40s float %8.3f ms  double %8.6f ms  exact 0 ms\n", "drift: accumulated seconds",
+                worst_f, worst_d);
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "blink_controller.h"
+#include "realtime_profile.h"
+#include "tick_jitter.h"
+
+/**
+ * @brief Tick-loop latency before/after the real-time profile under load
+ *
+ * Runs a 1 kHz tick loop driving a bank of controllers while background
+ * threads burn CPU and churn memory (page faults, cache pressure). The same
+ * loop is measured twice: best-effort, then with apply_realtime_profile().
+ *
+ * Usage: bench_tick_jitter [seconds_per_run] [--cpu N]
+ */
+struct null_pin {
+    void set(bool state) { do_not_optimize(state); }
+};
+
+static void background_load(std::atomic<bool> const& stop, std::size_t churn_bytes) {
+    std::vector<char*> blocks;
+    uint32_t round = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        // Allocate, touch and release memory so the kernel keeps faulting pages in and out
+        char* const block = new char[churn_bytes];
+        std::memset(block, static_cast<int>(round), churn_bytes);
+        blocks.push_back(block);
+        if (blocks.size() > 8) {
+            delete[] blocks.front();
+            blocks.erase(blocks.begin());
+        }
+        ++round;
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        delete[] blocks[i];
+    }
+}
+
+static tick_jitter_histogram measure(uint32_t seconds) {
+    static std::size_t const CHANNELS = 256;
+    null_pin pin;
+    std::vector<blink_controller<null_pin> > controllers;
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        controllers.push_back(blink_controller<null_pin>(pin, 50 + i, 25 + i));
+    }
+
+    tick_jitter_histogram jitter;
+    periodic_ticker ticker(std::chrono::milliseconds(1));
+    uint32_t const ticks = seconds * 1000;
+    for (uint32_t t = 0; t < ticks; ++t) {
+        jitter.record(ticker.wait_next());
+        for (std::size_t i = 0; i < CHANNELS; ++i) {
+            controllers[i].update(t);
+        }
+    }
+    return jitter;
+}
+
+static void print_row(char const* label, tick_jitter_histogram const& jitter) {
+    std::printf("%-14s %8llu %8.1f %8u %8u %8u %8u\n", label,
+                static_cast<unsigned long long>(jitter.get_count()), jitter.get_mean_us(),
+                jitter.percentile_us(50.0), jitter.percentile_us(99.0),
+                jitter.percentile_us(99.9), jitter.get_max_us());
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = 5;
+    realtime_config config;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            config.cpu = std::atoi(argv[++i]);
+        } else {
+            seconds = static_cast<uint32_t>(std::atoi(argv[i]));
+        }
+    }
+
+    unsigned const load_threads = std::thread::hardware_concurrency() + 1;
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> load;
+    for (unsigned i = 0; i < load_threads; ++i) {
+        load.push_back(std::thread(background_load, std::cref(stop), 4u * 1024 * 1024));
+    }
+
+    std::printf("=== tick jitter at 1 kHz, %u load threads, %us per run ===\n", load_threads,
+                seconds);
+    std::printf("%-14s %8s %8s %8s %8s %8s %8s\n", "profile", "ticks", "mean_us", "p50_us",
+                "p99_us", "p99.9_us", "max_us");
+
+    tick_jitter_histogram const before = measure(seconds);
+    print_row("best-effort", before);
+
+    realtime_status const status = apply_realtime_profile(config);
+    tick_jitter_histogram const after = measure(seconds);
+    print_row("realtime", after);
+
+    std::printf("\nrealtime profile: mlockall=%s prefault=%s/%s affinity=%s SCHED_FIFO=%s\n",
+                status.memory_locked ? "yes" : "no", status.stack_prefaulted ? "stack" : "-",
+                status.heap_prefaulted ? "heap" : "-",
+                config.cpu < 0 ? "not requested" : (status.cpu_pinned ? "yes" : "no"),
+                status.fifo_scheduling ? "yes" : "no");
+
+    release_realtime_profile(status);
+    stop.store(true);
+    for (std::size_t i = 0; i < load.size(); ++i) {
+        load[i].join();
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "fd_serial.h"
+#include "serial_protocol.h"
+#include "virtual_board.h"
+
+/**
+ * @brief End-to-end command latency and throughput against a virtual board
+ *
+ * The host side opens the board's /dev/pts/N like a real serial device and
+ * talks the serial command protocol through the kernel tty layer. For each
+ * baud rate:
+ *   - query round trips, one at a time (p50/p99/max latency)
+ *   - set_durations pipelined with a window of 4 (60 bytes, inside the board's
+ *     64-byte RX buffer): commands/s vs the line limit, and commands lost
+ * The board runs loop() on every wakeup, like a sketch with an empty loop.
+ * Baud 0 is an unthrottled pty, i.e. the software overhead alone.
+ */
+typedef std::chrono::steady_clock bench_clock;
+
+static double since_us(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(bench_clock::now() - start).count();
+}
+
+static std::vector<uint8_t> command_frame(serial_message type, uint8_t seq, uint8_t channel) {
+    serial_frame_builder<> builder;
+    builder.begin(type, seq, channel);
+    if (type == serial_message::set_durations) {
+        builder.put_u32(100 + seq);
+        builder.put_u32(200);
+    }
+    uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+    std::size_t const length = builder.finish(wire, sizeof(wire));
+    return std::vector<uint8_t>(wire, wire + length);
+}
+
+// Wait for one reply frame (false on timeout)
+static bool wait_reply(fd_serial& host, serial_parser<>& parser, double timeout_us) {
+    bench_clock::time_point const start = bench_clock::now();
+    while (since_us(start) < timeout_us) {
+        while (host.available() > 0) {
+            serial_frame frame;
+            if (parser.push(static_cast<uint8_t>(host.read()), frame)) {
+                return true;
+            }
+        }
+        pollfd pfd = {host.get_fd(), POLLIN, 0};
+        ::poll(&pfd, 1, 10);
+    }
+    return false;
+}
+
+static void run_baud(uint32_t baud) {
+    virtual_board board;
+    if (!board.open(baud)) {
+        std::printf("no pty available\n");
+        return;
+    }
+    blink_board_sketch<8> sketch(board.get_serial(), 500, 500);
+    board.start(&blink_board_sketch<8>::loop, &sketch, 0);
+    int const fd = open_serial_device(board.get_device_path());
+    if (fd < 0) {
+        std::printf("cannot open %s\n", board.get_device_path());
+        return;
+    }
+    fd_serial host(fd);
+    serial_parser<> parser;
+
+    // Round-trip latency
+    static int const ROUND_TRIPS = 200;
+    std::vector<double> rtts;
+    for (int i = 0; i < ROUND_TRIPS; ++i) {
+        std::vector<uint8_t> const query =
+            command_frame(serial_message::query, static_cast<uint8_t>(i), 0);
+        bench_clock::time_point const start = bench_clock::now();
+        host.write(query.data(), query.size());
+        if (!wait_reply(host, parser, 1e6)) {
+            std::printf("timeout\n");
+            break;
+        }
+        rtts.push_back(since_us(start));
+    }
+    std::sort(rtts.begin(), rtts.end());
+
+    // Pipelined throughput
+    static std::size_t const COMMANDS = 1000;
+    static std::size_t const WINDOW = 4;
+    std::size_t sent = 0;
+    std::size_t acked = 0;
+    std::size_t lost = 0;
+    std::size_t bytes = 0;
+    bench_clock::time_point const start = bench_clock::now();
+    while (acked + lost < COMMANDS) {
+        while (sent < COMMANDS && sent - acked - lost < WINDOW) {
+            std::vector<uint8_t> const frame = command_frame(
+                serial_message::set_durations, static_cast<uint8_t>(sent), sent % 8);
+            host.write(frame.data(), frame.size());
+            bytes += frame.size();
+            ++sent;
+        }
+        // A command whose bytes were overrun never gets a reply
+        if (wait_reply(host, parser, 100000)) {
+            ++acked;
+        } else {
+            ++lost;
+        }
+    }
+    double const seconds = since_us(start) / 1e6;
+    double const rate = acked / seconds;
+
+    char label[32];
+    std::snprintf(label, sizeof(label), "%u", baud);
+    double const line = baud == 0 ? 0.0 : baud / 10.0 / (static_cast<double>(bytes) / COMMANDS);
+    std::printf("%-10s %9.0f %9.0f %9.0f %12.0f %12.0f %6zu\n", baud == 0 ? "unlimited" : label,
+                rtts.empty() ? 0.0 : rtts[rtts.size() / 2],
+                rtts.empty() ? 0.0 : rtts[rtts.size() * 99 / 100],
+                rtts.empty() ? 0.0 : rtts.back(), rate, line, lost);
+
+    board.stop();
+    ::close(fd);
+}
+
+int main() {
+    std::printf("=== virtual board: query round trip (us) and pipelined set_durations ===\n");
+    std::printf("%-10s %9s %9s %9s %12s %12s %6s\n", "baud", "rtt p50", "rtt p99", "rtt max",
+                "cmds/s", "line cmds/s", "lost");
+    uint32_t const bauds[] = {115200, 1000000, 0};
+    for (std::size_t i = 0; i < sizeof(bauds) / sizeof(bauds[0]); ++i) {
+        run_baud(bauds[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,648 @@
+#pragma once
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief How an async_sink gets bytes to its file descriptor
+ */
+enum class sink_backend {
+    blocking,  // write() on the calling thread (baseline)
+    thread,    // Hand filled buffers to a writer thread
+    io_uring,  // Submit buffers to the kernel with io_uring, reap completions later
+    automatic  // io_uring when available, otherwise thread
+};
+
+inline char const* sink_backend_name(sink_backend backend) {
+    switch (backend) {
+        case sink_backend::blocking:
+            return "blocking";
+        case sink_backend::thread:
+            return "thread";
+        case sink_backend::io_uring:
+            return "io_uring";
+        default:
+            return "automatic";
+    }
+}
+
+/**
+ * @brief Single-producer single-consumer queue of buffer indices
+ *
+ * Used between the tick thread and the thread backend's writer.
+ */
+struct index_queue {
+   public:
+    void init(std::size_t capacity) {
+        slots_.assign(capacity + 1, 0);
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    bool push(uint32_t value) {
+        std::size_t const tail = tail_.load(std::memory_order_relaxed);
+        std::size_t const next = (tail + 1) % slots_.size();
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots_[tail] = value;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(uint32_t& value) {
+        std::size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots_[head];
+        head_.store((head + 1) % slots_.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+   private:
+    std::vector<uint32_t> slots_;
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+};
+
+/**
+ * @brief Minimal io_uring wrapper over the raw system calls
+ *
+ * Only what async_sink needs: one submission/completion ring pair,
+ * registered buffers and WRITE/WRITE_FIXED requests. No liburing dependency.
+ */
+struct uring_writer {
+   public:
+    uring_writer()
+        : ring_fd_(-1),
+          sq_ring_(nullptr),
+          cq_ring_(nullptr),
+          sqes_(nullptr),
+          sq_ring_size_(0),
+          cq_ring_size_(0),
+          sqes_size_(0),
+          fixed_buffers_(false) {}
+
+    ~uring_writer() { close(); }
+
+    uring_writer(uring_writer const&) = delete;
+    uring_writer& operator=(uring_writer const&) = delete;
+
+    /**
+     * @brief Create the rings
+     *
+     * @param entries Submission queue size (power of two)
+     * @return false io_uring unavailable (old kernel, seccomp, ...)
+     */
+    bool open(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd_ < 0) {
+            return false;
+        }
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = sq_ring_size_ > cq_ring_size_ ? sq_ring_size_
+                                                                         : cq_ring_size_;
+        }
+        sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(
+            static_cast<void*>(map(sqes_size_, IORING_OFF_SQES)));
+        if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr) {
+            close();
+            return false;
+        }
+
+        sq_head_ = ring_field(sq_ring_, params.sq_off.head);
+        sq_tail_ = ring_field(sq_ring_, params.sq_off.tail);
+        sq_mask_ = *ring_field(sq_ring_, params.sq_off.ring_mask);
+        sq_array_ = ring_field(sq_ring_, params.sq_off.array);
+        cq_head_ = ring_field(cq_ring_, params.cq_off.head);
+        cq_tail_ = ring_field(cq_ring_, params.cq_off.tail);
+        cq_mask_ = *ring_field(cq_ring_, params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring_ + params.cq_off.cqes);
+        return true;
+    }
+
+    void close() {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ != nullptr) {
+            ::munmap(sq_ring_, sq_ring_size_);
+        }
+        if (ring_fd_ >= 0) {
+            ::close(ring_fd_);
+        }
+        ring_fd_ = -1;
+        sq_ring_ = cq_ring_ = nullptr;
+        sqes_ = nullptr;
+        fixed_buffers_ = false;
+    }
+
+    /**
+     * @brief Register buffers for WRITE_FIXED (pins them once, not per write)
+     *
+     * @return false Registration refused (e.g. RLIMIT_MEMLOCK); plain writes still work
+     */
+    bool register_buffers(iovec const* buffers, unsigned count) {
+        fixed_buffers_ = ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                                   buffers, count) == 0;
+        return fixed_buffers_;
+    }
+
+    /**
+     * @brief Queue and submit one write (does not wait for it)
+     *
+     * @param offset File offset, or -1 for the current position / stream fds
+     * @param user_data Returned with the completion
+     * @return false Submission queue full
+     */
+    bool submit_write(int fd, char const* data, uint32_t length, uint64_t offset,
+                      int buffer_index, uint64_t user_data) {
+        unsigned const tail = *sq_tail_;
+        if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) > sq_mask_) {
+            return false;
+        }
+        unsigned const index = tail & sq_mask_;
+        io_uring_sqe* const sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = fixed_buffers_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->buf_index = static_cast<uint16_t>(fixed_buffers_ ? buffer_index : 0);
+        sqe->user_data = user_data;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+        // Also resubmits anything a failed earlier enter left in the ring
+        unsigned const pending = tail + 1 - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        ::syscall(__NR_io_uring_enter, ring_fd_, pending, 0, 0, nullptr, 0);
+        return true;
+    }
+
+    /**
+     * @brief Collect finished writes without blocking (or wait for at least one)
+     *
+     * @param callback Called as callback(user_data, result) for each completion
+     * @param wait Block until at least one completion is available
+     * @return std::size_t Number of completions reaped
+     */
+    template<typename callback_t>
+    std::size_t reap(callback_t callback, bool wait) {
+        if (wait && *cq_head_ == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+            ::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        }
+        unsigned head = *cq_head_;
+        unsigned const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        std::size_t count = 0;
+        while (head != tail) {
+            io_uring_cqe const& cqe = cqes_[head & cq_mask_];
+            callback(cqe.user_data, cqe.res);
+            ++head;
+            ++count;
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    bool is_open() const { return ring_fd_ >= 0; }
+    bool has_fixed_buffers() const { return fixed_buffers_; }
+
+   private:
+    char* map(std::size_t size, off_t offset) {
+        void* const ptr =
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : static_cast<char*>(ptr);
+    }
+
+    static unsigned* ring_field(char* ring, unsigned offset) {
+        return reinterpret_cast<unsigned*>(ring + offset);
+    }
+
+    int ring_fd_;
+    char* sq_ring_;
+    char* cq_ring_;
+    io_uring_sqe* sqes_;
+    std::size_t sq_ring_size_;
+    std::size_t cq_ring_size_;
+    std::size_t sqes_size_;
+    bool fixed_buffers_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+};
+
+/**
+ * @brief Buffered output sink that keeps blocking write()s off the tick thread
+ *
+ * The tick thread appends bytes into one of a fixed pool of buffers
+ * (allocated once in open()); full buffers, and the partially filled one at
+ * flush() when nothing is in flight, are handed to the backend:
+ * - io_uring: submitted as (registered-buffer) writes, completions reaped by poll()
+ * - thread:   queued to a writer thread over a lock-free SPSC queue
+ * - blocking: written immediately (baseline for comparison)
+ *
+ * Ordering is preserved: seekable fds (regular files) get explicit offsets so
+ * several writes may be in flight; streams (pipes, ttys) have one write in
+ * flight at a time. When every buffer is busy, new bytes are dropped and
+ * counted rather than stalling the tick loop.
+ *
+ * The file descriptor is owned by the caller. Linux only.
+ *
+ * Usage:
+ *   async_sink trace;
+ *   trace.open(fd, sink_backend::automatic);
+ *   trace.write(line, length);  // every tick
+ *   trace.flush();              // end of tick: submit if the backend is idle
+ *   trace.poll();               // recycle finished buffers
+ *   trace.drain();              // at shutdown
+ */
+struct async_sink {
+   public:
+    static std::size_t const DEFAULT_BUFFER_SIZE = 64 * 1024;
+    static std::size_t const DEFAULT_BUFFER_COUNT = 8;
+
+    async_sink()
+        : fd_(-1),
+          backend_(sink_backend::blocking),
+          buffer_size_(0),
+          filling_(NO_BUFFER),
+          seekable_(false),
+          next_offset_(0),
+          in_flight_(0),
+          stop_(false),
+          bytes_written_(0),
+          bytes_dropped_(0),
+          write_errors_(0),
+          submissions_(0) {}
+
+    ~async_sink() { close(); }
+
+    async_sink(async_sink const&) = delete;
+    async_sink& operator=(async_sink const&) = delete;
+
+    /**
+     * @brief Attach to a descriptor and allocate the buffer pool
+     *
+     * @param fd Destination (file, pipe, tty); not closed by the sink
+     * @param backend Requested backend (automatic = io_uring, else thread)
+     * @param buffer_size Bytes per buffer
+     * @param buffer_count Buffers in the pool
+     * @return false Requested backend unavailable
+     */
+    bool open(int fd, sink_backend backend, std::size_t buffer_size = DEFAULT_BUFFER_SIZE,
+              std::size_t buffer_count = DEFAULT_BUFFER_COUNT) {
+        close();
+        fd_ = fd;
+        buffer_size_ = buffer_size;
+        storage_.assign(buffer_size * buffer_count, '\0');
+        lengths_.assign(buffer_count, 0);
+        written_.assign(buffer_count, 0);
+        offsets_.assign(buffer_count, 0);
+        free_.clear();
+        for (std::size_t i = buffer_count; i > 0; --i) {
+            free_.push_back(static_cast<uint32_t>(i - 1));
+        }
+        ready_.init(buffer_count);
+        done_.init(buffer_count);
+        filling_ = NO_BUFFER;
+        in_flight_ = 0;
+        bytes_written_.store(0, std::memory_order_relaxed);
+        write_errors_.store(0, std::memory_order_relaxed);
+        bytes_dropped_ = submissions_ = 0;
+
+        off_t const position = ::lseek(fd, 0, SEEK_CUR);
+        seekable_ = position >= 0;
+        next_offset_ = seekable_ ? static_cast<uint64_t>(position) : 0;
+
+        if (backend == sink_backend::io_uring || backend == sink_backend::automatic) {
+            if (open_uring(buffer_count)) {
+                backend_ = sink_backend::io_uring;
+                return true;
+            }
+            if (backend == sink_backend::io_uring) {
+                fd_ = -1;
+                return false;
+            }
+            backend = sink_backend::thread;
+        }
+        backend_ = backend;
+        if (backend_ == sink_backend::thread) {
+            stop_.store(false);
+            writer_ = std::thread(&async_sink::writer_loop, this);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Flush, wait for outstanding writes and release the backend
+     */
+    void close() {
+        if (fd_ < 0) {
+            return;
+        }
+        drain();
+        if (writer_.joinable()) {
+            stop_.store(true);
+            wake_writer();
+            writer_.join();
+        }
+        uring_.close();
+        fd_ = -1;
+    }
+
+    /**
+     * @brief Append bytes (tick thread; never blocks on I/O for async backends)
+     *
+     * @return false Some bytes were dropped because every buffer was busy
+     */
+    bool write(char const* data, std::size_t length) {
+        while (length > 0) {
+            if (filling_ == NO_BUFFER && !acquire_buffer()) {
+                bytes_dropped_ += length;
+                return false;
+            }
+            std::size_t const room = buffer_size_ - lengths_[filling_];
+            std::size_t const chunk = length < room ? length : room;
+            std::memcpy(buffer(filling_) + lengths_[filling_], data, chunk);
+            lengths_[filling_] += chunk;
+            data += chunk;
+            length -= chunk;
+            if (lengths_[filling_] == buffer_size_) {
+                submit_filling();
+            }
+        }
+        return true;
+    }
+
+    bool write(char const* text) { return write(text, std::strlen(text)); }
+
+    /**
+     * @brief Hand off buffered bytes if the backend is idle (call once per tick)
+     *
+     * While earlier writes are still in flight, bytes keep accumulating in
+     * the current buffer instead, so a stalled destination gets a few large
+     * writes rather than one tiny write per tick.
+     */
+    void flush() {
+        poll();
+        if (filling_ != NO_BUFFER && lengths_[filling_] > 0 && in_flight_ == 0 &&
+            queued_.empty()) {
+            submit_filling();
+        }
+    }
+
+    /**
+     * @brief Recycle buffers whose writes completed (non-blocking)
+     */
+    void poll() { reap(false); }
+
+    /**
+     * @brief Submit everything buffered and block until it has been written
+     */
+    void drain() {
+        if (filling_ != NO_BUFFER && lengths_[filling_] > 0) {
+            submit_filling();
+        }
+        while (in_flight_ > 0 || !queued_.empty()) {
+            reap(true);
+        }
+    }
+
+    sink_backend get_backend() const { return backend_; }
+    bool has_registered_buffers() const { return uring_.has_fixed_buffers(); }
+    bool is_seekable() const { return seekable_; }
+    uint64_t get_bytes_written() const {
+        return bytes_written_.load(std::memory_order_relaxed);
+    }
+    uint64_t get_bytes_dropped() const { return bytes_dropped_; }
+    uint64_t get_write_errors() const { return write_errors_.load(std::memory_order_relaxed); }
+    uint64_t get_submissions() const { return submissions_; }
+    std::size_t get_free_buffers() const { return free_.size(); }
+
+   private:
+    static uint32_t const NO_BUFFER = 0xffffffffu;
+
+    char* buffer(uint32_t index) { return &storage_[index * buffer_size_]; }
+
+    bool open_uring(std::size_t buffer_count) {
+        unsigned entries = 1;
+        while (entries < buffer_count) {
+            entries <<= 1;
+        }
+        if (!uring_.open(entries)) {
+            return false;
+        }
+        std::vector<iovec> iovecs(buffer_count);
+        for (std::size_t i = 0; i < buffer_count; ++i) {
+            iovecs[i].iov_base = buffer(static_cast<uint32_t>(i));
+            iovecs[i].iov_len = buffer_size_;
+        }
+        uring_.register_buffers(iovecs.data(), static_cast<unsigned>(buffer_count));
+        return true;
+    }
+
+    bool acquire_buffer() {
+        if (free_.empty()) {
+            poll();
+            if (free_.empty()) {
+                return false;
+            }
+        }
+        filling_ = free_.back();
+        free_.pop_back();
+        lengths_[filling_] = 0;
+        written_[filling_] = 0;
+        return true;
+    }
+
+    void submit_filling() {
+        uint32_t const index = filling_;
+        filling_ = NO_BUFFER;
+        offsets_[index] = next_offset_;
+        next_offset_ += lengths_[index];
+        ++submissions_;
+
+        switch (backend_) {
+            case sink_backend::blocking:
+                write_fully(index);
+                release(index);
+                break;
+            case sink_backend::thread:
+                ready_.push(index);
+                ++in_flight_;
+                wake_writer();
+                break;
+            default:
+                // Streams keep a single write in flight to preserve order
+                queued_.push_back(index);
+                start_queued();
+                break;
+        }
+    }
+
+    void start_queued() {
+        while (!queued_.empty() && (seekable_ || in_flight_ == 0)) {
+            uint32_t const index = queued_.front();
+            if (!start_uring_write(index)) {
+                break;
+            }
+            queued_.erase(queued_.begin());
+            ++in_flight_;
+        }
+    }
+
+    bool start_uring_write(uint32_t index) {
+        uint64_t const offset = seekable_ ? offsets_[index] + written_[index] : uint64_t(-1);
+        return uring_.submit_write(fd_, buffer(index) + written_[index],
+                                   static_cast<uint32_t>(lengths_[index] - written_[index]),
+                                   offset, static_cast<int>(index), index);
+    }
+
+    void reap(bool wait) {
+        if (backend_ == sink_backend::io_uring) {
+            uring_.reap(
+                [this](uint64_t user_data, int32_t result) {
+                    on_uring_complete(static_cast<uint32_t>(user_data), result);
+                },
+                wait && in_flight_ > 0);
+            start_queued();
+        } else if (backend_ == sink_backend::thread) {
+            uint32_t index;
+            bool any = false;
+            while (done_.pop(index)) {
+                --in_flight_;
+                release(index);
+                any = true;
+            }
+            if (wait && !any && in_flight_ > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    void on_uring_complete(uint32_t index, int32_t result) {
+        --in_flight_;
+        if (result > 0) {
+            written_[index] += static_cast<std::size_t>(result);
+            bytes_written_.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+            if (written_[index] < lengths_[index]) {
+                // Short write: resubmit the remainder ahead of anything queued
+                queued_.insert(queued_.begin(), index);
+                return;
+            }
+        } else if (result < 0 && result != -EAGAIN && result != -EINTR) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            queued_.insert(queued_.begin(), index);
+            return;
+        }
+        release(index);
+    }
+
+    // Blocking write of one buffer, looping over short writes
+    bool write_fully(uint32_t index) {
+        while (written_[index] < lengths_[index]) {
+            ssize_t const n = ::write(fd_, buffer(index) + written_[index],
+                                      lengths_[index] - written_[index]);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                write_errors_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            written_[index] += static_cast<std::size_t>(n);
+            bytes_written_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void release(uint32_t index) { free_.push_back(index); }
+
+    void wake_writer() {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_.notify_one();
+    }
+
+    void writer_loop() {
+        for (;;) {
+            uint32_t index;
+            if (ready_.pop(index)) {
+                write_fully(index);
+                done_.push(index);
+                continue;
+            }
+            if (stop_.load()) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(1),
+                           [this]() { return !ready_.empty() || stop_.load(); });
+        }
+    }
+
+    int fd_;
+    sink_backend backend_;
+    std::size_t buffer_size_;
+    std::vector<char> storage_;
+    std::vector<std::size_t> lengths_;
+    std::vector<std::size_t> written_;
+    std::vector<uint64_t> offsets_;
+    std::vector<uint32_t> free_;
+    std::vector<uint32_t> queued_;
+    uint32_t filling_;
+    bool seekable_;
+    uint64_t next_offset_;
+    std::size_t in_flight_;
+
+    uring_writer uring_;
+
+    std::thread writer_;
+    index_queue ready_;
+    index_queue done_;
+    std::atomic<bool> stop_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+
+    // Also bumped by the writer thread; statistics only, so relaxed
+    std::atomic<uint64_t> bytes_written_;
+    uint64_t bytes_dropped_;
+    std::atomic<uint64_t> write_errors_;
+    uint64_t submissions_;
+};
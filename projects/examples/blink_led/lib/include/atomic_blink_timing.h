@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock-free mailbox for retiming a blink_controller from another thread
+ *
+ * A control thread publishes new ON/OFF durations and phase shifts; the tick
+ * thread copies them into its controller with apply_to() right before
+ * update(). Both durations travel together in one packed 64-bit atomic, so
+ * the tick thread can never observe a new ON duration paired with an old OFF
+ * duration. Phase shifts accumulate in a separate counter and are consumed
+ * exactly once.
+ *
+ * Desktop/host only (requires <atomic>); blink_controller itself stays
+ * single-threaded and AVR-friendly.
+ *
+ * Timing semantics (see blink_controller::set_durations/shift_phase):
+ * - Durations take effect at the next edge
+ * - Phase shifts take effect immediately on the interval in progress
+ *
+ * Usage:
+ *   atomic_blink_timing timing(1000, 500);
+ *
+ *   // Control thread
+ *   timing.store(250, 250);
+ *   timing.shift_phase(-100);
+ *
+ *   // Tick thread
+ *   timing.apply_to(controller);
+ *   controller.update(timer.millis());
+ */
+struct atomic_blink_timing {
+   public:
+    atomic_blink_timing(uint32_t on_duration_ms, uint32_t off_duration_ms)
+        : packed_(pack(on_duration_ms, off_duration_ms)), pending_phase_ms_(0) {}
+
+    /**
+     * @brief Publish new durations (any thread, wait-free)
+     *
+     * @param on_duration_ms New ON duration (milliseconds)
+     * @param off_duration_ms New OFF duration (milliseconds)
+     */
+    void store(uint32_t on_duration_ms, uint32_t off_duration_ms) {
+        packed_.store(pack(on_duration_ms, off_duration_ms), std::memory_order_release);
+    }
+
+    /**
+     * @brief Request a phase shift (any thread, wait-free)
+     *
+     * @param delta_ms Positive delays the next edge, negative advances it
+     */
+    void shift_phase(int32_t delta_ms) {
+        pending_phase_ms_.fetch_add(delta_ms, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Copy the latest timing into a controller (tick thread only)
+     *
+     * Costs one 64-bit load plus one 32-bit load when no phase shift is
+     * pending; the read-modify-write only happens when there is a shift to
+     * consume.
+     *
+     * @tparam controller_t Type with set_durations() and shift_phase()
+     * @param controller Controller to retime
+     */
+    template<typename controller_t>
+    void apply_to(controller_t& controller) {
+        uint64_t const packed = packed_.load(std::memory_order_acquire);
+        controller.set_durations(unpack_on(packed), unpack_off(packed));
+
+        if (pending_phase_ms_.load(std::memory_order_relaxed) != 0) {
+            controller.shift_phase(pending_phase_ms_.exchange(0, std::memory_order_acq_rel));
+        }
+    }
+
+    // Getters for testing and state inspection
+    uint32_t get_on_duration() const { return unpack_on(packed_.load(std::memory_order_acquire)); }
+    uint32_t get_off_duration() const {
+        return unpack_off(packed_.load(std::memory_order_acquire));
+    }
+    int32_t get_pending_phase() const { return pending_phase_ms_.load(std::memory_order_relaxed); }
+    bool is_lock_free() const { return packed_.is_lock_free() && pending_phase_ms_.is_lock_free(); }
+
+    static uint64_t pack(uint32_t on_duration_ms, uint32_t off_duration_ms) {
+        return (static_cast<uint64_t>(on_duration_ms) << 32) | off_duration_ms;
+    }
+    static uint32_t unpack_on(uint64_t packed) { return static_cast<uint32_t>(packed >> 32); }
+    static uint32_t unpack_off(uint64_t packed) { return static_cast<uint32_t>(packed); }
+
+   private:
+    std::atomic<uint64_t> packed_;
+    std::atomic<int32_t> pending_phase_ms_;
+};
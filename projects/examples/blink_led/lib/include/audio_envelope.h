@@ -0,0 +1,368 @@
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "wav_file.h"
+
+/**
+ * @brief Loudness of one block of samples
+ *
+ * Sums are exact integers, so the SIMD and scalar paths agree bit for bit.
+ * |-32768| is counted as 32767 (saturating absolute value) on both paths.
+ */
+struct envelope_stats {
+    uint64_t sum_squares;
+    uint32_t samples;
+    uint16_t peak;
+
+    uint16_t rms() const {
+        return samples == 0
+                   ? 0
+                   : static_cast<uint16_t>(std::sqrt(static_cast<double>(sum_squares) / samples) +
+                                           0.5);
+    }
+};
+
+namespace envelope_detail {
+
+inline uint16_t saturating_abs(int16_t sample) {
+    return sample == -32768 ? 32767 : static_cast<uint16_t>(sample < 0 ? -sample : sample);
+}
+
+inline void accumulate_scalar(int16_t const* samples, std::size_t count, envelope_stats& stats) {
+    for (std::size_t i = 0; i < count; ++i) {
+        uint16_t const magnitude = saturating_abs(samples[i]);
+        stats.sum_squares += static_cast<uint32_t>(magnitude) * magnitude;
+        stats.peak = magnitude > stats.peak ? magnitude : stats.peak;
+    }
+    stats.samples += static_cast<uint32_t>(count);
+}
+
+}  // namespace envelope_detail
+
+/**
+ * @brief Block loudness, portable reference implementation
+ */
+inline envelope_stats envelope_block_scalar(int16_t const* samples, std::size_t count) {
+    envelope_stats stats = {0, 0, 0};
+    envelope_detail::accumulate_scalar(samples, count, stats);
+    return stats;
+}
+
+/**
+ * @brief Block loudness, 8 samples per step with SSE2 or NEON
+ *
+ * Squares of saturated magnitudes are paired into 32-bit lanes
+ * (2 * 32767^2 < 2^31) and widened into 64-bit accumulators, so the sum is
+ * exact for any block length. Falls back to envelope_block_scalar() on
+ * other targets.
+ */
+inline envelope_stats envelope_block(int16_t const* samples, std::size_t count) {
+    envelope_stats stats = {0, 0, 0};
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    __m128i const zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    __m128i peaks = zero;
+    for (; i + 8 <= count; i += 8) {
+        __m128i const x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(samples + i));
+        __m128i const magnitude = _mm_max_epi16(x, _mm_subs_epi16(zero, x));
+        peaks = _mm_max_epi16(peaks, magnitude);
+        __m128i const squares = _mm_madd_epi16(magnitude, magnitude);
+        sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(squares, zero));
+        sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(squares, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+    int16_t peak_lanes[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(peak_lanes), peaks);
+    stats.sum_squares = lanes[0] + lanes[1];
+    for (int lane = 0; lane < 8; ++lane) {
+        uint16_t const peak = static_cast<uint16_t>(peak_lanes[lane]);
+        stats.peak = peak > stats.peak ? peak : stats.peak;
+    }
+#elif defined(__ARM_NEON)
+    int64x2_t sums = vdupq_n_s64(0);
+    int16x8_t peaks = vdupq_n_s16(0);
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t const magnitude = vqabsq_s16(vld1q_s16(samples + i));
+        peaks = vmaxq_s16(peaks, magnitude);
+        int32x4_t squares = vmull_s16(vget_low_s16(magnitude), vget_low_s16(magnitude));
+        squares = vmlal_s16(squares, vget_high_s16(magnitude), vget_high_s16(magnitude));
+        sums = vpadalq_s32(sums, squares);
+    }
+    stats.sum_squares = static_cast<uint64_t>(vgetq_lane_s64(sums, 0)) +
+                        static_cast<uint64_t>(vgetq_lane_s64(sums, 1));
+    int16_t peak_lanes[8];
+    vst1q_s16(peak_lanes, peaks);
+    for (int lane = 0; lane < 8; ++lane) {
+        uint16_t const peak = static_cast<uint16_t>(peak_lanes[lane]);
+        stats.peak = peak > stats.peak ? peak : stats.peak;
+    }
+#endif
+    stats.samples = static_cast<uint32_t>(i);
+    envelope_detail::accumulate_scalar(samples + i, count - i, stats);
+    return stats;
+}
+
+/**
+ * @brief Attack/release smoothing of block loudness into an 8-bit level
+ *
+ * One-pole follower per block: rises with the attack time constant, falls
+ * with the release one. gain scales full-scale input (1.0: a full-scale
+ * block reads 255; 4.0: a quarter of full scale already reads 255).
+ */
+struct envelope_follower {
+   public:
+    struct settings {
+        uint32_t attack_ms;
+        uint32_t release_ms;
+        float gain;
+        bool use_peak;  // Follow block peaks instead of RMS
+    };
+
+    envelope_follower() : attack_(1.0f), release_(1.0f), gain_(1.0f), use_peak_(false), value_(0) {}
+
+    /**
+     * @param block_ms Duration of one block (frames / sample rate)
+     */
+    void configure(settings const& s, float block_ms) {
+        attack_ = coefficient(s.attack_ms, block_ms);
+        release_ = coefficient(s.release_ms, block_ms);
+        gain_ = s.gain;
+        use_peak_ = s.use_peak;
+        value_ = 0.0f;
+    }
+
+    uint8_t push(envelope_stats const& stats) {
+        float const input = (use_peak_ ? stats.peak : stats.rms()) * gain_ / 32767.0f;
+        value_ += (input - value_) * (input > value_ ? attack_ : release_);
+        return get_level();
+    }
+
+    uint8_t get_level() const {
+        float const level = value_ * 255.0f + 0.5f;
+        return level >= 255.0f ? 255 : static_cast<uint8_t>(level);
+    }
+
+   private:
+    // Fraction of the gap closed per block for a time constant
+    static float coefficient(uint32_t time_ms, float block_ms) {
+        return time_ms == 0 ? 1.0f : 1.0f - std::exp(-block_ms / static_cast<float>(time_ms));
+    }
+
+    float attack_;
+    float release_;
+    float gain_;
+    bool use_peak_;
+    float value_;
+};
+
+/**
+ * @brief Envelope value at the end of one audio block
+ */
+struct envelope_point {
+    uint32_t time_ms;  // Controller time the block ends at
+    uint16_t rms;
+    uint16_t peak;
+    uint8_t level;  // Follower output (0-255)
+};
+
+/**
+ * @brief Bounded single-producer single-consumer queue of envelope points
+ *
+ * Fixed storage; push() fails when full instead of growing, which is what
+ * throttles the reader to stay a bounded distance ahead of playback.
+ *
+ * @tparam capacity_v Points held (power of two)
+ */
+template<std::size_t capacity_v>
+struct envelope_ring {
+   public:
+    static_assert(capacity_v >= 2 && (capacity_v & (capacity_v - 1)) == 0,
+                  "capacity must be a power of two");
+
+    envelope_ring() : head_(0), tail_(0) {}
+
+    bool push(envelope_point const& point) {
+        std::size_t const tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity_v) {
+            return false;
+        }
+        points_[tail & (capacity_v - 1)] = point;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Oldest point, without removing it (false if empty)
+     */
+    bool peek(envelope_point& point) const {
+        std::size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        point = points_[head & (capacity_v - 1)];
+        return true;
+    }
+
+    void pop() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool full() const { return size() == capacity_v; }
+
+   private:
+    envelope_point points_[capacity_v];
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+};
+
+/**
+ * @brief Audio track as a control signal for fade controllers
+ *
+ * pump() reads blocks from a wav_reader into a fixed block buffer, measures
+ * each block (envelope_block()) and queues the follower output in a bounded
+ * ring, stopping once the ring is full or the queued audio reaches the
+ * requested time. sample() returns the level of the latest block that has
+ * ended by now, so brightness and jaw position follow the track at tick
+ * time. No allocation after construction.
+ *
+ * pump() and sample() may run on different threads (the ring is SPSC).
+ * The reader must be open before construction (its sample rate sets the
+ * follower's block time).
+ *
+ * Usage:
+ *   wav_reader wav;
+ *   wav.open("skull.wav");
+ *   audio_envelope<> voice(wav, {5, 80, 2.0f, false});  // 5 ms attack, 80 ms release
+ *   voice.start(millis());
+ *   voice.pump(millis() + 100);         // keep 100 ms queued
+ *   voice.drive(jaw, millis());         // jaw: fade_controller on a servo pin
+ *
+ * @tparam block_frames_v Frames per block (envelope resolution)
+ * @tparam ring_capacity_v Blocks queued ahead of playback (power of two)
+ */
+template<std::size_t block_frames_v = 256, std::size_t ring_capacity_v = 64>
+struct audio_envelope {
+   public:
+    static std::size_t const BLOCK_FRAMES = block_frames_v;
+    static std::size_t const MAX_CHANNELS = 8;
+
+    audio_envelope(wav_reader& reader, envelope_follower::settings const& settings)
+        : reader_(reader),
+          origin_ms_(0),
+          frames_(0),
+          ended_(false),
+          current_(0),
+          skipped_(0) {
+        wav_format const& format = reader_.get_format();
+        follower_.configure(settings, 1000.0f * block_frames_v / format.sample_rate);
+    }
+
+    /**
+     * @brief The track starts playing at now_ms
+     */
+    void start(uint32_t now_ms) { origin_ms_ = now_ms; }
+
+    /**
+     * @brief Read and measure blocks until until_ms is queued or the ring is full
+     *
+     * @return std::size_t Blocks queued by this call
+     */
+    std::size_t pump(uint32_t until_ms) {
+        std::size_t queued = 0;
+        uint32_t const rate = reader_.get_format().sample_rate;
+        std::size_t const channels = reader_.get_format().channels;
+        while (!ended_.load(std::memory_order_relaxed) && !ring_.full() &&
+               static_cast<int32_t>(queued_until() - until_ms) < 0) {
+            std::size_t const frames = reader_.read(block_, block_frames_v);
+            if (frames == 0) {
+                ended_.store(true, std::memory_order_release);
+                break;
+            }
+            envelope_stats const stats = envelope_block(block_, frames * channels);
+            frames_ += frames;
+            envelope_point point;
+            point.time_ms = origin_ms_ + static_cast<uint32_t>(frames_ * 1000 / rate);
+            point.rms = stats.rms();
+            point.peak = stats.peak;
+            point.level = follower_.push(stats);
+            ring_.push(point);
+            ++queued;
+        }
+        return queued;
+    }
+
+    /**
+     * @brief Level of the latest block that has ended by now_ms
+     */
+    uint8_t sample(uint32_t now_ms) {
+        envelope_point point;
+        std::size_t taken = 0;
+        while (ring_.peek(point) && static_cast<int32_t>(point.time_ms - now_ms) <= 0) {
+            current_ = point.level;
+            ring_.pop();
+            ++taken;
+        }
+        skipped_ += taken > 1 ? static_cast<uint32_t>(taken - 1) : 0;
+        return current_;
+    }
+
+    /**
+     * @brief Point a fade controller (LED, servo) at the current level
+     */
+    template<typename fade_t>
+    void drive(fade_t& fade, uint32_t now_ms) {
+        fade.set_target(sample(now_ms), now_ms);
+    }
+
+    /**
+     * @brief All audio read and every queued block consumed
+     */
+    bool is_finished() const {
+        return ended_.load(std::memory_order_acquire) && ring_.size() == 0;
+    }
+
+    std::size_t get_queued() const { return ring_.size(); }
+    uint64_t get_frames() const { return frames_; }
+    uint8_t get_level() const { return current_; }
+
+    // Blocks passed over because ticks were further apart than blocks
+    uint32_t get_skipped() const { return skipped_; }
+
+   private:
+    // Controller time the audio read so far ends at
+    uint32_t queued_until() const {
+        return origin_ms_ +
+               static_cast<uint32_t>(frames_ * 1000 / reader_.get_format().sample_rate);
+    }
+
+    wav_reader& reader_;
+    envelope_follower follower_;
+    envelope_ring<ring_capacity_v> ring_;
+    int16_t block_[block_frames_v * MAX_CHANNELS];
+    uint32_t origin_ms_;
+    uint64_t frames_;
+    std::atomic<bool> ended_;
+    uint8_t current_;
+    uint32_t skipped_;
+};
+
+template<std::size_t block_frames_v, std::size_t ring_capacity_v>
+std::size_t const audio_envelope<block_frames_v, ring_capacity_v>::BLOCK_FRAMES;
+
+template<std::size_t block_frames_v, std::size_t ring_capacity_v>
+std::size_t const audio_envelope<block_frames_v, ring_capacity_v>::MAX_CHANNELS;
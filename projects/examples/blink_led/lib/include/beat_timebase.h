@@ -0,0 +1,363 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "smf_import.h"
+
+/**
+ * @brief Musical time: beat positions from wall-clock milliseconds
+ *
+ * Positions are in beat ticks, BEAT_PPQ per beat (960 divides into halves,
+ * thirds, quarters, fifths, sixths and eighths, so triplets stay exact).
+ */
+static uint32_t const BEAT_PPQ = 960;
+
+/**
+ * @brief Piecewise tempo map with a cached segment cursor
+ *
+ * Each segment starts at a beat tick with a tempo in microseconds per beat.
+ * Segment start times are kept exactly, as integer 1/BEAT_PPQ microseconds,
+ * so conversions do not drift however many tempo changes precede them.
+ *
+ * Lookups start from the segment used last and step to a neighbour when the
+ * time has moved past it: O(1) for playback moving forward (or backward) a
+ * little at a time, and a binary search only after a large seek.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   tempo_map<64> map;              // 120 BPM from beat 0
+ *   map.add(16 * BEAT_PPQ, tempo_map<64>::bpm(140));
+ *   uint32_t const tick = map.ms_to_tick(song_ms);
+ *
+ * @tparam max_segments_v Tempo changes held (the initial tempo included)
+ */
+template<std::size_t max_segments_v>
+struct tempo_map {
+   public:
+    static_assert(max_segments_v >= 1, "need room for the initial tempo");
+
+    struct segment {
+        uint32_t start_tick;
+        uint32_t us_per_beat;
+        uint64_t start_time;  // In 1/BEAT_PPQ microseconds
+    };
+
+    explicit tempo_map(uint32_t us_per_beat = SMF_DEFAULT_TEMPO) { reset(us_per_beat); }
+
+    /**
+     * @brief Microseconds per beat for a tempo in beats per minute
+     */
+    static uint32_t bpm(uint32_t beats_per_minute) { return 60000000u / beats_per_minute; }
+
+    /**
+     * @brief Start over with a single tempo from beat 0
+     */
+    void reset(uint32_t us_per_beat) {
+        segments_[0].start_tick = 0;
+        segments_[0].us_per_beat = us_per_beat;
+        segments_[0].start_time = 0;
+        count_ = 1;
+        cursor_ = 0;
+    }
+
+    /**
+     * @brief Change tempo from a beat tick onwards (ticks non-decreasing)
+     *
+     * @return false Out of segments, zero tempo or tick went backwards
+     */
+    bool add(uint32_t start_tick, uint32_t us_per_beat) {
+        segment& last = segments_[count_ - 1];
+        if (start_tick < last.start_tick || us_per_beat == 0) {
+            return false;
+        }
+        if (start_tick == last.start_tick) {
+            last.us_per_beat = us_per_beat;
+            return true;
+        }
+        if (count_ == max_segments_v) {
+            return false;
+        }
+        segment& next = segments_[count_++];
+        next.start_tick = start_tick;
+        next.us_per_beat = us_per_beat;
+        next.start_time = last.start_time +
+                          static_cast<uint64_t>(start_tick - last.start_tick) * last.us_per_beat;
+        return true;
+    }
+
+    /**
+     * @brief Build from an imported SMF tempo map (metrical files only)
+     *
+     * @param division The file's ticks per quarter note
+     * @return false SMPTE map, or more tempo changes than max_segments_v
+     */
+    template<std::size_t smf_segments_v>
+    bool load(smf_tempo_map<smf_segments_v> const& smf, uint16_t division) {
+        if (division == 0 || (division & 0x8000) != 0 || smf.get_tick_den() != division) {
+            return false;
+        }
+        reset(smf.get_segment(0).tick_num);
+        for (std::size_t i = 1; i < smf.get_segment_count(); ++i) {
+            typename smf_tempo_map<smf_segments_v>::segment const& s = smf.get_segment(i);
+            uint32_t const tick =
+                static_cast<uint32_t>(static_cast<uint64_t>(s.tick) * BEAT_PPQ / division);
+            if (!add(tick, s.tick_num)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Beat position at a song time
+     */
+    uint32_t ms_to_tick(uint32_t ms) { return us_to_tick(static_cast<uint64_t>(ms) * 1000); }
+
+    uint32_t us_to_tick(uint64_t us) {
+        uint64_t const time = us * BEAT_PPQ;
+        segment const& s = segments_[seek_time(time)];
+        return s.start_tick + static_cast<uint32_t>((time - s.start_time) / s.us_per_beat);
+    }
+
+    /**
+     * @brief First song millisecond at which the position reaches tick
+     */
+    uint32_t tick_to_ms(uint32_t tick) {
+        segment const& s = segments_[seek_tick(tick)];
+        uint64_t const time =
+            s.start_time + static_cast<uint64_t>(tick - s.start_tick) * s.us_per_beat;
+        uint64_t const per_ms = static_cast<uint64_t>(BEAT_PPQ) * 1000;
+        return static_cast<uint32_t>((time + per_ms - 1) / per_ms);
+    }
+
+    /**
+     * @brief Tempo in effect at a beat position (microseconds per beat)
+     */
+    uint32_t tempo_at(uint32_t tick) { return segments_[seek_tick(tick)].us_per_beat; }
+
+    std::size_t get_segment_count() const { return count_; }
+    segment const& get_segment(std::size_t index) const { return segments_[index]; }
+    std::size_t get_cursor() const { return cursor_; }
+
+   private:
+    // Neighbour steps before falling back to a binary search
+    static std::size_t const MAX_STEPS = 4;
+
+    bool contains_time(std::size_t i, uint64_t time) const {
+        return segments_[i].start_time <= time &&
+               (i + 1 == count_ || time < segments_[i + 1].start_time);
+    }
+
+    bool contains_tick(std::size_t i, uint32_t tick) const {
+        return segments_[i].start_tick <= tick &&
+               (i + 1 == count_ || tick < segments_[i + 1].start_tick);
+    }
+
+    std::size_t seek_time(uint64_t time) {
+        for (std::size_t step = 0; step < MAX_STEPS; ++step) {
+            if (contains_time(cursor_, time)) {
+                return cursor_;
+            }
+            cursor_ = time < segments_[cursor_].start_time ? cursor_ - 1 : cursor_ + 1;
+        }
+        std::size_t low = 0;
+        std::size_t high = count_;
+        while (high - low > 1) {
+            std::size_t const mid = (low + high) / 2;
+            if (segments_[mid].start_time <= time) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        cursor_ = low;
+        return cursor_;
+    }
+
+    std::size_t seek_tick(uint32_t tick) {
+        for (std::size_t step = 0; step < MAX_STEPS; ++step) {
+            if (contains_tick(cursor_, tick)) {
+                return cursor_;
+            }
+            cursor_ = tick < segments_[cursor_].start_tick ? cursor_ - 1 : cursor_ + 1;
+        }
+        std::size_t low = 0;
+        std::size_t high = count_;
+        while (high - low > 1) {
+            std::size_t const mid = (low + high) / 2;
+            if (segments_[mid].start_tick <= tick) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        cursor_ = low;
+        return cursor_;
+    }
+
+    segment segments_[max_segments_v];
+    std::size_t count_;
+    std::size_t cursor_;
+};
+
+template<std::size_t max_segments_v>
+std::size_t const tempo_map<max_segments_v>::MAX_STEPS;
+
+/**
+ * @brief Song clock: converts controller millis() to a beat position once per loop
+ *
+ * start() anchors beat 0 at a controller time; update() converts the
+ * current time through the tempo map and keeps the result, so any number of
+ * beat_blink_controller channels share one conversion per loop.
+ *
+ * Usage:
+ *   beat_timebase<tempo_map<64> > clock(map);
+ *   clock.start(millis());
+ *   uint32_t const tick = clock.update(millis());  // every loop
+ *   for (...) channels[i].update(tick);
+ *
+ * @tparam tempo_map_t tempo_map<N>
+ */
+template<typename tempo_map_t>
+struct beat_timebase {
+   public:
+    explicit beat_timebase(tempo_map_t& map) : map_(map), origin_ms_(0), tick_(0) {}
+
+    /**
+     * @brief Beat 0 happens at now_ms
+     */
+    void start(uint32_t now_ms) {
+        origin_ms_ = now_ms;
+        tick_ = 0;
+    }
+
+    /**
+     * @brief Current beat position (wraparound-safe in now_ms)
+     */
+    uint32_t update(uint32_t now_ms) {
+        tick_ = map_.ms_to_tick(now_ms - origin_ms_);
+        return tick_;
+    }
+
+    /**
+     * @brief Controller time at which a beat position is reached
+     */
+    uint32_t tick_to_controller_ms(uint32_t tick) { return origin_ms_ + map_.tick_to_ms(tick); }
+
+    uint32_t get_tick() const { return tick_; }
+    uint32_t get_origin() const { return origin_ms_; }
+
+   private:
+    tempo_map_t& map_;
+    uint32_t origin_ms_;
+    uint32_t tick_;
+};
+
+/**
+ * @brief blink_controller whose on/off durations are in beats
+ *
+ * Driven by a beat position (beat_timebase::update()) instead of
+ * milliseconds. Edges sit on a grid anchored at the beat the pattern
+ * started on, so a late update() never shifts later edges and tempo
+ * changes stretch the pattern with the music. The OFF part of each period
+ * comes first, as in blink_controller.
+ *
+ * New durations latch at the next period boundary. A position before the
+ * current period (a seek or loop back) realigns the grid to beat 0.
+ *
+ * Usage:
+ *   beat_blink_controller<led_pin> strobe(pin, BEAT_PPQ / 2, BEAT_PPQ / 2);  // 8th notes
+ *   strobe.update(clock.update(millis()));
+ *
+ * @tparam output_pin_t Type that implements set(bool) method
+ */
+template<typename output_pin_t>
+struct beat_blink_controller {
+   public:
+    /**
+     * @param on_ticks ON duration in beat ticks (BEAT_PPQ per beat)
+     * @param off_ticks OFF duration in beat ticks
+     */
+    beat_blink_controller(output_pin_t& output, uint32_t on_ticks, uint32_t off_ticks)
+        : output_(output),
+          on_ticks_(on_ticks),
+          off_ticks_(off_ticks),
+          next_on_ticks_(on_ticks),
+          next_off_ticks_(off_ticks),
+          anchor_tick_(0),
+          led_on_(false) {}
+
+    void update(uint32_t tick) {
+        uint32_t period = on_ticks_ + off_ticks_;
+        if (tick < anchor_tick_) {
+            realign(tick);
+            period = on_ticks_ + off_ticks_;
+        } else if (period == 0 || tick - anchor_tick_ >= period) {
+            // Whole periods passed: move the anchor onto the grid, then retime
+            anchor_tick_ = period == 0 ? tick : tick - (tick - anchor_tick_) % period;
+            on_ticks_ = next_on_ticks_;
+            off_ticks_ = next_off_ticks_;
+            period = on_ticks_ + off_ticks_;
+        }
+        led_on_ = period != 0 && tick - anchor_tick_ >= off_ticks_;
+        output_.set(led_on_);
+    }
+
+    /**
+     * @brief Change durations at the next period boundary
+     */
+    void set_durations(uint32_t on_ticks, uint32_t off_ticks) {
+        next_on_ticks_ = on_ticks;
+        next_off_ticks_ = off_ticks;
+    }
+
+    /**
+     * @brief Start the pattern (OFF first) at a beat position
+     */
+    void restart(uint32_t tick) {
+        anchor_tick_ = tick;
+        on_ticks_ = next_on_ticks_;
+        off_ticks_ = next_off_ticks_;
+        led_on_ = false;
+        output_.set(false);
+    }
+
+    /**
+     * @brief Beat ticks until update() will change the output (0 = due now)
+     */
+    uint32_t ticks_until_toggle(uint32_t tick) const {
+        if (tick < anchor_tick_) {
+            return 0;
+        }
+        uint32_t const into = tick - anchor_tick_;
+        if (into < off_ticks_) {
+            return off_ticks_ - into;
+        }
+        uint32_t const period = on_ticks_ + off_ticks_;
+        return into < period ? period - into : 0;
+    }
+
+    uint32_t get_on_ticks() const { return on_ticks_; }
+    uint32_t get_off_ticks() const { return off_ticks_; }
+    uint32_t get_next_on_ticks() const { return next_on_ticks_; }
+    uint32_t get_next_off_ticks() const { return next_off_ticks_; }
+    uint32_t get_anchor_tick() const { return anchor_tick_; }
+    bool is_on() const { return led_on_; }
+
+   private:
+    void realign(uint32_t tick) {
+        on_ticks_ = next_on_ticks_;
+        off_ticks_ = next_off_ticks_;
+        uint32_t const period = on_ticks_ + off_ticks_;
+        anchor_tick_ = period == 0 ? tick : tick - tick % period;
+    }
+
+    output_pin_t& output_;
+    uint32_t on_ticks_;
+    uint32_t off_ticks_;
+    uint32_t next_on_ticks_;
+    uint32_t next_off_ticks_;
+    uint32_t anchor_tick_;
+    bool led_on_;
+};
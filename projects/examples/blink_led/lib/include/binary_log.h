@@ -0,0 +1,410 @@
+#pragma once
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Raw 64-bit encoding of one log argument, decoded back to its type
+ *
+ * Integers (including bool and char), floating point and pointers are
+ * supported. Pointers are stored, not their targets: a char const* argument
+ * must outlive the record (string literals, static tables).
+ */
+template<typename value_t, typename enable_t = void>
+struct log_arg_codec;
+
+template<typename value_t>
+struct log_arg_codec<value_t, typename std::enable_if<std::is_integral<value_t>::value>::type> {
+    static uint64_t encode(value_t value) { return static_cast<uint64_t>(value); }
+    static value_t decode(uint64_t bits) { return static_cast<value_t>(bits); }
+};
+
+template<typename value_t>
+struct log_arg_codec<value_t,
+                     typename std::enable_if<std::is_floating_point<value_t>::value>::type> {
+    static uint64_t encode(value_t value) {
+        double const wide = value;
+        uint64_t bits;
+        std::memcpy(&bits, &wide, sizeof(bits));
+        return bits;
+    }
+    static double decode(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+template<typename value_t>
+struct log_arg_codec<value_t, typename std::enable_if<std::is_pointer<value_t>::value>::type> {
+    static uint64_t encode(value_t value) { return reinterpret_cast<uintptr_t>(value); }
+    static value_t decode(uint64_t bits) {
+        return reinterpret_cast<value_t>(static_cast<uintptr_t>(bits));
+    }
+};
+
+namespace binary_log_detail {
+
+// C++11 stand-in for std::index_sequence
+template<std::size_t...>
+struct index_list {};
+
+template<std::size_t count, std::size_t... indices>
+struct make_index_list : make_index_list<count - 1, count - 1, indices...> {};
+
+template<std::size_t... indices>
+struct make_index_list<0, indices...> {
+    typedef index_list<indices...> type;
+};
+
+inline void pack_args(uint64_t*) {}
+
+template<typename first_t, typename... rest_t>
+inline void pack_args(uint64_t* out, first_t first, rest_t... rest) {
+    out[0] = log_arg_codec<first_t>::encode(first);
+    pack_args(out + 1, rest...);
+}
+
+}  // namespace binary_log_detail
+
+/**
+ * @brief Formats one record whose arguments had types args_t...
+ *
+ * Instantiated at each distinct log() call signature; the record stores a
+ * pointer to format(), so the decoder needs no type registry.
+ */
+template<typename... args_t>
+struct log_formatter {
+    static int format(char* out, std::size_t capacity, char const* fmt, uint64_t const* args) {
+        return apply(out, capacity, fmt, args,
+                     typename binary_log_detail::make_index_list<sizeof...(args_t)>::type());
+    }
+
+   private:
+    template<std::size_t... indices>
+    static int apply(char* out, std::size_t capacity, char const* fmt, uint64_t const* args,
+                     binary_log_detail::index_list<indices...>) {
+        return std::snprintf(out, capacity, fmt, log_arg_codec<args_t>::decode(args[indices])...);
+    }
+};
+
+// Messages without arguments are printed verbatim
+template<>
+struct log_formatter<> {
+    static int format(char* out, std::size_t capacity, char const* fmt, uint64_t const*) {
+        return std::snprintf(out, capacity, "%s", fmt);
+    }
+};
+
+/**
+ * @brief One fixed-size log entry: formatter, format string and raw arguments
+ */
+struct log_record {
+    static std::size_t const MAX_ARGS = 6;
+
+    int (*format)(char* out, std::size_t capacity, char const* fmt, uint64_t const* args);
+    char const* fmt;
+    uint64_t args[MAX_ARGS];
+};
+
+/**
+ * @brief Single-producer ring of log records owned by one thread
+ *
+ * The hot path is a handful of stores into the next slot plus one release
+ * store of the tail; no formatting, no allocation, no locks. When the ring
+ * is full the record is dropped and counted rather than waiting for the
+ * decoder.
+ *
+ * Obtain from binary_logger::attach(); use from one thread only.
+ *
+ * Usage:
+ *   log_ring& log = *logger.attach();
+ *   log.log("[%ums] LED %s", now, on ? "ON" : "OFF");  // fmt and strings must be static
+ */
+struct log_ring {
+   public:
+    explicit log_ring(std::size_t capacity)
+        : records_(new log_record[round_up(capacity)]),
+          mask_(round_up(capacity) - 1),
+          cached_head_(0),
+          tail_(0),
+          dropped_(0),
+          head_(0) {}
+
+    log_ring(log_ring const&) = delete;
+    log_ring& operator=(log_ring const&) = delete;
+
+    /**
+     * @brief Record a message for deferred formatting (producer thread)
+     *
+     * @param fmt printf-style format with static lifetime
+     * @param args Up to log_record::MAX_ARGS integers, floats or pointers
+     * @return false Ring full; the record was dropped
+     */
+    template<typename... args_t>
+    bool log(char const* fmt, args_t... args) {
+        static_assert(sizeof...(args_t) <= log_record::MAX_ARGS, "too many log arguments");
+        std::size_t const tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+                return false;
+            }
+        }
+        log_record& record = records_[tail & mask_];
+        record.format = &log_formatter<args_t...>::format;
+        record.fmt = fmt;
+        binary_log_detail::pack_args(record.args, args...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest record (consumer thread)
+     *
+     * @return false Ring empty
+     */
+    bool pop(log_record& record) {
+        std::size_t const head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = records_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t get_capacity() const { return mask_ + 1; }
+    uint64_t get_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+   private:
+    static std::size_t const CACHE_LINE = 64;
+
+    static std::size_t round_up(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    std::unique_ptr<log_record[]> records_;
+    std::size_t const mask_;
+    std::size_t cached_head_;  // Producer's last view of head_
+
+    // Producer and consumer indices on separate cache lines. Explicit padding
+    // rather than alignas(64): C++11 operator new doesn't honour extended
+    // alignment, and attach() allocates rings with new. A full line of
+    // padding on either side of head_ separates it whatever the address.
+    std::atomic<std::size_t> tail_;
+    std::atomic<uint64_t> dropped_;
+    char producer_pad_[CACHE_LINE];
+    std::atomic<std::size_t> head_;
+    char consumer_pad_[CACHE_LINE];
+};
+
+/**
+ * @brief Destination for formatted text: plain function pointer plus context
+ */
+struct log_output {
+    void (*write)(void* context, char const* text, std::size_t length);
+    void* context;
+};
+
+/**
+ * @brief log_output writing to a file descriptor (context points to the fd)
+ */
+inline void write_log_to_fd(void* context, char const* text, std::size_t length) {
+    int const fd = *static_cast<int const*>(context);
+    while (length > 0) {
+        ssize_t const n = ::write(fd, text, length);
+        if (n <= 0) {
+            return;
+        }
+        text += n;
+        length -= static_cast<std::size_t>(n);
+    }
+}
+
+/**
+ * @brief Collects records from per-thread rings and formats them off the hot path
+ *
+ * Each producing thread attaches its own log_ring once (outside the hot
+ * path). Formatting happens in drain(), either on a background thread
+ * started with start() or called explicitly (offline decoding, tests). Each
+ * record becomes one line; lines are batched into a single output write.
+ *
+ * Records are ordered within a ring; rings are drained one after another,
+ * so put a timestamp in the message where cross-thread order matters.
+ *
+ * Usage:
+ *   int out_fd = STDOUT_FILENO;
+ *   log_output output = {&write_log_to_fd, &out_fd};
+ *   binary_logger logger(output);
+ *   log_ring& log = *logger.attach();
+ *   logger.start();
+ *   log.log("tick %u", now);  // tick thread
+ *   logger.stop();            // drains what is left
+ */
+struct binary_logger {
+   public:
+    static std::size_t const MAX_RINGS = 16;
+    static std::size_t const DEFAULT_RING_CAPACITY = 4096;
+    static std::size_t const MAX_LINE = 256;
+
+    explicit binary_logger(log_output output, std::size_t ring_capacity = DEFAULT_RING_CAPACITY)
+        : output_(output), ring_capacity_(ring_capacity), ring_count_(0), running_(false) {}
+
+    ~binary_logger() { stop(); }
+
+    binary_logger(binary_logger const&) = delete;
+    binary_logger& operator=(binary_logger const&) = delete;
+
+    /**
+     * @brief Create a ring for the calling thread (allocates; not for the hot path)
+     *
+     * @return log_ring* nullptr when MAX_RINGS are already attached
+     */
+    log_ring* attach() {
+        std::lock_guard<std::mutex> lock(attach_mutex_);
+        std::size_t const count = ring_count_.load(std::memory_order_relaxed);
+        if (count >= MAX_RINGS) {
+            return nullptr;
+        }
+        rings_[count].reset(new log_ring(ring_capacity_));
+        ring_count_.store(count + 1, std::memory_order_release);
+        return rings_[count].get();
+    }
+
+    /**
+     * @brief Format and output every pending record (one consumer at a time)
+     *
+     * @return std::size_t Number of records formatted
+     */
+    std::size_t drain() {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+        std::size_t formatted = 0;
+        std::size_t used = 0;
+        std::size_t const count = ring_count_.load(std::memory_order_acquire);
+        log_record record;
+        for (std::size_t i = 0; i < count; ++i) {
+            while (rings_[i]->pop(record)) {
+                if (sizeof(batch_) - used < MAX_LINE + 1) {
+                    output_.write(output_.context, batch_, used);
+                    used = 0;
+                }
+                int const length = record.format(batch_ + used, MAX_LINE, record.fmt, record.args);
+                if (length > 0) {
+                    used += static_cast<std::size_t>(length) < MAX_LINE
+                                ? static_cast<std::size_t>(length)
+                                : MAX_LINE - 1;
+                }
+                batch_[used++] = '\n';
+                ++formatted;
+            }
+        }
+        if (used > 0) {
+            output_.write(output_.context, batch_, used);
+        }
+        return formatted;
+    }
+
+    /**
+     * @brief Format on a background thread every poll_interval
+     */
+    void start(std::chrono::milliseconds poll_interval = std::chrono::milliseconds(2)) {
+        if (running_.exchange(true)) {
+            return;
+        }
+        decoder_ = std::thread([this, poll_interval]() {
+            while (running_.load(std::memory_order_relaxed)) {
+                if (drain() == 0) {
+                    std::this_thread::sleep_for(poll_interval);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Stop the background thread and format whatever is left
+     */
+    void stop() {
+        if (running_.exchange(false)) {
+            decoder_.join();
+        }
+        drain();
+    }
+
+    std::size_t get_ring_count() const { return ring_count_.load(std::memory_order_acquire); }
+
+    uint64_t get_dropped() const {
+        uint64_t dropped = 0;
+        std::size_t const count = get_ring_count();
+        for (std::size_t i = 0; i < count; ++i) {
+            dropped += rings_[i]->get_dropped();
+        }
+        return dropped;
+    }
+
+   private:
+    log_output output_;
+    std::size_t ring_capacity_;
+    std::unique_ptr<log_ring> rings_[MAX_RINGS];
+    std::atomic<std::size_t> ring_count_;
+    std::mutex attach_mutex_;
+    std::mutex drain_mutex_;
+    std::atomic<bool> running_;
+    std::thread decoder_;
+    char batch_[16 * 1024];
+};
+
+/**
+ * @brief Pin decorator that logs every state change of the wrapped pin
+ *
+ * Drop-in for any controller's pin_t: forwards every set() and records
+ * "[time] channel N ON/OFF" into a log_ring for the first set() and then
+ * only when the state changes.
+ *
+ * Usage:
+ *   transition_logging_pin<console_led_pin, real_time_timer> logged(pin, timer, log, 3);
+ *   blink_controller<transition_logging_pin<console_led_pin, real_time_timer> > c(logged, 500, 500);
+ *
+ * @tparam pin_t Wrapped pin with set(bool)
+ * @tparam timer_t Type with millis()
+ */
+template<typename pin_t, typename timer_t>
+struct transition_logging_pin {
+   public:
+    transition_logging_pin(pin_t& pin, timer_t& timer, log_ring& ring, uint32_t channel)
+        : pin_(pin), timer_(timer), ring_(ring), channel_(channel), state_(false), known_(false) {}
+
+    void set(bool state) {
+        if (!known_ || state != state_) {
+            ring_.log("[%ums] channel %u %s", timer_.millis(), channel_, state ? "ON" : "OFF");
+        }
+        state_ = state;
+        known_ = true;
+        pin_.set(state);
+    }
+
+    bool get_state() const { return state_; }
+
+   private:
+    pin_t& pin_;
+    timer_t& timer_;
+    log_ring& ring_;
+    uint32_t channel_;
+    bool state_;
+    bool known_;
+};
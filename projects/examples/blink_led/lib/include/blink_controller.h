@@ -47,7 +47,10 @@ struct blink_controller {
         : output_(output),
           on_duration_ms_(on_duration_ms),
           off_duration_ms_(off_duration_ms),
+          next_on_duration_ms_(on_duration_ms),
+          next_off_duration_ms_(off_duration_ms),
           last_toggle_time_ms_(0),
+          phase_adjust_ms_(0),
           led_on_(false) {}
 
     /**
@@ -60,29 +63,32 @@ struct blink_controller {
      * @param current_time_ms Current time in milliseconds
      */
     void update(uint32_t current_time_ms) {
-        // Calculate time elapsed since last toggle
-        uint32_t elapsed;
-        if (current_time_ms >= last_toggle_time_ms_) {
-            // Normal case: no wraparound
-            elapsed = current_time_ms - last_toggle_time_ms_;
-        } else {
-            // Handle uint32_t wraparound (occurs after ~49.7 days)
-            elapsed = (UINT32_MAX - last_toggle_time_ms_) + current_time_ms + 1;
-        }
-
         // Determine if we should toggle
-        uint32_t const target_duration = led_on_ ? on_duration_ms_ : off_duration_ms_;
-
-        if (elapsed >= target_duration) {
-            // Toggle the LED state
-            led_on_ = !led_on_;
-            last_toggle_time_ms_ = current_time_ms;
+        if (elapsed_since_toggle(current_time_ms) >= current_target_duration()) {
+            // Toggle the LED state; retiming takes effect at the edge
+            toggle_at(current_time_ms);
         }
 
         // Output control - ALL logic testable!
         output_.set(led_on_);
     }
 
+    /**
+     * @brief Time left until update() will toggle
+     *
+     * Lets event loops sleep until the earliest controller deadline instead
+     * of polling. Reflects pending phase shifts; pending durations only
+     * matter after the next edge, so they do not change the answer.
+     *
+     * @param current_time_ms Current time in milliseconds
+     * @return uint32_t Milliseconds until the next edge (0 = due now)
+     */
+    uint32_t time_until_toggle(uint32_t current_time_ms) const {
+        uint32_t const elapsed = elapsed_since_toggle(current_time_ms);
+        uint32_t const target = current_target_duration();
+        return elapsed >= target ? 0 : target - elapsed;
+    }
+
     /**
      * @brief Reset controller to initial state
      *
@@ -91,20 +97,188 @@ struct blink_controller {
      */
     void reset() {
         last_toggle_time_ms_ = 0;
+        on_duration_ms_ = next_on_duration_ms_;
+        off_duration_ms_ = next_off_duration_ms_;
+        phase_adjust_ms_ = 0;
         led_on_ = false;
         output_.set(false);
     }
 
+    /**
+     * @brief Restart the pattern from now (external trigger)
+     *
+     * Like reset(), but the OFF interval starts at current_time_ms instead of
+     * at time 0, so the first ON edge comes one OFF duration after the trigger.
+     *
+     * @param current_time_ms Time of the trigger in milliseconds
+     */
+    void restart(uint32_t current_time_ms) {
+        reset();
+        last_toggle_time_ms_ = current_time_ms;
+    }
+
+    /**
+     * @brief Change blink durations at the next edge
+     *
+     * The interval currently in progress finishes with the timing it started
+     * with; the new durations are latched on the next toggle (or reset()).
+     * This keeps a half-finished ON or OFF period from being truncated or
+     * stretched mid-show. Use shift_phase() to move the pending edge itself.
+     *
+     * @param on_duration_ms New ON duration (milliseconds)
+     * @param off_duration_ms New OFF duration (milliseconds)
+     */
+    void set_durations(uint32_t on_duration_ms, uint32_t off_duration_ms) {
+        next_on_duration_ms_ = on_duration_ms;
+        next_off_duration_ms_ = off_duration_ms;
+    }
+
+    /**
+     * @brief Move the pending edge immediately
+     *
+     * Positive values delay the next toggle, negative values bring it
+     * forward (an advance past the current time toggles on the next update).
+     * Shifts accumulate (saturating at the int32_t range) until the edge
+     * they apply to, then clear.
+     *
+     * @param delta_ms Phase shift in milliseconds
+     */
+    void shift_phase(int32_t delta_ms) {
+        if (delta_ms > 0 && phase_adjust_ms_ > INT32_MAX - delta_ms) {
+            phase_adjust_ms_ = INT32_MAX;
+        } else if (delta_ms < 0 && phase_adjust_ms_ < INT32_MIN - delta_ms) {
+            phase_adjust_ms_ = INT32_MIN;
+        } else {
+            phase_adjust_ms_ += delta_ms;
+        }
+    }
+
+    /**
+     * @brief Timing state for checkpoints (the output pin is not included)
+     */
+    struct snapshot {
+        uint32_t on_duration_ms;
+        uint32_t off_duration_ms;
+        uint32_t next_on_duration_ms;
+        uint32_t next_off_duration_ms;
+        uint32_t last_toggle_time_ms;
+        int32_t phase_adjust_ms;
+        bool led_on;
+    };
+
+    snapshot save() const {
+        snapshot s;
+        s.on_duration_ms = on_duration_ms_;
+        s.off_duration_ms = off_duration_ms_;
+        s.next_on_duration_ms = next_on_duration_ms_;
+        s.next_off_duration_ms = next_off_duration_ms_;
+        s.last_toggle_time_ms = last_toggle_time_ms_;
+        s.phase_adjust_ms = phase_adjust_ms_;
+        s.led_on = led_on_;
+        return s;
+    }
+
+    /**
+     * @brief Return to a saved state; the output follows on the next update()
+     */
+    void restore(snapshot const& s) {
+        on_duration_ms_ = s.on_duration_ms;
+        off_duration_ms_ = s.off_duration_ms;
+        next_on_duration_ms_ = s.next_on_duration_ms;
+        next_off_duration_ms_ = s.next_off_duration_ms;
+        last_toggle_time_ms_ = s.last_toggle_time_ms;
+        phase_adjust_ms_ = s.phase_adjust_ms;
+        led_on_ = s.led_on;
+    }
+
+    /**
+     * @brief Jump ahead as if update() had run every millisecond until now
+     *
+     * Constant time however far ahead: the pending edge is taken, whole
+     * ON+OFF periods are skipped arithmetically, then at most one more edge.
+     * A zero duration lasts one millisecond, as it does with per-millisecond
+     * updates. The pending edge must not already be overdue, so call update()
+     * after shift_phase() and before fast-forwarding.
+     *
+     * @param current_time_ms Time to jump to in milliseconds
+     */
+    void fast_forward(uint32_t current_time_ms) {
+        uint32_t elapsed = elapsed_since_toggle(current_time_ms);
+        uint32_t const first = at_least_1ms(current_target_duration());
+        if (elapsed >= first) {
+            toggle_at(last_toggle_time_ms_ + first);
+            elapsed -= first;
+            uint32_t const on = at_least_1ms(on_duration_ms_);
+            uint32_t const off = at_least_1ms(off_duration_ms_);
+            uint64_t const period = static_cast<uint64_t>(on) + off;
+            uint32_t const skipped = static_cast<uint32_t>(elapsed / period * period);
+            last_toggle_time_ms_ += skipped;
+            elapsed -= skipped;
+            if (elapsed >= (led_on_ ? on : off)) {
+                toggle_at(last_toggle_time_ms_ + (led_on_ ? on : off));
+            }
+        }
+        output_.set(led_on_);
+    }
+
     // Getters for testing and state inspection
     uint32_t get_on_duration() const { return on_duration_ms_; }
     uint32_t get_off_duration() const { return off_duration_ms_; }
+    uint32_t get_next_on_duration() const { return next_on_duration_ms_; }
+    uint32_t get_next_off_duration() const { return next_off_duration_ms_; }
+    int32_t get_phase_adjust() const { return phase_adjust_ms_; }
     bool is_on() const { return led_on_; }
     uint32_t get_last_toggle_time() const { return last_toggle_time_ms_; }
 
    private:
+    static uint32_t at_least_1ms(uint32_t duration_ms) {
+        return duration_ms == 0 ? 1 : duration_ms;
+    }
+
+    // Edge at time_ms: toggle and latch pending durations
+    void toggle_at(uint32_t time_ms) {
+        led_on_ = !led_on_;
+        last_toggle_time_ms_ = time_ms;
+        on_duration_ms_ = next_on_duration_ms_;
+        off_duration_ms_ = next_off_duration_ms_;
+        phase_adjust_ms_ = 0;
+    }
+
+    // Time elapsed since last toggle
+    uint32_t elapsed_since_toggle(uint32_t current_time_ms) const {
+        if (current_time_ms >= last_toggle_time_ms_) {
+            // Normal case: no wraparound
+            return current_time_ms - last_toggle_time_ms_;
+        }
+        // Handle uint32_t wraparound (occurs after ~49.7 days)
+        return (UINT32_MAX - last_toggle_time_ms_) + current_time_ms + 1;
+    }
+
+    // Duration of the interval in progress, including any phase shift
+    uint32_t current_target_duration() const {
+        uint32_t const target_duration = led_on_ ? on_duration_ms_ : off_duration_ms_;
+        if (phase_adjust_ms_ == 0) {
+            return target_duration;
+        }
+        return adjusted_duration(target_duration, phase_adjust_ms_);
+    }
+
+    // Apply a signed phase shift to a duration, saturating at 0 and UINT32_MAX
+    static uint32_t adjusted_duration(uint32_t duration, int32_t adjust) {
+        if (adjust < 0) {
+            uint32_t const advance = static_cast<uint32_t>(-(static_cast<int64_t>(adjust)));
+            return advance >= duration ? 0 : duration - advance;
+        }
+        uint32_t const delay = static_cast<uint32_t>(adjust);
+        return delay > UINT32_MAX - duration ? UINT32_MAX : duration + delay;
+    }
+
     output_pin_t& output_;
     uint32_t on_duration_ms_;
     uint32_t off_duration_ms_;
+    uint32_t next_on_duration_ms_;
+    uint32_t next_off_duration_ms_;
     uint32_t last_toggle_time_ms_;
+    int32_t phase_adjust_ms_;
     bool led_on_;
 };
@@ -0,0 +1,195 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "seqlock.h"
+
+/**
+ * @brief Inspected state of one channel
+ */
+struct channel_snapshot {
+    bool on;
+    uint32_t last_toggle_ms;
+    uint32_t change_count;  // Frames whose on state differed from the previous frame
+};
+
+/**
+ * @brief Consistent copy of every channel at one published frame
+ *
+ * @tparam channel_count_v Number of channels
+ */
+template<std::size_t channel_count_v>
+struct monitor_snapshot {
+    uint32_t frame;    // Frame number (1 = first published frame, 0 = none yet)
+    uint32_t time_ms;  // Tick time passed to begin_frame()
+    channel_snapshot channels[channel_count_v];
+};
+
+/**
+ * @brief Seqlock-protected view of a bank of blink_controllers
+ *
+ * The control thread records every controller after its update() and
+ * publishes a frame; monitoring threads take consistent bulk snapshots at
+ * their own rate. The writer never blocks or retries - readers retry if
+ * they overlap a frame being written.
+ *
+ * Writer cost is one comparison per channel plus atomic stores only for
+ * channels whose state changed since the previous frame. change_count is
+ * derived by the writer from successive frames (31 bits, wrapping): it
+ * counts sampled state changes, not edges. An even number of edges between
+ * two frames (several edges per fast_forward(), for example) leaves the
+ * state unchanged and counts as none; use last_toggle_ms to see that the
+ * channel moved.
+ *
+ * Control thread (e.g. 1 kHz):
+ *   for (auto& c : controllers) c.update(now);
+ *   monitor.publish(controllers, now);
+ *
+ * Monitoring thread (e.g. 10 Hz):
+ *   monitor_snapshot<N> snap;
+ *   monitor.snapshot(snap);
+ *
+ * Desktop/host only (requires <atomic>).
+ *
+ * @tparam channel_count_v Number of channels
+ */
+template<std::size_t channel_count_v>
+struct blink_monitor {
+   public:
+    static std::size_t const CHANNEL_COUNT = channel_count_v;
+
+    blink_monitor() : frame_(0) {
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            words_[i].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            last_toggle_ms_[i] = 0;
+            state_word_[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Start recording a frame (writer thread only)
+     *
+     * @param time_ms Tick time the frame describes
+     */
+    void begin_frame(uint32_t time_ms) {
+        lock_.write_begin();
+        seqlock_store(words_[TIME_WORD], time_ms);
+    }
+
+    /**
+     * @brief Record one channel (between begin_frame and end_frame)
+     *
+     * @tparam controller_t Type with is_on() and get_last_toggle_time()
+     * @param channel Channel index (< channel_count_v)
+     * @param controller Controller driving that channel
+     */
+    template<typename controller_t>
+    void record(std::size_t channel, controller_t const& controller) {
+        bool const on = controller.is_on();
+        uint32_t const last_toggle_ms = controller.get_last_toggle_time();
+
+        uint32_t state = state_word_[channel];
+        if (on != ((state & 1u) != 0)) {
+            // Edge seen since the previous frame: bump the counter, store the flag
+            state = (((state >> 1) + 1) << 1) | (on ? 1u : 0u);
+            state_word_[channel] = state;
+            seqlock_store(words_[channel_word(channel) + 1], state);
+        }
+        if (last_toggle_ms != last_toggle_ms_[channel]) {
+            last_toggle_ms_[channel] = last_toggle_ms;
+            seqlock_store(words_[channel_word(channel)], last_toggle_ms);
+        }
+    }
+
+    /**
+     * @brief Publish the frame recorded since begin_frame()
+     */
+    void end_frame() {
+        ++frame_;
+        seqlock_store(words_[FRAME_WORD], frame_);
+        lock_.write_end();
+    }
+
+    /**
+     * @brief Record and publish a whole array of controllers
+     *
+     * @param controllers Array of channel_count_v controllers
+     * @param time_ms Tick time the frame describes
+     */
+    template<typename controller_t>
+    void publish(controller_t const* controllers, uint32_t time_ms) {
+        begin_frame(time_ms);
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            record(i, controllers[i]);
+        }
+        end_frame();
+    }
+
+    /**
+     * @brief Take one snapshot attempt (any thread, never blocks the writer)
+     *
+     * @param out Destination
+     * @return false A frame is being (or was) written concurrently; out is unspecified
+     */
+    bool try_snapshot(monitor_snapshot<channel_count_v>& out) const {
+        uint32_t raw[WORD_COUNT];
+        uint32_t seq;
+        if (!lock_.try_read_begin(seq)) {
+            return false;
+        }
+        seqlock_copy(words_, raw, WORD_COUNT);
+        if (lock_.read_retry(seq)) {
+            return false;
+        }
+        decode(raw, out);
+        return true;
+    }
+
+    /**
+     * @brief Take a consistent snapshot, retrying until one succeeds
+     *
+     * @param out Destination
+     */
+    void snapshot(monitor_snapshot<channel_count_v>& out) const {
+        while (!try_snapshot(out)) {
+        }
+    }
+
+    /**
+     * @brief Number of frames published (readable from any thread)
+     */
+    uint32_t get_frame_count() const { return lock_.sequence() / 2; }
+
+   private:
+    static std::size_t const FRAME_WORD = 0;
+    static std::size_t const TIME_WORD = 1;
+    static std::size_t const HEADER_WORDS = 2;
+    static std::size_t const WORD_COUNT = HEADER_WORDS + 2 * channel_count_v;
+
+    static std::size_t channel_word(std::size_t channel) { return HEADER_WORDS + 2 * channel; }
+
+    static void decode(uint32_t const* raw, monitor_snapshot<channel_count_v>& out) {
+        out.frame = raw[FRAME_WORD];
+        out.time_ms = raw[TIME_WORD];
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            uint32_t const state = raw[channel_word(i) + 1];
+            out.channels[i].on = (state & 1u) != 0;
+            out.channels[i].last_toggle_ms = raw[channel_word(i)];
+            out.channels[i].change_count = state >> 1;
+        }
+    }
+
+    seqlock lock_;
+    std::atomic<uint32_t> words_[WORD_COUNT];
+
+    // Writer-private shadow state (never read by monitoring threads)
+    uint32_t frame_;
+    uint32_t last_toggle_ms_[channel_count_v];
+    uint32_t state_word_[channel_count_v];
+};
+
+template<std::size_t channel_count_v>
+std::size_t const blink_monitor<channel_count_v>::CHANNEL_COUNT;
@@ -0,0 +1,157 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Worst-case COBS encoding size of a payload (without the 0x00 delimiter)
+ */
+inline std::size_t cobs_max_encoded_size(std::size_t length) { return length + length / 254 + 1; }
+
+/**
+ * @brief Consistent Overhead Byte Stuffing: remove every 0x00 from a payload
+ *
+ * The encoded block contains no zero bytes, so 0x00 can delimit frames on a
+ * byte stream and a receiver can resynchronize at the next delimiter after
+ * any corruption. Overhead is one byte per 254 bytes of payload.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * @param source Payload bytes
+ * @param length Payload length
+ * @param dest Output buffer (no delimiter is appended)
+ * @param capacity Size of dest; cobs_max_encoded_size(length) always suffices
+ * @return std::size_t Encoded length, 0 if dest is too small
+ */
+inline std::size_t cobs_encode(uint8_t const* source, std::size_t length, uint8_t* dest,
+                               std::size_t capacity) {
+    if (capacity == 0) {
+        return 0;
+    }
+    std::size_t code_index = 0;
+    std::size_t out = 1;
+    uint8_t code = 1;
+    for (std::size_t i = 0; i < length; ++i) {
+        if (source[i] != 0) {
+            if (out >= capacity) {
+                return 0;
+            }
+            dest[out++] = source[i];
+            ++code;
+        }
+        if (source[i] == 0 || code == 0xFF) {
+            dest[code_index] = code;
+            code = 1;
+            if (out >= capacity) {
+                return 0;
+            }
+            code_index = out++;
+        }
+    }
+    dest[code_index] = code;
+    return out;
+}
+
+/**
+ * @brief Incremental COBS decoder over a fixed buffer
+ *
+ * Bytes are decoded as they arrive (one push() per received byte), straight
+ * into the frame buffer: there is no separate receive buffer and no copy
+ * once a frame completes. data()/size() stay valid until the next push().
+ * A frame longer than the buffer, or a delimiter in the middle of a COBS
+ * block, is reported once and the decoder resynchronizes on the next 0x00.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   cobs_decoder<32> decoder;
+ *   if (decoder.push(byte) == cobs_decoder<32>::frame) {
+ *       handle(decoder.data(), decoder.size());
+ *   }
+ *
+ * @tparam capacity_v Largest decoded frame in bytes
+ */
+template<std::size_t capacity_v>
+struct cobs_decoder {
+   public:
+    enum result { pending, frame, error };
+
+    static std::size_t const CAPACITY = capacity_v;
+
+    cobs_decoder() { reset(); }
+
+    /**
+     * @brief Discard any partial frame
+     */
+    void reset() {
+        length_ = 0;
+        remaining_ = 0;
+        code_ = 0xFF;
+        started_ = false;
+        overflow_ = false;
+    }
+
+    /**
+     * @brief Feed one received byte
+     *
+     * @return frame A complete frame is in data()/size()
+     * @return error The frame just delimited was malformed or too long
+     * @return pending Need more bytes
+     */
+    result push(uint8_t byte) {
+        if (byte == 0) {
+            bool const empty = !started_;
+            bool const valid = !overflow_ && remaining_ == 0;
+            std::size_t const length = length_;
+            reset();
+            if (empty) {
+                return pending;  // Back-to-back delimiters (line idle/resync)
+            }
+            length_ = valid ? length : 0;
+            return valid ? frame : error;
+        }
+
+        if (!started_) {
+            // Previous frame's data is no longer needed once a new one begins
+            length_ = 0;
+            started_ = true;
+        }
+        if (overflow_) {
+            return pending;
+        }
+        if (remaining_ == 0) {
+            // Code byte: a block that ended before 0xFF implied a zero
+            if (code_ != 0xFF && !append(0)) {
+                return pending;
+            }
+            code_ = byte;
+            remaining_ = static_cast<uint8_t>(byte - 1);
+            return pending;
+        }
+        append(byte);
+        --remaining_;
+        return pending;
+    }
+
+    uint8_t const* data() const { return buffer_; }
+    std::size_t size() const { return length_; }
+
+   private:
+    bool append(uint8_t byte) {
+        if (length_ >= capacity_v) {
+            overflow_ = true;
+            return false;
+        }
+        buffer_[length_++] = byte;
+        return true;
+    }
+
+    uint8_t buffer_[capacity_v];
+    std::size_t length_;
+    uint8_t remaining_;
+    uint8_t code_;
+    bool started_;
+    bool overflow_;
+};
+
+template<std::size_t capacity_v>
+std::size_t const cobs_decoder<capacity_v>::CAPACITY;
@@ -89,23 +89,23 @@ struct console_led_pin {
      */
     static std::string format_output(uint32_t timestamp_ms, bool state) {
         std::ostringstream oss;
-
-        // ANSI color codes
-        char const* green = "\033[32m";  // Green text
-        char const* red = "\033[31m";    // Red text
-        char const* reset = "\033[0m";   // Reset to default
-
-        oss << "[" << timestamp_ms << "ms] LED: ";
-
-        if (state) {
-            oss << green << "███ ON ███" << reset;
-        } else {
-            oss << red << "▓▓▓ OFF ▓▓▓" << reset;
-        }
-
+        oss << "[" << timestamp_ms << "ms] LED: " << state_label(state);
         return oss.str();
     }
 
+    /**
+     * @brief Colored state label used by format_output()
+     *
+     * Returns a string literal, so it can also be passed to deferred
+     * loggers (binary_log.h) that store pointers rather than copies.
+     *
+     * @param state LED state (true=ON, false=OFF)
+     * @return char const* Label with ANSI color codes (GREEN ON, RED OFF)
+     */
+    static char const* state_label(bool state) {
+        return state ? "\033[32m███ ON ███\033[0m" : "\033[31m▓▓▓ OFF ▓▓▓\033[0m";
+    }
+
     /**
      * @brief Strip ANSI color codes from string (for testing)
      *
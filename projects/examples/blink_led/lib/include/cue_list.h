@@ -0,0 +1,314 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "smf_import.h"
+
+/**
+ * @brief One recorded channel change; previous is filled in by compile()
+ */
+struct cue_change {
+    uint16_t channel;
+    uint8_t level;
+    uint8_t previous;  // Level before the cue (tracked state), for back()
+};
+
+/**
+ * @brief Operator cue list compiled to per-cue deltas and periodic snapshots
+ *
+ * Cues are recorded the way a tracking console records them: only the
+ * channels a cue changes, with everything else carried over from earlier
+ * cues. compile() walks the list once and stores
+ *   - each cue's delta: its changes with the level each one replaces,
+ *     dropping changes that do not change anything
+ *   - a full snapshot of every channel every snapshot_interval_v cues
+ * so GO and back apply one small delta, and a jump to any cue copies the
+ * nearest earlier snapshot and applies fewer than snapshot_interval_v
+ * deltas instead of replaying the show from the top.
+ *
+ * Channels drive fade controllers bound with bind(): GO fades the changed
+ * channels over the cue's fade time, a jump fades every channel that differs
+ * over the jump time. Cue numbers are thousandths, as MSC sends them
+ * ("47.5" -> 47500), so handle() can take MSC GO and RESET directly.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   cue_list<fade_controller<level_pin>, 64, 500, 4000> show;
+ *   show.bind(0, fade);
+ *   show.add_cue(1000, 2000);      // Cue 1, 2 s fade
+ *   show.add_change(0, 255);
+ *   show.compile();
+ *   show.go(millis());
+ *   show.jump(47000, millis(), 0);  // Cue 47, snap
+ *
+ * @tparam fade_t Type with set_fade_duration(uint32_t) and set_target(uint8_t, uint32_t)
+ * @tparam channels_v Channels in the look
+ * @tparam max_cues_v Cue capacity
+ * @tparam max_changes_v Recorded changes across all cues
+ * @tparam snapshot_interval_v Cues between full snapshots (jump cost vs memory)
+ */
+template<typename fade_t, std::size_t channels_v, std::size_t max_cues_v,
+         std::size_t max_changes_v, std::size_t snapshot_interval_v = 32>
+struct cue_list {
+   public:
+    static_assert(channels_v >= 1 && channels_v <= 65535, "1 to 65535 channels");
+    static_assert(snapshot_interval_v >= 1, "snapshot interval must be at least 1");
+
+    static std::size_t const SNAPSHOT_COUNT = max_cues_v / snapshot_interval_v + 1;
+
+    cue_list() : cue_count_(0), change_count_(0), position_(0), compiled_(false) {
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            outputs_[c] = nullptr;
+            levels_[c] = 0;
+        }
+    }
+
+    /**
+     * @brief Drive a channel's fade controller from the cue list
+     */
+    bool bind(std::size_t channel, fade_t& fade) {
+        if (channel >= channels_v) {
+            return false;
+        }
+        outputs_[channel] = &fade;
+        return true;
+    }
+
+    /**
+     * @brief Append a cue (numbers strictly increasing); needs compile() again
+     *
+     * @param number Cue number in thousandths
+     * @param fade_ms Fade time for GO into this cue
+     */
+    bool add_cue(uint32_t number, uint32_t fade_ms) {
+        if (cue_count_ == max_cues_v || number == MIDI_CUE_NONE ||
+            (cue_count_ > 0 && number <= cues_[cue_count_ - 1].number)) {
+            return false;
+        }
+        cue_record& cue = cues_[cue_count_++];
+        cue.number = number;
+        cue.fade_ms = fade_ms;
+        cue.first = change_count_;
+        cue.count = 0;
+        compiled_ = false;
+        return true;
+    }
+
+    /**
+     * @brief Record a channel level in the last added cue
+     */
+    bool add_change(std::size_t channel, uint8_t level) {
+        if (cue_count_ == 0 || channel >= channels_v || change_count_ == max_changes_v) {
+            return false;
+        }
+        cue_change& change = changes_[change_count_++];
+        change.channel = static_cast<uint16_t>(channel);
+        change.level = level;
+        change.previous = 0;
+        ++cues_[cue_count_ - 1].count;
+        compiled_ = false;
+        return true;
+    }
+
+    /**
+     * @brief Build deltas and snapshots; the look starts dark, before the first cue
+     *
+     * Outputs are not touched; the next GO or jump drives them.
+     */
+    void compile() {
+        uint8_t* state = look_;
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            state[c] = 0;
+        }
+        store_snapshot(0, state);
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < cue_count_; ++i) {
+            cue_record& cue = cues_[i];
+            std::size_t const first = kept;
+            for (std::size_t k = cue.first; k < cue.first + cue.count; ++k) {
+                cue_change change = changes_[k];
+                if (state[change.channel] == change.level) {
+                    continue;  // Tracks: already at this level
+                }
+                change.previous = state[change.channel];
+                state[change.channel] = change.level;
+                changes_[kept++] = change;
+            }
+            cue.first = static_cast<uint32_t>(first);
+            cue.count = static_cast<uint32_t>(kept - first);
+            if ((i + 1) % snapshot_interval_v == 0) {
+                store_snapshot((i + 1) / snapshot_interval_v, state);
+            }
+        }
+        change_count_ = kept;
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            levels_[c] = 0;
+        }
+        position_ = 0;
+        compiled_ = true;
+    }
+
+    /**
+     * @brief Fade into the next cue
+     *
+     * @return false at the end of the list (or not compiled)
+     */
+    bool go(uint32_t now_ms) {
+        if (!compiled_ || position_ == cue_count_) {
+            return false;
+        }
+        cue_record const& cue = cues_[position_++];
+        for (std::size_t k = cue.first; k < cue.first + cue.count; ++k) {
+            set_level(changes_[k].channel, changes_[k].level, cue.fade_ms, now_ms);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Undo the current cue, fading back over its fade time
+     */
+    bool back(uint32_t now_ms) {
+        if (!compiled_ || position_ == 0) {
+            return false;
+        }
+        cue_record const& cue = cues_[--position_];
+        for (std::size_t k = cue.first + cue.count; k-- > cue.first;) {
+            set_level(changes_[k].channel, changes_[k].previous, cue.fade_ms, now_ms);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Jump to a cue by number
+     *
+     * @return false if there is no such cue
+     */
+    bool jump(uint32_t number, uint32_t now_ms, uint32_t fade_ms) {
+        std::size_t const index = find(number);
+        return index != cue_count_ && jump_to_position(index + 1, now_ms, fade_ms);
+    }
+
+    /**
+     * @brief Jump to the state after position cues (0: dark, before the first cue)
+     *
+     * Copies the nearest snapshot at or before position, applies the
+     * remaining deltas, then fades the channels that differ from now.
+     */
+    bool jump_to_position(std::size_t position, uint32_t now_ms, uint32_t fade_ms) {
+        if (!compiled_ || position > cue_count_) {
+            return false;
+        }
+        std::size_t const snapshot = position / snapshot_interval_v;
+        uint8_t const* base = snapshots_ + snapshot * channels_v;
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            look_[c] = base[c];
+        }
+        cue_record const* const end = cues_ + position;
+        for (cue_record const* cue = cues_ + snapshot * snapshot_interval_v; cue != end; ++cue) {
+            cue_change const* const last = changes_ + cue->first + cue->count;
+            for (cue_change const* change = changes_ + cue->first; change != last; ++change) {
+                look_[change->channel] = change->level;
+            }
+        }
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            if (look_[c] != levels_[c]) {
+                set_level(c, look_[c], fade_ms, now_ms);
+            }
+        }
+        position_ = position;
+        return true;
+    }
+
+    /**
+     * @brief MSC GO (next cue, or jump to its cue number with that cue's fade) and RESET
+     *
+     * @return false for other commands or cues that do not apply
+     */
+    bool handle(midi_cue const& msc, uint32_t now_ms) {
+        if (msc.type != midi_cue_type::show_control) {
+            return false;
+        }
+        if (msc.number == MSC_RESET) {
+            return jump_to_position(0, now_ms, 0);
+        }
+        if (msc.number != MSC_GO) {
+            return false;
+        }
+        if (msc.cue == MIDI_CUE_NONE) {
+            return go(now_ms);
+        }
+        std::size_t const index = find(msc.cue);
+        return index != cue_count_ &&
+               jump_to_position(index + 1, now_ms, cues_[index].fade_ms);
+    }
+
+    /**
+     * @brief Number of the last cue applied (MIDI_CUE_NONE before the first)
+     */
+    uint32_t get_current_cue() const {
+        return position_ == 0 ? MIDI_CUE_NONE : cues_[position_ - 1].number;
+    }
+
+    std::size_t get_position() const { return position_; }
+    std::size_t get_cue_count() const { return cue_count_; }
+    std::size_t get_change_count() const { return change_count_; }
+    uint8_t get_level(std::size_t channel) const { return levels_[channel]; }
+    uint8_t const* levels() const { return levels_; }
+    bool is_compiled() const { return compiled_; }
+
+   private:
+    struct cue_record {
+        uint32_t number;
+        uint32_t fade_ms;
+        uint32_t first;  // Index into changes_
+        uint32_t count;
+    };
+
+    // Index of the cue with this number, or cue_count_
+    std::size_t find(uint32_t number) const {
+        std::size_t lo = 0;
+        std::size_t hi = cue_count_;
+        while (lo < hi) {
+            std::size_t const mid = lo + (hi - lo) / 2;
+            if (cues_[mid].number < number) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo < cue_count_ && cues_[lo].number == number ? lo : cue_count_;
+    }
+
+    void store_snapshot(std::size_t index, uint8_t const* state) {
+        uint8_t* out = snapshots_ + index * channels_v;
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            out[c] = state[c];
+        }
+    }
+
+    void set_level(std::size_t channel, uint8_t level, uint32_t fade_ms, uint32_t now_ms) {
+        levels_[channel] = level;
+        fade_t* const fade = outputs_[channel];
+        if (fade != nullptr) {
+            fade->set_fade_duration(fade_ms);
+            fade->set_target(level, now_ms);
+        }
+    }
+
+    cue_record cues_[max_cues_v];
+    cue_change changes_[max_changes_v];
+    uint8_t snapshots_[SNAPSHOT_COUNT * channels_v];
+    uint8_t levels_[channels_v];  // Current look
+    uint8_t look_[channels_v];    // Scratch for compile() and jumps
+    fade_t* outputs_[channels_v];
+    std::size_t cue_count_;
+    std::size_t change_count_;
+    std::size_t position_;
+    bool compiled_;
+};
+
+template<typename fade_t, std::size_t channels_v, std::size_t max_cues_v,
+         std::size_t max_changes_v, std::size_t snapshot_interval_v>
+std::size_t const
+    cue_list<fade_t, channels_v, max_cues_v, max_changes_v, snapshot_interval_v>::SNAPSHOT_COUNT;
@@ -0,0 +1,434 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "dmx_packet.h"
+
+/**
+ * @brief Per-universe source tracking and merge, following E1.31 rules
+ *
+ * Each subscribed universe keeps up to max_sources_v sources (identified by
+ * the E1.31 CID, or the sender address for Art-Net). For every source:
+ *   - packets failing the sequence check are dropped as late/reordered
+ *   - preview packets are ignored; a stream-terminated packet removes it
+ *   - silence for SOURCE_TIMEOUT_MS (2.5 s) removes it (see expire())
+ * The universe output is the highest-priority sources' data, highest value
+ * taking precedence (HTP) where several sources share that priority.
+ *
+ * All storage is fixed at compile time: no heap, no STL.
+ *
+ * Usage:
+ *   dmx_merger<2> merger;
+ *   merger.subscribe(1);
+ *   if (merger.accept(packet, source_id, millis())) {
+ *       patch.apply(packet.universe, merger.get_slots(packet.universe),
+ *                   merger.get_slot_count(packet.universe), millis());
+ *   }
+ *
+ * @tparam max_universes_v Universes that can be subscribed
+ * @tparam max_sources_v Concurrent sources tracked per universe
+ */
+template<std::size_t max_universes_v, std::size_t max_sources_v = 2>
+struct dmx_merger {
+   public:
+    static_assert(max_universes_v >= 1 && max_sources_v >= 1, "need at least one of each");
+
+    static uint32_t const SOURCE_TIMEOUT_MS = 2500;
+
+    dmx_merger()
+        : universe_count_(0),
+          accepted_(0),
+          unsubscribed_(0),
+          sequence_drops_(0),
+          preview_drops_(0),
+          source_overflows_(0) {}
+
+    /**
+     * @brief Start tracking a universe (1-63999)
+     *
+     * @return false Universe invalid or no room left
+     */
+    bool subscribe(uint16_t universe) {
+        if (universe == 0 || universe > 63999) {
+            return false;
+        }
+        if (find(universe) != nullptr) {
+            return true;
+        }
+        if (universe_count_ == max_universes_v) {
+            return false;
+        }
+        universe_state& state = universes_[universe_count_++];
+        state.universe = universe;
+        state.slot_count = 0;
+        for (std::size_t i = 0; i < max_sources_v; ++i) {
+            state.sources[i].active = false;
+        }
+        clear_slots(state.output, 0);
+        return true;
+    }
+
+    bool is_subscribed(uint16_t universe) const { return find(universe) != nullptr; }
+
+    /**
+     * @brief Feed one parsed packet
+     *
+     * @param packet Parsed E1.31 or Art-Net packet
+     * @param source_id SOURCE_ID_SIZE bytes identifying the sender
+     * @param now_ms Receive time in milliseconds
+     * @return true The universe output was recomputed
+     */
+    bool accept(dmx_packet const& packet, uint8_t const* source_id, uint32_t now_ms) {
+        universe_state* const state = find(packet.universe);
+        if (state == nullptr) {
+            ++unsubscribed_;
+            return false;
+        }
+        if ((packet.options & E131_OPTION_PREVIEW) != 0) {
+            ++preview_drops_;
+            return false;
+        }
+        source_state* source = find_source(*state, source_id);
+        if ((packet.options & E131_OPTION_TERMINATED) != 0) {
+            if (source == nullptr) {
+                return false;
+            }
+            source->active = false;
+            merge(*state);
+            return true;
+        }
+        if (source != nullptr) {
+            // Art-Net sequence 0 means the sender does not sequence
+            bool const sequenced = packet.protocol == dmx_protocol::e131 || packet.sequence != 0;
+            if (sequenced && !dmx_sequence_accept(source->sequence, packet.sequence)) {
+                ++sequence_drops_;
+                return false;
+            }
+        } else {
+            source = free_source(*state);
+            if (source == nullptr) {
+                ++source_overflows_;
+                return false;
+            }
+            source->active = true;
+            for (std::size_t i = 0; i < dmx_packet::SOURCE_ID_SIZE; ++i) {
+                source->id[i] = source_id[i];
+            }
+        }
+        source->sequence = packet.sequence;
+        source->priority = packet.priority;
+        source->last_seen_ms = now_ms;
+        source->slot_count = packet.slot_count;
+        for (std::size_t i = 0; i < packet.slot_count; ++i) {
+            source->slots[i] = packet.slots[i];
+        }
+        ++accepted_;
+        merge(*state);
+        return true;
+    }
+
+    /**
+     * @brief Drop sources silent for longer than SOURCE_TIMEOUT_MS
+     *
+     * @param now_ms Current time in milliseconds (wraparound-safe)
+     * @return std::size_t Number of sources removed
+     */
+    std::size_t expire(uint32_t now_ms) {
+        std::size_t removed = 0;
+        for (std::size_t u = 0; u < universe_count_; ++u) {
+            universe_state& state = universes_[u];
+            std::size_t before = removed;
+            for (std::size_t s = 0; s < max_sources_v; ++s) {
+                source_state& source = state.sources[s];
+                if (source.active && now_ms - source.last_seen_ms > SOURCE_TIMEOUT_MS) {
+                    source.active = false;
+                    ++removed;
+                }
+            }
+            if (removed != before) {
+                merge(state);
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Merged slot values for a universe (nullptr if not subscribed)
+     */
+    uint8_t const* get_slots(uint16_t universe) const {
+        universe_state const* const state = find(universe);
+        return state == nullptr ? nullptr : state->output;
+    }
+
+    /**
+     * @brief Merged slot count (longest winning source; 0 with no sources)
+     */
+    uint16_t get_slot_count(uint16_t universe) const {
+        universe_state const* const state = find(universe);
+        return state == nullptr ? 0 : state->slot_count;
+    }
+
+    /**
+     * @brief Number of active sources on a universe
+     */
+    std::size_t get_source_count(uint16_t universe) const {
+        universe_state const* const state = find(universe);
+        std::size_t count = 0;
+        for (std::size_t s = 0; state != nullptr && s < max_sources_v; ++s) {
+            count += state->sources[s].active ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Statistics
+    uint32_t get_accepted() const { return accepted_; }
+    uint32_t get_unsubscribed() const { return unsubscribed_; }
+    uint32_t get_sequence_drops() const { return sequence_drops_; }
+    uint32_t get_preview_drops() const { return preview_drops_; }
+    uint32_t get_source_overflows() const { return source_overflows_; }
+
+   private:
+    struct source_state {
+        bool active;
+        uint8_t id[dmx_packet::SOURCE_ID_SIZE];
+        uint8_t sequence;
+        uint8_t priority;
+        uint32_t last_seen_ms;
+        uint16_t slot_count;
+        uint8_t slots[dmx_packet::MAX_SLOTS];
+    };
+
+    struct universe_state {
+        uint16_t universe;
+        uint16_t slot_count;
+        source_state sources[max_sources_v];
+        uint8_t output[dmx_packet::MAX_SLOTS];
+    };
+
+    universe_state* find(uint16_t universe) {
+        for (std::size_t i = 0; i < universe_count_; ++i) {
+            if (universes_[i].universe == universe) {
+                return &universes_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    universe_state const* find(uint16_t universe) const {
+        return const_cast<dmx_merger*>(this)->find(universe);
+    }
+
+    static source_state* find_source(universe_state& state, uint8_t const* id) {
+        for (std::size_t s = 0; s < max_sources_v; ++s) {
+            source_state& source = state.sources[s];
+            if (source.active && dmx_packet_detail::bytes_equal(source.id, id, sizeof(source.id))) {
+                return &source;
+            }
+        }
+        return nullptr;
+    }
+
+    static source_state* free_source(universe_state& state) {
+        for (std::size_t s = 0; s < max_sources_v; ++s) {
+            if (!state.sources[s].active) {
+                return &state.sources[s];
+            }
+        }
+        return nullptr;
+    }
+
+    static void clear_slots(uint8_t* slots, std::size_t from) {
+        for (std::size_t i = from; i < dmx_packet::MAX_SLOTS; ++i) {
+            slots[i] = 0;
+        }
+    }
+
+    // Highest priority wins; HTP among sources sharing it
+    static void merge(universe_state& state) {
+        int winning_priority = -1;
+        for (std::size_t s = 0; s < max_sources_v; ++s) {
+            source_state const& source = state.sources[s];
+            if (source.active && source.priority > winning_priority) {
+                winning_priority = source.priority;
+            }
+        }
+        uint16_t slot_count = 0;
+        bool first = true;
+        for (std::size_t s = 0; s < max_sources_v; ++s) {
+            source_state const& source = state.sources[s];
+            if (!source.active || source.priority != winning_priority) {
+                continue;
+            }
+            if (first) {
+                for (std::size_t i = 0; i < source.slot_count; ++i) {
+                    state.output[i] = source.slots[i];
+                }
+                clear_slots(state.output, source.slot_count);
+                first = false;
+            } else {
+                for (std::size_t i = 0; i < source.slot_count; ++i) {
+                    if (source.slots[i] > state.output[i]) {
+                        state.output[i] = source.slots[i];
+                    }
+                }
+            }
+            if (source.slot_count > slot_count) {
+                slot_count = source.slot_count;
+            }
+        }
+        if (first) {
+            clear_slots(state.output, 0);
+        }
+        state.slot_count = slot_count;
+    }
+
+    universe_state universes_[max_universes_v];
+    std::size_t universe_count_;
+    uint32_t accepted_;
+    uint32_t unsubscribed_;
+    uint32_t sequence_drops_;
+    uint32_t preview_drops_;
+    uint32_t source_overflows_;
+};
+
+template<std::size_t max_universes_v, std::size_t max_sources_v>
+uint32_t const dmx_merger<max_universes_v, max_sources_v>::SOURCE_TIMEOUT_MS;
+
+/**
+ * @brief Maps DMX slots onto output channels, fades and blink rates
+ *
+ * Each entry binds one slot of one universe (slots numbered from 1, as on a
+ * desk) to a target:
+ *   - map_channel: a bank channel, on at 128 and above
+ *   - map_fade: a fade controller's target level
+ *   - map_blink: a blink controller's period, 2000 ms at 0 down to 50 ms
+ *     at 255 (50% duty), applied only when the slot value changes
+ * apply() walks the entries for one universe; it is cheap enough to run on
+ * every merged packet.
+ *
+ * @tparam bank_t Type with set(std::size_t, bool) (output_bank)
+ * @tparam fade_t Type with set_target(uint8_t, uint32_t) (fade_controller)
+ * @tparam blink_t Type with set_durations(uint32_t, uint32_t) (blink_controller)
+ * @tparam max_entries_v Patch capacity
+ */
+template<typename bank_t, typename fade_t, typename blink_t, std::size_t max_entries_v = 512>
+struct dmx_patch {
+   public:
+    static uint32_t const BLINK_SLOWEST_MS = 2000;
+    static uint32_t const BLINK_FASTEST_MS = 50;
+
+    dmx_patch() : count_(0) {}
+
+    bool map_channel(uint16_t universe, uint16_t slot, bank_t& bank, std::size_t channel) {
+        entry* const e = add(universe, slot, entry_kind::channel);
+        if (e == nullptr) {
+            return false;
+        }
+        e->bank = &bank;
+        e->channel = channel;
+        return true;
+    }
+
+    bool map_fade(uint16_t universe, uint16_t slot, fade_t& fade) {
+        entry* const e = add(universe, slot, entry_kind::fade);
+        if (e == nullptr) {
+            return false;
+        }
+        e->fade = &fade;
+        return true;
+    }
+
+    bool map_blink(uint16_t universe, uint16_t slot, blink_t& blink) {
+        entry* const e = add(universe, slot, entry_kind::blink);
+        if (e == nullptr) {
+            return false;
+        }
+        e->blink = &blink;
+        return true;
+    }
+
+    /**
+     * @brief Push one universe's slot values to its patched outputs
+     *
+     * Slots beyond slot_count read as 0.
+     *
+     * @return std::size_t Entries applied
+     */
+    std::size_t apply(uint16_t universe, uint8_t const* slots, uint16_t slot_count,
+                      uint32_t now_ms) {
+        std::size_t applied = 0;
+        for (std::size_t i = 0; i < count_; ++i) {
+            entry& e = entries_[i];
+            if (e.universe != universe) {
+                continue;
+            }
+            uint8_t const value = e.slot <= slot_count ? slots[e.slot - 1] : 0;
+            switch (e.kind) {
+                case entry_kind::channel:
+                    e.bank->set(e.channel, value >= 128);
+                    break;
+                case entry_kind::fade:
+                    e.fade->set_target(value, now_ms);
+                    break;
+                case entry_kind::blink:
+                    if (!e.has_value || value != e.last_value) {
+                        uint32_t const half = blink_period(value) / 2;
+                        e.blink->set_durations(half, half);
+                    }
+                    break;
+            }
+            e.last_value = value;
+            e.has_value = true;
+            ++applied;
+        }
+        return applied;
+    }
+
+    static uint32_t blink_period(uint8_t value) {
+        return BLINK_SLOWEST_MS - (BLINK_SLOWEST_MS - BLINK_FASTEST_MS) * value / 255;
+    }
+
+    std::size_t get_entry_count() const { return count_; }
+
+   private:
+    enum class entry_kind : uint8_t { channel, fade, blink };
+
+    struct entry {
+        uint16_t universe;
+        uint16_t slot;
+        entry_kind kind;
+        bool has_value;
+        uint8_t last_value;
+        std::size_t channel;
+        bank_t* bank;
+        fade_t* fade;
+        blink_t* blink;
+    };
+
+    entry* add(uint16_t universe, uint16_t slot, entry_kind kind) {
+        if (count_ == max_entries_v || universe == 0 || slot == 0 ||
+            slot > dmx_packet::MAX_SLOTS) {
+            return nullptr;
+        }
+        entry& e = entries_[count_++];
+        e.universe = universe;
+        e.slot = slot;
+        e.kind = kind;
+        e.has_value = false;
+        e.last_value = 0;
+        e.channel = 0;
+        e.bank = nullptr;
+        e.fade = nullptr;
+        e.blink = nullptr;
+        return &e;
+    }
+
+    entry entries_[max_entries_v];
+    std::size_t count_;
+};
+
+template<typename bank_t, typename fade_t, typename blink_t, std::size_t max_entries_v>
+uint32_t const dmx_patch<bank_t, fade_t, blink_t, max_entries_v>::BLINK_SLOWEST_MS;
+
+template<typename bank_t, typename fade_t, typename blink_t, std::size_t max_entries_v>
+uint32_t const dmx_patch<bank_t, fade_t, blink_t, max_entries_v>::BLINK_FASTEST_MS;
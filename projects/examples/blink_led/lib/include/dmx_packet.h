@@ -0,0 +1,274 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief DMX-over-IP packets: E1.31 (sACN) and Art-Net ArtDmx
+ *
+ * Parsers validate a received datagram and fill a dmx_packet whose pointers
+ * refer into the datagram itself (parsed in place, nothing copied or
+ * allocated). Builders produce the same packets for generators and tests.
+ *
+ * Universes use E1.31 numbering (1-63999). Art-Net port-address N is
+ * reported as universe N + 1, the usual convention in desks that speak both.
+ *
+ * Platform-agnostic (no heap, no STL): usable with an Ethernet shield.
+ */
+enum class dmx_protocol : uint8_t { e131, artnet };
+
+struct dmx_packet {
+    static std::size_t const MAX_SLOTS = 512;
+    static std::size_t const SOURCE_ID_SIZE = 16;
+
+    dmx_protocol protocol;
+    uint16_t universe;
+    uint8_t sequence;      // Art-Net: 0 = sequencing disabled
+    uint8_t priority;      // E1.31 0-200; Art-Net has none and reports 100
+    uint8_t options;       // E1.31 options (E131_OPTION_*); 0 for Art-Net
+    uint8_t const* cid;    // E1.31 component id (16 bytes); nullptr for Art-Net
+    uint8_t const* slots;  // Slot 1 onwards (after the start code)
+    uint16_t slot_count;
+};
+
+static uint16_t const E131_PORT = 5568;
+static uint16_t const ARTNET_PORT = 6454;
+static uint8_t const E131_DEFAULT_PRIORITY = 100;
+static uint8_t const E131_MAX_PRIORITY = 200;
+static uint8_t const E131_OPTION_PREVIEW = 0x80;
+static uint8_t const E131_OPTION_TERMINATED = 0x40;
+static std::size_t const E131_HEADER_SIZE = 126;  // Up to and including the start code
+static std::size_t const ARTNET_HEADER_SIZE = 18;
+static std::size_t const DMX_MAX_PACKET_SIZE = E131_HEADER_SIZE + 512;
+
+namespace dmx_packet_detail {
+
+static uint8_t const ACN_PACKET_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+static uint8_t const ARTNET_ID[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+static uint16_t const ARTNET_OP_DMX = 0x5000;
+
+inline uint16_t read_u16_be(uint8_t const* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline uint32_t read_u32_be(uint8_t const* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline void write_u16_be(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+}
+
+inline void write_u32_be(uint8_t* p, uint32_t value) {
+    write_u16_be(p, static_cast<uint16_t>(value >> 16));
+    write_u16_be(p + 2, static_cast<uint16_t>(value));
+}
+
+// ACN PDU flags (0x7) and length (12 bits) covering offset..end
+inline bool pdu_length_ok(uint8_t const* data, std::size_t offset, std::size_t length) {
+    uint16_t const field = read_u16_be(data + offset);
+    return (field >> 12) == 0x7 && (field & 0x0FFF) == length - offset;
+}
+
+inline bool bytes_equal(uint8_t const* a, uint8_t const* b, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace dmx_packet_detail
+
+/**
+ * @brief Parse an E1.31 data packet (DMX null start code only)
+ *
+ * @return false Not a valid E1.31 DMX packet (or another start code, such as
+ *         0xDD per-address priority, which this receiver ignores)
+ */
+inline bool e131_parse(uint8_t const* data, std::size_t length, dmx_packet& packet) {
+    using namespace dmx_packet_detail;
+    if (length < E131_HEADER_SIZE || length > DMX_MAX_PACKET_SIZE) {
+        return false;
+    }
+    // Root layer
+    if (read_u16_be(data) != 0x0010 || read_u16_be(data + 2) != 0 ||
+        !bytes_equal(data + 4, ACN_PACKET_ID, sizeof(ACN_PACKET_ID)) ||
+        !pdu_length_ok(data, 16, length) || read_u32_be(data + 18) != 0x00000004) {
+        return false;
+    }
+    // Framing layer
+    if (!pdu_length_ok(data, 38, length) || read_u32_be(data + 40) != 0x00000002) {
+        return false;
+    }
+    uint8_t const priority = data[108];
+    uint16_t const universe = read_u16_be(data + 113);
+    if (priority > E131_MAX_PRIORITY || universe == 0 || universe > 63999) {
+        return false;
+    }
+    // DMP layer
+    uint16_t const property_count = read_u16_be(data + 123);
+    if (!pdu_length_ok(data, 115, length) || data[117] != 0x02 || data[118] != 0xA1 ||
+        read_u16_be(data + 119) != 0 || read_u16_be(data + 121) != 1 || property_count < 1 ||
+        property_count - 1u > dmx_packet::MAX_SLOTS ||
+        length != E131_HEADER_SIZE - 1 + property_count) {
+        return false;
+    }
+    if (data[125] != 0) {
+        return false;
+    }
+
+    packet.protocol = dmx_protocol::e131;
+    packet.universe = universe;
+    packet.sequence = data[111];
+    packet.priority = priority;
+    packet.options = data[112];
+    packet.cid = data + 22;
+    packet.slots = data + E131_HEADER_SIZE;
+    packet.slot_count = static_cast<uint16_t>(property_count - 1);
+    return true;
+}
+
+/**
+ * @brief Parse an Art-Net ArtDmx packet
+ *
+ * @return false Not an ArtDmx packet (other opcodes such as ArtPoll are ignored)
+ */
+inline bool artnet_parse(uint8_t const* data, std::size_t length, dmx_packet& packet) {
+    using namespace dmx_packet_detail;
+    if (length < ARTNET_HEADER_SIZE || !bytes_equal(data, ARTNET_ID, sizeof(ARTNET_ID))) {
+        return false;
+    }
+    uint16_t const opcode = static_cast<uint16_t>(data[8] | (data[9] << 8));
+    uint16_t const version = read_u16_be(data + 10);
+    uint16_t const slot_count = read_u16_be(data + 16);
+    if (opcode != ARTNET_OP_DMX || version < 14 || slot_count < 2 ||
+        slot_count > dmx_packet::MAX_SLOTS || length < ARTNET_HEADER_SIZE + slot_count) {
+        return false;
+    }
+
+    packet.protocol = dmx_protocol::artnet;
+    packet.universe = static_cast<uint16_t>((((data[15] & 0x7F) << 8) | data[14]) + 1);
+    packet.sequence = data[12];
+    packet.priority = E131_DEFAULT_PRIORITY;
+    packet.options = 0;
+    packet.cid = nullptr;
+    packet.slots = data + ARTNET_HEADER_SIZE;
+    packet.slot_count = slot_count;
+    return true;
+}
+
+/**
+ * @brief Parse either protocol (by signature)
+ */
+inline bool dmx_parse(uint8_t const* data, std::size_t length, dmx_packet& packet) {
+    if (length >= 1 && data[0] == 'A') {
+        return artnet_parse(data, length, packet);
+    }
+    return e131_parse(data, length, packet);
+}
+
+/**
+ * @brief E1.31 sequence rule: accept unless 0 >= (new - last) > -20
+ *
+ * A small backwards step means a late, reordered packet; a large one means
+ * the source restarted and is accepted.
+ */
+inline bool dmx_sequence_accept(uint8_t last, uint8_t next) {
+    int8_t const delta = static_cast<int8_t>(static_cast<uint8_t>(next - last));
+    return !(delta <= 0 && delta > -20);
+}
+
+/**
+ * @brief Build an E1.31 data packet
+ *
+ * @param out Output buffer (DMX_MAX_PACKET_SIZE always suffices)
+ * @param capacity Size of out
+ * @param cid 16-byte component id of the source
+ * @param source_name Up to 63 characters
+ * @param universe 1-63999
+ * @param priority 0-200
+ * @param sequence Per-universe sequence number
+ * @param options E131_OPTION_* bits
+ * @param slots Slot values (slot 1 onwards)
+ * @param slot_count Up to 512
+ * @return std::size_t Packet length, 0 if it does not fit
+ */
+inline std::size_t e131_build(uint8_t* out, std::size_t capacity, uint8_t const* cid,
+                              char const* source_name, uint16_t universe, uint8_t priority,
+                              uint8_t sequence, uint8_t options, uint8_t const* slots,
+                              uint16_t slot_count) {
+    using namespace dmx_packet_detail;
+    std::size_t const length = E131_HEADER_SIZE + slot_count;
+    if (slot_count > dmx_packet::MAX_SLOTS || length > capacity) {
+        return 0;
+    }
+    for (std::size_t i = 0; i < E131_HEADER_SIZE; ++i) {
+        out[i] = 0;
+    }
+    // Root layer
+    write_u16_be(out, 0x0010);
+    for (std::size_t i = 0; i < sizeof(ACN_PACKET_ID); ++i) {
+        out[4 + i] = ACN_PACKET_ID[i];
+    }
+    write_u16_be(out + 16, static_cast<uint16_t>(0x7000 | (length - 16)));
+    write_u32_be(out + 18, 0x00000004);
+    for (std::size_t i = 0; i < dmx_packet::SOURCE_ID_SIZE; ++i) {
+        out[22 + i] = cid[i];
+    }
+    // Framing layer
+    write_u16_be(out + 38, static_cast<uint16_t>(0x7000 | (length - 38)));
+    write_u32_be(out + 40, 0x00000002);
+    for (std::size_t i = 0; i < 63 && source_name[i] != '\0'; ++i) {
+        out[44 + i] = static_cast<uint8_t>(source_name[i]);
+    }
+    out[108] = priority;
+    out[111] = sequence;
+    out[112] = options;
+    write_u16_be(out + 113, universe);
+    // DMP layer
+    write_u16_be(out + 115, static_cast<uint16_t>(0x7000 | (length - 115)));
+    out[117] = 0x02;
+    out[118] = 0xA1;
+    write_u16_be(out + 121, 1);
+    write_u16_be(out + 123, static_cast<uint16_t>(slot_count + 1));
+    for (std::size_t i = 0; i < slot_count; ++i) {
+        out[E131_HEADER_SIZE + i] = slots[i];
+    }
+    return length;
+}
+
+/**
+ * @brief Build an Art-Net ArtDmx packet
+ *
+ * @param universe E1.31-style universe (port-address + 1)
+ * @param slot_count Up to 512; odd counts are padded with one zero slot
+ * @return std::size_t Packet length, 0 if it does not fit
+ */
+inline std::size_t artnet_build(uint8_t* out, std::size_t capacity, uint16_t universe,
+                                uint8_t sequence, uint8_t const* slots, uint16_t slot_count) {
+    using namespace dmx_packet_detail;
+    uint16_t const padded = static_cast<uint16_t>(slot_count < 2 ? 2 : (slot_count + 1) & ~1u);
+    std::size_t const length = ARTNET_HEADER_SIZE + padded;
+    if (universe == 0 || padded > dmx_packet::MAX_SLOTS || length > capacity) {
+        return 0;
+    }
+    for (std::size_t i = 0; i < sizeof(ARTNET_ID); ++i) {
+        out[i] = ARTNET_ID[i];
+    }
+    uint16_t const port_address = static_cast<uint16_t>(universe - 1);
+    out[8] = static_cast<uint8_t>(ARTNET_OP_DMX);
+    out[9] = static_cast<uint8_t>(ARTNET_OP_DMX >> 8);
+    write_u16_be(out + 10, 14);
+    out[12] = sequence;
+    out[13] = 0;
+    out[14] = static_cast<uint8_t>(port_address);
+    out[15] = static_cast<uint8_t>((port_address >> 8) & 0x7F);
+    write_u16_be(out + 16, padded);
+    for (std::size_t i = 0; i < padded; ++i) {
+        out[ARTNET_HEADER_SIZE + i] = i < slot_count ? slots[i] : 0;
+    }
+    return length;
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <poll.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dmx_packet.h"
+#include "udp_socket.h"
+
+/**
+ * @brief Called for every valid DMX packet
+ *
+ * @param context Pointer registered with receive()
+ * @param packet Parsed packet; its pointers are only valid during the call
+ * @param source_id SOURCE_ID_SIZE bytes: the E1.31 CID, or the sender's
+ *        IPv4 address and port for Art-Net
+ */
+typedef void (*dmx_packet_handler)(void* context, dmx_packet const& packet,
+                                   uint8_t const* source_id);
+
+/**
+ * @brief UDP receiver for E1.31 (sACN) and Art-Net
+ *
+ * One udp_batch_receiver per protocol. receive() drains both with
+ * recvmmsg() into buffers allocated once with the receiver, parses each
+ * datagram in place and hands it to the handler, so the steady state does no
+ * allocation and one system call per batch. Feed the handler into a
+ * dmx_merger and dmx_patch (dmx_merge.h) to drive output banks and
+ * controllers.
+ *
+ * Linux only (recvmmsg).
+ *
+ * Usage:
+ *   dmx_receiver receiver;
+ *   receiver.open();                 // Standard ports 5568 and 6454
+ *   receiver.join_universe(1);       // sACN multicast 239.255.0.1
+ *   while (running) {
+ *       receiver.wait(100);
+ *       receiver.receive(&on_packet, &show);
+ *   }
+ */
+struct dmx_receiver {
+   public:
+    static std::size_t const BATCH_SIZE = 32;
+
+    dmx_receiver() : handler_(nullptr), context_(nullptr), invalid_(0) {}
+
+    dmx_receiver(dmx_receiver const&) = delete;
+    dmx_receiver& operator=(dmx_receiver const&) = delete;
+
+    /**
+     * @brief Bind both sockets on all interfaces
+     *
+     * @param e131_port sACN port (0 = any free port, see get_e131_port())
+     * @param artnet_port Art-Net port (0 = any free port)
+     * @return false A socket could not be created or bound
+     */
+    bool open(uint16_t e131_port = E131_PORT, uint16_t artnet_port = ARTNET_PORT) {
+        if (!e131_.open(e131_port) || !artnet_.open(artnet_port)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        e131_.close();
+        artnet_.close();
+    }
+
+    /**
+     * @brief Join the sACN multicast group for a universe (239.255.hi.lo)
+     *
+     * @return false Not open, invalid universe, or no multicast route
+     */
+    bool join_universe(uint16_t universe) {
+        if (universe == 0 || universe > 63999) {
+            return false;
+        }
+        return e131_.join_group(e131_multicast_address(universe));
+    }
+
+    /**
+     * @brief Wait until either socket is readable
+     *
+     * @param timeout_ms Maximum wait (-1 = forever)
+     * @return true Data is ready
+     */
+    bool wait(int timeout_ms) const {
+        pollfd fds[2] = {{e131_.get_fd(), POLLIN, 0}, {artnet_.get_fd(), POLLIN, 0}};
+        return ::poll(fds, 2, timeout_ms) > 0;
+    }
+
+    /**
+     * @brief Drain both sockets without blocking
+     *
+     * @param handler Called once per valid packet
+     * @param context Passed to handler
+     * @return std::size_t Valid packets delivered
+     */
+    std::size_t receive(dmx_packet_handler handler, void* context) {
+        handler_ = handler;
+        context_ = context;
+        uint64_t const invalid_before = invalid_;
+        std::size_t const datagrams = e131_.receive(&dmx_receiver::on_e131, this) +
+                                      artnet_.receive(&dmx_receiver::on_artnet, this);
+        return datagrams - static_cast<std::size_t>(invalid_ - invalid_before);
+    }
+
+    /**
+     * @brief Multicast group for an sACN universe, host byte order
+     */
+    static uint32_t e131_multicast_address(uint16_t universe) {
+        return 0xEFFF0000u | universe;
+    }
+
+    uint16_t get_e131_port() const { return e131_.get_port(); }
+    uint16_t get_artnet_port() const { return artnet_.get_port(); }
+    bool is_open() const { return e131_.is_open(); }
+
+    // Statistics
+    uint64_t get_datagrams() const { return e131_.get_datagrams() + artnet_.get_datagrams(); }
+    uint64_t get_invalid() const {
+        return invalid_ + e131_.get_truncated() + artnet_.get_truncated();
+    }
+
+   private:
+    typedef udp_batch_receiver<DMX_MAX_PACKET_SIZE, BATCH_SIZE> socket_t;
+
+    static void on_e131(void* context, uint8_t const* data, std::size_t length,
+                        sockaddr_in const&) {
+        dmx_receiver& self = *static_cast<dmx_receiver*>(context);
+        dmx_packet packet;
+        if (!e131_parse(data, length, packet)) {
+            ++self.invalid_;
+            return;
+        }
+        self.handler_(self.context_, packet, packet.cid);
+    }
+
+    static void on_artnet(void* context, uint8_t const* data, std::size_t length,
+                          sockaddr_in const& sender) {
+        dmx_receiver& self = *static_cast<dmx_receiver*>(context);
+        dmx_packet packet;
+        if (!artnet_parse(data, length, packet)) {
+            ++self.invalid_;
+            return;
+        }
+        uint8_t sender_id[dmx_packet::SOURCE_ID_SIZE] = {};
+        dmx_packet_detail::write_u32_be(sender_id, ntohl(sender.sin_addr.s_addr));
+        dmx_packet_detail::write_u16_be(sender_id + 4, ntohs(sender.sin_port));
+        self.handler_(self.context_, packet, sender_id);
+    }
+
+    socket_t e131_;
+    socket_t artnet_;
+    dmx_packet_handler handler_;
+    void* context_;
+    uint64_t invalid_;
+};
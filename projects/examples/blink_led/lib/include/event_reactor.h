@@ -0,0 +1,350 @@
+#pragma once
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "show_clock.h"
+
+/**
+ * @brief Non-allocating callback: plain function pointer plus context
+ *
+ * @param context Pointer registered with the handler
+ * @param events  EPOLLIN/EPOLLOUT/EPOLLHUP/... bits that fired
+ */
+struct event_handler {
+    void (*callback)(void* context, uint32_t events);
+    void* context;
+};
+
+/**
+ * @brief Single-threaded epoll reactor with a timerfd tick source
+ *
+ * Multiplexes file descriptors (serial ports, ptys, sockets, pipes) and one
+ * one-shot tick timer on the calling thread. Everything dispatched by the
+ * reactor runs on that thread, so handlers can touch blink_controllers
+ * directly without locks. The loop sleeps in epoll_wait until either I/O
+ * arrives or the tick timer (armed for the next controller deadline) fires.
+ *
+ * Sources live in a fixed table (MAX_SOURCES), so registration and dispatch
+ * never allocate.
+ *
+ * Linux only.
+ *
+ * Usage:
+ *   event_reactor reactor;
+ *   reactor.open();
+ *   reactor.watch(serial_fd, EPOLLIN, serial_handler);
+ *   reactor.set_tick_handler(tick_handler);
+ *   reactor.arm_tick(0);
+ *   reactor.run();
+ */
+struct event_reactor {
+   public:
+    static std::size_t const MAX_SOURCES = 32;
+    static std::size_t const MAX_EVENTS_PER_WAIT = 16;
+
+    event_reactor() : epoll_fd_(-1), timer_fd_(-1), running_(false) {
+        for (std::size_t i = 0; i < MAX_SOURCES; ++i) {
+            sources_[i].fd = -1;
+        }
+        tick_handler_.callback = nullptr;
+        tick_handler_.context = nullptr;
+    }
+
+    ~event_reactor() { close(); }
+
+    event_reactor(event_reactor const&) = delete;
+    event_reactor& operator=(event_reactor const&) = delete;
+
+    /**
+     * @brief Create the epoll instance and tick timer
+     *
+     * @return false Kernel resources could not be created
+     */
+    bool open() {
+        close();
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (epoll_fd_ < 0 || timer_fd_ < 0) {
+            close();
+            return false;
+        }
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u32 = TIMER_TAG;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Release the epoll instance and timer (watched fds are not closed)
+     */
+    void close() {
+        if (timer_fd_ >= 0) {
+            ::close(timer_fd_);
+            timer_fd_ = -1;
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+            epoll_fd_ = -1;
+        }
+        for (std::size_t i = 0; i < MAX_SOURCES; ++i) {
+            sources_[i].fd = -1;
+        }
+    }
+
+    /**
+     * @brief Start dispatching events on a file descriptor
+     *
+     * @param fd Descriptor to watch (ideally O_NONBLOCK)
+     * @param events EPOLLIN, EPOLLOUT, ... (level-triggered)
+     * @param handler Called on the reactor thread when events fire
+     * @return false Table full, fd already watched, or epoll_ctl failed
+     */
+    bool watch(int fd, uint32_t events, event_handler handler) {
+        if (find(fd) < MAX_SOURCES) {
+            return false;
+        }
+        std::size_t const slot = find(-1);
+        if (slot >= MAX_SOURCES) {
+            return false;
+        }
+        epoll_event ev;
+        ev.events = events;
+        ev.data.u32 = static_cast<uint32_t>(slot);
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            return false;
+        }
+        sources_[slot].fd = fd;
+        sources_[slot].handler = handler;
+        return true;
+    }
+
+    /**
+     * @brief Stop watching a file descriptor (safe to call from its own handler)
+     */
+    bool unwatch(int fd) {
+        std::size_t const slot = find(fd);
+        if (slot >= MAX_SOURCES) {
+            return false;
+        }
+        sources_[slot].fd = -1;
+        return ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr) == 0;
+    }
+
+    /**
+     * @brief Handler called when the tick timer expires
+     */
+    void set_tick_handler(event_handler handler) { tick_handler_ = handler; }
+
+    /**
+     * @brief Arm the one-shot tick timer (replaces any pending deadline)
+     *
+     * @param delay_ms Milliseconds from now (0 = as soon as possible)
+     */
+    bool arm_tick(uint32_t delay_ms) {
+        itimerspec spec;
+        spec.it_interval.tv_sec = 0;
+        spec.it_interval.tv_nsec = 0;
+        spec.it_value.tv_sec = delay_ms / 1000;
+        spec.it_value.tv_nsec = static_cast<long>(delay_ms % 1000) * 1000000L;
+        if (delay_ms == 0) {
+            spec.it_value.tv_nsec = 1;  // A zero value would disarm the timer
+        }
+        return ::timerfd_settime(timer_fd_, 0, &spec, nullptr) == 0;
+    }
+
+    /**
+     * @brief Cancel the pending tick, if any
+     */
+    bool disarm_tick() {
+        itimerspec spec = {};
+        return ::timerfd_settime(timer_fd_, 0, &spec, nullptr) == 0;
+    }
+
+    /**
+     * @brief Wait for and dispatch one batch of events
+     *
+     * @param timeout_ms Maximum wait (-1 = until something happens)
+     * @return int Number of handlers dispatched (0 on timeout, -1 on error)
+     */
+    int run_once(int timeout_ms) {
+        epoll_event events[MAX_EVENTS_PER_WAIT];
+        int const count = ::epoll_wait(epoll_fd_, events, MAX_EVENTS_PER_WAIT, timeout_ms);
+        if (count < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+
+        int dispatched = 0;
+        for (int i = 0; i < count; ++i) {
+            uint32_t const tag = events[i].data.u32;
+            if (tag == TIMER_TAG) {
+                uint64_t expirations;
+                if (::read(timer_fd_, &expirations, sizeof(expirations)) > 0 &&
+                    tick_handler_.callback != nullptr) {
+                    tick_handler_.callback(tick_handler_.context, events[i].events);
+                    ++dispatched;
+                }
+            } else if (tag < MAX_SOURCES && sources_[tag].fd >= 0) {
+                event_handler const handler = sources_[tag].handler;
+                handler.callback(handler.context, events[i].events);
+                ++dispatched;
+            }
+        }
+        return dispatched;
+    }
+
+    /**
+     * @brief Dispatch until stop() is called from a handler
+     */
+    void run() {
+        running_ = true;
+        while (running_) {
+            if (run_once(-1) < 0) {
+                break;
+            }
+        }
+    }
+
+    void stop() { running_ = false; }
+
+    bool is_open() const { return epoll_fd_ >= 0; }
+
+    std::size_t get_source_count() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < MAX_SOURCES; ++i) {
+            count += sources_[i].fd >= 0 ? 1 : 0;
+        }
+        return count;
+    }
+
+   private:
+    static uint32_t const TIMER_TAG = 0xffffffffu;
+
+    struct source {
+        int fd;
+        event_handler handler;
+    };
+
+    std::size_t find(int fd) const {
+        for (std::size_t i = 0; i < MAX_SOURCES; ++i) {
+            if (sources_[i].fd == fd) {
+                return i;
+            }
+        }
+        return MAX_SOURCES;
+    }
+
+    int epoll_fd_;
+    int timer_fd_;
+    bool running_;
+    event_handler tick_handler_;
+    source sources_[MAX_SOURCES];
+};
+
+/**
+ * @brief Tick handler that updates controllers and sleeps until the next edge
+ *
+ * On every tick it brings all controllers to the current time, then arms
+ * the reactor's timer for the earliest time_until_toggle() (capped at
+ * max_sleep_ms so clock-driven consumers still get a periodic update). I/O
+ * handlers that retime controllers call reschedule() so the new deadline is
+ * honored immediately.
+ *
+ * Controllers are advanced with fast_forward(), so a late wake takes every
+ * edge at its exact time instead of one edge at the wake time. That makes
+ * a show_clock timer exact at any rate: deadlines are show time, the sleep
+ * is converted to wall time at the clock's rate, and a wake that covers
+ * several edges (1000x rehearsal) loses none of them. An edge a retime made
+ * overdue since the last tick is taken with update() at the current time,
+ * as fast_forward() requires.
+ *
+ * Usage:
+ *   controller_ticker<blink_controller<pin_t>, real_time_timer>
+ *       ticker(reactor, controllers, count, timer, 1000);
+ *   ticker.start();
+ *   reactor.run();
+ *
+ * @tparam controller_t Type with update(), fast_forward() and time_until_toggle()
+ * @tparam timer_t Type with millis()
+ */
+template<typename controller_t, typename timer_t>
+struct controller_ticker {
+   public:
+    controller_ticker(event_reactor& reactor, controller_t* controllers, std::size_t count,
+                      timer_t& timer, uint32_t max_sleep_ms)
+        : reactor_(reactor),
+          controllers_(controllers),
+          count_(count),
+          timer_(timer),
+          max_sleep_ms_(max_sleep_ms),
+          last_tick_ms_(0),
+          tick_count_(0),
+          next_sleep_ms_(0) {}
+
+    /**
+     * @brief Install as the reactor's tick handler and tick immediately
+     */
+    void start() {
+        event_handler handler;
+        handler.callback = &controller_ticker::on_tick;
+        handler.context = this;
+        reactor_.set_tick_handler(handler);
+        last_tick_ms_ = timer_.millis();
+        reactor_.arm_tick(0);
+    }
+
+    /**
+     * @brief Update now and re-arm (call after retiming from an I/O handler)
+     */
+    void reschedule() { tick(); }
+
+    uint32_t get_tick_count() const { return tick_count_; }
+    uint32_t get_next_sleep_ms() const { return next_sleep_ms_; }
+
+   private:
+    static void on_tick(void* context, uint32_t) { static_cast<controller_ticker*>(context)->tick(); }
+
+    void tick() {
+        uint32_t const now = timer_.millis();
+        uint32_t until_edge_ms = UINT32_MAX;
+        for (std::size_t i = 0; i < count_; ++i) {
+            // Every controller was current at last_tick_ms_, so an edge already due
+            // then comes from a retime since; everything else is a normal edge
+            if (controllers_[i].time_until_toggle(last_tick_ms_) == 0) {
+                controllers_[i].update(now);
+            } else {
+                controllers_[i].fast_forward(now);
+            }
+            uint32_t const remaining = controllers_[i].time_until_toggle(now);
+            if (remaining < until_edge_ms) {
+                until_edge_ms = remaining;
+            }
+        }
+        uint32_t sleep_ms = wall_delay_ms(timer_, until_edge_ms);
+        if (sleep_ms > max_sleep_ms_) {
+            sleep_ms = max_sleep_ms_;
+        }
+        last_tick_ms_ = now;
+        ++tick_count_;
+        next_sleep_ms_ = sleep_ms;
+        reactor_.arm_tick(sleep_ms);
+    }
+
+    event_reactor& reactor_;
+    controller_t* controllers_;
+    std::size_t count_;
+    timer_t& timer_;
+    uint32_t max_sleep_ms_;
+    uint32_t last_tick_ms_;
+    uint32_t tick_count_;
+    uint32_t next_sleep_ms_;
+};
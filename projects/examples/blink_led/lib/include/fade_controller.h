@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Platform-agnostic linear fade between 8-bit levels
+ *
+ * The dimmable counterpart of blink_controller: set_target() starts a fade
+ * from the current level, and update() writes the interpolated level to the
+ * injected output whenever it changes. A new target mid-fade starts from
+ * wherever the fade currently is, so stepped sources (DMX, audio envelopes)
+ * come out smooth instead of jumping.
+ *
+ * @tparam output_pin_t Type that implements set_level(uint8_t) (PWM pin, level_pin)
+ *
+ * Example Usage:
+ *
+ * struct pwm_pin {
+ *     void set_level(uint8_t level) { analogWrite(LED_PIN, level); }
+ * };
+ * pwm_pin pin;
+ * fade_controller<pwm_pin> fade(pin, 200);  // 200 ms per fade
+ * fade.set_target(255, millis());
+ * fade.update(millis());
+ */
+template<typename output_pin_t>
+struct fade_controller {
+   public:
+    /// Longest fade; keeps the interpolation inside 32-bit arithmetic
+    static uint32_t const MAX_FADE_MS = 0x00FFFFFFu;
+
+    /**
+     * @brief Construct a fade controller at level 0
+     *
+     * @param output Reference to output pin interface
+     * @param fade_duration_ms Time for a complete fade to a new target (0 = jump)
+     */
+    fade_controller(output_pin_t& output, uint32_t fade_duration_ms)
+        : output_(output),
+          fade_duration_ms_(clamp_duration(fade_duration_ms)),
+          fade_start_ms_(0),
+          start_level_(0),
+          target_level_(0),
+          level_(0),
+          fading_(false) {}
+
+    /**
+     * @brief Fade from the current level to a new target
+     *
+     * Setting the target already being approached keeps the fade running.
+     *
+     * @param level Target level (0-255)
+     * @param current_time_ms Time the fade starts in milliseconds
+     */
+    void set_target(uint8_t level, uint32_t current_time_ms) {
+        if (level == target_level_) {
+            return;
+        }
+        write(level_at(current_time_ms));
+        start_level_ = level_;
+        target_level_ = level;
+        fade_start_ms_ = current_time_ms;
+        fading_ = true;
+    }
+
+    /**
+     * @brief Set the level immediately, cancelling any fade
+     */
+    void jump_to(uint8_t level) {
+        start_level_ = target_level_ = level;
+        fading_ = false;
+        write(level);
+    }
+
+    /**
+     * @brief Advance the fade and write the level if it changed
+     *
+     * @param current_time_ms Current time in milliseconds
+     */
+    void update(uint32_t current_time_ms) {
+        if (!fading_) {
+            return;
+        }
+        uint8_t const level = level_at(current_time_ms);
+        if (level == target_level_) {
+            fading_ = false;
+        }
+        write(level);
+    }
+
+    /**
+     * @brief Change the duration of subsequent fades
+     */
+    void set_fade_duration(uint32_t fade_duration_ms) {
+        fade_duration_ms_ = clamp_duration(fade_duration_ms);
+    }
+
+    // Getters for testing and state inspection
+    uint8_t get_level() const { return level_; }
+    uint8_t get_target() const { return target_level_; }
+    uint32_t get_fade_duration() const { return fade_duration_ms_; }
+    bool is_fading() const { return fading_; }
+
+   private:
+    static uint32_t clamp_duration(uint32_t duration_ms) {
+        return duration_ms > MAX_FADE_MS ? MAX_FADE_MS : duration_ms;
+    }
+
+    // Interpolated level (wraparound-safe elapsed time)
+    uint8_t level_at(uint32_t current_time_ms) const {
+        if (!fading_) {
+            return level_;
+        }
+        uint32_t const elapsed = current_time_ms - fade_start_ms_;
+        if (elapsed >= fade_duration_ms_) {
+            return target_level_;
+        }
+        if (target_level_ > start_level_) {
+            uint32_t const span = target_level_ - start_level_;
+            return static_cast<uint8_t>(start_level_ + span * elapsed / fade_duration_ms_);
+        }
+        uint32_t const span = start_level_ - target_level_;
+        return static_cast<uint8_t>(start_level_ - span * elapsed / fade_duration_ms_);
+    }
+
+    void write(uint8_t level) {
+        if (level != level_) {
+            level_ = level;
+            output_.set_level(level);
+        }
+    }
+
+    output_pin_t& output_;
+    uint32_t fade_duration_ms_;
+    uint32_t fade_start_ms_;
+    uint8_t start_level_;
+    uint8_t target_level_;
+    uint8_t level_;
+    bool fading_;
+};
+
+template<typename output_pin_t>
+uint32_t const fade_controller<output_pin_t>::MAX_FADE_MS;
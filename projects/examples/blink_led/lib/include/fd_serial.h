@@ -0,0 +1,158 @@
+#pragma once
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Arduino-style serial interface over a file descriptor
+ *
+ * Lets board-side code written against HardwareSerial (available(), read(),
+ * write()) run on the host against a pty, a tty device or a pipe. The fd is
+ * owned by the caller.
+ *
+ * Linux/POSIX only.
+ *
+ * Usage:
+ *   fd_serial serial(pty.slave_fd);
+ *   serial_command_server<controller_t, fd_serial> server(controllers, n, serial);
+ */
+struct fd_serial {
+   public:
+    explicit fd_serial(int fd) : fd_(fd) {}
+
+    /**
+     * @brief Bytes readable without blocking
+     */
+    int available() const {
+        int count = 0;
+        if (::ioctl(fd_, FIONREAD, &count) != 0) {
+            return 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Read one byte (-1 if none is available)
+     */
+    int read() {
+        uint8_t byte;
+        return ::read(fd_, &byte, 1) == 1 ? byte : -1;
+    }
+
+    /**
+     * @brief Write all bytes (retries short writes)
+     *
+     * @return std::size_t Bytes written
+     */
+    std::size_t write(uint8_t const* data, std::size_t length) {
+        std::size_t written = 0;
+        while (written < length) {
+            ssize_t const n = ::write(fd_, data + written, length - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            written += static_cast<std::size_t>(n);
+        }
+        return written;
+    }
+
+    int get_fd() const { return fd_; }
+
+   private:
+    int fd_;
+};
+
+/**
+ * @brief Put a tty in raw mode (no echo, no line editing, 8-bit clean)
+ *
+ * @return false fd is not a terminal
+ */
+inline bool set_raw_mode(int fd) {
+    termios settings;
+    if (::tcgetattr(fd, &settings) != 0) {
+        return false;
+    }
+    ::cfmakeraw(&settings);
+    return ::tcsetattr(fd, TCSANOW, &settings) == 0;
+}
+
+/**
+ * @brief Open a serial device (/dev/ttyACM0, a virtual board's /dev/pts/N) in raw mode
+ *
+ * @return int File descriptor, -1 on failure
+ */
+inline int open_serial_device(char const* path) {
+    int const fd = ::open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd >= 0 && !set_raw_mode(fd)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Pseudo-terminal pair in raw mode (a virtual serial cable)
+ *
+ * The slave side behaves like a serial device (/dev/pts/N, usable by tools
+ * that expect a tty); the master side is the other end of the cable.
+ *
+ * Usage:
+ *   pty_pair pty;
+ *   if (pty.open()) { host writes pty.master_fd, board reads pty.slave_fd }
+ */
+struct pty_pair {
+   public:
+    pty_pair() : master_fd(-1), slave_fd(-1) {}
+    ~pty_pair() { close(); }
+
+    pty_pair(pty_pair const&) = delete;
+    pty_pair& operator=(pty_pair const&) = delete;
+
+    /**
+     * @brief Create the pair; both ends raw (no echo, no line editing, 8-bit clean)
+     *
+     * @return false No pty available
+     */
+    bool open() {
+        close();
+        master_fd = ::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (master_fd < 0 || ::grantpt(master_fd) != 0 || ::unlockpt(master_fd) != 0) {
+            close();
+            return false;
+        }
+        char const* const name = ::ptsname(master_fd);
+        slave_fd = name == nullptr ? -1 : ::open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (slave_fd < 0 || !set_raw_mode(slave_fd) || !set_raw_mode(master_fd)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (slave_fd >= 0) {
+            ::close(slave_fd);
+        }
+        if (master_fd >= 0) {
+            ::close(master_fd);
+        }
+        slave_fd = master_fd = -1;
+    }
+
+    /**
+     * @brief Path of the slave side, for tools that open the device by name
+     */
+    char const* slave_path() const { return master_fd < 0 ? nullptr : ::ptsname(master_fd); }
+
+    int master_fd;
+    int slave_fd;
+};
@@ -0,0 +1,597 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "output_bank.h"
+#include "serial_protocol.h"
+
+/**
+ * @brief Delta-compressed output_bank streaming over the serial protocol
+ *
+ * Sending the whole bank every tick costs channels / 8 bytes per frame. The
+ * host instead sends each frame as the difference from the newest frame the
+ * board has acknowledged. Differences only accumulate over the
+ * acknowledgement round trip, so a frame usually carries a few changed bytes
+ * even for thousands of channels. The board keeps its last history_v applied
+ * frames, so any of them can serve as the reference. Lost frames need no
+ * retransmission: the next delta is computed against an older acknowledged
+ * frame and still yields the full state. Periodic keyframes (full state)
+ * recover from a board reset or a silently diverged reference.
+ *
+ * Frames use the serial_protocol framing (COBS + CRC-16):
+ *
+ *   keyframe     [encoding:1][bytes...]             state
+ *   delta_frame  [ref_seq:1][encoding:1][bytes...]  state XOR frame ref_seq
+ *
+ * Byte k holds channels 8k..8k+7 (LSB first). Each frame picks the smallest
+ * of three encodings:
+ *
+ *   raw     every byte
+ *   bitmap  one bit per byte (set = nonzero byte), then the nonzero bytes
+ *   rle     PackBits: c < 0x80 copies c + 1 literal bytes,
+ *           c >= 0x80 repeats the next byte c - 0x80 + 3 times
+ *
+ * Sparse changes favour bitmap, dense runs (sections switching together)
+ * favour rle, and raw bounds the worst case at channels / 8 + 2 bytes.
+ * The board acks every frame; unknown_reference asks for a keyframe.
+ */
+enum class frame_encoding : uint8_t { raw = 0, bitmap = 1, rle = 2 };
+
+namespace frame_stream_detail {
+
+// Byte k of a packed frame, optionally XORed with a reference frame
+struct byte_source {
+    uint32_t const* current;
+    uint32_t const* reference;  // nullptr for keyframes
+
+    uint8_t operator[](std::size_t index) const {
+        uint32_t word = current[index / 4];
+        if (reference != nullptr) {
+            word ^= reference[index / 4];
+        }
+        return static_cast<uint8_t>(word >> ((index % 4) * 8));
+    }
+};
+
+// Appends to a buffer, or only counts when dest is nullptr
+struct byte_writer {
+    byte_writer(uint8_t* dest, std::size_t capacity)
+        : dest(dest), capacity(capacity), length(0), overflow(false) {}
+
+    void put(uint8_t value) {
+        if (dest != nullptr) {
+            if (length >= capacity) {
+                overflow = true;
+                return;
+            }
+            dest[length] = value;
+        }
+        ++length;
+    }
+
+    uint8_t* dest;
+    std::size_t capacity;
+    std::size_t length;
+    bool overflow;
+};
+
+static std::size_t const RLE_MIN_RUN = 3;
+static std::size_t const RLE_MAX_RUN = 0x7F + RLE_MIN_RUN;
+static std::size_t const RLE_MAX_LITERAL = 0x80;
+
+inline void put_literals(byte_source const& source, std::size_t begin, std::size_t end,
+                         byte_writer& out) {
+    while (begin < end) {
+        std::size_t const count = end - begin < RLE_MAX_LITERAL ? end - begin : RLE_MAX_LITERAL;
+        out.put(static_cast<uint8_t>(count - 1));
+        for (std::size_t i = 0; i < count; ++i) {
+            out.put(source[begin + i]);
+        }
+        begin += count;
+    }
+}
+
+inline void encode_rle(byte_source const& source, std::size_t count, byte_writer& out) {
+    std::size_t literal_begin = 0;
+    std::size_t i = 0;
+    while (i < count) {
+        uint8_t const value = source[i];
+        std::size_t run = 1;
+        while (i + run < count && run < RLE_MAX_RUN && source[i + run] == value) {
+            ++run;
+        }
+        if (run >= RLE_MIN_RUN) {
+            put_literals(source, literal_begin, i, out);
+            out.put(static_cast<uint8_t>(0x80 + run - RLE_MIN_RUN));
+            out.put(value);
+            literal_begin = i + run;
+        }
+        i += run;
+    }
+    put_literals(source, literal_begin, count, out);
+}
+
+inline void encode_bitmap(byte_source const& source, std::size_t count, byte_writer& out) {
+    for (std::size_t base = 0; base < count; base += 8) {
+        uint8_t mask = 0;
+        for (std::size_t bit = 0; bit < 8 && base + bit < count; ++bit) {
+            if (source[base + bit] != 0) {
+                mask = static_cast<uint8_t>(mask | (1u << bit));
+            }
+        }
+        out.put(mask);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        uint8_t const value = source[i];
+        if (value != 0) {
+            out.put(value);
+        }
+    }
+}
+
+inline std::size_t bitmap_size(byte_source const& source, std::size_t count) {
+    std::size_t size = (count + 7) / 8;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (source[i] != 0) {
+            ++size;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Write [encoding][bytes] using the smallest encoding
+ *
+ * @return std::size_t Bytes written, 0 if dest is too small
+ */
+inline std::size_t encode_bytes(byte_source const& source, std::size_t count, uint8_t* dest,
+                                std::size_t capacity, frame_encoding& chosen) {
+    byte_writer rle_size(nullptr, 0);
+    encode_rle(source, count, rle_size);
+    std::size_t const bitmap = bitmap_size(source, count);
+
+    chosen = frame_encoding::raw;
+    std::size_t best = count;
+    if (bitmap < best) {
+        chosen = frame_encoding::bitmap;
+        best = bitmap;
+    }
+    if (rle_size.length < best) {
+        chosen = frame_encoding::rle;
+    }
+
+    byte_writer out(dest, capacity);
+    out.put(static_cast<uint8_t>(chosen));
+    if (chosen == frame_encoding::rle) {
+        encode_rle(source, count, out);
+    } else if (chosen == frame_encoding::bitmap) {
+        encode_bitmap(source, count, out);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            out.put(source[i]);
+        }
+    }
+    return out.overflow ? 0 : out.length;
+}
+
+// Validation pass: accepts every byte
+struct ignore_bytes {
+    void operator()(std::size_t, uint8_t) {}
+};
+
+// Apply pass: XOR byte k into the packed words
+struct xor_into_words {
+    uint32_t* words;
+
+    void operator()(std::size_t index, uint8_t value) {
+        words[index / 4] ^= static_cast<uint32_t>(value) << ((index % 4) * 8);
+    }
+};
+
+/**
+ * @brief Walk an encoded payload, calling visit(k, byte) for nonzero bytes
+ *
+ * @return false Payload is malformed or does not cover exactly count bytes
+ */
+template<typename visitor_t>
+bool decode_bytes(uint8_t encoding, uint8_t const* data, std::size_t length, std::size_t count,
+                  visitor_t& visit) {
+    if (encoding == static_cast<uint8_t>(frame_encoding::raw)) {
+        if (length != count) {
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            if (data[i] != 0) {
+                visit(i, data[i]);
+            }
+        }
+        return true;
+    }
+
+    if (encoding == static_cast<uint8_t>(frame_encoding::bitmap)) {
+        std::size_t const mask_bytes = (count + 7) / 8;
+        if (length < mask_bytes) {
+            return false;
+        }
+        std::size_t next = mask_bytes;
+        for (std::size_t i = 0; i < count; ++i) {
+            if ((data[i / 8] & (1u << (i % 8))) == 0) {
+                continue;
+            }
+            if (next >= length) {
+                return false;
+            }
+            visit(i, data[next++]);
+        }
+        return next == length;
+    }
+
+    if (encoding == static_cast<uint8_t>(frame_encoding::rle)) {
+        std::size_t position = 0;
+        std::size_t index = 0;
+        while (position < length) {
+            uint8_t const control = data[position++];
+            if (control < 0x80) {
+                std::size_t const literals = static_cast<std::size_t>(control) + 1;
+                if (literals > length - position || literals > count - index) {
+                    return false;
+                }
+                for (std::size_t i = 0; i < literals; ++i, ++index) {
+                    uint8_t const value = data[position++];
+                    if (value != 0) {
+                        visit(index, value);
+                    }
+                }
+            } else {
+                std::size_t const run = control - 0x80 + RLE_MIN_RUN;
+                if (position >= length || run > count - index) {
+                    return false;
+                }
+                uint8_t const value = data[position++];
+                for (std::size_t i = 0; i < run; ++i, ++index) {
+                    if (value != 0) {
+                        visit(index, value);
+                    }
+                }
+            }
+        }
+        return index == count;
+    }
+
+    return false;
+}
+
+}  // namespace frame_stream_detail
+
+/**
+ * @brief Host side: turns output_bank states into keyframes and deltas
+ *
+ * Feed every reply from the board to on_reply(); the encoder tracks the
+ * newest acknowledged frame and falls back to a keyframe when none is
+ * usable (nothing acked within the board's history, a nack, or the
+ * keyframe interval elapsed).
+ *
+ * Usage:
+ *   frame_stream_encoder<512> encoder(50);  // keyframe at least every 50 frames
+ *   std::size_t n = encoder.encode(bank, wire, sizeof(wire));
+ *   send(wire, n);
+ *   if (reply_parser.push(byte, reply)) { encoder.on_reply(reply); }
+ *
+ * @tparam channel_count_v Channels in the bank
+ * @tparam history_v Frames kept by the board (must match the decoder)
+ */
+template<std::size_t channel_count_v, std::size_t history_v = 4>
+struct frame_stream_encoder {
+   public:
+    static_assert(history_v >= 1 && history_v <= 128, "history must fit the 8-bit sequence");
+
+    static std::size_t const WORD_COUNT = output_bank<channel_count_v>::WORD_COUNT;
+    static std::size_t const BYTE_COUNT = (channel_count_v + 7) / 8;
+    static std::size_t const MAX_BODY_SIZE = serial_frame::HEADER_SIZE + 2 + BYTE_COUNT;
+    static std::size_t const MAX_WIRE_SIZE = serial_frame_builder<MAX_BODY_SIZE>::MAX_WIRE_SIZE;
+
+    /**
+     * @param keyframe_interval Frames between forced keyframes (0 = only when needed)
+     */
+    explicit frame_stream_encoder(uint32_t keyframe_interval = 50)
+        : keyframe_interval_(keyframe_interval),
+          next_frame_(0),
+          acked_frame_(0),
+          has_ack_(false),
+          force_keyframe_(true),
+          frames_since_keyframe_(0),
+          keyframes_(0),
+          deltas_(0),
+          last_encoding_(frame_encoding::raw) {}
+
+    /**
+     * @brief Encode the bank as the next frame
+     *
+     * @param bank Current output state
+     * @param wire Output buffer (MAX_WIRE_SIZE always suffices)
+     * @param capacity Size of wire
+     * @return std::size_t Bytes to send (COBS-framed), 0 if wire is too small
+     */
+    std::size_t encode(output_bank<channel_count_v> const& bank, uint8_t* wire,
+                       std::size_t capacity) {
+        uint8_t const seq = static_cast<uint8_t>(next_frame_);
+        bool const keyframe = force_keyframe_ || !reference_usable() ||
+                              (keyframe_interval_ != 0 &&
+                               frames_since_keyframe_ + 1 >= keyframe_interval_);
+
+        uint8_t payload[2 + BYTE_COUNT];
+        std::size_t header = 0;
+        frame_stream_detail::byte_source source = {bank.words(), nullptr};
+        if (!keyframe) {
+            payload[header++] = static_cast<uint8_t>(acked_frame_);
+            source.reference = history_[acked_frame_ % history_v];
+        }
+        std::size_t const encoded = frame_stream_detail::encode_bytes(
+            source, BYTE_COUNT, payload + header, sizeof(payload) - header, last_encoding_);
+
+        builder_.begin(keyframe ? serial_message::keyframe : serial_message::delta_frame, seq,
+                       0);
+        builder_.put_bytes(payload, header + encoded);
+        std::size_t const length = encoded == 0 ? 0 : builder_.finish(wire, capacity);
+        if (length == 0) {
+            return 0;
+        }
+
+        uint32_t const* const words = bank.words();
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            history_[seq % history_v][i] = words[i];
+        }
+        ++next_frame_;
+        if (keyframe) {
+            force_keyframe_ = false;
+            frames_since_keyframe_ = 0;
+            ++keyframes_;
+        } else {
+            ++frames_since_keyframe_;
+            ++deltas_;
+        }
+        return length;
+    }
+
+    /**
+     * @brief Process an ack from the board
+     */
+    void on_reply(serial_frame const& reply) {
+        if (reply.type != serial_message::ack || reply.payload_size != 1) {
+            return;
+        }
+        if (reply.payload[0] != static_cast<uint8_t>(serial_status::ok)) {
+            force_keyframe_ = true;
+            return;
+        }
+        // Only frames still in the history, and newer than the current reference
+        uint8_t const age = static_cast<uint8_t>(static_cast<uint8_t>(next_frame_) - reply.seq);
+        if (age == 0 || age > history_v) {
+            return;
+        }
+        uint32_t const frame = next_frame_ - age;
+        if (has_ack_ && frame - acked_frame_ >= 0x80000000u) {
+            return;
+        }
+        acked_frame_ = frame;
+        has_ack_ = true;
+    }
+
+    /**
+     * @brief Send a keyframe next (e.g. after reconnecting)
+     */
+    void request_keyframe() { force_keyframe_ = true; }
+
+    uint32_t get_keyframes() const { return keyframes_; }
+    uint32_t get_deltas() const { return deltas_; }
+    frame_encoding get_last_encoding() const { return last_encoding_; }
+
+   private:
+    // The board overwrites slot seq % history_v when it applies seq. Frame
+    // numbers are counted full width so a long run without acks cannot wrap
+    // the 8-bit seq back into range.
+    bool reference_usable() const {
+        return has_ack_ && next_frame_ - acked_frame_ < history_v;
+    }
+
+    uint32_t keyframe_interval_;
+    uint32_t next_frame_;   // Frames encoded; the wire seq is the low 8 bits
+    uint32_t acked_frame_;  // Newest acked frame still in the history
+    bool has_ack_;
+    bool force_keyframe_;
+    uint32_t frames_since_keyframe_;
+    uint32_t keyframes_;
+    uint32_t deltas_;
+    frame_encoding last_encoding_;
+    uint32_t history_[history_v][WORD_COUNT];
+    serial_frame_builder<MAX_BODY_SIZE> builder_;
+};
+
+template<std::size_t channel_count_v, std::size_t history_v>
+std::size_t const frame_stream_encoder<channel_count_v, history_v>::WORD_COUNT;
+
+template<std::size_t channel_count_v, std::size_t history_v>
+std::size_t const frame_stream_encoder<channel_count_v, history_v>::BYTE_COUNT;
+
+template<std::size_t channel_count_v, std::size_t history_v>
+std::size_t const frame_stream_encoder<channel_count_v, history_v>::MAX_BODY_SIZE;
+
+template<std::size_t channel_count_v, std::size_t history_v>
+std::size_t const frame_stream_encoder<channel_count_v, history_v>::MAX_WIRE_SIZE;
+
+/**
+ * @brief Board side: applies keyframes and deltas straight into an output_bank
+ *
+ * The payload is validated first, then decoded directly into the bank's
+ * words (no staging frame). A rejected frame leaves the bank untouched.
+ * RAM: history_v copies of the bank; use history_v = 2 on small boards.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * @tparam channel_count_v Channels in the bank
+ * @tparam history_v Applied frames kept as delta references
+ */
+template<std::size_t channel_count_v, std::size_t history_v = 4>
+struct frame_stream_decoder {
+   public:
+    static_assert(history_v >= 1 && history_v <= 128, "history must fit the 8-bit sequence");
+
+    static std::size_t const WORD_COUNT = output_bank<channel_count_v>::WORD_COUNT;
+    static std::size_t const BYTE_COUNT = (channel_count_v + 7) / 8;
+
+    frame_stream_decoder() : applied_(0), rejected_(0) {
+        for (std::size_t i = 0; i < history_v; ++i) {
+            valid_[i] = false;
+            seqs_[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Apply one keyframe or delta_frame
+     *
+     * @return serial_status ok, unknown_reference (send a keyframe), bad_length,
+     *         bad_channel (channel must be 0) or unknown_command
+     */
+    serial_status apply(serial_frame const& frame, output_bank<channel_count_v>& bank) {
+        if (frame.type != serial_message::keyframe && frame.type != serial_message::delta_frame) {
+            return serial_status::unknown_command;
+        }
+        if (frame.channel != 0) {
+            return reject(serial_status::bad_channel);
+        }
+
+        std::size_t offset = 0;
+        uint32_t const* base = nullptr;
+        if (frame.type == serial_message::delta_frame) {
+            if (frame.payload_size < 1) {
+                return reject(serial_status::bad_length);
+            }
+            uint8_t const reference = frame.payload[0];
+            std::size_t const slot = reference % history_v;
+            if (!valid_[slot] || seqs_[slot] != reference) {
+                return reject(serial_status::unknown_reference);
+            }
+            base = history_[slot];
+            offset = 1;
+        }
+        if (frame.payload_size < offset + 1) {
+            return reject(serial_status::bad_length);
+        }
+
+        uint8_t const encoding = frame.payload[offset];
+        uint8_t const* const data = frame.payload + offset + 1;
+        std::size_t const length = frame.payload_size - offset - 1;
+        frame_stream_detail::ignore_bytes check;
+        if (!frame_stream_detail::decode_bytes(encoding, data, length, BYTE_COUNT, check)) {
+            return reject(serial_status::bad_length);
+        }
+
+        uint32_t* const words = bank.words();
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            words[i] = base != nullptr ? base[i] : 0;
+        }
+        frame_stream_detail::xor_into_words apply_bytes = {words};
+        frame_stream_detail::decode_bytes(encoding, data, length, BYTE_COUNT, apply_bytes);
+        if (channel_count_v % 32 != 0) {
+            words[WORD_COUNT - 1] &= (uint32_t(1) << (channel_count_v % 32)) - 1;
+        }
+
+        std::size_t const slot = frame.seq % history_v;
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            history_[slot][i] = words[i];
+        }
+        seqs_[slot] = frame.seq;
+        valid_[slot] = true;
+        ++applied_;
+        return serial_status::ok;
+    }
+
+    uint32_t get_applied() const { return applied_; }
+    uint32_t get_rejected() const { return rejected_; }
+
+   private:
+    serial_status reject(serial_status status) {
+        ++rejected_;
+        return status;
+    }
+
+    uint32_t history_[history_v][WORD_COUNT];
+    uint8_t seqs_[history_v];
+    bool valid_[history_v];
+    uint32_t applied_;
+    uint32_t rejected_;
+};
+
+template<std::size_t channel_count_v, std::size_t history_v>
+std::size_t const frame_stream_decoder<channel_count_v, history_v>::WORD_COUNT;
+
+template<std::size_t channel_count_v, std::size_t history_v>
+std::size_t const frame_stream_decoder<channel_count_v, history_v>::BYTE_COUNT;
+
+/**
+ * @brief Board-side endpoint: parses frames from a serial port into a bank
+ *
+ * Acks every frame with the decoder's status so the host can advance its
+ * delta reference (or send a keyframe).
+ *
+ * Usage (Arduino loop):
+ *   output_bank<256> bank;
+ *   frame_stream_receiver<256, HardwareSerial, 2> receiver(bank, Serial);
+ *   void loop() { receiver.poll(); shift_out(bank.words()); }
+ *
+ * @tparam channel_count_v Channels in the bank
+ * @tparam serial_t Type with int available(), int read(), write(uint8_t const*, size_t)
+ * @tparam history_v Applied frames kept as delta references
+ */
+template<std::size_t channel_count_v, typename serial_t, std::size_t history_v = 4>
+struct frame_stream_receiver {
+   public:
+    static std::size_t const PARSER_CAPACITY =
+        frame_stream_encoder<channel_count_v, history_v>::MAX_BODY_SIZE + serial_frame::CRC_SIZE;
+
+    frame_stream_receiver(output_bank<channel_count_v>& bank, serial_t& serial)
+        : bank_(bank), serial_(serial) {}
+
+    /**
+     * @brief Drain buffered input and apply complete frames
+     */
+    void poll() {
+        while (serial_.available() > 0) {
+            int const byte = serial_.read();
+            if (byte < 0) {
+                break;
+            }
+            feed(static_cast<uint8_t>(byte));
+        }
+    }
+
+    void feed(uint8_t byte) {
+        serial_frame frame;
+        if (!parser_.push(byte, frame)) {
+            return;
+        }
+        serial_status const status = decoder_.apply(frame, bank_);
+        serial_frame_builder<serial_frame::HEADER_SIZE + 1> reply;
+        reply.begin(serial_message::ack, frame.seq, frame.channel);
+        reply.put_u8(static_cast<uint8_t>(status));
+        uint8_t wire[serial_frame_builder<serial_frame::HEADER_SIZE + 1>::MAX_WIRE_SIZE];
+        std::size_t const length = reply.finish(wire, sizeof(wire));
+        if (length > 0) {
+            serial_.write(wire, length);
+        }
+    }
+
+    frame_stream_decoder<channel_count_v, history_v> const& get_decoder() const {
+        return decoder_;
+    }
+    serial_parser<PARSER_CAPACITY> const& get_parser() const { return parser_; }
+
+   private:
+    output_bank<channel_count_v>& bank_;
+    serial_t& serial_;
+    serial_parser<PARSER_CAPACITY> parser_;
+    frame_stream_decoder<channel_count_v, history_v> decoder_;
+};
+
+template<std::size_t channel_count_v, typename serial_t, std::size_t history_v>
+std::size_t const frame_stream_receiver<channel_count_v, serial_t, history_v>::PARSER_CAPACITY;
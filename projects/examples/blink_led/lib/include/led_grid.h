@@ -0,0 +1,194 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "led_layout.h"
+
+/**
+ * @brief Uniform grid over a layout's LED positions for region queries
+ *
+ * Localized effects (a flash near the sensor that fired) should touch the
+ * LEDs near it, not every LED in the house. The grid buckets LEDs into
+ * cubic cells; a query visits only the cells overlapping the region and
+ * tests the LEDs in them.
+ *
+ * Storage is flat (CSR): LEDs are sorted by cell with a counting sort, and
+ * each cell is a [begin, end) range into one array. Cells are numbered x
+ * fastest, so a run of cells along x is one contiguous range and a query
+ * walks (rows x layers) ranges rather than individual cells. Positions are
+ * copied in cell order next to the LED numbers, so the distance tests read
+ * memory sequentially.
+ *
+ * Built once from a led_layout (host side, std::vector); queries allocate
+ * nothing.
+ *
+ * Usage:
+ *   led_grid grid(layout, 0.5f);  // 50 cm cells
+ *   grid.for_each_in_radius(sensor, 1.5f, [&](uint32_t led, float distance_squared) {
+ *       levels[led] = flash_level(distance_squared);
+ *   });
+ */
+struct led_grid {
+   public:
+    /// Cells per LED at most; larger cells are used past this
+    static std::size_t const MAX_CELLS_PER_LED = 4;
+
+    /**
+     * @param layout LED positions (copied; the layout may change afterwards)
+     * @param cell_size Cell edge in meters; about the typical query radius works well
+     */
+    led_grid(led_layout const& layout, float cell_size) { build(layout, cell_size); }
+
+    void build(led_layout const& layout, float cell_size) {
+        std::size_t const count = layout.size();
+        float low[3] = {0, 0, 0};
+        float high[3] = {0, 0, 0};
+        float const* const axes[3] = {layout.x(), layout.y(), layout.z()};
+        for (std::size_t a = 0; a < 3; ++a) {
+            for (std::size_t i = 0; i < count; ++i) {
+                float const v = axes[a][i];
+                low[a] = i == 0 || v < low[a] ? v : low[a];
+                high[a] = i == 0 || v > high[a] ? v : high[a];
+            }
+        }
+        // Grow the cells until the grid is at most MAX_CELLS_PER_LED per LED
+        cell_ = cell_size > 0 ? cell_size : 1.0f;
+        std::size_t const cell_limit = (count == 0 ? 1 : count) * MAX_CELLS_PER_LED;
+        while (true) {
+            std::size_t cells = 1;
+            for (std::size_t a = 0; a < 3; ++a) {
+                cells_[a] = static_cast<std::size_t>((high[a] - low[a]) / cell_) + 1;
+                cells *= cells_[a];
+            }
+            if (cells <= cell_limit) {
+                break;
+            }
+            cell_ *= 1.25f;
+        }
+        inverse_cell_ = 1.0f / cell_;
+        for (std::size_t a = 0; a < 3; ++a) {
+            origin_[a] = low[a];
+        }
+
+        // Counting sort by cell
+        std::size_t const total = cells_[0] * cells_[1] * cells_[2];
+        start_.assign(total + 1, 0);
+        std::vector<uint32_t> cell_of(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t c[3];
+            for (std::size_t a = 0; a < 3; ++a) {
+                c[a] = cell_coordinate(a, axes[a][i]);
+            }
+            cell_of[i] = static_cast<uint32_t>((c[2] * cells_[1] + c[1]) * cells_[0] + c[0]);
+            ++start_[cell_of[i] + 1];
+        }
+        for (std::size_t c = 0; c < total; ++c) {
+            start_[c + 1] += start_[c];
+        }
+        std::vector<uint32_t> fill(start_.begin(), start_.end() - 1);
+        leds_.resize(count);
+        x_.resize(count);
+        y_.resize(count);
+        z_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            uint32_t const slot = fill[cell_of[i]]++;
+            leds_[slot] = static_cast<uint32_t>(i);
+            x_[slot] = axes[0][i];
+            y_[slot] = axes[1][i];
+            z_[slot] = axes[2][i];
+        }
+    }
+
+    /**
+     * @brief Call fn(led, distance_squared) for every LED within radius of center
+     *
+     * LEDs come in cell order, not LED order.
+     */
+    template<typename fn_t>
+    void for_each_in_radius(led_position const& center, float radius, fn_t fn) const {
+        float const r2 = radius * radius;
+        led_position const low = {center.x - radius, center.y - radius, center.z - radius};
+        led_position const high = {center.x + radius, center.y + radius, center.z + radius};
+        visit(low, high, [&](std::size_t slot) {
+            float const dx = x_[slot] - center.x;
+            float const dy = y_[slot] - center.y;
+            float const dz = z_[slot] - center.z;
+            float const d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 <= r2) {
+                fn(leds_[slot], d2);
+            }
+        });
+    }
+
+    /**
+     * @brief Call fn(led) for every LED inside the box (bounds inclusive)
+     */
+    template<typename fn_t>
+    void for_each_in_box(led_position const& low, led_position const& high, fn_t fn) const {
+        visit(low, high, [&](std::size_t slot) {
+            if (x_[slot] >= low.x && x_[slot] <= high.x && y_[slot] >= low.y &&
+                y_[slot] <= high.y && z_[slot] >= low.z && z_[slot] <= high.z) {
+                fn(leds_[slot]);
+            }
+        });
+    }
+
+    /**
+     * @brief LEDs within radius of center, appended to out (LED numbers)
+     */
+    void query_radius(led_position const& center, float radius,
+                      std::vector<uint32_t>& out) const {
+        for_each_in_radius(center, radius, [&](uint32_t led, float) { out.push_back(led); });
+    }
+
+    float get_cell_size() const { return cell_; }
+    std::size_t get_cell_count() const { return start_.size() - 1; }
+    std::size_t size() const { return leds_.size(); }
+
+   private:
+    std::size_t cell_coordinate(std::size_t axis, float value) const {
+        float const c = (value - origin_[axis]) * inverse_cell_;
+        if (!(c > 0)) {
+            return 0;  // Below the grid (or NaN)
+        }
+        std::size_t const cell = static_cast<std::size_t>(c);
+        return cell < cells_[axis] ? cell : cells_[axis] - 1;
+    }
+
+    // Visit every slot in the cells overlapping [low, high], one x run at a time
+    template<typename fn_t>
+    void visit(led_position const& low, led_position const& high, fn_t fn) const {
+        float const lows[3] = {low.x, low.y, low.z};
+        float const highs[3] = {high.x, high.y, high.z};
+        std::size_t from[3];
+        std::size_t to[3];
+        for (std::size_t a = 0; a < 3; ++a) {
+            float const top = origin_[a] + cells_[a] * cell_;
+            if (!(highs[a] >= origin_[a]) || !(lows[a] <= top) || leds_.empty()) {
+                return;  // Entirely outside the grid
+            }
+            from[a] = cell_coordinate(a, lows[a]);
+            to[a] = cell_coordinate(a, highs[a]);
+        }
+        for (std::size_t z = from[2]; z <= to[2]; ++z) {
+            for (std::size_t y = from[1]; y <= to[1]; ++y) {
+                std::size_t const row = (z * cells_[1] + y) * cells_[0];
+                uint32_t const end = start_[row + to[0] + 1];
+                for (uint32_t slot = start_[row + from[0]]; slot < end; ++slot) {
+                    fn(slot);
+                }
+            }
+        }
+    }
+
+    float cell_;
+    float inverse_cell_;
+    float origin_[3];
+    std::size_t cells_[3];
+    std::vector<uint32_t> start_;  // Cell c holds slots [start_[c], start_[c + 1])
+    std::vector<uint32_t> leds_;   // LED number per slot
+    std::vector<float> x_;         // Positions per slot
+    std::vector<float> y_;
+    std::vector<float> z_;
+};
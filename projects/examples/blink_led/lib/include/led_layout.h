@@ -0,0 +1,306 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pixel_shader.h"
+
+/**
+ * @brief LED position in meters
+ */
+struct led_position {
+    float x;
+    float y;
+    float z;
+};
+
+/**
+ * @brief Where and why a layout failed to load
+ */
+struct led_layout_error {
+    uint32_t line;        // 1-based
+    char const* message;  // String literal
+};
+
+/**
+ * @brief Per-LED geometry for one effect: Q16.16 values in LED order
+ *
+ * A dense array effects read front to back (and pixel_shader reads as its
+ * x or y input). min and max bound the values for normalizing.
+ */
+struct geometry_table {
+    std::vector<int32_t> values;
+    int32_t min;
+    int32_t max;
+
+    int32_t const* data() const { return values.data(); }
+    std::size_t size() const { return values.size(); }
+
+    /**
+     * @brief Rescale in place so min..max becomes 0..1
+     */
+    void normalize() {
+        int64_t const range = static_cast<int64_t>(max) - min;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = range == 0 ? 0
+                                   : static_cast<int32_t>(
+                                         (static_cast<int64_t>(values[i]) - min) * SHADER_ONE /
+                                         range);
+        }
+        min = 0;
+        max = range == 0 ? 0 : SHADER_ONE;
+    }
+};
+
+namespace led_layout_detail {
+
+inline int32_t to_q16(double value) {
+    double const scaled = value * SHADER_ONE;
+    return static_cast<int32_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+// "-1.25" style decimal; false if malformed
+inline bool parse_number(char const*& p, char const* end, float& value) {
+    bool const negative = p != end && *p == '-';
+    if (negative || (p != end && *p == '+')) {
+        ++p;
+    }
+    double whole = 0;
+    double scale = 1;
+    bool digits = false;
+    bool point = false;
+    for (; p != end; ++p) {
+        if (*p >= '0' && *p <= '9') {
+            whole = whole * 10 + (*p - '0');
+            if (point) {
+                scale *= 10;
+            }
+            digits = true;
+        } else if (*p == '.' && !point) {
+            point = true;
+        } else {
+            break;
+        }
+    }
+    value = static_cast<float>((negative ? -whole : whole) / scale);
+    return digits;
+}
+
+inline bool is_separator(char c) { return c == ' ' || c == '\t' || c == '\r' || c == ','; }
+
+}  // namespace led_layout_detail
+
+/**
+ * @brief Physical LED positions, stored one coordinate array per axis
+ *
+ * Controllers only know channel numbers; sweeps and waves across a room
+ * need to know where each LED is. The layout keeps positions in SoA form
+ * and turns them into geometry tables once, when the effect is set up:
+ * distance from a point, angle around an axis, projection onto a
+ * direction. Per frame, an effect then reads one dense Q16.16 array
+ * instead of doing 3D math per LED (see layout_wave()).
+ *
+ * Host side (std::vector, float math at setup); tables can be baked and
+ * shipped to a board as plain arrays.
+ *
+ * Usage:
+ *   led_layout layout;
+ *   layout.load(text, length, error);       // "x y z" per LED, meters
+ *   geometry_table const along = layout.projections({1, 0, 0}, {0, 0, 0});
+ *   geometry_table const radius = layout.distances({2.5f, 0, 1});
+ *   layout_wave(along, SHADER_ONE, t_q16, levels);  // 1 cycle per meter
+ */
+struct led_layout {
+   public:
+    /**
+     * @brief Append one LED; LEDs are numbered in the order they are added
+     */
+    void add(led_position const& position) {
+        x_.push_back(position.x);
+        y_.push_back(position.y);
+        z_.push_back(position.z);
+    }
+
+    void clear() {
+        x_.clear();
+        y_.clear();
+        z_.clear();
+    }
+
+    /**
+     * @brief Load "x y z" lines (meters; z may be omitted for flat layouts)
+     *
+     * Numbers are separated by spaces, tabs or commas, so CSV exports load
+     * as they are; # starts a comment and blank lines are skipped. On error
+     * the layout is left empty.
+     */
+    bool load(char const* text, std::size_t length, led_layout_error& error) {
+        using namespace led_layout_detail;
+        clear();
+        error.line = 0;
+        error.message = nullptr;
+        char const* const end = text + length;
+        char const* p = text;
+        for (uint32_t line = 1; p < end; ++line) {
+            float values[3] = {0, 0, 0};
+            std::size_t count = 0;
+            while (p != end && *p != '\n' && *p != '#') {
+                if (is_separator(*p)) {
+                    ++p;
+                    continue;
+                }
+                if (count == 3 || !parse_number(p, end, values[count])) {
+                    error.line = line;
+                    error.message = count == 3 ? "more than 3 coordinates" : "bad number";
+                    clear();
+                    return false;
+                }
+                ++count;
+            }
+            while (p != end && *p != '\n') {
+                ++p;
+            }
+            if (p != end) {
+                ++p;
+            }
+            if (count == 1) {
+                error.line = line;
+                error.message = "expected: x y [z]";
+                clear();
+                return false;
+            }
+            if (count != 0) {
+                led_position const position = {values[0], values[1], values[2]};
+                add(position);
+            }
+        }
+        return true;
+    }
+
+    std::size_t size() const { return x_.size(); }
+    float const* x() const { return x_.data(); }
+    float const* y() const { return y_.data(); }
+    float const* z() const { return z_.data(); }
+
+    led_position get(std::size_t index) const {
+        led_position const position = {x_[index], y_[index], z_[index]};
+        return position;
+    }
+
+    /**
+     * @brief Distance of every LED from a point, in meters
+     */
+    geometry_table distances(led_position const& origin) const {
+        geometry_table table = begin_table();
+        for (std::size_t i = 0; i < size(); ++i) {
+            double const dx = x_[i] - origin.x;
+            double const dy = y_[i] - origin.y;
+            double const dz = z_[i] - origin.z;
+            finish(table, i, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+        return table;
+    }
+
+    /**
+     * @brief Signed distance of every LED along a direction, from a point
+     *
+     * @param direction Need not be unit length
+     */
+    geometry_table projections(led_position const& direction, led_position const& origin) const {
+        double const length = std::sqrt(static_cast<double>(direction.x) * direction.x +
+                                        static_cast<double>(direction.y) * direction.y +
+                                        static_cast<double>(direction.z) * direction.z);
+        double const ux = length > 0 ? direction.x / length : 0;
+        double const uy = length > 0 ? direction.y / length : 0;
+        double const uz = length > 0 ? direction.z / length : 0;
+        geometry_table table = begin_table();
+        for (std::size_t i = 0; i < size(); ++i) {
+            finish(table, i,
+                   (x_[i] - origin.x) * ux + (y_[i] - origin.y) * uy + (z_[i] - origin.z) * uz);
+        }
+        return table;
+    }
+
+    /**
+     * @brief Angle of every LED around an axis through center, in turns (0 to 1)
+     *
+     * Turns rather than radians so wave() and tri() go round once per
+     * revolution. Zero is an arbitrary fixed direction perpendicular to the
+     * axis (+x for the z axis); angles grow counterclockwise looking down
+     * the axis.
+     */
+    geometry_table angles(led_position const& center, led_position const& axis) const {
+        // Orthonormal basis (e1, e2) of the plane perpendicular to the axis
+        double const length = std::sqrt(static_cast<double>(axis.x) * axis.x +
+                                        static_cast<double>(axis.y) * axis.y +
+                                        static_cast<double>(axis.z) * axis.z);
+        double const n[3] = {length > 0 ? axis.x / length : 0, length > 0 ? axis.y / length : 0,
+                             length > 0 ? axis.z / length : 1};
+        double const helper[3] = {std::fabs(n[0]) < 0.9 ? 1.0 : 0.0,
+                                  std::fabs(n[0]) < 0.9 ? 0.0 : 1.0, 0.0};
+        double const along = helper[0] * n[0] + helper[1] * n[1];
+        double e1[3] = {helper[0] - along * n[0], helper[1] - along * n[1], -along * n[2]};
+        double const e1_length = std::sqrt(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+        for (std::size_t k = 0; k < 3; ++k) {
+            e1[k] /= e1_length;
+        }
+        double const e2[3] = {n[1] * e1[2] - n[2] * e1[1], n[2] * e1[0] - n[0] * e1[2],
+                              n[0] * e1[1] - n[1] * e1[0]};
+        geometry_table table = begin_table();
+        for (std::size_t i = 0; i < size(); ++i) {
+            double const d[3] = {x_[i] - center.x, y_[i] - center.y, z_[i] - center.z};
+            double const a = d[0] * e1[0] + d[1] * e1[1] + d[2] * e1[2];
+            double const b = d[0] * e2[0] + d[1] * e2[1] + d[2] * e2[2];
+            double turns = std::atan2(b, a) / 6.283185307179586;
+            if (turns < 0) {
+                turns += 1;
+            }
+            finish(table, i, turns >= 1 ? 0 : turns);
+        }
+        return table;
+    }
+
+   private:
+    geometry_table begin_table() const {
+        geometry_table table;
+        table.values.resize(size());
+        table.min = size() == 0 ? 0 : INT32_MAX;
+        table.max = size() == 0 ? 0 : INT32_MIN;
+        return table;
+    }
+
+    static void finish(geometry_table& table, std::size_t index, double value) {
+        int32_t const q16 = led_layout_detail::to_q16(value);
+        table.values[index] = q16;
+        table.min = q16 < table.min ? q16 : table.min;
+        table.max = q16 > table.max ? q16 : table.max;
+    }
+
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> z_;
+};
+
+/**
+ * @brief Moving wave over a geometry table: one 0-255 level per LED
+ *
+ * level = wave(value * cycles - phase): a sine band that travels along the
+ * table (away from the point for distances, along the direction for
+ * projections, around the axis for angles) as phase grows. One multiply,
+ * one subtract and a table lookup per LED; the same value pixel_shader
+ * gives for "r = wave(x * cycles - phase)".
+ *
+ * @param cycles Q16.16 waves per unit of the table (per meter, per turn)
+ * @param phase Q16.16 offset in waves (t * speed)
+ */
+inline void layout_wave(geometry_table const& table, int32_t cycles, int32_t phase,
+                        uint8_t* levels) {
+    int32_t const* const values = table.data();
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        uint32_t const position = static_cast<uint32_t>(shader_detail::mul(values[i], cycles)) -
+                                  static_cast<uint32_t>(phase);
+        levels[i] =
+            shader_level(shader_apply(shader_op::wave, static_cast<int32_t>(position), 0));
+    }
+}
@@ -0,0 +1,447 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#define NOISE8_TABLE_STORAGE PROGMEM
+#define NOISE8_TABLE_READ(entry) pgm_read_byte(&(entry))
+#else
+#define NOISE8_TABLE_STORAGE
+#define NOISE8_TABLE_READ(entry) (entry)
+#endif
+
+/**
+ * @brief Fixed-point value noise for flicker and fire
+ *
+ * Coherent noise: random values on an integer lattice, blended with a
+ * smoothstep between neighbours, so samples close together are close in
+ * value and the result changes smoothly as a coordinate moves (a candle
+ * walks its noise along time; fire walks 2D/3D noise over LED positions).
+ *
+ * Two variants share the scheme:
+ *   - noise_1d/2d/3d: Q16.16 coordinates (the pixel_shader and
+ *     geometry_table format, one lattice cell per unit) and 16-bit output,
+ *     with SIMD batch versions that fill whole LED arrays eight samples per
+ *     step (SSE2 or NEON, scalar otherwise; identical results on all).
+ *     Keys, hash and weights are all 16-bit, which SSE2 and NEON multiply
+ *     natively; the lattice repeats every 65536 cells along each axis
+ *   - noise8_1d/2d/3d: 8.8 coordinates and 8-bit output for AVR, a
+ *     256-byte permutation table in PROGMEM and only 8x8 multiplies
+ *
+ * Usage:
+ *   uint16_t const n = noise_1d(now_ms * 655, seed);     // ~10 cells per second
+ *   noise_3d_batch(along.data(), up.data(), t_q16, count, seed, heat);
+ *   uint8_t const candle = noise8_1d(static_cast<uint16_t>(now_ms * 3));
+ */
+namespace noise_detail {
+
+// Lattice key steps per cell (odd, so every axis has a 65536-cell period)
+static uint16_t const STEP_X = 0x9E37;
+static uint16_t const STEP_Y = 0x85EB;
+static uint16_t const STEP_Z = 0xC2B3;
+static uint16_t const HASH_1 = 0x88B5;
+static uint16_t const HASH_2 = 0xDB2D;
+
+inline uint16_t mul_low(uint16_t a, uint16_t b) {
+    return static_cast<uint16_t>(static_cast<uint32_t>(a) * b);
+}
+
+inline uint16_t mul_high(uint16_t a, uint16_t b) {
+    return static_cast<uint16_t>((static_cast<uint32_t>(a) * b) >> 16);
+}
+
+// 16-bit lattice value for a cell key (xorshift-multiply mixer)
+inline uint16_t lattice(uint16_t key) {
+    key = static_cast<uint16_t>(key ^ (key >> 8));
+    key = mul_low(key, HASH_1);
+    key = static_cast<uint16_t>(key ^ (key >> 7));
+    key = mul_low(key, HASH_2);
+    return static_cast<uint16_t>(key ^ (key >> 9));
+}
+
+// Smoothstep 3f^2 - 2f^3 of a 16-bit fraction, as ff + 2 ff (1 - f)
+inline uint16_t smooth(uint16_t fraction) {
+    uint16_t const ff = mul_high(fraction, fraction);
+    return static_cast<uint16_t>(ff + 2 * mul_high(ff, static_cast<uint16_t>(0xFFFF - fraction)));
+}
+
+inline uint16_t blend(uint16_t a, uint16_t b, uint16_t weight) {
+    return static_cast<uint16_t>(mul_high(a, static_cast<uint16_t>(0xFFFF - weight)) +
+                                 mul_high(b, weight));
+}
+
+inline uint16_t cell(int32_t coordinate) { return static_cast<uint16_t>(coordinate >> 16); }
+inline uint16_t fraction(int32_t coordinate) { return static_cast<uint16_t>(coordinate); }
+inline uint16_t fold(uint32_t seed) { return static_cast<uint16_t>(seed ^ (seed >> 16)); }
+
+inline uint16_t key_2d(uint16_t key, uint16_t sx, uint16_t sy) {
+    uint16_t const up = static_cast<uint16_t>(key + STEP_Y);
+    return blend(blend(lattice(key), lattice(static_cast<uint16_t>(key + STEP_X)), sx),
+                 blend(lattice(up), lattice(static_cast<uint16_t>(up + STEP_X)), sx), sy);
+}
+
+}  // namespace noise_detail
+
+/**
+ * @brief 1D noise at x (Q16.16), 0-65535
+ */
+inline uint16_t noise_1d(int32_t x, uint32_t seed) {
+    using namespace noise_detail;
+    uint16_t const key = static_cast<uint16_t>(fold(seed) + mul_low(cell(x), STEP_X));
+    return blend(lattice(key), lattice(static_cast<uint16_t>(key + STEP_X)),
+                 smooth(fraction(x)));
+}
+
+/**
+ * @brief 2D noise at (x, y) (Q16.16), 0-65535
+ */
+inline uint16_t noise_2d(int32_t x, int32_t y, uint32_t seed) {
+    using namespace noise_detail;
+    uint16_t const key = static_cast<uint16_t>(fold(seed) + mul_low(cell(x), STEP_X) +
+                                               mul_low(cell(y), STEP_Y));
+    return key_2d(key, smooth(fraction(x)), smooth(fraction(y)));
+}
+
+/**
+ * @brief 3D noise at (x, y, z) (Q16.16), 0-65535
+ */
+inline uint16_t noise_3d(int32_t x, int32_t y, int32_t z, uint32_t seed) {
+    using namespace noise_detail;
+    uint16_t const key = static_cast<uint16_t>(fold(seed) + mul_low(cell(x), STEP_X) +
+                                               mul_low(cell(y), STEP_Y) +
+                                               mul_low(cell(z), STEP_Z));
+    uint16_t const sx = smooth(fraction(x));
+    uint16_t const sy = smooth(fraction(y));
+    return blend(key_2d(key, sx, sy), key_2d(static_cast<uint16_t>(key + STEP_Z), sx, sy),
+                 smooth(fraction(z)));
+}
+
+namespace noise_detail {
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define NOISE_FIELD_SIMD 1
+
+// Eight 16-bit lanes: SSE2 and NEON both multiply 16-bit lanes natively
+#if defined(__SSE2__)
+typedef __m128i lanes;
+
+inline lanes splat(uint16_t value) { return _mm_set1_epi16(static_cast<int16_t>(value)); }
+inline lanes add(lanes a, lanes b) { return _mm_add_epi16(a, b); }
+inline lanes sub(lanes a, lanes b) { return _mm_sub_epi16(a, b); }
+inline lanes bit_xor(lanes a, lanes b) { return _mm_xor_si128(a, b); }
+inline lanes mul_low(lanes a, lanes b) { return _mm_mullo_epi16(a, b); }
+inline lanes mul_high(lanes a, lanes b) { return _mm_mulhi_epu16(a, b); }
+template<int shift_v>
+inline lanes shift_right(lanes a) {
+    return _mm_srli_epi16(a, shift_v);
+}
+
+// Cells and fractions of eight Q16.16 coordinates (high and low halves)
+inline void split(int32_t const* p, lanes& cells, lanes& fractions) {
+    __m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    __m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + 4));
+    // Both halves are sign-extended into int16 range first, so the pack never saturates
+    cells = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+    fractions = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+}
+
+inline void store(uint16_t* out, lanes value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), value);
+}
+#else
+typedef uint16x8_t lanes;
+
+inline lanes splat(uint16_t value) { return vdupq_n_u16(value); }
+inline lanes add(lanes a, lanes b) { return vaddq_u16(a, b); }
+inline lanes sub(lanes a, lanes b) { return vsubq_u16(a, b); }
+inline lanes bit_xor(lanes a, lanes b) { return veorq_u16(a, b); }
+inline lanes mul_low(lanes a, lanes b) { return vmulq_u16(a, b); }
+inline lanes mul_high(lanes a, lanes b) {
+    return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16),
+                        vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16));
+}
+template<int shift_v>
+inline lanes shift_right(lanes a) {
+    return vshrq_n_u16(a, shift_v);
+}
+
+inline void split(int32_t const* p, lanes& cells, lanes& fractions) {
+    int32x4_t const a = vld1q_s32(p);
+    int32x4_t const b = vld1q_s32(p + 4);
+    cells = vreinterpretq_u16_s16(vcombine_s16(vshrn_n_s32(a, 16), vshrn_n_s32(b, 16)));
+    fractions = vreinterpretq_u16_s16(vcombine_s16(vmovn_s32(a), vmovn_s32(b)));
+}
+
+inline void store(uint16_t* out, lanes value) { vst1q_u16(out, value); }
+#endif
+
+inline lanes lattice(lanes key) {
+    key = bit_xor(key, shift_right<8>(key));
+    key = mul_low(key, splat(HASH_1));
+    key = bit_xor(key, shift_right<7>(key));
+    key = mul_low(key, splat(HASH_2));
+    return bit_xor(key, shift_right<9>(key));
+}
+
+inline lanes smooth(lanes fraction) {
+    lanes const ff = mul_high(fraction, fraction);
+    lanes const tail = mul_high(ff, sub(splat(0xFFFF), fraction));
+    return add(ff, add(tail, tail));
+}
+
+inline lanes blend(lanes a, lanes b, lanes weight) {
+    return add(mul_high(a, sub(splat(0xFFFF), weight)), mul_high(b, weight));
+}
+
+inline lanes key_2d(lanes key, lanes sx, lanes sy) {
+    lanes const step_x = splat(STEP_X);
+    lanes const up = add(key, splat(STEP_Y));
+    return blend(blend(lattice(key), lattice(add(key, step_x)), sx),
+                 blend(lattice(up), lattice(add(up, step_x)), sx), sy);
+}
+#endif
+
+}  // namespace noise_detail
+
+/**
+ * @brief noise_1d() for count coordinates, into out
+ */
+inline void noise_1d_batch(int32_t const* x, std::size_t count, uint32_t seed, uint16_t* out) {
+    std::size_t i = 0;
+#ifdef NOISE_FIELD_SIMD
+    using namespace noise_detail;
+    lanes const base = splat(fold(seed));
+    for (; i + 8 <= count; i += 8) {
+        lanes cx;
+        lanes fx;
+        split(x + i, cx, fx);
+        lanes const key = add(base, mul_low(cx, splat(STEP_X)));
+        store(out + i, blend(lattice(key), lattice(add(key, splat(STEP_X))), smooth(fx)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = noise_1d(x[i], seed);
+    }
+}
+
+/**
+ * @brief noise_2d() for count (x, y) pairs, into out
+ */
+inline void noise_2d_batch(int32_t const* x, int32_t const* y, std::size_t count, uint32_t seed,
+                           uint16_t* out) {
+    std::size_t i = 0;
+#ifdef NOISE_FIELD_SIMD
+    using namespace noise_detail;
+    lanes const base = splat(fold(seed));
+    for (; i + 8 <= count; i += 8) {
+        lanes cx;
+        lanes fx;
+        lanes cy;
+        lanes fy;
+        split(x + i, cx, fx);
+        split(y + i, cy, fy);
+        lanes const key =
+            add(add(base, mul_low(cx, splat(STEP_X))), mul_low(cy, splat(STEP_Y)));
+        store(out + i, key_2d(key, smooth(fx), smooth(fy)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = noise_2d(x[i], y[i], seed);
+    }
+}
+
+/**
+ * @brief noise_3d() over (x, y) pairs at one z (time, for moving 2D fields), into out
+ */
+inline void noise_3d_batch(int32_t const* x, int32_t const* y, int32_t z, std::size_t count,
+                           uint32_t seed, uint16_t* out) {
+    std::size_t i = 0;
+#ifdef NOISE_FIELD_SIMD
+    using namespace noise_detail;
+    lanes const base = splat(static_cast<uint16_t>(
+        fold(seed) + noise_detail::mul_low(noise_detail::cell(z), STEP_Z)));
+    lanes const sz = splat(noise_detail::smooth(noise_detail::fraction(z)));
+    for (; i + 8 <= count; i += 8) {
+        lanes cx;
+        lanes fx;
+        lanes cy;
+        lanes fy;
+        split(x + i, cx, fx);
+        split(y + i, cy, fy);
+        lanes const key =
+            add(add(base, mul_low(cx, splat(STEP_X))), mul_low(cy, splat(STEP_Y)));
+        lanes const sx = smooth(fx);
+        lanes const sy = smooth(fy);
+        store(out + i,
+              blend(key_2d(key, sx, sy), key_2d(add(key, splat(STEP_Z)), sx, sy), sz));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = noise_3d(x[i], y[i], z, seed);
+    }
+}
+
+/**
+ * @brief Perlin's permutation of 0-255: the AVR variant's lattice values
+ *
+ * 256 bytes in flash (PROGMEM) on AVR, .rodata on the host.
+ */
+inline uint8_t noise8_permutation(uint8_t index) {
+    static uint8_t const table[256] NOISE8_TABLE_STORAGE = {
+        151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+        140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+        247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+        57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+        74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+        60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+        65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+        200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+        52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+        207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+        119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+        129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+        218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+        81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+        184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+        222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+    };
+    return NOISE8_TABLE_READ(table[index]);
+}
+
+namespace noise_detail {
+
+// Smoothstep of an 8-bit fraction in 16-bit arithmetic
+inline uint8_t ease8(uint8_t fraction) {
+    uint16_t const ff = static_cast<uint16_t>((static_cast<uint16_t>(fraction) * fraction) >> 8);
+    uint16_t const fff = static_cast<uint16_t>((ff * fraction) >> 8);
+    uint16_t const eased = static_cast<uint16_t>(3 * ff - 2 * fff);
+    return eased > 255 ? 255 : static_cast<uint8_t>(eased);
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t weight) {
+    return static_cast<uint8_t>((static_cast<uint16_t>(a) * (256 - weight) +
+                                 static_cast<uint16_t>(b) * weight) >> 8);
+}
+
+inline uint8_t hash8(uint8_t x, uint8_t y) {
+    return noise8_permutation(static_cast<uint8_t>(noise8_permutation(x) + y));
+}
+
+}  // namespace noise_detail
+
+/**
+ * @brief 1D noise at x (8.8: cell in the high byte), 0-255
+ */
+inline uint8_t noise8_1d(uint16_t x) {
+    using namespace noise_detail;
+    uint8_t const cell = static_cast<uint8_t>(x >> 8);
+    return blend8(noise8_permutation(cell), noise8_permutation(static_cast<uint8_t>(cell + 1)),
+                  ease8(static_cast<uint8_t>(x)));
+}
+
+/**
+ * @brief 2D noise at (x, y) (8.8), 0-255
+ */
+inline uint8_t noise8_2d(uint16_t x, uint16_t y) {
+    using namespace noise_detail;
+    uint8_t const cx = static_cast<uint8_t>(x >> 8);
+    uint8_t const cy = static_cast<uint8_t>(y >> 8);
+    uint8_t const nx = static_cast<uint8_t>(cx + 1);
+    uint8_t const ny = static_cast<uint8_t>(cy + 1);
+    uint8_t const sx = ease8(static_cast<uint8_t>(x));
+    return blend8(blend8(hash8(cx, cy), hash8(nx, cy), sx),
+                  blend8(hash8(cx, ny), hash8(nx, ny), sx), ease8(static_cast<uint8_t>(y)));
+}
+
+/**
+ * @brief 3D noise at (x, y, z) (8.8), 0-255
+ */
+inline uint8_t noise8_3d(uint16_t x, uint16_t y, uint16_t z) {
+    using namespace noise_detail;
+    uint8_t const cz = static_cast<uint8_t>(z >> 8);
+    uint8_t const sz = ease8(static_cast<uint8_t>(z));
+    // The z cell offsets the x lattice, so each layer is a different 2D field
+    uint8_t const layer0 = noise8_2d(static_cast<uint16_t>(x + (noise8_permutation(cz) << 8)), y);
+    uint8_t const layer1 = noise8_2d(
+        static_cast<uint16_t>(x + (noise8_permutation(static_cast<uint8_t>(cz + 1)) << 8)), y);
+    return blend8(layer0, layer1, sz);
+}
+
+/**
+ * @brief Candle flicker on an on/off pin, driven by noise
+ *
+ * Same pin interface as blink_controller (set(bool)): the flame level
+ * (two octaves of noise8_1d() along time, between min and max) is
+ * dithered onto the pin with a first-order sigma-delta, so called every
+ * millisecond or faster the LED's average brightness follows the flame.
+ * get_level() exposes the level for PWM outputs.
+ *
+ * Platform-agnostic (no heap, no STL, 8-bit noise): a few bytes of state
+ * and one noise sample pair per update.
+ *
+ * Usage:
+ *   flicker_controller<led_pin> candle(pin, 120, 255, 8);  // 8 flickers per second
+ *   candle.update(millis());
+ *
+ * @tparam output_pin_t Type that implements set(bool) method
+ */
+template<typename output_pin_t>
+struct flicker_controller {
+   public:
+    /**
+     * @param output Reference to output pin interface
+     * @param min_level Dimmest the flame gets (0-255)
+     * @param max_level Brightest (0-255)
+     * @param cells_per_second Noise cells per second: how fast the flame moves
+     * @param seed Different seeds give unsynchronized candles
+     */
+    flicker_controller(output_pin_t& output, uint8_t min_level, uint8_t max_level,
+                       uint16_t cells_per_second, uint8_t seed = 0)
+        : output_(output),
+          step_(static_cast<uint32_t>(cells_per_second) * 65536u / 1000u),
+          offset_(static_cast<uint16_t>(seed) << 8),
+          min_level_(min_level),
+          max_level_(max_level),
+          level_(min_level),
+          error_(0),
+          on_(false) {}
+
+    /**
+     * @brief Advance the flame to current_time_ms and drive the pin
+     */
+    void update(uint32_t current_time_ms) {
+        uint16_t const x = static_cast<uint16_t>((current_time_ms * step_) >> 8) + offset_;
+        uint16_t const slow = noise8_1d(x);
+        uint16_t const fast = noise8_1d(static_cast<uint16_t>(x * 3 + 0x5A00));
+        uint16_t const flame = static_cast<uint16_t>((3 * slow + fast) >> 2);
+        level_ = static_cast<uint8_t>(min_level_ + (((max_level_ - min_level_) * flame) >> 8));
+
+        error_ = static_cast<uint16_t>(error_ + level_);
+        on_ = error_ >= 255;
+        if (on_) {
+            error_ = static_cast<uint16_t>(error_ - 255);
+        }
+        output_.set(on_);
+    }
+
+    uint8_t get_level() const { return level_; }
+    bool is_on() const { return on_; }
+
+   private:
+    output_pin_t& output_;
+    uint32_t step_;  // Noise position per ms, 1/65536 cells
+    uint16_t offset_;
+    uint8_t min_level_;
+    uint8_t max_level_;
+    uint8_t level_;
+    uint16_t error_;
+    bool on_;
+};
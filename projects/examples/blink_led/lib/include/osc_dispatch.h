@@ -0,0 +1,560 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "osc_message.h"
+
+/**
+ * @brief Called for a message whose address pattern matched a route
+ *
+ * @param context Pointer registered with the route
+ * @param message The message; valid only during the call
+ */
+typedef void (*osc_handler)(void* context, osc_message const& message);
+
+namespace osc_detail {
+
+inline bool is_pattern_char(char c) {
+    return c == '*' || c == '?' || c == '[' || c == '{';
+}
+
+inline uint32_t fnv1a(char const* text, std::size_t length) {
+    uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(text[i])) * 16777619u;
+    }
+    return hash;
+}
+
+inline std::size_t count_segments(char const* text, std::size_t length) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        count += text[i] == '/' ? 1 : 0;
+    }
+    return count;
+}
+
+constexpr std::size_t table_size(std::size_t routes, std::size_t size = 8) {
+    return size >= routes * 2 ? size : table_size(routes, size * 2);
+}
+
+// '[' set: p points after '['; on return p points after ']'
+inline bool match_set(char const*& p, char const* pattern_end, char c) {
+    bool const negate = p < pattern_end && *p == '!';
+    if (negate) {
+        ++p;
+    }
+    bool matched = false;
+    while (p < pattern_end && *p != ']') {
+        if (p + 2 < pattern_end && p[1] == '-' && p[2] != ']') {
+            char const low = p[0] < p[2] ? p[0] : p[2];
+            char const high = p[0] < p[2] ? p[2] : p[0];
+            matched = matched || (c >= low && c <= high);
+            p += 3;
+        } else {
+            matched = matched || *p == c;
+            ++p;
+        }
+    }
+    if (p < pattern_end) {
+        ++p;  // ']'
+    }
+    return matched != negate;
+}
+
+}  // namespace osc_detail
+
+/**
+ * @brief OSC 1.0 address pattern match
+ *
+ * '?' matches one character and '*' any run of characters (neither crosses
+ * a '/'); "[a-z]" / "[!0-9]" match one character from a set; "{go,stop}"
+ * matches any of the listed strings.
+ */
+inline bool osc_pattern_match(char const* pattern, char const* pattern_end, char const* address,
+                              char const* address_end) {
+    while (pattern < pattern_end) {
+        char const p = *pattern;
+        if (p == '*') {
+            while (pattern < pattern_end && *pattern == '*') {
+                ++pattern;
+            }
+            for (char const* rest = address;; ++rest) {
+                if (osc_pattern_match(pattern, pattern_end, rest, address_end)) {
+                    return true;
+                }
+                if (rest == address_end || *rest == '/') {
+                    return false;
+                }
+            }
+        }
+        if (address == address_end) {
+            return false;
+        }
+        if (p == '?') {
+            if (*address == '/') {
+                return false;
+            }
+            ++pattern;
+            ++address;
+        } else if (p == '[') {
+            ++pattern;
+            if (*address == '/' || !osc_detail::match_set(pattern, pattern_end, *address)) {
+                return false;
+            }
+            ++address;
+        } else if (p == '{') {
+            char const* close = pattern;
+            while (close < pattern_end && *close != '}') {
+                ++close;
+            }
+            char const* after = close < pattern_end ? close + 1 : close;
+            char const* option = pattern + 1;
+            while (option <= close) {
+                char const* option_end = option;
+                while (option_end < close && *option_end != ',') {
+                    ++option_end;
+                }
+                std::size_t const size = static_cast<std::size_t>(option_end - option);
+                if (static_cast<std::size_t>(address_end - address) >= size &&
+                    std::memcmp(option, address, size) == 0 &&
+                    osc_pattern_match(after, pattern_end, address + size, address_end)) {
+                    return true;
+                }
+                option = option_end + 1;
+            }
+            return false;
+        } else {
+            if (p != *address) {
+                return false;
+            }
+            ++pattern;
+            ++address;
+        }
+    }
+    return address == address_end;
+}
+
+/**
+ * @brief Routes OSC messages to handlers through a table built at setup time
+ *
+ * Routes are plain addresses ("/cue/go", "/channel/3/rate"). At add() time
+ * each gets a hash slot, its hash and its segment count, so that dispatch
+ * costs:
+ *   - literal address (the common case): one pass to hash the address, one
+ *     table probe and one compare to confirm
+ *   - pattern address ("/channel/{1,2}/rate", "/channel/?", a star): the
+ *     matching routes are resolved once and cached by pattern, so a desk
+ *     repeating a pattern pays a hash probe and a compare, not a match per
+ *     route
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   osc_dispatcher<32> osc;
+ *   osc.add("/cue/go", &on_go, &cues);
+ *   osc.dispatch(message);
+ *
+ * @tparam max_routes_v Route capacity
+ * @tparam max_address_v Longest route or cached pattern, including the NUL
+ */
+template<std::size_t max_routes_v, std::size_t max_address_v = 64>
+struct osc_dispatcher {
+   public:
+    static_assert(max_routes_v >= 1 && max_routes_v < 0xFFFF, "route index must fit in 16 bits");
+
+    static std::size_t const TABLE_SIZE = osc_detail::table_size(max_routes_v);
+    static std::size_t const PATTERN_CACHE_SIZE = 8;
+
+    osc_dispatcher()
+        : route_count_(0), next_cache_(0), dispatched_(0), unmatched_(0), pattern_misses_(0) {
+        for (std::size_t i = 0; i < TABLE_SIZE; ++i) {
+            table_[i] = 0;
+        }
+        clear_cache();
+    }
+
+    /**
+     * @brief Register a handler for a literal address
+     *
+     * @return false Full, address too long, not starting with '/', containing
+     *         pattern characters, or already registered
+     */
+    bool add(char const* address, osc_handler handler, void* context) {
+        std::size_t const length = std::strlen(address);
+        if (route_count_ == max_routes_v || length == 0 || length >= max_address_v ||
+            address[0] != '/' || handler == nullptr) {
+            return false;
+        }
+        for (std::size_t i = 0; i < length; ++i) {
+            if (osc_detail::is_pattern_char(address[i]) || address[i] == ' ' ||
+                address[i] == '#') {
+                return false;
+            }
+        }
+        uint32_t const hash = osc_detail::fnv1a(address, length);
+        if (find(address, length, hash) != nullptr) {
+            return false;
+        }
+        route& r = routes_[route_count_];
+        std::memcpy(r.address, address, length + 1);
+        r.length = static_cast<uint16_t>(length);
+        r.hash = hash;
+        r.segments = static_cast<uint16_t>(osc_detail::count_segments(address, length));
+        r.handler = handler;
+        r.context = context;
+        std::size_t slot = hash & (TABLE_SIZE - 1);
+        while (table_[slot] != 0) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        table_[slot] = static_cast<uint16_t>(++route_count_);
+        clear_cache();  // Cached pattern results may now miss the new route
+        return true;
+    }
+
+    /**
+     * @brief Call the handler of every route the message's address matches
+     *
+     * @return std::size_t Handlers called
+     */
+    std::size_t dispatch(osc_message const& message) {
+        char const* const address = message.address;
+        std::size_t const length = message.address_length;
+        uint32_t hash = 2166136261u;
+        bool pattern = false;
+        for (std::size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(address[i])) * 16777619u;
+            pattern = pattern || osc_detail::is_pattern_char(address[i]);
+        }
+        std::size_t called = 0;
+        if (!pattern) {
+            route const* const r = find(address, length, hash);
+            if (r != nullptr) {
+                r->handler(r->context, message);
+                called = 1;
+            }
+        } else {
+            called = dispatch_pattern(message, hash);
+        }
+        if (called == 0) {
+            ++unmatched_;
+        }
+        dispatched_ += static_cast<uint32_t>(called);
+        return called;
+    }
+
+    std::size_t get_route_count() const { return route_count_; }
+
+    // Statistics
+    uint32_t get_dispatched() const { return dispatched_; }
+    uint32_t get_unmatched() const { return unmatched_; }
+    uint32_t get_pattern_misses() const { return pattern_misses_; }
+
+   private:
+    static std::size_t const MASK_WORDS = (max_routes_v + 31) / 32;
+    static std::size_t const ANY_SEGMENTS = ~static_cast<std::size_t>(0);
+
+    struct route {
+        char address[max_address_v];
+        uint16_t length;
+        uint16_t segments;
+        uint32_t hash;
+        osc_handler handler;
+        void* context;
+    };
+
+    struct cached_pattern {
+        bool valid;
+        uint16_t length;
+        uint32_t hash;
+        char pattern[max_address_v];
+        uint32_t routes[MASK_WORDS];
+    };
+
+    route const* find(char const* address, std::size_t length, uint32_t hash) const {
+        std::size_t slot = hash & (TABLE_SIZE - 1);
+        while (table_[slot] != 0) {
+            route const& r = routes_[table_[slot] - 1];
+            if (r.hash == hash && r.length == length &&
+                std::memcmp(r.address, address, length) == 0) {
+                return &r;
+            }
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        return nullptr;
+    }
+
+    void clear_cache() {
+        for (std::size_t i = 0; i < PATTERN_CACHE_SIZE; ++i) {
+            cache_[i].valid = false;
+        }
+    }
+
+    bool route_matches(route const& r, char const* pattern, std::size_t length,
+                       std::size_t segments) const {
+        return (segments == ANY_SEGMENTS || r.segments == segments) &&
+               osc_pattern_match(pattern, pattern + length, r.address, r.address + r.length);
+    }
+
+    std::size_t dispatch_pattern(osc_message const& message, uint32_t hash) {
+        char const* const pattern = message.address;
+        std::size_t const length = message.address_length;
+        for (std::size_t c = 0; c < PATTERN_CACHE_SIZE; ++c) {
+            cached_pattern const& entry = cache_[c];
+            if (entry.valid && entry.hash == hash && entry.length == length &&
+                std::memcmp(entry.pattern, pattern, length) == 0) {
+                return call_routes(entry.routes, message);
+            }
+        }
+
+        ++pattern_misses_;
+        // '{a/b,c}' may span segments; skip the segment-count filter for it
+        std::size_t const segments = std::memchr(pattern, '{', length) != nullptr
+                                         ? ANY_SEGMENTS
+                                         : osc_detail::count_segments(pattern, length);
+        if (length >= max_address_v) {
+            // Too long to cache: match every route directly
+            std::size_t called = 0;
+            for (std::size_t i = 0; i < route_count_; ++i) {
+                if (route_matches(routes_[i], pattern, length, segments)) {
+                    routes_[i].handler(routes_[i].context, message);
+                    ++called;
+                }
+            }
+            return called;
+        }
+        cached_pattern& entry = cache_[next_cache_];
+        next_cache_ = (next_cache_ + 1) % PATTERN_CACHE_SIZE;
+        entry.valid = true;
+        entry.hash = hash;
+        entry.length = static_cast<uint16_t>(length);
+        std::memcpy(entry.pattern, pattern, length);
+        for (std::size_t w = 0; w < MASK_WORDS; ++w) {
+            entry.routes[w] = 0;
+        }
+        for (std::size_t i = 0; i < route_count_; ++i) {
+            if (route_matches(routes_[i], pattern, length, segments)) {
+                entry.routes[i / 32] |= uint32_t(1) << (i % 32);
+            }
+        }
+        return call_routes(entry.routes, message);
+    }
+
+    std::size_t call_routes(uint32_t const* mask, osc_message const& message) {
+        std::size_t called = 0;
+        for (std::size_t w = 0; w < MASK_WORDS; ++w) {
+            uint32_t bits = mask[w];
+            while (bits != 0) {
+                std::size_t bit = 0;
+                while ((bits & (uint32_t(1) << bit)) == 0) {
+                    ++bit;
+                }
+                bits &= bits - 1;
+                route const& r = routes_[w * 32 + bit];
+                r.handler(r.context, message);
+                ++called;
+            }
+        }
+        return called;
+    }
+
+    route routes_[max_routes_v];
+    uint16_t table_[TABLE_SIZE];
+    cached_pattern cache_[PATTERN_CACHE_SIZE];
+    std::size_t route_count_;
+    std::size_t next_cache_;
+    uint32_t dispatched_;
+    uint32_t unmatched_;
+    uint32_t pattern_misses_;
+};
+
+template<std::size_t max_routes_v, std::size_t max_address_v>
+std::size_t const osc_dispatcher<max_routes_v, max_address_v>::TABLE_SIZE;
+
+template<std::size_t max_routes_v, std::size_t max_address_v>
+std::size_t const osc_dispatcher<max_routes_v, max_address_v>::PATTERN_CACHE_SIZE;
+
+template<std::size_t max_routes_v, std::size_t max_address_v>
+std::size_t const osc_dispatcher<max_routes_v, max_address_v>::ANY_SEGMENTS;
+
+/**
+ * @brief Runs timetagged bundle contents at their time on the controller clock
+ *
+ * sync() pairs an OSC (NTP) time with the controller's millis(). process()
+ * walks a received packet: plain messages, immediate bundles and bundles
+ * whose time has passed are dispatched at once (as OSC 1.0 requires for
+ * late bundles); future ones are copied into a fixed queue and dispatched
+ * by update() when due, in time order. Conversion is exact integer math on
+ * the 32.32 timetag, so scheduling does not drift.
+ *
+ * Until the first sync() every timetag is treated as immediate.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   osc_scheduler<osc_dispatcher<32> > scheduler(osc);
+ *   scheduler.sync(ntp_now, millis());
+ *   scheduler.process(packet, length, millis());  // per received datagram
+ *   scheduler.update(millis());                   // every loop
+ *
+ * @tparam dispatcher_t Type with dispatch(osc_message const&) (osc_dispatcher)
+ * @tparam capacity_v Scheduled messages held at once
+ * @tparam max_message_v Largest message that can be scheduled (bytes)
+ */
+template<typename dispatcher_t, std::size_t capacity_v = 16, std::size_t max_message_v = 128>
+struct osc_scheduler {
+   public:
+    static_assert(capacity_v >= 1 && capacity_v < 256, "queue index must fit in a byte");
+
+    explicit osc_scheduler(dispatcher_t& dispatcher)
+        : dispatcher_(dispatcher),
+          synced_(false),
+          sync_timetag_(0),
+          sync_ms_(0),
+          pending_(0),
+          dropped_(0) {}
+
+    /**
+     * @brief Pair an OSC time with the controller clock
+     *
+     * @param timetag OSC/NTP time (32.32 fixed point)
+     * @param now_ms Controller millis() at that moment
+     */
+    void sync(uint64_t timetag, uint32_t now_ms) {
+        sync_timetag_ = timetag;
+        sync_ms_ = now_ms;
+        synced_ = true;
+    }
+
+    /**
+     * @brief Controller time of an OSC timetag (nearest millisecond)
+     */
+    uint32_t timetag_to_ms(uint64_t timetag) const {
+        uint64_t const forward = timetag - sync_timetag_;
+        bool const past = (forward >> 63) != 0;
+        uint64_t const magnitude = past ? sync_timetag_ - timetag : forward;
+        // Round the fraction so millisecond timetags map back exactly
+        uint64_t const fraction_ms = ((magnitude & 0xFFFFFFFFu) * 1000 + 0x80000000u) >> 32;
+        uint64_t const ms = (magnitude >> 32) * 1000 + fraction_ms;
+        uint32_t const offset = static_cast<uint32_t>(ms);
+        return past ? sync_ms_ - offset : sync_ms_ + offset;
+    }
+
+    /**
+     * @brief Dispatch or schedule every message of a received packet
+     *
+     * @return false The packet was (partly) malformed
+     */
+    bool process(uint8_t const* data, std::size_t length, uint32_t now_ms) {
+        visitor v = {this, now_ms};
+        return osc_walk_packet(data, length, v);
+    }
+
+    /**
+     * @brief Dispatch scheduled messages that are due (wraparound-safe)
+     *
+     * @return std::size_t Messages dispatched
+     */
+    std::size_t update(uint32_t now_ms) {
+        std::size_t count = 0;
+        while (pending_ > 0) {
+            entry& next = entries_[order_[0]];
+            if (static_cast<int32_t>(next.due_ms - now_ms) > 0) {
+                break;
+            }
+            osc_message message;
+            if (osc_parse_message(next.bytes, next.length, message)) {
+                dispatcher_.dispatch(message);
+                ++count;
+            }
+            for (std::size_t i = 1; i < pending_; ++i) {
+                order_[i - 1] = order_[i];
+            }
+            --pending_;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Time the next scheduled message is due (false if none)
+     */
+    bool get_next_due(uint32_t& due_ms) const {
+        if (pending_ == 0) {
+            return false;
+        }
+        due_ms = entries_[order_[0]].due_ms;
+        return true;
+    }
+
+    std::size_t get_pending() const { return pending_; }
+    uint32_t get_dropped() const { return dropped_; }
+    bool is_synced() const { return synced_; }
+
+   private:
+    struct entry {
+        uint32_t due_ms;
+        uint16_t length;
+        uint8_t bytes[max_message_v];
+    };
+
+    struct visitor {
+        osc_scheduler* self;
+        uint32_t now_ms;
+
+        void on_message(osc_message const& message, uint64_t timetag) {
+            self->on_message(message, timetag, now_ms);
+        }
+    };
+
+    void on_message(osc_message const& message, uint64_t timetag, uint32_t now_ms) {
+        if (!synced_ || timetag == OSC_TIMETAG_IMMEDIATE) {
+            dispatcher_.dispatch(message);
+            return;
+        }
+        uint32_t const due_ms = timetag_to_ms(timetag);
+        if (static_cast<int32_t>(due_ms - now_ms) <= 0) {
+            dispatcher_.dispatch(message);
+            return;
+        }
+        if (pending_ == capacity_v || message.raw_length > max_message_v) {
+            ++dropped_;
+            return;
+        }
+        // Claim a free entry and insert it in due order (FIFO among equals)
+        std::size_t slot = 0;
+        while (used(slot)) {
+            ++slot;
+        }
+        entry& e = entries_[slot];
+        e.due_ms = due_ms;
+        e.length = static_cast<uint16_t>(message.raw_length);
+        std::memcpy(e.bytes, message.raw, message.raw_length);
+        std::size_t position = pending_;
+        while (position > 0 &&
+               static_cast<int32_t>(entries_[order_[position - 1]].due_ms - due_ms) > 0) {
+            order_[position] = order_[position - 1];
+            --position;
+        }
+        order_[position] = static_cast<uint8_t>(slot);
+        ++pending_;
+    }
+
+    bool used(std::size_t slot) const {
+        for (std::size_t i = 0; i < pending_; ++i) {
+            if (order_[i] == slot) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    dispatcher_t& dispatcher_;
+    bool synced_;
+    uint64_t sync_timetag_;
+    uint32_t sync_ms_;
+    entry entries_[capacity_v];
+    uint8_t order_[capacity_v];
+    std::size_t pending_;
+    uint32_t dropped_;
+};
@@ -0,0 +1,552 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Open Sound Control 1.0 messages and bundles, parsed in place
+ *
+ * A packet is either a message:
+ *
+ *   address "/cue/go"  type tags ",if"  arguments (big-endian, 4-byte aligned)
+ *
+ * or a bundle: "#bundle" + 64-bit NTP timetag + elements, each a 32-bit
+ * size followed by a message or a nested bundle. Strings are NUL-terminated
+ * and zero-padded to a multiple of 4 bytes.
+ *
+ * osc_parse_message() validates a message and records where each argument
+ * starts; osc_message then reads arguments straight out of the packet
+ * buffer. osc_walk_packet() visits every message of a packet with the
+ * timetag of the bundle it arrived in. Nothing is copied or allocated.
+ *
+ * Platform-agnostic (no heap, no STL).
+ */
+
+/// Timetag meaning "now" (bundles without a schedule)
+static uint64_t const OSC_TIMETAG_IMMEDIATE = 1;
+
+/// NTP seconds at the Unix epoch (1970-01-01)
+static uint32_t const OSC_NTP_UNIX_OFFSET = 2208988800u;
+
+namespace osc_detail {
+
+inline uint32_t read_u32(uint8_t const* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline void write_u32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+inline std::size_t pad4(std::size_t length) { return (length + 3) & ~static_cast<std::size_t>(3); }
+
+/**
+ * @brief Length of the padded OSC string at offset (0 if unterminated or badly padded)
+ */
+inline std::size_t string_size(uint8_t const* data, std::size_t offset, std::size_t length,
+                               std::size_t& string_length) {
+    for (std::size_t i = offset; i < length; ++i) {
+        if (data[i] == 0) {
+            std::size_t const padded = pad4(i - offset + 1);
+            if (offset + padded > length) {
+                return 0;
+            }
+            for (std::size_t j = i + 1; j < offset + padded; ++j) {
+                if (data[j] != 0) {
+                    return 0;
+                }
+            }
+            string_length = i - offset;
+            return padded;
+        }
+    }
+    return 0;
+}
+
+static char const BUNDLE_TAG[8] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0};
+static std::size_t const MAX_BUNDLE_DEPTH = 4;
+
+}  // namespace osc_detail
+
+/**
+ * @brief Zero-copy view of one validated OSC message
+ *
+ * Pointers refer into the packet buffer and are valid as long as it is.
+ */
+struct osc_message {
+    static std::size_t const MAX_ARGUMENTS = 16;
+
+    char const* address;     // NUL-terminated
+    std::size_t address_length;
+    char const* type_tags;   // After the ',' (NUL-terminated; "" without arguments)
+    std::size_t argument_count;
+    uint8_t const* raw;      // Whole message, for copying (see osc_scheduler)
+    std::size_t raw_length;
+    uint16_t offsets[MAX_ARGUMENTS];  // Argument positions relative to raw
+
+    char get_type(std::size_t index) const {
+        return index < argument_count ? type_tags[index] : '\0';
+    }
+
+    /**
+     * @brief Read a numeric argument as int32 (i, h, f, d, T, F)
+     *
+     * Floats truncate toward zero and saturate at the int32 range; NaN fails.
+     */
+    bool get_int32(std::size_t index, int32_t& value) const {
+        switch (get_type(index)) {
+            case 'i':
+                value = static_cast<int32_t>(read_u32(index));
+                return true;
+            case 'h':
+                value = static_cast<int32_t>(static_cast<int64_t>(read_u64(index)));
+                return true;
+            case 'f':
+                return to_int32(read_float(index), value);
+            case 'd': {
+                double number;
+                return read_double(index, number) && to_int32(number, value);
+            }
+            case 'T':
+                value = 1;
+                return true;
+            case 'F':
+                value = 0;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Read a numeric argument as float (i, h, f, d, T, F)
+     */
+    bool get_float(std::size_t index, float& value) const {
+        switch (get_type(index)) {
+            case 'f':
+                value = read_float(index);
+                return true;
+            case 'd': {
+                double number;
+                if (!read_double(index, number)) {
+                    return false;
+                }
+                value = static_cast<float>(number);
+                return true;
+            }
+            case 'i':
+                value = static_cast<float>(static_cast<int32_t>(read_u32(index)));
+                return true;
+            case 'h':
+                value = static_cast<float>(static_cast<int64_t>(read_u64(index)));
+                return true;
+            case 'T':
+                value = 1.0f;
+                return true;
+            case 'F':
+                value = 0.0f;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Read a string or symbol argument (s, S)
+     */
+    bool get_string(std::size_t index, char const*& value) const {
+        char const type = get_type(index);
+        if (type != 's' && type != 'S') {
+            return false;
+        }
+        value = reinterpret_cast<char const*>(raw + offsets[index]);
+        return true;
+    }
+
+    /**
+     * @brief Read a blob argument (b)
+     */
+    bool get_blob(std::size_t index, uint8_t const*& data, std::size_t& size) const {
+        if (get_type(index) != 'b') {
+            return false;
+        }
+        size = read_u32(index);
+        data = raw + offsets[index] + 4;
+        return true;
+    }
+
+    uint32_t read_u32(std::size_t index) const {
+        return osc_detail::read_u32(raw + offsets[index]);
+    }
+
+    uint64_t read_u64(std::size_t index) const {
+        uint8_t const* p = raw + offsets[index];
+        return (static_cast<uint64_t>(osc_detail::read_u32(p)) << 32) |
+               osc_detail::read_u32(p + 4);
+    }
+
+   private:
+    // Untrusted input: converting NaN or an out-of-range float is undefined
+    static bool to_int32(double number, int32_t& value) {
+        if (number != number) {
+            return false;
+        }
+        if (number >= 2147483648.0) {
+            value = INT32_MAX;
+        } else if (number < -2147483648.0) {
+            value = INT32_MIN;
+        } else {
+            value = static_cast<int32_t>(number);
+        }
+        return true;
+    }
+
+    float read_float(std::size_t index) const {
+        uint32_t const bits = read_u32(index);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // 'd' needs a 64-bit double (not available on AVR, where double is float)
+    bool read_double(std::size_t index, double& value) const {
+        if (sizeof(double) != sizeof(uint64_t)) {
+            return false;
+        }
+        uint64_t const bits = read_u64(index);
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+};
+
+/**
+ * @brief Validate one OSC message and index its arguments
+ *
+ * A message without a type tag string (pre-1.0 senders) has no arguments.
+ *
+ * @return false Malformed, unsupported type tag, or more than MAX_ARGUMENTS
+ */
+inline bool osc_parse_message(uint8_t const* data, std::size_t length, osc_message& message) {
+    using namespace osc_detail;
+    if (length < 4 || length % 4 != 0 || data[0] != '/' || length > 0xFFFF) {
+        return false;
+    }
+    std::size_t address_length = 0;
+    std::size_t offset = string_size(data, 0, length, address_length);
+    if (offset == 0) {
+        return false;
+    }
+    message.address = reinterpret_cast<char const*>(data);
+    message.address_length = address_length;
+    message.raw = data;
+    message.raw_length = length;
+    message.argument_count = 0;
+    if (offset == length) {
+        message.type_tags = reinterpret_cast<char const*>(data + address_length);  // ""
+        return true;
+    }
+    if (data[offset] != ',') {
+        return false;
+    }
+    std::size_t tag_length = 0;
+    std::size_t const tags_size = string_size(data, offset, length, tag_length);
+    if (tags_size == 0) {
+        return false;
+    }
+    message.type_tags = reinterpret_cast<char const*>(data + offset + 1);
+    std::size_t position = offset + tags_size;
+    std::size_t count = 0;
+    for (std::size_t t = 1; t < tag_length; ++t) {
+        char const type = static_cast<char>(data[offset + t]);
+        std::size_t size = 0;
+        switch (type) {
+            case 'i':
+            case 'f':
+            case 'c':
+            case 'r':
+            case 'm':
+                size = 4;
+                break;
+            case 'h':
+            case 't':
+            case 'd':
+                size = 8;
+                break;
+            case 's':
+            case 'S': {
+                std::size_t ignored = 0;
+                size = string_size(data, position, length, ignored);
+                if (size == 0) {
+                    return false;
+                }
+                break;
+            }
+            case 'b': {
+                if (position + 4 > length) {
+                    return false;
+                }
+                // Bound the length before padding it, so it cannot wrap a 32-bit size_t
+                uint32_t const blob_length = read_u32(data + position);
+                if (blob_length > length - position - 4) {
+                    return false;
+                }
+                size = 4 + pad4(blob_length);
+                break;
+            }
+            case 'T':
+            case 'F':
+            case 'N':
+            case 'I':
+                size = 0;
+                break;
+            default:
+                return false;  // Includes arrays ('[', ']'), which this parser does not index
+        }
+        if (count == osc_message::MAX_ARGUMENTS || position + size > length ||
+            size > length) {
+            return false;
+        }
+        message.offsets[count++] = static_cast<uint16_t>(position);
+        position += size;
+    }
+    if (position != length) {
+        return false;
+    }
+    message.argument_count = count;
+    return true;
+}
+
+inline bool osc_is_bundle(uint8_t const* data, std::size_t length) {
+    return length >= 16 && std::memcmp(data, osc_detail::BUNDLE_TAG, 8) == 0;
+}
+
+namespace osc_detail {
+
+template<typename visitor_t>
+bool walk(uint8_t const* data, std::size_t length, uint64_t timetag, std::size_t depth,
+          visitor_t& visitor) {
+    if (!osc_is_bundle(data, length)) {
+        osc_message message;
+        if (!osc_parse_message(data, length, message)) {
+            return false;
+        }
+        visitor.on_message(message, timetag);
+        return true;
+    }
+    if (depth == MAX_BUNDLE_DEPTH || length % 4 != 0) {
+        return false;
+    }
+    uint64_t const bundle_time =
+        (static_cast<uint64_t>(read_u32(data + 8)) << 32) | read_u32(data + 12);
+    std::size_t position = 16;
+    bool valid = true;
+    while (position < length) {
+        if (position + 4 > length) {
+            return false;
+        }
+        std::size_t const size = read_u32(data + position);
+        position += 4;
+        if (size > length - position) {
+            return false;
+        }
+        valid = walk(data + position, size, bundle_time, depth + 1, visitor) && valid;
+        position += size;
+    }
+    return valid;
+}
+
+}  // namespace osc_detail
+
+/**
+ * @brief Visit every message in a packet
+ *
+ * Messages outside a bundle carry OSC_TIMETAG_IMMEDIATE; messages in a
+ * bundle carry the timetag of the innermost bundle containing them.
+ * Malformed elements are skipped; the rest of the bundle is still visited.
+ *
+ * @tparam visitor_t Type with on_message(osc_message const&, uint64_t timetag)
+ * @return false Some part of the packet was malformed
+ */
+template<typename visitor_t>
+bool osc_walk_packet(uint8_t const* data, std::size_t length, visitor_t& visitor) {
+    return osc_detail::walk(data, length, OSC_TIMETAG_IMMEDIATE, 0, visitor);
+}
+
+/**
+ * @brief Write one OSC message into a caller-provided buffer
+ *
+ * The type tags are declared up front, then one add_*() per tag.
+ *
+ * Usage:
+ *   uint8_t buffer[64];
+ *   osc_message_writer writer(buffer, sizeof(buffer));
+ *   writer.begin("/channel/3/rate", "if");
+ *   writer.add_int32(3);
+ *   writer.add_float(120.0f);
+ *   std::size_t length = writer.finish();  // 0 on overflow or a tag mismatch
+ */
+struct osc_message_writer {
+   public:
+    osc_message_writer(uint8_t* buffer, std::size_t capacity)
+        : buffer_(buffer), capacity_(capacity), length_(0), tags_(nullptr), next_tag_(0),
+          ok_(false) {}
+
+    void begin(char const* address, char const* type_tags) {
+        length_ = 0;
+        ok_ = true;
+        put_string(address);
+        std::size_t const tag_start = length_;
+        if (ok_ && length_ < capacity_) {
+            buffer_[length_++] = ',';
+            std::size_t const count = std::strlen(type_tags);
+            for (std::size_t i = 0; i < count && ok_; ++i) {
+                put_byte(static_cast<uint8_t>(type_tags[i]));
+            }
+            put_byte(0);
+            pad();
+        } else {
+            ok_ = false;
+        }
+        tags_ = reinterpret_cast<char const*>(buffer_ + tag_start + 1);
+        next_tag_ = 0;
+    }
+
+    void add_int32(int32_t value) {
+        if (expect('i')) {
+            put_u32(static_cast<uint32_t>(value));
+        }
+    }
+
+    void add_float(float value) {
+        if (expect('f')) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            put_u32(bits);
+        }
+    }
+
+    void add_string(char const* value) {
+        if (expect('s')) {
+            put_string(value);
+        }
+    }
+
+    void add_blob(uint8_t const* data, std::size_t size) {
+        if (expect('b')) {
+            put_u32(static_cast<uint32_t>(size));
+            for (std::size_t i = 0; i < size && ok_; ++i) {
+                put_byte(data[i]);
+            }
+            pad();
+        }
+    }
+
+    /**
+     * @return std::size_t Message length (0 if it did not fit or tags were left over)
+     */
+    std::size_t finish() {
+        if (!ok_ || tags_ == nullptr || tags_[next_tag_] != '\0') {
+            return 0;
+        }
+        return length_;
+    }
+
+   private:
+    bool expect(char type) {
+        if (!ok_ || tags_[next_tag_] != type) {
+            ok_ = false;
+            return false;
+        }
+        ++next_tag_;
+        return true;
+    }
+
+    void put_byte(uint8_t byte) {
+        if (length_ == capacity_) {
+            ok_ = false;
+            return;
+        }
+        buffer_[length_++] = byte;
+    }
+
+    void put_u32(uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            put_byte(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    void put_string(char const* value) {
+        for (std::size_t i = 0; value[i] != '\0' && ok_; ++i) {
+            put_byte(static_cast<uint8_t>(value[i]));
+        }
+        put_byte(0);
+        pad();
+    }
+
+    void pad() {
+        while (ok_ && length_ % 4 != 0) {
+            put_byte(0);
+        }
+    }
+
+    uint8_t* buffer_;
+    std::size_t capacity_;
+    std::size_t length_;
+    char const* tags_;
+    std::size_t next_tag_;
+    bool ok_;
+};
+
+/**
+ * @brief Write an OSC bundle: a timetag followed by size-prefixed elements
+ *
+ * Usage:
+ *   osc_bundle_writer bundle(buffer, sizeof(buffer), timetag);
+ *   bundle.add(message, message_length);
+ *   std::size_t length = bundle.finish();
+ */
+struct osc_bundle_writer {
+   public:
+    osc_bundle_writer(uint8_t* buffer, std::size_t capacity, uint64_t timetag)
+        : buffer_(buffer), capacity_(capacity), length_(16), ok_(capacity >= 16) {
+        if (ok_) {
+            std::memcpy(buffer_, osc_detail::BUNDLE_TAG, 8);
+            osc_detail::write_u32(buffer_ + 8, static_cast<uint32_t>(timetag >> 32));
+            osc_detail::write_u32(buffer_ + 12, static_cast<uint32_t>(timetag));
+        }
+    }
+
+    /**
+     * @brief Append a message or nested bundle
+     */
+    void add(uint8_t const* element, std::size_t size) {
+        if (!ok_ || size % 4 != 0 || length_ + 4 + size > capacity_) {
+            ok_ = false;
+            return;
+        }
+        osc_detail::write_u32(buffer_ + length_, static_cast<uint32_t>(size));
+        std::memmove(buffer_ + length_ + 4, element, size);
+        length_ += 4 + size;
+    }
+
+    std::size_t finish() const { return ok_ ? length_ : 0; }
+
+   private:
+    uint8_t* buffer_;
+    std::size_t capacity_;
+    std::size_t length_;
+    bool ok_;
+};
+
+/**
+ * @brief Build an NTP timetag from seconds and milliseconds since the Unix epoch
+ */
+inline uint64_t osc_timetag_from_unix(uint64_t unix_seconds, uint32_t milliseconds) {
+    uint64_t const seconds = unix_seconds + OSC_NTP_UNIX_OFFSET;
+    uint64_t const fraction = (static_cast<uint64_t>(milliseconds) << 32) / 1000;
+    return (seconds << 32) | fraction;
+}
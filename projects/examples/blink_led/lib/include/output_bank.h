@@ -0,0 +1,228 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Pin adapter that drives one bit of an output_bank
+ *
+ * Implements the same set(bool) interface as hardware pins, so any
+ * controller can drive a bank channel through dependency injection.
+ */
+struct bank_pin {
+   public:
+    bank_pin(uint32_t* word, uint32_t mask) : word_(word), mask_(mask) {}
+
+    void set(bool state) {
+        if (state) {
+            *word_ |= mask_;
+        } else {
+            *word_ &= ~mask_;
+        }
+    }
+
+    bool get_state() const { return (*word_ & mask_) != 0; }
+
+   private:
+    uint32_t* word_;
+    uint32_t mask_;
+};
+
+/**
+ * @brief Packed on/off states for a fixed number of channels (one bit each)
+ *
+ * A bank is the frame the show produces every tick: controllers write into
+ * it through bank_pin adapters, and consumers (hardware shift registers,
+ * shared-memory publishers, serial streamers) read the packed words.
+ * Channel i lives in word i / 32, bit i % 32.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   output_bank<64> bank;
+ *   bank_pin pin = bank.channel(5);
+ *   blink_controller<bank_pin> controller(pin, 1000, 500);
+ *   controller.update(now);
+ *   publish(bank.words(), output_bank<64>::WORD_COUNT);
+ *
+ * @tparam channel_count_v Number of channels
+ */
+template<std::size_t channel_count_v>
+struct output_bank {
+   public:
+    static std::size_t const CHANNEL_COUNT = channel_count_v;
+    static std::size_t const WORD_COUNT = (channel_count_v + 31) / 32;
+
+    output_bank() { clear(); }
+
+    /**
+     * @brief Set every channel OFF
+     */
+    void clear() {
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            words_[i] = 0;
+        }
+    }
+
+    void set(std::size_t index, bool state) { channel(index).set(state); }
+
+    bool get(std::size_t index) const {
+        return (words_[index / 32] & (uint32_t(1) << (index % 32))) != 0;
+    }
+
+    /**
+     * @brief Pin adapter for one channel
+     *
+     * @param index Channel index (< channel_count_v)
+     * @return bank_pin Adapter with set(bool)
+     */
+    bank_pin channel(std::size_t index) {
+        return bank_pin(&words_[index / 32], uint32_t(1) << (index % 32));
+    }
+
+    /**
+     * @brief Number of channels currently ON
+     */
+    std::size_t count_on() const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            uint32_t word = words_[i];
+            while (word != 0) {
+                word &= word - 1;
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    uint32_t const* words() const { return words_; }
+    uint32_t* words() { return words_; }
+
+   private:
+    uint32_t words_[WORD_COUNT];
+};
+
+template<std::size_t channel_count_v>
+std::size_t const output_bank<channel_count_v>::CHANNEL_COUNT;
+
+template<std::size_t channel_count_v>
+std::size_t const output_bank<channel_count_v>::WORD_COUNT;
+
+/**
+ * @brief Pin adapter that drives one 8-bit channel of a level_bank
+ *
+ * Implements set_level(uint8_t) for fade_controller and other dimmable
+ * outputs.
+ */
+struct level_pin {
+   public:
+    explicit level_pin(uint8_t* level) : level_(level) {}
+
+    void set_level(uint8_t level) { *level_ = level; }
+
+    uint8_t get_level() const { return *level_; }
+
+   private:
+    uint8_t* level_;
+};
+
+/**
+ * @brief 8-bit levels for a fixed number of dimmable channels
+ *
+ * The dimmable counterpart of output_bank: one byte per channel (PWM duty,
+ * DMX slot value), driven through level_pin adapters.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   level_bank<16> levels;
+ *   level_pin pin = levels.channel(3);
+ *   fade_controller<level_pin> fade(pin, 200);
+ *
+ * @tparam channel_count_v Number of channels
+ */
+template<std::size_t channel_count_v>
+struct level_bank {
+   public:
+    static std::size_t const CHANNEL_COUNT = channel_count_v;
+
+    level_bank() { clear(); }
+
+    void clear() {
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            levels_[i] = 0;
+        }
+    }
+
+    void set(std::size_t index, uint8_t level) { levels_[index] = level; }
+    uint8_t get(std::size_t index) const { return levels_[index]; }
+
+    level_pin channel(std::size_t index) { return level_pin(&levels_[index]); }
+
+    uint8_t const* levels() const { return levels_; }
+
+   private:
+    uint8_t levels_[channel_count_v];
+};
+
+template<std::size_t channel_count_v>
+std::size_t const level_bank<channel_count_v>::CHANNEL_COUNT;
+
+/**
+ * @brief RGB frame for addressable strips and matrices, one plane per color
+ *
+ * Planar rather than interleaved: effects that compute a whole frame
+ * (pixel_shader) write each color as one contiguous run, which keeps their
+ * inner loops vectorizable. Drivers that need GRB or RGB byte order pack
+ * pixels with get() as they shift them out.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   rgb_bank<300> strip;
+ *   strip.set(0, 255, 80, 0);
+ *   uint32_t const rgb = strip.get(0);  // 0xFF5000
+ *
+ * @tparam pixel_count_v Number of pixels
+ */
+template<std::size_t pixel_count_v>
+struct rgb_bank {
+   public:
+    static std::size_t const PIXEL_COUNT = pixel_count_v;
+
+    rgb_bank() { clear(); }
+
+    void clear() {
+        for (std::size_t i = 0; i < pixel_count_v; ++i) {
+            red_[i] = green_[i] = blue_[i] = 0;
+        }
+    }
+
+    void set(std::size_t index, uint8_t red, uint8_t green, uint8_t blue) {
+        red_[index] = red;
+        green_[index] = green;
+        blue_[index] = blue;
+    }
+
+    /**
+     * @brief Pixel packed as 0xRRGGBB
+     */
+    uint32_t get(std::size_t index) const {
+        return static_cast<uint32_t>(red_[index]) << 16 |
+               static_cast<uint32_t>(green_[index]) << 8 | blue_[index];
+    }
+
+    uint8_t* red() { return red_; }
+    uint8_t* green() { return green_; }
+    uint8_t* blue() { return blue_; }
+    uint8_t const* red() const { return red_; }
+    uint8_t const* green() const { return green_; }
+    uint8_t const* blue() const { return blue_; }
+
+   private:
+    uint8_t red_[pixel_count_v];
+    uint8_t green_[pixel_count_v];
+    uint8_t blue_[pixel_count_v];
+};
+
+template<std::size_t pixel_count_v>
+std::size_t const rgb_bank<pixel_count_v>::PIXEL_COUNT;
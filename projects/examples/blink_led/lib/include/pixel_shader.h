@@ -0,0 +1,452 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Shader numbers are Q16.16 fixed point: SHADER_ONE is 1.0
+ */
+static int32_t const SHADER_ONE = 65536;
+
+/**
+ * @brief Shader operations (shared by the compiled program and the expression tree)
+ */
+enum class shader_op : uint8_t {
+    constant = 0,  // Scalar programs only: dst = value
+    add,
+    sub,
+    mul,
+    div,  // x / 0 = 0
+    mod,  // x % 0 = 0, sign of x
+    min,
+    max,
+    lt,  // 1.0 if a < b else 0
+    gt,
+    neg,
+    abs,
+    floor,
+    frac,  // x - floor(x), in [0, 1)
+    sin,   // Radians
+    cos,
+    wave,  // (sin(2 pi x) + 1) / 2: 0 to 1 and back once per unit
+    tri,   // Triangle 0 -> 1 -> 0 once per unit
+};
+
+/// Capacities of a compiled shader
+static std::size_t const SHADER_MAX_INSTRUCTIONS = 128;
+static std::size_t const SHADER_VECTOR_REGISTERS = 16;
+static std::size_t const SHADER_SCALAR_REGISTERS = 64;
+static uint8_t const SHADER_NO_REGISTER = 0xFF;
+
+/// Per-pixel inputs a shader can read
+enum class shader_input : uint8_t {
+    index = 0,  // Pixel number (exact up to 32767)
+    u = 1,      // index / pixel count, 0 to just under 1
+    x = 2,      // From shader_inputs::x (layout coordinates)
+    y = 3,
+};
+static std::size_t const SHADER_PIXEL_INPUTS = 4;
+
+/// Instruction operand flags: operand is a scalar register
+static uint8_t const SHADER_A_SCALAR = 1;
+static uint8_t const SHADER_B_SCALAR = 2;
+
+struct shader_instruction {
+    shader_op op;
+    uint8_t dst;
+    uint8_t a;
+    uint8_t b;
+    uint8_t flags;  // SHADER_A_SCALAR, SHADER_B_SCALAR
+    int32_t value;  // constant
+};
+
+/**
+ * @brief Compiled shader (shader_expression.h builds it)
+ *
+ * Two programs: the scalar one runs once per frame and computes constants
+ * and everything that depends only on t (scalar register 0); the vector
+ * one runs once per block of pixels, each instruction over the whole block.
+ */
+struct shader_program {
+    shader_instruction scalar_code[SHADER_MAX_INSTRUCTIONS];
+    shader_instruction vector_code[SHADER_MAX_INSTRUCTIONS];
+    uint8_t scalar_count;
+    uint8_t vector_count;
+    uint8_t input_register[SHADER_PIXEL_INPUTS];  // Vector register, or SHADER_NO_REGISTER
+    uint8_t output_register[3];                   // r, g, b
+    uint8_t output_scalar[3];                     // Output register is scalar
+};
+
+namespace shader_detail {
+
+// sin(2 pi i / 256) in Q16.16, 257 entries so interpolation needs no wrap
+inline int32_t const* sine_table() {
+    struct table {
+        table() {
+            for (int i = 0; i <= 256; ++i) {
+                double const s = std::sin(6.283185307179586 * i / 256.0) * SHADER_ONE;
+                values[i] = static_cast<int32_t>(s < 0 ? s - 0.5 : s + 0.5);
+            }
+        }
+        int32_t values[257];
+    };
+    static table const sine;
+    return sine.values;
+}
+
+// Sine of a phase in 1/65536 turns
+inline int32_t sine_turns(uint32_t phase) {
+    int32_t const* const table = sine_table();
+    uint32_t const index = (phase >> 8) & 0xFF;
+    int32_t const fraction = static_cast<int32_t>(phase & 0xFF);
+    return table[index] + (((table[index + 1] - table[index]) * fraction) >> 8);
+}
+
+// 1 / (2 pi) in Q16.16
+static int32_t const INV_TWO_PI = 10430;
+
+inline int32_t mul(int32_t a, int32_t b) {
+    return static_cast<int32_t>(static_cast<uint32_t>(
+        static_cast<uint64_t>(static_cast<int64_t>(a) * b) >> 16));
+}
+
+inline int32_t radians_to_turns(int32_t x) { return mul(x, INV_TWO_PI); }
+
+}  // namespace shader_detail
+
+/**
+ * @brief One shader operation on scalars; the vector kernels compute exactly this
+ */
+inline int32_t shader_apply(shader_op op, int32_t a, int32_t b) {
+    using namespace shader_detail;
+    switch (op) {
+        case shader_op::constant:
+            return a;
+        case shader_op::add:
+            return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+        case shader_op::sub:
+            return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+        case shader_op::mul:
+            return mul(a, b);
+        case shader_op::div:
+            return b == 0 ? 0
+                          : static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(
+                                (static_cast<int64_t>(a) * SHADER_ONE) / b)));
+        case shader_op::mod:
+            return b == 0 || (a == INT32_MIN && b == -1) ? 0 : a % b;
+        case shader_op::min:
+            return a < b ? a : b;
+        case shader_op::max:
+            return a > b ? a : b;
+        case shader_op::lt:
+            return a < b ? SHADER_ONE : 0;
+        case shader_op::gt:
+            return a > b ? SHADER_ONE : 0;
+        case shader_op::neg:
+            return static_cast<int32_t>(0u - static_cast<uint32_t>(a));
+        case shader_op::abs:
+            return a < 0 ? static_cast<int32_t>(0u - static_cast<uint32_t>(a)) : a;
+        case shader_op::floor:
+            return static_cast<int32_t>(static_cast<uint32_t>(a) & 0xFFFF0000u);
+        case shader_op::frac:
+            return a & 0xFFFF;
+        case shader_op::sin:
+            return sine_turns(static_cast<uint32_t>(radians_to_turns(a)));
+        case shader_op::cos:
+            return sine_turns(static_cast<uint32_t>(radians_to_turns(a)) + 0x4000);
+        case shader_op::wave:
+            return (sine_turns(static_cast<uint32_t>(a)) + SHADER_ONE) >> 1;
+        case shader_op::tri: {
+            int32_t const f = a & 0xFFFF;
+            return f < 0x8000 ? 2 * f : 2 * (SHADER_ONE - f);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief index / count in Q16.16 (the u input), identical for every evaluator
+ */
+inline int32_t shader_u(std::size_t index, std::size_t count) {
+    uint64_t const step = (static_cast<uint64_t>(1) << 32) / count;
+    return static_cast<int32_t>((index * step) >> 16);
+}
+
+/**
+ * @brief Level 0-255 from a Q16.16 color value clamped to [0, 1]
+ */
+inline uint8_t shader_level(int32_t value) {
+    int32_t const v = value < 0 ? 0 : (value > SHADER_ONE ? SHADER_ONE : value);
+    return static_cast<uint8_t>((v * 255 + 0x8000) >> 16);
+}
+
+/**
+ * @brief Per-frame inputs
+ */
+struct shader_inputs {
+    int32_t const* x;  // Q16.16 per pixel, or nullptr for 0
+    int32_t const* y;
+    int32_t time;  // t, seconds in Q16.16
+};
+
+/**
+ * @brief Q16.16 products of whole arrays: SSE2 or NEON, four per step
+ *
+ * SSE2 has no signed 32x32->64 multiply, so the unsigned products are
+ * corrected for negative operands; the result matches shader_apply() exactly.
+ */
+inline void shader_mul_array(int32_t* dst, int32_t const* a, int32_t const* b, std::size_t count) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        __m128i const x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i));
+        __m128i const y = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i));
+        __m128i const even = _mm_srli_epi64(_mm_mul_epu32(x, y), 16);
+        __m128i const odd =
+            _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32)), 16);
+        __m128i const product =
+            _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                               _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        __m128i const correction = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(x, 31), y),
+                                                 _mm_and_si128(_mm_srai_epi32(y, 31), x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_sub_epi32(product, _mm_slli_epi32(correction, 16)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= count; i += 4) {
+        int32x4_t const x = vld1q_s32(a + i);
+        int32x4_t const y = vld1q_s32(b + i);
+        int32x2_t const lo = vshrn_n_s64(vmull_s32(vget_low_s32(x), vget_low_s32(y)), 16);
+        int32x2_t const hi = vshrn_n_s64(vmull_s32(vget_high_s32(x), vget_high_s32(y)), 16);
+        vst1q_s32(dst + i, vcombine_s32(lo, hi));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = shader_detail::mul(a[i], b[i]);
+    }
+}
+
+/**
+ * @brief Evaluates compiled shaders over pixel arrays into an RGB frame
+ *
+ * The compiled program is register-based with whole-block registers:
+ * every instruction is one tight loop over block_v pixels (add, min, lt,
+ * frac... are plain loops the compiler vectorizes; products use
+ * shader_mul_array()). Decoding and dispatch are paid once per block
+ * instead of once per pixel and node, and work that depends only on t runs
+ * once per frame in the scalar program.
+ *
+ * Registers are block_v * 4 bytes each (16 of them): 16 KB for the default
+ * 256-pixel block on a host, 1 KB for a 16-pixel block on a small board.
+ *
+ * Usage:
+ *   shader_program program;
+ *   compile_shader("r = wave(u + t / 4); b = 1 - r", length, program, error);
+ *   pixel_shader<> shader;
+ *   shader_inputs const inputs = {nullptr, nullptr, t_q16};
+ *   shader.evaluate(program, inputs, strip.PIXEL_COUNT, strip.red(), strip.green(), strip.blue());
+ *
+ * @tparam block_v Pixels per block
+ */
+template<std::size_t block_v = 256>
+struct pixel_shader {
+   public:
+    static_assert(block_v >= 4 && block_v % 4 == 0, "block is a multiple of 4 pixels");
+
+    /**
+     * @brief Run the shader on count pixels, writing 0-255 levels per color plane (null skips one)
+     */
+    void evaluate(shader_program const& program, shader_inputs const& inputs, std::size_t count,
+                  uint8_t* red, uint8_t* green, uint8_t* blue) {
+        run_scalar(program, inputs.time);
+        uint8_t* const planes[3] = {red, green, blue};
+        for (std::size_t base = 0; base < count; base += block_v) {
+            std::size_t const n = count - base < block_v ? count - base : block_v;
+            load_inputs(program, inputs, base, n, count);
+            run_vector(program, n);
+            for (std::size_t c = 0; c < 3; ++c) {
+                if (planes[c] != nullptr) {
+                    store(program, c, planes[c] + base, n);
+                }
+            }
+        }
+    }
+
+   private:
+    void run_scalar(shader_program const& program, int32_t time) {
+        scalars_[0] = time;
+        for (std::size_t k = 0; k < program.scalar_count; ++k) {
+            shader_instruction const& in = program.scalar_code[k];
+            scalars_[in.dst] = in.op == shader_op::constant
+                                   ? in.value
+                                   : shader_apply(in.op, scalars_[in.a], scalars_[in.b]);
+        }
+    }
+
+    void load_inputs(shader_program const& program, shader_inputs const& inputs,
+                     std::size_t base, std::size_t n, std::size_t count) {
+        uint8_t const* const reg = program.input_register;
+        if (reg[0] != SHADER_NO_REGISTER) {
+            int32_t* const out = registers_[reg[0]];
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<int32_t>(static_cast<uint32_t>(base + i) << 16);
+            }
+        }
+        if (reg[1] != SHADER_NO_REGISTER) {
+            int32_t* const out = registers_[reg[1]];
+            uint64_t const step = (static_cast<uint64_t>(1) << 32) / count;
+            uint64_t position = base * step;
+            for (std::size_t i = 0; i < n; ++i, position += step) {
+                out[i] = static_cast<int32_t>(position >> 16);
+            }
+        }
+        int32_t const* const sources[2] = {inputs.x, inputs.y};
+        for (std::size_t k = 0; k < 2; ++k) {
+            if (reg[2 + k] == SHADER_NO_REGISTER) {
+                continue;
+            }
+            int32_t* const out = registers_[reg[2 + k]];
+            if (sources[k] != nullptr) {
+                std::memcpy(out, sources[k] + base, n * sizeof(int32_t));
+            } else {
+                std::memset(out, 0, n * sizeof(int32_t));
+            }
+        }
+    }
+
+    // Block-wide kernels: one loop per operand shape, op inlined
+    template<typename op_t>
+    void binary(shader_instruction const& in, std::size_t n) {
+        int32_t* const d = registers_[in.dst];
+        if (in.flags == 0) {
+            int32_t const* const a = registers_[in.a];
+            int32_t const* const b = registers_[in.b];
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] = op_t::apply(a[i], b[i]);
+            }
+        } else if (in.flags == SHADER_A_SCALAR) {
+            int32_t const a = scalars_[in.a];
+            int32_t const* const b = registers_[in.b];
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] = op_t::apply(a, b[i]);
+            }
+        } else {
+            int32_t const* const a = registers_[in.a];
+            int32_t const b = scalars_[in.b];
+            for (std::size_t i = 0; i < n; ++i) {
+                d[i] = op_t::apply(a[i], b);
+            }
+        }
+    }
+
+    template<typename op_t>
+    void unary(shader_instruction const& in, std::size_t n) {
+        int32_t* const d = registers_[in.dst];
+        int32_t const* const a = registers_[in.a];
+        for (std::size_t i = 0; i < n; ++i) {
+            d[i] = op_t::apply(a[i], 0);
+        }
+    }
+
+    template<shader_op op_v>
+    struct op {
+        static int32_t apply(int32_t a, int32_t b) { return shader_apply(op_v, a, b); }
+    };
+
+    void multiply(shader_instruction const& in, std::size_t n) {
+        int32_t const* a = registers_[in.a];
+        int32_t const* b = registers_[in.b];
+        if (in.flags != 0) {
+            int32_t const value = scalars_[in.flags == SHADER_A_SCALAR ? in.a : in.b];
+            for (std::size_t i = 0; i < n; ++i) {
+                broadcast_[i] = value;
+            }
+            (in.flags == SHADER_A_SCALAR ? a : b) = broadcast_;
+        }
+        shader_mul_array(registers_[in.dst], a, b, n);
+    }
+
+    void run_vector(shader_program const& program, std::size_t n) {
+        for (std::size_t k = 0; k < program.vector_count; ++k) {
+            shader_instruction const& in = program.vector_code[k];
+            switch (in.op) {
+                case shader_op::add:
+                    binary<op<shader_op::add> >(in, n);
+                    break;
+                case shader_op::sub:
+                    binary<op<shader_op::sub> >(in, n);
+                    break;
+                case shader_op::mul:
+                    multiply(in, n);
+                    break;
+                case shader_op::div:
+                    binary<op<shader_op::div> >(in, n);
+                    break;
+                case shader_op::mod:
+                    binary<op<shader_op::mod> >(in, n);
+                    break;
+                case shader_op::min:
+                    binary<op<shader_op::min> >(in, n);
+                    break;
+                case shader_op::max:
+                    binary<op<shader_op::max> >(in, n);
+                    break;
+                case shader_op::lt:
+                    binary<op<shader_op::lt> >(in, n);
+                    break;
+                case shader_op::gt:
+                    binary<op<shader_op::gt> >(in, n);
+                    break;
+                case shader_op::neg:
+                    unary<op<shader_op::neg> >(in, n);
+                    break;
+                case shader_op::abs:
+                    unary<op<shader_op::abs> >(in, n);
+                    break;
+                case shader_op::floor:
+                    unary<op<shader_op::floor> >(in, n);
+                    break;
+                case shader_op::frac:
+                    unary<op<shader_op::frac> >(in, n);
+                    break;
+                case shader_op::sin:
+                    unary<op<shader_op::sin> >(in, n);
+                    break;
+                case shader_op::cos:
+                    unary<op<shader_op::cos> >(in, n);
+                    break;
+                case shader_op::wave:
+                    unary<op<shader_op::wave> >(in, n);
+                    break;
+                case shader_op::tri:
+                    unary<op<shader_op::tri> >(in, n);
+                    break;
+                case shader_op::constant:
+                    break;
+            }
+        }
+    }
+
+    void store(shader_program const& program, std::size_t color, uint8_t* out, std::size_t n) {
+        uint8_t const reg = program.output_register[color];
+        if (program.output_scalar[color]) {
+            std::memset(out, shader_level(scalars_[reg]), n);
+            return;
+        }
+        int32_t const* const value = registers_[reg];
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = shader_level(value[i]);
+        }
+    }
+
+    int32_t registers_[SHADER_VECTOR_REGISTERS][block_v];
+    int32_t broadcast_[block_v];
+    int32_t scalars_[SHADER_SCALAR_REGISTERS];
+};
@@ -0,0 +1,273 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "output_bank.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace prng_detail {
+
+// Well-mixed, never-zero xorshift32 state for (seed, channel)
+inline uint32_t channel_state(uint32_t seed, uint32_t channel) {
+    uint32_t z = seed + channel * 0x9E3779B9u;
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    z ^= z >> 16;
+    return z == 0 ? 0x6D2B79F5u : z;
+}
+
+inline uint32_t xorshift(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+}  // namespace prng_detail
+
+/**
+ * @brief Independent, reproducible random streams, one per channel
+ *
+ * Each channel is a xorshift32 generator (4 bytes of state, period
+ * 2^32 - 1), stored as one contiguous array so a pass over every channel
+ * is a straight SIMD loop of shifts and xors: four channels per step with
+ * SSE2 or NEON, the same values with the scalar fallback. Channel c's
+ * stream depends only on (seed, c), so a show replays the same sparkles
+ * and one channel can be reseeded without disturbing the others.
+ *
+ * std::mt19937 per channel would be 2.5-5 KB of state each; this is 4 bytes.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   prng_bank<4096> random(show_seed);
+ *   uint32_t const r = random.next(17);       // One channel
+ *   random.draw_bits(threshold, bank.words());  // Every channel: bit = (value < threshold)
+ *
+ * @tparam channel_count_v Number of channels
+ */
+template<std::size_t channel_count_v>
+struct prng_bank {
+   public:
+    static std::size_t const CHANNEL_COUNT = channel_count_v;
+    static std::size_t const WORD_COUNT = (channel_count_v + 31) / 32;
+
+    explicit prng_bank(uint32_t seed) { reseed(seed); }
+
+    /**
+     * @brief Restart every channel's stream from seed
+     */
+    void reseed(uint32_t seed) {
+        for (std::size_t c = 0; c < PADDED; ++c) {
+            state_[c] = prng_detail::channel_state(seed, static_cast<uint32_t>(c));
+        }
+    }
+
+    /**
+     * @brief Restart one channel's stream (as reseed(seed) would for it)
+     */
+    void reseed_channel(std::size_t channel, uint32_t seed) {
+        state_[channel] = prng_detail::channel_state(seed, static_cast<uint32_t>(channel));
+    }
+
+    /**
+     * @brief Advance one channel and return its new value
+     */
+    uint32_t next(std::size_t channel) {
+        state_[channel] = prng_detail::xorshift(state_[channel]);
+        return state_[channel];
+    }
+
+    /**
+     * @brief Advance every channel once; values() then holds the new values
+     */
+    void step() {
+        std::size_t c = 0;
+#if defined(__SSE2__)
+        for (; c + 4 <= PADDED; c += 4) {
+            __m128i* const p = reinterpret_cast<__m128i*>(state_ + c);
+            _mm_storeu_si128(p, step4(_mm_loadu_si128(p)));
+        }
+#elif defined(__ARM_NEON)
+        for (; c + 4 <= PADDED; c += 4) {
+            vst1q_u32(state_ + c, step4(vld1q_u32(state_ + c)));
+        }
+#endif
+        for (; c < PADDED; ++c) {
+            state_[c] = prng_detail::xorshift(state_[c]);
+        }
+    }
+
+    /**
+     * @brief Advance every channel once and pack (value < threshold) into bits
+     *
+     * Channel c goes to words[c / 32], bit c % 32: the output_bank layout.
+     * Each channel's bit is set with probability threshold / 2^32.
+     */
+    void draw_bits(uint32_t threshold, uint32_t* words) {
+        for (std::size_t w = 0; w < WORD_COUNT; ++w) {
+            uint32_t* const state = state_ + w * 32;
+            uint32_t bits = 0;
+#if defined(__SSE2__)
+            __m128i const bias = _mm_set1_epi32(static_cast<int32_t>(0x80000000u));
+            __m128i const limit = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(threshold)),
+                                                bias);
+            for (std::size_t k = 0; k < 32; k += 4) {
+                __m128i* const p = reinterpret_cast<__m128i*>(state + k);
+                __m128i const value = step4(_mm_loadu_si128(p));
+                _mm_storeu_si128(p, value);
+                // Unsigned compare as signed, both sides offset by 2^31
+                __m128i const below = _mm_cmplt_epi32(_mm_xor_si128(value, bias), limit);
+                bits |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(below))) << k;
+            }
+#elif defined(__ARM_NEON)
+            uint32x4_t const limit = vdupq_n_u32(threshold);
+            uint32_t const weights_init[4] = {1, 2, 4, 8};
+            uint32x4_t const weights = vld1q_u32(weights_init);
+            for (std::size_t k = 0; k < 32; k += 4) {
+                uint32x4_t const value = step4(vld1q_u32(state + k));
+                vst1q_u32(state + k, value);
+                uint32x4_t const below = vandq_u32(vcltq_u32(value, limit), weights);
+                uint32x2_t const pairs = vadd_u32(vget_low_u32(below), vget_high_u32(below));
+                bits |= vget_lane_u32(vpadd_u32(pairs, pairs), 0) << k;
+            }
+#else
+            for (std::size_t k = 0; k < 32; ++k) {
+                state[k] = prng_detail::xorshift(state[k]);
+                bits |= static_cast<uint32_t>(state[k] < threshold) << k;
+            }
+#endif
+            words[w] = bits & word_mask(w);
+        }
+    }
+
+    uint32_t get(std::size_t channel) const { return state_[channel]; }
+    uint32_t const* values() const { return state_; }
+
+   private:
+    // Whole words of channels, so batch passes need no tail
+    static std::size_t const PADDED = WORD_COUNT * 32;
+
+    static uint32_t word_mask(std::size_t word) {
+        std::size_t const used = channel_count_v - word * 32;
+        return used >= 32 ? 0xFFFFFFFFu : (uint32_t(1) << used) - 1;
+    }
+
+#if defined(__SSE2__)
+    static __m128i step4(__m128i x) {
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    }
+#elif defined(__ARM_NEON)
+    static uint32x4_t step4(uint32x4_t x) {
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        return veorq_u32(x, vshlq_n_u32(x, 5));
+    }
+#endif
+
+    uint32_t state_[PADDED];
+};
+
+template<std::size_t channel_count_v>
+std::size_t const prng_bank<channel_count_v>::CHANNEL_COUNT;
+
+template<std::size_t channel_count_v>
+std::size_t const prng_bank<channel_count_v>::WORD_COUNT;
+
+template<std::size_t channel_count_v>
+std::size_t const prng_bank<channel_count_v>::PADDED;
+
+/**
+ * @brief How a sparkle pass changes the bank
+ */
+enum class sparkle_mode : uint8_t {
+    twinkle = 0,  // Drawn channels toggle: lights wander on and off
+    flash = 1,    // Exactly the drawn channels are on for one pass
+};
+
+/**
+ * @brief Random twinkle across a whole output_bank, one vectorized pass per interval
+ *
+ * Every interval, each channel is drawn with the given chance (from its
+ * own prng_bank stream) and the drawn channels toggle or flash. The
+ * decision for 32 channels is one word of bits, written straight into the
+ * bank, so thousands of channels cost a few microseconds per pass.
+ *
+ * Usage:
+ *   output_bank<2048> bank;
+ *   sparkle_controller<2048> sparkle(bank, seed, 50, 1300);  // 50 ms, 2% chance
+ *   sparkle.update(millis());
+ *
+ * @tparam channel_count_v Number of channels (matches the bank)
+ */
+template<std::size_t channel_count_v>
+struct sparkle_controller {
+   public:
+    /**
+     * @param bank Output bank to sparkle (every channel)
+     * @param seed Stream seed; the same seed replays the same sparkles
+     * @param interval_ms Time between passes
+     * @param chance Chance per channel per pass, in 1/65536 (0-65535)
+     * @param mode Toggle or flash the drawn channels
+     */
+    sparkle_controller(output_bank<channel_count_v>& bank, uint32_t seed, uint32_t interval_ms,
+                       uint16_t chance, sparkle_mode mode = sparkle_mode::twinkle)
+        : bank_(bank),
+          random_(seed),
+          interval_ms_(interval_ms == 0 ? 1 : interval_ms),
+          threshold_(static_cast<uint32_t>(chance) << 16),
+          mode_(mode),
+          last_pass_ms_(0),
+          started_(false) {}
+
+    /**
+     * @brief Run a pass if an interval has elapsed (at most one per call)
+     *
+     * @return true if a pass ran
+     */
+    bool update(uint32_t current_time_ms) {
+        if (started_ && current_time_ms - last_pass_ms_ < interval_ms_) {
+            return false;
+        }
+        started_ = true;
+        last_pass_ms_ = current_time_ms;
+        pass();
+        return true;
+    }
+
+    /**
+     * @brief Draw every channel once and apply the result to the bank
+     */
+    void pass() {
+        uint32_t* const words = bank_.words();
+        if (mode_ == sparkle_mode::flash) {
+            random_.draw_bits(threshold_, words);
+            return;
+        }
+        random_.draw_bits(threshold_, drawn_);
+        for (std::size_t w = 0; w < output_bank<channel_count_v>::WORD_COUNT; ++w) {
+            words[w] ^= drawn_[w];
+        }
+    }
+
+    void set_chance(uint16_t chance) { threshold_ = static_cast<uint32_t>(chance) << 16; }
+    void set_mode(sparkle_mode mode) { mode_ = mode; }
+    prng_bank<channel_count_v>& get_random() { return random_; }
+
+   private:
+    output_bank<channel_count_v>& bank_;
+    prng_bank<channel_count_v> random_;
+    uint32_t drawn_[output_bank<channel_count_v>::WORD_COUNT];
+    uint32_t interval_ms_;
+    uint32_t threshold_;
+    sparkle_mode mode_;
+    uint32_t last_pass_ms_;
+    bool started_;
+};
@@ -0,0 +1,174 @@
+#pragma once
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief What the real-time profile should attempt
+ *
+ * Every step is optional and independent; a step that is not permitted
+ * (no CAP_IPC_LOCK / CAP_SYS_NICE, restricted cpuset, ...) is skipped and
+ * reported, never fatal.
+ */
+struct realtime_config {
+    bool lock_memory = true;                         // mlockall(MCL_CURRENT | MCL_FUTURE)
+    std::size_t prefault_stack_bytes = 256 * 1024;   // Touch this much stack up front
+    std::size_t prefault_heap_bytes = 8 * 1024 * 1024;  // Reserve and touch this much heap
+    int cpu = -1;                                    // Pin calling thread (-1 = don't pin)
+    int fifo_priority = 80;                          // SCHED_FIFO priority (0 = don't change)
+};
+
+/**
+ * @brief Outcome of each step (errno of the failure, 0 on success or skip)
+ */
+struct realtime_status {
+    bool memory_locked = false;
+    bool stack_prefaulted = false;
+    bool heap_prefaulted = false;
+    bool cpu_pinned = false;
+    bool fifo_scheduling = false;
+    int lock_error = 0;
+    int affinity_error = 0;
+    int scheduler_error = 0;
+
+    /**
+     * @brief True when every requested step succeeded
+     */
+    bool complete(realtime_config const& config) const {
+        return (!config.lock_memory || memory_locked) &&
+               (config.prefault_stack_bytes == 0 || stack_prefaulted) &&
+               (config.prefault_heap_bytes == 0 || heap_prefaulted) &&
+               (config.cpu < 0 || cpu_pinned) && (config.fifo_priority <= 0 || fifo_scheduling);
+    }
+};
+
+namespace realtime_detail {
+
+/**
+ * @brief Touch a block of stack so later deep calls don't page-fault
+ *
+ * Kept out of line so the alloca() block is carved from the real stack and
+ * released again on return.
+ */
+__attribute__((noinline)) inline bool prefault_stack(std::size_t bytes) {
+    std::size_t const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    volatile char* const block = static_cast<volatile char*>(alloca(bytes));
+    for (std::size_t i = 0; i < bytes; i += page) {
+        block[i] = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Grow the heap, touch it, and keep it mapped after free()
+ *
+ * Disabling trimming and mmap-backed allocations keeps the touched pages in
+ * the malloc arena, so later allocations reuse resident (and, with
+ * mlockall, locked) memory instead of faulting.
+ */
+inline bool prefault_heap(std::size_t bytes) {
+    if (::mallopt(M_TRIM_THRESHOLD, -1) == 0 || ::mallopt(M_MMAP_MAX, 0) == 0) {
+        return false;
+    }
+    char* const block = static_cast<char*>(std::malloc(bytes));
+    if (block == nullptr) {
+        return false;
+    }
+    std::size_t const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    for (std::size_t i = 0; i < bytes; i += page) {
+        static_cast<volatile char*>(block)[i] = 0;
+    }
+    std::free(block);
+    return true;
+}
+
+}  // namespace realtime_detail
+
+/**
+ * @brief Opt-in real-time execution profile for the calling (tick) thread
+ *
+ * Removes the two main sources of tick-loop latency spikes on a Linux show
+ * host: page faults (mlockall + prefaulted stack/heap) and scheduler
+ * preemption (CPU pinning + SCHED_FIFO). Call once from the tick thread
+ * before entering the loop. Steps that are not permitted fall back to normal
+ * behavior and are reported in the returned status.
+ *
+ * Linux only.
+ *
+ * Usage:
+ *   realtime_config config;
+ *   config.cpu = 2;
+ *   realtime_status status = apply_realtime_profile(config);
+ *   if (!status.fifo_scheduling) { ... running best-effort ... }
+ *
+ * @param config Steps to attempt
+ * @return realtime_status Which steps succeeded
+ */
+inline realtime_status apply_realtime_profile(realtime_config const& config) {
+    realtime_status status;
+
+    if (config.lock_memory) {
+        if (::mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            status.memory_locked = true;
+        } else {
+            status.lock_error = errno;
+        }
+    }
+    if (config.prefault_heap_bytes > 0) {
+        status.heap_prefaulted = realtime_detail::prefault_heap(config.prefault_heap_bytes);
+    }
+    if (config.prefault_stack_bytes > 0) {
+        status.stack_prefaulted = realtime_detail::prefault_stack(config.prefault_stack_bytes);
+    }
+
+    if (config.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config.cpu, &set);
+        int const result = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        if (result == 0) {
+            status.cpu_pinned = true;
+        } else {
+            status.affinity_error = result;
+        }
+    }
+
+    if (config.fifo_priority > 0) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = config.fifo_priority;
+        int const result = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param);
+        if (result == 0) {
+            status.fifo_scheduling = true;
+        } else {
+            status.scheduler_error = result;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Undo the scheduling parts of the profile for the calling thread
+ *
+ * Returns to SCHED_OTHER and unlocks memory. Affinity is left as is.
+ */
+inline void release_realtime_profile(realtime_status const& status) {
+    if (status.fifo_scheduling) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        ::pthread_setschedparam(::pthread_self(), SCHED_OTHER, &param);
+    }
+    if (status.memory_locked) {
+        ::munlockall();
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Sequence counter for single-writer, many-reader consistent snapshots
+ *
+ * The writer never blocks: it bumps the counter to odd, writes, then bumps it
+ * back to even. Readers copy the protected data and retry if the counter was
+ * odd or changed while they were copying.
+ *
+ * The protected data must itself be accessed through relaxed atomics (see
+ * seqlock_store/seqlock_load below) so concurrent copies are well-defined
+ * and ThreadSanitizer-clean. std::atomic<uint32_t> is lock-free and
+ * address-free, so a seqlock and its words may also live in shared memory.
+ *
+ * Writer:
+ *   lock.write_begin();
+ *   seqlock_store(words[i], value);
+ *   lock.write_end();
+ *
+ * Reader:
+ *   uint32_t seq;
+ *   do {
+ *       seq = lock.read_begin();
+ *       value = seqlock_load(words[i]);
+ *   } while (lock.read_retry(seq));
+ */
+struct seqlock {
+   public:
+    seqlock() : sequence_(0) {}
+
+    /**
+     * @brief Start a write section (single writer only)
+     */
+    void write_begin() {
+        uint32_t const seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /**
+     * @brief End a write section, publishing everything written since write_begin()
+     */
+    void write_end() {
+        uint32_t const seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Start a read section
+     *
+     * Spins while a write is in progress, so the returned value is always even.
+     *
+     * @return uint32_t Sequence to pass to read_retry()
+     */
+    uint32_t read_begin() const {
+        uint32_t seq = sequence_.load(std::memory_order_acquire);
+        while ((seq & 1u) != 0) {
+            seq = sequence_.load(std::memory_order_acquire);
+        }
+        return seq;
+    }
+
+    /**
+     * @brief Start a read section without waiting for the writer
+     *
+     * @param start Receives the sequence to pass to read_retry()
+     * @return false A write is in progress; try again later
+     */
+    bool try_read_begin(uint32_t& start) const {
+        start = sequence_.load(std::memory_order_acquire);
+        return (start & 1u) == 0;
+    }
+
+    /**
+     * @brief Check whether the data read since read_begin() may be torn
+     *
+     * @param start Value returned by read_begin()
+     * @return true Data changed during the read; copy again
+     */
+    bool read_retry(uint32_t start) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) != start;
+    }
+
+    /**
+     * @brief Current sequence (even when idle, odd while writing)
+     */
+    uint32_t sequence() const { return sequence_.load(std::memory_order_acquire); }
+
+   private:
+    std::atomic<uint32_t> sequence_;
+};
+
+/**
+ * @brief Write one seqlock-protected word (inside write_begin/write_end)
+ */
+inline void seqlock_store(std::atomic<uint32_t>& word, uint32_t value) {
+    word.store(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Read one seqlock-protected word (inside read_begin/read_retry)
+ */
+inline uint32_t seqlock_load(std::atomic<uint32_t> const& word) {
+    return word.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copy a block of seqlock-protected words (inside read_begin/read_retry)
+ */
+inline void seqlock_copy(std::atomic<uint32_t> const* words, uint32_t* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = words[i].load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,343 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "cobs.h"
+#include "crc16.h"
+
+/**
+ * @brief Binary serial command protocol for controllers
+ *
+ * Wire format: COBS(body + crc16_le) 0x00
+ *
+ *   body = [type:1][seq:1][channel:1][payload...]
+ *   crc  = CRC-16/CCITT-FALSE over body, little-endian
+ *
+ * Commands (host -> board), payload integers little-endian:
+ *   set_durations  on_ms:u32 off_ms:u32   Latched at the next edge
+ *   shift_phase    delta_ms:i32           Moves the pending edge
+ *   trigger        -                      Restart the pattern now (OFF phase)
+ *   query          -                      Reply with state
+ *
+ * Output frames (frame_stream.h) use keyframe/delta_frame.
+ *
+ * Replies (board -> host) echo seq and channel:
+ *   ack            status:u8
+ *   state          on:u8 on_ms:u32 off_ms:u32 until_toggle_ms:u32
+ *
+ * Frames failing CRC or COBS are dropped silently (their seq cannot be
+ * trusted); the host retries on timeout.
+ */
+enum class serial_message : uint8_t {
+    set_durations = 0x01,
+    shift_phase = 0x02,
+    trigger = 0x03,
+    query = 0x04,
+    keyframe = 0x10,
+    delta_frame = 0x11,
+    ack = 0x81,
+    state = 0x84
+};
+
+enum class serial_status : uint8_t {
+    ok = 0,
+    bad_channel = 1,
+    bad_length = 2,
+    unknown_command = 3,
+    unknown_reference = 4
+};
+
+/**
+ * @brief Zero-copy view of one validated frame body
+ *
+ * payload points into the decoder's buffer and is valid until the next
+ * byte is fed.
+ */
+struct serial_frame {
+    static std::size_t const HEADER_SIZE = 3;
+    static std::size_t const CRC_SIZE = 2;
+
+    serial_message type;
+    uint8_t seq;
+    uint8_t channel;
+    uint8_t const* payload;
+    std::size_t payload_size;
+
+    uint32_t read_u32(std::size_t offset) const {
+        return static_cast<uint32_t>(payload[offset]) |
+               (static_cast<uint32_t>(payload[offset + 1]) << 8) |
+               (static_cast<uint32_t>(payload[offset + 2]) << 16) |
+               (static_cast<uint32_t>(payload[offset + 3]) << 24);
+    }
+};
+
+/**
+ * @brief Incremental frame parser: COBS decode + CRC check, one byte at a time
+ *
+ * Runs on AVR with a small fixed buffer (default fits the largest command)
+ * and on the host for replies. No heap, no STL.
+ *
+ * Usage:
+ *   serial_parser<> parser;
+ *   serial_frame frame;
+ *   if (parser.push(byte, frame)) { dispatch(frame); }
+ *
+ * @tparam capacity_v Largest decoded body + CRC in bytes
+ */
+template<std::size_t capacity_v = 24>
+struct serial_parser {
+   public:
+    serial_parser() : frames_(0), crc_errors_(0), framing_errors_(0) {}
+
+    /**
+     * @brief Feed one received byte
+     *
+     * @param byte Next byte from the line
+     * @param frame Filled when a valid frame completes
+     * @return true frame holds a CRC-checked frame
+     */
+    bool push(uint8_t byte, serial_frame& frame) {
+        typename cobs_decoder<capacity_v>::result const result = decoder_.push(byte);
+        if (result == cobs_decoder<capacity_v>::error) {
+            ++framing_errors_;
+            return false;
+        }
+        if (result != cobs_decoder<capacity_v>::frame) {
+            return false;
+        }
+
+        std::size_t const size = decoder_.size();
+        if (size < serial_frame::HEADER_SIZE + serial_frame::CRC_SIZE) {
+            ++framing_errors_;
+            return false;
+        }
+        uint8_t const* const data = decoder_.data();
+        std::size_t const body_size = size - serial_frame::CRC_SIZE;
+        uint16_t const expected =
+            static_cast<uint16_t>(data[body_size] | (data[body_size + 1] << 8));
+        if (crc16(data, body_size) != expected) {
+            ++crc_errors_;
+            return false;
+        }
+
+        frame.type = static_cast<serial_message>(data[0]);
+        frame.seq = data[1];
+        frame.channel = data[2];
+        frame.payload = data + serial_frame::HEADER_SIZE;
+        frame.payload_size = body_size - serial_frame::HEADER_SIZE;
+        ++frames_;
+        return true;
+    }
+
+    uint32_t get_frame_count() const { return frames_; }
+    uint32_t get_crc_errors() const { return crc_errors_; }
+    uint32_t get_framing_errors() const { return framing_errors_; }
+
+   private:
+    cobs_decoder<capacity_v> decoder_;
+    uint32_t frames_;
+    uint32_t crc_errors_;
+    uint32_t framing_errors_;
+};
+
+/**
+ * @brief Builds frames into a caller-provided buffer (no heap)
+ *
+ * Usage:
+ *   serial_frame_builder<24> builder;
+ *   builder.begin(serial_message::set_durations, seq, channel);
+ *   builder.put_u32(on_ms);
+ *   builder.put_u32(off_ms);
+ *   std::size_t n = builder.finish(wire, sizeof(wire));  // COBS + 0x00, ready to send
+ *
+ * @tparam capacity_v Largest body in bytes (before CRC)
+ */
+template<std::size_t capacity_v = 24>
+struct serial_frame_builder {
+   public:
+    static std::size_t const MAX_WIRE_SIZE = capacity_v + serial_frame::CRC_SIZE +
+                                             (capacity_v + serial_frame::CRC_SIZE) / 254 + 2;
+
+    serial_frame_builder() : length_(0), overflow_(false) {}
+
+    void begin(serial_message type, uint8_t seq, uint8_t channel) {
+        length_ = 0;
+        overflow_ = false;
+        put_u8(static_cast<uint8_t>(type));
+        put_u8(seq);
+        put_u8(channel);
+    }
+
+    void put_u8(uint8_t value) {
+        if (length_ >= capacity_v) {
+            overflow_ = true;
+            return;
+        }
+        body_[length_++] = value;
+    }
+
+    void put_u32(uint32_t value) {
+        put_u8(static_cast<uint8_t>(value));
+        put_u8(static_cast<uint8_t>(value >> 8));
+        put_u8(static_cast<uint8_t>(value >> 16));
+        put_u8(static_cast<uint8_t>(value >> 24));
+    }
+
+    void put_bytes(uint8_t const* data, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            put_u8(data[i]);
+        }
+    }
+
+    /**
+     * @brief Append the CRC, COBS-encode and delimit
+     *
+     * @param wire Output buffer (MAX_WIRE_SIZE always suffices)
+     * @param capacity Size of wire
+     * @return std::size_t Bytes to send, 0 on overflow
+     */
+    std::size_t finish(uint8_t* wire, std::size_t capacity) {
+        if (overflow_) {
+            return 0;
+        }
+        uint16_t const crc = crc16(body_, length_);
+        body_[length_] = static_cast<uint8_t>(crc);
+        body_[length_ + 1] = static_cast<uint8_t>(crc >> 8);
+        std::size_t const encoded =
+            cobs_encode(body_, length_ + serial_frame::CRC_SIZE, wire, capacity);
+        if (encoded == 0 || encoded >= capacity) {
+            return 0;
+        }
+        wire[encoded] = 0;
+        return encoded + 1;
+    }
+
+   private:
+    uint8_t body_[capacity_v + serial_frame::CRC_SIZE];
+    std::size_t length_;
+    bool overflow_;
+};
+
+template<std::size_t capacity_v>
+std::size_t const serial_frame_builder<capacity_v>::MAX_WIRE_SIZE;
+
+/**
+ * @brief Board-side endpoint: parses commands and applies them to controllers
+ *
+ * Reads whatever the serial port has buffered on each poll() (never waits),
+ * applies commands to an array of controllers and writes replies. On AVR
+ * pass HardwareSerial; on the host any type with available()/read()/write().
+ *
+ * Usage (Arduino loop):
+ *   serial_command_server<blink_controller<LEDPin>, HardwareSerial> server(controllers, 4, Serial);
+ *   void loop() {
+ *       uint32_t const now = millis();
+ *       server.poll(now);
+ *       for (...) controllers[i].update(now);
+ *   }
+ *
+ * @tparam controller_t blink_controller-like type
+ * @tparam serial_t Type with int available(), int read(), write(uint8_t const*, size_t)
+ */
+template<typename controller_t, typename serial_t>
+struct serial_command_server {
+   public:
+    serial_command_server(controller_t* controllers, uint8_t count, serial_t& serial)
+        : controllers_(controllers), count_(count), serial_(serial), commands_(0) {}
+
+    /**
+     * @brief Drain buffered input and handle complete commands
+     *
+     * @param now_ms Controller clock, used by trigger and query
+     */
+    void poll(uint32_t now_ms) {
+        while (serial_.available() > 0) {
+            int const byte = serial_.read();
+            if (byte < 0) {
+                break;
+            }
+            feed(static_cast<uint8_t>(byte), now_ms);
+        }
+    }
+
+    /**
+     * @brief Handle one received byte (for byte-at-a-time sources)
+     */
+    void feed(uint8_t byte, uint32_t now_ms) {
+        serial_frame frame;
+        if (parser_.push(byte, frame)) {
+            handle(frame, now_ms);
+        }
+    }
+
+    uint32_t get_command_count() const { return commands_; }
+    serial_parser<> const& get_parser() const { return parser_; }
+
+   private:
+    void handle(serial_frame const& frame, uint32_t now_ms) {
+        ++commands_;
+        if (frame.channel >= count_) {
+            reply_ack(frame, serial_status::bad_channel);
+            return;
+        }
+        controller_t& controller = controllers_[frame.channel];
+        switch (frame.type) {
+            case serial_message::set_durations:
+                if (frame.payload_size != 8) {
+                    reply_ack(frame, serial_status::bad_length);
+                    return;
+                }
+                controller.set_durations(frame.read_u32(0), frame.read_u32(4));
+                reply_ack(frame, serial_status::ok);
+                return;
+            case serial_message::shift_phase:
+                if (frame.payload_size != 4) {
+                    reply_ack(frame, serial_status::bad_length);
+                    return;
+                }
+                controller.shift_phase(static_cast<int32_t>(frame.read_u32(0)));
+                reply_ack(frame, serial_status::ok);
+                return;
+            case serial_message::trigger:
+                controller.restart(now_ms);
+                reply_ack(frame, serial_status::ok);
+                return;
+            case serial_message::query:
+                reply_state(frame, controller, now_ms);
+                return;
+            default:
+                reply_ack(frame, serial_status::unknown_command);
+                return;
+        }
+    }
+
+    void reply_ack(serial_frame const& frame, serial_status status) {
+        builder_.begin(serial_message::ack, frame.seq, frame.channel);
+        builder_.put_u8(static_cast<uint8_t>(status));
+        send();
+    }
+
+    void reply_state(serial_frame const& frame, controller_t const& controller, uint32_t now_ms) {
+        builder_.begin(serial_message::state, frame.seq, frame.channel);
+        builder_.put_u8(controller.is_on() ? 1 : 0);
+        builder_.put_u32(controller.get_next_on_duration());
+        builder_.put_u32(controller.get_next_off_duration());
+        builder_.put_u32(controller.time_until_toggle(now_ms));
+        send();
+    }
+
+    void send() {
+        uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+        std::size_t const length = builder_.finish(wire, sizeof(wire));
+        if (length > 0) {
+            serial_.write(wire, length);
+        }
+    }
+
+    controller_t* controllers_;
+    uint8_t count_;
+    serial_t& serial_;
+    serial_parser<> parser_;
+    serial_frame_builder<> builder_;
+    uint32_t commands_;
+};
@@ -0,0 +1,720 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "pixel_shader.h"
+
+/**
+ * @brief Where and why a shader failed to compile
+ */
+struct shader_error {
+    uint32_t line;        // 1-based
+    uint32_t column;      // 1-based
+    char const* message;  // String literal
+};
+
+/// Expression tree, name and nesting capacities
+static std::size_t const SHADER_MAX_NODES = 256;
+static std::size_t const SHADER_MAX_NAMES = 16;
+static std::size_t const SHADER_MAX_DEPTH = 32;  // Nested (), calls and unary minus
+static uint16_t const SHADER_NO_NODE = 0xFFFF;
+
+enum class shader_node_kind : uint8_t {
+    constant,
+    input,  // Per-pixel input (shader_input in value)
+    time,
+    operation,
+};
+
+/**
+ * @brief Expression tree node; children always come before their parents
+ */
+struct shader_node {
+    shader_node_kind kind;
+    shader_op op;
+    uint16_t a;
+    uint16_t b;
+    int32_t value;  // constant, or shader_input
+};
+
+/**
+ * @brief Parsed shader: a tree (sharing assigned variables) per color
+ */
+struct shader_expression {
+    shader_node nodes[SHADER_MAX_NODES];
+    uint16_t count;
+    uint16_t output[3];  // r, g, b root node, or SHADER_NO_NODE for 0
+};
+
+namespace shader_detail {
+
+struct function_name {
+    char const* name;
+    shader_op op;
+    uint8_t arguments;
+};
+
+static function_name const FUNCTIONS[] = {
+    {"sin", shader_op::sin, 1},     {"cos", shader_op::cos, 1},
+    {"wave", shader_op::wave, 1},   {"tri", shader_op::tri, 1},
+    {"frac", shader_op::frac, 1},   {"floor", shader_op::floor, 1},
+    {"abs", shader_op::abs, 1},     {"min", shader_op::min, 2},
+    {"max", shader_op::max, 2},
+};
+
+inline bool is_binary(shader_op op) {
+    return op == shader_op::add || op == shader_op::sub || op == shader_op::mul ||
+           op == shader_op::div || op == shader_op::mod || op == shader_op::min ||
+           op == shader_op::max || op == shader_op::lt || op == shader_op::gt;
+}
+
+// Recursive descent parser; the first error stops everything
+struct parser {
+    struct variable {
+        char const* name;
+        std::size_t length;
+        uint16_t node;
+    };
+
+    parser(char const* text, std::size_t length, shader_expression& out, shader_error& error)
+        : text_(text),
+          end_(text + length),
+          p_(text),
+          out_(out),
+          error_(error),
+          variable_count_(0),
+          depth_(0),
+          time_node_(SHADER_NO_NODE) {
+        out_.count = 0;
+        for (std::size_t k = 0; k < 3; ++k) {
+            out_.output[k] = SHADER_NO_NODE;
+        }
+        for (std::size_t k = 0; k < SHADER_PIXEL_INPUTS; ++k) {
+            input_node_[k] = SHADER_NO_NODE;
+        }
+        error_.line = 0;
+        error_.column = 0;
+        error_.message = nullptr;
+    }
+
+    bool parse() {
+        while (true) {
+            skip_blanks();
+            if (p_ == end_) {
+                return true;
+            }
+            if (*p_ == '\n' || *p_ == ';') {
+                ++p_;
+                continue;
+            }
+            if (!statement()) {
+                return false;
+            }
+            skip_blanks();
+            if (p_ != end_ && *p_ != '\n' && *p_ != ';') {
+                return fail("expected end of statement");
+            }
+        }
+    }
+
+   private:
+    bool fail(char const* message) {
+        if (error_.message == nullptr) {
+            error_.line = 1;
+            char const* line_start = text_;
+            for (char const* c = text_; c < p_; ++c) {
+                if (*c == '\n') {
+                    ++error_.line;
+                    line_start = c + 1;
+                }
+            }
+            error_.column = static_cast<uint32_t>(p_ - line_start) + 1;
+            error_.message = message;
+        }
+        return false;
+    }
+
+    // Spaces and comments, not newlines (they end statements)
+    void skip_blanks() {
+        while (p_ != end_) {
+            if (*p_ == ' ' || *p_ == '\t' || *p_ == '\r') {
+                ++p_;
+            } else if (*p_ == '#') {
+                while (p_ != end_ && *p_ != '\n') {
+                    ++p_;
+                }
+            } else {
+                return;
+            }
+        }
+    }
+
+    bool accept(char c) {
+        skip_blanks();
+        if (p_ != end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    static bool is_letter(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+    static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+    bool identifier(char const*& name, std::size_t& length) {
+        skip_blanks();
+        if (p_ == end_ || !is_letter(*p_)) {
+            return false;
+        }
+        name = p_;
+        while (p_ != end_ && (is_letter(*p_) || is_digit(*p_))) {
+            ++p_;
+        }
+        length = static_cast<std::size_t>(p_ - name);
+        return true;
+    }
+
+    static bool same(char const* name, std::size_t length, char const* word) {
+        std::size_t i = 0;
+        for (; i < length; ++i) {
+            if (word[i] != name[i]) {
+                return false;
+            }
+        }
+        return word[i] == '\0';
+    }
+
+    uint16_t add(shader_node_kind kind, shader_op op, uint16_t a, uint16_t b, int32_t value) {
+        if (out_.count == SHADER_MAX_NODES) {
+            fail("shader too long");
+            return SHADER_NO_NODE;
+        }
+        shader_node& node = out_.nodes[out_.count];
+        node.kind = kind;
+        node.op = op;
+        node.a = a;
+        node.b = b;
+        node.value = value;
+        return out_.count++;
+    }
+
+    uint16_t constant(int32_t value) {
+        return add(shader_node_kind::constant, shader_op::constant, 0, 0, value);
+    }
+
+    // Operation node, folded when every operand is a constant
+    uint16_t operation(shader_op op, uint16_t a, uint16_t b) {
+        if (a == SHADER_NO_NODE || (is_binary(op) && b == SHADER_NO_NODE)) {
+            return SHADER_NO_NODE;
+        }
+        shader_node const& x = out_.nodes[a];
+        if (x.kind == shader_node_kind::constant) {
+            if (!is_binary(op)) {
+                return constant(shader_apply(op, x.value, 0));
+            }
+            if (out_.nodes[b].kind == shader_node_kind::constant) {
+                return constant(shader_apply(op, x.value, out_.nodes[b].value));
+            }
+        }
+        return add(shader_node_kind::operation, op, a, is_binary(op) ? b : 0, 0);
+    }
+
+    bool statement() {
+        char const* name;
+        std::size_t length;
+        char const* const start = p_;
+        if (!identifier(name, length)) {
+            return fail("expected: <name> = <expression>");
+        }
+        if (!accept('=')) {
+            p_ = start;
+            return fail("expected: <name> = <expression>");
+        }
+        uint16_t const value = expression();
+        if (value == SHADER_NO_NODE) {
+            return false;
+        }
+        char const* const outputs[3] = {"r", "g", "b"};
+        for (std::size_t k = 0; k < 3; ++k) {
+            if (same(name, length, outputs[k])) {
+                out_.output[k] = value;
+            }
+        }
+        for (std::size_t v = 0; v < variable_count_; ++v) {
+            if (variables_[v].length == length && matches(variables_[v], name, length)) {
+                variables_[v].node = value;
+                return true;
+            }
+        }
+        if (reserved(name, length)) {
+            p_ = start;
+            return fail("cannot assign to an input or function");
+        }
+        if (variable_count_ == SHADER_MAX_NAMES) {
+            p_ = start;
+            return fail("too many variables");
+        }
+        variables_[variable_count_].name = name;
+        variables_[variable_count_].length = length;
+        variables_[variable_count_].node = value;
+        ++variable_count_;
+        return true;
+    }
+
+    static bool matches(variable const& v, char const* name, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            if (v.name[i] != name[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool reserved(char const* name, std::size_t length) {
+        char const* const words[] = {"index", "u", "x", "y", "t", "PI"};
+        for (std::size_t k = 0; k < sizeof(words) / sizeof(words[0]); ++k) {
+            if (same(name, length, words[k])) {
+                return true;
+            }
+        }
+        for (std::size_t k = 0; k < sizeof(FUNCTIONS) / sizeof(FUNCTIONS[0]); ++k) {
+            if (same(name, length, FUNCTIONS[k].name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint16_t expression() {
+        uint16_t left = additive();
+        while (left != SHADER_NO_NODE) {
+            if (accept('<')) {
+                left = operation(shader_op::lt, left, additive());
+            } else if (accept('>')) {
+                left = operation(shader_op::gt, left, additive());
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    uint16_t additive() {
+        uint16_t left = term();
+        while (left != SHADER_NO_NODE) {
+            if (accept('+')) {
+                left = operation(shader_op::add, left, term());
+            } else if (accept('-')) {
+                left = operation(shader_op::sub, left, term());
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    uint16_t term() {
+        uint16_t left = unary();
+        while (left != SHADER_NO_NODE) {
+            if (accept('*')) {
+                left = operation(shader_op::mul, left, unary());
+            } else if (accept('/')) {
+                left = operation(shader_op::div, left, unary());
+            } else if (accept('%')) {
+                left = operation(shader_op::mod, left, unary());
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    // Every recursion passes through here, so this bounds the parser's stack use
+    uint16_t unary() {
+        if (depth_ == SHADER_MAX_DEPTH) {
+            fail("expression nested too deeply");
+            return SHADER_NO_NODE;
+        }
+        ++depth_;
+        uint16_t const node = accept('-') ? operation(shader_op::neg, unary(), 0) : primary();
+        --depth_;
+        return node;
+    }
+
+    // "12", "0.25", ".5": Q16.16, below 32768 (fractions rounding up to it included)
+    uint16_t number() {
+        char const* const start = p_;
+        int64_t whole = 0;
+        while (p_ != end_ && is_digit(*p_)) {
+            whole = whole * 10 + (*p_ - '0');
+            if (whole > 32767) {
+                p_ = start;
+                fail("number too large");
+                return SHADER_NO_NODE;
+            }
+            ++p_;
+        }
+        int64_t fraction = 0;
+        int64_t scale = 1;
+        if (p_ != end_ && *p_ == '.') {
+            ++p_;
+            while (p_ != end_ && is_digit(*p_)) {
+                if (scale < 1000000000) {
+                    fraction = fraction * 10 + (*p_ - '0');
+                    scale *= 10;
+                }
+                ++p_;
+            }
+        }
+        int64_t const value = whole * SHADER_ONE + (fraction * SHADER_ONE + scale / 2) / scale;
+        if (value >= int64_t(32768) * SHADER_ONE) {
+            p_ = start;
+            fail("number too large");
+            return SHADER_NO_NODE;
+        }
+        return constant(static_cast<int32_t>(value));
+    }
+
+    uint16_t input(shader_input which) {
+        uint16_t& node = input_node_[static_cast<std::size_t>(which)];
+        if (node == SHADER_NO_NODE) {
+            node = add(shader_node_kind::input, shader_op::constant, 0, 0,
+                       static_cast<int32_t>(which));
+        }
+        return node;
+    }
+
+    uint16_t primary() {
+        skip_blanks();
+        if (p_ == end_) {
+            fail("expected a value");
+            return SHADER_NO_NODE;
+        }
+        if (is_digit(*p_) || *p_ == '.') {
+            return number();
+        }
+        if (accept('(')) {
+            uint16_t const inner = expression();
+            if (inner != SHADER_NO_NODE && !accept(')')) {
+                fail("expected )");
+                return SHADER_NO_NODE;
+            }
+            return inner;
+        }
+        char const* const start = p_;
+        char const* name;
+        std::size_t length;
+        if (!identifier(name, length)) {
+            fail("expected a value");
+            return SHADER_NO_NODE;
+        }
+        for (std::size_t k = 0; k < sizeof(FUNCTIONS) / sizeof(FUNCTIONS[0]); ++k) {
+            if (same(name, length, FUNCTIONS[k].name)) {
+                return call(FUNCTIONS[k]);
+            }
+        }
+        if (same(name, length, "index")) {
+            return input(shader_input::index);
+        }
+        if (same(name, length, "u")) {
+            return input(shader_input::u);
+        }
+        if (same(name, length, "x")) {
+            return input(shader_input::x);
+        }
+        if (same(name, length, "y")) {
+            return input(shader_input::y);
+        }
+        if (same(name, length, "t")) {
+            if (time_node_ == SHADER_NO_NODE) {
+                time_node_ = add(shader_node_kind::time, shader_op::constant, 0, 0, 0);
+            }
+            return time_node_;
+        }
+        if (same(name, length, "PI")) {
+            return constant(205887);
+        }
+        for (std::size_t v = 0; v < variable_count_; ++v) {
+            if (variables_[v].length == length && matches(variables_[v], name, length)) {
+                return variables_[v].node;
+            }
+        }
+        p_ = start;
+        fail("unknown name");
+        return SHADER_NO_NODE;
+    }
+
+    uint16_t call(function_name const& function) {
+        if (!accept('(')) {
+            fail("expected ( after function name");
+            return SHADER_NO_NODE;
+        }
+        uint16_t const a = expression();
+        if (a == SHADER_NO_NODE) {
+            return SHADER_NO_NODE;
+        }
+        uint16_t b = 0;
+        if (function.arguments == 2) {
+            if (!accept(',')) {
+                fail("expected , and a second argument");
+                return SHADER_NO_NODE;
+            }
+            b = expression();
+            if (b == SHADER_NO_NODE) {
+                return SHADER_NO_NODE;
+            }
+        }
+        if (!accept(')')) {
+            fail("expected )");
+            return SHADER_NO_NODE;
+        }
+        return operation(function.op, a, b);
+    }
+
+    char const* const text_;
+    char const* const end_;
+    char const* p_;
+    shader_expression& out_;
+    shader_error& error_;
+    variable variables_[SHADER_MAX_NAMES];
+    std::size_t variable_count_;
+    std::size_t depth_;
+    uint16_t input_node_[SHADER_PIXEL_INPUTS];
+    uint16_t time_node_;
+};
+
+// Value of one node for one pixel, walking the tree
+inline int32_t tree_value(shader_expression const& expression, uint16_t node,
+                          int32_t const* pixel, int32_t time) {
+    shader_node const& n = expression.nodes[node];
+    switch (n.kind) {
+        case shader_node_kind::constant:
+            return n.value;
+        case shader_node_kind::input:
+            return pixel[n.value];
+        case shader_node_kind::time:
+            return time;
+        case shader_node_kind::operation:
+            break;
+    }
+    int32_t const a = tree_value(expression, n.a, pixel, time);
+    int32_t const b = is_binary(n.op) ? tree_value(expression, n.b, pixel, time) : 0;
+    return shader_apply(n.op, a, b);
+}
+
+}  // namespace shader_detail
+
+/**
+ * @brief Parse a shader into expression trees
+ *
+ * Statements are "name = expression", separated by newlines or ';', with
+ * # comments. Assigning r, g and b sets the pixel color (0 to 1, clamped;
+ * unassigned colors are 0); any other name is a variable for later lines.
+ *
+ *   inputs      index, u (index / count), x, y (layout), t (seconds)
+ *   operators   + - * / % < > (1 or 0), unary -, parentheses
+ *   functions   sin(a) cos(a) (radians), wave(a) tri(a) (0..1..0 per unit),
+ *               frac(a) floor(a) abs(a) min(a, b) max(a, b)
+ *   constants   decimal numbers, PI
+ *
+ * Numbers are Q16.16 fixed point (about +-32767 with 1/65536 steps), so
+ * shaders run the same on a board without an FPU as on the host.
+ */
+inline bool parse_shader(char const* text, std::size_t length, shader_expression& expression,
+                         shader_error& error) {
+    shader_detail::parser parser(text, length, expression, error);
+    return parser.parse();
+}
+
+/**
+ * @brief Evaluate a parsed shader pixel by pixel by walking its trees
+ *
+ * The straightforward interpreter: every pixel walks every color's tree
+ * node by node. It is the reference pixel_shader is tested against and
+ * the baseline it is benchmarked against.
+ */
+inline void evaluate_shader_tree(shader_expression const& expression,
+                                 shader_inputs const& inputs, std::size_t count, uint8_t* red,
+                                 uint8_t* green, uint8_t* blue) {
+    uint8_t* const planes[3] = {red, green, blue};
+    for (std::size_t i = 0; i < count; ++i) {
+        int32_t const pixel[SHADER_PIXEL_INPUTS] = {
+            static_cast<int32_t>(static_cast<uint32_t>(i) << 16), shader_u(i, count),
+            inputs.x != nullptr ? inputs.x[i] : 0, inputs.y != nullptr ? inputs.y[i] : 0};
+        for (std::size_t c = 0; c < 3; ++c) {
+            if (planes[c] == nullptr) {
+                continue;
+            }
+            uint16_t const root = expression.output[c];
+            planes[c][i] = shader_level(
+                root == SHADER_NO_NODE
+                    ? 0
+                    : shader_detail::tree_value(expression, root, pixel, inputs.time));
+        }
+    }
+}
+
+/**
+ * @brief Generate the register program for a parsed shader
+ *
+ * Nodes that depend only on t and constants go to the scalar program (once
+ * per frame); the rest become block-wide vector instructions, each using
+ * the uniform values directly as scalar operands. Vector registers are
+ * reused as soon as their last reader has run. Inputs are allocated first,
+ * since they are loaded before the program starts.
+ */
+inline bool generate_shader(shader_expression const& expression, shader_program& program,
+                            shader_error& error) {
+    error.line = 0;
+    error.column = 0;
+    error.message = nullptr;
+    std::size_t const count = expression.count;
+    bool uniform[SHADER_MAX_NODES];
+    uint8_t uses[SHADER_MAX_NODES];
+    uint8_t reg[SHADER_MAX_NODES];
+    bool needed[SHADER_MAX_NODES];
+    for (std::size_t n = 0; n < count; ++n) {
+        shader_node const& node = expression.nodes[n];
+        uniform[n] = node.kind == shader_node_kind::constant ||
+                     node.kind == shader_node_kind::time ||
+                     (node.kind == shader_node_kind::operation && uniform[node.a] &&
+                      (!shader_detail::is_binary(node.op) || uniform[node.b]));
+        uses[n] = 0;
+        reg[n] = SHADER_NO_REGISTER;
+        needed[n] = false;
+    }
+    for (std::size_t c = 0; c < 3; ++c) {
+        if (expression.output[c] != SHADER_NO_NODE) {
+            needed[expression.output[c]] = true;
+            ++uses[expression.output[c]];  // Never freed
+        }
+    }
+    // Children come first, so one backward pass marks everything reachable
+    for (std::size_t n = count; n-- > 0;) {
+        shader_node const& node = expression.nodes[n];
+        if (!needed[n] || node.kind != shader_node_kind::operation) {
+            continue;
+        }
+        needed[node.a] = true;
+        if (!uniform[n]) {
+            ++uses[node.a];
+        }
+        if (shader_detail::is_binary(node.op)) {
+            needed[node.b] = true;
+            if (!uniform[n]) {
+                ++uses[node.b];
+            }
+        }
+    }
+
+    program.scalar_count = 0;
+    program.vector_count = 0;
+    for (std::size_t k = 0; k < SHADER_PIXEL_INPUTS; ++k) {
+        program.input_register[k] = SHADER_NO_REGISTER;
+    }
+    bool vector_free[SHADER_VECTOR_REGISTERS];
+    for (std::size_t r = 0; r < SHADER_VECTOR_REGISTERS; ++r) {
+        vector_free[r] = true;
+    }
+    std::size_t scalar_next = 1;  // 0 is t
+    for (std::size_t n = 0; n < count; ++n) {
+        shader_node const& node = expression.nodes[n];
+        if (needed[n] && node.kind == shader_node_kind::input) {
+            std::size_t r = 0;
+            while (r < SHADER_VECTOR_REGISTERS && !vector_free[r]) {
+                ++r;
+            }
+            vector_free[r] = false;  // Four inputs at most, always fit
+            reg[n] = static_cast<uint8_t>(r);
+            program.input_register[node.value] = static_cast<uint8_t>(r);
+        }
+    }
+
+    for (std::size_t n = 0; n < count; ++n) {
+        shader_node const& node = expression.nodes[n];
+        if (!needed[n] || node.kind == shader_node_kind::input) {
+            continue;
+        }
+        if (node.kind == shader_node_kind::time) {
+            reg[n] = 0;
+            continue;
+        }
+        bool const binary = shader_detail::is_binary(node.op);
+        shader_instruction in;
+        in.op = node.op;
+        in.a = node.kind == shader_node_kind::operation ? reg[node.a] : 0;
+        in.b = binary ? reg[node.b] : 0;
+        in.value = node.value;
+        if (uniform[n]) {
+            if (scalar_next == SHADER_SCALAR_REGISTERS ||
+                program.scalar_count == SHADER_MAX_INSTRUCTIONS) {
+                error.message = "too many constants";
+                return false;
+            }
+            in.flags = 0;
+            in.dst = static_cast<uint8_t>(scalar_next++);
+            program.scalar_code[program.scalar_count++] = in;
+            reg[n] = in.dst;
+            continue;
+        }
+        in.flags = static_cast<uint8_t>((uniform[node.a] ? SHADER_A_SCALAR : 0) |
+                                        (binary && uniform[node.b] ? SHADER_B_SCALAR : 0));
+        if (!uniform[node.a] && --uses[node.a] == 0) {
+            vector_free[reg[node.a]] = true;
+        }
+        if (binary && !uniform[node.b] && --uses[node.b] == 0) {
+            vector_free[reg[node.b]] = true;
+        }
+        std::size_t r = 0;
+        while (r < SHADER_VECTOR_REGISTERS && !vector_free[r]) {
+            ++r;
+        }
+        if (r == SHADER_VECTOR_REGISTERS || program.vector_count == SHADER_MAX_INSTRUCTIONS) {
+            error.message = "shader too complex";
+            return false;
+        }
+        vector_free[r] = false;
+        in.dst = static_cast<uint8_t>(r);
+        program.vector_code[program.vector_count++] = in;
+        reg[n] = in.dst;
+    }
+
+    for (std::size_t c = 0; c < 3; ++c) {
+        uint16_t const root = expression.output[c];
+        if (root == SHADER_NO_NODE) {
+            if (scalar_next == SHADER_SCALAR_REGISTERS ||
+                program.scalar_count == SHADER_MAX_INSTRUCTIONS) {
+                error.message = "too many constants";
+                return false;
+            }
+            shader_instruction const zero = {shader_op::constant, static_cast<uint8_t>(scalar_next),
+                                             0, 0, 0, 0};
+            program.scalar_code[program.scalar_count++] = zero;
+            program.output_register[c] = static_cast<uint8_t>(scalar_next++);
+            program.output_scalar[c] = 1;
+        } else {
+            program.output_register[c] = reg[root];
+            program.output_scalar[c] = uniform[root] ? 1 : 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Compile shader text for pixel_shader (parse_shader() then generate_shader())
+ *
+ * Usage:
+ *   shader_program program;
+ *   shader_error error;
+ *   if (!compile_shader(text, length, program, error)) {
+ *       report(error.line, error.column, error.message);
+ *   }
+ */
+inline bool compile_shader(char const* text, std::size_t length, shader_program& program,
+                           shader_error& error) {
+    shader_expression expression;
+    return parse_shader(text, length, expression, error) &&
+           generate_shader(expression, program, error);
+}
@@ -0,0 +1,301 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "seqlock.h"
+
+/**
+ * @brief Layout of a shared-memory frame region
+ *
+ * [shm_frame_header][words: frame_lo, frame_hi, time_ms, channel words...]
+ *
+ * Header fields other than the seqlock are written once by the publisher
+ * before any frame, then magic is stored with release; a reader loads magic
+ * with acquire before touching the rest. Everything after the header is
+ * seqlock-protected and accessed only through relaxed 32-bit atomics
+ * (lock-free and address-free, so valid across processes).
+ */
+struct shm_frame_header {
+    static uint32_t const MAGIC = 0x48573246;  // "HW2F"
+    static uint32_t const VERSION = 1;
+    static std::size_t const FRAME_LO_WORD = 0;
+    static std::size_t const FRAME_HI_WORD = 1;
+    static std::size_t const TIME_WORD = 2;
+    static std::size_t const HEADER_WORDS = 3;
+
+    std::atomic<uint32_t> magic;  // MAGIC once the rest of the header is written
+    uint32_t version;
+    uint32_t channel_count;
+    uint32_t word_count;  // Channel words (bit i % 32 of word i / 32)
+    seqlock lock;
+
+    static std::size_t region_size(uint32_t channel_count) {
+        return sizeof(shm_frame_header) +
+               (HEADER_WORDS + (channel_count + 31) / 32) * sizeof(std::atomic<uint32_t>);
+    }
+};
+
+/**
+ * @brief Metadata of one frame read from shared memory
+ */
+struct shm_frame_info {
+    uint64_t frame;  // 1 = first published frame, 0 = none yet
+    uint32_t time_ms;
+};
+
+/**
+ * @brief Publishes packed channel states into POSIX shared memory
+ *
+ * The show process creates the region once and publishes every tick. The
+ * writer never waits on readers: publishing is a seqlock write of the
+ * channel words that changed plus the frame counter. Any number of local
+ * reader processes (visualizers, loggers) map the region read-only with
+ * shm_frame_reader.
+ *
+ * Restarts: create() never resizes or reinitializes a region in place,
+ * since readers may have it mapped (a shrunk region is SIGBUS, a reset
+ * seqlock a torn read). It unlinks any region of the same name and creates
+ * a fresh one. Readers of the old region keep a valid mapping whose frame
+ * counter simply stops advancing; to follow a restarted writer they call
+ * open() again (for example when no new frame arrives for a while).
+ *
+ * Linux/POSIX only.
+ *
+ * Usage:
+ *   shm_frame_writer writer;
+ *   if (!writer.create("/halloween_frames", output_bank<64>::CHANNEL_COUNT)) { fallback... }
+ *   writer.publish(bank.words(), now);
+ */
+struct shm_frame_writer {
+   public:
+    shm_frame_writer() : header_(nullptr), words_(nullptr), size_(0), frame_(0) {}
+    ~shm_frame_writer() { close(); }
+
+    shm_frame_writer(shm_frame_writer const&) = delete;
+    shm_frame_writer& operator=(shm_frame_writer const&) = delete;
+
+    /**
+     * @brief Create a named region, replacing any region of that name
+     *
+     * An existing region is unlinked, not reused: its readers keep their
+     * mapping intact and must open() again to see this one.
+     *
+     * @param name POSIX shm name, e.g. "/halloween_frames"
+     * @param channel_count Number of channels per frame
+     * @return false Region could not be created or mapped
+     */
+    bool create(char const* name, uint32_t channel_count) {
+        close();
+        ::shm_unlink(name);
+        int const fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        std::size_t const size = shm_frame_header::region_size(channel_count);
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* const base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+
+        // Fresh object, but magic is still published last for readers racing open()
+        header_ = new (base) shm_frame_header();
+        header_->version = shm_frame_header::VERSION;
+        header_->channel_count = channel_count;
+        header_->word_count = (channel_count + 31) / 32;
+        words_ = reinterpret_cast<std::atomic<uint32_t>*>(header_ + 1);
+        for (std::size_t i = 0; i < shm_frame_header::HEADER_WORDS + header_->word_count; ++i) {
+            new (&words_[i]) std::atomic<uint32_t>(0);
+        }
+        size_ = size;
+        frame_ = 0;
+        header_->magic.store(shm_frame_header::MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Unmap the region (the name stays until unlink())
+     */
+    void close() {
+        if (header_ != nullptr) {
+            ::munmap(header_, size_);
+            header_ = nullptr;
+            words_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    /**
+     * @brief Remove a region name (readers keep existing mappings)
+     */
+    static bool unlink(char const* name) { return ::shm_unlink(name) == 0; }
+
+    /**
+     * @brief Publish one frame (tick thread, never blocks)
+     *
+     * @param channel_words Packed channel states, word_count words
+     * @param time_ms Tick time the frame describes
+     */
+    void publish(uint32_t const* channel_words, uint32_t time_ms) {
+        ++frame_;
+        std::atomic<uint32_t>* const channels = words_ + shm_frame_header::HEADER_WORDS;
+        header_->lock.write_begin();
+        seqlock_store(words_[shm_frame_header::FRAME_LO_WORD], static_cast<uint32_t>(frame_));
+        seqlock_store(words_[shm_frame_header::FRAME_HI_WORD],
+                      static_cast<uint32_t>(frame_ >> 32));
+        seqlock_store(words_[shm_frame_header::TIME_WORD], time_ms);
+        for (uint32_t i = 0; i < header_->word_count; ++i) {
+            // Writer is the only mutator, so its own relaxed load is exact
+            if (seqlock_load(channels[i]) != channel_words[i]) {
+                seqlock_store(channels[i], channel_words[i]);
+            }
+        }
+        header_->lock.write_end();
+    }
+
+    bool is_open() const { return header_ != nullptr; }
+    uint64_t get_frame_count() const { return frame_; }
+    uint32_t get_word_count() const { return header_ == nullptr ? 0 : header_->word_count; }
+
+   private:
+    shm_frame_header* header_;
+    std::atomic<uint32_t>* words_;
+    std::size_t size_;
+    uint64_t frame_;
+};
+
+/**
+ * @brief Read-only view of a region created by shm_frame_writer
+ *
+ * Frames are read straight out of the shared mapping (no kernel copies,
+ * no sockets); the only copy is the reader's own consistent snapshot.
+ * Reading never affects the writer.
+ *
+ * Usage:
+ *   shm_frame_reader reader;
+ *   if (reader.open("/halloween_frames")) {
+ *       std::vector<uint32_t> words(reader.get_word_count());
+ *       shm_frame_info info;
+ *       reader.read(words.data(), info);
+ *   }
+ */
+struct shm_frame_reader {
+   public:
+    shm_frame_reader() : header_(nullptr), words_(nullptr), size_(0) {}
+    ~shm_frame_reader() { close(); }
+
+    shm_frame_reader(shm_frame_reader const&) = delete;
+    shm_frame_reader& operator=(shm_frame_reader const&) = delete;
+
+    /**
+     * @brief Map an existing region read-only
+     *
+     * Also how a reader follows a restarted writer: the new region is mapped
+     * and checked before the current one is released, so a failed open()
+     * keeps the current mapping and can simply be retried.
+     *
+     * @param name POSIX shm name used by the writer
+     * @return false Region missing, too small, not a frame region, or not
+     *         yet fully created
+     */
+    bool open(char const* name) {
+        int const fd = ::shm_open(name, O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 ||
+            static_cast<std::size_t>(st.st_size) < sizeof(shm_frame_header)) {
+            ::close(fd);
+            return false;
+        }
+        std::size_t const size = static_cast<std::size_t>(st.st_size);
+        void* const base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+
+        // The other header fields are only written before magic; read them after it
+        shm_frame_header const* const header = static_cast<shm_frame_header const*>(base);
+        bool const valid = header->magic.load(std::memory_order_acquire) ==
+                               shm_frame_header::MAGIC &&
+                           header->version == shm_frame_header::VERSION &&
+                           size >= shm_frame_header::region_size(header->channel_count);
+        if (!valid) {
+            ::munmap(base, size);
+            return false;
+        }
+        close();
+        header_ = header;
+        words_ = reinterpret_cast<std::atomic<uint32_t> const*>(header_ + 1);
+        size_ = size;
+        return true;
+    }
+
+    void close() {
+        if (header_ != nullptr) {
+            ::munmap(const_cast<shm_frame_header*>(header_), size_);
+            header_ = nullptr;
+            words_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    /**
+     * @brief Attempt one consistent copy without waiting
+     *
+     * @param channel_words Destination, get_word_count() words
+     * @param info Receives frame number and time
+     * @return false The writer was mid-frame; try again
+     */
+    bool try_read(uint32_t* channel_words, shm_frame_info& info) const {
+        uint32_t seq;
+        if (!header_->lock.try_read_begin(seq)) {
+            return false;
+        }
+        uint32_t const lo = seqlock_load(words_[shm_frame_header::FRAME_LO_WORD]);
+        uint32_t const hi = seqlock_load(words_[shm_frame_header::FRAME_HI_WORD]);
+        uint32_t const time_ms = seqlock_load(words_[shm_frame_header::TIME_WORD]);
+        seqlock_copy(words_ + shm_frame_header::HEADER_WORDS, channel_words, header_->word_count);
+        if (header_->lock.read_retry(seq)) {
+            return false;
+        }
+        info.frame = (static_cast<uint64_t>(hi) << 32) | lo;
+        info.time_ms = time_ms;
+        return true;
+    }
+
+    /**
+     * @brief Copy the latest frame, retrying until consistent
+     */
+    void read(uint32_t* channel_words, shm_frame_info& info) const {
+        while (!try_read(channel_words, info)) {
+        }
+    }
+
+    /**
+     * @brief Cheap change check: sequence advances once per published frame
+     */
+    uint32_t get_sequence() const { return header_->lock.sequence(); }
+
+    bool is_open() const { return header_ != nullptr; }
+    uint32_t get_channel_count() const { return header_->channel_count; }
+    uint32_t get_word_count() const { return header_->word_count; }
+
+   private:
+    shm_frame_header const* header_;
+    std::atomic<uint32_t> const* words_;
+    std::size_t size_;
+};
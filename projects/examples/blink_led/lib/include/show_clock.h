@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Playback rate 1x in show_clock's Q16.16 fixed point
+ */
+static uint32_t const SHOW_RATE_ONE = 65536;
+
+/**
+ * @brief Playback rate numerator/denominator in Q16.16 (show_rate(1, 4) = 0.25x)
+ */
+inline uint32_t show_rate(uint32_t numerator, uint32_t denominator) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(numerator) << 16) / denominator);
+}
+
+/**
+ * @brief Show time from wall time at a changeable playback rate
+ *
+ * Wraps any timer with millis() (real_time_timer, mock_timer, an Arduino
+ * millis() adapter) and has the same interface, so it drops in wherever a
+ * timer is passed. Show time is kept as an anchor, the show position at the
+ * last rate change in 1/65536 ms, plus the wall time elapsed since then times
+ * the rate:
+ *   - set_rate() re-anchors at the exact current position, fraction included,
+ *     so a rate change never jumps show time and never loses the fractional
+ *     millisecond that 0.25x accumulates between wall ticks
+ *   - nothing is summed per call, so the clock does not drift however often
+ *     millis() is read
+ *   - rate 0 pauses
+ *
+ * At high rates one wall millisecond is many show milliseconds, so drive
+ * controllers analytically rather than once per edge:
+ * blink_controller::fast_forward() or show_playback::advance() with
+ * millis() cost the same per frame at 1000x as at 1x. wall_delay_ms()
+ * converts a show-time deadline (time_until_toggle()) into a wall-clock
+ * sleep for event loops.
+ *
+ * Platform-agnostic (no heap, no STL).
+ *
+ * Usage:
+ *   real_time_timer timer;
+ *   show_clock<real_time_timer> clock(timer);
+ *   clock.set_rate(show_rate(1, 4));  // Quarter speed rehearsal
+ *   controller.fast_forward(clock.millis());
+ *
+ * @tparam timer_t Type with millis()
+ */
+template<typename timer_t>
+struct show_clock {
+   public:
+    explicit show_clock(timer_t& timer)
+        : timer_(timer), anchor_wall_ms_(timer.millis()), anchor_show_(0), rate_(SHOW_RATE_ONE) {}
+
+    /**
+     * @brief Current show time in milliseconds (wraps like millis())
+     */
+    uint32_t millis() const { return static_cast<uint32_t>(position(timer_.millis()) >> 16); }
+
+    /**
+     * @brief Change the playback rate from now on (Q16.16, 0 pauses)
+     */
+    void set_rate(uint32_t rate) {
+        uint32_t const wall_ms = timer_.millis();
+        anchor_show_ = position(wall_ms);
+        anchor_wall_ms_ = wall_ms;
+        rate_ = rate;
+    }
+
+    /**
+     * @brief Jump to a show time; the rate is kept
+     */
+    void seek(uint32_t show_ms) {
+        anchor_wall_ms_ = timer_.millis();
+        anchor_show_ = static_cast<uint64_t>(show_ms) << 16;
+    }
+
+    /**
+     * @brief Wall milliseconds until show time has advanced by show_ms
+     *
+     * Rounded up, so sleeping this long never wakes before the deadline.
+     *
+     * @return UINT32_MAX when paused or further than the wall clock reaches
+     */
+    uint32_t wall_delay_ms(uint32_t show_ms) const {
+        if (show_ms == 0) {
+            return 0;
+        }
+        if (rate_ == 0) {
+            return UINT32_MAX;
+        }
+        uint64_t const fraction = position(timer_.millis()) & 0xFFFF;
+        uint64_t const remaining = (static_cast<uint64_t>(show_ms) << 16) - fraction;
+        uint64_t const delay = (remaining + rate_ - 1) / rate_;
+        return delay > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(delay);
+    }
+
+    uint32_t get_rate() const { return rate_; }
+
+   private:
+    // Show position in 1/65536 ms at a wall time (wall wraparound included)
+    uint64_t position(uint32_t wall_ms) const {
+        uint32_t const elapsed = wall_ms - anchor_wall_ms_;
+        return anchor_show_ + static_cast<uint64_t>(elapsed) * rate_;
+    }
+
+    timer_t& timer_;
+    uint32_t anchor_wall_ms_;
+    uint64_t anchor_show_;  // Q16.16 ms
+    uint32_t rate_;
+};
+
+/**
+ * @brief Wall-clock sleep for a show-time delay: identity for plain timers
+ */
+template<typename timer_t>
+uint32_t wall_delay_ms(timer_t const&, uint32_t show_ms) {
+    return show_ms;
+}
+
+template<typename timer_t>
+uint32_t wall_delay_ms(show_clock<timer_t> const& clock, uint32_t show_ms) {
+    return clock.wall_delay_ms(show_ms);
+}
@@ -0,0 +1,269 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Timed change to one channel's blink controller
+ */
+enum class show_event_type : uint8_t {
+    set_durations = 0,  // a: ON ms, b: OFF ms
+    shift_phase = 1,    // a: delta ms (int32_t)
+    restart = 2
+};
+
+struct show_event {
+    uint32_t time_ms;
+    uint32_t channel;
+    show_event_type type;
+    uint32_t a;
+    uint32_t b;
+};
+
+/**
+ * @brief Show playback that can seek to any time without replaying from zero
+ *
+ * A show is a set of controllers (blink_controller) plus time-sorted events
+ * that retime, shift or restart them. Playing it means: at every
+ * millisecond, apply that millisecond's events, then update() every
+ * controller. seek() reaches the same state at any time t without that
+ * loop:
+ *   - restore the last checkpoint at or before t (every controller's
+ *     save() state, taken every checkpoint interval by prepare())
+ *   - walk the events between the checkpoint and t; a controller an event
+ *     touches is fast-forwarded to just before it, gets the event, and is
+ *     updated at the event time, exactly as the per-millisecond loop would
+ *   - fast_forward() every controller to t (constant time per controller)
+ * so a seek costs one checkpoint copy, the events in one interval and one
+ * O(1) step per channel, whatever t is.
+ *
+ * Checkpoint memory is channels * sizeof(snapshot) per checkpoint. prepare()
+ * widens the requested interval until the checkpoints fit the memory
+ * budget.
+ *
+ * Usage:
+ *   show_playback<blink_controller<bank_pin> > show(controllers.data(), controllers.size());
+ *   show.add_event({270000, 3, show_event_type::set_durations, 100, 100});
+ *   show.prepare(3600000, 10000, 64 << 20);  // 1 h show, 10 s checkpoints, 64 MB
+ *   show.seek(270000);                       // "4 minutes 30 in"
+ *   show.advance(millis() - start);          // then play on
+ *
+ * @tparam controller_t Type with update(), fast_forward(), save(), restore(),
+ *         set_durations(), shift_phase() and restart() (blink_controller)
+ */
+template<typename controller_t>
+struct show_playback {
+   public:
+    typedef typename controller_t::snapshot snapshot;
+
+    /**
+     * @param controllers Channels, in their initial state until the first prepare()
+     */
+    show_playback(controller_t* controllers, std::size_t count)
+        : controllers_(controllers),
+          count_(count),
+          marks_(count, 0),
+          serial_(0),
+          interval_ms_(0),
+          now_ms_(0),
+          next_event_(0),
+          prepared_(false) {}
+
+    /**
+     * @brief Append an event (times non-decreasing); needs prepare() again
+     */
+    bool add_event(show_event const& event) {
+        if (event.channel >= count_ ||
+            (!events_.empty() && event.time_ms < events_.back().time_ms)) {
+            return false;
+        }
+        events_.push_back(event);
+        prepared_ = false;
+        return true;
+    }
+
+    /**
+     * @brief Play the show once from the controllers' initial state, taking checkpoints
+     *
+     * The first call saves the controllers as the initial state; later
+     * calls (after add_event()) restore it first, so each prepare() plays
+     * from the same start. Ends positioned at time 0.
+     *
+     * @param duration_ms Show length (seeks beyond it fast-forward from the last checkpoint)
+     * @param interval_ms Requested time between checkpoints
+     * @param budget_bytes Memory for all checkpoints
+     * @return false if not even the time-0 checkpoint fits the budget
+     */
+    bool prepare(uint32_t duration_ms, uint32_t interval_ms, std::size_t budget_bytes) {
+        std::size_t const checkpoint_bytes = count_ * sizeof(snapshot);
+        std::size_t const affordable =
+            checkpoint_bytes == 0 ? 1 : budget_bytes / checkpoint_bytes;
+        if (affordable == 0) {
+            return false;
+        }
+        uint32_t interval = interval_ms == 0 ? 1 : interval_ms;
+        if (duration_ms / interval + 1 > affordable) {
+            // 64-bit: one checkpoint of a UINT32_MAX show wants an interval past 32 bits
+            uint64_t const widened =
+                affordable > 1 ? (uint64_t(duration_ms) + affordable - 2) / (affordable - 1)
+                               : uint64_t(duration_ms) + 1;
+            interval = widened > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(widened);
+        }
+        interval_ms_ = interval;
+        if (initial_.empty()) {
+            initial_.resize(count_);
+            for (std::size_t c = 0; c < count_; ++c) {
+                initial_[c] = controllers_[c].save();
+            }
+        } else {
+            for (std::size_t c = 0; c < count_; ++c) {
+                controllers_[c].restore(initial_[c]);
+            }
+        }
+        std::size_t checkpoints = duration_ms / interval + 1;
+        if (checkpoints > affordable) {
+            checkpoints = affordable;  // Only when the interval was clamped to UINT32_MAX
+        }
+        states_.resize(checkpoints * count_);
+        event_index_.resize(checkpoints);
+
+        // Time 0: its events, then one update of every controller
+        now_ms_ = 0;
+        next_event_ = 0;
+        apply_events_at(0);
+        for (std::size_t c = 0; c < count_; ++c) {
+            if (marks_[c] != serial_) {
+                controllers_[c].update(0);
+            }
+        }
+        store(0);
+        for (std::size_t k = 1; k < checkpoints; ++k) {
+            advance_to(static_cast<uint32_t>(k * interval));
+            store(k);
+        }
+        prepared_ = true;
+        return seek(0);
+    }
+
+    /**
+     * @brief Jump to show time t (forwards or backwards)
+     */
+    bool seek(uint32_t t) {
+        if (!prepared_) {
+            return false;
+        }
+        std::size_t k = t / interval_ms_;
+        if (k >= event_index_.size()) {
+            k = event_index_.size() - 1;
+        }
+        load(k);
+        advance_to(t);
+        return true;
+    }
+
+    /**
+     * @brief Play forward to show time t; an earlier t seeks back
+     *
+     * Cost does not grow with the time skipped, so slow hosts and fast
+     * rehearsal rates stay exact.
+     */
+    bool advance(uint32_t t) {
+        if (!prepared_) {
+            return false;
+        }
+        if (t < now_ms_) {
+            return seek(t);
+        }
+        advance_to(t);
+        return true;
+    }
+
+    uint32_t get_time() const { return now_ms_; }
+    uint32_t get_checkpoint_interval() const { return interval_ms_; }
+    std::size_t get_checkpoint_count() const { return event_index_.size(); }
+    std::size_t get_checkpoint_bytes() const { return states_.size() * sizeof(snapshot); }
+    std::size_t get_event_count() const { return events_.size(); }
+
+   private:
+    void store(std::size_t k) {
+        snapshot* out = &states_[k * count_];
+        for (std::size_t c = 0; c < count_; ++c) {
+            out[c] = controllers_[c].save();
+        }
+        event_index_[k] = next_event_;
+    }
+
+    void load(std::size_t k) {
+        snapshot const* in = &states_[k * count_];
+        for (std::size_t c = 0; c < count_; ++c) {
+            controllers_[c].restore(in[c]);
+        }
+        next_event_ = event_index_[k];
+        now_ms_ = static_cast<uint32_t>(k * interval_ms_);
+    }
+
+    // From now_ms_ (every controller current) to t
+    void advance_to(uint32_t t) {
+        while (next_event_ < events_.size() && events_[next_event_].time_ms <= t) {
+            apply_events_at(events_[next_event_].time_ms);
+        }
+        for (std::size_t c = 0; c < count_; ++c) {
+            controllers_[c].fast_forward(t);
+        }
+        now_ms_ = t;
+    }
+
+    // All events at time e: touched controllers are brought to e - 1, get
+    // their events, then one update at e (the per-millisecond loop's order)
+    void apply_events_at(uint32_t e) {
+        std::size_t const first = next_event_;
+        std::size_t last = first;
+        while (last < events_.size() && events_[last].time_ms == e) {
+            ++last;
+        }
+        uint32_t const touched = ++serial_;
+        for (std::size_t i = first; i < last; ++i) {
+            show_event const& event = events_[i];
+            controller_t& controller = controllers_[event.channel];
+            if (marks_[event.channel] != touched) {
+                marks_[event.channel] = touched;
+                if (e > now_ms_) {
+                    controller.fast_forward(e - 1);
+                }
+            }
+            switch (event.type) {
+                case show_event_type::set_durations:
+                    controller.set_durations(event.a, event.b);
+                    break;
+                case show_event_type::shift_phase:
+                    controller.shift_phase(static_cast<int32_t>(event.a));
+                    break;
+                case show_event_type::restart:
+                    controller.restart(e);
+                    break;
+            }
+        }
+        uint32_t const updated = ++serial_;
+        for (std::size_t i = first; i < last; ++i) {
+            uint32_t const channel = events_[i].channel;
+            if (marks_[channel] != updated) {
+                marks_[channel] = updated;
+                controllers_[channel].update(e);
+            }
+        }
+        next_event_ = last;
+    }
+
+    controller_t* controllers_;
+    std::size_t count_;
+    std::vector<show_event> events_;
+    std::vector<snapshot> initial_;          // Controllers before the first prepare()
+    std::vector<snapshot> states_;           // count_ per checkpoint
+    std::vector<std::size_t> event_index_;   // First event after each checkpoint
+    std::vector<uint32_t> marks_;            // Per channel: last event group that touched it
+    uint32_t serial_;
+    uint32_t interval_ms_;
+    uint32_t now_ms_;
+    std::size_t next_event_;
+    bool prepared_;
+};
@@ -0,0 +1,388 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "show_vm.h"
+
+/**
+ * @brief Where and why a show script failed to compile
+ */
+struct show_script_error {
+    uint32_t line;        // 1-based
+    char const* message;  // String literal
+};
+
+/// Named channels per script
+static std::size_t const SHOW_SCRIPT_MAX_NAMES = 32;
+
+namespace show_script_detail {
+
+struct token {
+    char const* text;
+    std::size_t length;
+
+    bool is(char const* word) const {
+        std::size_t i = 0;
+        for (; i < length; ++i) {
+            if (word[i] != text[i]) {
+                return false;
+            }
+        }
+        return word[i] == '\0';
+    }
+};
+
+// Splits one line into whitespace-separated tokens, dropping # comments
+struct line_tokens {
+    static std::size_t const MAX_TOKENS = 6;
+
+    line_tokens(char const* begin, char const* end) : count(0), overflow(false) {
+        char const* p = begin;
+        while (p != end && *p != '#') {
+            if (*p == ' ' || *p == '\t' || *p == '\r') {
+                ++p;
+                continue;
+            }
+            char const* const start = p;
+            while (p != end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '#') {
+                ++p;
+            }
+            if (count == MAX_TOKENS) {
+                overflow = true;
+                return;
+            }
+            tokens[count].text = start;
+            tokens[count].length = static_cast<std::size_t>(p - start);
+            ++count;
+        }
+    }
+
+    token tokens[MAX_TOKENS];
+    std::size_t count;
+    bool overflow;
+};
+
+inline bool parse_uint(token const& t, uint32_t max, uint32_t& value) {
+    if (t.length == 0) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (std::size_t i = 0; i < t.length; ++i) {
+        if (t.text[i] < '0' || t.text[i] > '9') {
+            return false;
+        }
+        v = v * 10 + static_cast<uint64_t>(t.text[i] - '0');
+        if (v > max) {
+            return false;
+        }
+    }
+    value = static_cast<uint32_t>(v);
+    return true;
+}
+
+// "500", "500ms", "2s", "1.25s" (milliseconds resolution)
+inline bool parse_ms(token const& t, uint32_t& value) {
+    std::size_t digits = t.length;
+    uint32_t scale = 1;
+    if (digits > 2 && t.text[digits - 2] == 'm' && t.text[digits - 1] == 's') {
+        digits -= 2;
+    } else if (digits > 1 && t.text[digits - 1] == 's') {
+        digits -= 1;
+        scale = 1000;
+    }
+    uint64_t whole = 0;
+    uint32_t fraction = 0;
+    uint32_t fraction_scale = scale;
+    bool point = false;
+    bool any = false;
+    for (std::size_t i = 0; i < digits; ++i) {
+        char const c = t.text[i];
+        if (c == '.' && !point && scale == 1000) {
+            point = true;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        any = true;
+        if (point) {
+            if (fraction_scale == 1) {
+                return false;  // Below a millisecond
+            }
+            fraction_scale /= 10;
+            fraction += static_cast<uint32_t>(c - '0') * fraction_scale;
+        } else {
+            whole = whole * 10 + static_cast<uint64_t>(c - '0');
+            if (whole > UINT32_MAX) {
+                return false;
+            }
+        }
+    }
+    uint64_t const ms = whole * scale + fraction;
+    if (!any || ms > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<uint32_t>(ms);
+    return true;
+}
+
+struct emitter {
+    emitter(uint8_t* out, std::size_t capacity) : out_(out), capacity_(capacity), size_(0) {}
+
+    void byte(uint8_t value) {
+        if (size_ < capacity_) {
+            out_[size_] = value;
+        }
+        ++size_;
+    }
+
+    void varint(uint32_t value) {
+        while (value >= 0x80) {
+            byte(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        byte(static_cast<uint8_t>(value));
+    }
+
+    bool overflowed() const { return size_ > capacity_; }
+    std::size_t size() const { return size_; }
+
+   private:
+    uint8_t* out_;
+    std::size_t capacity_;
+    std::size_t size_;
+};
+
+struct channel_name {
+    token name;
+    uint8_t channel;
+};
+
+}  // namespace show_script_detail
+
+/**
+ * @brief Compile a text show script to show_vm bytecode
+ *
+ * One instruction per line; # starts a comment. Channels are numbers
+ * (0-255) or names declared with channel, levels are 0-255, and times are
+ * milliseconds ("500", "500ms") or seconds ("2s", "1.25s").
+ *
+ *   channel <name> <number>             name a channel
+ *   level <channel> <level>             set now (on = 255, off = 0 also accepted)
+ *   fade <channel> <level> <time>       fade from wherever it is
+ *   blink <channel> <on> <off> [level]  blink until changed (level 255 by default)
+ *   stop <channel>                      stop blinking, off
+ *   wait <time>                         pause the script
+ *   wait trigger <n>                    pause until trigger n (0-7) fires
+ *   repeat <n> ... end                  n passes (n >= 1), nested up to 4 deep
+ *   loop ... end                        forever; the body must wait
+ *   halt                                end the show (also implied at the end)
+ *
+ * Allocation-free: the output goes to a caller buffer, so the compiler runs
+ * on the board as well as on the host.
+ *
+ * Usage:
+ *   uint8_t bytecode[512];
+ *   show_script_error error;
+ *   std::size_t const size = compile_show_script(text, length, bytecode, sizeof(bytecode), error);
+ *   if (size == 0) { report(error.line, error.message); }
+ *
+ * @return Bytecode size, or 0 with error filled in
+ */
+inline std::size_t compile_show_script(char const* text, std::size_t length, uint8_t* out,
+                                       std::size_t capacity, show_script_error& error) {
+    using namespace show_script_detail;
+    emitter code(out, capacity);
+    code.byte(SHOW_BYTECODE_MAGIC_0);
+    code.byte(SHOW_BYTECODE_MAGIC_1);
+    code.byte(SHOW_BYTECODE_VERSION);
+
+    channel_name names[SHOW_SCRIPT_MAX_NAMES];
+    std::size_t name_count = 0;
+    bool block_forever[SHOW_VM_MAX_DEPTH];
+    bool block_waits[SHOW_VM_MAX_DEPTH];
+    std::size_t depth = 0;
+
+    error.line = 0;
+    error.message = nullptr;
+    char const* const end = text + length;
+    uint32_t line = 0;
+    for (char const* line_start = text; line_start < end;) {
+        ++line;
+        char const* line_end = line_start;
+        while (line_end != end && *line_end != '\n') {
+            ++line_end;
+        }
+        line_tokens const tokens(line_start, line_end);
+        line_start = line_end == end ? end : line_end + 1;
+        error.line = line;
+        if (tokens.overflow) {
+            error.message = "too many words";
+            return 0;
+        }
+        if (tokens.count == 0) {
+            continue;
+        }
+        token const* const t = tokens.tokens;
+        std::size_t const args = tokens.count - 1;
+
+        // Channel operand: declared name or number
+        uint8_t channel = 0;
+        bool channel_ok = false;
+        if (args >= 1 && !t[0].is("channel")) {
+            uint32_t number;
+            if (parse_uint(t[1], 255, number)) {
+                channel = static_cast<uint8_t>(number);
+                channel_ok = true;
+            }
+            for (std::size_t n = 0; n < name_count && !channel_ok; ++n) {
+                token const& name = names[n].name;
+                if (name.length == t[1].length) {
+                    std::size_t i = 0;
+                    while (i < name.length && name.text[i] == t[1].text[i]) {
+                        ++i;
+                    }
+                    if (i == name.length) {
+                        channel = names[n].channel;
+                        channel_ok = true;
+                    }
+                }
+            }
+        }
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+        if (t[0].is("channel")) {
+            if (args != 2 || !parse_uint(t[2], 255, a) || parse_uint(t[1], UINT32_MAX, b)) {
+                error.message = "expected: channel <name> <0-255>";
+                return 0;
+            }
+            if (name_count == SHOW_SCRIPT_MAX_NAMES) {
+                error.message = "too many channel names";
+                return 0;
+            }
+            names[name_count].name = t[1];
+            names[name_count].channel = static_cast<uint8_t>(a);
+            ++name_count;
+        } else if (t[0].is("level")) {
+            if (args != 2 || !channel_ok) {
+                error.message = "expected: level <channel> <0-255|on|off>";
+                return 0;
+            }
+            if (t[2].is("on")) {
+                a = 255;
+            } else if (t[2].is("off")) {
+                a = 0;
+            } else if (!parse_uint(t[2], 255, a)) {
+                error.message = "level must be 0-255, on or off";
+                return 0;
+            }
+            code.byte(static_cast<uint8_t>(show_op::level));
+            code.byte(channel);
+            code.byte(static_cast<uint8_t>(a));
+        } else if (t[0].is("fade")) {
+            if (args != 3 || !channel_ok || !parse_uint(t[2], 255, a) || !parse_ms(t[3], b)) {
+                error.message = "expected: fade <channel> <0-255> <time>";
+                return 0;
+            }
+            code.byte(static_cast<uint8_t>(show_op::fade));
+            code.byte(channel);
+            code.byte(static_cast<uint8_t>(a));
+            code.varint(b);
+        } else if (t[0].is("blink")) {
+            c = 255;
+            if ((args != 3 && args != 4) || !channel_ok || !parse_ms(t[2], a) ||
+                !parse_ms(t[3], b) || (args == 4 && !parse_uint(t[4], 255, c))) {
+                error.message = "expected: blink <channel> <on time> <off time> [0-255]";
+                return 0;
+            }
+            if (a == 0 || b == 0) {
+                error.message = "blink times must be at least 1 ms";
+                return 0;
+            }
+            code.byte(static_cast<uint8_t>(show_op::blink));
+            code.byte(channel);
+            code.byte(static_cast<uint8_t>(c));
+            code.varint(a);
+            code.varint(b);
+        } else if (t[0].is("stop")) {
+            if (args != 1 || !channel_ok) {
+                error.message = "expected: stop <channel>";
+                return 0;
+            }
+            code.byte(static_cast<uint8_t>(show_op::stop));
+            code.byte(channel);
+        } else if (t[0].is("wait")) {
+            if (args == 2 && t[1].is("trigger")) {
+                if (!parse_uint(t[2], SHOW_VM_TRIGGERS - 1, a)) {
+                    error.message = "trigger must be 0-7";
+                    return 0;
+                }
+                code.byte(static_cast<uint8_t>(show_op::wait_trigger));
+                code.byte(static_cast<uint8_t>(a));
+            } else if (args == 1 && parse_ms(t[1], a)) {
+                code.byte(static_cast<uint8_t>(show_op::wait));
+                code.varint(a);
+            } else {
+                error.message = "expected: wait <time> or wait trigger <0-7>";
+                return 0;
+            }
+            if (depth > 0) {
+                block_waits[depth - 1] = true;
+            }
+        } else if (t[0].is("repeat") || t[0].is("loop")) {
+            bool const forever = t[0].is("loop");
+            if (forever ? args != 0 : (args != 1 || !parse_uint(t[1], UINT32_MAX, a) || a == 0)) {
+                error.message = "expected: repeat <count >= 1> or loop";
+                return 0;
+            }
+            if (depth == SHOW_VM_MAX_DEPTH) {
+                error.message = "blocks nested too deep";
+                return 0;
+            }
+            block_forever[depth] = forever;
+            block_waits[depth] = false;
+            ++depth;
+            code.byte(static_cast<uint8_t>(show_op::repeat));
+            code.varint(forever ? 0 : a);
+        } else if (t[0].is("end")) {
+            if (args != 0 || depth == 0) {
+                error.message = "end without repeat or loop";
+                return 0;
+            }
+            --depth;
+            if (block_forever[depth] && !block_waits[depth]) {
+                error.message = "loop never waits";
+                return 0;
+            }
+            if (depth > 0 && block_waits[depth]) {
+                block_waits[depth - 1] = true;
+            }
+            code.byte(static_cast<uint8_t>(show_op::end));
+        } else if (t[0].is("halt")) {
+            if (args != 0) {
+                error.message = "expected: halt";
+                return 0;
+            }
+            code.byte(static_cast<uint8_t>(show_op::halt));
+        } else {
+            error.message = "unknown instruction";
+            return 0;
+        }
+        if (code.overflowed()) {
+            error.message = "bytecode buffer full";
+            return 0;
+        }
+    }
+    if (depth != 0) {
+        error.message = "missing end";
+        return 0;
+    }
+    code.byte(static_cast<uint8_t>(show_op::halt));
+    if (code.overflowed()) {
+        error.message = "bytecode buffer full";
+        return 0;
+    }
+    error.line = 0;
+    return code.size();
+}
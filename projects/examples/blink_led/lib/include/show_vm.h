@@ -0,0 +1,436 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVR__) && !defined(SHOW_VM_PROGRAM_IN_RAM)
+#include <avr/pgmspace.h>
+#define SHOW_VM_READ(address) pgm_read_byte(address)
+#else
+#define SHOW_VM_READ(address) (*(address))
+#endif
+
+/**
+ * @brief Show bytecode instructions
+ *
+ * Operands follow the opcode: channels, levels and triggers are one byte,
+ * times and counts are unsigned LEB128 varints (7 bits per byte, low
+ * first), so a 500 ms wait is 3 bytes and most instructions fit in 4-6.
+ */
+enum class show_op : uint8_t {
+    halt = 0,
+    level = 1,         // channel, level
+    fade = 2,          // channel, level, ms
+    blink = 3,         // channel, level, on ms, off ms (both >= 1)
+    stop = 4,          // channel
+    wait = 5,          // ms
+    repeat = 6,        // count (0 = forever), then the body up to the matching end
+    end = 7,
+    wait_trigger = 8,  // trigger
+};
+
+/// Bytecode header: "SV" and the format version
+static uint8_t const SHOW_BYTECODE_MAGIC_0 = 'S';
+static uint8_t const SHOW_BYTECODE_MAGIC_1 = 'V';
+static uint8_t const SHOW_BYTECODE_VERSION = 1;
+static std::size_t const SHOW_BYTECODE_HEADER_SIZE = 3;
+
+/// Deepest nesting of repeat blocks
+static std::size_t const SHOW_VM_MAX_DEPTH = 4;
+
+/// Triggers 0 to SHOW_VM_TRIGGERS - 1 (sensors, buttons, network cues)
+static uint8_t const SHOW_VM_TRIGGERS = 8;
+
+namespace show_vm_detail {
+
+// Unsigned LEB128 from validated bytecode
+inline uint32_t read_varint(uint8_t const*& p) {
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = SHOW_VM_READ(p++);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+// Checked LEB128: false past end or beyond 32 bits
+inline bool check_varint(uint8_t const*& p, uint8_t const* end, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (p == end) {
+            return false;
+        }
+        uint8_t const byte = SHOW_VM_READ(p++);
+        if (shift == 28 && (byte & 0x70) != 0) {
+            return false;
+        }
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace show_vm_detail
+
+/**
+ * @brief Allocation-free interpreter for compiled show scripts
+ *
+ * Runs show bytecode (show_script.h compiles the text form) against fade
+ * controllers bound per channel, the same way cue_list drives them:
+ *   - level and fade set a channel directly or fade it over a time
+ *   - blink toggles a channel between a level and 0 until the next level,
+ *     fade or stop on it
+ *   - wait and wait_trigger suspend the program until a time or until
+ *     trigger() is called
+ *   - repeat blocks nest up to SHOW_VM_MAX_DEPTH deep
+ *
+ * Time is scheduled, not sampled: a wait ends at the time the previous
+ * wait ended plus its length, and instructions after it take effect at
+ * that time even when update() runs late, so programs do not drift. A
+ * trigger resumes at the time passed to trigger().
+ *
+ * load() validates the whole program once (opcodes, operands, channels,
+ * nesting), so bytecode from a file or a serial link cannot make the
+ * interpreter read out of bounds. update() runs at most
+ * ops_per_update_v instructions, then drives blinking channels and the
+ * bound fades; a program that never waits cannot stall the loop.
+ *
+ * On AVR the program is read from flash (PROGMEM) unless
+ * SHOW_VM_PROGRAM_IN_RAM is defined. RAM is the channel table
+ * (15 bytes plus a pointer per channel) and about 50 bytes of registers
+ * and loop stack.
+ *
+ * Usage:
+ *   static uint8_t const show[] PROGMEM = {...};  // show_compile output
+ *   show_vm<fade_controller<level_pin>, 8> vm;
+ *   vm.bind(0, fade);
+ *   vm.load(show, sizeof(show));
+ *   vm.start(millis());
+ *   vm.update(millis());           // every loop
+ *   vm.trigger(0, millis());       // from a motion sensor
+ *
+ * @tparam fade_t Type with jump_to(), set_fade_duration(), set_target() and
+ *         update() (fade_controller)
+ * @tparam channels_v Channels (1 to 256)
+ * @tparam ops_per_update_v Instructions run per update() at most
+ */
+template<typename fade_t, std::size_t channels_v, std::size_t ops_per_update_v = 64>
+struct show_vm {
+   public:
+    static_assert(channels_v >= 1 && channels_v <= 256, "1 to 256 channels");
+    static_assert(ops_per_update_v >= 1, "at least one instruction per update");
+
+    show_vm()
+        : program_(nullptr),
+          size_(0),
+          pc_(0),
+          depth_(0),
+          wake_ms_(0),
+          op_count_(0),
+          state_(vm_state::idle),
+          trigger_(0) {
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            outputs_[c] = nullptr;
+            channels_[c].blinking = false;
+        }
+    }
+
+    /**
+     * @brief Drive a channel's fade controller from the program
+     */
+    bool bind(std::size_t channel, fade_t& fade) {
+        if (channel >= channels_v) {
+            return false;
+        }
+        outputs_[channel] = &fade;
+        return true;
+    }
+
+    /**
+     * @brief Validate and install a program (the bytes must outlive the VM's use)
+     *
+     * @return false if the bytecode is malformed or uses channels beyond channels_v
+     */
+    bool load(uint8_t const* program, std::size_t size) {
+        state_ = vm_state::idle;
+        if (!validate(program, size)) {
+            program_ = nullptr;
+            size_ = 0;
+            return false;
+        }
+        program_ = program;
+        size_ = size;
+        return true;
+    }
+
+    /**
+     * @brief Run the loaded program from the top, starting at start_ms
+     */
+    bool start(uint32_t start_ms) {
+        if (program_ == nullptr) {
+            return false;
+        }
+        pc_ = SHOW_BYTECODE_HEADER_SIZE;
+        depth_ = 0;
+        wake_ms_ = start_ms;
+        state_ = size_ == SHOW_BYTECODE_HEADER_SIZE ? vm_state::halted : vm_state::running;
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            channels_[c].blinking = false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Run due instructions, then drive blinks and fades
+     *
+     * @param now_ms Current time in milliseconds
+     */
+    void update(uint32_t now_ms) {
+        run(now_ms);
+        for (std::size_t c = 0; c < channels_v; ++c) {
+            if (channels_[c].blinking) {
+                advance_blink(c, now_ms);
+            }
+            if (outputs_[c] != nullptr) {
+                outputs_[c]->update(now_ms);
+            }
+        }
+    }
+
+    /**
+     * @brief Fire a trigger; resumes the program if it is waiting for it
+     *
+     * @return true if the program was waiting for this trigger
+     */
+    bool trigger(uint8_t number, uint32_t now_ms) {
+        if (state_ != vm_state::triggered_wait || number != trigger_) {
+            return false;
+        }
+        state_ = vm_state::running;
+        wake_ms_ = now_ms;
+        return true;
+    }
+
+    bool is_running() const { return state_ != vm_state::idle && state_ != vm_state::halted; }
+    bool is_halted() const { return state_ == vm_state::halted; }
+    bool is_waiting_for_trigger() const { return state_ == vm_state::triggered_wait; }
+    std::size_t get_pc() const { return pc_; }
+    uint32_t get_op_count() const { return op_count_; }
+    bool is_blinking(std::size_t channel) const { return channels_[channel].blinking; }
+
+   private:
+    enum class vm_state : uint8_t { idle, running, triggered_wait, halted };
+
+    struct channel_state {
+        uint32_t on_ms;
+        uint32_t off_ms;
+        uint32_t next_edge_ms;
+        uint8_t level;
+        bool blinking;
+        bool lit;
+    };
+
+    struct loop_frame {
+        uint32_t body;       // pc of the first body instruction
+        uint32_t remaining;  // Passes left including this one (0 = forever)
+    };
+
+    void run(uint32_t now_ms) {
+        using show_vm_detail::read_varint;
+        for (std::size_t budget = ops_per_update_v; budget > 0; --budget) {
+            if (state_ != vm_state::running ||
+                static_cast<int32_t>(now_ms - wake_ms_) < 0) {
+                return;
+            }
+            uint8_t const* p = program_ + pc_;
+            show_op const op = static_cast<show_op>(SHOW_VM_READ(p++));
+            ++op_count_;
+            switch (op) {
+                case show_op::level: {
+                    uint8_t const channel = SHOW_VM_READ(p++);
+                    channels_[channel].blinking = false;
+                    jump(channel, SHOW_VM_READ(p++));
+                    break;
+                }
+                case show_op::fade: {
+                    uint8_t const channel = SHOW_VM_READ(p++);
+                    uint8_t const level = SHOW_VM_READ(p++);
+                    uint32_t const fade_ms = read_varint(p);
+                    channels_[channel].blinking = false;
+                    if (outputs_[channel] != nullptr) {
+                        outputs_[channel]->set_fade_duration(fade_ms);
+                        outputs_[channel]->set_target(level, wake_ms_);
+                    }
+                    break;
+                }
+                case show_op::blink: {
+                    uint8_t const index = SHOW_VM_READ(p++);
+                    channel_state& channel = channels_[index];
+                    channel.level = SHOW_VM_READ(p++);
+                    channel.on_ms = read_varint(p);
+                    channel.off_ms = read_varint(p);
+                    channel.blinking = true;
+                    channel.lit = true;
+                    channel.next_edge_ms = wake_ms_ + channel.on_ms;
+                    jump(index, channel.level);
+                    break;
+                }
+                case show_op::stop: {
+                    uint8_t const channel = SHOW_VM_READ(p++);
+                    channels_[channel].blinking = false;
+                    jump(channel, 0);
+                    break;
+                }
+                case show_op::wait:
+                    wake_ms_ += read_varint(p);
+                    break;
+                case show_op::repeat: {
+                    loop_frame& frame = stack_[depth_++];
+                    frame.remaining = read_varint(p);
+                    frame.body = static_cast<uint32_t>(p - program_);
+                    break;
+                }
+                case show_op::end: {
+                    loop_frame& frame = stack_[depth_ - 1];
+                    if (frame.remaining == 0 || --frame.remaining > 0) {
+                        p = program_ + frame.body;
+                    } else {
+                        --depth_;
+                    }
+                    break;
+                }
+                case show_op::wait_trigger:
+                    trigger_ = SHOW_VM_READ(p++);
+                    state_ = vm_state::triggered_wait;
+                    break;
+                case show_op::halt:
+                    state_ = vm_state::halted;
+                    return;
+            }
+            pc_ = static_cast<std::size_t>(p - program_);
+            if (pc_ == size_) {
+                state_ = vm_state::halted;
+            }
+        }
+    }
+
+    // Edges due by now_ms; whole periods behind are skipped arithmetically
+    void advance_blink(std::size_t index, uint32_t now_ms) {
+        channel_state& channel = channels_[index];
+        if (static_cast<int32_t>(now_ms - channel.next_edge_ms) < 0) {
+            return;
+        }
+        uint32_t const behind = now_ms - channel.next_edge_ms;
+        uint64_t const period = static_cast<uint64_t>(channel.on_ms) + channel.off_ms;
+        channel.next_edge_ms += static_cast<uint32_t>(behind / period * period);
+        while (static_cast<int32_t>(now_ms - channel.next_edge_ms) >= 0) {
+            channel.lit = !channel.lit;
+            channel.next_edge_ms += channel.lit ? channel.on_ms : channel.off_ms;
+        }
+        jump(index, channel.lit ? channel.level : 0);
+    }
+
+    void jump(std::size_t channel, uint8_t level) {
+        if (outputs_[channel] != nullptr) {
+            outputs_[channel]->jump_to(level);
+        }
+    }
+
+    // One pass over the program: every operand present and in range, blocks balanced
+    static bool validate(uint8_t const* program, std::size_t size) {
+        using show_vm_detail::check_varint;
+        if (program == nullptr || size < SHOW_BYTECODE_HEADER_SIZE ||
+            SHOW_VM_READ(program) != SHOW_BYTECODE_MAGIC_0 ||
+            SHOW_VM_READ(program + 1) != SHOW_BYTECODE_MAGIC_1 ||
+            SHOW_VM_READ(program + 2) != SHOW_BYTECODE_VERSION || size > UINT32_MAX) {
+            return false;
+        }
+        uint8_t const* p = program + SHOW_BYTECODE_HEADER_SIZE;
+        uint8_t const* const end = program + size;
+        std::size_t depth = 0;
+        uint32_t value;
+        while (p != end) {
+            show_op const op = static_cast<show_op>(SHOW_VM_READ(p++));
+            uint8_t const operand_bytes =
+                op == show_op::level || op == show_op::fade || op == show_op::blink ? 2
+                : op == show_op::stop || op == show_op::wait_trigger                ? 1
+                                                                                    : 0;
+            if (static_cast<std::size_t>(end - p) < operand_bytes) {
+                return false;
+            }
+            switch (op) {
+                case show_op::halt:
+                    break;
+                case show_op::level:
+                case show_op::stop:
+                    if (SHOW_VM_READ(p) >= channels_v) {
+                        return false;
+                    }
+                    p += operand_bytes;
+                    break;
+                case show_op::fade:
+                    if (SHOW_VM_READ(p) >= channels_v) {
+                        return false;
+                    }
+                    p += operand_bytes;
+                    if (!check_varint(p, end, value)) {
+                        return false;
+                    }
+                    break;
+                case show_op::blink: {
+                    if (SHOW_VM_READ(p) >= channels_v) {
+                        return false;
+                    }
+                    p += operand_bytes;
+                    uint32_t off_ms;
+                    if (!check_varint(p, end, value) || !check_varint(p, end, off_ms) ||
+                        value == 0 || off_ms == 0) {
+                        return false;
+                    }
+                    break;
+                }
+                case show_op::wait:
+                    if (!check_varint(p, end, value)) {
+                        return false;
+                    }
+                    break;
+                case show_op::repeat:
+                    if (!check_varint(p, end, value) || depth == SHOW_VM_MAX_DEPTH) {
+                        return false;
+                    }
+                    ++depth;
+                    break;
+                case show_op::end:
+                    if (depth == 0) {
+                        return false;
+                    }
+                    --depth;
+                    break;
+                case show_op::wait_trigger:
+                    if (SHOW_VM_READ(p++) >= SHOW_VM_TRIGGERS) {
+                        return false;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return depth == 0;
+    }
+
+    uint8_t const* program_;
+    std::size_t size_;
+    std::size_t pc_;
+    std::size_t depth_;
+    uint32_t wake_ms_;
+    uint32_t op_count_;
+    vm_state state_;
+    uint8_t trigger_;
+    loop_frame stack_[SHOW_VM_MAX_DEPTH];
+    channel_state channels_[channels_v];
+    fade_t* outputs_[channels_v];
+};
@@ -0,0 +1,517 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Standard MIDI File (SMF) and MIDI Show Control (MSC) cue import
+ *
+ * Sound designers deliver cue timing as .mid files. smf_importer turns one
+ * into a time-sorted array of midi_cue (12 bytes each) in a single pass:
+ * the tracks are merged as they are read (every track keeps a cursor and
+ * the earliest next event is taken), so the output is sorted without a sort
+ * and nothing is buffered per event.
+ *
+ * Time is exact. Each tick's length is kept as the rational
+ * tempo / division microseconds, and elapsed time is accumulated as an
+ * integer count of 1/division microseconds, so a tick position maps to the
+ * same millisecond however many tempo changes precede it (no float drift).
+ *
+ * Platform-agnostic (no heap, no STL): the file is read from memory and the
+ * cues are written to a caller-provided array.
+ */
+enum class midi_cue_type : uint8_t {
+    note_on = 0,
+    note_off = 1,
+    control_change = 2,
+    program_change = 3,
+    show_control = 4  // MSC command
+};
+
+/**
+ * @brief One imported event at its controller time
+ *
+ *   type            channel       number       value        cue
+ *   note_on/off     0-15          note         velocity     MIDI_CUE_NONE
+ *   control_change  0-15          controller   value        MIDI_CUE_NONE
+ *   program_change  0-15          program      0            MIDI_CUE_NONE
+ *   show_control    device id     command      format       cue number
+ */
+struct midi_cue {
+    uint32_t time_ms;
+    midi_cue_type type;
+    uint8_t channel;
+    uint8_t number;
+    uint8_t value;
+    uint32_t cue;  // MSC cue number in thousandths ("12.5" -> 12500)
+};
+
+static uint32_t const MIDI_CUE_NONE = 0xFFFFFFFFu;
+static uint32_t const SMF_DEFAULT_TEMPO = 500000;  // us per quarter note (120 BPM)
+
+// MSC command numbers (MIDI Show Control 1.0)
+static uint8_t const MSC_GO = 0x01;
+static uint8_t const MSC_STOP = 0x02;
+static uint8_t const MSC_RESUME = 0x03;
+static uint8_t const MSC_TIMED_GO = 0x04;
+static uint8_t const MSC_LOAD = 0x05;
+static uint8_t const MSC_SET = 0x06;
+static uint8_t const MSC_FIRE = 0x07;
+static uint8_t const MSC_ALL_OFF = 0x08;
+static uint8_t const MSC_RESTORE = 0x09;
+static uint8_t const MSC_RESET = 0x0A;
+static uint8_t const MSC_GO_OFF = 0x0B;
+
+namespace smf_detail {
+
+inline uint32_t read_u32(uint8_t const* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline uint16_t read_u16(uint8_t const* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+// Variable-length quantity (at most 4 bytes); false if truncated or too long
+inline bool read_vlq(uint8_t const*& p, uint8_t const* end, uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (p == end) {
+            return false;
+        }
+        uint8_t const byte = *p++;
+        value = (value << 7) | (byte & 0x7F);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Data bytes following a channel status byte
+inline std::size_t channel_data_size(uint8_t status) {
+    uint8_t const kind = status & 0xF0;
+    return kind == 0xC0 || kind == 0xD0 ? 1 : 2;
+}
+
+// MSC cue number: ASCII "12.5" -> 12500 (three decimals kept)
+inline uint32_t parse_cue_number(uint8_t const* p, uint8_t const* end) {
+    uint32_t whole = 0;
+    uint32_t fraction = 0;
+    uint32_t scale = 1000;
+    bool fractional = false;
+    bool digits = false;
+    for (; p < end && *p != 0x00 && *p != 0xF7; ++p) {
+        if (*p == '.') {
+            if (fractional) {
+                break;  // "1.2.3": sub-parts beyond the first are ignored
+            }
+            fractional = true;
+        } else if (*p >= '0' && *p <= '9') {
+            digits = true;
+            if (!fractional) {
+                whole = whole * 10 + (*p - '0');
+            } else if (scale > 1) {
+                scale /= 10;
+                fraction += (*p - '0') * scale;
+            }
+        } else {
+            return MIDI_CUE_NONE;
+        }
+    }
+    return digits ? whole * 1000 + fraction : MIDI_CUE_NONE;
+}
+
+}  // namespace smf_detail
+
+/**
+ * @brief Exact tick-to-millisecond map built from SMF tempo events
+ *
+ * A tick lasts tick_num / tick_den microseconds: tempo / division for
+ * metrical files, 1000000 / (fps * ticks per frame) for SMPTE ones. Each
+ * segment records where it starts in ticks and in elapsed 1/tick_den
+ * microseconds, so tick_to_ms() is a search plus one multiply-add.
+ *
+ * Usage:
+ *   uint32_t const ms = importer.get_tempo_map().tick_to_ms(tick);
+ *
+ * @tparam max_segments_v Tempo changes held (the initial tempo included)
+ */
+template<std::size_t max_segments_v>
+struct smf_tempo_map {
+   public:
+    static_assert(max_segments_v >= 1, "need room for the initial tempo");
+
+    struct segment {
+        uint32_t tick;
+        uint32_t tick_num;  // Tick length numerator (tempo in us per quarter note)
+        uint64_t elapsed;   // Time at tick, in 1/tick_den microseconds
+    };
+
+    smf_tempo_map() { reset(SMF_DEFAULT_TEMPO, 480); }
+
+    /**
+     * @brief Start over with one segment from tick 0
+     */
+    void reset(uint32_t tick_num, uint32_t tick_den) {
+        tick_den_ = tick_den;
+        segments_[0].tick = 0;
+        segments_[0].tick_num = tick_num;
+        segments_[0].elapsed = 0;
+        count_ = 1;
+    }
+
+    /**
+     * @brief Change the tick length from tick onwards (ticks non-decreasing)
+     *
+     * @return false Out of segments or tick went backwards
+     */
+    bool add(uint32_t tick, uint32_t tick_num) {
+        segment& last = segments_[count_ - 1];
+        if (tick < last.tick) {
+            return false;
+        }
+        if (tick == last.tick) {
+            last.tick_num = tick_num;  // Same tick: the later tempo wins
+            return true;
+        }
+        if (count_ == max_segments_v) {
+            return false;
+        }
+        segment& next = segments_[count_++];
+        next.tick = tick;
+        next.tick_num = tick_num;
+        next.elapsed = elapsed_at(last, tick);
+        return true;
+    }
+
+    /**
+     * @brief Elapsed time at a tick in 1/tick_den microseconds (exact)
+     */
+    uint64_t tick_to_elapsed(uint32_t tick) const { return elapsed_at(find(tick), tick); }
+
+    /**
+     * @brief Controller time of a tick (nearest millisecond)
+     */
+    uint32_t tick_to_ms(uint32_t tick) const { return elapsed_to_ms(tick_to_elapsed(tick)); }
+
+    uint32_t elapsed_to_ms(uint64_t elapsed) const {
+        uint64_t const per_ms = static_cast<uint64_t>(tick_den_) * 1000;
+        return static_cast<uint32_t>((elapsed + per_ms / 2) / per_ms);
+    }
+
+    std::size_t get_segment_count() const { return count_; }
+    segment const& get_segment(std::size_t index) const { return segments_[index]; }
+    uint32_t get_tick_den() const { return tick_den_; }
+
+   private:
+    static uint64_t elapsed_at(segment const& s, uint32_t tick) {
+        return s.elapsed + static_cast<uint64_t>(tick - s.tick) * s.tick_num;
+    }
+
+    // Last segment starting at or before tick (in-order lookups hit the first test)
+    segment const& find(uint32_t tick) const {
+        if (segments_[count_ - 1].tick <= tick) {
+            return segments_[count_ - 1];
+        }
+        std::size_t low = 0;
+        std::size_t high = count_;
+        while (high - low > 1) {
+            std::size_t const mid = (low + high) / 2;
+            if (segments_[mid].tick <= tick) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return segments_[low];
+    }
+
+    segment segments_[max_segments_v];
+    std::size_t count_;
+    uint32_t tick_den_;
+};
+
+/**
+ * @brief Single-pass SMF (format 0 or 1) to cue array converter
+ *
+ * Imported: note on/off (note on with velocity 0 is reported as note off),
+ * control change, program change and MSC SysEx (F0 7F <device> 02 ...).
+ * Tempo meta events build the tempo map. Everything else (pitch bend,
+ * aftertouch, other SysEx, other meta events) is skipped and counted.
+ * Events at the same tick keep track order, then file order.
+ *
+ * Usage:
+ *   smf_importer<> importer;
+ *   std::size_t count = 0;
+ *   importer.import(file, size, nullptr, 0, count);  // Optional sizing pass
+ *   std::vector<midi_cue> cues(count);
+ *   importer.import(file, size, cues.data(), cues.size(), count);
+ *
+ * @tparam max_tracks_v Tracks merged at once
+ * @tparam max_tempos_v Tempo changes kept in the tempo map
+ */
+template<std::size_t max_tracks_v = 32, std::size_t max_tempos_v = 512>
+struct smf_importer {
+   public:
+    static std::size_t const MAX_TRACKS = max_tracks_v;
+
+    smf_importer() : format_(0), track_count_(0), division_(0), skipped_(0) {}
+
+    /**
+     * @brief Convert a whole file
+     *
+     * @param data File contents
+     * @param length File size
+     * @param cues Output array, or nullptr to only count the cues
+     * @param capacity Entries available in cues
+     * @param count Cues produced (or needed, when cues is nullptr)
+     * @return false Malformed or unsupported file (format 2, too many tracks
+     *         or tempo changes), or more cues than capacity
+     */
+    bool import(uint8_t const* data, std::size_t length, midi_cue* cues, std::size_t capacity,
+                std::size_t& count) {
+        count = 0;
+        skipped_ = 0;
+        if (!read_header(data, length)) {
+            return false;
+        }
+        while (true) {
+            // Earliest pending event; lowest track first among equals
+            track* next = nullptr;
+            for (std::size_t t = 0; t < track_count_; ++t) {
+                track& candidate = tracks_[t];
+                if (!candidate.done && (next == nullptr || candidate.tick < next->tick)) {
+                    next = &candidate;
+                }
+            }
+            if (next == nullptr) {
+                return true;
+            }
+            midi_cue cue;
+            bool produced = false;
+            if (!read_event(*next, cue, produced)) {
+                return false;
+            }
+            if (produced) {
+                if (cues != nullptr) {
+                    if (count == capacity) {
+                        return false;
+                    }
+                    cues[count] = cue;
+                }
+                ++count;
+            }
+            if (!next->done && !advance(*next)) {
+                return false;
+            }
+        }
+    }
+
+    smf_tempo_map<max_tempos_v> const& get_tempo_map() const { return tempo_map_; }
+    uint16_t get_format() const { return format_; }
+    std::size_t get_track_count() const { return track_count_; }
+    uint16_t get_division() const { return division_; }
+    uint32_t get_skipped() const { return skipped_; }
+
+   private:
+    struct track {
+        uint8_t const* p;
+        uint8_t const* end;
+        uint32_t tick;  // Absolute tick of the event at p
+        uint8_t running_status;
+        bool done;
+    };
+
+    bool read_header(uint8_t const* data, std::size_t length) {
+        if (length < 14 || data[0] != 'M' || data[1] != 'T' || data[2] != 'h' || data[3] != 'd') {
+            return false;
+        }
+        uint32_t const header_size = smf_detail::read_u32(data + 4);
+        format_ = smf_detail::read_u16(data + 8);
+        uint16_t const declared_tracks = smf_detail::read_u16(data + 10);
+        division_ = smf_detail::read_u16(data + 12);
+        if (header_size < 6 || header_size > length - 8 || format_ > 1 ||
+            declared_tracks > max_tracks_v || (division_ & 0x7FFF) == 0) {
+            return false;
+        }
+        if ((division_ & 0x8000) == 0) {
+            tempo_map_.reset(SMF_DEFAULT_TEMPO, division_);
+        } else {
+            // SMPTE: -fps in the high byte, ticks per frame in the low byte
+            uint32_t const fps = static_cast<uint32_t>(256 - (division_ >> 8));
+            uint32_t const ticks_per_frame = division_ & 0xFF;
+            if (ticks_per_frame == 0 || (fps != 24 && fps != 25 && fps != 29 && fps != 30)) {
+                return false;
+            }
+            // 29 means 29.97 drop-frame: 30000/1001 frames per second
+            tempo_map_.reset(fps == 29 ? 1001000000u : 1000000u,
+                             fps == 29 ? 30000 * ticks_per_frame : fps * ticks_per_frame);
+        }
+
+        uint8_t const* p = data + 8 + header_size;
+        uint8_t const* const end = data + length;
+        track_count_ = 0;
+        while (track_count_ < declared_tracks && end - p >= 8) {
+            uint32_t const chunk_size = smf_detail::read_u32(p + 4);
+            if (chunk_size > static_cast<std::size_t>(end - p) - 8) {
+                return false;
+            }
+            bool const is_track = p[0] == 'M' && p[1] == 'T' && p[2] == 'r' && p[3] == 'k';
+            if (is_track) {
+                track& t = tracks_[track_count_++];
+                t.p = p + 8;
+                t.end = p + 8 + chunk_size;
+                t.tick = 0;
+                t.running_status = 0;
+                t.done = false;
+                if (!advance_from(t, 0)) {
+                    return false;
+                }
+            }
+            p += 8 + chunk_size;  // Unknown chunks are skipped
+        }
+        return track_count_ == declared_tracks;
+    }
+
+    // Read the next delta time; an empty track just ends
+    bool advance(track& t) { return advance_from(t, t.tick); }
+
+    bool advance_from(track& t, uint32_t tick) {
+        if (t.p == t.end) {
+            t.done = true;
+            return true;
+        }
+        uint32_t delta = 0;
+        if (!smf_detail::read_vlq(t.p, t.end, delta)) {
+            return false;
+        }
+        t.tick = tick + delta;
+        return true;
+    }
+
+    bool read_event(track& t, midi_cue& cue, bool& produced) {
+        if (t.p == t.end) {
+            return false;  // Delta time without an event
+        }
+        uint8_t status = *t.p;
+        if (status < 0x80) {
+            if (t.running_status == 0) {
+                return false;
+            }
+            status = t.running_status;  // Data byte: reuse the previous status
+        } else {
+            ++t.p;
+        }
+
+        if (status == 0xFF) {
+            t.running_status = 0;
+            return read_meta(t);
+        }
+        if (status == 0xF0 || status == 0xF7) {
+            t.running_status = 0;
+            uint32_t size = 0;
+            if (!smf_detail::read_vlq(t.p, t.end, size) ||
+                size > static_cast<std::size_t>(t.end - t.p)) {
+                return false;
+            }
+            produced = status == 0xF0 && read_show_control(t.p, t.p + size, t.tick, cue);
+            skipped_ += produced ? 0 : 1;
+            t.p += size;
+            return true;
+        }
+        if (status >= 0xF0) {
+            return false;  // System common/real-time bytes are not valid in a file
+        }
+
+        t.running_status = status;
+        std::size_t const size = smf_detail::channel_data_size(status);
+        if (static_cast<std::size_t>(t.end - t.p) < size) {
+            return false;
+        }
+        uint8_t const first = t.p[0];
+        uint8_t const second = size == 2 ? t.p[1] : 0;
+        t.p += size;
+        if ((first | second) & 0x80) {
+            return false;
+        }
+
+        cue.time_ms = tempo_map_.tick_to_ms(t.tick);
+        cue.channel = status & 0x0F;
+        cue.number = first;
+        cue.value = second;
+        cue.cue = MIDI_CUE_NONE;
+        produced = true;
+        switch (status & 0xF0) {
+            case 0x80:
+                cue.type = midi_cue_type::note_off;
+                break;
+            case 0x90:
+                cue.type = second == 0 ? midi_cue_type::note_off : midi_cue_type::note_on;
+                break;
+            case 0xB0:
+                cue.type = midi_cue_type::control_change;
+                break;
+            case 0xC0:
+                cue.type = midi_cue_type::program_change;
+                break;
+            default:
+                produced = false;  // Aftertouch, channel pressure, pitch bend
+                ++skipped_;
+                break;
+        }
+        return true;
+    }
+
+    bool read_meta(track& t) {
+        if (t.p == t.end) {
+            return false;
+        }
+        uint8_t const type = *t.p++;
+        uint32_t size = 0;
+        if (!smf_detail::read_vlq(t.p, t.end, size) ||
+            size > static_cast<std::size_t>(t.end - t.p)) {
+            return false;
+        }
+        uint8_t const* const body = t.p;
+        t.p += size;
+        if (type == 0x2F) {
+            t.done = true;  // End of track; anything after it is ignored
+            return true;
+        }
+        if (type == 0x51 && size == 3) {
+            if ((division_ & 0x8000) != 0) {
+                return true;  // SMPTE time ignores tempo
+            }
+            uint32_t const tempo = (static_cast<uint32_t>(body[0]) << 16) |
+                                   (static_cast<uint32_t>(body[1]) << 8) | body[2];
+            return tempo != 0 && tempo_map_.add(t.tick, tempo);
+        }
+        ++skipped_;
+        return true;
+    }
+
+    // F0 7F <device> 02 <format> <command> [cue] [00 list] [00 path] F7
+    bool read_show_control(uint8_t const* p, uint8_t const* end, uint32_t tick, midi_cue& cue) {
+        if (end - p < 5 || p[0] != 0x7F || p[2] != 0x02) {
+            return false;
+        }
+        cue.time_ms = tempo_map_.tick_to_ms(tick);
+        cue.type = midi_cue_type::show_control;
+        cue.channel = p[1];
+        cue.value = p[3];
+        cue.number = p[4];
+        cue.cue = smf_detail::parse_cue_number(p + 5, end);
+        return true;
+    }
+
+    track tracks_[max_tracks_v];
+    smf_tempo_map<max_tempos_v> tempo_map_;
+    uint16_t format_;
+    std::size_t track_count_;
+    uint16_t division_;
+    uint32_t skipped_;
+};
+
+template<std::size_t max_tracks_v, std::size_t max_tempos_v>
+std::size_t const smf_importer<max_tracks_v, max_tempos_v>::MAX_TRACKS;
@@ -0,0 +1,389 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Sound effect held in memory, not owned
+ *
+ * Interleaved int16 frames with the mixer's channel count. Float WAV files
+ * are converted to int16 as they are read (wav_reader).
+ */
+struct sound_clip {
+    int16_t const* samples;
+    uint32_t frames;
+    uint16_t channels;
+};
+
+// Voice gains are Q14: 16384 is unity, 32767 just under +6 dB
+static int16_t const MIXER_UNITY_GAIN = 16384;
+
+/**
+ * @brief Add samples scaled by a Q14 gain into 32-bit accumulators, scalar
+ */
+inline void mix_gain_scalar(int32_t* acc, int16_t const* samples, std::size_t count,
+                            int16_t gain) {
+    for (std::size_t i = 0; i < count; ++i) {
+        acc[i] += (static_cast<int32_t>(samples[i]) * gain) >> 14;
+    }
+}
+
+/**
+ * @brief mix_gain_scalar(), 8 samples per step with SSE2 or NEON
+ *
+ * Full 32-bit products (SSE2: mullo/mulhi pairs), so the result matches the
+ * scalar path exactly.
+ */
+inline void mix_gain(int32_t* acc, int16_t const* samples, std::size_t count, int16_t gain) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    __m128i const g = _mm_set1_epi16(gain);
+    for (; i + 8 <= count; i += 8) {
+        __m128i const x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(samples + i));
+        __m128i const lo = _mm_mullo_epi16(x, g);
+        __m128i const hi = _mm_mulhi_epi16(x, g);
+        __m128i* out = reinterpret_cast<__m128i*>(acc + i);
+        __m128i const p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 14);
+        __m128i const p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 14);
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), p0));
+        _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), p1));
+    }
+#elif defined(__ARM_NEON)
+    int16x4_t const g = vdup_n_s16(gain);
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t const x = vld1q_s16(samples + i);
+        int32x4_t const p0 = vshrq_n_s32(vmull_s16(vget_low_s16(x), g), 14);
+        int32x4_t const p1 = vshrq_n_s32(vmull_s16(vget_high_s16(x), g), 14);
+        vst1q_s32(acc + i, vaddq_s32(vld1q_s32(acc + i), p0));
+        vst1q_s32(acc + i + 4, vaddq_s32(vld1q_s32(acc + i + 4), p1));
+    }
+#endif
+    mix_gain_scalar(acc + i, samples + i, count - i, gain);
+}
+
+/**
+ * @brief Saturate 32-bit accumulators to int16 output
+ *
+ * @return std::size_t Samples that clipped
+ */
+inline std::size_t mix_saturate(int16_t* out, int32_t const* acc, std::size_t count) {
+    std::size_t clipped = 0;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i const a0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(acc + i));
+        __m128i const a1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(acc + i + 4));
+        __m128i const packed = _mm_packs_epi32(a0, a1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+        // A lane clipped if widening it back does not give the accumulator
+        __m128i const back0 = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+        __m128i const back1 = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+        __m128i const same = _mm_packs_epi32(_mm_cmpeq_epi32(a0, back0),
+                                             _mm_cmpeq_epi32(a1, back1));
+        clipped += 8 - __builtin_popcount(_mm_movemask_epi8(same)) / 2;
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int32x4_t const a0 = vld1q_s32(acc + i);
+        int32x4_t const a1 = vld1q_s32(acc + i + 4);
+        int16x8_t const packed = vcombine_s16(vqmovn_s32(a0), vqmovn_s32(a1));
+        vst1q_s16(out + i, packed);
+        uint32x4_t const same0 = vceqq_s32(a0, vmovl_s16(vget_low_s16(packed)));
+        uint32x4_t const same1 = vceqq_s32(a1, vmovl_s16(vget_high_s16(packed)));
+        uint32x4_t const ones = vaddq_u32(vshrq_n_u32(same0, 31), vshrq_n_u32(same1, 31));
+        clipped += 8 - (vgetq_lane_u32(ones, 0) + vgetq_lane_u32(ones, 1) +
+                        vgetq_lane_u32(ones, 2) + vgetq_lane_u32(ones, 3));
+    }
+#endif
+    for (; i < count; ++i) {
+        int32_t const value = acc[i];
+        out[i] = value > 32767 ? 32767 : (value < -32768 ? -32768 : static_cast<int16_t>(value));
+        clipped += out[i] != value ? 1 : 0;
+    }
+    return clipped;
+}
+
+/**
+ * @brief Sample-accurate sound effect mixer on the show clock
+ *
+ * Voices start on an exact output frame: trigger() converts a controller
+ * time in milliseconds to the first frame at or after it, so a cue sent
+ * ahead of time lands mid-block on its sample. The rendered frame count is
+ * the show clock: get_time_ms() is the controller time for the next block,
+ * and passing it to blink_controller::update() keeps lights and sound on
+ * one timeline that cannot drift.
+ *
+ * Each block is summed into 32-bit accumulators (mix_gain(), SSE2/NEON) and
+ * saturated to int16 once, so loud overlaps clip instead of wrapping and
+ * the result does not depend on voice order. Gain changes ramp linearly per
+ * frame. No allocation: voices and the accumulator are fixed arrays.
+ *
+ * Usage:
+ *   sound_mixer<> mixer(48000, 2);
+ *   mixer.start(0);
+ *   uint32_t const now = mixer.get_time_ms();
+ *   blink.update(now);
+ *   if (cue_due) { mixer.trigger(scream, now); }
+ *   mixer.render(block, 48);                    // 1 ms at 48 kHz
+ *   out.write(block, 48);                       // wav_writer (file or pipe)
+ *
+ * @tparam max_voices_v Voices playing at once (at most 256)
+ * @tparam block_frames_v Frames summed per pass (accumulator size)
+ */
+template<std::size_t max_voices_v = 32, std::size_t block_frames_v = 256>
+struct sound_mixer {
+   public:
+    static_assert(max_voices_v >= 1 && max_voices_v <= 256, "1 to 256 voices");
+
+    static std::size_t const MAX_CHANNELS = 8;
+    static uint32_t const NO_VOICE = 0xFFFFFFFFu;
+
+    sound_mixer(uint32_t sample_rate, uint16_t channels)
+        : sample_rate_(sample_rate),
+          channels_(channels < 1 ? 1 : (channels > 8 ? 8 : channels)),
+          origin_ms_(0),
+          frame_(0),
+          clipped_(0),
+          late_(0),
+          dropped_(0) {
+        for (std::size_t v = 0; v < max_voices_v; ++v) {
+            voices_[v].active = false;
+            voices_[v].generation = 0;
+        }
+    }
+
+    /**
+     * @brief Frame 0 of the output plays at controller time now_ms; stops all voices
+     */
+    void start(uint32_t now_ms) {
+        origin_ms_ = now_ms;
+        frame_ = 0;
+        for (std::size_t v = 0; v < max_voices_v; ++v) {
+            voices_[v].active = false;
+        }
+    }
+
+    /**
+     * @brief Play a clip from controller time at_ms
+     *
+     * Times already rendered start at the next frame (counted in get_late()).
+     *
+     * @param gain Q14 (MIXER_UNITY_GAIN is unity)
+     * @return uint32_t Voice handle, or NO_VOICE if every voice is busy or
+     *         the clip's channel count does not match
+     */
+    uint32_t trigger(sound_clip const& clip, uint32_t at_ms, int16_t gain = MIXER_UNITY_GAIN) {
+        int32_t const delta = static_cast<int32_t>(at_ms - origin_ms_);
+        uint64_t const frame =
+            delta <= 0 ? 0 : (static_cast<uint64_t>(delta) * sample_rate_ + 999) / 1000;
+        return trigger_frame(clip, frame, gain);
+    }
+
+    /**
+     * @brief Play a clip from an absolute output frame
+     */
+    uint32_t trigger_frame(sound_clip const& clip, uint64_t frame,
+                           int16_t gain = MIXER_UNITY_GAIN) {
+        if (clip.channels != channels_ || clip.frames == 0) {
+            return NO_VOICE;
+        }
+        for (std::size_t v = 0; v < max_voices_v; ++v) {
+            voice& slot = voices_[v];
+            if (slot.active) {
+                continue;
+            }
+            if (frame < frame_) {
+                frame = frame_;
+                ++late_;
+            }
+            slot.samples = clip.samples;
+            slot.frames = clip.frames;
+            slot.position = 0;
+            slot.start_frame = frame;
+            slot.gain = static_cast<int32_t>(clamp_gain(gain)) << 16;
+            slot.step = 0;
+            slot.target = clamp_gain(gain);
+            slot.ramp_left = 0;
+            slot.stopping = false;
+            slot.active = true;
+            slot.generation = (slot.generation + 1) & 0x7FFFFF;  // Handles never reach NO_VOICE
+            return (slot.generation << 8) | static_cast<uint32_t>(v);
+        }
+        ++dropped_;
+        return NO_VOICE;
+    }
+
+    /**
+     * @brief Ramp a voice's gain linearly, starting at its next rendered frame
+     *
+     * @return false if the voice has already finished
+     */
+    bool set_gain(uint32_t handle, int16_t gain, uint32_t ramp_ms) {
+        voice* slot = find(handle);
+        if (slot == nullptr) {
+            return false;
+        }
+        ramp(*slot, clamp_gain(gain), ramp_ms);
+        return true;
+    }
+
+    /**
+     * @brief Fade a voice out over ramp_ms and free it
+     */
+    bool stop(uint32_t handle, uint32_t ramp_ms) {
+        voice* slot = find(handle);
+        if (slot == nullptr) {
+            return false;
+        }
+        ramp(*slot, 0, ramp_ms);
+        slot->stopping = true;
+        if (slot->ramp_left == 0) {
+            slot->active = false;
+        }
+        return true;
+    }
+
+    bool is_playing(uint32_t handle) const {
+        uint32_t const v = handle & 0xFF;
+        return v < max_voices_v && voices_[v].active && voices_[v].generation == (handle >> 8);
+    }
+
+    /**
+     * @brief Render interleaved int16 frames and advance the show clock
+     *
+     * @param out frames * channels samples
+     */
+    void render(int16_t* out, std::size_t frames) {
+        while (frames > 0) {
+            std::size_t const n = frames < block_frames_v ? frames : block_frames_v;
+            render_block(out, n);
+            out += n * channels_;
+            frames -= n;
+        }
+    }
+
+    /**
+     * @brief Controller time of the next frame to be rendered
+     */
+    uint32_t get_time_ms() const {
+        return origin_ms_ + static_cast<uint32_t>(frame_ * 1000 / sample_rate_);
+    }
+
+    uint64_t get_frame() const { return frame_; }
+    uint32_t get_sample_rate() const { return sample_rate_; }
+    uint16_t get_channels() const { return channels_; }
+
+    std::size_t get_active() const {
+        std::size_t active = 0;
+        for (std::size_t v = 0; v < max_voices_v; ++v) {
+            active += voices_[v].active ? 1 : 0;
+        }
+        return active;
+    }
+
+    uint64_t get_clipped() const { return clipped_; }  // Output samples saturated
+    uint32_t get_late() const { return late_; }         // Triggers for frames already rendered
+    uint32_t get_dropped() const { return dropped_; }   // Triggers with every voice busy
+
+   private:
+    struct voice {
+        int16_t const* samples;
+        uint32_t frames;
+        uint32_t position;     // Next clip frame
+        uint64_t start_frame;  // Output frame of clip frame 0
+        int32_t gain;          // Q14 in the upper 16 bits, so ramps step by fractions
+        int32_t step;
+        int16_t target;
+        uint32_t ramp_left;  // Frames until gain reaches target
+        uint32_t generation;
+        bool stopping;
+        bool active;
+    };
+
+    static int16_t clamp_gain(int16_t gain) { return gain < 0 ? 0 : gain; }
+
+    voice* find(uint32_t handle) { return is_playing(handle) ? &voices_[handle & 0xFF] : nullptr; }
+
+    void ramp(voice& slot, int16_t target, uint32_t ramp_ms) {
+        uint32_t const frames =
+            static_cast<uint32_t>(static_cast<uint64_t>(ramp_ms) * sample_rate_ / 1000);
+        slot.target = target;
+        if (frames == 0) {
+            slot.gain = static_cast<int32_t>(target) << 16;
+            slot.ramp_left = 0;
+            return;
+        }
+        slot.step =
+            ((static_cast<int32_t>(target) << 16) - slot.gain) / static_cast<int32_t>(frames);
+        slot.ramp_left = frames;
+    }
+
+    void render_block(int16_t* out, std::size_t frames) {
+        std::size_t const channels = channels_;
+        for (std::size_t i = 0; i < frames * channels; ++i) {
+            acc_[i] = 0;
+        }
+        for (std::size_t v = 0; v < max_voices_v; ++v) {
+            voice& slot = voices_[v];
+            if (!slot.active || slot.start_frame >= frame_ + frames) {
+                continue;
+            }
+            std::size_t const offset =
+                slot.start_frame > frame_ ? static_cast<std::size_t>(slot.start_frame - frame_)
+                                          : 0;
+            std::size_t count = frames - offset;
+            if (count > slot.frames - slot.position) {
+                count = slot.frames - slot.position;
+            }
+            int32_t* acc = acc_ + offset * channels;
+            int16_t const* samples =
+                slot.samples + static_cast<std::size_t>(slot.position) * channels;
+            // Ramping: gain changes every frame (locals: the accumulator may alias the voice)
+            std::size_t const ramped = count < slot.ramp_left ? count : slot.ramp_left;
+            int32_t ramp_gain = slot.gain;
+            int32_t const step = slot.step;
+            for (std::size_t i = 0; i < ramped; ++i) {
+                int32_t const g = ramp_gain >> 16;
+                for (std::size_t c = 0; c < channels; ++c) {
+                    acc[i * channels + c] += (samples[i * channels + c] * g) >> 14;
+                }
+                ramp_gain += step;
+            }
+            slot.ramp_left -= static_cast<uint32_t>(ramped);
+            slot.gain = slot.ramp_left == 0 ? static_cast<int32_t>(slot.target) << 16 : ramp_gain;
+            std::size_t const i = ramped;
+            int16_t const gain = static_cast<int16_t>(slot.gain >> 16);
+            if (i < count && gain != 0) {
+                mix_gain(acc + i * channels, samples + i * channels, (count - i) * channels,
+                         gain);
+            }
+            slot.position += static_cast<uint32_t>(count);
+            if (slot.position == slot.frames || (slot.stopping && slot.ramp_left == 0)) {
+                slot.active = false;
+            }
+        }
+        clipped_ += mix_saturate(out, acc_, frames * channels);
+        frame_ += frames;
+    }
+
+    uint32_t sample_rate_;
+    uint16_t channels_;
+    uint32_t origin_ms_;
+    uint64_t frame_;
+    uint64_t clipped_;
+    uint32_t late_;
+    uint32_t dropped_;
+    voice voices_[max_voices_v];
+    int32_t acc_[block_frames_v * MAX_CHANNELS];
+};
+
+template<std::size_t max_voices_v, std::size_t block_frames_v>
+std::size_t const sound_mixer<max_voices_v, block_frames_v>::MAX_CHANNELS;
+
+template<std::size_t max_voices_v, std::size_t block_frames_v>
+uint32_t const sound_mixer<max_voices_v, block_frames_v>::NO_VOICE;
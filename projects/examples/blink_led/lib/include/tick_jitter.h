@@ -0,0 +1,139 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief Fixed-size histogram of tick lateness (how late each tick woke up)
+ *
+ * Records lateness in microseconds into 5 us buckets up to 10 ms plus an
+ * overflow bucket, and tracks the exact maximum. No allocation, so it can
+ * run inside the tick loop it is measuring.
+ *
+ * Usage:
+ *   tick_jitter_histogram jitter;
+ *   jitter.record(lateness_us);
+ *   uint32_t p99 = jitter.percentile_us(99.0);
+ */
+struct tick_jitter_histogram {
+   public:
+    static uint32_t const BUCKET_US = 5;
+    static std::size_t const BUCKET_COUNT = 2000;  // Covers 0 .. 10 ms
+
+    tick_jitter_histogram() { reset(); }
+
+    void reset() {
+        for (std::size_t i = 0; i <= BUCKET_COUNT; ++i) {
+            buckets_[i] = 0;
+        }
+        count_ = 0;
+        total_us_ = 0;
+        max_us_ = 0;
+    }
+
+    /**
+     * @brief Record one tick's lateness
+     *
+     * @param lateness_us Microseconds between the deadline and the wakeup
+     */
+    void record(uint32_t lateness_us) {
+        std::size_t const bucket = lateness_us / BUCKET_US;
+        ++buckets_[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT];
+        ++count_;
+        total_us_ += lateness_us;
+        if (lateness_us > max_us_) {
+            max_us_ = lateness_us;
+        }
+    }
+
+    /**
+     * @brief Lateness below which a given percentage of ticks fall
+     *
+     * Resolution is one bucket (upper bound reported); the overflow bucket
+     * reports the exact maximum.
+     *
+     * @param percent 0 .. 100
+     * @return uint32_t Lateness in microseconds (0 if nothing recorded)
+     */
+    uint32_t percentile_us(double percent) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        uint64_t const rank = static_cast<uint64_t>(percent / 100.0 * (count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                uint32_t const upper = static_cast<uint32_t>((i + 1) * BUCKET_US - 1);
+                return upper < max_us_ ? upper : max_us_;
+            }
+        }
+        return max_us_;
+    }
+
+    uint64_t get_count() const { return count_; }
+    uint32_t get_max_us() const { return max_us_; }
+    uint64_t get_overflow_count() const { return buckets_[BUCKET_COUNT]; }
+    double get_mean_us() const { return count_ == 0 ? 0.0 : static_cast<double>(total_us_) / count_; }
+
+   private:
+    uint64_t buckets_[BUCKET_COUNT + 1];
+    uint64_t count_;
+    uint64_t total_us_;
+    uint32_t max_us_;
+};
+
+/**
+ * @brief Periodic tick source with absolute deadlines
+ *
+ * Sleeps until fixed deadlines (start + n * period) rather than for a fixed
+ * interval, so oversleeping on one tick does not shift every later tick.
+ * Returns how late each wakeup was, for a tick_jitter_histogram.
+ *
+ * Usage:
+ *   periodic_ticker ticker(std::chrono::milliseconds(1));
+ *   while (running) {
+ *       jitter.record(ticker.wait_next());
+ *       controller.update(timer.millis());
+ *   }
+ */
+struct periodic_ticker {
+   public:
+    typedef std::chrono::steady_clock clock;
+
+    explicit periodic_ticker(clock::duration period)
+        : period_(period), next_deadline_(clock::now() + period) {}
+
+    /**
+     * @brief Sleep until the next deadline
+     *
+     * If a deadline was missed by more than a period, the schedule skips
+     * ahead instead of firing a burst of catch-up ticks.
+     *
+     * @return uint32_t Lateness of this wakeup in microseconds
+     */
+    uint32_t wait_next() {
+        std::this_thread::sleep_until(next_deadline_);
+        clock::time_point const now = clock::now();
+        int64_t const late_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - next_deadline_).count();
+
+        next_deadline_ += period_;
+        if (now >= next_deadline_) {
+            next_deadline_ = now + period_;
+        }
+        return late_us < 0 ? 0 : static_cast<uint32_t>(late_us);
+    }
+
+    /**
+     * @brief Restart the schedule one period from now
+     */
+    void reset() { next_deadline_ = clock::now() + period_; }
+
+    clock::duration get_period() const { return period_; }
+
+   private:
+    clock::duration period_;
+    clock::time_point next_deadline_;
+};
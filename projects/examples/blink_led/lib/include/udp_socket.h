@@ -0,0 +1,245 @@
+#pragma once
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Called for every complete datagram
+ *
+ * @param context Pointer registered with receive()
+ * @param data Datagram bytes, valid only during the call
+ * @param length Datagram length
+ * @param sender Source address
+ */
+typedef void (*udp_datagram_handler)(void* context, uint8_t const* data, std::size_t length,
+                                     sockaddr_in const& sender);
+
+/**
+ * @brief Non-blocking UDP socket drained in batches with recvmmsg()
+ *
+ * Receive buffers for a whole batch are allocated once with the socket, so
+ * receiving does no allocation and one system call per batch_size_v
+ * datagrams. Datagrams longer than datagram_size_v are counted as truncated
+ * and not delivered. Used by the DMX and OSC receivers.
+ *
+ * Linux only (recvmmsg).
+ *
+ * Usage:
+ *   udp_batch_receiver<1024> socket;
+ *   socket.open(8000);
+ *   while (socket.wait(100)) {
+ *       socket.receive(&on_datagram, &context);
+ *   }
+ *
+ * @tparam datagram_size_v Largest datagram accepted
+ * @tparam batch_size_v Datagrams per recvmmsg() call
+ */
+template<std::size_t datagram_size_v, std::size_t batch_size_v = 32>
+struct udp_batch_receiver {
+   public:
+    static std::size_t const DATAGRAM_SIZE = datagram_size_v;
+    static std::size_t const BATCH_SIZE = batch_size_v;
+    static int const SOCKET_BUFFER_SIZE = 1 << 20;
+
+    udp_batch_receiver() : fd_(-1), datagrams_(0), truncated_(0) {
+        for (std::size_t i = 0; i < batch_size_v; ++i) {
+            iov_[i].iov_base = buffers_[i];
+            iov_[i].iov_len = datagram_size_v;
+        }
+    }
+
+    ~udp_batch_receiver() { close(); }
+
+    udp_batch_receiver(udp_batch_receiver const&) = delete;
+    udp_batch_receiver& operator=(udp_batch_receiver const&) = delete;
+
+    /**
+     * @brief Bind on all interfaces
+     *
+     * @param port Local port (0 = any free port, see get_port())
+     * @return false The socket could not be created or bound
+     */
+    bool open(uint16_t port) {
+        close();
+        int const fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return false;
+        }
+        int const on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        // Best effort: absorbs bursts between receive() calls
+        int const buffer_size = SOCKET_BUFFER_SIZE;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+        sockaddr_in address = sockaddr_in();
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        fd_ = fd;
+        return true;
+    }
+
+    void close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    /**
+     * @brief Join an IPv4 multicast group on the default interface
+     *
+     * @param group Group address, host byte order
+     * @return false Not open or no multicast route
+     */
+    bool join_group(uint32_t group) {
+        if (fd_ < 0) {
+            return false;
+        }
+        ip_mreq request;
+        request.imr_multiaddr.s_addr = htonl(group);
+        request.imr_interface.s_addr = htonl(INADDR_ANY);
+        return ::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof(request)) == 0;
+    }
+
+    /**
+     * @brief Wait until the socket is readable
+     *
+     * @param timeout_ms Maximum wait (-1 = forever)
+     */
+    bool wait(int timeout_ms) const {
+        pollfd pfd = {fd_, POLLIN, 0};
+        return ::poll(&pfd, 1, timeout_ms) > 0;
+    }
+
+    /**
+     * @brief Drain the socket without blocking
+     *
+     * @return std::size_t Datagrams delivered to handler
+     */
+    std::size_t receive(udp_datagram_handler handler, void* context) {
+        std::size_t delivered = 0;
+        while (fd_ >= 0) {
+            for (std::size_t i = 0; i < batch_size_v; ++i) {
+                messages_[i].msg_hdr.msg_name = &senders_[i];
+                messages_[i].msg_hdr.msg_namelen = sizeof(senders_[i]);
+                messages_[i].msg_hdr.msg_iov = &iov_[i];
+                messages_[i].msg_hdr.msg_iovlen = 1;
+                messages_[i].msg_hdr.msg_control = nullptr;
+                messages_[i].msg_hdr.msg_controllen = 0;
+                messages_[i].msg_hdr.msg_flags = 0;
+            }
+            int const count = ::recvmmsg(fd_, messages_, batch_size_v, MSG_DONTWAIT, nullptr);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                break;
+            }
+            for (int i = 0; i < count; ++i) {
+                ++datagrams_;
+                if ((messages_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+                    ++truncated_;
+                    continue;
+                }
+                handler(context, buffers_[i], messages_[i].msg_len, senders_[i]);
+                ++delivered;
+            }
+            if (static_cast<std::size_t>(count) < batch_size_v) {
+                break;
+            }
+        }
+        return delivered;
+    }
+
+    int get_fd() const { return fd_; }
+
+    uint16_t get_port() const {
+        sockaddr_in address = sockaddr_in();
+        socklen_t length = sizeof(address);
+        if (fd_ < 0 || ::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return 0;
+        }
+        return ntohs(address.sin_port);
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+
+    // Statistics
+    uint64_t get_datagrams() const { return datagrams_; }
+    uint64_t get_truncated() const { return truncated_; }
+
+   private:
+    int fd_;
+    uint8_t buffers_[batch_size_v][datagram_size_v];
+    iovec iov_[batch_size_v];
+    sockaddr_in senders_[batch_size_v];
+    mmsghdr messages_[batch_size_v];
+    uint64_t datagrams_;
+    uint64_t truncated_;
+};
+
+template<std::size_t datagram_size_v, std::size_t batch_size_v>
+std::size_t const udp_batch_receiver<datagram_size_v, batch_size_v>::DATAGRAM_SIZE;
+
+template<std::size_t datagram_size_v, std::size_t batch_size_v>
+std::size_t const udp_batch_receiver<datagram_size_v, batch_size_v>::BATCH_SIZE;
+
+template<std::size_t datagram_size_v, std::size_t batch_size_v>
+int const udp_batch_receiver<datagram_size_v, batch_size_v>::SOCKET_BUFFER_SIZE;
+
+/**
+ * @brief Send datagrams to one fixed destination (generators, tests, tools)
+ */
+struct udp_sender {
+   public:
+    udp_sender() : fd_(::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0)), destination_() {}
+    ~udp_sender() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    udp_sender(udp_sender const&) = delete;
+    udp_sender& operator=(udp_sender const&) = delete;
+
+    /**
+     * @brief Set the destination
+     *
+     * @param address IPv4 address, host byte order (INADDR_LOOPBACK for tests)
+     * @param port Destination port
+     */
+    void connect(uint32_t address, uint16_t port) {
+        destination_.sin_family = AF_INET;
+        destination_.sin_addr.s_addr = htonl(address);
+        destination_.sin_port = htons(port);
+    }
+
+    bool send(uint8_t const* data, std::size_t length) const {
+        return fd_ >= 0 && ::sendto(fd_, data, length, 0,
+                                    reinterpret_cast<sockaddr const*>(&destination_),
+                                    sizeof(destination_)) == static_cast<ssize_t>(length);
+    }
+
+    uint16_t get_local_port() const {
+        sockaddr_in address = sockaddr_in();
+        socklen_t length = sizeof(address);
+        if (fd_ < 0 || ::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return 0;
+        }
+        return ntohs(address.sin_port);
+    }
+
+   private:
+    int fd_;
+    sockaddr_in destination_;
+};
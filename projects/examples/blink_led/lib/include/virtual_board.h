@@ -0,0 +1,401 @@
+#pragma once
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "blink_controller.h"
+#include "fd_serial.h"
+#include "output_bank.h"
+#include "serial_protocol.h"
+
+/**
+ * @brief Serial line timing: 10 bits (start + 8 data + stop) per byte
+ *
+ * Bytes queue behind each other on the line; schedule() returns the time
+ * a byte submitted at now_ns has been fully received at the other end.
+ * Baud 0 means an ideal line (no delay).
+ */
+struct uart_line_model {
+   public:
+    explicit uart_line_model(uint32_t baud)
+        : byte_time_ns_(baud == 0 ? 0 : 10ull * 1000000000ull / baud), line_free_ns_(0) {}
+
+    uint64_t schedule(uint64_t now_ns) {
+        uint64_t const start = line_free_ns_ > now_ns ? line_free_ns_ : now_ns;
+        line_free_ns_ = start + byte_time_ns_;
+        return line_free_ns_;
+    }
+
+    uint64_t get_byte_time_ns() const { return byte_time_ns_; }
+    uint64_t get_line_free_ns() const { return line_free_ns_; }
+
+   private:
+    uint64_t byte_time_ns_;
+    uint64_t line_free_ns_;
+};
+
+/**
+ * @brief HardwareSerial stand-in used by firmware running on a virtual_board
+ *
+ * The RX buffer has a fixed size like the AVR core's ring (64 bytes on an
+ * Uno): bytes landing while it is full are overrun and lost, so firmware
+ * that polls too slowly fails here the way it would on hardware.
+ */
+struct virtual_uart {
+   public:
+    explicit virtual_uart(std::size_t rx_capacity = 64)
+        : rx_(rx_capacity == 0 ? 1 : rx_capacity), rx_head_(0), rx_count_(0), overruns_(0) {}
+
+    // Firmware side
+    int available() const { return static_cast<int>(rx_count_); }
+
+    int read() {
+        if (rx_count_ == 0) {
+            return -1;
+        }
+        uint8_t const byte = rx_[rx_head_];
+        rx_head_ = (rx_head_ + 1) % rx_.size();
+        --rx_count_;
+        return byte;
+    }
+
+    std::size_t write(uint8_t const* data, std::size_t length) {
+        tx_.insert(tx_.end(), data, data + length);
+        return length;
+    }
+
+    // Line side
+    bool deliver(uint8_t byte) {
+        if (rx_count_ == rx_.size()) {
+            ++overruns_;
+            return false;
+        }
+        rx_[(rx_head_ + rx_count_) % rx_.size()] = byte;
+        ++rx_count_;
+        return true;
+    }
+
+    std::size_t take_tx(uint8_t* out, std::size_t capacity) {
+        std::size_t const count = tx_.size() < capacity ? tx_.size() : capacity;
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = tx_[i];
+        }
+        tx_.erase(tx_.begin(), tx_.begin() + static_cast<std::ptrdiff_t>(count));
+        return count;
+    }
+
+    uint32_t get_overruns() const { return overruns_; }
+
+   private:
+    std::vector<uint8_t> rx_;
+    std::size_t rx_head_;
+    std::size_t rx_count_;
+    std::vector<uint8_t> tx_;
+    uint32_t overruns_;
+};
+
+/**
+ * @brief Firmware entry point: one Arduino loop() iteration
+ *
+ * @param context Pointer registered with start()
+ * @param serial The board's serial port
+ * @param now_ms Board millis()
+ */
+typedef void (*board_loop)(void* context, virtual_uart& serial, uint32_t now_ms);
+
+/**
+ * @brief A board behind a pseudo-terminal, with baud-rate-limited serial timing
+ *
+ * Runs firmware written against the platform-agnostic libraries on a thread
+ * and exposes its serial port as /dev/pts/N. Host tools open that path
+ * exactly like /dev/ttyACM0. Bytes in both directions take 10 bit times
+ * each, and the board sees them through a fixed-size RX buffer, so latency,
+ * throughput and overrun behaviour match a real UART link closely enough for
+ * CI tests and benchmarks.
+ *
+ * Linux/POSIX only.
+ *
+ * Usage:
+ *   virtual_board board;
+ *   board.open(115200);
+ *   blink_board_sketch<8> sketch(board.get_serial(), 1000, 500);
+ *   board.start(&blink_board_sketch<8>::loop, &sketch);
+ *   int fd = open_serial_device(board.get_device_path());
+ */
+struct virtual_board {
+   public:
+    static std::size_t const MAX_IN_FLIGHT = 4096;
+
+    virtual_board()
+        : baud_(0),
+          loop_(nullptr),
+          context_(nullptr),
+          loop_period_ns_(0),
+          running_(false),
+          bytes_received_(0),
+          bytes_sent_(0),
+          loops_(0),
+          overruns_(0) {}
+
+    ~virtual_board() { close(); }
+
+    virtual_board(virtual_board const&) = delete;
+    virtual_board& operator=(virtual_board const&) = delete;
+
+    /**
+     * @brief Create the pty and the board's serial port
+     *
+     * @param baud Line rate in both directions (0 = unthrottled)
+     * @param rx_buffer Board RX buffer in bytes (64 on an Uno)
+     * @return false No pty available
+     */
+    bool open(uint32_t baud, std::size_t rx_buffer = 64) {
+        close();
+        if (!pty_.open()) {
+            return false;
+        }
+        int const flags = ::fcntl(pty_.master_fd, F_GETFL);
+        if (flags < 0 || ::fcntl(pty_.master_fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+            pty_.close();
+            return false;
+        }
+        baud_ = baud;
+        serial_ = virtual_uart(rx_buffer);
+        return true;
+    }
+
+    /**
+     * @brief Device path for the host side (/dev/pts/N)
+     */
+    char const* get_device_path() const { return pty_.slave_path(); }
+
+    /**
+     * @brief The board's serial port, for constructing firmware before start()
+     */
+    virtual_uart& get_serial() { return serial_; }
+
+    /**
+     * @brief Start running loop() on the board thread
+     *
+     * @param loop Firmware loop, called every loop_period_us
+     * @param context Passed to loop
+     * @param loop_period_us Time between loop() calls (0 = on every wakeup)
+     */
+    bool start(board_loop loop, void* context, uint32_t loop_period_us = 100) {
+        if (pty_.master_fd < 0 || running_.load() || loop == nullptr) {
+            return false;
+        }
+        loop_ = loop;
+        context_ = context;
+        loop_period_ns_ = static_cast<uint64_t>(loop_period_us) * 1000;
+        running_.store(true);
+        thread_ = std::thread(&virtual_board::run, this);
+        return true;
+    }
+
+    /**
+     * @brief Stop the board thread (bytes still on the line are discarded)
+     */
+    void stop() {
+        running_.store(false);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void close() {
+        stop();
+        pty_.close();
+    }
+
+    uint64_t get_bytes_received() const { return bytes_received_.load(); }
+    uint64_t get_bytes_sent() const { return bytes_sent_.load(); }
+    uint64_t get_loop_count() const { return loops_.load(); }
+    uint32_t get_rx_overruns() const { return overruns_.load(); }
+
+   private:
+    struct timed_byte {
+        uint64_t due_ns;
+        uint8_t value;
+    };
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    void run() {
+        uart_line_model rx_line(baud_);
+        uart_line_model tx_line(baud_);
+        std::deque<timed_byte> rx_wire;
+        std::deque<timed_byte> tx_wire;
+        uint8_t buffer[256];
+        uint64_t const boot_ns = now_ns();
+        uint64_t next_loop_ns = boot_ns;
+
+        while (running_.load()) {
+            uint64_t const now = now_ns();
+
+            // Host -> line; stop reading when the line is backed up so host writes block
+            while (rx_wire.size() < MAX_IN_FLIGHT) {
+                std::size_t const room = MAX_IN_FLIGHT - rx_wire.size();
+                ssize_t const n = ::read(pty_.master_fd, buffer,
+                                         room < sizeof(buffer) ? room : sizeof(buffer));
+                if (n <= 0) {
+                    break;
+                }
+                for (ssize_t i = 0; i < n; ++i) {
+                    timed_byte const byte = {rx_line.schedule(now), buffer[i]};
+                    rx_wire.push_back(byte);
+                }
+            }
+
+            // Line -> board RX buffer
+            while (!rx_wire.empty() && rx_wire.front().due_ns <= now) {
+                serial_.deliver(rx_wire.front().value);
+                rx_wire.pop_front();
+                bytes_received_.fetch_add(1);
+            }
+
+            if (now >= next_loop_ns) {
+                loop_(context_, serial_, static_cast<uint32_t>((now - boot_ns) / 1000000));
+                loops_.fetch_add(1);
+                overruns_.store(serial_.get_overruns());
+                next_loop_ns = now + loop_period_ns_;
+            }
+
+            // Board TX -> line -> host
+            std::size_t taken;
+            while ((taken = serial_.take_tx(buffer, sizeof(buffer))) > 0) {
+                for (std::size_t i = 0; i < taken; ++i) {
+                    timed_byte const byte = {tx_line.schedule(now), buffer[i]};
+                    tx_wire.push_back(byte);
+                }
+            }
+            std::size_t due = 0;
+            while (due < tx_wire.size() && due < sizeof(buffer) && tx_wire[due].due_ns <= now) {
+                buffer[due] = tx_wire[due].value;
+                ++due;
+            }
+            if (due > 0) {
+                ssize_t const written = ::write(pty_.master_fd, buffer, due);
+                for (ssize_t i = 0; i < written; ++i) {
+                    tx_wire.pop_front();
+                }
+                if (written > 0) {
+                    bytes_sent_.fetch_add(static_cast<uint64_t>(written));
+                }
+            }
+
+            // Sleep until the next byte lands, the next loop() or host input
+            uint64_t wake_ns = next_loop_ns;
+            if (!rx_wire.empty() && rx_wire.front().due_ns < wake_ns) {
+                wake_ns = rx_wire.front().due_ns;
+            }
+            if (!tx_wire.empty() && tx_wire.front().due_ns < wake_ns) {
+                wake_ns = tx_wire.front().due_ns;
+            }
+            uint64_t const after = now_ns();
+            uint64_t wait_ns = wake_ns > after ? wake_ns - after : 0;
+            if (wait_ns > MAX_SLEEP_NS) {
+                wait_ns = MAX_SLEEP_NS;  // Keep stop() responsive
+            }
+            if (wait_ns > 0) {
+                pollfd pfd = {rx_wire.size() < MAX_IN_FLIGHT ? pty_.master_fd : -1, POLLIN, 0};
+                timespec timeout;
+                timeout.tv_sec = static_cast<time_t>(wait_ns / 1000000000ull);
+                timeout.tv_nsec = static_cast<long>(wait_ns % 1000000000ull);
+                ::ppoll(&pfd, 1, &timeout, nullptr);
+            }
+        }
+    }
+
+    static uint64_t const MAX_SLEEP_NS = 10000000;  // 10 ms
+
+    pty_pair pty_;
+    uint32_t baud_;
+    virtual_uart serial_;
+    board_loop loop_;
+    void* context_;
+    uint64_t loop_period_ns_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::atomic<uint64_t> bytes_received_;
+    std::atomic<uint64_t> bytes_sent_;
+    std::atomic<uint64_t> loops_;
+    std::atomic<uint32_t> overruns_;
+};
+
+/**
+ * @brief Firmware for a virtual board: blinking channels under serial command
+ *
+ * The sketch a command-driven prop runs: channel_count_v blink_controllers
+ * driving an output_bank, retimed by a serial_command_server on the board's
+ * serial port. Only touched from the board thread once started.
+ *
+ * @tparam channel_count_v Number of channels (<= 255, the protocol's channel field)
+ */
+template<std::size_t channel_count_v>
+struct blink_board_sketch {
+   public:
+    static_assert(channel_count_v >= 1 && channel_count_v <= 255, "channel must fit in a byte");
+
+    blink_board_sketch(virtual_uart& serial, uint32_t on_duration_ms, uint32_t off_duration_ms)
+        : pins_(make_pins(bank_)),
+          controllers_(make_controllers(pins_, on_duration_ms, off_duration_ms)),
+          server_(controllers_.data(), static_cast<uint8_t>(channel_count_v), serial) {}
+
+    blink_board_sketch(blink_board_sketch const&) = delete;
+    blink_board_sketch& operator=(blink_board_sketch const&) = delete;
+
+    /**
+     * @brief board_loop entry point
+     */
+    static void loop(void* context, virtual_uart&, uint32_t now_ms) {
+        blink_board_sketch& sketch = *static_cast<blink_board_sketch*>(context);
+        sketch.server_.poll(now_ms);
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            sketch.controllers_[i].update(now_ms);
+        }
+    }
+
+    output_bank<channel_count_v> const& get_bank() const { return bank_; }
+    uint32_t get_command_count() const { return server_.get_command_count(); }
+
+   private:
+    typedef blink_controller<bank_pin> controller_t;
+
+    static std::vector<bank_pin> make_pins(output_bank<channel_count_v>& bank) {
+        std::vector<bank_pin> pins;
+        pins.reserve(channel_count_v);
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            pins.push_back(bank.channel(i));
+        }
+        return pins;
+    }
+
+    static std::vector<controller_t> make_controllers(std::vector<bank_pin>& pins, uint32_t on_ms,
+                                                      uint32_t off_ms) {
+        std::vector<controller_t> controllers;
+        controllers.reserve(channel_count_v);
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            controllers.push_back(controller_t(pins[i], on_ms, off_ms));
+        }
+        return controllers;
+    }
+
+    output_bank<channel_count_v> bank_;
+    std::vector<bank_pin> pins_;
+    std::vector<controller_t> controllers_;
+    serial_command_server<controller_t, virtual_uart> server_;
+};
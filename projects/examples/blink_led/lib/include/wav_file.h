@@ -0,0 +1,451 @@
+#pragma once
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief PCM sample layout of a WAV file or raw stream
+ */
+struct wav_format {
+    static uint16_t const PCM = 1;
+    static uint16_t const IEEE_FLOAT = 3;
+
+    uint16_t encoding;  // PCM (16-bit) or IEEE_FLOAT (32-bit)
+    uint16_t channels;
+    uint32_t sample_rate;
+
+    uint16_t bits_per_sample() const { return encoding == IEEE_FLOAT ? 32 : 16; }
+    uint16_t bytes_per_frame() const { return channels * (bits_per_sample() / 8); }
+
+    bool is_valid() const {
+        return (encoding == PCM || encoding == IEEE_FLOAT) && channels >= 1 && channels <= 8 &&
+               sample_rate >= 1000 && sample_rate <= 192000;
+    }
+};
+
+static std::size_t const WAV_HEADER_SIZE = 44;
+
+namespace wav_detail {
+
+inline uint32_t read_u32(uint8_t const* p) {
+    return p[0] | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t read_u16(uint8_t const* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+inline void write_u32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline void write_u16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+// read() until size bytes or end of stream
+inline std::size_t read_fully(int fd, void* buffer, std::size_t size) {
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    std::size_t done = 0;
+    while (done < size) {
+        ssize_t const n = ::read(fd, out + done, size - done);
+        if (n > 0) {
+            done += static_cast<std::size_t>(n);
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    return done;
+}
+
+// write() until size bytes or an error
+inline bool write_fully(int fd, void const* buffer, std::size_t size) {
+    uint8_t const* in = static_cast<uint8_t const*>(buffer);
+    std::size_t done = 0;
+    while (done < size) {
+        ssize_t const n = ::write(fd, in + done, size - done);
+        if (n > 0) {
+            done += static_cast<std::size_t>(n);
+        } else if (n == 0 || errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int16_t float_to_pcm16(float value) {
+    float const scaled = value * 32767.0f;
+    if (scaled >= 32767.0f) {
+        return 32767;
+    }
+    if (scaled <= -32768.0f) {
+        return -32768;
+    }
+    return static_cast<int16_t>(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+}
+
+}  // namespace wav_detail
+
+/**
+ * @brief Canonical 44-byte WAV header
+ *
+ * @param data_bytes Size of the sample data that follows (0xFFFFFFFF when
+ *        streaming to a pipe and the length is not known yet)
+ */
+inline void wav_build_header(uint8_t* header, wav_format const& format, uint32_t data_bytes) {
+    std::memcpy(header, "RIFF", 4);
+    wav_detail::write_u32(header + 4,
+                          data_bytes > 0xFFFFFFFFu - 36 ? 0xFFFFFFFFu : 36 + data_bytes);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    wav_detail::write_u32(header + 16, 16);
+    wav_detail::write_u16(header + 20, format.encoding);
+    wav_detail::write_u16(header + 22, format.channels);
+    wav_detail::write_u32(header + 24, format.sample_rate);
+    wav_detail::write_u32(header + 28, format.sample_rate * format.bytes_per_frame());
+    wav_detail::write_u16(header + 32, format.bytes_per_frame());
+    wav_detail::write_u16(header + 34, format.bits_per_sample());
+    std::memcpy(header + 36, "data", 4);
+    wav_detail::write_u32(header + 40, data_bytes);
+}
+
+/**
+ * @brief Streaming PCM reader for WAV files, pipes and raw stdin
+ *
+ * Reads the RIFF chunks up to "data" with small fixed reads (no seeking,
+ * so pipes work), then hands out blocks of interleaved int16 frames. 32-bit
+ * float input is converted to int16 as it is read. Nothing is allocated:
+ * the caller owns the block buffer.
+ *
+ * Usage:
+ *   wav_reader wav;
+ *   wav.open("skull.wav");                 // or wav.open_raw(0, format) for stdin PCM
+ *   int16_t block[512 * 2];
+ *   std::size_t frames = wav.read(block, 512);
+ */
+struct wav_reader {
+   public:
+    wav_reader() : fd_(-1), owns_fd_(false), remaining_(0), frames_read_(0) {
+        format_.encoding = wav_format::PCM;
+        format_.channels = 1;
+        format_.sample_rate = 44100;
+    }
+
+    ~wav_reader() { close(); }
+
+    wav_reader(wav_reader const&) = delete;
+    wav_reader& operator=(wav_reader const&) = delete;
+
+    /**
+     * @brief Open a WAV file by path
+     */
+    bool open(char const* path) {
+        close();
+        int const fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        if (!open_fd(fd)) {
+            ::close(fd);
+            return false;
+        }
+        owns_fd_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Read a WAV header from an already open descriptor (file or pipe)
+     *
+     * The descriptor is not closed by the reader.
+     */
+    bool open_fd(int fd) {
+        close();
+        uint8_t riff[12];
+        if (wav_detail::read_fully(fd, riff, sizeof(riff)) != sizeof(riff) ||
+            std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+            return false;
+        }
+        bool have_format = false;
+        for (;;) {
+            uint8_t chunk[8];
+            if (wav_detail::read_fully(fd, chunk, sizeof(chunk)) != sizeof(chunk)) {
+                return false;
+            }
+            uint32_t const size = wav_detail::read_u32(chunk + 4);
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                if (size < 16 || !read_format(fd, size)) {
+                    return false;
+                }
+                have_format = true;
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!have_format) {
+                    return false;
+                }
+                fd_ = fd;
+                remaining_ = size;
+                frames_read_ = 0;
+                return true;
+            } else if (!skip(fd, size + (size & 1))) {  // Chunks are padded to even sizes
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Read headerless PCM (e.g. stdin) in a known format
+     */
+    bool open_raw(int fd, wav_format const& format) {
+        close();
+        if (!format.is_valid()) {
+            return false;
+        }
+        format_ = format;
+        fd_ = fd;
+        remaining_ = 0xFFFFFFFFu;
+        frames_read_ = 0;
+        return true;
+    }
+
+    void close() {
+        if (owns_fd_ && fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = -1;
+        owns_fd_ = false;
+    }
+
+    /**
+     * @brief Read up to max_frames interleaved int16 frames
+     *
+     * @param frames Buffer of max_frames * channels samples
+     * @return std::size_t Frames read; 0 at the end of the data
+     */
+    std::size_t read(int16_t* frames, std::size_t max_frames) {
+        if (fd_ < 0) {
+            return 0;
+        }
+        std::size_t const channels = format_.channels;
+        std::size_t const frame_bytes = format_.bytes_per_frame();
+        std::size_t want = max_frames * frame_bytes;
+        if (want > remaining_) {
+            want = remaining_ - remaining_ % frame_bytes;
+        }
+        if (format_.encoding == wav_format::PCM) {
+            std::size_t const got = wav_detail::read_fully(fd_, frames, want) / frame_bytes;
+            return finish_read(got, frame_bytes);
+        }
+        // Float: convert through a small stack buffer
+        std::size_t const total = want / frame_bytes;
+        std::size_t const batch_frames = FLOAT_BATCH / channels;
+        float samples[FLOAT_BATCH];
+        std::size_t got = 0;
+        while (got < total) {
+            std::size_t const wanted = total - got < batch_frames ? total - got : batch_frames;
+            std::size_t const batch =
+                wav_detail::read_fully(fd_, samples, wanted * frame_bytes) / frame_bytes;
+            for (std::size_t i = 0; i < batch * channels; ++i) {
+                frames[got * channels + i] = wav_detail::float_to_pcm16(samples[i]);
+            }
+            got += batch;
+            if (batch < wanted) {
+                break;
+            }
+        }
+        return finish_read(got, frame_bytes);
+    }
+
+    wav_format const& get_format() const { return format_; }
+    uint64_t get_frames_read() const { return frames_read_; }
+    bool is_open() const { return fd_ >= 0; }
+
+   private:
+    static std::size_t const FLOAT_BATCH = 256;
+
+    bool read_format(int fd, uint32_t size) {
+        uint8_t body[16];
+        if (wav_detail::read_fully(fd, body, sizeof(body)) != sizeof(body) ||
+            !skip(fd, size - 16 + (size & 1))) {
+            return false;
+        }
+        wav_format format;
+        format.encoding = wav_detail::read_u16(body);
+        format.channels = wav_detail::read_u16(body + 2);
+        format.sample_rate = wav_detail::read_u32(body + 4);
+        uint16_t const bits = wav_detail::read_u16(body + 14);
+        if (!format.is_valid() || bits != format.bits_per_sample()) {
+            return false;
+        }
+        format_ = format;
+        return true;
+    }
+
+    static bool skip(int fd, uint32_t size) {
+        uint8_t scratch[256];
+        while (size > 0) {
+            std::size_t const chunk = size < sizeof(scratch) ? size : sizeof(scratch);
+            if (wav_detail::read_fully(fd, scratch, chunk) != chunk) {
+                return false;
+            }
+            size -= static_cast<uint32_t>(chunk);
+        }
+        return true;
+    }
+
+    std::size_t finish_read(std::size_t frames, std::size_t frame_bytes) {
+        if (remaining_ != 0xFFFFFFFFu) {
+            remaining_ -= static_cast<uint32_t>(frames * frame_bytes);
+        }
+        frames_read_ += frames;
+        return frames;
+    }
+
+    int fd_;
+    bool owns_fd_;
+    wav_format format_;
+    uint32_t remaining_;  // Data bytes left (0xFFFFFFFF: unknown, read to end of stream)
+    uint64_t frames_read_;
+};
+
+/**
+ * @brief Streaming PCM writer for WAV files and pipes
+ *
+ * Writes the canonical header first with an unknown length, then frames as
+ * they are rendered. Files opened by path get their RIFF and data sizes
+ * patched on close(); pipes keep the unknown length (0xFFFFFFFF), which
+ * wav_reader reads to the end of the stream. int16 frames are converted to
+ * 32-bit float when the format is IEEE_FLOAT.
+ *
+ * Usage:
+ *   wav_writer out;
+ *   out.open("render.wav", format);        // or out.open_fd(1, format) for a pipe
+ *   out.write(block, 512);
+ *   out.close();
+ */
+struct wav_writer {
+   public:
+    wav_writer() : fd_(-1), owns_fd_(false), frames_written_(0) {
+        format_.encoding = wav_format::PCM;
+        format_.channels = 1;
+        format_.sample_rate = 44100;
+    }
+
+    ~wav_writer() { close(); }
+
+    wav_writer(wav_writer const&) = delete;
+    wav_writer& operator=(wav_writer const&) = delete;
+
+    /**
+     * @brief Create (or truncate) a WAV file by path
+     */
+    bool open(char const* path, wav_format const& format) {
+        close();
+        if (!format.is_valid()) {
+            return false;
+        }
+        int const fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (!open_fd(fd, format)) {
+            ::close(fd);
+            return false;
+        }
+        owns_fd_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Write a streaming header to an already open descriptor
+     *
+     * The descriptor is not closed by the writer and the header keeps the
+     * unknown length.
+     */
+    bool open_fd(int fd, wav_format const& format) {
+        close();
+        if (!format.is_valid()) {
+            return false;
+        }
+        uint8_t header[WAV_HEADER_SIZE];
+        wav_build_header(header, format, 0xFFFFFFFFu);
+        if (!wav_detail::write_fully(fd, header, sizeof(header))) {
+            return false;
+        }
+        format_ = format;
+        fd_ = fd;
+        frames_written_ = 0;
+        return true;
+    }
+
+    /**
+     * @brief Finish the file: patch the sizes (files opened by path) and close
+     */
+    bool close() {
+        bool ok = true;
+        if (owns_fd_ && fd_ >= 0) {
+            uint8_t header[WAV_HEADER_SIZE];
+            wav_build_header(header, format_, data_bytes());
+            ok = ::pwrite(fd_, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+            ok = ::close(fd_) == 0 && ok;
+        }
+        fd_ = -1;
+        owns_fd_ = false;
+        return ok;
+    }
+
+    /**
+     * @brief Append interleaved int16 frames
+     *
+     * @param frames count * channels samples
+     */
+    bool write(int16_t const* frames, std::size_t count) {
+        if (fd_ < 0) {
+            return false;
+        }
+        std::size_t const channels = format_.channels;
+        if (format_.encoding == wav_format::PCM) {
+            if (!wav_detail::write_fully(fd_, frames, count * format_.bytes_per_frame())) {
+                return false;
+            }
+            frames_written_ += count;
+            return true;
+        }
+        // Float: convert through a small stack buffer
+        std::size_t const batch_frames = FLOAT_BATCH / channels;
+        float samples[FLOAT_BATCH];
+        for (std::size_t done = 0; done < count;) {
+            std::size_t const batch = count - done < batch_frames ? count - done : batch_frames;
+            for (std::size_t i = 0; i < batch * channels; ++i) {
+                samples[i] = frames[done * channels + i] / 32767.0f;
+            }
+            if (!wav_detail::write_fully(fd_, samples, batch * format_.bytes_per_frame())) {
+                return false;
+            }
+            done += batch;
+            frames_written_ += batch;
+        }
+        return true;
+    }
+
+    wav_format const& get_format() const { return format_; }
+    uint64_t get_frames_written() const { return frames_written_; }
+    bool is_open() const { return fd_ >= 0; }
+
+   private:
+    static std::size_t const FLOAT_BATCH = 256;
+
+    uint32_t data_bytes() const {
+        uint64_t const bytes = frames_written_ * format_.bytes_per_frame();
+        return bytes >= 0xFFFFFFFFu ? 0xFFFFFFFEu : static_cast<uint32_t>(bytes);
+    }
+
+    int fd_;
+    bool owns_fd_;
+    wav_format format_;
+    uint64_t frames_written_;
+};
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "shm_frame.h"
+
+static std::chrono::milliseconds const STALL_TIMEOUT(1000);
+
+/**
+ * @brief Print frames published by blink_demo --shm <name>
+ *
+ * Example external reader: maps the region read-only and prints every new
+ * frame as a row of channel states ('#' = ON, '.' = OFF). Stand-in for a
+ * visualizer or logger process. When no frame arrives for a second it
+ * re-opens the name, so it follows a writer that restarted (and recreated
+ * the region); until then it keeps its current mapping.
+ *
+ * Usage: frame_reader <name> [max_frames]
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <name> [max_frames]\n", argv[0]);
+        return 1;
+    }
+    char const* const name = argv[1];
+    unsigned long const max_frames = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+
+    shm_frame_reader reader;
+    if (!reader.open(name)) {
+        std::fprintf(stderr, "frame_reader: cannot open shared memory region '%s'\n", name);
+        return 1;
+    }
+
+    std::vector<uint32_t> words(reader.get_word_count());
+    std::vector<char> row(reader.get_channel_count() + 1, '\0');
+    uint32_t last_sequence = 0;
+    unsigned long printed = 0;
+    std::chrono::steady_clock::time_point last_progress = std::chrono::steady_clock::now();
+
+    while (max_frames == 0 || printed < max_frames) {
+        // Poll the sequence; only copy when a new frame was published
+        uint32_t const sequence = reader.get_sequence();
+        if (sequence == last_sequence || (sequence & 1u) != 0) {
+            std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+            if (now - last_progress >= STALL_TIMEOUT) {
+                // Writer stopped or restarted: map whatever region the name now refers to
+                last_progress = now;
+                if (reader.open(name)) {
+                    words.resize(reader.get_word_count());
+                    row.assign(reader.get_channel_count() + 1, '\0');
+                    last_sequence = reader.get_sequence();
+                }
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        shm_frame_info info;
+        reader.read(words.data(), info);
+        last_sequence = sequence;
+        last_progress = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < reader.get_channel_count(); ++i) {
+            row[i] = (words[i / 32] >> (i % 32)) & 1u ? '#' : '.';
+        }
+        std::printf("frame %llu [%ums] %s\n", static_cast<unsigned long long>(info.frame),
+                    info.time_ms, row.data());
+        std::fflush(stdout);
+        ++printed;
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "blink_controller.h"
+#include "frame_stream.h"
+#include "output_bank.h"
+
+/**
+ * @brief Bytes per frame for delta streaming vs full frames, and what fits a link
+ *
+ * Drives a bank with a synthetic show, streams every frame through
+ * frame_stream_encoder/decoder (acks arrive one frame late, as on a real
+ * link) and reports the average wire bytes per frame. From those, the
+ * largest simulated channel count whose average fits in 90% of each baud
+ * rate (10 bits per byte) at the chosen frame rate.
+ *
+ * Patterns:
+ *   blink   every channel blinks with its own 250-2000 ms period
+ *   chase   16-channel blocks marching one channel per frame
+ *   sparse  one channel in ten blinks, the rest hold
+ *
+ * Usage: frame_stream_sim [fps] [seconds]
+ */
+enum pattern_kind { blink_pattern, chase_pattern, sparse_pattern, PATTERN_COUNT };
+
+static char const* const PATTERN_NAMES[PATTERN_COUNT] = {"blink", "chase", "sparse"};
+
+struct stream_result {
+    std::size_t channels;
+    double full_bytes;
+    double delta_bytes[PATTERN_COUNT];
+};
+
+static uint32_t next_random(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Wire size of a full frame: the bank sent raw as a keyframe every time
+static double full_frame_bytes(std::size_t channels) {
+    std::size_t const body = serial_frame::HEADER_SIZE + 1 + (channels + 7) / 8;
+    std::size_t const encoded = body + serial_frame::CRC_SIZE;
+    return static_cast<double>(encoded + encoded / 254 + 2);
+}
+
+template<std::size_t channel_count_v>
+static double simulate(pattern_kind pattern, uint32_t fps, uint32_t seconds) {
+    output_bank<channel_count_v> host_bank;
+    output_bank<channel_count_v> board_bank;
+    frame_stream_encoder<channel_count_v> encoder(50);
+    frame_stream_decoder<channel_count_v> decoder;
+
+    std::vector<bank_pin> pins;
+    pins.reserve(channel_count_v);
+    std::vector<blink_controller<bank_pin> > controllers;
+    controllers.reserve(channel_count_v);
+    uint32_t state = 0x9E3779B9u;
+    for (std::size_t i = 0; i < channel_count_v; ++i) {
+        pins.push_back(host_bank.channel(i));
+        uint32_t const on = 250 + next_random(state) % 1750;
+        uint32_t const off = 250 + next_random(state) % 1750;
+        controllers.push_back(blink_controller<bank_pin>(pins.back(), on, off));
+    }
+    for (std::size_t i = 0; i < channel_count_v; i += 2) {
+        host_bank.set(i, true);  // Held channels in the sparse pattern: half ON
+    }
+
+    uint32_t const frames = fps * seconds;
+    uint8_t wire[frame_stream_encoder<channel_count_v>::MAX_WIRE_SIZE];
+    uint8_t ack_body[1];
+    serial_frame pending_ack = {serial_message::ack, 0, 0, nullptr, 0};
+    bool has_pending_ack = false;
+    uint64_t total_bytes = 0;
+    serial_parser<frame_stream_encoder<channel_count_v>::MAX_BODY_SIZE + serial_frame::CRC_SIZE>
+        parser;
+
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        uint32_t const now = frame * 1000 / fps;
+        for (std::size_t i = 0; i < channel_count_v; ++i) {
+            if (pattern == blink_pattern || (pattern == sparse_pattern && i % 10 == 0)) {
+                controllers[i].update(now);
+            } else if (pattern == chase_pattern) {
+                host_bank.set(i, ((i + frame) / 16) % 4 == 0);
+            }
+        }
+
+        std::size_t const length = encoder.encode(host_bank, wire, sizeof(wire));
+        total_bytes += length;
+
+        // Board side, parsed straight from the wire bytes
+        serial_frame received;
+        serial_status status = serial_status::bad_length;
+        uint8_t seq = 0;
+        for (std::size_t i = 0; i < length; ++i) {
+            if (parser.push(wire[i], received)) {
+                status = decoder.apply(received, board_bank);
+                seq = received.seq;
+            }
+        }
+        if (status != serial_status::ok) {
+            std::fprintf(stderr, "frame_stream_sim: frame %u rejected\n", frame);
+            std::exit(1);
+        }
+
+        // The previous frame's ack arrives now; this frame's after the next one
+        if (has_pending_ack) {
+            encoder.on_reply(pending_ack);
+        }
+        ack_body[0] = static_cast<uint8_t>(serial_status::ok);
+        pending_ack.seq = seq;
+        pending_ack.payload = ack_body;
+        pending_ack.payload_size = 1;
+        has_pending_ack = true;
+    }
+    return static_cast<double>(total_bytes) / frames;
+}
+
+template<std::size_t channel_count_v>
+static stream_result run_all(uint32_t fps, uint32_t seconds) {
+    stream_result result;
+    result.channels = channel_count_v;
+    result.full_bytes = full_frame_bytes(channel_count_v);
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        result.delta_bytes[p] = simulate<channel_count_v>(static_cast<pattern_kind>(p), fps,
+                                                          seconds);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint32_t const fps = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 40;
+    uint32_t const seconds =
+        argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 10;
+    if (fps == 0 || seconds == 0) {
+        std::fprintf(stderr, "Usage: %s [fps] [seconds]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<stream_result> results;
+    results.push_back(run_all<64>(fps, seconds));
+    results.push_back(run_all<128>(fps, seconds));
+    results.push_back(run_all<192>(fps, seconds));
+    results.push_back(run_all<256>(fps, seconds));
+    results.push_back(run_all<384>(fps, seconds));
+    results.push_back(run_all<512>(fps, seconds));
+    results.push_back(run_all<768>(fps, seconds));
+    results.push_back(run_all<1024>(fps, seconds));
+    results.push_back(run_all<1536>(fps, seconds));
+    results.push_back(run_all<2048>(fps, seconds));
+    results.push_back(run_all<3072>(fps, seconds));
+    results.push_back(run_all<4096>(fps, seconds));
+    results.push_back(run_all<6144>(fps, seconds));
+    results.push_back(run_all<8192>(fps, seconds));
+
+    std::printf("=== wire bytes per frame at %u fps (keyframe every 50, acks one frame late) ===\n",
+                fps);
+    std::printf("%-9s %10s", "channels", "full");
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        std::printf(" %10s", PATTERN_NAMES[p]);
+    }
+    std::printf("\n");
+    for (std::size_t r = 0; r < results.size(); ++r) {
+        std::printf("%-9zu %10.1f", results[r].channels, results[r].full_bytes);
+        for (int p = 0; p < PATTERN_COUNT; ++p) {
+            std::printf(" %10.1f", results[r].delta_bytes[p]);
+        }
+        std::printf("\n");
+    }
+
+    uint32_t const bauds[] = {115200, 250000, 500000, 1000000};
+    std::printf("\n=== max channels within 90%% of the line at %u fps ===\n", fps);
+    std::printf("%-9s %10s", "baud", "full");
+    for (int p = 0; p < PATTERN_COUNT; ++p) {
+        std::printf(" %10s", PATTERN_NAMES[p]);
+    }
+    std::printf("\n");
+    for (std::size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); ++b) {
+        double const budget = 0.9 * bauds[b] / 10.0 / fps;
+        std::size_t full_max = 0;
+        std::size_t delta_max[PATTERN_COUNT] = {};
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            if (results[r].full_bytes <= budget) {
+                full_max = results[r].channels;
+            }
+            for (int p = 0; p < PATTERN_COUNT; ++p) {
+                if (results[r].delta_bytes[p] <= budget) {
+                    delta_max[p] = results[r].channels;
+                }
+            }
+        }
+        std::printf("%-9u %10zu", bauds[b], full_max);
+        for (int p = 0; p < PATTERN_COUNT; ++p) {
+            std::printf(" %10zu", delta_max[p]);
+        }
+        std::printf("\n");
+    }
+    std::printf("(channel counts tested up to %zu)\n", results.back().channels);
+    return 0;
+}
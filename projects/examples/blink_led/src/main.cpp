@@ -1,10 +1,60 @@
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <thread>
 
+#include "async_sink.h"
+#include "binary_log.h"
 #include "blink_controller.h"
 #include "console_simulator.h"
+#include "output_bank.h"
+#include "realtime_profile.h"
+#include "shm_frame.h"
+#include "show_clock.h"
+#include "tick_jitter.h"
+
+/**
+ * @brief Command-line options for the demo
+ */
+struct demo_options {
+    char const* shm_name = nullptr;  // --shm <name>: publish frames for frame_reader
+    bool realtime = false;           // --realtime: mlockall, prefault, SCHED_FIFO
+    int cpu = -1;                    // --cpu <n>: pin the tick loop (with --realtime)
+    char const* trace_path = nullptr;  // --trace <file>: CSV of time_ms,state per tick
+    bool async_io = false;           // --async-io: console and trace via io_uring/thread sinks
+    uint32_t rate = SHOW_RATE_ONE;   // --rate <x>: show speed (0.25 to 1000), Q16.16
+};
+
+/**
+ * @brief Parse a --rate value (0.25 to 1000) into Q16.16
+ *
+ * @return false if the text is not a number or is out of range
+ */
+static bool parse_rate(char const* text, uint32_t& rate) {
+    char* end = nullptr;
+    double const value = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !(value >= 0.25 && value <= 1000.0)) {
+        return false;
+    }
+    rate = static_cast<uint32_t>(value * SHOW_RATE_ONE + 0.5);
+    return true;
+}
+
+/**
+ * @brief log_output that hands formatted lines to an async_sink
+ *
+ * Runs on the logger's decoder thread, the sink's only producer.
+ */
+static void write_log_to_sink(void* context, char const* text, std::size_t length) {
+    async_sink* const sink = static_cast<async_sink*>(context);
+    sink->write(text, length);
+    sink->flush();
+}
 
 /**
  * @brief Run blink controller demo with console output
@@ -15,51 +65,175 @@
  * This function is kept as a thin wrapper - all testable logic is in
  * console_simulator.h and blink_controller.h libraries.
  */
-void run_demo() {
+void run_demo(demo_options const& options) {
     // Configuration
     constexpr uint32_t ON_DURATION_MS = 1000;
     constexpr uint32_t OFF_DURATION_MS = 500;
     constexpr uint32_t SIMULATION_DURATION_MS = 10000;
     constexpr uint32_t UPDATE_INTERVAL_MS = 50;
 
-    // Create components (all from libraries)
-    console_led_pin console_pin;
+    // Create components (all from libraries); the controller drives a plain bank bit, and
+    // the binary logger below is the only console path
+    output_bank<1> bank;
     real_time_timer timer;
-    blink_controller<console_led_pin> controller(console_pin, ON_DURATION_MS, OFF_DURATION_MS);
+    bank_pin led_pin = bank.channel(0);
+    blink_controller<bank_pin> controller(led_pin, ON_DURATION_MS, OFF_DURATION_MS);
+
+    // Optional frame publication for external visualizers
+    shm_frame_writer frame_writer;
+    if (options.shm_name != nullptr) {
+        if (frame_writer.create(options.shm_name, output_bank<1>::CHANNEL_COUNT)) {
+            std::cout << "Publishing frames to shared memory: " << options.shm_name << std::endl;
+        } else {
+            std::cerr << "Warning: cannot create shared memory '" << options.shm_name
+                      << "', continuing without frame publication" << std::endl;
+        }
+    }
+
+    // Optional per-tick trace; blocking writes unless --async-io
+    sink_backend const backend = options.async_io ? sink_backend::automatic : sink_backend::blocking;
+    async_sink trace_sink;
+    int trace_fd = -1;
+    if (options.trace_path != nullptr) {
+        trace_fd = ::open(options.trace_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (trace_fd >= 0 && trace_sink.open(trace_fd, backend)) {
+            trace_sink.write("time_ms,state\n");
+        } else {
+            std::cerr << "Warning: cannot open trace '" << options.trace_path
+                      << "', continuing without trace" << std::endl;
+            // trace_fd >= 0 below means the sink is open
+            if (trace_fd >= 0) {
+                ::close(trace_fd);
+                trace_fd = -1;
+            }
+        }
+    }
+
+    // Console lines formatted by the logger go through a sink too with --async-io
+    async_sink console_sink;
+    if (options.async_io && console_sink.open(STDOUT_FILENO, backend)) {
+        std::cout << "Console and trace output: " << sink_backend_name(console_sink.get_backend())
+                  << " sink" << std::endl;
+    }
 
     // Print header
     std::cout << "\n=== blink_controller Demo ===" << std::endl;
-    std::cout << "Demonstrating dependency injection with console_led_pin\n" << std::endl;
+    std::cout << "Demonstrating dependency injection with an output_bank channel\n" << std::endl;
     std::cout << "Configuration:" << std::endl;
     std::cout << "  ON duration:  " << ON_DURATION_MS << "ms" << std::endl;
     std::cout << "  OFF duration: " << OFF_DURATION_MS << "ms" << std::endl;
     std::cout << "  Total cycle:  " << (ON_DURATION_MS + OFF_DURATION_MS) << "ms" << std::endl;
+    std::cout << "  Show rate:    " << options.rate / static_cast<double>(SHOW_RATE_ONE) << "x"
+              << std::endl;
     std::cout << "\nRunning for 10 seconds...\n" << std::endl;
 
+    // Optional real-time profile for the tick loop
+    realtime_status rt_status;
+    if (options.realtime) {
+        realtime_config rt_config;
+        rt_config.cpu = options.cpu;
+        rt_status = apply_realtime_profile(rt_config);
+        std::cout << "Real-time profile: mlockall=" << (rt_status.memory_locked ? "yes" : "no")
+                  << " SCHED_FIFO=" << (rt_status.fifo_scheduling ? "yes" : "no")
+                  << " affinity=" << (rt_status.cpu_pinned ? "yes" : "no");
+        if (!rt_status.complete(rt_config)) {
+            std::cout << " (partial, continuing best-effort)";
+        }
+        std::cout << "\n" << std::endl;
+    }
+
     // Synchronize timers
     timer.reset();
-    console_pin.reset_time();
+    show_clock<real_time_timer> clock(timer);
+    clock.set_rate(options.rate);
+    std::chrono::milliseconds const tick_period(UPDATE_INTERVAL_MS);
+    periodic_ticker ticker(tick_period);
+    tick_jitter_histogram jitter;
+
+    // Per-tick console lines are binary records, formatted on the logger's thread
+    int stdout_fd = STDOUT_FILENO;
+    log_output console_output = {&write_log_to_fd, &stdout_fd};
+    if (console_sink.get_backend() != sink_backend::blocking) {
+        console_output.write = &write_log_to_sink;
+        console_output.context = &console_sink;
+    }
+    binary_logger logger(console_output);
+    log_ring& console_log = *logger.attach();
+    std::cout.flush();
+    logger.start();
 
     // Main demo loop
     while (timer.millis() < SIMULATION_DURATION_MS) {
-        controller.update(timer.millis());
-        std::cout << console_pin.get_last_output() << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(UPDATE_INTERVAL_MS));
+        // Show time; fast_forward() takes every edge since the last tick at any rate
+        uint32_t const now = clock.millis();
+        controller.fast_forward(now);
+        if (frame_writer.is_open()) {
+            frame_writer.publish(bank.words(), now);
+        }
+        console_log.log("[%ums] LED: %s", now, console_led_pin::state_label(controller.is_on()));
+        if (trace_fd >= 0) {
+            char line[32];
+            int const length =
+                std::snprintf(line, sizeof(line), "%u,%d\n", now, controller.is_on() ? 1 : 0);
+            trace_sink.write(line, static_cast<std::size_t>(length));
+            trace_sink.flush();
+        }
+        jitter.record(ticker.wait_next());
+    }
+    release_realtime_profile(rt_status);
+    logger.stop();
+    console_sink.close();
+    trace_sink.close();
+    if (trace_fd >= 0) {
+        ::close(trace_fd);
+    }
+
+    // Remove the region name; running readers keep their mappings
+    if (frame_writer.is_open()) {
+        shm_frame_writer::unlink(options.shm_name);
     }
 
     // Print footer
     std::cout << "\n=== Demo Complete ===" << std::endl;
+    std::cout << "Tick jitter: p50=" << jitter.percentile_us(50.0)
+              << "us p99=" << jitter.percentile_us(99.0) << "us max=" << jitter.get_max_us()
+              << "us over " << jitter.get_count() << " ticks\n"
+              << std::endl;
     std::cout << "Notice how the controller manages timing and state transitions" << std::endl;
-    std::cout << "while console_led_pin handles the output presentation." << std::endl;
+    std::cout << "while the binary logger handles the output presentation." << std::endl;
     std::cout << "\nThis demonstrates the power of dependency injection:" << std::endl;
     std::cout << "  - Same blink_controller logic works with different output types" << std::endl;
-    std::cout << "  - mock_pin for testing, console_led_pin for demo, hardware pins for production"
+    std::cout << "  - mock_pin for testing, bank_pin for demo, hardware pins for production"
               << std::endl;
     std::cout << "  - Zero runtime overhead (template-based static polymorphism)" << std::endl;
     std::cout << "  - 100% testable business logic\n" << std::endl;
 }
 
-int main() {
-    run_demo();
+int main(int argc, char** argv) {
+    demo_options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            options.shm_name = argv[++i];
+        } else if (std::strcmp(argv[i], "--realtime") == 0) {
+            options.realtime = true;
+        } else if (std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            options.cpu = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.trace_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--async-io") == 0) {
+            options.async_io = true;
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc &&
+                   parse_rate(argv[i + 1], options.rate)) {
+            ++i;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--shm <name>] [--realtime [--cpu <n>]] [--trace <file>] [--async-io]"
+                      << " [--rate <x>]" << std::endl;
+            std::cerr << "  --rate: show speed from 0.25 to 1000 (1 = real time)" << std::endl;
+            return 1;
+        }
+    }
+
+    run_demo(options);
     return 0;
 }
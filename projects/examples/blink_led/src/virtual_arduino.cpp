@@ -0,0 +1,61 @@
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "virtual_board.h"
+
+/**
+ * @brief Run an 8-channel command-driven board behind a pty
+ *
+ * Prints the device path; point host tools at it instead of /dev/ttyACM0.
+ * The board speaks the serial command protocol (serial_protocol.h) at the
+ * given baud rate until interrupted.
+ *
+ * Usage: virtual_arduino [--baud N] [--rx-buffer BYTES]
+ */
+static volatile std::sig_atomic_t g_running = 1;
+
+static void handle_signal(int) { g_running = 0; }
+
+int main(int argc, char** argv) {
+    uint32_t baud = 115200;
+    std::size_t rx_buffer = 64;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baud = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--rx-buffer") == 0 && i + 1 < argc) {
+            rx_buffer = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--baud N] [--rx-buffer BYTES]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    virtual_board board;
+    if (!board.open(baud, rx_buffer)) {
+        std::fprintf(stderr, "virtual_arduino: cannot create a pty\n");
+        return 1;
+    }
+    blink_board_sketch<8> sketch(board.get_serial(), 1000, 500);
+    board.start(&blink_board_sketch<8>::loop, &sketch);
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+    std::printf("virtual board on %s (%u baud, %zu-byte RX buffer, 8 channels)\n",
+                board.get_device_path(), baud, rx_buffer);
+    std::fflush(stdout);
+
+    while (g_running) {
+        ::usleep(100000);
+    }
+    board.stop();
+    std::printf("commands: %u, bytes in: %llu, bytes out: %llu, RX overruns: %u\n",
+                sketch.get_command_count(),
+                static_cast<unsigned long long>(board.get_bytes_received()),
+                static_cast<unsigned long long>(board.get_bytes_sent()), board.get_rx_overruns());
+    return 0;
+}
@@ -86,3 +86,29 @@ struct mock_pin {
     bool state_ = false;
     uint32_t toggle_count_ = 0;
 };
+
+/**
+ * @brief Mock dimmable output for testing level-based controllers
+ *
+ * Records the last level written and how many writes happened.
+ */
+struct mock_level_pin {
+   public:
+    /**
+     * @brief Set output level
+     *
+     * @param level 0 (off) to 255 (full)
+     */
+    void set_level(uint8_t level) {
+        level_ = level;
+        write_count_++;
+    }
+
+    uint8_t get_level() const { return level_; }
+
+    uint32_t get_write_count() const { return write_count_; }
+
+   private:
+    uint8_t level_ = 0;
+    uint32_t write_count_ = 0;
+};
@@ -0,0 +1,192 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "async_sink.h"
+
+// Read a whole descriptor from the start
+static std::string read_file(int fd) {
+    std::string contents;
+    char buffer[4096];
+    ::lseek(fd, 0, SEEK_SET);
+    for (;;) {
+        ssize_t const n = ::read(fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        contents.append(buffer, static_cast<std::size_t>(n));
+    }
+    return contents;
+}
+
+// Numbered lines so reordering or loss is visible
+static std::string make_line(uint32_t index) {
+    char line[32];
+    int const length = std::snprintf(line, sizeof(line), "tick %06u\n", index);
+    return std::string(line, static_cast<std::size_t>(length));
+}
+
+struct async_sink_test : public ::testing::TestWithParam<sink_backend> {
+   protected:
+    void SetUp() override {
+        char path[] = "/tmp/async_sink_testXXXXXX";
+        fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ::unlink(path);
+    }
+    void TearDown() override { ::close(fd); }
+
+    int fd;
+};
+
+// Test every backend writes all bytes in order to a regular file
+TEST_P(async_sink_test, writes_file_in_order) {
+    async_sink sink;
+    ASSERT_TRUE(sink.open(fd, GetParam(), 256, 4));
+    EXPECT_TRUE(sink.is_seekable());
+
+    std::string expected;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        std::string const line = make_line(i);
+        expected += line;
+        ASSERT_TRUE(sink.write(line.data(), line.size()));
+        if (i % 10 == 9) {
+            sink.flush();
+        }
+        if (sink.get_free_buffers() == 0) {
+            sink.drain();  // Keep the test lossless on a slow filesystem
+        }
+    }
+    sink.drain();
+
+    EXPECT_EQ(sink.get_bytes_written(), expected.size());
+    EXPECT_EQ(sink.get_bytes_dropped(), 0u);
+    EXPECT_EQ(sink.get_write_errors(), 0u);
+    EXPECT_EQ(read_file(fd), expected);
+}
+
+// Test writes start at the descriptor's current position
+TEST_P(async_sink_test, appends_after_existing_content) {
+    ASSERT_EQ(::write(fd, "header\n", 7), 7);
+    async_sink sink;
+    ASSERT_TRUE(sink.open(fd, GetParam()));
+    sink.write("body\n");
+    sink.drain();
+    EXPECT_EQ(read_file(fd), "header\nbody\n");
+}
+
+// Test a pipe (stream fd) keeps order with one write in flight
+TEST_P(async_sink_test, writes_pipe_in_order) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    async_sink sink;
+    ASSERT_TRUE(sink.open(fds[1], GetParam(), 64, 4));
+    EXPECT_FALSE(sink.is_seekable());
+
+    std::string expected;
+    for (uint32_t i = 0; i < 100; ++i) {
+        std::string const line = make_line(i);
+        expected += line;
+        sink.write(line.data(), line.size());
+        sink.flush();
+        sink.drain();
+    }
+    sink.close();
+    ::close(fds[1]);
+
+    std::string received;
+    char buffer[256];
+    ssize_t n;
+    while ((n = ::read(fds[0], buffer, sizeof(buffer))) > 0) {
+        received.append(buffer, static_cast<std::size_t>(n));
+    }
+    ::close(fds[0]);
+    EXPECT_EQ(received, expected);
+}
+
+// Test close() flushes pending bytes
+TEST_P(async_sink_test, close_flushes) {
+    {
+        async_sink sink;
+        ASSERT_TRUE(sink.open(fd, GetParam()));
+        sink.write("unflushed\n");
+    }
+    EXPECT_EQ(read_file(fd), "unflushed\n");
+}
+
+INSTANTIATE_TEST_SUITE_P(backends, async_sink_test,
+                         ::testing::Values(sink_backend::blocking, sink_backend::thread,
+                                           sink_backend::automatic));
+
+// Test bytes are dropped, not blocked on, when every buffer is busy
+TEST(async_sink, drops_when_pool_exhausted) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_EQ(::fcntl(fds[1], F_SETPIPE_SZ, 4096), 4096);
+    async_sink sink;
+    ASSERT_TRUE(sink.open(fds[1], sink_backend::thread, 4096, 2));
+
+    // Nobody reads the pipe: the writer thread blocks after one buffer
+    std::string const chunk(4096, 'x');
+    uint32_t dropped_writes = 0;
+    for (int i = 0; i < 8; ++i) {
+        if (!sink.write(chunk.data(), chunk.size())) {
+            ++dropped_writes;
+        }
+    }
+    EXPECT_GT(dropped_writes, 0u);
+    EXPECT_GT(sink.get_bytes_dropped(), 0u);
+
+    // Unblock the writer so close() can drain
+    char buffer[4096];
+    ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    while (sink.get_free_buffers() < 2) {
+        while (::read(fds[0], buffer, sizeof(buffer)) > 0) {
+        }
+        sink.poll();
+    }
+    sink.close();
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// Test the automatic backend reports what it picked
+TEST(async_sink, automatic_picks_available_backend) {
+    async_sink sink;
+    ASSERT_TRUE(sink.open(STDERR_FILENO, sink_backend::automatic));
+    sink_backend const backend = sink.get_backend();
+    EXPECT_TRUE(backend == sink_backend::io_uring || backend == sink_backend::thread);
+    EXPECT_STREQ(sink_backend_name(sink_backend::io_uring), "io_uring");
+}
+
+// Test the io_uring backend directly, skipping where the kernel denies it
+TEST(async_sink, io_uring_registered_buffers) {
+    char path[] = "/tmp/async_sink_uringXXXXXX";
+    int const fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::unlink(path);
+
+    async_sink sink;
+    if (!sink.open(fd, sink_backend::io_uring, 128, 4)) {
+        ::close(fd);
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    std::string expected;
+    for (uint32_t i = 0; i < 64; ++i) {
+        std::string const line = make_line(i);
+        expected += line;
+        sink.write(line.data(), line.size());
+        if (sink.get_free_buffers() == 0) {
+            sink.drain();
+        }
+    }
+    sink.drain();
+    EXPECT_GT(sink.get_submissions(), 1u);
+    EXPECT_EQ(read_file(fd), expected);
+    ::close(fd);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "atomic_blink_timing.h"
+#include "blink_controller.h"
+#include "mock_hardware.h"
+
+struct atomic_blink_timing_test : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        timer.reset();
+        pin.reset();
+    }
+
+    mock_timer timer;
+    mock_pin pin;
+};
+
+// Test initial durations and lock-freedom
+TEST_F(atomic_blink_timing_test, constructor_initializes_correctly) {
+    atomic_blink_timing timing(1000, 500);
+
+    EXPECT_EQ(timing.get_on_duration(), 1000);
+    EXPECT_EQ(timing.get_off_duration(), 500);
+    EXPECT_EQ(timing.get_pending_phase(), 0);
+    EXPECT_TRUE(timing.is_lock_free());
+}
+
+// Test pack/unpack round trip at the extremes
+TEST_F(atomic_blink_timing_test, pack_round_trip) {
+    uint64_t const packed = atomic_blink_timing::pack(UINT32_MAX, 0);
+    EXPECT_EQ(atomic_blink_timing::unpack_on(packed), UINT32_MAX);
+    EXPECT_EQ(atomic_blink_timing::unpack_off(packed), 0);
+
+    uint64_t const swapped = atomic_blink_timing::pack(0, UINT32_MAX);
+    EXPECT_EQ(atomic_blink_timing::unpack_on(swapped), 0);
+    EXPECT_EQ(atomic_blink_timing::unpack_off(swapped), UINT32_MAX);
+}
+
+// Test that stored durations reach the controller at the next edge
+TEST_F(atomic_blink_timing_test, apply_to_sets_pending_durations) {
+    atomic_blink_timing timing(1000, 500);
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    timing.store(200, 100);
+    timing.apply_to(controller);
+    EXPECT_EQ(controller.get_next_on_duration(), 200);
+    EXPECT_EQ(controller.get_next_off_duration(), 100);
+
+    timer.advance(500);
+    controller.update(timer.millis());
+    EXPECT_TRUE(pin.get_state());
+    EXPECT_EQ(controller.get_on_duration(), 200);
+}
+
+// Test that phase shifts accumulate and are consumed exactly once
+TEST_F(atomic_blink_timing_test, phase_shift_consumed_once) {
+    atomic_blink_timing timing(1000, 500);
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    timing.shift_phase(-50);
+    timing.shift_phase(-50);
+    timing.apply_to(controller);
+    EXPECT_EQ(controller.get_phase_adjust(), -100);
+    EXPECT_EQ(timing.get_pending_phase(), 0);
+
+    timing.apply_to(controller);
+    EXPECT_EQ(controller.get_phase_adjust(), -100);
+}
+
+// Test that a reader never sees a torn duration pair
+TEST_F(atomic_blink_timing_test, concurrent_store_never_tears) {
+    atomic_blink_timing timing(1, 1);
+    std::atomic<bool> done(false);
+
+    // Writer always publishes on == off
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= 100000; ++i) {
+            timing.store(i, i);
+        }
+        done.store(true);
+    });
+
+    // Each apply_to() is one 64-bit load, so both halves come from one store
+    blink_controller<mock_pin> controller(pin, 0, 0);
+    uint32_t torn = 0;
+    while (!done.load()) {
+        timing.apply_to(controller);
+        if (controller.get_next_on_duration() != controller.get_next_off_duration()) {
+            ++torn;
+        }
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(timing.get_on_duration(), 100000);
+}
+
+// Test that concurrent phase requests are all delivered
+TEST_F(atomic_blink_timing_test, concurrent_phase_shifts_are_not_lost) {
+    atomic_blink_timing timing(1000, 500);
+    blink_controller<mock_pin> controller(pin, UINT32_MAX, UINT32_MAX);
+
+    std::thread writer([&]() {
+        for (int i = 0; i < 10000; ++i) {
+            timing.shift_phase(1);
+        }
+    });
+
+    // Tick thread consumes while the writer produces
+    for (int i = 0; i < 10000; ++i) {
+        timing.apply_to(controller);
+    }
+    writer.join();
+    timing.apply_to(controller);
+
+    EXPECT_EQ(controller.get_phase_adjust(), 10000);
+}
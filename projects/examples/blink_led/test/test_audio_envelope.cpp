@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "audio_envelope.h"
+#include "fade_controller.h"
+#include "mock_hardware.h"
+#include "wav_file.h"
+
+static wav_format make_format(uint16_t encoding, uint16_t channels, uint32_t sample_rate) {
+    wav_format format;
+    format.encoding = encoding;
+    format.channels = channels;
+    format.sample_rate = sample_rate;
+    return format;
+}
+
+// Temporary WAV file, removed with the fixture
+class wav_file_test : public ::testing::Test {
+   protected:
+    void TearDown() override {
+        if (!path_.empty()) {
+            ::unlink(path_.c_str());
+        }
+    }
+
+    // Header (plus an optional LIST chunk before "data") followed by raw bytes
+    char const* write_wav(wav_format const& format, void const* data, uint32_t bytes,
+                          bool extra_chunk = false) {
+        char path[] = "/tmp/audio_envelope_testXXXXXX";
+        int const fd = ::mkstemp(path);
+        EXPECT_GE(fd, 0);
+        path_ = path;
+        uint8_t header[WAV_HEADER_SIZE];
+        wav_build_header(header, format, bytes);
+        EXPECT_EQ(::write(fd, header, 36), 36);
+        if (extra_chunk) {
+            uint8_t const list[13] = {'L', 'I', 'S', 'T', 5, 0, 0, 0, 'x', 'y', 'z', 'w', 'v'};
+            uint8_t const pad = 0;
+            EXPECT_EQ(::write(fd, list, sizeof(list)), 13);
+            EXPECT_EQ(::write(fd, &pad, 1), 1);  // Odd chunk sizes are padded
+        }
+        EXPECT_EQ(::write(fd, header + 36, 8), 8);
+        EXPECT_EQ(::write(fd, data, bytes), static_cast<ssize_t>(bytes));
+        ::close(fd);
+        return path_.c_str();
+    }
+
+    std::string path_;
+};
+
+// Tone bursts: amplitude[i] for each 100 ms section, 1 kHz
+static std::vector<int16_t> tone_bursts(std::vector<double> const& amplitudes,
+                                        uint32_t sample_rate) {
+    std::vector<int16_t> samples;
+    uint32_t const section = sample_rate / 10;
+    for (std::size_t s = 0; s < amplitudes.size(); ++s) {
+        for (uint32_t i = 0; i < section; ++i) {
+            double const t = static_cast<double>(s * section + i) / sample_rate;
+            samples.push_back(static_cast<int16_t>(
+                std::lround(amplitudes[s] * 32767.0 * std::sin(2.0 * M_PI * 1000.0 * t))));
+        }
+    }
+    return samples;
+}
+
+// Test the SIMD block measurement matches the scalar reference exactly
+TEST(envelope_block_test, simd_matches_scalar) {
+    std::vector<int16_t> samples(4099);
+    std::srand(7);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<int16_t>(std::rand() % 65536 - 32768);
+    }
+    samples[5] = -32768;
+    samples[17] = 32767;
+    for (std::size_t length = 0; length < 70; ++length) {
+        envelope_stats const simd = envelope_block(samples.data() + 1, length);
+        envelope_stats const scalar = envelope_block_scalar(samples.data() + 1, length);
+        ASSERT_EQ(simd.sum_squares, scalar.sum_squares) << length;
+        ASSERT_EQ(simd.peak, scalar.peak) << length;
+        ASSERT_EQ(simd.samples, scalar.samples);
+    }
+    envelope_stats const all = envelope_block(samples.data(), samples.size());
+    EXPECT_EQ(all.sum_squares, envelope_block_scalar(samples.data(), samples.size()).sum_squares);
+    EXPECT_EQ(all.peak, 32767);
+
+    std::vector<int16_t> const full_scale(64, -32768);
+    EXPECT_EQ(envelope_block(full_scale.data(), 64).rms(), 32767);
+}
+
+// Test block RMS and peak against the analytic values for a sine
+TEST(envelope_block_test, sine_reference_levels) {
+    std::vector<int16_t> const tone = tone_bursts({0.5}, 48000);
+    envelope_stats const stats = envelope_block(tone.data(), 480);  // 10 whole cycles
+    EXPECT_NEAR(stats.rms(), 0.5 * 32767 / std::sqrt(2.0), 1.0);
+    EXPECT_NEAR(stats.peak, 0.5 * 32767, 1.0);
+}
+
+// Test 16-bit and float WAV files read back identically, past extra chunks
+TEST_F(wav_file_test, reads_pcm_and_float) {
+    int16_t const pcm[6] = {0, 1000, -1000, 32767, -32768, 5};
+    char const* path = write_wav(make_format(wav_format::PCM, 2, 8000), pcm, sizeof(pcm), true);
+    wav_reader wav;
+    ASSERT_TRUE(wav.open(path));
+    EXPECT_EQ(wav.get_format().channels, 2);
+    EXPECT_EQ(wav.get_format().sample_rate, 8000u);
+    int16_t frames[8] = {};
+    EXPECT_EQ(wav.read(frames, 2), 2u);
+    EXPECT_EQ(frames[3], 32767);
+    EXPECT_EQ(wav.read(frames, 4), 1u);  // Stops at the end of "data"
+    EXPECT_EQ(frames[0], -32768);
+    EXPECT_EQ(wav.read(frames, 4), 0u);
+    EXPECT_EQ(wav.get_frames_read(), 3u);
+
+    float const floats[4] = {0.0f, 0.5f, -1.0f, 2.0f};
+    path = write_wav(make_format(wav_format::IEEE_FLOAT, 1, 48000), floats, sizeof(floats));
+    ASSERT_TRUE(wav.open(path));
+    ASSERT_EQ(wav.read(frames, 8), 4u);
+    EXPECT_EQ(frames[1], 16384);
+    EXPECT_EQ(frames[2], -32767);
+    EXPECT_EQ(frames[3], 32767);  // Clipped
+}
+
+// Test headerless PCM from a pipe, as from stdin
+TEST(wav_reader_test, reads_raw_pcm_from_pipe) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    int16_t const pcm[3] = {1, -2, 3};
+    ASSERT_EQ(::write(fds[1], pcm, sizeof(pcm)), static_cast<ssize_t>(sizeof(pcm)));
+    ::close(fds[1]);
+
+    wav_reader wav;
+    ASSERT_TRUE(wav.open_raw(fds[0], make_format(wav_format::PCM, 1, 16000)));
+    int16_t frames[8] = {};
+    EXPECT_EQ(wav.read(frames, 8), 3u);
+    EXPECT_EQ(frames[1], -2);
+    EXPECT_EQ(wav.read(frames, 8), 0u);
+    ::close(fds[0]);
+
+    EXPECT_FALSE(wav.open_raw(0, make_format(7, 1, 16000)));
+}
+
+// Test malformed headers are rejected
+TEST_F(wav_file_test, rejects_bad_headers) {
+    int16_t const pcm[2] = {0, 0};
+    wav_format format = make_format(wav_format::PCM, 1, 44100);
+    char const* path = write_wav(format, pcm, sizeof(pcm));
+    wav_reader wav;
+    ASSERT_TRUE(wav.open(path));
+
+    std::vector<uint8_t> bytes(WAV_HEADER_SIZE);
+    wav_build_header(bytes.data(), format, 0);
+    bytes[20] = 2;  // ADPCM
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    ASSERT_EQ(::write(fds[1], bytes.data(), bytes.size()), static_cast<ssize_t>(bytes.size()));
+    ::close(fds[1]);
+    EXPECT_FALSE(wav.open_fd(fds[0]));
+    ::close(fds[0]);
+
+    EXPECT_FALSE(wav.open("/nonexistent/skull.wav"));
+}
+
+// Test the follower against a reference envelope of tone bursts
+TEST_F(wav_file_test, follows_reference_envelope) {
+    // 100 ms sections at 48 kHz; 10 ms blocks
+    std::vector<int16_t> const tone = tone_bursts({0.0, 0.8, 0.8, 0.2, 0.0, 0.0}, 48000);
+    char const* path = write_wav(make_format(wav_format::PCM, 1, 48000), tone.data(),
+                                 static_cast<uint32_t>(tone.size() * 2));
+    wav_reader wav;
+    ASSERT_TRUE(wav.open(path));
+    audio_envelope<480, 128> envelope(wav, {0, 50, 1.0f, false});  // Instant attack
+    envelope.start(1000);
+    EXPECT_EQ(envelope.pump(UINT32_MAX / 2), 60u);
+    EXPECT_EQ(envelope.pump(UINT32_MAX / 2), 0u);
+
+    std::vector<uint8_t> levels;
+    for (uint32_t t = 1010; t <= 1600; t += 10) {
+        levels.push_back(envelope.sample(t));
+    }
+    ASSERT_EQ(levels.size(), 60u);
+    uint8_t const loud = static_cast<uint8_t>(0.8 / std::sqrt(2.0) * 255 + 0.5);  // 144
+    EXPECT_EQ(levels[9], 0);         // Silence
+    EXPECT_NEAR(levels[10], loud, 1);  // First block of the burst: instant attack
+    EXPECT_NEAR(levels[29], loud, 1);
+    // 0.8 -> 0.2: released with a 50 ms time constant
+    uint8_t const quiet = static_cast<uint8_t>(0.2 / std::sqrt(2.0) * 255 + 0.5);
+    double const after_50ms = quiet + (loud - quiet) * std::exp(-1.0);
+    EXPECT_NEAR(levels[34], after_50ms, 2.0);
+    EXPECT_NEAR(levels[39], quiet + (loud - quiet) * std::exp(-2.0), 2.0);
+    EXPECT_LT(levels[59], 3);  // Decayed into the final silence
+    EXPECT_TRUE(envelope.is_finished());
+    EXPECT_EQ(envelope.get_skipped(), 0u);
+}
+
+// Test the ring bounds read-ahead and ticks sample the latest ended block
+TEST_F(wav_file_test, ring_bounds_read_ahead_and_drives_fades) {
+    std::vector<int16_t> const tone = tone_bursts({1.0, 1.0, 1.0, 1.0}, 8000);
+    char const* path = write_wav(make_format(wav_format::PCM, 1, 8000), tone.data(),
+                                 static_cast<uint32_t>(tone.size() * 2));
+    wav_reader wav;
+    ASSERT_TRUE(wav.open(path));
+    audio_envelope<80, 8> envelope(wav, {0, 0, 1.0f, true});  // 10 ms blocks, peaks
+    envelope.start(0);
+
+    EXPECT_EQ(envelope.pump(1000), 8u);  // Ring full: no further reading
+    EXPECT_EQ(envelope.get_queued(), 8u);
+    EXPECT_EQ(envelope.get_frames(), 640u);
+
+    mock_level_pin pin;
+    fade_controller<mock_level_pin> jaw(pin, 0);
+    envelope.drive(jaw, 5);  // Nothing has ended yet
+    EXPECT_EQ(jaw.get_target(), 0);
+    envelope.drive(jaw, 30);  // Blocks ending at 10, 20, 30 ms
+    jaw.update(30);
+    EXPECT_GE(pin.get_level(), 250);
+    EXPECT_EQ(envelope.get_skipped(), 2u);
+    EXPECT_EQ(envelope.get_queued(), 5u);
+
+    // Keep 50 ms queued, as a show loop would
+    EXPECT_EQ(envelope.pump(80), 0u);  // Already queued to 80 ms
+    EXPECT_EQ(envelope.pump(100), 2u);
+    uint32_t now = 30;
+    while (!envelope.is_finished() && now < 1000) {
+        now += 10;
+        envelope.pump(now + 50);
+        envelope.drive(jaw, now);
+    }
+    EXPECT_EQ(now, 400u);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "beat_timebase.h"
+#include "mock_hardware.h"
+#include "smf_import.h"
+
+// Test conversions through a tempo change at beat 4
+TEST(tempo_map_test, converts_across_tempo_changes) {
+    tempo_map<8> map;  // 120 BPM: 500 ms per beat
+    ASSERT_TRUE(map.add(4 * BEAT_PPQ, tempo_map<8>::bpm(60)));
+    EXPECT_FALSE(map.add(2 * BEAT_PPQ, tempo_map<8>::bpm(90)));  // Backwards
+
+    EXPECT_EQ(map.ms_to_tick(0), 0u);
+    EXPECT_EQ(map.ms_to_tick(250), BEAT_PPQ / 2);
+    EXPECT_EQ(map.ms_to_tick(2000), 4 * BEAT_PPQ);
+    EXPECT_EQ(map.ms_to_tick(3000), 5 * BEAT_PPQ);
+    EXPECT_EQ(map.tick_to_ms(4 * BEAT_PPQ), 2000u);
+    EXPECT_EQ(map.tick_to_ms(5 * BEAT_PPQ + BEAT_PPQ / 2), 3500u);
+    EXPECT_EQ(map.tempo_at(0), 500000u);
+    EXPECT_EQ(map.tempo_at(4 * BEAT_PPQ), 1000000u);
+}
+
+// Test tick_to_ms() returns the first millisecond that reaches the tick
+TEST(tempo_map_test, tick_to_ms_is_first_reaching_millisecond) {
+    tempo_map<4> map(tempo_map<4>::bpm(137));  // 437956 us per beat
+    for (uint32_t tick = 0; tick < 20 * BEAT_PPQ; tick += 7) {
+        uint32_t const ms = map.tick_to_ms(tick);
+        ASSERT_GE(map.ms_to_tick(ms), tick);
+        if (ms > 0) {
+            ASSERT_LT(map.ms_to_tick(ms - 1), tick);
+        }
+    }
+}
+
+// Test the cursor follows playback and recovers from seeks
+TEST(tempo_map_test, cursor_tracks_playback) {
+    tempo_map<256> map;
+    for (uint32_t i = 1; i < 256; ++i) {
+        ASSERT_TRUE(map.add(i * BEAT_PPQ, 400000 + (i % 7) * 25000));
+    }
+    // Reference: a fresh map (cursor at 0) for every lookup
+    std::vector<uint32_t> expected;
+    for (uint32_t ms = 0; ms < 120000; ms += 37) {
+        tempo_map<256> fresh = map;
+        expected.push_back(fresh.ms_to_tick(ms));
+    }
+    std::size_t i = 0;
+    for (uint32_t ms = 0; ms < 120000; ms += 37, ++i) {
+        ASSERT_EQ(map.ms_to_tick(ms), expected[i]);
+    }
+    EXPECT_GT(map.get_cursor(), 200u);
+
+    // Seek back: binary search lands on the right segment
+    EXPECT_EQ(map.ms_to_tick(999), expected[27]);  // 27 * 37 ms
+    EXPECT_EQ(map.get_cursor(), 2u);
+    EXPECT_EQ(map.ms_to_tick(0), 0u);
+}
+
+// Test an SMF tempo map loads onto the beat grid with the same times
+TEST(tempo_map_test, loads_smf_tempo_map) {
+    smf_tempo_map<8> smf;
+    smf.reset(500000, 96);
+    smf.add(192, 750000);  // 80 BPM from beat 2
+    smf.add(384, 400000);  // 150 BPM from beat 4
+    tempo_map<8> map;
+    ASSERT_TRUE(map.load(smf, 96));
+    EXPECT_EQ(map.get_segment_count(), 3u);
+    for (uint32_t tick = 0; tick < 960; tick += 12) {
+        uint64_t const expected_ms = (smf.tick_to_elapsed(tick) + 95999) / 96000;  // Round up
+        EXPECT_EQ(map.tick_to_ms(tick * BEAT_PPQ / 96), expected_ms) << "tick " << tick;
+    }
+    EXPECT_FALSE(map.load(smf, 480));  // Division mismatch
+}
+
+// Test the timebase anchors beat 0 and is wraparound-safe
+TEST(beat_timebase_test, converts_controller_time) {
+    tempo_map<4> map;
+    beat_timebase<tempo_map<4> > clock(map);
+    clock.start(UINT32_MAX - 499);  // 500 ms before millis() wraps
+    EXPECT_EQ(clock.update(UINT32_MAX - 499), 0u);
+    EXPECT_EQ(clock.update(500), 2 * BEAT_PPQ);  // 1 s later, across the wrap
+    EXPECT_EQ(clock.get_tick(), 2 * BEAT_PPQ);
+    EXPECT_EQ(clock.tick_to_controller_ms(4 * BEAT_PPQ), 1500u);
+}
+
+// Test a beat blink follows the music through a tempo change
+TEST(beat_blink_controller_test, edges_follow_the_beat) {
+    tempo_map<4> map;  // 120 BPM
+    map.add(2 * BEAT_PPQ, tempo_map<4>::bpm(60));
+    beat_timebase<tempo_map<4> > clock(map);
+    clock.start(0);
+    mock_pin pin;
+    beat_blink_controller<mock_pin> blink(pin, BEAT_PPQ / 2, BEAT_PPQ / 2);  // 8th notes
+
+    blink.update(clock.update(0));
+    EXPECT_FALSE(pin.get_state());
+    blink.update(clock.update(249));
+    EXPECT_FALSE(pin.get_state());
+    blink.update(clock.update(250));  // Half a beat at 120 BPM
+    EXPECT_TRUE(pin.get_state());
+    blink.update(clock.update(500));
+    EXPECT_FALSE(pin.get_state());
+
+    // After beat 2 (1000 ms) beats last 1000 ms
+    blink.update(clock.update(1499));
+    EXPECT_FALSE(pin.get_state());
+    blink.update(clock.update(1500));
+    EXPECT_TRUE(pin.get_state());
+    EXPECT_EQ(blink.ticks_until_toggle(clock.get_tick()), BEAT_PPQ / 2);
+    EXPECT_EQ(clock.tick_to_controller_ms(clock.get_tick() + BEAT_PPQ / 2), 2000u);
+}
+
+// Test late updates do not shift the grid and retiming waits for the period
+TEST(beat_blink_controller_test, grid_survives_late_updates_and_retiming) {
+    mock_pin pin;
+    beat_blink_controller<mock_pin> blink(pin, BEAT_PPQ, BEAT_PPQ);  // Period: 2 beats
+    blink.update(0);
+    blink.update(5 * BEAT_PPQ + 10);  // Missed two periods: still on the grid
+    EXPECT_EQ(blink.get_anchor_tick(), 4 * BEAT_PPQ);
+    EXPECT_TRUE(pin.get_state());  // Second beat of the period: ON
+
+    blink.set_durations(BEAT_PPQ / 4, BEAT_PPQ / 4);
+    blink.update(5 * BEAT_PPQ + 100);  // Current period keeps its durations
+    EXPECT_TRUE(pin.get_state());
+    EXPECT_EQ(blink.get_on_ticks(), BEAT_PPQ);
+    blink.update(6 * BEAT_PPQ);  // Boundary: new durations
+    EXPECT_EQ(blink.get_on_ticks(), BEAT_PPQ / 4);
+    EXPECT_FALSE(pin.get_state());
+    blink.update(6 * BEAT_PPQ + BEAT_PPQ / 4);
+    EXPECT_TRUE(pin.get_state());
+
+    // Loop back to the start of the song: realigned to beat 0
+    blink.update(BEAT_PPQ / 4 + 1);
+    EXPECT_EQ(blink.get_anchor_tick(), 0u);
+    EXPECT_TRUE(pin.get_state());
+
+    blink.restart(1000);
+    EXPECT_FALSE(pin.get_state());
+    blink.update(1000 + BEAT_PPQ / 4);
+    EXPECT_TRUE(pin.get_state());
+}
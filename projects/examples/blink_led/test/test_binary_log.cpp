@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binary_log.h"
+#include "blink_controller.h"
+#include "mock_hardware.h"
+
+// log_output that appends to a string
+static void append_to_string(void* context, char const* text, std::size_t length) {
+    static_cast<std::string*>(context)->append(text, length);
+}
+
+struct binary_log_test : public ::testing::Test {
+   protected:
+    binary_log_test() : logger(output(), 8), ring(nullptr) {}
+
+    void SetUp() override {
+        ring = logger.attach();
+        ASSERT_NE(ring, nullptr);
+    }
+
+    log_output output() {
+        log_output out = {&append_to_string, &text};
+        return out;
+    }
+
+    std::string text;
+    binary_logger logger;
+    log_ring* ring;
+};
+
+// Test arguments of each supported kind are decoded with their types
+TEST_F(binary_log_test, formats_typed_arguments) {
+    log_ring& log = *ring;
+    log.log("u=%u i=%d c=%c b=%d", 42u, -7, 'x', true);
+    log.log("ll=%lld ull=%llu", -5000000000LL, 18446744073709551615ULL);
+    log.log("f=%.2f d=%.3f", 1.5f, -2.25);
+    log.log("s=%s p=%s", "static", static_cast<char const*>("text"));
+    EXPECT_EQ(logger.drain(), 4u);
+    EXPECT_EQ(text,
+              "u=42 i=-7 c=x b=1\n"
+              "ll=-5000000000 ull=18446744073709551615\n"
+              "f=1.50 d=-2.250\n"
+              "s=static p=text\n");
+}
+
+// Test messages without arguments are printed verbatim
+TEST_F(binary_log_test, no_argument_message_is_verbatim) {
+    log_ring& log = *ring;
+    log.log("100% done");
+    logger.drain();
+    EXPECT_EQ(text, "100% done\n");
+}
+
+// Test nothing is formatted until drain()
+TEST_F(binary_log_test, formatting_is_deferred) {
+    log_ring& log = *ring;
+    log.log("tick %u", 1u);
+    EXPECT_TRUE(text.empty());
+    logger.drain();
+    EXPECT_EQ(text, "tick 1\n");
+}
+
+// Test a full ring drops instead of blocking, and recovers after drain
+TEST_F(binary_log_test, full_ring_drops_records) {
+    log_ring& log = *ring;
+    EXPECT_EQ(log.get_capacity(), 8u);
+    for (uint32_t i = 0; i < 8; ++i) {
+        EXPECT_TRUE(log.log("%u", i));
+    }
+    EXPECT_FALSE(log.log("%u", 8u));
+    EXPECT_EQ(logger.get_dropped(), 1u);
+
+    EXPECT_EQ(logger.drain(), 8u);
+    EXPECT_TRUE(log.log("%u", 9u));
+    logger.drain();
+    EXPECT_EQ(text, "0\n1\n2\n3\n4\n5\n6\n7\n9\n");
+}
+
+// Test over-long lines are truncated, not overflowed
+TEST_F(binary_log_test, long_lines_truncated) {
+    log_ring& log = *ring;
+    std::string const long_text(1000, 'a');
+    static std::string const keep = long_text;
+    log.log("%s", keep.c_str());
+    logger.drain();
+    std::size_t const max_line = binary_logger::MAX_LINE;
+    EXPECT_EQ(text.size(), max_line);
+    EXPECT_EQ(text.back(), '\n');
+}
+
+// Test several producer threads with the background decoder
+TEST(binary_logger, background_decoder_collects_all_threads) {
+    std::string text;
+    log_output out = {&append_to_string, &text};
+    binary_logger logger(out, 1 << 16);
+
+    static uint32_t const THREADS = 4;
+    static uint32_t const PER_THREAD = 10000;
+    std::vector<log_ring*> rings;
+    for (uint32_t t = 0; t < THREADS; ++t) {
+        rings.push_back(logger.attach());
+    }
+    logger.start(std::chrono::milliseconds(1));
+
+    std::vector<std::thread> producers;
+    for (uint32_t t = 0; t < THREADS; ++t) {
+        producers.push_back(std::thread([&rings, t]() {
+            for (uint32_t i = 0; i < PER_THREAD; ++i) {
+                rings[t]->log("%u:%u", t, i);
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < producers.size(); ++t) {
+        producers[t].join();
+    }
+    logger.stop();
+
+    EXPECT_EQ(logger.get_dropped(), 0u);
+    std::size_t lines = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        lines += text[i] == '\n' ? 1 : 0;
+    }
+    EXPECT_EQ(lines, THREADS * PER_THREAD);
+    EXPECT_NE(text.find("3:9999\n"), std::string::npos);
+}
+
+// Test attach() stops at MAX_RINGS
+TEST(binary_logger, attach_limit) {
+    std::string text;
+    log_output out = {&append_to_string, &text};
+    binary_logger logger(out, 2);
+    std::size_t const max_rings = binary_logger::MAX_RINGS;
+    for (std::size_t i = 0; i < max_rings; ++i) {
+        EXPECT_NE(logger.attach(), nullptr);
+    }
+    EXPECT_EQ(logger.attach(), nullptr);
+    EXPECT_EQ(logger.get_ring_count(), max_rings);
+}
+
+// Test the pin decorator logs the initial state and transitions only
+TEST_F(binary_log_test, transition_logging_pin_logs_changes) {
+    log_ring& log = *ring;
+    mock_pin pin;
+    mock_timer timer;
+    transition_logging_pin<mock_pin, mock_timer> logged(pin, timer, log, 3);
+    blink_controller<transition_logging_pin<mock_pin, mock_timer> > controller(logged, 100, 50);
+
+    for (uint32_t t = 0; t <= 300; t += 10) {
+        timer.set_time(t);
+        controller.update(t);
+    }
+    logger.drain();
+
+    EXPECT_EQ(text,
+              "[0ms] channel 3 OFF\n"
+              "[50ms] channel 3 ON\n"
+              "[150ms] channel 3 OFF\n"
+              "[200ms] channel 3 ON\n"
+              "[300ms] channel 3 OFF\n");
+    EXPECT_EQ(pin.get_toggle_count(), 31u);  // Every set() is still forwarded
+    EXPECT_EQ(logged.get_state(), pin.get_state());
+}
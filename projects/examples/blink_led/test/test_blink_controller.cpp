@@ -257,3 +257,226 @@ TEST_F(blink_controller_test, output_pin_updated_every_call) {
     controller.update(timer.millis());
     EXPECT_GT(pin.get_toggle_count(), count_after_first);
 }
+
+// Test that new durations wait for the next edge
+TEST_F(blink_controller_test, set_durations_takes_effect_at_next_edge) {
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    // Shortening OFF mid-interval must not cut the interval in progress
+    controller.update(timer.millis());
+    controller.set_durations(200, 100);
+    EXPECT_EQ(controller.get_off_duration(), 500);
+    EXPECT_EQ(controller.get_next_off_duration(), 100);
+
+    timer.advance(499);
+    controller.update(timer.millis());
+    EXPECT_FALSE(pin.get_state());
+
+    // Edge at 500ms latches the new timing
+    timer.advance(1);
+    controller.update(timer.millis());
+    EXPECT_TRUE(pin.get_state());
+    EXPECT_EQ(controller.get_on_duration(), 200);
+    EXPECT_EQ(controller.get_off_duration(), 100);
+
+    // New ON duration applies to the interval that just started
+    timer.advance(200);
+    controller.update(timer.millis());
+    EXPECT_FALSE(pin.get_state());
+
+    // And the new OFF duration to the one after it
+    timer.advance(100);
+    controller.update(timer.millis());
+    EXPECT_TRUE(pin.get_state());
+}
+
+// Test that reset latches pending durations
+TEST_F(blink_controller_test, reset_latches_pending_durations) {
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    controller.set_durations(300, 200);
+    controller.reset();
+
+    EXPECT_EQ(controller.get_on_duration(), 300);
+    EXPECT_EQ(controller.get_off_duration(), 200);
+}
+
+// Test that a positive phase shift delays the pending edge
+TEST_F(blink_controller_test, shift_phase_delays_edge) {
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    controller.update(timer.millis());
+    controller.shift_phase(100);
+
+    timer.advance(599);
+    controller.update(timer.millis());
+    EXPECT_FALSE(pin.get_state());
+
+    timer.advance(1);
+    controller.update(timer.millis());
+    EXPECT_TRUE(pin.get_state());
+    EXPECT_EQ(controller.get_phase_adjust(), 0);
+
+    // Shift only applied to one interval
+    timer.advance(1000);
+    controller.update(timer.millis());
+    EXPECT_FALSE(pin.get_state());
+}
+
+// Test that a negative phase shift advances the pending edge
+TEST_F(blink_controller_test, shift_phase_advances_edge) {
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    controller.update(timer.millis());
+    controller.shift_phase(-200);
+    controller.shift_phase(-100);
+    EXPECT_EQ(controller.get_phase_adjust(), -300);
+
+    timer.advance(199);
+    controller.update(timer.millis());
+    EXPECT_FALSE(pin.get_state());
+
+    timer.advance(1);
+    controller.update(timer.millis());
+    EXPECT_TRUE(pin.get_state());
+}
+
+// Test phase shift saturation at both ends of the duration range
+TEST_F(blink_controller_test, shift_phase_saturates) {
+    // Advancing past the edge toggles on the next update
+    blink_controller<mock_pin> early(pin, 1000, 500);
+    early.update(timer.millis());
+    early.shift_phase(INT32_MIN);
+    timer.advance(1);
+    early.update(timer.millis());
+    EXPECT_TRUE(early.is_on());
+
+    // Delaying a near-maximal duration clamps instead of wrapping
+    timer.reset();
+    blink_controller<mock_pin> late(pin, 1000, UINT32_MAX - 10);
+    late.update(timer.millis());
+    late.shift_phase(100);
+    timer.advance(1000);
+    late.update(timer.millis());
+    EXPECT_FALSE(late.is_on());
+
+    // Accumulated shifts clamp instead of overflowing
+    late.shift_phase(INT32_MAX);
+    late.shift_phase(INT32_MAX);
+    EXPECT_EQ(late.get_phase_adjust(), INT32_MAX);
+    early.shift_phase(INT32_MIN);
+    early.shift_phase(-1);
+    EXPECT_EQ(early.get_phase_adjust(), INT32_MIN);
+}
+
+// Test time until the next edge
+TEST_F(blink_controller_test, time_until_toggle_counts_down) {
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+
+    controller.update(timer.millis());
+    EXPECT_EQ(controller.time_until_toggle(0), 500);
+    EXPECT_EQ(controller.time_until_toggle(499), 1);
+    EXPECT_EQ(controller.time_until_toggle(500), 0);
+    EXPECT_EQ(controller.time_until_toggle(900), 0);
+
+    // After the edge the ON duration applies
+    controller.update(500);
+    EXPECT_EQ(controller.time_until_toggle(500), 1000);
+
+    // Phase shifts move the deadline, pending durations don't
+    controller.shift_phase(-200);
+    controller.set_durations(10, 10);
+    EXPECT_EQ(controller.time_until_toggle(500), 800);
+}
+
+// Test time until the next edge across timer wraparound
+TEST_F(blink_controller_test, time_until_toggle_handles_wraparound) {
+    blink_controller<mock_pin> controller(pin, 100, 100);
+
+    controller.update(UINT32_MAX - 150);
+    controller.update(UINT32_MAX - 40);
+    EXPECT_FALSE(controller.is_on());
+
+    // Elapsed at 10 after wrap: 40 + 10 + 1 = 51ms of 100ms
+    EXPECT_EQ(controller.time_until_toggle(10), 49);
+    EXPECT_EQ(controller.time_until_toggle(59), 0);
+}
+
+// Test restart() begins a fresh OFF interval at the trigger time
+TEST_F(blink_controller_test, restart_starts_pattern_at_trigger_time) {
+    blink_controller<mock_pin> controller(pin, 100, 50);
+    controller.update(60);
+    EXPECT_TRUE(controller.is_on());
+
+    controller.set_durations(200, 80);
+    controller.restart(1000);
+    EXPECT_FALSE(controller.is_on());
+    EXPECT_FALSE(pin.get_state());
+    EXPECT_EQ(controller.get_on_duration(), 200);
+    EXPECT_EQ(controller.time_until_toggle(1000), 80);
+
+    controller.update(1079);
+    EXPECT_FALSE(controller.is_on());
+    controller.update(1080);
+    EXPECT_TRUE(controller.is_on());
+}
+
+// Test fast_forward() lands where per-millisecond updates do, zero durations included
+TEST_F(blink_controller_test, fast_forward_matches_per_millisecond_updates) {
+    uint32_t const durations[][2] = {{100, 50}, {0, 7}, {3, 0}, {0, 0}, {1, 1}, {997, 13}};
+    for (auto const& d : durations) {
+        mock_pin stepped_pin;
+        blink_controller<mock_pin> stepped(stepped_pin, d[0], d[1]);
+        blink_controller<mock_pin> jumped(pin, d[0], d[1]);
+        stepped.update(0);
+        jumped.update(0);
+        stepped.set_durations(d[1] + 5, d[0] + 2);  // Latched at the next edge
+        jumped.set_durations(d[1] + 5, d[0] + 2);
+        uint32_t const stops[] = {1, 2, 40, 41, 1000, 4321, 4322, 20000};
+        uint32_t now = 0;
+        for (uint32_t stop : stops) {
+            while (now < stop) {
+                stepped.update(++now);
+            }
+            jumped.fast_forward(stop);
+            ASSERT_EQ(jumped.is_on(), stepped.is_on()) << d[0] << "/" << d[1] << " @" << stop;
+            ASSERT_EQ(jumped.get_last_toggle_time(), stepped.get_last_toggle_time());
+            ASSERT_EQ(jumped.get_on_duration(), stepped.get_on_duration());
+            ASSERT_EQ(pin.get_state(), stepped_pin.get_state());
+        }
+    }
+}
+
+// Test fast_forward() after a phase shift and across the millis() wrap
+TEST_F(blink_controller_test, fast_forward_honors_phase_and_wraparound) {
+    blink_controller<mock_pin> controller(pin, 100, 100);
+    controller.restart(UINT32_MAX - 149);
+    controller.shift_phase(-40);  // OFF ends 60 ms after the trigger
+    controller.update(UINT32_MAX - 149);
+    controller.fast_forward(UINT32_MAX - 90);
+    EXPECT_FALSE(controller.is_on());
+    controller.fast_forward(UINT32_MAX - 89);
+    EXPECT_TRUE(controller.is_on());
+    controller.fast_forward(1000);  // Past the wrap: OFF at 10, then 200 ms periods
+    EXPECT_TRUE(controller.is_on());
+    EXPECT_EQ(controller.get_last_toggle_time(), 910u);
+    EXPECT_TRUE(pin.get_state());
+}
+
+// Test save() and restore() round-trip the timing state
+TEST_F(blink_controller_test, save_and_restore_round_trip) {
+    blink_controller<mock_pin> controller(pin, 100, 50);
+    controller.update(60);
+    controller.set_durations(30, 20);
+    controller.shift_phase(5);
+    blink_controller<mock_pin>::snapshot const saved = controller.save();
+
+    controller.update(500);
+    controller.set_durations(1, 1);
+    controller.restore(saved);
+    EXPECT_TRUE(controller.is_on());
+    EXPECT_EQ(controller.get_last_toggle_time(), 60u);
+    EXPECT_EQ(controller.get_next_on_duration(), 30u);
+    EXPECT_EQ(controller.get_phase_adjust(), 5);
+    EXPECT_EQ(controller.time_until_toggle(60), 105u);
+}
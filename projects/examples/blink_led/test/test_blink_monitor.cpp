@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "blink_controller.h"
+#include "blink_monitor.h"
+#include "mock_hardware.h"
+
+// Minimal stand-in exposing the inspected interface directly
+struct fake_controller {
+    bool on;
+    uint32_t last_toggle_ms;
+
+    bool is_on() const { return on; }
+    uint32_t get_last_toggle_time() const { return last_toggle_ms; }
+};
+
+// Test empty monitor snapshot
+TEST(blink_monitor_test, initial_snapshot_is_zeroed) {
+    blink_monitor<4> monitor;
+    monitor_snapshot<4> snap;
+
+    EXPECT_TRUE(monitor.try_snapshot(snap));
+    EXPECT_EQ(snap.frame, 0);
+    EXPECT_EQ(snap.time_ms, 0);
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_FALSE(snap.channels[i].on);
+        EXPECT_EQ(snap.channels[i].last_toggle_ms, 0);
+        EXPECT_EQ(snap.channels[i].change_count, 0);
+    }
+    EXPECT_EQ(monitor.get_frame_count(), 0);
+    EXPECT_EQ(blink_monitor<4>::CHANNEL_COUNT, 4);
+}
+
+// Test snapshot reflects real blink_controllers
+TEST(blink_monitor_test, snapshot_reflects_controllers) {
+    mock_pin pins[2];
+    blink_controller<mock_pin> controllers[2] = {
+        blink_controller<mock_pin>(pins[0], 100, 100),
+        blink_controller<mock_pin>(pins[1], 300, 300),
+    };
+    blink_monitor<2> monitor;
+    monitor_snapshot<2> snap;
+
+    for (uint32_t t = 0; t <= 200; t += 10) {
+        controllers[0].update(t);
+        controllers[1].update(t);
+        monitor.publish(controllers, t);
+    }
+    monitor.snapshot(snap);
+
+    EXPECT_EQ(snap.frame, 21);
+    EXPECT_EQ(snap.time_ms, 200);
+    EXPECT_EQ(snap.channels[0].on, controllers[0].is_on());
+    EXPECT_EQ(snap.channels[0].last_toggle_ms, controllers[0].get_last_toggle_time());
+    EXPECT_EQ(snap.channels[0].change_count, 2);  // on at 100, off at 200
+    EXPECT_FALSE(snap.channels[1].on);
+    EXPECT_EQ(snap.channels[1].change_count, 0);
+    EXPECT_EQ(monitor.get_frame_count(), 21);
+}
+
+// Test change counting across many frames, one edge per frame
+TEST(blink_monitor_test, counts_every_sampled_change) {
+    fake_controller channel = {false, 0};
+    blink_monitor<1> monitor;
+
+    for (uint32_t t = 1; t <= 1000; ++t) {
+        channel.on = !channel.on;
+        channel.last_toggle_ms = t;
+        monitor.publish(&channel, t);
+    }
+    monitor_snapshot<1> snap;
+    monitor.snapshot(snap);
+
+    EXPECT_EQ(snap.channels[0].change_count, 1000);
+    EXPECT_FALSE(snap.channels[0].on);
+    EXPECT_EQ(snap.channels[0].last_toggle_ms, 1000);
+
+    // Two edges between frames: same state, so no change counted; the time still moves
+    channel.last_toggle_ms = 1002;
+    monitor.publish(&channel, 1002);
+    monitor.snapshot(snap);
+    EXPECT_EQ(snap.channels[0].change_count, 1000);
+    EXPECT_EQ(snap.channels[0].last_toggle_ms, 1002);
+}
+
+// Test try_snapshot fails while a frame is being written
+TEST(blink_monitor_test, try_snapshot_fails_during_write) {
+    blink_monitor<1> monitor;
+    monitor_snapshot<1> snap;
+    fake_controller channel = {true, 5};
+
+    monitor.begin_frame(5);
+    monitor.record(0, channel);
+
+    // Reader returns immediately instead of waiting for the writer
+    EXPECT_FALSE(monitor.try_snapshot(snap));
+    EXPECT_EQ(monitor.get_frame_count(), 0);
+
+    monitor.end_frame();
+    EXPECT_TRUE(monitor.try_snapshot(snap));
+    EXPECT_TRUE(snap.channels[0].on);
+    EXPECT_EQ(snap.channels[0].change_count, 1);
+}
+
+// Test monitoring thread only ever sees whole frames
+TEST(blink_monitor_test, concurrent_snapshots_are_consistent) {
+    static std::size_t const CHANNELS = 64;
+    fake_controller channels[CHANNELS];
+    blink_monitor<CHANNELS> monitor;
+    std::atomic<bool> done(false);
+
+    // Writer: every channel mirrors the frame time, all flip together
+    std::thread writer([&]() {
+        for (uint32_t t = 1; t <= 20000; ++t) {
+            for (std::size_t i = 0; i < CHANNELS; ++i) {
+                channels[i].on = (t & 1u) != 0;
+                channels[i].last_toggle_ms = t;
+            }
+            monitor.publish(channels, t);
+        }
+        done.store(true);
+    });
+
+    uint32_t inconsistent = 0;
+    uint32_t snapshots = 0;
+    monitor_snapshot<CHANNELS> snap;
+    // Read at least once even if the writer finishes first (single-core hosts)
+    do {
+        monitor.snapshot(snap);
+        for (std::size_t i = 0; i < CHANNELS; ++i) {
+            channel_snapshot const& ch = snap.channels[i];
+            if (ch.last_toggle_ms != snap.time_ms || ch.change_count != snap.time_ms ||
+                ch.on != ((snap.time_ms & 1u) != 0)) {
+                ++inconsistent;
+            }
+        }
+        ++snapshots;
+    } while (!done.load());
+    writer.join();
+
+    EXPECT_EQ(inconsistent, 0);
+    EXPECT_GT(snapshots, 0);
+    monitor.snapshot(snap);
+    EXPECT_EQ(snap.frame, 20000);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "cobs.h"
+
+typedef cobs_decoder<600> decoder_t;
+
+// Encode, delimit and decode a payload through the incremental decoder
+static std::vector<uint8_t> round_trip(std::vector<uint8_t> const& payload) {
+    std::vector<uint8_t> wire(cobs_max_encoded_size(payload.size()) + 1);
+    std::size_t const length =
+        cobs_encode(payload.data(), payload.size(), wire.data(), wire.size());
+    EXPECT_GT(length, 0u);
+    for (std::size_t i = 0; i < length; ++i) {
+        EXPECT_NE(wire[i], 0) << "zero at " << i;
+    }
+
+    decoder_t decoder;
+    for (std::size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(decoder.push(wire[i]), decoder_t::pending);
+    }
+    EXPECT_EQ(decoder.push(0), decoder_t::frame);
+    return std::vector<uint8_t>(decoder.data(), decoder.data() + decoder.size());
+}
+
+// Test reference vectors from the COBS paper / Wikipedia
+TEST(cobs_test, reference_vectors) {
+    uint8_t out[8];
+    uint8_t const zero[] = {0x00};
+    ASSERT_EQ(cobs_encode(zero, 1, out, sizeof(out)), 2u);
+    EXPECT_EQ(out[0], 0x01);
+    EXPECT_EQ(out[1], 0x01);
+
+    uint8_t const mixed[] = {0x11, 0x22, 0x00, 0x33};
+    ASSERT_EQ(cobs_encode(mixed, 4, out, sizeof(out)), 5u);
+    uint8_t const expected[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    for (std::size_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(out[i], expected[i]);
+    }
+}
+
+// Test round trips including zero runs and 254-byte block boundaries
+TEST(cobs_test, round_trips) {
+    std::vector<std::vector<uint8_t> > payloads;
+    payloads.push_back(std::vector<uint8_t>());
+    payloads.push_back(std::vector<uint8_t>(1, 0));
+    payloads.push_back(std::vector<uint8_t>(5, 0));
+    for (std::size_t size = 252; size <= 256; ++size) {
+        payloads.push_back(std::vector<uint8_t>(size, 0x5A));
+    }
+    std::vector<uint8_t> ramp;
+    for (uint32_t i = 0; i < 520; ++i) {
+        ramp.push_back(static_cast<uint8_t>(i));
+    }
+    payloads.push_back(ramp);
+
+    for (std::size_t i = 0; i < payloads.size(); ++i) {
+        EXPECT_EQ(round_trip(payloads[i]), payloads[i]) << "payload " << i;
+    }
+}
+
+// Test encoding fails cleanly when the output is too small
+TEST(cobs_test, encode_reports_overflow) {
+    uint8_t const data[] = {1, 2, 3, 4};
+    uint8_t out[4];
+    EXPECT_EQ(cobs_encode(data, 4, out, sizeof(out)), 0u);
+    EXPECT_EQ(cobs_encode(data, 4, out, 0), 0u);
+}
+
+// Test idle delimiters are ignored and frames are back to back
+TEST(cobs_test, decoder_handles_idle_and_consecutive_frames) {
+    cobs_decoder<8> decoder;
+    EXPECT_EQ(decoder.push(0), cobs_decoder<8>::pending);
+    uint8_t const stream[] = {0x02, 0xAA, 0x00, 0x01, 0x01, 0x00};
+    EXPECT_EQ(decoder.push(stream[0]), cobs_decoder<8>::pending);
+    EXPECT_EQ(decoder.push(stream[1]), cobs_decoder<8>::pending);
+    ASSERT_EQ(decoder.push(stream[2]), cobs_decoder<8>::frame);
+    ASSERT_EQ(decoder.size(), 1u);
+    EXPECT_EQ(decoder.data()[0], 0xAA);
+
+    decoder.push(stream[3]);
+    decoder.push(stream[4]);
+    ASSERT_EQ(decoder.push(stream[5]), cobs_decoder<8>::frame);
+    ASSERT_EQ(decoder.size(), 1u);
+    EXPECT_EQ(decoder.data()[0], 0x00);
+}
+
+// Test truncated blocks and oversize frames are errors, then resync
+TEST(cobs_test, decoder_reports_errors_and_resyncs) {
+    cobs_decoder<4> decoder;
+    // Code promises 4 data bytes, delimiter after 1
+    decoder.push(0x05);
+    decoder.push(0x11);
+    EXPECT_EQ(decoder.push(0), cobs_decoder<4>::error);
+
+    // Six data bytes into a 4-byte buffer
+    decoder.push(0x07);
+    for (int i = 0; i < 6; ++i) {
+        decoder.push(0x22);
+    }
+    EXPECT_EQ(decoder.push(0), cobs_decoder<4>::error);
+
+    decoder.push(0x02);
+    decoder.push(0x33);
+    ASSERT_EQ(decoder.push(0), cobs_decoder<4>::frame);
+    EXPECT_EQ(decoder.data()[0], 0x33);
+}
@@ -329,3 +329,10 @@ TEST(console_simulator_integration, timer_and_pin_work_together) {
     // Should be within reasonable tolerance (±10ms)
     EXPECT_LE(std::abs(static_cast<int>(elapsed) - static_cast<int>(pin_time)), 10);
 }
+
+// Test state_label is the label format_output uses
+TEST(console_led_pin_format, state_label_matches_format_output) {
+    EXPECT_EQ(console_led_pin::format_output(5, true),
+              std::string("[5ms] LED: ") + console_led_pin::state_label(true));
+    EXPECT_EQ(console_led_pin::strip_ansi_codes(console_led_pin::state_label(false)), "▓▓▓ OFF ▓▓▓");
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "crc16.h"
+
+// Test the CRC-16/CCITT-FALSE check value
+TEST(crc16_test, check_value) {
+    char const* const text = "123456789";
+    EXPECT_EQ(crc16(reinterpret_cast<uint8_t const*>(text), std::strlen(text)), 0x29B1);
+}
+
+// Test empty input returns the initial value
+TEST(crc16_test, empty_input) {
+    EXPECT_EQ(crc16(nullptr, 0), CRC16_INIT);
+}
+
+// Test the table matches the bitwise definition
+TEST(crc16_test, table_matches_bitwise_crc) {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = static_cast<uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+        }
+        EXPECT_EQ(crc16_table_entry(static_cast<uint8_t>(i)), crc) << "entry " << i;
+    }
+}
+
+// Test incremental updates equal a one-shot CRC
+TEST(crc16_test, incremental_equals_one_shot) {
+    uint8_t const data[] = {0x01, 0x00, 0xFF, 0x42, 0x10, 0x00, 0x7E};
+    uint16_t crc = CRC16_INIT;
+    for (std::size_t i = 0; i < sizeof(data); ++i) {
+        crc = crc16_update(crc, data[i]);
+    }
+    EXPECT_EQ(crc, crc16(data, sizeof(data)));
+    EXPECT_EQ(crc16(data + 3, 4, crc16(data, 3)), crc);
+}
+
+// Test single-bit corruption is detected
+TEST(crc16_test, detects_single_bit_errors) {
+    uint8_t data[16];
+    for (std::size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37);
+    }
+    uint16_t const good = crc16(data, sizeof(data));
+    for (std::size_t bit = 0; bit < sizeof(data) * 8; ++bit) {
+        data[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+        EXPECT_NE(crc16(data, sizeof(data)), good);
+        data[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+    }
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "cue_list.h"
+#include "fade_controller.h"
+#include "mock_hardware.h"
+#include "smf_import.h"
+
+typedef fade_controller<mock_level_pin> test_fade;
+
+// Fade stand-in that records every call
+struct recording_fade {
+    recording_fade() : target(0), duration(0), calls(0) {}
+    void set_fade_duration(uint32_t ms) { duration = ms; }
+    void set_target(uint8_t level, uint32_t) {
+        target = level;
+        ++calls;
+    }
+    uint8_t target;
+    uint32_t duration;
+    uint32_t calls;
+};
+
+// Test GO and back fade the changed channels over the cue's fade time
+TEST(cue_list_test, go_and_back_apply_deltas) {
+    mock_level_pin pins[3];
+    test_fade fades[3] = {test_fade(pins[0], 0), test_fade(pins[1], 0), test_fade(pins[2], 0)};
+    cue_list<test_fade, 3, 8, 16> show;
+    for (std::size_t c = 0; c < 3; ++c) {
+        ASSERT_TRUE(show.bind(c, fades[c]));
+    }
+    ASSERT_TRUE(show.add_cue(1000, 100));
+    ASSERT_TRUE(show.add_change(0, 200));
+    ASSERT_TRUE(show.add_cue(2000, 400));
+    ASSERT_TRUE(show.add_change(1, 100));
+    ASSERT_TRUE(show.add_change(0, 50));
+    show.compile();
+    EXPECT_EQ(show.get_current_cue(), MIDI_CUE_NONE);
+
+    ASSERT_TRUE(show.go(0));
+    EXPECT_EQ(fades[0].get_fade_duration(), 100u);
+    fades[0].update(100);
+    EXPECT_EQ(pins[0].get_level(), 200);
+    ASSERT_TRUE(show.go(1000));
+    EXPECT_EQ(show.get_current_cue(), 2000u);
+    EXPECT_EQ(fades[0].get_target(), 50);
+    EXPECT_EQ(fades[1].get_fade_duration(), 400u);
+    EXPECT_FALSE(show.go(2000));  // End of the list
+
+    ASSERT_TRUE(show.back(3000));  // Restores what cue 2 replaced
+    EXPECT_EQ(fades[0].get_target(), 200);
+    EXPECT_EQ(fades[1].get_target(), 0);
+    EXPECT_EQ(show.get_current_cue(), 1000u);
+    ASSERT_TRUE(show.back(3000));
+    EXPECT_EQ(show.get_level(0), 0);
+    EXPECT_FALSE(show.back(3000));
+    EXPECT_EQ(fades[2].get_target(), 0);  // Never changed
+}
+
+// Test jumps land on exactly the state replaying the list would give
+template<std::size_t interval_v>
+static void check_jumps_match_replay() {
+    std::size_t const CUES = 200;
+    cue_list<recording_fade, 16, CUES, 2000, interval_v> show;
+    std::vector<std::vector<uint8_t> > expected(1, std::vector<uint8_t>(16, 0));
+    std::srand(42);
+    for (std::size_t i = 0; i < CUES; ++i) {
+        ASSERT_TRUE(show.add_cue(static_cast<uint32_t>((i + 1) * 1000), 0));
+        std::vector<uint8_t> look = expected.back();
+        for (int k = std::rand() % 4; k >= 0; --k) {
+            std::size_t const channel = static_cast<std::size_t>(std::rand() % 16);
+            uint8_t const level = static_cast<uint8_t>(std::rand() % 4 * 85);
+            ASSERT_TRUE(show.add_change(channel, level));
+            look[channel] = level;
+        }
+        expected.push_back(look);
+    }
+    show.compile();
+    for (int j = 0; j < 500; ++j) {
+        std::size_t const position = static_cast<std::size_t>(std::rand() % (CUES + 1));
+        ASSERT_TRUE(show.jump_to_position(position, 0, 0));
+        for (std::size_t c = 0; c < 16; ++c) {
+            ASSERT_EQ(show.get_level(c), expected[position][c]) << position << ":" << c;
+        }
+        if (position < CUES) {  // GO after a jump continues from there
+            ASSERT_TRUE(show.go(0));
+            for (std::size_t c = 0; c < 16; ++c) {
+                ASSERT_EQ(show.get_level(c), expected[position + 1][c]);
+            }
+        }
+    }
+}
+
+TEST(cue_list_test, jumps_match_replay) {
+    check_jumps_match_replay<1>();
+    check_jumps_match_replay<7>();
+    check_jumps_match_replay<1000>();  // Only the dark snapshot: full replay
+}
+
+// Test no-op changes are dropped and jumps drive only the channels that differ
+TEST(cue_list_test, compiles_minimal_deltas) {
+    recording_fade fades[4];
+    cue_list<recording_fade, 4, 8, 16, 2> show;
+    for (std::size_t c = 0; c < 4; ++c) {
+        show.bind(c, fades[c]);
+    }
+    show.add_cue(1000, 0);
+    show.add_change(0, 255);
+    show.add_change(1, 0);  // Already 0
+    show.add_cue(1500, 0);
+    show.add_change(0, 255);  // Tracks from cue 1
+    show.add_change(2, 10);
+    show.add_cue(47000, 0);
+    show.add_change(3, 99);
+    EXPECT_FALSE(show.is_compiled());
+    show.compile();
+    EXPECT_TRUE(show.is_compiled());
+    EXPECT_EQ(show.get_change_count(), 3u);
+
+    ASSERT_TRUE(show.jump(47000, 0, 1500));
+    EXPECT_EQ(fades[0].calls, 1u);
+    EXPECT_EQ(fades[1].calls, 0u);
+    EXPECT_EQ(fades[3].target, 99);
+    EXPECT_EQ(fades[3].duration, 1500u);
+    ASSERT_TRUE(show.jump(1000, 0, 0));  // Back to cue 1: channels 2 and 3 go out
+    EXPECT_EQ(fades[0].calls, 1u);
+    EXPECT_EQ(fades[2].target, 0);
+    EXPECT_EQ(fades[3].target, 0);
+    EXPECT_FALSE(show.jump(46000, 0, 0));  // No such cue
+    EXPECT_EQ(show.get_position(), 1u);
+}
+
+// Test MSC GO, GO with a cue number and RESET from imported show control
+TEST(cue_list_test, handles_msc_commands) {
+    recording_fade fade;
+    cue_list<recording_fade, 1, 4, 4> show;
+    show.bind(0, fade);
+    show.add_cue(1000, 0);
+    show.add_change(0, 10);
+    show.add_cue(12500, 800);
+    show.add_change(0, 20);
+    show.add_cue(13000, 0);
+    show.add_change(0, 30);
+    show.compile();
+
+    midi_cue msc = {0, midi_cue_type::show_control, 0x7F, MSC_GO, 1, MIDI_CUE_NONE};
+    EXPECT_TRUE(show.handle(msc, 0));
+    EXPECT_EQ(fade.target, 10);
+    msc.cue = 12500;  // "12.5"
+    EXPECT_TRUE(show.handle(msc, 0));
+    EXPECT_EQ(fade.target, 20);
+    EXPECT_EQ(fade.duration, 800u);
+    msc.number = MSC_RESET;
+    EXPECT_TRUE(show.handle(msc, 0));
+    EXPECT_EQ(fade.target, 0);
+    EXPECT_EQ(show.get_position(), 0u);
+    msc.number = MSC_STOP;
+    EXPECT_FALSE(show.handle(msc, 0));
+    midi_cue const note = {0, midi_cue_type::note_on, 0, 60, 100, MIDI_CUE_NONE};
+    EXPECT_FALSE(show.handle(note, 0));
+}
+
+// Test recording limits and GO before compile
+TEST(cue_list_test, rejects_bad_recordings) {
+    cue_list<recording_fade, 2, 2, 2> show;
+    recording_fade fade;
+    EXPECT_FALSE(show.bind(2, fade));
+    EXPECT_FALSE(show.add_change(0, 1));  // No cue yet
+    EXPECT_TRUE(show.add_cue(5000, 0));
+    EXPECT_FALSE(show.add_cue(5000, 0));  // Not increasing
+    EXPECT_FALSE(show.add_change(2, 1));
+    EXPECT_TRUE(show.add_change(0, 1));
+    EXPECT_TRUE(show.add_change(1, 1));
+    EXPECT_FALSE(show.add_change(1, 2));  // Changes full
+    EXPECT_TRUE(show.add_cue(6000, 0));
+    EXPECT_FALSE(show.add_cue(7000, 0));  // Cues full
+    EXPECT_FALSE(show.go(0));             // Not compiled
+    show.compile();
+    EXPECT_TRUE(show.go(0));
+    EXPECT_TRUE(show.go(0));  // Empty cue
+    EXPECT_FALSE(show.jump_to_position(3, 0, 0));
+}
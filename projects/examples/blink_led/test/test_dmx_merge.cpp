@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "blink_controller.h"
+#include "dmx_merge.h"
+#include "fade_controller.h"
+#include "mock_hardware.h"
+#include "output_bank.h"
+
+static uint8_t const DESK_A[16] = {0xA};
+static uint8_t const DESK_B[16] = {0xB};
+static uint8_t const DESK_C[16] = {0xC};
+
+// Parsed-packet view over a slot vector
+static dmx_packet make_packet(uint16_t universe, uint8_t priority, uint8_t sequence,
+                              std::vector<uint8_t> const& slots, uint8_t options = 0) {
+    dmx_packet packet;
+    packet.protocol = dmx_protocol::e131;
+    packet.universe = universe;
+    packet.sequence = sequence;
+    packet.priority = priority;
+    packet.options = options;
+    packet.cid = nullptr;
+    packet.slots = slots.data();
+    packet.slot_count = static_cast<uint16_t>(slots.size());
+    return packet;
+}
+
+// Test only subscribed universes are merged
+TEST(dmx_merger_test, ignores_unsubscribed_universes) {
+    dmx_merger<2> merger;
+    EXPECT_TRUE(merger.subscribe(1));
+    EXPECT_TRUE(merger.subscribe(1));  // Idempotent
+    EXPECT_TRUE(merger.subscribe(9));
+    EXPECT_FALSE(merger.subscribe(10));  // Full
+    EXPECT_FALSE(merger.subscribe(0));
+
+    std::vector<uint8_t> const slots(8, 50);
+    EXPECT_FALSE(merger.accept(make_packet(2, 100, 0, slots), DESK_A, 0));
+    EXPECT_EQ(merger.get_unsubscribed(), 1u);
+    EXPECT_EQ(merger.get_slots(2), nullptr);
+
+    EXPECT_TRUE(merger.accept(make_packet(9, 100, 0, slots), DESK_A, 0));
+    EXPECT_EQ(merger.get_slot_count(9), 8);
+    EXPECT_EQ(merger.get_slots(9)[7], 50);
+    EXPECT_EQ(merger.get_slot_count(1), 0);
+}
+
+// Test late and duplicate packets from a source are dropped
+TEST(dmx_merger_test, drops_out_of_sequence_packets) {
+    dmx_merger<1> merger;
+    merger.subscribe(1);
+    std::vector<uint8_t> const first(4, 10);
+    std::vector<uint8_t> const late(4, 99);
+    std::vector<uint8_t> const next(4, 20);
+
+    EXPECT_TRUE(merger.accept(make_packet(1, 100, 5, first), DESK_A, 0));
+    EXPECT_FALSE(merger.accept(make_packet(1, 100, 4, late), DESK_A, 1));
+    EXPECT_FALSE(merger.accept(make_packet(1, 100, 5, late), DESK_A, 2));
+    EXPECT_EQ(merger.get_slots(1)[0], 10);
+    EXPECT_TRUE(merger.accept(make_packet(1, 100, 6, next), DESK_A, 3));
+    EXPECT_EQ(merger.get_slots(1)[0], 20);
+    EXPECT_EQ(merger.get_sequence_drops(), 2u);
+
+    // A different source has its own sequence
+    EXPECT_TRUE(merger.accept(make_packet(1, 100, 0, first), DESK_B, 4));
+    EXPECT_EQ(merger.get_source_count(1), 2u);
+
+    // Art-Net sequence 0 disables the check
+    dmx_packet artnet = make_packet(1, 100, 0, next);
+    artnet.protocol = dmx_protocol::artnet;
+    dmx_merger<1> plain;
+    plain.subscribe(1);
+    EXPECT_TRUE(plain.accept(artnet, DESK_C, 0));
+    EXPECT_TRUE(plain.accept(artnet, DESK_C, 1));
+}
+
+// Test the highest priority wins and the backup takes over when it times out
+TEST(dmx_merger_test, highest_priority_wins_until_it_expires) {
+    dmx_merger<1> merger;
+    merger.subscribe(1);
+    std::vector<uint8_t> const main_desk(4, 200);
+    std::vector<uint8_t> const backup(4, 60);
+
+    merger.accept(make_packet(1, 150, 0, main_desk), DESK_A, 0);
+    merger.accept(make_packet(1, 100, 0, backup), DESK_B, 0);
+    EXPECT_EQ(merger.get_slots(1)[0], 200);
+
+    // Backup keeps sending; main goes silent
+    merger.accept(make_packet(1, 100, 1, backup), DESK_B, 2000);
+    EXPECT_EQ(merger.expire(2400), 0u);
+    EXPECT_EQ(merger.get_slots(1)[0], 200);
+    EXPECT_EQ(merger.expire(2600), 1u);
+    EXPECT_EQ(merger.get_slots(1)[0], 60);
+    EXPECT_EQ(merger.get_source_count(1), 1u);
+
+    // Everything silent: the universe goes dark
+    EXPECT_EQ(merger.expire(5000), 1u);
+    EXPECT_EQ(merger.get_slot_count(1), 0);
+    EXPECT_EQ(merger.get_slots(1)[0], 0);
+}
+
+// Test equal-priority sources merge highest-takes-precedence per slot
+TEST(dmx_merger_test, equal_priority_merges_htp) {
+    dmx_merger<1, 3> merger;
+    merger.subscribe(1);
+    std::vector<uint8_t> const a = {255, 0, 10};
+    std::vector<uint8_t> const b = {0, 128, 20, 7};
+    std::vector<uint8_t> const low = {1, 1, 1, 1, 255};
+
+    merger.accept(make_packet(1, 100, 0, a), DESK_A, 0);
+    merger.accept(make_packet(1, 100, 0, b), DESK_B, 0);
+    merger.accept(make_packet(1, 50, 0, low), DESK_C, 0);
+
+    uint8_t const* out = merger.get_slots(1);
+    EXPECT_EQ(merger.get_slot_count(1), 4);
+    EXPECT_EQ(out[0], 255);
+    EXPECT_EQ(out[1], 128);
+    EXPECT_EQ(out[2], 20);
+    EXPECT_EQ(out[3], 7);
+    EXPECT_EQ(out[4], 0);  // The lower-priority source is not merged
+}
+
+// Test stream termination, preview data and source overflow
+TEST(dmx_merger_test, handles_termination_preview_and_overflow) {
+    dmx_merger<1, 2> merger;
+    merger.subscribe(1);
+    std::vector<uint8_t> const high(2, 200);
+    std::vector<uint8_t> const low(2, 30);
+
+    merger.accept(make_packet(1, 120, 0, high), DESK_A, 0);
+    merger.accept(make_packet(1, 100, 0, low), DESK_B, 0);
+    EXPECT_FALSE(merger.accept(make_packet(1, 100, 0, low), DESK_C, 0));
+    EXPECT_EQ(merger.get_source_count(1), 2u);
+    EXPECT_EQ(merger.get_source_overflows(), 1u);
+
+    EXPECT_FALSE(merger.accept(make_packet(1, 200, 1, low, E131_OPTION_PREVIEW), DESK_A, 1));
+    EXPECT_EQ(merger.get_preview_drops(), 1u);
+    EXPECT_EQ(merger.get_slots(1)[0], 200);
+
+    // Terminating the main source hands over immediately, without the timeout
+    EXPECT_TRUE(merger.accept(make_packet(1, 120, 1, high, E131_OPTION_TERMINATED), DESK_A, 2));
+    EXPECT_EQ(merger.get_source_count(1), 1u);
+    EXPECT_EQ(merger.get_slots(1)[0], 30);
+}
+
+typedef dmx_patch<output_bank<8>, fade_controller<mock_level_pin>, blink_controller<mock_pin> >
+    test_patch;
+
+// Test patched slots drive bank channels, fades and blink rates
+TEST(dmx_patch_test, drives_outputs_from_slots) {
+    output_bank<8> bank;
+    mock_level_pin level;
+    fade_controller<mock_level_pin> fade(level, 0);
+    mock_pin blink_pin;
+    blink_controller<mock_pin> blink(blink_pin, 1000, 1000);
+
+    test_patch patch;
+    EXPECT_TRUE(patch.map_channel(1, 1, bank, 0));
+    EXPECT_TRUE(patch.map_channel(1, 2, bank, 5));
+    EXPECT_TRUE(patch.map_fade(1, 3, fade));
+    EXPECT_TRUE(patch.map_blink(2, 1, blink));
+    EXPECT_FALSE(patch.map_fade(1, 0, fade));  // Slots count from 1
+    EXPECT_FALSE(patch.map_fade(1, 513, fade));
+
+    uint8_t const slots[3] = {127, 128, 90};
+    EXPECT_EQ(patch.apply(1, slots, 3, 0), 3u);
+    EXPECT_FALSE(bank.get(0));
+    EXPECT_TRUE(bank.get(5));
+    EXPECT_EQ(fade.get_target(), 90);
+    fade.update(0);
+    EXPECT_EQ(level.get_level(), 90);
+
+    // Missing slots read as zero
+    EXPECT_EQ(patch.apply(1, slots, 1, 10), 3u);
+    EXPECT_FALSE(bank.get(5));
+    EXPECT_EQ(fade.get_target(), 0);
+
+    uint8_t const rate[1] = {255};
+    EXPECT_EQ(patch.apply(2, rate, 1, 0), 1u);
+    EXPECT_EQ(blink.get_next_on_duration(), 25u);
+    EXPECT_EQ(blink.get_next_off_duration(), 25u);
+    EXPECT_EQ(test_patch::blink_period(0), 2000u);
+    EXPECT_EQ(test_patch::blink_period(255), 50u);
+}
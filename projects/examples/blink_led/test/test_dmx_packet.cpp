@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "dmx_packet.h"
+
+static uint8_t const CID[16] = {0x10, 0x21, 0x32, 0x43, 0x54, 0x65, 0x76, 0x87,
+                                0x98, 0xA9, 0xBA, 0xCB, 0xDC, 0xED, 0xFE, 0x0F};
+
+static std::vector<uint8_t> e131_packet(uint16_t universe, uint8_t priority, uint8_t sequence,
+                                        std::vector<uint8_t> const& slots, uint8_t options = 0) {
+    std::vector<uint8_t> out(DMX_MAX_PACKET_SIZE);
+    std::size_t const length =
+        e131_build(out.data(), out.size(), CID, "test desk", universe, priority, sequence, options,
+                   slots.data(), static_cast<uint16_t>(slots.size()));
+    out.resize(length);
+    return out;
+}
+
+// Test an E1.31 packet round-trips through build and parse, in place
+TEST(dmx_packet_test, e131_round_trip) {
+    std::vector<uint8_t> slots(512);
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        slots[i] = static_cast<uint8_t>(i * 7);
+    }
+    std::vector<uint8_t> const wire = e131_packet(7, 150, 42, slots);
+    ASSERT_EQ(wire.size(), 638u);
+
+    dmx_packet packet;
+    ASSERT_TRUE(e131_parse(wire.data(), wire.size(), packet));
+    EXPECT_EQ(packet.protocol, dmx_protocol::e131);
+    EXPECT_EQ(packet.universe, 7);
+    EXPECT_EQ(packet.priority, 150);
+    EXPECT_EQ(packet.sequence, 42);
+    EXPECT_EQ(packet.options, 0);
+    EXPECT_EQ(packet.slot_count, 512);
+    EXPECT_EQ(packet.slots, wire.data() + E131_HEADER_SIZE);  // Points into the datagram
+    EXPECT_EQ(packet.cid, wire.data() + 22);
+    EXPECT_EQ(packet.slots[100], slots[100]);
+    EXPECT_EQ(std::vector<uint8_t>(packet.cid, packet.cid + 16),
+              std::vector<uint8_t>(CID, CID + 16));
+
+    // Short universes are legal too
+    std::vector<uint8_t> const short_wire = e131_packet(1, 100, 0, std::vector<uint8_t>(24, 9));
+    ASSERT_TRUE(dmx_parse(short_wire.data(), short_wire.size(), packet));
+    EXPECT_EQ(packet.slot_count, 24);
+}
+
+// Test malformed or unsupported E1.31 packets are rejected
+TEST(dmx_packet_test, e131_rejects_invalid_packets) {
+    std::vector<uint8_t> const good = e131_packet(1, 100, 0, std::vector<uint8_t>(16, 1));
+    dmx_packet packet;
+    ASSERT_TRUE(e131_parse(good.data(), good.size(), packet));
+
+    // Truncated: the PDU lengths no longer match
+    EXPECT_FALSE(e131_parse(good.data(), good.size() - 1, packet));
+    EXPECT_FALSE(e131_parse(good.data(), 100, packet));
+
+    std::vector<uint8_t> bad = good;
+    bad[4] = 'X';  // ACN packet identifier
+    EXPECT_FALSE(e131_parse(bad.data(), bad.size(), packet));
+
+    bad = good;
+    bad[43] = 0x08;  // Framing vector: universe discovery, not data
+    EXPECT_FALSE(e131_parse(bad.data(), bad.size(), packet));
+
+    bad = good;
+    bad[125] = 0xDD;  // Per-address priority start code
+    EXPECT_FALSE(e131_parse(bad.data(), bad.size(), packet));
+
+    bad = good;
+    bad[108] = 201;  // Priority above 200
+    EXPECT_FALSE(e131_parse(bad.data(), bad.size(), packet));
+
+    bad = good;
+    bad[113] = 0;
+    bad[114] = 0;  // Universe 0 is reserved
+    EXPECT_FALSE(e131_parse(bad.data(), bad.size(), packet));
+
+    bad = good;
+    bad[124] = 40;  // Property count disagrees with the length
+    EXPECT_FALSE(e131_parse(bad.data(), bad.size(), packet));
+}
+
+// Test the options byte reports preview and stream termination
+TEST(dmx_packet_test, e131_reports_options) {
+    std::vector<uint8_t> const wire =
+        e131_packet(3, 100, 9, std::vector<uint8_t>(4, 0), E131_OPTION_TERMINATED);
+    dmx_packet packet;
+    ASSERT_TRUE(e131_parse(wire.data(), wire.size(), packet));
+    EXPECT_EQ(packet.options & E131_OPTION_TERMINATED, E131_OPTION_TERMINATED);
+    EXPECT_EQ(packet.options & E131_OPTION_PREVIEW, 0);
+}
+
+// Test an ArtDmx packet round-trips, mapping port-address 0 to universe 1
+TEST(dmx_packet_test, artnet_round_trip) {
+    uint8_t const slots[5] = {1, 2, 3, 4, 5};
+    uint8_t wire[DMX_MAX_PACKET_SIZE];
+    std::size_t const length = artnet_build(wire, sizeof(wire), 1, 77, slots, 5);
+    ASSERT_EQ(length, 18u + 6u);  // Odd counts are padded to even
+    EXPECT_EQ(wire[14], 0);
+    EXPECT_EQ(wire[15], 0);
+
+    dmx_packet packet;
+    ASSERT_TRUE(artnet_parse(wire, length, packet));
+    EXPECT_EQ(packet.protocol, dmx_protocol::artnet);
+    EXPECT_EQ(packet.universe, 1);
+    EXPECT_EQ(packet.sequence, 77);
+    EXPECT_EQ(packet.priority, E131_DEFAULT_PRIORITY);
+    EXPECT_EQ(packet.cid, nullptr);
+    EXPECT_EQ(packet.slot_count, 6);
+    EXPECT_EQ(packet.slots[4], 5);
+    EXPECT_EQ(packet.slots[5], 0);
+
+    // Net 2, sub-net/universe 0x13 -> port-address 0x213 -> universe 0x214
+    ASSERT_GT(artnet_build(wire, sizeof(wire), 0x214, 0, slots, 2), 0u);
+    EXPECT_EQ(wire[14], 0x13);
+    EXPECT_EQ(wire[15], 0x02);
+    ASSERT_TRUE(dmx_parse(wire, 20, packet));
+    EXPECT_EQ(packet.universe, 0x214);
+}
+
+// Test other Art-Net opcodes and short datagrams are rejected
+TEST(dmx_packet_test, artnet_rejects_invalid_packets) {
+    uint8_t const slots[2] = {0, 0};
+    uint8_t wire[DMX_MAX_PACKET_SIZE];
+    std::size_t const length = artnet_build(wire, sizeof(wire), 1, 0, slots, 2);
+    dmx_packet packet;
+    ASSERT_TRUE(artnet_parse(wire, length, packet));
+
+    EXPECT_FALSE(artnet_parse(wire, length - 1, packet));
+    wire[9] = 0x20;  // OpPoll
+    EXPECT_FALSE(artnet_parse(wire, length, packet));
+    wire[9] = 0x50;
+    wire[2] = 'X';
+    EXPECT_FALSE(artnet_parse(wire, length, packet));
+    EXPECT_EQ(artnet_build(wire, sizeof(wire), 0, 0, slots, 2), 0u);  // No universe 0
+}
+
+// Test the E1.31 sequence window: late packets dropped, restarts accepted
+TEST(dmx_packet_test, sequence_rule_drops_late_packets) {
+    EXPECT_TRUE(dmx_sequence_accept(10, 11));
+    EXPECT_TRUE(dmx_sequence_accept(255, 0));  // Wraps
+    EXPECT_FALSE(dmx_sequence_accept(10, 10));  // Duplicate
+    EXPECT_FALSE(dmx_sequence_accept(10, 9));   // Reordered
+    EXPECT_FALSE(dmx_sequence_accept(10, 247));  // 19 behind, across the wrap
+    EXPECT_TRUE(dmx_sequence_accept(10, 246));   // 20 behind: a restarted source
+    EXPECT_TRUE(dmx_sequence_accept(200, 0));
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "blink_controller.h"
+#include "dmx_merge.h"
+#include "dmx_receiver.h"
+#include "fade_controller.h"
+#include "mock_hardware.h"
+#include "output_bank.h"
+#include "udp_socket.h"
+
+static uint8_t const CID[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+
+typedef dmx_patch<output_bank<8>, fade_controller<mock_level_pin>, blink_controller<mock_pin> >
+    show_patch;
+
+// What a show's handler typically does: merge, then patch the merged universe
+struct show_outputs {
+    dmx_merger<2> merger;
+    show_patch patch;
+    uint32_t now_ms = 0;
+    std::vector<uint8_t> last_source;
+
+    static void on_packet(void* context, dmx_packet const& packet, uint8_t const* source_id) {
+        show_outputs& show = *static_cast<show_outputs*>(context);
+        show.last_source.assign(source_id, source_id + dmx_packet::SOURCE_ID_SIZE);
+        if (show.merger.accept(packet, source_id, show.now_ms)) {
+            show.patch.apply(packet.universe, show.merger.get_slots(packet.universe),
+                             show.merger.get_slot_count(packet.universe), show.now_ms);
+        }
+    }
+};
+
+// Receive until count packets arrive or a second passes
+static std::size_t receive_packets(dmx_receiver& receiver, show_outputs& show, std::size_t count) {
+    std::size_t received = 0;
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    while (received < count && std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+        receiver.wait(10);
+        received += receiver.receive(&show_outputs::on_packet, &show);
+    }
+    return received;
+}
+
+class dmx_receiver_test : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        if (!receiver.open(0, 0)) {
+            GTEST_SKIP() << "no UDP sockets available";
+        }
+        show.merger.subscribe(1);
+        show.merger.subscribe(2);
+    }
+
+    // Local packet generator on 127.0.0.1
+    bool send(uint16_t port, uint8_t const* data, std::size_t length) {
+        sender.connect(INADDR_LOOPBACK, port);
+        return sender.send(data, length);
+    }
+
+    dmx_receiver receiver;
+    udp_sender sender;
+    show_outputs show;
+};
+
+// Test an E1.31 packet over loopback lands on patched bank channels and fades
+TEST_F(dmx_receiver_test, e131_over_loopback_drives_outputs) {
+    output_bank<8> bank;
+    mock_level_pin level;
+    fade_controller<mock_level_pin> fade(level, 100);
+    show.patch.map_channel(1, 1, bank, 3);
+    show.patch.map_fade(1, 2, fade);
+
+    uint8_t const slots[2] = {255, 180};
+    uint8_t wire[DMX_MAX_PACKET_SIZE];
+    std::size_t const length =
+        e131_build(wire, sizeof(wire), CID, "loopback", 1, 100, 0, 0, slots, 2);
+    ASSERT_TRUE(send(receiver.get_e131_port(), wire, length));
+
+    ASSERT_EQ(receive_packets(receiver, show, 1), 1u);
+    EXPECT_TRUE(bank.get(3));
+    EXPECT_EQ(fade.get_target(), 180);
+    fade.update(100);
+    EXPECT_EQ(level.get_level(), 180);
+    EXPECT_EQ(show.last_source, std::vector<uint8_t>(CID, CID + 16));
+    EXPECT_EQ(receiver.get_datagrams(), 1u);
+}
+
+// Test Art-Net packets are identified by sender and sequenced per source
+TEST_F(dmx_receiver_test, artnet_over_loopback_is_sequenced) {
+    output_bank<8> bank;
+    show.patch.map_channel(2, 4, bank, 0);
+
+    uint8_t slots[4] = {0, 0, 0, 255};
+    uint8_t wire[DMX_MAX_PACKET_SIZE];
+    std::size_t length = artnet_build(wire, sizeof(wire), 2, 10, slots, 4);
+    ASSERT_TRUE(send(receiver.get_artnet_port(), wire, length));
+    ASSERT_EQ(receive_packets(receiver, show, 1), 1u);
+    EXPECT_TRUE(bank.get(0));
+
+    // Sender id: 127.0.0.1 and the sender's port
+    ASSERT_EQ(show.last_source.size(), 16u);
+    EXPECT_EQ(show.last_source[0], 127);
+    EXPECT_EQ(show.last_source[3], 1);
+    EXPECT_EQ((show.last_source[4] << 8) | show.last_source[5], sender.get_local_port());
+
+    // A late packet from the same sender is dropped by the merger
+    slots[3] = 0;
+    length = artnet_build(wire, sizeof(wire), 2, 9, slots, 4);
+    ASSERT_TRUE(send(receiver.get_artnet_port(), wire, length));
+    ASSERT_EQ(receive_packets(receiver, show, 1), 1u);
+    EXPECT_TRUE(bank.get(0));
+    EXPECT_EQ(show.merger.get_sequence_drops(), 1u);
+}
+
+// Test garbage datagrams are counted and skipped
+TEST_F(dmx_receiver_test, invalid_datagrams_are_skipped) {
+    uint8_t const junk[40] = {'A', 'r', 't', '-', 'N', 'e', 't', 0, 0x00, 0x20};
+    ASSERT_TRUE(send(receiver.get_artnet_port(), junk, sizeof(junk)));
+    ASSERT_TRUE(send(receiver.get_e131_port(), junk, sizeof(junk)));
+    uint8_t const slots[2] = {1, 2};
+    uint8_t wire[DMX_MAX_PACKET_SIZE];
+    std::size_t const length = e131_build(wire, sizeof(wire), CID, "", 1, 100, 0, 0, slots, 2);
+    ASSERT_TRUE(send(receiver.get_e131_port(), wire, length));
+
+    EXPECT_EQ(receive_packets(receiver, show, 1), 1u);
+    EXPECT_EQ(receiver.get_datagrams(), 3u);
+    EXPECT_EQ(receiver.get_invalid(), 2u);
+}
+
+// Test a burst larger than one recvmmsg batch is drained completely
+TEST_F(dmx_receiver_test, burst_spans_several_batches) {
+    std::size_t const burst = 3 * dmx_receiver::BATCH_SIZE + 5;
+    std::vector<uint8_t> slots(512, 0);
+    uint8_t wire[DMX_MAX_PACKET_SIZE];
+    for (std::size_t i = 0; i < burst; ++i) {
+        slots[0] = static_cast<uint8_t>(i);
+        std::size_t const length = e131_build(wire, sizeof(wire), CID, "burst", 1, 100,
+                                              static_cast<uint8_t>(i), 0, slots.data(), 512);
+        ASSERT_TRUE(send(receiver.get_e131_port(), wire, length));
+    }
+
+    EXPECT_EQ(receive_packets(receiver, show, burst), burst);
+    EXPECT_EQ(show.merger.get_accepted(), burst);
+    EXPECT_EQ(show.merger.get_slots(1)[0], static_cast<uint8_t>(burst - 1));
+}
+
+// Test universes map onto the standard sACN multicast groups
+TEST(dmx_receiver_address_test, multicast_group_per_universe) {
+    EXPECT_EQ(dmx_receiver::e131_multicast_address(1), 0xEFFF0001u);      // 239.255.0.1
+    EXPECT_EQ(dmx_receiver::e131_multicast_address(0x1234), 0xEFFF1234u);  // 239.255.18.52
+}
@@ -0,0 +1,329 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "blink_controller.h"
+#include "console_simulator.h"
+#include "event_reactor.h"
+#include "mock_hardware.h"
+
+// Handler context that drains a descriptor and counts what it saw
+struct read_counter {
+    int fd;
+    uint32_t calls;
+    uint32_t bytes;
+    uint32_t last_events;
+    char last_byte;
+
+    static void on_event(void* context, uint32_t events) {
+        read_counter* const self = static_cast<read_counter*>(context);
+        char buffer[64];
+        ssize_t const n = ::read(self->fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            self->bytes += static_cast<uint32_t>(n);
+            self->last_byte = buffer[n - 1];
+        }
+        self->last_events = events;
+        ++self->calls;
+    }
+
+    event_handler handler() {
+        event_handler h;
+        h.callback = &read_counter::on_event;
+        h.context = this;
+        return h;
+    }
+};
+
+struct tick_counter {
+    uint32_t ticks;
+
+    static void on_tick(void* context, uint32_t) { ++static_cast<tick_counter*>(context)->ticks; }
+
+    event_handler handler() {
+        event_handler h;
+        h.callback = &tick_counter::on_tick;
+        h.context = this;
+        return h;
+    }
+};
+
+struct event_reactor_test : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        ASSERT_TRUE(reactor.open());
+        ASSERT_EQ(::pipe(fds), 0);
+    }
+    void TearDown() override {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    event_reactor reactor;
+    int fds[2];
+};
+
+// Test open/close lifecycle
+TEST_F(event_reactor_test, open_and_close) {
+    EXPECT_TRUE(reactor.is_open());
+    reactor.close();
+    EXPECT_FALSE(reactor.is_open());
+    EXPECT_TRUE(reactor.open());
+}
+
+// Test readable descriptor dispatches its handler
+TEST_F(event_reactor_test, dispatches_readable_fd) {
+    read_counter counter = {fds[0], 0, 0, 0, 0};
+    ASSERT_TRUE(reactor.watch(fds[0], EPOLLIN, counter.handler()));
+    EXPECT_EQ(reactor.get_source_count(), 1);
+
+    // Nothing pending: times out
+    EXPECT_EQ(reactor.run_once(0), 0);
+
+    ASSERT_EQ(::write(fds[1], "abc", 3), 3);
+    EXPECT_EQ(reactor.run_once(1000), 1);
+    EXPECT_EQ(counter.calls, 1);
+    EXPECT_EQ(counter.bytes, 3);
+    EXPECT_TRUE((counter.last_events & EPOLLIN) != 0);
+}
+
+// Test duplicate registration and unwatch
+TEST_F(event_reactor_test, watch_rejects_duplicates_and_unwatch_removes) {
+    read_counter counter = {fds[0], 0, 0, 0, 0};
+    ASSERT_TRUE(reactor.watch(fds[0], EPOLLIN, counter.handler()));
+    EXPECT_FALSE(reactor.watch(fds[0], EPOLLIN, counter.handler()));
+
+    EXPECT_TRUE(reactor.unwatch(fds[0]));
+    EXPECT_FALSE(reactor.unwatch(fds[0]));
+    EXPECT_EQ(reactor.get_source_count(), 0);
+
+    ASSERT_EQ(::write(fds[1], "x", 1), 1);
+    EXPECT_EQ(reactor.run_once(10), 0);
+    EXPECT_EQ(counter.calls, 0);
+}
+
+// Test invalid descriptors are refused
+TEST_F(event_reactor_test, watch_invalid_fd_fails) {
+    read_counter counter = {-1, 0, 0, 0, 0};
+    EXPECT_FALSE(reactor.watch(12345, EPOLLIN, counter.handler()));
+    EXPECT_EQ(reactor.get_source_count(), 0);
+}
+
+// Test the source table is bounded
+TEST_F(event_reactor_test, watch_fails_when_table_full) {
+    int pipes[event_reactor::MAX_SOURCES + 1][2];
+    read_counter counter = {-1, 0, 0, 0, 0};
+    std::size_t const limit = event_reactor::MAX_SOURCES;
+    for (std::size_t i = 0; i <= limit; ++i) {
+        ASSERT_EQ(::pipe(pipes[i]), 0);
+        bool const added = reactor.watch(pipes[i][0], EPOLLIN, counter.handler());
+        EXPECT_EQ(added, i < limit);
+    }
+    for (std::size_t i = 0; i <= limit; ++i) {
+        ::close(pipes[i][0]);
+        ::close(pipes[i][1]);
+    }
+}
+
+// Test one-shot tick timer
+TEST_F(event_reactor_test, tick_timer_fires_once) {
+    tick_counter ticks = {0};
+    reactor.set_tick_handler(ticks.handler());
+
+    ASSERT_TRUE(reactor.arm_tick(5));
+    EXPECT_EQ(reactor.run_once(1000), 1);
+    EXPECT_EQ(ticks.ticks, 1);
+
+    // One-shot: nothing more without re-arming
+    EXPECT_EQ(reactor.run_once(20), 0);
+}
+
+// Test disarm cancels a pending tick
+TEST_F(event_reactor_test, disarm_cancels_tick) {
+    tick_counter ticks = {0};
+    reactor.set_tick_handler(ticks.handler());
+
+    ASSERT_TRUE(reactor.arm_tick(5));
+    ASSERT_TRUE(reactor.disarm_tick());
+    EXPECT_EQ(reactor.run_once(30), 0);
+    EXPECT_EQ(ticks.ticks, 0);
+}
+
+// Test zero delay still fires (timerfd treats zero as disarm)
+TEST_F(event_reactor_test, zero_delay_fires_immediately) {
+    tick_counter ticks = {0};
+    reactor.set_tick_handler(ticks.handler());
+
+    ASSERT_TRUE(reactor.arm_tick(0));
+    EXPECT_EQ(reactor.run_once(1000), 1);
+}
+
+// Test pseudo-terminal (serial stand-in) input is dispatched
+TEST_F(event_reactor_test, dispatches_pty_input) {
+    int const master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master, 0);
+    ASSERT_EQ(::grantpt(master), 0);
+    ASSERT_EQ(::unlockpt(master), 0);
+    int const slave = ::open(::ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave, 0);
+
+    read_counter counter = {master, 0, 0, 0, 0};
+    ASSERT_TRUE(reactor.watch(master, EPOLLIN, counter.handler()));
+    ASSERT_EQ(::write(slave, "S", 1), 1);
+    EXPECT_EQ(reactor.run_once(1000), 1);
+    EXPECT_EQ(counter.last_byte, 'S');
+
+    ::close(slave);
+    ::close(master);
+}
+
+// Test stop() ends run() from inside a handler
+TEST_F(event_reactor_test, stop_from_handler_ends_run) {
+    struct stopper {
+        static void on_event(void* context, uint32_t) { static_cast<event_reactor*>(context)->stop(); }
+    };
+    event_handler handler;
+    handler.callback = &stopper::on_event;
+    handler.context = &reactor;
+    reactor.set_tick_handler(handler);
+
+    reactor.arm_tick(1);
+    reactor.run();
+    SUCCEED();
+}
+
+// Test ticker sleeps until the earliest controller deadline
+TEST_F(event_reactor_test, controller_ticker_sleeps_until_next_edge) {
+    mock_timer timer;
+    mock_pin pins[2];
+    blink_controller<mock_pin> controllers[2] = {
+        blink_controller<mock_pin>(pins[0], 1000, 500),
+        blink_controller<mock_pin>(pins[1], 1000, 300),
+    };
+    controller_ticker<blink_controller<mock_pin>, mock_timer> ticker(reactor, controllers, 2,
+                                                                     timer, 2000);
+
+    ticker.start();
+    EXPECT_EQ(reactor.run_once(1000), 1);
+    EXPECT_EQ(ticker.get_tick_count(), 1);
+    EXPECT_EQ(ticker.get_next_sleep_ms(), 300);
+
+    // Second controller's edge; first now has 200ms left
+    timer.set_time(300);
+    ticker.reschedule();
+    EXPECT_TRUE(pins[1].get_state());
+    EXPECT_EQ(ticker.get_next_sleep_ms(), 200);
+}
+
+// Test a show_clock timer turns show-time deadlines into wall-time sleeps
+TEST_F(event_reactor_test, controller_ticker_sleeps_in_wall_time_with_show_clock) {
+    mock_timer timer;
+    show_clock<mock_timer> clock(timer);
+    clock.set_rate(show_rate(4, 1));
+    mock_pin pin;
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+    controller_ticker<blink_controller<mock_pin>, show_clock<mock_timer> > ticker(
+        reactor, &controller, 1, clock, 2000);
+
+    ticker.start();
+    EXPECT_EQ(reactor.run_once(1000), 1);
+    EXPECT_EQ(ticker.get_next_sleep_ms(), 125);  // 500 show ms at 4x
+
+    clock.set_rate(show_rate(1, 4));
+    ticker.reschedule();
+    EXPECT_EQ(ticker.get_next_sleep_ms(), 2000);  // 2000 wall ms, capped
+}
+
+// Test late wakes at a fast show rate keep every edge at its exact show time
+TEST_F(event_reactor_test, controller_ticker_keeps_edges_on_late_wakes) {
+    mock_timer timer;
+    show_clock<mock_timer> clock(timer);
+    clock.set_rate(show_rate(1000, 1));
+    mock_pin pin;
+    blink_controller<mock_pin> controller(pin, 7, 5);
+    controller_ticker<blink_controller<mock_pin>, show_clock<mock_timer> > ticker(
+        reactor, &controller, 1, clock, 2000);
+
+    mock_pin reference_pin;
+    blink_controller<mock_pin> reference(reference_pin, 7, 5);
+    ticker.start();
+    reactor.run_once(1000);
+    uint32_t show_ms = 0;
+    for (int wake = 0; wake < 50; ++wake) {
+        timer.advance(3);  // Each wake is 3000 show ms, hundreds of edges
+        ticker.reschedule();
+        for (uint32_t t = clock.millis(); show_ms <= t; ++show_ms) {
+            reference.update(show_ms);
+        }
+        ASSERT_EQ(controller.is_on(), reference.is_on()) << wake;
+        ASSERT_EQ(controller.get_last_toggle_time(), reference.get_last_toggle_time()) << wake;
+    }
+    EXPECT_EQ(clock.millis(), 150000u);
+}
+
+// Test a socket command retimes a controller on the reactor thread
+TEST_F(event_reactor_test, socket_command_retimes_controller) {
+    int sockets[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets), 0);
+
+    mock_timer timer;
+    mock_pin pin;
+    blink_controller<mock_pin> controller(pin, 1000, 500);
+    controller_ticker<blink_controller<mock_pin>, mock_timer> ticker(reactor, &controller, 1,
+                                                                     timer, 5000);
+
+    // Each received byte advances the pending edge by that many milliseconds
+    struct retime_context {
+        int fd;
+        blink_controller<mock_pin>* controller;
+        controller_ticker<blink_controller<mock_pin>, mock_timer>* ticker;
+
+        static void on_event(void* context, uint32_t) {
+            retime_context* const self = static_cast<retime_context*>(context);
+            char byte;
+            while (::read(self->fd, &byte, 1) == 1) {
+                self->controller->shift_phase(-static_cast<int32_t>(byte));
+            }
+            self->ticker->reschedule();
+        }
+    };
+    retime_context context = {sockets[0], &controller, &ticker};
+    event_handler handler;
+    handler.callback = &retime_context::on_event;
+    handler.context = &context;
+    ASSERT_TRUE(reactor.watch(sockets[0], EPOLLIN, handler));
+
+    ticker.start();
+    reactor.run_once(1000);
+    EXPECT_EQ(ticker.get_next_sleep_ms(), 500);
+
+    char const advance = 100;
+    ASSERT_EQ(::write(sockets[1], &advance, 1), 1);
+    EXPECT_EQ(reactor.run_once(1000), 1);
+    EXPECT_EQ(ticker.get_next_sleep_ms(), 400);
+
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+}
+
+// Test event-driven ticking wakes per edge rather than polling
+TEST_F(event_reactor_test, real_timer_wakes_only_near_edges) {
+    real_time_timer timer;
+    mock_pin pin;
+    blink_controller<mock_pin> controller(pin, 20, 20);
+    controller_ticker<blink_controller<mock_pin>, real_time_timer> ticker(reactor, &controller,
+                                                                          1, timer, 1000);
+
+    ticker.start();
+    while (timer.millis() < 205) {
+        reactor.run_once(100);
+    }
+
+    // ~10 edges in 200ms; allow a few extra wakeups for ms rounding
+    EXPECT_GE(ticker.get_tick_count(), 10);
+    EXPECT_LE(ticker.get_tick_count(), 25);
+}
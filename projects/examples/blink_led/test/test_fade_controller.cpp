@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "fade_controller.h"
+#include "mock_hardware.h"
+#include "output_bank.h"
+
+class fade_controller_test : public ::testing::Test {
+   protected:
+    mock_level_pin pin;
+    mock_timer timer;
+};
+
+// Test initial state: level 0, nothing written
+TEST_F(fade_controller_test, initial_state_is_dark) {
+    fade_controller<mock_level_pin> fade(pin, 100);
+
+    EXPECT_EQ(fade.get_level(), 0);
+    EXPECT_FALSE(fade.is_fading());
+    fade.update(timer.millis());
+    EXPECT_EQ(pin.get_write_count(), 0u);
+}
+
+// Test a linear fade up reaches the target at the fade duration
+TEST_F(fade_controller_test, fades_linearly_to_target) {
+    fade_controller<mock_level_pin> fade(pin, 100);
+
+    fade.set_target(200, timer.millis());
+    EXPECT_TRUE(fade.is_fading());
+
+    timer.advance(25);
+    fade.update(timer.millis());
+    EXPECT_EQ(pin.get_level(), 50);
+
+    timer.advance(25);
+    fade.update(timer.millis());
+    EXPECT_EQ(pin.get_level(), 100);
+
+    timer.advance(50);
+    fade.update(timer.millis());
+    EXPECT_EQ(pin.get_level(), 200);
+    EXPECT_FALSE(fade.is_fading());
+}
+
+// Test a fade down
+TEST_F(fade_controller_test, fades_down) {
+    fade_controller<mock_level_pin> fade(pin, 0);
+    fade.set_target(255, 0);
+    fade.update(0);
+    EXPECT_EQ(pin.get_level(), 255);
+
+    fade.set_fade_duration(1000);
+    fade.set_target(55, 0);
+    fade.update(500);
+    EXPECT_EQ(pin.get_level(), 155);
+    fade.update(1000);
+    EXPECT_EQ(pin.get_level(), 55);
+}
+
+// Test retargeting mid-fade starts from the current level
+TEST_F(fade_controller_test, retarget_mid_fade_is_continuous) {
+    fade_controller<mock_level_pin> fade(pin, 100);
+    fade.set_target(200, 0);
+    fade.update(50);
+    EXPECT_EQ(pin.get_level(), 100);
+
+    fade.set_target(0, 60);  // Currently at 120
+    fade.update(60);
+    EXPECT_EQ(pin.get_level(), 120);
+    fade.update(110);
+    EXPECT_EQ(pin.get_level(), 60);
+    fade.update(160);
+    EXPECT_EQ(pin.get_level(), 0);
+}
+
+// Test the output is only written when the level changes
+TEST_F(fade_controller_test, writes_only_on_change) {
+    fade_controller<mock_level_pin> fade(pin, 1000);
+    fade.set_target(10, 0);
+    for (uint32_t t = 0; t <= 1000; ++t) {
+        fade.update(t);
+    }
+    EXPECT_EQ(pin.get_level(), 10);
+    EXPECT_EQ(pin.get_write_count(), 10u);
+
+    // Same target again: no restart
+    fade.set_target(10, 2000);
+    fade.update(2000);
+    EXPECT_EQ(pin.get_write_count(), 10u);
+}
+
+// Test jump_to cancels a fade
+TEST_F(fade_controller_test, jump_cancels_fade) {
+    fade_controller<mock_level_pin> fade(pin, 1000);
+    fade.set_target(255, 0);
+    fade.jump_to(30);
+    EXPECT_EQ(pin.get_level(), 30);
+    EXPECT_FALSE(fade.is_fading());
+    fade.update(500);
+    EXPECT_EQ(pin.get_level(), 30);
+}
+
+// Test fades across the millis() wraparound and duration clamping
+TEST_F(fade_controller_test, wraparound_and_long_fades) {
+    fade_controller<mock_level_pin> fade(pin, 100);
+    fade.set_target(100, UINT32_MAX - 49);
+    fade.update(UINT32_MAX);
+    EXPECT_EQ(pin.get_level(), 49);
+    fade.update(50);
+    EXPECT_EQ(pin.get_level(), 100);
+
+    fade.set_fade_duration(UINT32_MAX);
+    uint32_t const max_fade = fade_controller<mock_level_pin>::MAX_FADE_MS;
+    EXPECT_EQ(fade.get_fade_duration(), max_fade);
+    fade.set_target(255, 0);
+    fade.update(max_fade / 2);
+    EXPECT_EQ(pin.get_level(), 177);
+}
+
+// Test a fade driving a level_bank channel
+TEST(fade_controller_bank_test, drives_level_bank) {
+    level_bank<8> levels;
+    level_pin pin = levels.channel(5);
+    fade_controller<level_pin> fade(pin, 10);
+    fade.set_target(80, 0);
+    fade.update(10);
+    EXPECT_EQ(levels.get(5), 80);
+}
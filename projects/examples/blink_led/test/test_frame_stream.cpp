@@ -0,0 +1,340 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "frame_stream.h"
+#include "output_bank.h"
+#include "serial_protocol.h"
+
+static std::size_t const CHANNELS = 1024;
+typedef frame_stream_encoder<CHANNELS> encoder_t;
+
+// Byte queues standing in for both directions of a UART
+struct loopback_serial {
+    int available() const { return static_cast<int>(rx.size()); }
+    int read() {
+        if (rx.empty()) {
+            return -1;
+        }
+        uint8_t const byte = rx.front();
+        rx.pop_front();
+        return byte;
+    }
+    std::size_t write(uint8_t const* data, std::size_t length) {
+        tx.insert(tx.end(), data, data + length);
+        return length;
+    }
+
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+};
+
+static bool banks_equal(output_bank<CHANNELS> const& a, output_bank<CHANNELS> const& b) {
+    for (std::size_t i = 0; i < output_bank<CHANNELS>::WORD_COUNT; ++i) {
+        if (a.words()[i] != b.words()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t next_random(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief Host encoder + board receiver with per-frame loss and delayed acks
+ */
+struct frame_stream_test : public ::testing::Test {
+   protected:
+    frame_stream_test() : encoder(50), receiver(board_bank, serial), wire_bytes(0) {}
+
+    // Send one frame; returns false if it was dropped on the way
+    bool send(bool drop = false) {
+        uint8_t wire[encoder_t::MAX_WIRE_SIZE];
+        std::size_t const length = encoder.encode(host_bank, wire, sizeof(wire));
+        EXPECT_GT(length, 0u);
+        wire_bytes += length;
+        last_length = length;
+        if (drop) {
+            return false;
+        }
+        serial.rx.insert(serial.rx.end(), wire, wire + length);
+        receiver.poll();
+        return true;
+    }
+
+    // Deliver the board's replies to the encoder
+    void deliver_acks() {
+        serial_frame reply;
+        for (std::size_t i = 0; i < serial.tx.size(); ++i) {
+            if (reply_parser.push(serial.tx[i], reply)) {
+                encoder.on_reply(reply);
+                statuses.push_back(static_cast<serial_status>(reply.payload[0]));
+            }
+        }
+        serial.tx.clear();
+    }
+
+    output_bank<CHANNELS> host_bank;
+    output_bank<CHANNELS> board_bank;
+    loopback_serial serial;
+    encoder_t encoder;
+    frame_stream_receiver<CHANNELS, loopback_serial> receiver;
+    serial_parser<> reply_parser;
+    std::vector<serial_status> statuses;
+    std::size_t wire_bytes;
+    std::size_t last_length;
+};
+
+// Test the first frame is a keyframe and later frames are small deltas
+TEST_F(frame_stream_test, keyframe_then_deltas) {
+    host_bank.set(3, true);
+    host_bank.set(700, true);
+    send();
+    deliver_acks();
+    EXPECT_EQ(encoder.get_keyframes(), 1u);
+    EXPECT_TRUE(banks_equal(host_bank, board_bank));
+
+    host_bank.set(512, true);
+    send();
+    deliver_acks();
+    EXPECT_EQ(encoder.get_deltas(), 1u);
+    EXPECT_TRUE(banks_equal(host_bank, board_bank));
+    EXPECT_EQ(encoder.get_last_encoding(), frame_encoding::rle);
+    EXPECT_LT(last_length, 20u);  // vs 128 bytes for the full bank
+    EXPECT_EQ(receiver.get_decoder().get_rejected(), 0u);
+}
+
+// Test random changes with each ack arriving after the next frame
+TEST_F(frame_stream_test, random_changes_with_ack_latency) {
+    uint32_t state = 12345;
+    for (int frame = 0; frame < 500; ++frame) {
+        for (int c = 0; c < 8; ++c) {
+            std::size_t const channel = next_random(state) % CHANNELS;
+            host_bank.set(channel, !host_bank.get(channel));
+        }
+        std::vector<uint8_t> const acks_before(serial.tx);
+        serial.tx.clear();
+        send();
+        // Hold back this frame's ack until the next frame has been sent
+        std::vector<uint8_t> const this_ack(serial.tx);
+        serial.tx = acks_before;
+        deliver_acks();
+        serial.tx = this_ack;
+        ASSERT_TRUE(banks_equal(host_bank, board_bank)) << "frame " << frame;
+    }
+    EXPECT_EQ(receiver.get_decoder().get_rejected(), 0u);
+    // Frames 0 and 1 go out before the first ack, then one every 50 frames
+    EXPECT_EQ(encoder.get_keyframes(), 11u);
+    EXPECT_LT(wire_bytes / 500, 48u);  // vs 136 bytes for full frames
+}
+
+// Test lost frames need no retransmission: the next delivered frame is complete
+TEST_F(frame_stream_test, lost_frames_recover_without_retransmission) {
+    send();
+    deliver_acks();
+
+    for (int frame = 0; frame < 20; ++frame) {
+        host_bank.set(static_cast<std::size_t>(frame) * 37 % CHANNELS, true);
+        bool const dropped = frame % 3 != 0;
+        send(dropped);
+        deliver_acks();
+        if (!dropped) {
+            EXPECT_TRUE(banks_equal(host_bank, board_bank)) << "frame " << frame;
+        }
+    }
+    EXPECT_EQ(receiver.get_decoder().get_rejected(), 0u);
+}
+
+// Test a board that lost its history nacks deltas and gets a keyframe
+TEST_F(frame_stream_test, board_reset_triggers_keyframe) {
+    send();
+    deliver_acks();
+    host_bank.set(1, true);
+    send();
+    deliver_acks();
+    EXPECT_EQ(encoder.get_keyframes(), 1u);
+
+    // Fresh receiver: no reference frames
+    output_bank<CHANNELS> fresh_bank;
+    frame_stream_receiver<CHANNELS, loopback_serial> fresh(fresh_bank, serial);
+    uint8_t wire[encoder_t::MAX_WIRE_SIZE];
+    host_bank.set(2, true);
+    std::size_t const length = encoder.encode(host_bank, wire, sizeof(wire));
+    for (std::size_t i = 0; i < length; ++i) {
+        fresh.feed(wire[i]);
+    }
+    deliver_acks();
+    ASSERT_FALSE(statuses.empty());
+    EXPECT_EQ(statuses.back(), serial_status::unknown_reference);
+
+    std::size_t const again = encoder.encode(host_bank, wire, sizeof(wire));
+    for (std::size_t i = 0; i < again; ++i) {
+        fresh.feed(wire[i]);
+    }
+    EXPECT_EQ(encoder.get_keyframes(), 2u);
+    EXPECT_TRUE(banks_equal(host_bank, fresh_bank));
+}
+
+// Test without acks the encoder keeps sending keyframes
+TEST_F(frame_stream_test, no_acks_means_keyframes) {
+    for (int i = 0; i < 5; ++i) {
+        send();
+        serial.tx.clear();
+    }
+    EXPECT_EQ(encoder.get_keyframes(), 5u);
+    EXPECT_EQ(encoder.get_deltas(), 0u);
+    EXPECT_TRUE(banks_equal(host_bank, board_bank));
+}
+
+// Test 256+ frames without acks cannot wrap the 8-bit seq back onto an old reference
+TEST_F(frame_stream_test, unacked_run_does_not_wrap_onto_old_reference) {
+    encoder = encoder_t(0);  // Keyframes only when needed
+    uint32_t state = 77;
+    host_bank.set(5, true);
+    send();
+    deliver_acks();  // Frame 0 acked, then the ack path goes quiet
+    for (uint32_t frame = 1; frame <= 257; ++frame) {
+        for (int k = 0; k < 8; ++k) {
+            host_bank.set(next_random(state) % CHANNELS, (state & 0x100) != 0);
+        }
+        if (send(frame == 256)) {  // The board misses frame 256, the new seq 0
+            ASSERT_TRUE(banks_equal(host_bank, board_bank)) << frame;
+        }
+        serial.tx.clear();
+    }
+    EXPECT_EQ(encoder.get_deltas(), 3u);  // Frames 1-3, while frame 0 is in the history
+    EXPECT_TRUE(banks_equal(host_bank, board_bank));
+}
+
+// Test the smallest encoding wins for sparse, dense and random content
+TEST(frame_stream_encoding, picks_smallest_encoding) {
+    output_bank<CHANNELS> bank;
+    frame_stream_detail::byte_source const source = {bank.words(), nullptr};
+    uint8_t out[2 + CHANNELS / 8];
+    frame_encoding chosen;
+
+    // Scattered single channels: bitmap
+    for (std::size_t i = 0; i < CHANNELS; i += 80) {
+        bank.set(i, true);
+    }
+    std::size_t length = frame_stream_detail::encode_bytes(source, CHANNELS / 8, out, sizeof(out),
+                                                           chosen);
+    EXPECT_EQ(chosen, frame_encoding::bitmap);
+    EXPECT_EQ(length, 1 + 16 + 13u);
+
+    // A whole section switching together: rle
+    bank.clear();
+    for (std::size_t i = 256; i < 768; ++i) {
+        bank.set(i, true);
+    }
+    length = frame_stream_detail::encode_bytes(source, CHANNELS / 8, out, sizeof(out), chosen);
+    EXPECT_EQ(chosen, frame_encoding::rle);
+    EXPECT_EQ(length, 1 + 6u);
+
+    // Noise: raw
+    uint32_t state = 99;
+    for (std::size_t i = 0; i < CHANNELS; ++i) {
+        bank.set(i, (next_random(state) & 1) != 0);
+    }
+    length = frame_stream_detail::encode_bytes(source, CHANNELS / 8, out, sizeof(out), chosen);
+    EXPECT_EQ(chosen, frame_encoding::raw);
+    EXPECT_EQ(length, 1 + CHANNELS / 8);
+}
+
+// Test every encoding decodes back to the source bytes
+TEST(frame_stream_encoding, encodings_round_trip) {
+    uint32_t state = 7;
+    for (int trial = 0; trial < 200; ++trial) {
+        output_bank<CHANNELS> bank;
+        uint32_t const density = next_random(state) % 64;
+        for (std::size_t i = 0; i < CHANNELS; ++i) {
+            if (next_random(state) % 64 < density) {
+                bank.set(i, true);
+            }
+        }
+        // Occasional long runs
+        if (trial % 3 == 0) {
+            std::size_t const start = next_random(state) % CHANNELS;
+            for (std::size_t i = start; i < CHANNELS && i < start + 400; ++i) {
+                bank.set(i, true);
+            }
+        }
+
+        frame_stream_detail::byte_source const source = {bank.words(), nullptr};
+        uint8_t out[2 + CHANNELS / 8];
+        frame_encoding chosen;
+        std::size_t const length =
+            frame_stream_detail::encode_bytes(source, CHANNELS / 8, out, sizeof(out), chosen);
+        ASSERT_GT(length, 0u);
+
+        uint32_t words[output_bank<CHANNELS>::WORD_COUNT] = {};
+        frame_stream_detail::xor_into_words apply = {words};
+        ASSERT_TRUE(frame_stream_detail::decode_bytes(out[0], out + 1, length - 1, CHANNELS / 8,
+                                                      apply));
+        for (std::size_t i = 0; i < output_bank<CHANNELS>::WORD_COUNT; ++i) {
+            ASSERT_EQ(words[i], bank.words()[i]) << "trial " << trial;
+        }
+    }
+}
+
+// Build a frame body by hand (for malformed payloads)
+static std::vector<uint8_t> raw_frame(serial_message type, uint8_t seq,
+                                      std::vector<uint8_t> const& payload) {
+    serial_frame_builder<64> builder;
+    builder.begin(type, seq, 0);
+    builder.put_bytes(payload.data(), payload.size());
+    uint8_t wire[serial_frame_builder<64>::MAX_WIRE_SIZE];
+    std::size_t const length = builder.finish(wire, sizeof(wire));
+    return std::vector<uint8_t>(wire, wire + length);
+}
+
+// Test malformed payloads are rejected and leave the bank untouched
+TEST(frame_stream_decoder_test, malformed_payload_leaves_bank_untouched) {
+    output_bank<24> bank;
+    loopback_serial serial;
+    frame_stream_receiver<24, loopback_serial> receiver(bank, serial);
+
+    std::vector<uint8_t> key;
+    key.push_back(0);  // raw
+    key.push_back(0xA5);
+    key.push_back(0x5A);
+    key.push_back(0x01);
+    std::vector<uint8_t> wire = raw_frame(serial_message::keyframe, 0, key);
+    serial.rx.insert(serial.rx.end(), wire.begin(), wire.end());
+    receiver.poll();
+    EXPECT_EQ(bank.words()[0], 0x015AA5u);
+
+    std::vector<uint8_t> cases[3];
+    cases[0].push_back(0);  // raw, one byte short
+    cases[0].push_back(0xFF);
+    cases[1].push_back(2);  // rle run past the end
+    cases[1].push_back(0x85);
+    cases[1].push_back(0xFF);
+    cases[2].push_back(9);  // unknown encoding
+    for (int i = 0; i < 3; ++i) {
+        wire = raw_frame(serial_message::keyframe, static_cast<uint8_t>(1 + i), cases[i]);
+        serial.rx.insert(serial.rx.end(), wire.begin(), wire.end());
+        receiver.poll();
+        EXPECT_EQ(bank.words()[0], 0x015AA5u) << "case " << i;
+    }
+    EXPECT_EQ(receiver.get_decoder().get_rejected(), 3u);
+    EXPECT_EQ(receiver.get_decoder().get_applied(), 1u);
+}
+
+// Test bits past the last channel are masked off
+TEST(frame_stream_decoder_test, padding_bits_are_masked) {
+    output_bank<20> bank;
+    frame_stream_decoder<20> decoder;
+    uint8_t const payload[] = {0, 0xFF, 0xFF, 0xFF};
+    serial_frame frame = {serial_message::keyframe, 0, 0, payload, sizeof(payload)};
+    EXPECT_EQ(decoder.apply(frame, bank), serial_status::ok);
+    EXPECT_EQ(bank.words()[0], 0xFFFFFu);
+    EXPECT_EQ(bank.count_on(), 20u);
+}
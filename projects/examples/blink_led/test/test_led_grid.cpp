@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "led_grid.h"
+#include "led_layout.h"
+
+static float random_between(float low, float high) {
+    return low + (high - low) * static_cast<float>(std::rand()) / RAND_MAX;
+}
+
+static led_layout random_layout(std::size_t count) {
+    led_layout layout;
+    for (std::size_t i = 0; i < count; ++i) {
+        layout.add({random_between(-2, 8), random_between(0, 5), random_between(0, 1.5f)});
+    }
+    return layout;
+}
+
+// Test radius and box queries find exactly the LEDs a full scan finds
+TEST(led_grid_test, queries_match_full_scan) {
+    std::srand(23);
+    led_layout const layout = random_layout(3000);
+    float const cell_sizes[] = {0.2f, 0.5f, 3.0f, 50.0f};
+    for (std::size_t s = 0; s < sizeof(cell_sizes) / sizeof(cell_sizes[0]); ++s) {
+        led_grid const grid(layout, cell_sizes[s]);
+        EXPECT_EQ(grid.size(), layout.size());
+        for (int q = 0; q < 300; ++q) {
+            led_position const center = {random_between(-4, 10), random_between(-2, 7),
+                                         random_between(-1, 2.5f)};
+            float const radius = q % 10 == 0 ? 0.0f : random_between(0.05f, 4);
+            std::vector<uint32_t> found;
+            grid.for_each_in_radius(center, radius, [&](uint32_t led, float distance_squared) {
+                led_position const p = layout.get(led);
+                float const dx = p.x - center.x;
+                float const dy = p.y - center.y;
+                float const dz = p.z - center.z;
+                EXPECT_FLOAT_EQ(distance_squared, dx * dx + dy * dy + dz * dz);
+                found.push_back(led);
+            });
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < layout.size(); ++i) {
+                led_position const p = layout.get(i);
+                float const dx = p.x - center.x;
+                float const dy = p.y - center.y;
+                float const dz = p.z - center.z;
+                if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                    expected.push_back(i);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            ASSERT_EQ(found, expected) << s << " " << q;
+
+            led_position const low = {center.x - radius, center.y - 0.5f * radius, center.z};
+            led_position const high = {center.x + radius, center.y + radius, center.z + radius};
+            found.clear();
+            grid.for_each_in_box(low, high, [&](uint32_t led) { found.push_back(led); });
+            expected.clear();
+            for (uint32_t i = 0; i < layout.size(); ++i) {
+                led_position const p = layout.get(i);
+                if (p.x >= low.x && p.x <= high.x && p.y >= low.y && p.y <= high.y &&
+                    p.z >= low.z && p.z <= high.z) {
+                    expected.push_back(i);
+                }
+            }
+            std::sort(found.begin(), found.end());
+            ASSERT_EQ(found, expected) << s << " " << q;
+        }
+    }
+}
+
+// Test small cells grow to bound memory, and degenerate layouts still work
+TEST(led_grid_test, bounds_cells_and_handles_degenerate_layouts) {
+    std::srand(29);
+    led_layout const layout = random_layout(100);
+    led_grid const fine(layout, 0.001f);
+    EXPECT_LE(fine.get_cell_count(), 100 * led_grid::MAX_CELLS_PER_LED);
+    EXPECT_GT(fine.get_cell_size(), 0.001f);
+
+    led_layout empty;
+    led_grid const nothing(empty, 1.0f);
+    std::vector<uint32_t> found;
+    nothing.query_radius({0, 0, 0}, 100, found);
+    EXPECT_TRUE(found.empty());
+
+    led_layout same;
+    for (int i = 0; i < 10; ++i) {
+        same.add({1, 2, 3});  // Every LED in one spot
+    }
+    led_grid const point(same, 0.5f);
+    point.query_radius({1, 2, 3}, 0, found);
+    EXPECT_EQ(found.size(), 10u);
+    found.clear();
+    point.query_radius({1.5f, 2, 3}, 0.4f, found);
+    EXPECT_TRUE(found.empty());
+}
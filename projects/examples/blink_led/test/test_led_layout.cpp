@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "led_layout.h"
+#include "pixel_shader.h"
+#include "shader_expression.h"
+
+static bool load(led_layout& layout, char const* text, led_layout_error& error) {
+    return layout.load(text, std::strlen(text), error);
+}
+
+// Test positions load from whitespace or CSV lines, flat or 3D, with comments
+TEST(led_layout_test, loads_positions) {
+    led_layout layout;
+    led_layout_error error;
+    ASSERT_TRUE(load(layout,
+                     "# porch rail\n"
+                     "0 0 1.5\n"
+                     "\n"
+                     "0.25, -1.75, 2  # corner\r\n"
+                     "3\t4\n",
+                     error))
+        << error.message;
+    ASSERT_EQ(layout.size(), 3u);
+    EXPECT_FLOAT_EQ(layout.z()[0], 1.5f);
+    EXPECT_FLOAT_EQ(layout.x()[1], 0.25f);
+    EXPECT_FLOAT_EQ(layout.y()[1], -1.75f);
+    EXPECT_FLOAT_EQ(layout.get(2).y, 4.0f);
+    EXPECT_FLOAT_EQ(layout.get(2).z, 0.0f);
+
+    struct bad_layout {
+        char const* text;
+        uint32_t line;
+    };
+    bad_layout const layouts[] = {
+        {"1 2 3\n4\n", 2},
+        {"1 2 3 4\n", 1},
+        {"1 2\n\n1 x 2\n", 3},
+        {"1 - 2\n", 1},
+    };
+    for (std::size_t i = 0; i < sizeof(layouts) / sizeof(layouts[0]); ++i) {
+        EXPECT_FALSE(load(layout, layouts[i].text, error)) << i;
+        EXPECT_EQ(error.line, layouts[i].line) << i;
+        EXPECT_EQ(layout.size(), 0u) << i;
+    }
+}
+
+// Test distance, projection and angle tables in Q16.16, with their bounds
+TEST(led_layout_test, builds_geometry_tables) {
+    led_layout layout;
+    led_position const positions[] = {{1, 0, 0}, {0, 1, 0}, {-1, 0, 0}, {0, -1, 0}, {3, 4, 0}};
+    for (std::size_t i = 0; i < 5; ++i) {
+        layout.add(positions[i]);
+    }
+    geometry_table const distance = layout.distances({0, 0, 0});
+    EXPECT_EQ(distance.values[0], SHADER_ONE);
+    EXPECT_EQ(distance.values[4], 5 * SHADER_ONE);
+    EXPECT_EQ(distance.min, SHADER_ONE);
+    EXPECT_EQ(distance.max, 5 * SHADER_ONE);
+
+    geometry_table const along = layout.projections({2, 0, 0}, {1, 0, 0});
+    EXPECT_EQ(along.values[2], -2 * SHADER_ONE);
+    EXPECT_EQ(along.values[4], 2 * SHADER_ONE);
+
+    geometry_table const around_z = layout.angles({0, 0, 0}, {0, 0, 1});
+    EXPECT_EQ(around_z.values[0], 0);
+    EXPECT_EQ(around_z.values[1], SHADER_ONE / 4);
+    EXPECT_EQ(around_z.values[2], SHADER_ONE / 2);
+    EXPECT_EQ(around_z.values[3], 3 * SHADER_ONE / 4);
+
+    led_layout upright;
+    upright.add({5, 0, 1});
+    EXPECT_EQ(upright.angles({0, 0, 0}, {1, 0, 0}).values[0], SHADER_ONE / 4);
+
+    geometry_table scaled = layout.distances({0, 0, 0});
+    scaled.normalize();
+    EXPECT_EQ(scaled.values[0], 0);
+    EXPECT_EQ(scaled.values[4], SHADER_ONE);
+    EXPECT_EQ(scaled.values[1], 0);
+}
+
+// Test layout_wave matches the same wave written as a pixel shader over the table
+TEST(led_layout_test, wave_matches_pixel_shader) {
+    led_layout layout;
+    for (int i = 0; i < 500; ++i) {
+        layout.add({static_cast<float>(i % 25) * 0.4f, static_cast<float>(i / 25) * 0.3f, 1.0f});
+    }
+    geometry_table const radius = layout.distances({4, 3, 0});
+    char const* const text = "r = wave(x * 1.5 - t)";
+    shader_program program;
+    shader_error error;
+    ASSERT_TRUE(compile_shader(text, std::strlen(text), program, error));
+    std::vector<uint8_t> wave(layout.size());
+    std::vector<uint8_t> shaded(layout.size());
+    pixel_shader<> shader;
+    for (int32_t phase = 0; phase < 4 * SHADER_ONE; phase += 12345) {
+        layout_wave(radius, 3 * SHADER_ONE / 2, phase, wave.data());
+        shader_inputs const inputs = {radius.data(), nullptr, phase};
+        shader.evaluate(program, inputs, layout.size(), shaded.data(), nullptr, nullptr);
+        ASSERT_EQ(wave, shaded) << phase;
+    }
+}
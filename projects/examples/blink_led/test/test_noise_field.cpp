@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "mock_hardware.h"
+#include "noise_field.h"
+
+static int32_t random_coordinate() {
+    // Unsigned arithmetic wraps; converting once at the end cannot overflow
+    uint32_t const bits = static_cast<uint32_t>(std::rand()) << 4 ^
+                          static_cast<uint32_t>(std::rand());
+    return static_cast<int32_t>(bits - (uint32_t(1) << 30));
+}
+
+// Test the SIMD batches give exactly the scalar results, tails included
+TEST(noise_field_test, batches_match_scalar) {
+    std::size_t const count = 1027;
+    std::vector<int32_t> x(count);
+    std::vector<int32_t> y(count);
+    std::srand(41);
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] = random_coordinate();
+        y[i] = i % 5 == 0 ? -x[i] : random_coordinate();
+    }
+    std::vector<uint16_t> out(count);
+    noise_1d_batch(x.data(), count, 7, out.data());
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(out[i], noise_1d(x[i], 7)) << i;
+    }
+    noise_2d_batch(x.data(), y.data(), count, 8, out.data());
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(out[i], noise_2d(x[i], y[i], 8)) << i;
+    }
+    for (int32_t z = -3 * 65536; z < 3 * 65536; z += 40000) {
+        noise_3d_batch(x.data(), y.data(), z, count, 9, out.data());
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(out[i], noise_3d(x[i], y[i], z, 9)) << i << " " << z;
+        }
+    }
+}
+
+// Test noise is smooth (no jumps, across cells and zero) and spans the range
+TEST(noise_field_test, noise_is_coherent_and_spread) {
+    uint32_t const seed = 12345;
+    uint16_t low = 65535;
+    uint16_t high = 0;
+    uint64_t sum = 0;
+    uint32_t samples = 0;
+    int32_t const step = 256;  // 1/256 cell
+    for (int32_t x = -50 * 65536; x < 50 * 65536; x += step) {
+        int const n = noise_1d(x, seed);
+        int const next = noise_1d(x + step, seed);
+        ASSERT_LE(std::abs(next - n), 400) << x;  // Slope at most 1.5 x 65535 per cell
+        int const n2 = noise_2d(x, x / 3, seed);
+        ASSERT_LE(std::abs(noise_2d(x + step, x / 3, seed) - n2), 400) << x;
+        ASSERT_LE(std::abs(noise_3d(7 * 65536, x / 5, x, seed) -
+                           noise_3d(7 * 65536, x / 5, x + step, seed)),
+                  400)
+            << x;
+        low = n < low ? static_cast<uint16_t>(n) : low;
+        high = n > high ? static_cast<uint16_t>(n) : high;
+        sum += static_cast<uint32_t>(n);
+        ++samples;
+    }
+    EXPECT_LT(low, 6000);
+    EXPECT_GT(high, 59000);
+    double const mean = static_cast<double>(sum) / samples;
+    EXPECT_GT(mean, 26000);
+    EXPECT_LT(mean, 39000);
+
+    // Smoothstep weights rise from 0 to 1 (give or take rounding) without overflowing 16 bits
+    for (uint32_t f = 1; f < 65536; ++f) {
+        ASSERT_GE(noise_detail::smooth(static_cast<uint16_t>(f)) + 2,
+                  noise_detail::smooth(static_cast<uint16_t>(f - 1)))
+            << f;
+    }
+    EXPECT_EQ(noise_detail::smooth(0), 0);
+    EXPECT_GT(noise_detail::smooth(0xFFFF), 0xFFF0);
+
+    // Different seeds are different fields
+    int same = 0;
+    for (int32_t x = 0; x < 100 * 65536; x += 65536 + 77) {
+        same += noise_1d(x, 1) == noise_1d(x, 2);
+    }
+    EXPECT_LT(same, 5);
+}
+
+// Test the 8-bit AVR variant: permutation table, smooth steps, lattice values at cells
+TEST(noise_field_test, noise8_is_coherent) {
+    bool seen[256] = {};
+    for (int i = 0; i < 256; ++i) {
+        seen[noise8_permutation(static_cast<uint8_t>(i))] = true;
+    }
+    for (int i = 0; i < 256; ++i) {
+        ASSERT_TRUE(seen[i]) << i;
+    }
+    EXPECT_EQ(noise_detail::ease8(0), 0);
+    EXPECT_EQ(noise_detail::ease8(255), 255);
+    EXPECT_EQ(noise_detail::ease8(128), 128);
+    for (int f = 1; f < 256; ++f) {
+        ASSERT_GE(noise_detail::ease8(static_cast<uint8_t>(f)) + 2,
+                  noise_detail::ease8(static_cast<uint8_t>(f - 1)));
+    }
+
+    for (uint32_t x = 0; x < 65536; ++x) {
+        uint16_t const at = static_cast<uint16_t>(x);
+        uint16_t const next = static_cast<uint16_t>(x + 1);
+        if ((x & 0xFF) == 0) {
+            ASSERT_EQ(noise8_1d(at), noise8_permutation(static_cast<uint8_t>(x >> 8)));
+        }
+        if ((x & 0xFF) != 0xFF) {  // Within a cell; the wrap to the next cell is checked below
+            ASSERT_LE(std::abs(noise8_1d(next) - noise8_1d(at)), 4) << x;
+            ASSERT_LE(std::abs(noise8_2d(next, at) - noise8_2d(at, at)), 4) << x;
+            ASSERT_LE(std::abs(noise8_3d(at, 300, next) - noise8_3d(at, 300, at)), 4) << x;
+        } else {
+            ASSERT_LE(std::abs(noise8_1d(next) - noise8_1d(at)), 1) << x;
+        }
+    }
+}
+
+// Test the flicker stays between its levels, moves, and dithers the pin to match
+TEST(noise_field_test, flicker_controller_dithers_flame) {
+    mock_pin pin;
+    flicker_controller<mock_pin> candle(pin, 100, 240, 10);
+    uint8_t low = 255;
+    uint8_t high = 0;
+    uint32_t level_sum = 0;
+    uint32_t on_count = 0;
+    for (uint32_t now = 0; now < 20000; ++now) {
+        candle.update(now);
+        ASSERT_EQ(pin.get_state(), candle.is_on());
+        low = candle.get_level() < low ? candle.get_level() : low;
+        high = candle.get_level() > high ? candle.get_level() : high;
+        level_sum += candle.get_level();
+        on_count += pin.get_state();
+    }
+    EXPECT_GE(low, 100);
+    EXPECT_LE(high, 240);
+    EXPECT_GT(high - low, 60);  // Actually flickers
+    // Average pin duty tracks the average level
+    EXPECT_NEAR(on_count / 20000.0, level_sum / 20000.0 / 255.0, 0.01);
+
+    // Another seed is another candle
+    mock_pin other_pin;
+    flicker_controller<mock_pin> other(other_pin, 100, 240, 10, 77);
+    int same = 0;
+    for (uint32_t now = 0; now < 2000; now += 50) {
+        candle.update(now);
+        other.update(now);
+        same += candle.get_level() == other.get_level();
+    }
+    EXPECT_LT(same, 10);
+}
@@ -0,0 +1,299 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "blink_controller.h"
+#include "mock_hardware.h"
+#include "osc_dispatch.h"
+#include "osc_message.h"
+#include "udp_socket.h"
+
+static bool matches(char const* pattern, char const* address) {
+    return osc_pattern_match(pattern, pattern + std::strlen(pattern), address,
+                             address + std::strlen(address));
+}
+
+// Records the addresses routed to it
+struct route_log {
+    std::vector<std::string> calls;
+
+    static void on_message(void* context, osc_message const& message) {
+        static_cast<route_log*>(context)->calls.push_back(message.address);
+    }
+};
+
+static std::size_t write_message(uint8_t* buffer, std::size_t capacity, char const* address) {
+    osc_message_writer writer(buffer, capacity);
+    writer.begin(address, "");
+    return writer.finish();
+}
+
+static std::size_t dispatch_address(osc_dispatcher<16>& osc, char const* address) {
+    uint8_t buffer[64];
+    std::size_t const length = write_message(buffer, sizeof(buffer), address);
+    osc_message message;
+    EXPECT_TRUE(osc_parse_message(buffer, length, message));
+    return osc.dispatch(message);
+}
+
+// Test the OSC 1.0 pattern syntax
+TEST(osc_pattern_test, matches_osc_wildcards) {
+    EXPECT_TRUE(matches("/cue/go", "/cue/go"));
+    EXPECT_FALSE(matches("/cue/go", "/cue/gone"));
+    EXPECT_TRUE(matches("/cue/?o", "/cue/go"));
+    EXPECT_TRUE(matches("/channel/*", "/channel/12"));
+    EXPECT_TRUE(matches("/channel/*", "/channel/"));
+    EXPECT_FALSE(matches("/channel/*", "/channel/12/rate"));  // '*' stops at '/'
+    EXPECT_TRUE(matches("/channel/*/rate", "/channel/12/rate"));
+    EXPECT_TRUE(matches("/*/*/rate", "/channel/12/rate"));
+    EXPECT_TRUE(matches("/channel/[1-3]/rate", "/channel/2/rate"));
+    EXPECT_FALSE(matches("/channel/[1-3]/rate", "/channel/4/rate"));
+    EXPECT_TRUE(matches("/channel/[!1-3]/rate", "/channel/4/rate"));
+    EXPECT_TRUE(matches("/channel/[13]", "/channel/3"));
+    EXPECT_TRUE(matches("/cue/{go,stop}", "/cue/stop"));
+    EXPECT_FALSE(matches("/cue/{go,stop}", "/cue/pause"));
+    EXPECT_TRUE(matches("/{cue,fx}/*o*", "/fx/strobe"));
+}
+
+// Test literal addresses resolve through the hash table
+TEST(osc_dispatcher_test, dispatches_literal_addresses) {
+    osc_dispatcher<16> osc;
+    route_log go;
+    route_log stop;
+    EXPECT_TRUE(osc.add("/cue/go", &route_log::on_message, &go));
+    EXPECT_TRUE(osc.add("/cue/stop", &route_log::on_message, &stop));
+    EXPECT_FALSE(osc.add("/cue/go", &route_log::on_message, &stop));  // Duplicate
+    EXPECT_FALSE(osc.add("/cue/*", &route_log::on_message, &stop));   // Routes are literal
+    EXPECT_FALSE(osc.add("cue", &route_log::on_message, &stop));
+    EXPECT_EQ(osc.get_route_count(), 2u);
+
+    EXPECT_EQ(dispatch_address(osc, "/cue/go"), 1u);
+    EXPECT_EQ(dispatch_address(osc, "/cue/stop"), 1u);
+    EXPECT_EQ(dispatch_address(osc, "/cue/gone"), 0u);
+    EXPECT_EQ(go.calls.size(), 1u);
+    EXPECT_EQ(stop.calls.size(), 1u);
+    EXPECT_EQ(osc.get_dispatched(), 2u);
+    EXPECT_EQ(osc.get_unmatched(), 1u);
+}
+
+// Test patterns fan out to every matching route and are cached
+TEST(osc_dispatcher_test, patterns_fan_out_and_are_cached) {
+    osc_dispatcher<16> osc;
+    route_log channels;
+    route_log cues;
+    char address[32];
+    for (int i = 1; i <= 8; ++i) {
+        std::snprintf(address, sizeof(address), "/channel/%d/rate", i);
+        ASSERT_TRUE(osc.add(address, &route_log::on_message, &channels));
+    }
+    osc.add("/cue/go", &route_log::on_message, &cues);
+
+    EXPECT_EQ(dispatch_address(osc, "/channel/*/rate"), 8u);
+    EXPECT_EQ(dispatch_address(osc, "/channel/[2-4]/rate"), 3u);
+    EXPECT_EQ(dispatch_address(osc, "/channel/{1,8}/rate"), 2u);
+    EXPECT_EQ(osc.get_pattern_misses(), 3u);
+
+    // Repeats are served from the cache
+    EXPECT_EQ(dispatch_address(osc, "/channel/*/rate"), 8u);
+    EXPECT_EQ(dispatch_address(osc, "/channel/[2-4]/rate"), 3u);
+    EXPECT_EQ(osc.get_pattern_misses(), 3u);
+    EXPECT_EQ(channels.calls.size(), 24u);
+    EXPECT_TRUE(cues.calls.empty());
+
+    // A new route invalidates cached results
+    route_log extra;
+    osc.add("/channel/9/rate", &route_log::on_message, &extra);
+    EXPECT_EQ(dispatch_address(osc, "/channel/*/rate"), 9u);
+    EXPECT_EQ(extra.calls.size(), 1u);
+}
+
+// Records the controller time each dispatched message arrived at
+struct timed_log {
+    uint32_t now_ms = 0;
+    std::vector<std::string> calls;
+    std::vector<uint32_t> times;
+
+    static void on_message(void* context, osc_message const& message) {
+        timed_log& log = *static_cast<timed_log*>(context);
+        log.calls.push_back(message.address);
+        log.times.push_back(log.now_ms);
+    }
+};
+
+static std::size_t write_bundle(uint8_t* buffer, std::size_t capacity, uint64_t timetag,
+                                char const* address) {
+    uint8_t message[32];
+    std::size_t const length = write_message(message, sizeof(message), address);
+    osc_bundle_writer bundle(buffer, capacity, timetag);
+    bundle.add(message, length);
+    return bundle.finish();
+}
+
+// Test timetag to controller time conversion is exact in both directions
+TEST(osc_scheduler_test, converts_timetags_to_controller_time) {
+    osc_dispatcher<4> osc;
+    osc_scheduler<osc_dispatcher<4> > scheduler(osc);
+    uint64_t const base = osc_timetag_from_unix(1700000000, 0);
+    scheduler.sync(base, 5000);
+
+    EXPECT_EQ(scheduler.timetag_to_ms(base), 5000u);
+    EXPECT_EQ(scheduler.timetag_to_ms(base + (uint64_t(3) << 32)), 8000u);
+    EXPECT_EQ(scheduler.timetag_to_ms(base - (uint64_t(2) << 32)), 3000u);
+    EXPECT_EQ(scheduler.timetag_to_ms(osc_timetag_from_unix(1700000000, 250)), 5250u);
+
+    // An hour of 1 ms steps lands exactly (no accumulated rounding)
+    uint64_t const hour_later = osc_timetag_from_unix(1700003600, 1);
+    EXPECT_EQ(scheduler.timetag_to_ms(hour_later), 5000u + 3600000u + 1u);
+}
+
+// Test bundles run at their time; late and immediate ones run at once
+TEST(osc_scheduler_test, runs_bundles_at_their_time) {
+    osc_dispatcher<4> osc;
+    timed_log log;
+    osc.add("/cue/go", &timed_log::on_message, &log);
+    osc.add("/cue/stop", &timed_log::on_message, &log);
+    osc_scheduler<osc_dispatcher<4>, 4> scheduler(osc);
+    uint64_t const base = osc_timetag_from_unix(1700000000, 0);
+    scheduler.sync(base, 1000);
+
+    uint8_t packet[64];
+    // Arrives in reverse order of execution
+    std::size_t length =
+        write_bundle(packet, sizeof(packet), base + (uint64_t(1) << 32), "/cue/stop");  // 2000 ms
+    EXPECT_TRUE(scheduler.process(packet, length, 1000));
+    length = write_bundle(packet, sizeof(packet), base + (uint64_t(1) << 31), "/cue/go");  // 1500
+    EXPECT_TRUE(scheduler.process(packet, length, 1000));
+    EXPECT_EQ(scheduler.get_pending(), 2u);
+    uint32_t due = 0;
+    ASSERT_TRUE(scheduler.get_next_due(due));
+    EXPECT_EQ(due, 1500u);
+
+    log.now_ms = 1499;
+    EXPECT_EQ(scheduler.update(1499), 0u);
+    log.now_ms = 1500;
+    EXPECT_EQ(scheduler.update(1500), 1u);
+    log.now_ms = 2100;
+    EXPECT_EQ(scheduler.update(2100), 1u);
+    ASSERT_EQ(log.calls.size(), 2u);
+    EXPECT_EQ(log.calls[0], "/cue/go");
+    EXPECT_EQ(log.times[0], 1500u);
+    EXPECT_EQ(log.calls[1], "/cue/stop");
+
+    // Late bundle: dispatched on arrival
+    length = write_bundle(packet, sizeof(packet), base, "/cue/go");
+    EXPECT_TRUE(scheduler.process(packet, length, 2200));
+    EXPECT_EQ(log.calls.size(), 3u);
+    EXPECT_EQ(scheduler.get_pending(), 0u);
+
+    // Full queue drops
+    for (int i = 0; i < 5; ++i) {
+        length = write_bundle(packet, sizeof(packet), base + (uint64_t(10) << 32), "/cue/go");
+        scheduler.process(packet, length, 2200);
+    }
+    EXPECT_EQ(scheduler.get_pending(), 4u);
+    EXPECT_EQ(scheduler.get_dropped(), 1u);
+}
+
+// Test messages scheduled for the same time keep their arrival order
+TEST(osc_scheduler_test, equal_times_keep_arrival_order) {
+    osc_dispatcher<4> osc;
+    timed_log log;
+    osc.add("/a", &timed_log::on_message, &log);
+    osc.add("/b", &timed_log::on_message, &log);
+    osc_scheduler<osc_dispatcher<4> > scheduler(osc);
+    scheduler.sync(0, 0);
+
+    uint8_t packet[64];
+    uint64_t const at = uint64_t(1) << 32;
+    std::size_t length = write_bundle(packet, sizeof(packet), at, "/a");
+    scheduler.process(packet, length, 0);
+    length = write_bundle(packet, sizeof(packet), at, "/b");
+    scheduler.process(packet, length, 0);
+    EXPECT_EQ(scheduler.update(1000), 2u);
+    ASSERT_EQ(log.calls.size(), 2u);
+    EXPECT_EQ(log.calls[0], "/a");
+    EXPECT_EQ(log.calls[1], "/b");
+}
+
+// A show's OSC surface: /channel/N/rate <on_ms> <off_ms> retimes channel N
+struct osc_show {
+    mock_pin pins[2];
+    std::vector<blink_controller<mock_pin> > channels;
+    osc_dispatcher<8> osc;
+    osc_scheduler<osc_dispatcher<8> > scheduler;
+
+    osc_show() : scheduler(osc) {
+        channels.push_back(blink_controller<mock_pin>(pins[0], 500, 500));
+        channels.push_back(blink_controller<mock_pin>(pins[1], 500, 500));
+        osc.add("/channel/1/rate", &osc_show::on_rate, &channels[0]);
+        osc.add("/channel/2/rate", &osc_show::on_rate, &channels[1]);
+    }
+
+    static void on_rate(void* context, osc_message const& message) {
+        int32_t on_ms = 0;
+        int32_t off_ms = 0;
+        if (message.get_int32(0, on_ms) && message.get_int32(1, off_ms)) {
+            static_cast<blink_controller<mock_pin>*>(context)->set_durations(
+                static_cast<uint32_t>(on_ms), static_cast<uint32_t>(off_ms));
+        }
+    }
+
+    static void on_datagram(void* context, uint8_t const* data, std::size_t length,
+                            sockaddr_in const&) {
+        osc_show& show = *static_cast<osc_show*>(context);
+        show.scheduler.process(data, length, show.now_ms);
+    }
+
+    uint32_t now_ms = 0;
+};
+
+// Test a pattern message and a timetagged bundle over loopback
+TEST(osc_loopback_test, retimes_channels_over_udp) {
+    udp_batch_receiver<1024> socket;
+    if (!socket.open(0)) {
+        GTEST_SKIP() << "no UDP sockets available";
+    }
+    udp_sender sender;
+    sender.connect(INADDR_LOOPBACK, socket.get_port());
+    osc_show show;
+    show.scheduler.sync(0, 0);
+
+    uint8_t message[64];
+    osc_message_writer writer(message, sizeof(message));
+    writer.begin("/channel/*/rate", "ii");
+    writer.add_int32(100);
+    writer.add_int32(300);
+    std::size_t const message_length = writer.finish();
+    ASSERT_TRUE(sender.send(message, message_length));
+
+    writer.begin("/channel/2/rate", "ii");
+    writer.add_int32(50);
+    writer.add_int32(50);
+    std::size_t const later_length = writer.finish();
+    uint8_t bundle[128];
+    osc_bundle_writer bundle_writer(bundle, sizeof(bundle), uint64_t(2) << 32);  // 2000 ms
+    bundle_writer.add(message, later_length);
+    ASSERT_TRUE(sender.send(bundle, bundle_writer.finish()));
+
+    std::size_t received = 0;
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    while (received < 2 && std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+        socket.wait(10);
+        received += socket.receive(&osc_show::on_datagram, &show);
+    }
+    ASSERT_EQ(received, 2u);
+    EXPECT_EQ(show.channels[0].get_next_on_duration(), 100u);
+    EXPECT_EQ(show.channels[1].get_next_off_duration(), 300u);
+    EXPECT_EQ(show.scheduler.get_pending(), 1u);
+
+    show.scheduler.update(1999);
+    EXPECT_EQ(show.channels[1].get_next_on_duration(), 100u);
+    show.scheduler.update(2000);
+    EXPECT_EQ(show.channels[1].get_next_on_duration(), 50u);
+    EXPECT_EQ(show.channels[0].get_next_on_duration(), 100u);
+}
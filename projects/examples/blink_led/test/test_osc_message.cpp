@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "osc_message.h"
+
+// Collects every message of a packet with its timetag
+struct message_log {
+    std::vector<std::string> addresses;
+    std::vector<uint64_t> timetags;
+
+    void on_message(osc_message const& message, uint64_t timetag) {
+        addresses.push_back(std::string(message.address, message.address_length));
+        timetags.push_back(timetag);
+    }
+};
+
+// Test a message round-trips through the writer and the in-place parser
+TEST(osc_message_test, parses_arguments_in_place) {
+    uint8_t buffer[128];
+    osc_message_writer writer(buffer, sizeof(buffer));
+    writer.begin("/channel/3/rate", "ifsb");
+    writer.add_int32(-42);
+    writer.add_float(1.5f);
+    writer.add_string("fast");
+    uint8_t const blob[3] = {9, 8, 7};
+    writer.add_blob(blob, sizeof(blob));
+    std::size_t const length = writer.finish();
+    // 16 address + 8 tags + 4 + 4 + 8 string + 4 size + 4 padded blob
+    ASSERT_EQ(length, 48u);
+
+    osc_message message;
+    ASSERT_TRUE(osc_parse_message(buffer, length, message));
+    EXPECT_EQ(std::string(message.address), "/channel/3/rate");
+    EXPECT_EQ(message.address_length, 15u);
+    EXPECT_EQ(message.address, reinterpret_cast<char const*>(buffer));  // No copy
+    EXPECT_EQ(std::string(message.type_tags), "ifsb");
+    ASSERT_EQ(message.argument_count, 4u);
+
+    int32_t i = 0;
+    float f = 0.0f;
+    char const* s = nullptr;
+    uint8_t const* b = nullptr;
+    std::size_t b_size = 0;
+    EXPECT_TRUE(message.get_int32(0, i));
+    EXPECT_EQ(i, -42);
+    EXPECT_TRUE(message.get_float(1, f));
+    EXPECT_FLOAT_EQ(f, 1.5f);
+    EXPECT_TRUE(message.get_string(2, s));
+    EXPECT_STREQ(s, "fast");
+    ASSERT_TRUE(message.get_blob(3, b, b_size));
+    EXPECT_EQ(b_size, 3u);
+    EXPECT_EQ(b[2], 7);
+
+    // Numbers convert between int and float; other types do not
+    EXPECT_TRUE(message.get_float(0, f));
+    EXPECT_FLOAT_EQ(f, -42.0f);
+    EXPECT_TRUE(message.get_int32(1, i));
+    EXPECT_EQ(i, 1);
+    EXPECT_FALSE(message.get_int32(2, i));
+    EXPECT_FALSE(message.get_string(0, s));
+    EXPECT_FALSE(message.get_int32(4, i));  // Out of range
+}
+
+// Test messages without arguments, with or without a type tag string
+TEST(osc_message_test, parses_messages_without_arguments) {
+    uint8_t buffer[32];
+    osc_message_writer writer(buffer, sizeof(buffer));
+    writer.begin("/cue/go", "");
+    std::size_t const length = writer.finish();
+    ASSERT_EQ(length, 12u);
+
+    osc_message message;
+    ASSERT_TRUE(osc_parse_message(buffer, length, message));
+    EXPECT_EQ(message.argument_count, 0u);
+
+    // Pre-1.0 senders omit the type tag string entirely
+    ASSERT_TRUE(osc_parse_message(buffer, 8, message));
+    EXPECT_EQ(message.argument_count, 0u);
+    EXPECT_STREQ(message.type_tags, "");
+}
+
+// Test float arguments saturate to int32 and NaN is refused
+TEST(osc_message_test, float_to_int_saturates_and_rejects_nan) {
+    uint8_t buffer[64];
+    osc_message_writer writer(buffer, sizeof(buffer));
+    writer.begin("/a", "fffff");
+    writer.add_float(std::numeric_limits<float>::quiet_NaN());
+    writer.add_float(3.0e9f);
+    writer.add_float(-3.0e9f);
+    writer.add_float(std::numeric_limits<float>::infinity());
+    writer.add_float(-2.9f);
+    std::size_t const length = writer.finish();
+    ASSERT_GT(length, 0u);
+    osc_message message;
+    ASSERT_TRUE(osc_parse_message(buffer, length, message));
+
+    int32_t value = 7;
+    EXPECT_FALSE(message.get_int32(0, value));
+    ASSERT_TRUE(message.get_int32(1, value));
+    EXPECT_EQ(value, std::numeric_limits<int32_t>::max());
+    ASSERT_TRUE(message.get_int32(2, value));
+    EXPECT_EQ(value, std::numeric_limits<int32_t>::min());
+    ASSERT_TRUE(message.get_int32(3, value));
+    EXPECT_EQ(value, std::numeric_limits<int32_t>::max());
+    ASSERT_TRUE(message.get_int32(4, value));
+    EXPECT_EQ(value, -2);
+}
+
+// Test malformed messages are rejected
+TEST(osc_message_test, rejects_malformed_messages) {
+    uint8_t buffer[64];
+    osc_message_writer writer(buffer, sizeof(buffer));
+    writer.begin("/a", "is");
+    writer.add_int32(1);
+    writer.add_string("xyz");
+    std::size_t const length = writer.finish();
+    ASSERT_GT(length, 0u);
+    osc_message message;
+    ASSERT_TRUE(osc_parse_message(buffer, length, message));
+
+    EXPECT_FALSE(osc_parse_message(buffer, length - 4, message));  // Missing argument
+    EXPECT_FALSE(osc_parse_message(buffer, length - 1, message));  // Not 4-aligned
+    std::vector<uint8_t> bad(buffer, buffer + length);
+    bad[0] = 'a';  // Address must start with '/'
+    EXPECT_FALSE(osc_parse_message(bad.data(), bad.size(), message));
+    bad.assign(buffer, buffer + length);
+    bad[3] = 'x';  // Address padding must be zero
+    EXPECT_FALSE(osc_parse_message(bad.data(), bad.size(), message));
+    bad.assign(buffer, buffer + length);
+    bad[6] = 'Z';  // Unknown type tag
+    EXPECT_FALSE(osc_parse_message(bad.data(), bad.size(), message));
+    bad.assign(buffer, buffer + length);
+    bad[4] = 'i';  // Type tags must start with ','
+    EXPECT_FALSE(osc_parse_message(bad.data(), bad.size(), message));
+
+    // Blob sizes past the end are rejected, including ones whose padding would wrap
+    uint8_t const blob[4] = {1, 2, 3, 4};
+    writer.begin("/a", "b");
+    writer.add_blob(blob, sizeof(blob));
+    std::size_t const blob_length = writer.finish();
+    ASSERT_GT(blob_length, 0u);
+    ASSERT_TRUE(osc_parse_message(buffer, blob_length, message));
+    uint32_t const sizes[] = {5, 8, 0xFFFFFFFDu, 0xFFFFFFFFu};
+    for (uint32_t size : sizes) {
+        bad.assign(buffer, buffer + blob_length);
+        for (std::size_t i = 0; i < 4; ++i) {
+            bad[8 + i] = static_cast<uint8_t>(size >> (24 - 8 * i));
+        }
+        EXPECT_FALSE(osc_parse_message(bad.data(), bad.size(), message)) << size;
+    }
+
+    // Writer reports tag mismatches and overflow
+    writer.begin("/a", "i");
+    writer.add_float(1.0f);
+    EXPECT_EQ(writer.finish(), 0u);
+    writer.begin("/a", "ii");
+    writer.add_int32(1);
+    EXPECT_EQ(writer.finish(), 0u);
+    uint8_t tiny[8];
+    osc_message_writer small(tiny, sizeof(tiny));
+    small.begin("/too/long", "");
+    EXPECT_EQ(small.finish(), 0u);
+}
+
+// Test nested bundles report the innermost timetag for each message
+TEST(osc_message_test, walks_nested_bundles) {
+    uint8_t go[16];
+    osc_message_writer writer(go, sizeof(go));
+    writer.begin("/cue/go", "");
+    std::size_t const go_length = writer.finish();
+    uint8_t stop[16];
+    osc_message_writer stop_writer(stop, sizeof(stop));
+    stop_writer.begin("/cue/stop", "");
+    std::size_t const stop_length = stop_writer.finish();
+
+    uint8_t inner[64];
+    osc_bundle_writer inner_bundle(inner, sizeof(inner), 0x200000000ull);
+    inner_bundle.add(stop, stop_length);
+    std::size_t const inner_length = inner_bundle.finish();
+    ASSERT_GT(inner_length, 0u);
+
+    uint8_t outer[128];
+    osc_bundle_writer outer_bundle(outer, sizeof(outer), 0x100000000ull);
+    outer_bundle.add(go, go_length);
+    outer_bundle.add(inner, inner_length);
+    std::size_t const outer_length = outer_bundle.finish();
+    ASSERT_GT(outer_length, 0u);
+    EXPECT_TRUE(osc_is_bundle(outer, outer_length));
+
+    message_log log;
+    EXPECT_TRUE(osc_walk_packet(outer, outer_length, log));
+    ASSERT_EQ(log.addresses.size(), 2u);
+    EXPECT_EQ(log.addresses[0], "/cue/go");
+    EXPECT_EQ(log.timetags[0], 0x100000000ull);
+    EXPECT_EQ(log.addresses[1], "/cue/stop");
+    EXPECT_EQ(log.timetags[1], 0x200000000ull);
+
+    // A bare message is immediate
+    message_log bare;
+    EXPECT_TRUE(osc_walk_packet(go, go_length, bare));
+    EXPECT_EQ(bare.timetags[0], OSC_TIMETAG_IMMEDIATE);
+
+    // An element size running past the end stops the walk
+    outer[16 + 3] = 200;
+    message_log broken;
+    EXPECT_FALSE(osc_walk_packet(outer, outer_length, broken));
+}
+
+// Test NTP timetags from Unix time
+TEST(osc_message_test, timetag_from_unix_time) {
+    uint64_t const timetag = osc_timetag_from_unix(0, 500);
+    EXPECT_EQ(timetag >> 32, OSC_NTP_UNIX_OFFSET);
+    EXPECT_EQ(static_cast<uint32_t>(timetag), 0x80000000u);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "blink_controller.h"
+#include "mock_hardware.h"
+#include "output_bank.h"
+
+// Test sizes and initial state
+TEST(output_bank_test, initial_state_is_all_off) {
+    output_bank<40> bank;
+
+    EXPECT_EQ(output_bank<40>::CHANNEL_COUNT, 40);
+    EXPECT_EQ(output_bank<40>::WORD_COUNT, 2);
+    EXPECT_EQ(bank.count_on(), 0);
+    EXPECT_EQ(bank.words()[0], 0);
+    EXPECT_EQ(bank.words()[1], 0);
+}
+
+// Test set/get and bit placement across word boundaries
+TEST(output_bank_test, set_and_get_channels) {
+    output_bank<64> bank;
+
+    bank.set(0, true);
+    bank.set(31, true);
+    bank.set(32, true);
+    bank.set(63, true);
+
+    EXPECT_TRUE(bank.get(0));
+    EXPECT_FALSE(bank.get(1));
+    EXPECT_TRUE(bank.get(63));
+    EXPECT_EQ(bank.words()[0], 0x80000001u);
+    EXPECT_EQ(bank.words()[1], 0x80000001u);
+    EXPECT_EQ(bank.count_on(), 4);
+
+    bank.set(31, false);
+    EXPECT_FALSE(bank.get(31));
+    EXPECT_EQ(bank.count_on(), 3);
+}
+
+// Test clear resets every channel
+TEST(output_bank_test, clear_turns_everything_off) {
+    output_bank<8> bank;
+    for (std::size_t i = 0; i < 8; ++i) {
+        bank.set(i, true);
+    }
+    EXPECT_EQ(bank.count_on(), 8);
+
+    bank.clear();
+    EXPECT_EQ(bank.count_on(), 0);
+}
+
+// Test bank_pin drives only its own bit
+TEST(output_bank_test, bank_pin_drives_one_channel) {
+    output_bank<16> bank;
+    bank_pin pin = bank.channel(3);
+
+    pin.set(true);
+    EXPECT_TRUE(pin.get_state());
+    EXPECT_TRUE(bank.get(3));
+    EXPECT_EQ(bank.count_on(), 1);
+
+    pin.set(false);
+    EXPECT_FALSE(bank.get(3));
+}
+
+// Test blink_controllers drive bank channels through dependency injection
+TEST(output_bank_test, controllers_drive_bank) {
+    output_bank<2> bank;
+    bank_pin pins[2] = {bank.channel(0), bank.channel(1)};
+    blink_controller<bank_pin> fast(pins[0], 100, 100);
+    blink_controller<bank_pin> slow(pins[1], 100, 300);
+
+    fast.update(100);
+    slow.update(100);
+    EXPECT_TRUE(bank.get(0));
+    EXPECT_FALSE(bank.get(1));
+
+    fast.update(300);
+    slow.update(300);
+    EXPECT_FALSE(bank.get(0));
+    EXPECT_TRUE(bank.get(1));
+}
+
+// Test level_bank stores one byte per channel through level_pin adapters
+TEST(output_bank_test, level_bank_pins_write_levels) {
+    level_bank<4> levels;
+    EXPECT_EQ(levels.get(2), 0);
+
+    level_pin pin = levels.channel(2);
+    pin.set_level(200);
+    EXPECT_EQ(levels.get(2), 200);
+    EXPECT_EQ(levels.levels()[2], 200);
+    EXPECT_EQ(pin.get_level(), 200);
+    EXPECT_EQ(levels.get(1), 0);
+
+    levels.clear();
+    EXPECT_EQ(pin.get_level(), 0);
+}
+
+// Test rgb_bank keeps one plane per color and packs pixels as 0xRRGGBB
+TEST(output_bank_test, rgb_bank_planes_and_packing) {
+    rgb_bank<3> strip;
+    EXPECT_EQ(strip.get(1), 0u);
+
+    strip.set(1, 255, 80, 1);
+    EXPECT_EQ(strip.get(1), 0xFF5001u);
+    EXPECT_EQ(strip.red()[1], 255);
+    EXPECT_EQ(strip.green()[1], 80);
+    EXPECT_EQ(strip.blue()[1], 1);
+    EXPECT_EQ(strip.get(0), 0u);
+
+    strip.clear();
+    EXPECT_EQ(strip.get(1), 0u);
+}
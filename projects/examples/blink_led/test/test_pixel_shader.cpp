@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "output_bank.h"
+#include "pixel_shader.h"
+#include "shader_expression.h"
+
+static bool compile(char const* text, shader_program& program, shader_error& error) {
+    return compile_shader(text, std::strlen(text), program, error);
+}
+
+static int32_t q16(double value) { return static_cast<int32_t>(value * SHADER_ONE); }
+
+// Test the expected colors come out on a small strip
+TEST(pixel_shader_test, writes_rgb_frame) {
+    shader_program program;
+    shader_error error;
+    ASSERT_TRUE(compile("r = 1; g = u\nb = index % 2  # odd pixels", program, error))
+        << error.message;
+    rgb_bank<4> strip;
+    pixel_shader<8> shader;
+    shader_inputs const inputs = {nullptr, nullptr, 0};
+    shader.evaluate(program, inputs, strip.PIXEL_COUNT, strip.red(), strip.green(), strip.blue());
+    EXPECT_EQ(strip.get(0), 0xFF0000u);
+    EXPECT_EQ(strip.get(1), 0xFF40FFu);  // u = 0.25
+    EXPECT_EQ(strip.get(2), 0xFF8000u);
+    EXPECT_EQ(strip.get(3), 0xFFBFFFu);
+}
+
+// Test compiled block evaluation matches the tree-walking interpreter exactly
+TEST(pixel_shader_test, matches_tree_walker) {
+    char const* const shaders[] = {
+        "r = wave(u + t / 4); g = tri(x * 3 - t); b = 1 - r",
+        "d = abs(x - 0.5) + abs(y - 0.5)\n"
+        "r = frac(d * 4 - t) < 0.3\n"
+        "g = max(0, 1 - d * 2) * wave(t)\n"
+        "b = min(sin(d * 8 * PI + t), cos(y * 5))",
+        "k = index % 7 / 7; r = k * k; g = floor(x * 10) / 10 > 0.4; b = -k + y / (x - 0.5)",
+        "s = sin(t) * 2; r = x * s; g = s; b = y % s",
+        "r = (x * 1000) * (y * -1000) / 1000 / 1000 + 0.5",
+    };
+    std::size_t const count = 1003;  // Not a whole number of blocks
+    std::vector<int32_t> x(count);
+    std::vector<int32_t> y(count);
+    std::srand(3);
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] = std::rand() % (2 * SHADER_ONE) - SHADER_ONE / 2;
+        y[i] = std::rand() % (2 * SHADER_ONE) - SHADER_ONE / 2;
+    }
+    std::vector<uint8_t> compiled(3 * count);
+    std::vector<uint8_t> walked(3 * count);
+    static pixel_shader<64> shader;
+    for (std::size_t s = 0; s < sizeof(shaders) / sizeof(shaders[0]); ++s) {
+        shader_expression expression;
+        shader_program program;
+        shader_error error;
+        ASSERT_TRUE(parse_shader(shaders[s], std::strlen(shaders[s]), expression, error))
+            << s << ": " << error.message;
+        ASSERT_TRUE(generate_shader(expression, program, error)) << s << ": " << error.message;
+        for (int32_t t = -q16(3); t < q16(20); t += q16(0.77)) {
+            shader_inputs const inputs = {x.data(), y.data(), t};
+            shader.evaluate(program, inputs, count, &compiled[0], &compiled[count],
+                            &compiled[2 * count]);
+            evaluate_shader_tree(expression, inputs, count, &walked[0], &walked[count],
+                                 &walked[2 * count]);
+            ASSERT_EQ(compiled, walked) << s << " at t " << t;
+        }
+    }
+}
+
+// Test constants fold away and t-only work runs once per frame, not per pixel
+TEST(pixel_shader_test, hoists_constants_and_uniform_work) {
+    shader_program program;
+    shader_error error;
+    ASSERT_TRUE(compile("r = wave(t / 4 * 2 + u)\ng = 2 * PI / 4\nb = wave(t)", program, error));
+    EXPECT_EQ(program.vector_count, 2u);  // add, wave
+    EXPECT_EQ(program.vector_code[0].op, shader_op::add);
+    EXPECT_EQ(program.vector_code[0].flags, SHADER_A_SCALAR);
+    EXPECT_TRUE(program.output_scalar[1]);
+    EXPECT_TRUE(program.output_scalar[2]);
+    EXPECT_EQ(program.input_register[static_cast<std::size_t>(shader_input::u)],
+              program.vector_code[0].b);
+    EXPECT_EQ(program.input_register[static_cast<std::size_t>(shader_input::x)],
+              SHADER_NO_REGISTER);
+
+    uint8_t green[300];
+    pixel_shader<> shader;
+    shader_inputs const inputs = {nullptr, nullptr, q16(0.25)};
+    shader.evaluate(program, inputs, sizeof(green), nullptr, green, nullptr);
+    EXPECT_EQ(green[0], 255);  // pi / 2, clamped
+    EXPECT_EQ(green[299], 255);
+
+    // A long chain stays within the registers as temporaries are reused
+    std::string chain = "v = x";
+    for (int i = 0; i < 40; ++i) {
+        chain += "\nv = v * 0.9 + y * x";
+    }
+    chain += "\nr = v";
+    ASSERT_TRUE(compile(chain.c_str(), program, error)) << error.message;
+}
+
+// Test errors name the line, column and problem
+TEST(pixel_shader_test, reports_errors_with_position) {
+    struct bad_shader {
+        char const* text;
+        uint32_t line;
+        uint32_t column;
+    };
+    bad_shader const shaders[] = {
+        {"r = u +", 1, 8},
+        {"r = 1\ng = sparkle(u)", 2, 5},
+        {"r = (u * 2", 1, 11},
+        {"r = min(u)", 1, 10},
+        {"r u", 1, 1},
+        {"r = 1 2", 1, 7},
+        {"t = 5", 1, 1},
+        {"g = 40000", 1, 5},
+        {"g = 1 + 32767.99999999", 1, 9},  // Rounds up to 32768
+        {"  b = zz", 1, 7},
+    };
+    for (std::size_t i = 0; i < sizeof(shaders) / sizeof(shaders[0]); ++i) {
+        shader_program program;
+        shader_error error;
+        EXPECT_FALSE(compile(shaders[i].text, program, error)) << i;
+        EXPECT_EQ(error.line, shaders[i].line) << i;
+        EXPECT_EQ(error.column, shaders[i].column) << i;
+        EXPECT_NE(error.message, nullptr) << i;
+    }
+
+    // More live values than vector registers: every product waits for the innermost sum
+    std::string nested = "r = ";
+    for (int i = 0; i < 20; ++i) {
+        nested += "x * " + std::to_string(i + 2) + " + (";
+    }
+    nested += "x" + std::string(20, ')');
+    shader_program program;
+    shader_error error;
+    EXPECT_FALSE(compile(nested.c_str(), program, error));
+    EXPECT_STREQ(error.message, "shader too complex");
+
+    // Nesting is bounded before it can exhaust the stack
+    std::string const deep[] = {
+        "r = " + std::string(SHADER_MAX_DEPTH, '(') + "u" + std::string(SHADER_MAX_DEPTH, ')'),
+        "r = " + std::string(10000, '-') + "u",
+        "r = " + std::string(10000, '(') + "u",
+    };
+    for (std::size_t i = 0; i < sizeof(deep) / sizeof(deep[0]); ++i) {
+        EXPECT_FALSE(compile(deep[i].c_str(), program, error)) << i;
+        EXPECT_STREQ(error.message, "expression nested too deeply") << i;
+    }
+    nested = "r = " + std::string(SHADER_MAX_DEPTH - 1, '(') + "u" +
+             std::string(SHADER_MAX_DEPTH - 1, ')');
+    EXPECT_TRUE(compile(nested.c_str(), program, error)) << error.message;
+}
+
+// Test the SIMD Q16.16 product matches the scalar one, negative operands included
+TEST(pixel_shader_test, simd_multiply_matches_scalar) {
+    std::size_t const count = 1027;
+    std::vector<int32_t> a(count);
+    std::vector<int32_t> b(count);
+    std::vector<int32_t> product(count);
+    std::srand(5);
+    for (std::size_t i = 0; i < count; ++i) {
+        a[i] = static_cast<int32_t>(static_cast<uint32_t>(std::rand()) << 8 ^
+                                    static_cast<uint32_t>(std::rand()));
+        b[i] = i % 3 == 0 ? -a[i] : static_cast<int32_t>(std::rand()) - RAND_MAX / 2;
+    }
+    a[0] = INT32_MIN;
+    b[0] = INT32_MIN;
+    a[1] = INT32_MAX;
+    b[1] = -1;
+    shader_mul_array(product.data(), a.data(), b.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(product[i], shader_apply(shader_op::mul, a[i], b[i])) << i;
+    }
+}
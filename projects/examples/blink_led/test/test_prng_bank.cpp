@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "output_bank.h"
+#include "prng_bank.h"
+
+// Test streams are reproducible per (seed, channel) and reseeding one channel leaves the rest
+TEST(prng_bank_test, streams_are_reproducible_and_independent) {
+    static prng_bank<100> a(7);
+    static prng_bank<100> b(7);
+    static prng_bank<100> other(8);
+    uint32_t same_as_other = 0;
+    for (int i = 0; i < 50; ++i) {
+        a.step();
+        b.step();
+        other.step();
+        for (std::size_t c = 0; c < 100; ++c) {
+            ASSERT_EQ(a.get(c), b.get(c));
+            ASSERT_NE(a.get(c), 0u);
+            same_as_other += a.get(c) == other.get(c);
+        }
+    }
+    EXPECT_EQ(same_as_other, 0u);
+
+    // Channel 3 restarts; every other channel continues its stream
+    prng_bank<100> fresh(9);
+    a.reseed_channel(3, 9);
+    for (std::size_t c = 0; c < 100; ++c) {
+        uint32_t const before = b.get(c);
+        uint32_t const value = a.next(c);
+        uint32_t const expected = c == 3 ? fresh.next(3) : b.next(c);
+        EXPECT_EQ(value, expected) << c;
+        EXPECT_NE(value, before);
+    }
+}
+
+// Test the SIMD passes give exactly the scalar stream, partial words included
+TEST(prng_bank_test, batch_passes_match_scalar) {
+    static prng_bank<77> batch(31);
+    static prng_bank<77> scalar(31);
+    uint32_t const thresholds[] = {0, 1, 0x40000000u, 0x80000000u, 0xC0000001u, 0xFFFFFFFFu};
+    for (int round = 0; round < 60; ++round) {
+        uint32_t const threshold = thresholds[round % 6];
+        uint32_t words[prng_bank<77>::WORD_COUNT] = {};
+        if (round % 2 == 0) {
+            batch.step();
+        } else {
+            batch.draw_bits(threshold, words);
+        }
+        for (std::size_t c = 0; c < 77; ++c) {
+            uint32_t const value = scalar.next(c);
+            ASSERT_EQ(batch.get(c), value) << round << " " << c;
+            if (round % 2 == 1) {
+                bool const bit = (words[c / 32] >> (c % 32)) & 1u;
+                ASSERT_EQ(bit, value < threshold) << round << " " << c;
+            }
+        }
+        EXPECT_EQ(words[2] >> 13, 0u);  // Channels 77-95 don't exist
+    }
+}
+
+// Test the generator passes a basic battery: bit balance, byte chi-square, serial and
+// cross-channel correlation, and run lengths
+TEST(prng_bank_test, statistics_look_uniform) {
+    std::size_t const channels = 256;
+    int const steps = 2048;
+    static prng_bank<channels> random(2024);
+    std::vector<uint32_t> samples;
+    samples.reserve(channels * steps);
+    std::vector<uint32_t> previous(random.values(), random.values() + channels);
+    double serial = 0;
+    double cross = 0;
+    for (int s = 0; s < steps; ++s) {
+        random.step();
+        uint32_t const* const values = random.values();
+        for (std::size_t c = 0; c < channels; ++c) {
+            samples.push_back(values[c]);
+            double const u = values[c] / 4294967296.0 - 0.5;
+            serial += u * (previous[c] / 4294967296.0 - 0.5);
+            cross += u * (values[(c + 1) % channels] / 4294967296.0 - 0.5);
+            previous[c] = values[c];
+        }
+    }
+    double const n = static_cast<double>(samples.size());
+
+    // Monobit: every bit position set half the time (5 sigma)
+    for (int bit = 0; bit < 32; ++bit) {
+        double ones = 0;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            ones += (samples[i] >> bit) & 1u;
+        }
+        EXPECT_LT(std::fabs(ones - n / 2), 5 * std::sqrt(n / 4)) << bit;
+    }
+
+    // Chi-square of the low and high bytes over 256 bins (255 degrees of freedom)
+    for (int shift = 0; shift <= 24; shift += 24) {
+        std::vector<double> bins(256, 0);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            bins[(samples[i] >> shift) & 0xFF] += 1;
+        }
+        double chi2 = 0;
+        double const expected = n / 256;
+        for (int k = 0; k < 256; ++k) {
+            chi2 += (bins[k] - expected) * (bins[k] - expected) / expected;
+        }
+        EXPECT_GT(chi2, 180) << shift;  // About p = 0.0002 either side
+        EXPECT_LT(chi2, 340) << shift;
+    }
+
+    // Correlation of uniform(-0.5, 0.5) pairs: variance of each product is 1/144
+    double const sigma = std::sqrt(n / 144);
+    EXPECT_LT(std::fabs(serial), 5 * sigma);
+    EXPECT_LT(std::fabs(cross), 5 * sigma);
+
+    // Runs: the top bit changes between consecutive draws half the time
+    double runs = 0;
+    for (std::size_t c = 0; c < channels; ++c) {
+        for (int s = 1; s < steps; ++s) {
+            runs += (samples[s * channels + c] >> 31) != (samples[(s - 1) * channels + c] >> 31);
+        }
+    }
+    double const pairs = channels * (steps - 1.0);
+    EXPECT_LT(std::fabs(runs - pairs / 2), 5 * std::sqrt(pairs / 4));
+}
+
+// Test sparkle passes hit the chance, flash sets exactly the drawn channels, twinkle toggles
+TEST(prng_bank_test, sparkle_controller_flashes_and_toggles) {
+    static output_bank<1000> bank;
+    sparkle_controller<1000> sparkle(bank, 5, 20, 6554, sparkle_mode::flash);  // 10%
+
+    EXPECT_TRUE(sparkle.update(0));
+    EXPECT_FALSE(sparkle.update(19));
+    std::size_t total = 0;
+    for (uint32_t t = 20; t <= 2000; t += 20) {
+        EXPECT_TRUE(sparkle.update(t));
+        total += bank.count_on();
+    }
+    double const draws = 100.0 * 1000;
+    double const p = 6554 / 65536.0;
+    EXPECT_LT(std::fabs(total - draws * p), 5 * std::sqrt(draws * p * (1 - p)));
+    EXPECT_EQ(bank.words()[31] >> 8, 0u);  // Past channel 999
+
+    // Flash replaces the bank with the drawn bits; twinkle xors them in
+    prng_bank<1000> replay(5);
+    for (int i = 0; i < 101; ++i) {
+        replay.step();
+    }
+    uint32_t drawn[output_bank<1000>::WORD_COUNT];
+    replay.draw_bits(6554u << 16, drawn);
+    std::vector<bool> before(1000);
+    for (std::size_t c = 0; c < 1000; ++c) {
+        before[c] = bank.get(c);
+    }
+    sparkle.set_mode(sparkle_mode::twinkle);
+    sparkle.pass();
+    for (std::size_t c = 0; c < 1000; ++c) {
+        bool const hit = (drawn[c / 32] >> (c % 32)) & 1u;
+        ASSERT_EQ(bank.get(c), before[c] != hit) << c;
+    }
+
+    // Zero chance leaves twinkle alone and flash dark
+    sparkle.set_chance(0);
+    std::size_t const lit = bank.count_on();
+    sparkle.pass();
+    EXPECT_EQ(bank.count_on(), lit);
+    sparkle.set_mode(sparkle_mode::flash);
+    sparkle.pass();
+    EXPECT_EQ(bank.count_on(), 0u);
+}
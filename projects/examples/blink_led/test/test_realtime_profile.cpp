@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+
+#include <cerrno>
+
+#include "realtime_profile.h"
+
+// Test an empty profile is trivially complete
+TEST(realtime_profile_test, empty_profile_is_complete) {
+    realtime_config config;
+    config.lock_memory = false;
+    config.prefault_stack_bytes = 0;
+    config.prefault_heap_bytes = 0;
+    config.cpu = -1;
+    config.fifo_priority = 0;
+
+    realtime_status const status = apply_realtime_profile(config);
+    EXPECT_TRUE(status.complete(config));
+    EXPECT_FALSE(status.memory_locked);
+    EXPECT_FALSE(status.fifo_scheduling);
+}
+
+// Test prefaulting works without privileges (the heap part needs glibc's mallopt)
+TEST(realtime_profile_test, prefault_needs_no_privileges) {
+    realtime_config config;
+    config.lock_memory = false;
+    config.prefault_stack_bytes = 64 * 1024;
+    config.prefault_heap_bytes = 1024 * 1024;
+    config.cpu = -1;
+    config.fifo_priority = 0;
+
+    realtime_status const status = apply_realtime_profile(config);
+    EXPECT_TRUE(status.stack_prefaulted);
+
+    // Sanitizer allocators refuse mallopt; probing repeats a setting the profile already made
+    if (::mallopt(M_TRIM_THRESHOLD, -1) == 0) {
+        GTEST_SKIP() << "mallopt unavailable, heap prefault not supported";
+    }
+    EXPECT_TRUE(status.heap_prefaulted);
+    EXPECT_TRUE(status.complete(config));
+}
+
+// Test impossible requests fall back cleanly with an error code
+TEST(realtime_profile_test, invalid_requests_fall_back) {
+    realtime_config config;
+    config.lock_memory = false;
+    config.prefault_stack_bytes = 0;
+    config.prefault_heap_bytes = 0;
+    config.cpu = CPU_SETSIZE - 1;  // No such CPU
+    config.fifo_priority = 1000;   // Outside SCHED_FIFO range
+
+    realtime_status const status = apply_realtime_profile(config);
+    EXPECT_FALSE(status.cpu_pinned);
+    EXPECT_NE(status.affinity_error, 0);
+    EXPECT_FALSE(status.fifo_scheduling);
+    EXPECT_EQ(status.scheduler_error, EINVAL);
+    EXPECT_FALSE(status.complete(config));
+}
+
+// Test the full profile either succeeds or reports why, and can be released
+TEST(realtime_profile_test, full_profile_reports_each_step) {
+    realtime_config config;
+    config.cpu = 0;
+    config.fifo_priority = 10;
+
+    realtime_status const status = apply_realtime_profile(config);
+    EXPECT_EQ(status.memory_locked, status.lock_error == 0);
+    EXPECT_EQ(status.cpu_pinned, status.affinity_error == 0);
+    EXPECT_EQ(status.fifo_scheduling, status.scheduler_error == 0);
+    EXPECT_TRUE(status.stack_prefaulted);
+
+    release_realtime_profile(status);
+    int policy = -1;
+    sched_param param;
+    ASSERT_EQ(pthread_getschedparam(pthread_self(), &policy, &param), 0);
+    EXPECT_EQ(policy, SCHED_OTHER);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "seqlock.h"
+
+// Test initial sequence is even (no write in progress)
+TEST(seqlock_test, initial_sequence_is_zero) {
+    seqlock lock;
+    EXPECT_EQ(lock.sequence(), 0);
+    EXPECT_EQ(lock.read_begin(), 0);
+}
+
+// Test write section makes sequence odd, then even again
+TEST(seqlock_test, write_section_toggles_parity) {
+    seqlock lock;
+
+    lock.write_begin();
+    EXPECT_EQ(lock.sequence() & 1u, 1u);
+    lock.write_end();
+    EXPECT_EQ(lock.sequence(), 2);
+}
+
+// Test non-blocking read start refuses while a write is in progress
+TEST(seqlock_test, try_read_begin_fails_during_write) {
+    seqlock lock;
+    uint32_t seq = 1;
+
+    EXPECT_TRUE(lock.try_read_begin(seq));
+    EXPECT_EQ(seq, 0);
+
+    lock.write_begin();
+    EXPECT_FALSE(lock.try_read_begin(seq));
+    lock.write_end();
+    EXPECT_TRUE(lock.try_read_begin(seq));
+    EXPECT_EQ(seq, 2);
+}
+
+// Test reader detects a write that overlapped its copy
+TEST(seqlock_test, read_retry_detects_overlapping_write) {
+    seqlock lock;
+
+    uint32_t const seq = lock.read_begin();
+    EXPECT_FALSE(lock.read_retry(seq));
+
+    lock.write_begin();
+    lock.write_end();
+    EXPECT_TRUE(lock.read_retry(seq));
+}
+
+// Test word helpers round trip
+TEST(seqlock_test, store_load_and_copy) {
+    std::atomic<uint32_t> words[3];
+    seqlock_store(words[0], 7);
+    seqlock_store(words[1], 8);
+    seqlock_store(words[2], 9);
+    EXPECT_EQ(seqlock_load(words[1]), 8);
+
+    uint32_t out[3] = {0, 0, 0};
+    seqlock_copy(words, out, 3);
+    EXPECT_EQ(out[0], 7);
+    EXPECT_EQ(out[2], 9);
+}
+
+// Test readers never accept a torn pair under concurrent writes
+TEST(seqlock_test, concurrent_readers_see_consistent_pairs) {
+    seqlock lock;
+    std::atomic<uint32_t> words[2];
+    seqlock_store(words[0], 0);
+    seqlock_store(words[1], 0);
+    std::atomic<bool> done(false);
+
+    // Writer keeps both words equal
+    std::thread writer([&]() {
+        for (uint32_t i = 1; i <= 200000; ++i) {
+            lock.write_begin();
+            seqlock_store(words[0], i);
+            seqlock_store(words[1], i);
+            lock.write_end();
+        }
+        done.store(true);
+    });
+
+    uint32_t torn = 0;
+    uint32_t reads = 0;
+    // Read at least once even if the writer finishes first (single-core hosts)
+    do {
+        uint32_t a;
+        uint32_t b;
+        uint32_t seq;
+        do {
+            seq = lock.read_begin();
+            a = seqlock_load(words[0]);
+            b = seqlock_load(words[1]);
+        } while (lock.read_retry(seq));
+        if (a != b) {
+            ++torn;
+        }
+        ++reads;
+    } while (!done.load());
+    writer.join();
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_GT(reads, 0);
+    EXPECT_EQ(lock.sequence(), 400000);
+}
@@ -0,0 +1,324 @@
+#include <gtest/gtest.h>
+#include <poll.h>
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "blink_controller.h"
+#include "fd_serial.h"
+#include "mock_hardware.h"
+#include "serial_protocol.h"
+
+/**
+ * @brief In-memory serial port with an optional line-rate model
+ *
+ * Bytes sent by the host arrive in the RX buffer at the simulated baud rate
+ * (10 bits per byte). The RX buffer has a fixed size like a UART ring
+ * (64 bytes on an Uno); bytes arriving while it is full are overrun and lost.
+ */
+struct simulated_serial {
+    simulated_serial(uint32_t baud, std::size_t rx_capacity)
+        : baud(baud), rx_capacity(rx_capacity), now_us(0), line_free_ns(0), overruns(0) {}
+
+    // Host side: queue bytes on the line behind anything already in flight
+    void send(uint8_t const* data, std::size_t length) {
+        uint64_t const byte_time_ns = 10ull * 1000000000ull / baud;
+        uint64_t done_ns = line_free_ns > now_us * 1000 ? line_free_ns : now_us * 1000;
+        for (std::size_t i = 0; i < length; ++i) {
+            done_ns += byte_time_ns;
+            in_flight.push_back(std::make_pair(done_ns, data[i]));
+        }
+        line_free_ns = done_ns;
+    }
+
+    // Advance simulated time, delivering bytes that finished on the line
+    void advance_to(uint64_t time_us) {
+        now_us = time_us;
+        while (!in_flight.empty() && in_flight.front().first <= now_us * 1000) {
+            if (rx.size() < rx_capacity) {
+                rx.push_back(in_flight.front().second);
+            } else {
+                ++overruns;
+            }
+            in_flight.pop_front();
+        }
+    }
+
+    bool idle() const { return in_flight.empty() && rx.empty(); }
+
+    // Board side (HardwareSerial-like)
+    int available() const { return static_cast<int>(rx.size()); }
+    int read() {
+        if (rx.empty()) {
+            return -1;
+        }
+        uint8_t const byte = rx.front();
+        rx.pop_front();
+        return byte;
+    }
+    std::size_t write(uint8_t const* data, std::size_t length) {
+        tx.insert(tx.end(), data, data + length);
+        return length;
+    }
+
+    uint32_t baud;
+    std::size_t rx_capacity;
+    uint64_t now_us;
+    uint64_t line_free_ns;
+    uint32_t overruns;
+    std::deque<std::pair<uint64_t, uint8_t> > in_flight;
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+};
+
+typedef blink_controller<mock_pin> controller_t;
+
+// Host-side helpers
+static std::vector<uint8_t> set_durations_frame(uint8_t seq, uint8_t channel, uint32_t on,
+                                                uint32_t off) {
+    serial_frame_builder<> builder;
+    builder.begin(serial_message::set_durations, seq, channel);
+    builder.put_u32(on);
+    builder.put_u32(off);
+    uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+    std::size_t const length = builder.finish(wire, sizeof(wire));
+    return std::vector<uint8_t>(wire, wire + length);
+}
+
+static std::vector<uint8_t> simple_frame(serial_message type, uint8_t seq, uint8_t channel) {
+    serial_frame_builder<> builder;
+    builder.begin(type, seq, channel);
+    uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+    std::size_t const length = builder.finish(wire, sizeof(wire));
+    return std::vector<uint8_t>(wire, wire + length);
+}
+
+// Parse every reply frame in a byte stream
+static std::vector<serial_frame> parse_replies(std::vector<uint8_t> const& bytes,
+                                               std::vector<std::vector<uint8_t> >& payloads) {
+    serial_parser<> parser;
+    std::vector<serial_frame> frames;
+    serial_frame frame;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        if (parser.push(bytes[i], frame)) {
+            payloads.push_back(
+                std::vector<uint8_t>(frame.payload, frame.payload + frame.payload_size));
+            frames.push_back(frame);
+        }
+    }
+    return frames;
+}
+
+struct serial_protocol_test : public ::testing::Test {
+   protected:
+    serial_protocol_test()
+        : serial(115200, 64),
+          controllers{controller_t(pins[0], 100, 100), controller_t(pins[1], 100, 100)},
+          server(controllers, 2, serial) {}
+
+    void deliver(std::vector<uint8_t> const& bytes, uint32_t now_ms) {
+        for (std::size_t i = 0; i < bytes.size(); ++i) {
+            server.feed(bytes[i], now_ms);
+        }
+    }
+
+    simulated_serial serial;
+    mock_pin pins[2];
+    controller_t controllers[2];
+    serial_command_server<controller_t, simulated_serial> server;
+};
+
+// Test set_durations reaches the addressed controller and is acknowledged
+TEST_F(serial_protocol_test, set_durations_applies_and_acks) {
+    deliver(set_durations_frame(7, 1, 250, 750), 0);
+
+    EXPECT_EQ(controllers[1].get_next_on_duration(), 250);
+    EXPECT_EQ(controllers[1].get_next_off_duration(), 750);
+    EXPECT_EQ(controllers[0].get_next_on_duration(), 100);
+
+    std::vector<std::vector<uint8_t> > payloads;
+    std::vector<serial_frame> replies = parse_replies(serial.tx, payloads);
+    ASSERT_EQ(replies.size(), 1u);
+    EXPECT_EQ(replies[0].type, serial_message::ack);
+    EXPECT_EQ(replies[0].seq, 7);
+    EXPECT_EQ(replies[0].channel, 1);
+    ASSERT_EQ(payloads[0].size(), 1u);
+    EXPECT_EQ(payloads[0][0], static_cast<uint8_t>(serial_status::ok));
+}
+
+// Test shift_phase with a negative delta and trigger restart
+TEST_F(serial_protocol_test, shift_phase_and_trigger) {
+    serial_frame_builder<> builder;
+    builder.begin(serial_message::shift_phase, 1, 0);
+    builder.put_u32(static_cast<uint32_t>(-30));
+    uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+    std::size_t const length = builder.finish(wire, sizeof(wire));
+    deliver(std::vector<uint8_t>(wire, wire + length), 0);
+    EXPECT_EQ(controllers[0].get_phase_adjust(), -30);
+
+    deliver(simple_frame(serial_message::trigger, 2, 0), 5000);
+    EXPECT_EQ(controllers[0].get_phase_adjust(), 0);
+    EXPECT_EQ(controllers[0].time_until_toggle(5000), 100);
+}
+
+// Test query returns on state, durations and time to the next edge
+TEST_F(serial_protocol_test, query_reports_state) {
+    controllers[0].update(100);  // ON until 200
+    deliver(simple_frame(serial_message::query, 9, 0), 150);
+
+    std::vector<std::vector<uint8_t> > payloads;
+    std::vector<serial_frame> replies = parse_replies(serial.tx, payloads);
+    ASSERT_EQ(replies.size(), 1u);
+    EXPECT_EQ(replies[0].type, serial_message::state);
+    ASSERT_EQ(payloads[0].size(), 13u);
+    serial_frame view = replies[0];
+    view.payload = payloads[0].data();
+    EXPECT_EQ(view.payload[0], 1);
+    EXPECT_EQ(view.read_u32(1), 100u);
+    EXPECT_EQ(view.read_u32(5), 100u);
+    EXPECT_EQ(view.read_u32(9), 50u);
+}
+
+// Test error statuses for bad channel, bad length and unknown commands
+TEST_F(serial_protocol_test, error_statuses) {
+    deliver(set_durations_frame(1, 5, 10, 10), 0);
+    deliver(simple_frame(serial_message::set_durations, 2, 0), 0);
+    deliver(simple_frame(static_cast<serial_message>(0x55), 3, 0), 0);
+
+    std::vector<std::vector<uint8_t> > payloads;
+    std::vector<serial_frame> replies = parse_replies(serial.tx, payloads);
+    ASSERT_EQ(replies.size(), 3u);
+    EXPECT_EQ(payloads[0][0], static_cast<uint8_t>(serial_status::bad_channel));
+    EXPECT_EQ(payloads[1][0], static_cast<uint8_t>(serial_status::bad_length));
+    EXPECT_EQ(payloads[2][0], static_cast<uint8_t>(serial_status::unknown_command));
+    EXPECT_EQ(controllers[0].get_next_on_duration(), 100);
+}
+
+// Test corrupted frames are dropped silently and the parser resyncs
+TEST_F(serial_protocol_test, corrupted_frames_dropped_then_resync) {
+    std::vector<uint8_t> bad = set_durations_frame(1, 0, 500, 500);
+    bad[4] ^= 0x10;
+    deliver(bad, 0);
+
+    uint8_t const garbage[] = {0x13, 0x37, 0xFF, 0x00, 0x02};
+    deliver(std::vector<uint8_t>(garbage, garbage + sizeof(garbage)), 0);
+    deliver(std::vector<uint8_t>(1, 0), 0);
+
+    deliver(set_durations_frame(2, 0, 300, 300), 0);
+
+    EXPECT_EQ(controllers[0].get_next_on_duration(), 300);
+    EXPECT_EQ(server.get_command_count(), 1u);
+    EXPECT_EQ(server.get_parser().get_crc_errors(), 1u);
+    EXPECT_GE(server.get_parser().get_framing_errors(), 1u);
+}
+
+// Run back-to-back commands over a simulated line, polling like an Arduino loop
+static void run_line(uint32_t baud, uint32_t loop_period_us, std::size_t rx_capacity,
+                     uint32_t commands, uint32_t& overruns, double& commands_per_sec,
+                     uint32_t& handled) {
+    simulated_serial line(baud, rx_capacity);
+    mock_pin pins[4];
+    controller_t controllers[4] = {controller_t(pins[0], 10, 10), controller_t(pins[1], 10, 10),
+                                   controller_t(pins[2], 10, 10), controller_t(pins[3], 10, 10)};
+    serial_command_server<controller_t, simulated_serial> server(controllers, 4, line);
+
+    std::size_t wire_bytes = 0;
+    for (uint32_t i = 0; i < commands; ++i) {
+        std::vector<uint8_t> const frame =
+            set_durations_frame(static_cast<uint8_t>(i), static_cast<uint8_t>(i % 4), 1000 + i,
+                                2000 + i);
+        wire_bytes += frame.size();
+        line.send(frame.data(), frame.size());
+    }
+
+    uint64_t now_us = 0;
+    while (!line.idle()) {
+        now_us += loop_period_us;
+        line.advance_to(now_us);
+        server.poll(static_cast<uint32_t>(now_us / 1000));
+        for (std::size_t c = 0; c < 4; ++c) {
+            controllers[c].update(static_cast<uint32_t>(now_us / 1000));
+        }
+    }
+
+    overruns = line.overruns;
+    handled = server.get_command_count();
+    commands_per_sec = commands * 1e6 / static_cast<double>(now_us);
+
+    // The line itself bounds throughput: 10 bits per byte
+    double const line_limit = baud / 10.0 / (static_cast<double>(wire_bytes) / commands);
+    EXPECT_GT(commands_per_sec, 0.95 * line_limit);
+    EXPECT_LE(commands_per_sec, 1.01 * line_limit);
+}
+
+// Test 115200 baud with a 1 ms loop and a 64-byte UART buffer keeps up
+TEST(serial_protocol_throughput, baud_115200_keeps_line_rate) {
+    uint32_t overruns = 0;
+    uint32_t handled = 0;
+    double rate = 0.0;
+    run_line(115200, 1000, 64, 2000, overruns, rate, handled);
+    EXPECT_EQ(overruns, 0u);
+    EXPECT_EQ(handled, 2000u);
+    EXPECT_GT(rate, 750.0);  // 15-byte frames: ~768 commands/s
+}
+
+// Test 1 Mbaud needs a faster loop than 64 bytes per poll allows
+TEST(serial_protocol_throughput, one_megabaud_requires_sub_millisecond_polling) {
+    uint32_t overruns = 0;
+    uint32_t handled = 0;
+    double rate = 0.0;
+
+    // 100 bytes arrive per 1 ms loop: the 64-byte buffer overruns
+    run_line(1000000, 1000, 64, 2000, overruns, rate, handled);
+    EXPECT_GT(overruns, 0u);
+    EXPECT_LT(handled, 2000u);
+
+    // Polling every 500 us (50 bytes) keeps every command
+    run_line(1000000, 500, 64, 2000, overruns, rate, handled);
+    EXPECT_EQ(overruns, 0u);
+    EXPECT_EQ(handled, 2000u);
+    EXPECT_GT(rate, 6500.0);  // ~6667 commands/s
+}
+
+// Test commands and replies across a real pty (virtual serial cable)
+TEST(serial_protocol_pty, round_trip_over_pty) {
+    pty_pair pty;
+    if (!pty.open()) {
+        GTEST_SKIP() << "no pty available";
+    }
+    fd_serial board_side(pty.slave_fd);
+    fd_serial host_side(pty.master_fd);
+    mock_pin pin;
+    controller_t controller(pin, 100, 100);
+    serial_command_server<controller_t, fd_serial> server(&controller, 1, board_side);
+
+    std::vector<uint8_t> const command = set_durations_frame(42, 0, 123, 456);
+    ASSERT_EQ(host_side.write(command.data(), command.size()), command.size());
+
+    // Board loop: poll until the command lands
+    for (int i = 0; i < 200 && server.get_command_count() == 0; ++i) {
+        pollfd pfd = {pty.slave_fd, POLLIN, 0};
+        ::poll(&pfd, 1, 10);
+        server.poll(0);
+    }
+    ASSERT_EQ(server.get_command_count(), 1u);
+    EXPECT_EQ(controller.get_next_on_duration(), 123);
+    EXPECT_EQ(controller.get_next_off_duration(), 456);
+
+    // Host reads the ack
+    serial_parser<> parser;
+    serial_frame reply;
+    bool got_reply = false;
+    for (int i = 0; i < 200 && !got_reply; ++i) {
+        pollfd pfd = {pty.master_fd, POLLIN, 0};
+        ::poll(&pfd, 1, 10);
+        while (!got_reply && host_side.available() > 0) {
+            got_reply = parser.push(static_cast<uint8_t>(host_side.read()), reply);
+        }
+    }
+    ASSERT_TRUE(got_reply);
+    EXPECT_EQ(reply.type, serial_message::ack);
+    EXPECT_EQ(reply.seq, 42);
+}
@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "output_bank.h"
+#include "shm_frame.h"
+
+struct shm_frame_test : public ::testing::Test {
+   protected:
+    void SetUp() override { name = "/hw2_shm_frame_test_" + std::to_string(::getpid()); }
+    void TearDown() override { shm_frame_writer::unlink(name.c_str()); }
+
+    std::string name;
+};
+
+// Test reader rejects a missing region
+TEST_F(shm_frame_test, open_missing_region_fails) {
+    shm_frame_reader reader;
+    EXPECT_FALSE(reader.open(name.c_str()));
+    EXPECT_FALSE(reader.is_open());
+}
+
+// Test reader rejects a region that is not a frame region
+TEST_F(shm_frame_test, open_foreign_region_fails) {
+    int const fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::ftruncate(fd, 4096), 0);
+    ::close(fd);
+
+    shm_frame_reader reader;
+    EXPECT_FALSE(reader.open(name.c_str()));
+}
+
+// Test reader rejects a region until its magic is published
+TEST_F(shm_frame_test, open_waits_for_magic) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 8));
+
+    // Simulate a writer between filling the header and publishing magic
+    int const fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    std::size_t const size = shm_frame_header::region_size(8);
+    void* const base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(base, MAP_FAILED);
+    shm_frame_header* const header = static_cast<shm_frame_header*>(base);
+    header->magic.store(0, std::memory_order_relaxed);
+
+    shm_frame_reader reader;
+    EXPECT_FALSE(reader.open(name.c_str()));
+    header->magic.store(shm_frame_header::MAGIC, std::memory_order_release);
+    EXPECT_TRUE(reader.open(name.c_str()));
+    EXPECT_EQ(reader.get_channel_count(), 8);
+    ::munmap(base, size);
+}
+
+// Test round trip of one frame
+TEST_F(shm_frame_test, publish_and_read_frame) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 40));
+    EXPECT_EQ(writer.get_word_count(), 2);
+
+    shm_frame_reader reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+    EXPECT_EQ(reader.get_channel_count(), 40);
+    EXPECT_EQ(reader.get_word_count(), 2);
+
+    // No frame yet
+    uint32_t words[2] = {1, 1};
+    shm_frame_info info;
+    reader.read(words, info);
+    EXPECT_EQ(info.frame, 0);
+    EXPECT_EQ(words[0], 0);
+
+    output_bank<40> bank;
+    bank.set(1, true);
+    bank.set(39, true);
+    writer.publish(bank.words(), 1234);
+
+    reader.read(words, info);
+    EXPECT_EQ(info.frame, 1);
+    EXPECT_EQ(info.time_ms, 1234);
+    EXPECT_EQ(words[0], bank.words()[0]);
+    EXPECT_EQ(words[1], bank.words()[1]);
+    EXPECT_EQ(writer.get_frame_count(), 1);
+}
+
+// Test reader sequence advances twice per frame
+TEST_F(shm_frame_test, reader_sequence_tracks_frames) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 8));
+    shm_frame_reader reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+
+    uint32_t const before = reader.get_sequence();
+    uint32_t const word = 0xff;
+    writer.publish(&word, 1);
+    writer.publish(&word, 2);
+    EXPECT_EQ(reader.get_sequence(), before + 4);
+}
+
+// Test try_read backs off while the writer is mid-frame
+TEST_F(shm_frame_test, try_read_fails_during_write) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 8));
+
+    // Simulate a crashed/paused writer holding the lock via a second RW mapping
+    int const fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    std::size_t const size = shm_frame_header::region_size(8);
+    void* const base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(base, MAP_FAILED);
+    static_cast<shm_frame_header*>(base)->lock.write_begin();
+
+    shm_frame_reader reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+    uint32_t word = 0;
+    shm_frame_info info;
+    EXPECT_FALSE(reader.try_read(&word, info));
+
+    static_cast<shm_frame_header*>(base)->lock.write_end();
+    EXPECT_TRUE(reader.try_read(&word, info));
+    ::munmap(base, size);
+}
+
+// Test writer re-creation and close
+TEST_F(shm_frame_test, create_close_and_recreate) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 8));
+    EXPECT_TRUE(writer.is_open());
+    writer.close();
+    EXPECT_FALSE(writer.is_open());
+    EXPECT_EQ(writer.get_word_count(), 0);
+
+    ASSERT_TRUE(writer.create(name.c_str(), 100));
+    shm_frame_reader reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+    EXPECT_EQ(reader.get_channel_count(), 100);
+    reader.close();
+    EXPECT_FALSE(reader.is_open());
+}
+
+// Test a restarted, smaller writer leaves mapped readers intact; they reopen to follow it
+TEST_F(shm_frame_test, recreate_does_not_resize_mapped_region) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 1000));
+    output_bank<1000> bank;
+    bank.set(999, true);
+    writer.publish(bank.words(), 10);
+    shm_frame_reader old_reader;
+    ASSERT_TRUE(old_reader.open(name.c_str()));
+
+    ASSERT_TRUE(writer.create(name.c_str(), 8));
+    uint32_t const word = 0x5;
+    writer.publish(&word, 20);
+
+    // The old mapping still holds the whole old frame (no SIGBUS, no reset)
+    uint32_t words[output_bank<1000>::WORD_COUNT] = {};
+    shm_frame_info info;
+    old_reader.read(words, info);
+    EXPECT_EQ(info.frame, 1);
+    EXPECT_EQ(info.time_ms, 10);
+    EXPECT_EQ(words[31], bank.words()[31]);
+
+    ASSERT_TRUE(old_reader.open(name.c_str()));
+    EXPECT_EQ(old_reader.get_channel_count(), 8);
+    old_reader.read(words, info);
+    EXPECT_EQ(info.time_ms, 20);
+    EXPECT_EQ(words[0], word);
+}
+
+// Test retrying open() follows a restarted writer and keeps the old mapping meanwhile
+TEST_F(shm_frame_test, reopen_follows_writer_restart) {
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), 8));
+    uint32_t const word = 0x1;
+    writer.publish(&word, 10);
+    shm_frame_reader reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+
+    // Writer exits: the retry fails and the stale mapping stays readable
+    writer.close();
+    ASSERT_TRUE(shm_frame_writer::unlink(name.c_str()));
+    EXPECT_FALSE(reader.open(name.c_str()));
+    ASSERT_TRUE(reader.is_open());
+    shm_frame_info info;
+    uint32_t words[2] = {};
+    reader.read(words, info);
+    EXPECT_EQ(info.time_ms, 10);
+    EXPECT_EQ(words[0], 0x1);
+
+    // Writer restarts with more channels: the next retry maps the new region
+    ASSERT_TRUE(writer.create(name.c_str(), 40));
+    uint32_t const restarted[2] = {0x2, 0x80};
+    writer.publish(restarted, 20);
+    ASSERT_TRUE(reader.open(name.c_str()));
+    EXPECT_EQ(reader.get_channel_count(), 40);
+    reader.read(words, info);
+    EXPECT_EQ(info.frame, 1);
+    EXPECT_EQ(info.time_ms, 20);
+    EXPECT_EQ(words[0], 0x2);
+    EXPECT_EQ(words[1], 0x80);
+}
+
+// Test invalid names fail cleanly
+TEST_F(shm_frame_test, invalid_name_fails) {
+    shm_frame_writer writer;
+    EXPECT_FALSE(writer.create("/bad/name", 8));
+    EXPECT_FALSE(writer.is_open());
+}
+
+// Throughput test: a reader never sees a torn frame while the writer publishes flat out
+TEST_F(shm_frame_test, concurrent_throughput_without_torn_frames) {
+    static uint32_t const CHANNELS = 4096;
+    static uint32_t const FRAMES = 20000;
+    shm_frame_writer writer;
+    ASSERT_TRUE(writer.create(name.c_str(), CHANNELS));
+    shm_frame_reader reader;
+    ASSERT_TRUE(reader.open(name.c_str()));
+    std::atomic<bool> done(false);
+
+    // Every channel word carries the frame number
+    std::thread publisher([&]() {
+        std::vector<uint32_t> words(CHANNELS / 32);
+        for (uint32_t f = 1; f <= FRAMES; ++f) {
+            for (std::size_t i = 0; i < words.size(); ++i) {
+                words[i] = f;
+            }
+            writer.publish(words.data(), f);
+        }
+        done.store(true);
+    });
+
+    std::vector<uint32_t> words(reader.get_word_count());
+    uint32_t torn = 0;
+    uint32_t reads = 0;
+    shm_frame_info info;
+    // Read at least once even if the writer finishes first (single-core hosts)
+    do {
+        reader.read(words.data(), info);
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            if (words[i] != info.time_ms) {
+                ++torn;
+            }
+        }
+        if (info.frame != info.time_ms) {
+            ++torn;
+        }
+        ++reads;
+    } while (!done.load());
+    publisher.join();
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_GT(reads, 0);
+    reader.read(words.data(), info);
+    EXPECT_EQ(info.frame, FRAMES);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "blink_controller.h"
+#include "mock_hardware.h"
+#include "show_clock.h"
+
+// Test show time follows wall time at the set rate
+TEST(show_clock_test, maps_wall_time_at_rate) {
+    mock_timer timer;
+    timer.set_time(5000);
+    show_clock<mock_timer> clock(timer);
+    EXPECT_EQ(clock.millis(), 0u);
+
+    timer.advance(1000);
+    EXPECT_EQ(clock.millis(), 1000u);
+
+    clock.set_rate(show_rate(8, 1));
+    timer.advance(100);
+    EXPECT_EQ(clock.millis(), 1800u);
+
+    clock.set_rate(show_rate(1, 4));
+    timer.advance(3);
+    EXPECT_EQ(clock.millis(), 1800u);  // 0.75 ms
+    timer.advance(1);
+    EXPECT_EQ(clock.millis(), 1801u);
+
+    clock.set_rate(show_rate(1000, 1));
+    timer.advance(60);
+    EXPECT_EQ(clock.millis(), 61801u);
+}
+
+// Test rate changes neither jump show time nor drop the fractional millisecond
+TEST(show_clock_test, rate_changes_are_continuous) {
+    mock_timer timer;
+    show_clock<mock_timer> clock(timer);
+
+    // 0.25x for 2 ms, then 0.5x for 1 ms: 0.5 + 0.5 = 1 ms exactly
+    clock.set_rate(show_rate(1, 4));
+    timer.advance(2);
+    clock.set_rate(show_rate(1, 2));
+    timer.advance(1);
+    EXPECT_EQ(clock.millis(), 1u);
+
+    // Random rates at random times: never a jump at the change, never backwards
+    uint32_t const rates[] = {show_rate(1, 4), show_rate(1, 2), SHOW_RATE_ONE, show_rate(3, 2),
+                              show_rate(8, 1), show_rate(1000, 1)};
+    std::srand(3);
+    uint32_t previous = clock.millis();
+    for (int i = 0; i < 2000; ++i) {
+        timer.advance(static_cast<uint32_t>(std::rand() % 7));
+        uint32_t const before = clock.millis();
+        ASSERT_GE(before, previous);
+        clock.set_rate(rates[std::rand() % 6]);
+        ASSERT_EQ(clock.millis(), before);
+        previous = before;
+    }
+}
+
+// Test pause, seek and the show-to-wall sleep conversion
+TEST(show_clock_test, pause_seek_and_wall_delay) {
+    mock_timer timer;
+    show_clock<mock_timer> clock(timer);
+    timer.advance(10);
+    clock.set_rate(0);
+    timer.advance(500);
+    EXPECT_EQ(clock.millis(), 10u);
+    EXPECT_EQ(clock.wall_delay_ms(1), UINT32_MAX);
+
+    clock.seek(90000);
+    clock.set_rate(show_rate(1, 4));
+    EXPECT_EQ(clock.millis(), 90000u);
+    EXPECT_EQ(clock.wall_delay_ms(100), 400u);
+    timer.advance(1);  // 0.25 ms in: 99.75 show ms left
+    EXPECT_EQ(clock.wall_delay_ms(100), 399u);
+    EXPECT_EQ(wall_delay_ms(clock, 100), 399u);
+    EXPECT_EQ(wall_delay_ms(timer, 100), 100u);  // Plain timers: identity
+
+    clock.set_rate(show_rate(8, 1));
+    EXPECT_EQ(clock.wall_delay_ms(100), 13u);  // 12.5 rounded up
+    EXPECT_EQ(clock.wall_delay_ms(0), 0u);
+}
+
+// Test a controller fast-forwarded once per wall millisecond at 1000x lands on
+// the same state as one updated every show millisecond
+TEST(show_clock_test, analytic_controller_at_1000x_matches_per_millisecond) {
+    mock_timer timer;
+    show_clock<mock_timer> clock(timer);
+    clock.set_rate(show_rate(1000, 1));
+    mock_pin pin;
+    mock_pin reference_pin;
+    blink_controller<mock_pin> controller(pin, 130, 70);
+    blink_controller<mock_pin> reference(reference_pin, 130, 70);
+    controller.update(0);
+    reference.update(0);
+
+    uint32_t show_ms = 0;
+    for (uint32_t wall = 1; wall <= 600; ++wall) {
+        timer.advance(1);
+        if (wall == 300) {  // Retimed mid-show
+            controller.set_durations(1, 997);
+            reference.set_durations(1, 997);
+        }
+        uint32_t const now = clock.millis();
+        for (++show_ms; show_ms <= now; ++show_ms) {
+            reference.update(show_ms);
+        }
+        --show_ms;
+        controller.fast_forward(now);
+        ASSERT_EQ(controller.is_on(), reference.is_on()) << now;
+        ASSERT_EQ(pin.get_state(), reference_pin.get_state()) << now;
+        ASSERT_EQ(controller.get_last_toggle_time(), reference.get_last_toggle_time()) << now;
+    }
+    EXPECT_EQ(show_ms, 600000u);
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "blink_controller.h"
+#include "mock_hardware.h"
+#include "show_playback.h"
+
+typedef blink_controller<mock_pin> controller;
+
+static std::size_t const CHANNELS = 48;
+static uint32_t const SHOW_MS = 60000;
+
+// Random show: retimes (zero durations included), phase shifts and restarts,
+// several on one channel in the same millisecond, some at time 0
+static std::vector<show_event> make_events() {
+    std::vector<show_event> events;
+    std::srand(2024);
+    uint32_t time = 0;
+    while (time < SHOW_MS) {
+        show_event event;
+        event.time_ms = time;
+        event.channel = static_cast<uint32_t>(std::rand() % CHANNELS);
+        int const kind = std::rand() % 10;
+        if (kind < 6) {
+            event.type = show_event_type::set_durations;
+            event.a = static_cast<uint32_t>(std::rand() % 400);
+            event.b = static_cast<uint32_t>(std::rand() % 400);
+        } else if (kind < 9) {
+            event.type = show_event_type::shift_phase;
+            event.a = static_cast<uint32_t>(std::rand() % 600 - 300);
+            event.b = 0;
+        } else {
+            event.type = show_event_type::restart;
+            event.a = event.b = 0;
+        }
+        events.push_back(event);
+        time += static_cast<uint32_t>(std::rand() % 3 == 0 ? 0 : std::rand() % 120);
+    }
+    return events;
+}
+
+struct show_rig {
+    explicit show_rig(std::size_t count) : pins(count) {
+        controllers.reserve(count);
+        for (std::size_t c = 0; c < count; ++c) {
+            controllers.push_back(controller(pins[c], 50 + 10 * c, 70 + 3 * c));
+        }
+    }
+    std::vector<mock_pin> pins;
+    std::vector<controller> controllers;
+};
+
+// One channel's observable state
+struct channel_state {
+    bool on;
+    bool pin;
+    uint32_t last_toggle;
+    uint32_t on_ms;
+    uint32_t off_ms;
+    int32_t phase;
+
+    bool operator==(channel_state const& other) const {
+        return on == other.on && pin == other.pin && last_toggle == other.last_toggle &&
+               on_ms == other.on_ms && off_ms == other.off_ms && phase == other.phase;
+    }
+};
+
+static std::vector<channel_state> observe(show_rig const& rig) {
+    std::vector<channel_state> states;
+    for (std::size_t c = 0; c < rig.controllers.size(); ++c) {
+        controller const& ctl = rig.controllers[c];
+        channel_state const s = {ctl.is_on(),          rig.pins[c].get_state(),
+                                 ctl.get_last_toggle_time(), ctl.get_on_duration(),
+                                 ctl.get_off_duration(), ctl.get_phase_adjust()};
+        states.push_back(s);
+    }
+    return states;
+}
+
+// Reference: the per-millisecond loop, events first, then every update
+static std::vector<std::vector<channel_state> > replay(std::vector<show_event> const& events) {
+    show_rig rig(CHANNELS);
+    std::vector<std::vector<channel_state> > states;
+    std::size_t next = 0;
+    for (uint32_t now = 0; now <= SHOW_MS; ++now) {
+        for (; next < events.size() && events[next].time_ms == now; ++next) {
+            controller& ctl = rig.controllers[events[next].channel];
+            switch (events[next].type) {
+                case show_event_type::set_durations:
+                    ctl.set_durations(events[next].a, events[next].b);
+                    break;
+                case show_event_type::shift_phase:
+                    ctl.shift_phase(static_cast<int32_t>(events[next].a));
+                    break;
+                case show_event_type::restart:
+                    ctl.restart(now);
+                    break;
+            }
+        }
+        for (std::size_t c = 0; c < CHANNELS; ++c) {
+            rig.controllers[c].update(now);
+        }
+        states.push_back(observe(rig));
+    }
+    return states;
+}
+
+// Test seeks anywhere, in any order, land on the per-millisecond state
+TEST(show_playback_test, seek_matches_per_millisecond_playback) {
+    std::vector<show_event> const events = make_events();
+    std::vector<std::vector<channel_state> > const expected = replay(events);
+
+    show_rig rig(CHANNELS);
+    show_playback<controller> show(rig.controllers.data(), CHANNELS);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        ASSERT_TRUE(show.add_event(events[i]));
+    }
+    ASSERT_TRUE(show.prepare(SHOW_MS, 5000, 1 << 20));
+    EXPECT_EQ(show.get_checkpoint_count(), 13u);
+    EXPECT_TRUE(observe(rig) == expected[0]);
+
+    std::srand(9);
+    for (int s = 0; s < 400; ++s) {
+        uint32_t const t = s < 3 ? s * 5000 : static_cast<uint32_t>(std::rand() % (SHOW_MS + 1));
+        ASSERT_TRUE(show.seek(t));
+        ASSERT_TRUE(observe(rig) == expected[t]) << "seek to " << t;
+    }
+}
+
+// Test advance() plays forward in large steps and seeks back when time goes backwards
+TEST(show_playback_test, advance_steps_and_rewinds) {
+    std::vector<show_event> const events = make_events();
+    std::vector<std::vector<channel_state> > const expected = replay(events);
+
+    show_rig rig(CHANNELS);
+    show_playback<controller> show(rig.controllers.data(), CHANNELS);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        show.add_event(events[i]);
+    }
+    EXPECT_FALSE(show.advance(10));  // Not prepared
+    ASSERT_TRUE(show.prepare(SHOW_MS, 7000, 1 << 20));
+    for (uint32_t t = 0; t <= SHOW_MS; t += 997) {  // ~1000x rehearsal speed
+        ASSERT_TRUE(show.advance(t));
+        ASSERT_TRUE(observe(rig) == expected[t]) << t;
+    }
+    ASSERT_TRUE(show.advance(1234));  // Scrubbed back
+    EXPECT_EQ(show.get_time(), 1234u);
+    EXPECT_TRUE(observe(rig) == expected[1234]);
+}
+
+// Test events added after a prepare() replay from the initial state, not over the old run
+TEST(show_playback_test, prepare_again_starts_from_initial_state) {
+    std::vector<show_event> const events = make_events();
+    std::vector<std::vector<channel_state> > const expected = replay(events);
+
+    show_rig rig(CHANNELS);
+    show_playback<controller> show(rig.controllers.data(), CHANNELS);
+    std::size_t const half = events.size() / 2;
+    for (std::size_t i = 0; i < half; ++i) {
+        ASSERT_TRUE(show.add_event(events[i]));
+    }
+    ASSERT_TRUE(show.prepare(SHOW_MS, 5000, 1 << 20));
+    ASSERT_TRUE(show.seek(SHOW_MS / 2));  // Controllers left mid-show
+    for (std::size_t i = half; i < events.size(); ++i) {
+        ASSERT_TRUE(show.add_event(events[i]));
+    }
+    EXPECT_FALSE(show.seek(0));  // Stale until prepared again
+    ASSERT_TRUE(show.prepare(SHOW_MS, 5000, 1 << 20));
+    EXPECT_TRUE(observe(rig) == expected[0]);
+    for (uint32_t t = 0; t <= SHOW_MS; t += 1499) {
+        ASSERT_TRUE(show.seek(t));
+        ASSERT_TRUE(observe(rig) == expected[t]) << t;
+    }
+
+    // A phase shift at time 0 is applied once however often the show is prepared
+    show_rig single(1);
+    show_playback<controller> shifted(single.controllers.data(), 1);
+    show_event const shift = {0, 0, show_event_type::shift_phase, 30, 0};
+    ASSERT_TRUE(shifted.add_event(shift));
+    ASSERT_TRUE(shifted.prepare(1000, 100, 1 << 10));
+    uint32_t const first_edge = single.controllers[0].get_last_toggle_time();
+    ASSERT_TRUE(shifted.seek(500));
+    uint32_t const edge_at_500 = single.controllers[0].get_last_toggle_time();
+    show_event const late = {900, 0, show_event_type::restart, 0, 0};
+    ASSERT_TRUE(shifted.add_event(late));
+    ASSERT_TRUE(shifted.prepare(1000, 100, 1 << 10));
+    EXPECT_EQ(single.controllers[0].get_last_toggle_time(), first_edge);
+    ASSERT_TRUE(shifted.seek(500));
+    EXPECT_EQ(single.controllers[0].get_last_toggle_time(), edge_at_500);
+}
+
+// Test the checkpoint interval widens to fit the memory budget
+TEST(show_playback_test, interval_fits_memory_budget) {
+    show_rig rig(4);
+    show_playback<controller> show(rig.controllers.data(), 4);
+    std::size_t const checkpoint = 4 * sizeof(controller::snapshot);
+
+    ASSERT_TRUE(show.prepare(60000, 1000, 7 * checkpoint));
+    EXPECT_EQ(show.get_checkpoint_interval(), 10000u);
+    EXPECT_EQ(show.get_checkpoint_count(), 7u);
+    EXPECT_LE(show.get_checkpoint_bytes(), 7 * checkpoint);
+
+    ASSERT_TRUE(show.prepare(60000, 1000, checkpoint));  // Time 0 only
+    EXPECT_EQ(show.get_checkpoint_count(), 1u);
+    EXPECT_FALSE(show.prepare(60000, 1000, checkpoint - 1));
+
+    // The longest show still fits one or two checkpoints without wrapping the interval
+    ASSERT_TRUE(show.prepare(UINT32_MAX, 1000, checkpoint));
+    EXPECT_EQ(show.get_checkpoint_interval(), UINT32_MAX);
+    EXPECT_EQ(show.get_checkpoint_count(), 1u);
+    EXPECT_TRUE(show.seek(1000));
+    ASSERT_TRUE(show.prepare(UINT32_MAX, 1000, 2 * checkpoint));
+    EXPECT_EQ(show.get_checkpoint_count(), 2u);
+}
+
+// Test events must be in time order and on existing channels
+TEST(show_playback_test, rejects_bad_events) {
+    show_rig rig(2);
+    show_playback<controller> show(rig.controllers.data(), 2);
+    show_event event = {100, 1, show_event_type::restart, 0, 0};
+    EXPECT_TRUE(show.add_event(event));
+    event.time_ms = 99;
+    EXPECT_FALSE(show.add_event(event));
+    event.time_ms = 100;
+    event.channel = 2;
+    EXPECT_FALSE(show.add_event(event));
+    EXPECT_EQ(show.get_event_count(), 1u);
+    EXPECT_FALSE(show.seek(0));
+}
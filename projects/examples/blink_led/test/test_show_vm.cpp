@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "fade_controller.h"
+#include "mock_hardware.h"
+#include "show_script.h"
+#include "show_vm.h"
+
+typedef fade_controller<mock_level_pin> fade;
+typedef show_vm<fade, 4> vm_type;
+
+static std::size_t compile(char const* text, uint8_t* out, std::size_t capacity,
+                           show_script_error& error) {
+    return compile_show_script(text, std::strlen(text), out, capacity, error);
+}
+
+// Channels wired to mock level pins
+struct vm_rig {
+    vm_rig() : fades{fade(pins[0], 0), fade(pins[1], 0), fade(pins[2], 0), fade(pins[3], 0)} {
+        for (std::size_t c = 0; c < 4; ++c) {
+            vm.bind(c, fades[c]);
+        }
+    }
+
+    bool load(char const* text) {
+        show_script_error error;
+        size = compile(text, bytecode, sizeof(bytecode), error);
+        return size != 0 && vm.load(bytecode, size);
+    }
+
+    mock_level_pin pins[4];
+    fade fades[4];
+    vm_type vm;
+    uint8_t bytecode[256];
+    std::size_t size;
+};
+
+// Test the text form compiles to the documented compact encoding
+TEST(show_vm_test, compiles_script_to_compact_bytecode) {
+    char const* const script =
+        "# porch\n"
+        "channel porch 2\n"
+        "level porch on\n"
+        "  fade 1 128 1.5s   # slow\n"
+        "repeat 3\n"
+        "  blink 0 100ms 300 64\n"
+        "  wait 1s\n"
+        "end\n"
+        "wait trigger 5\n";
+    uint8_t bytecode[64];
+    show_script_error error;
+    std::size_t const size = compile(script, bytecode, sizeof(bytecode), error);
+    uint8_t const expected[] = {'S', 'V', 1,                   // Header
+                                1,   2,   255,                 // level 2 255
+                                2,   1,   128, 0xDC, 0x0B,     // fade 1 128 1500
+                                6,   3,                        // repeat 3
+                                3,   0,   64,  100,  0xAC, 2,  // blink 0 64 100 300
+                                5,   0xE8, 7,                  // wait 1000
+                                7,                             // end
+                                8,   5,                        // wait trigger 5
+                                0};                            // halt
+    ASSERT_EQ(size, sizeof(expected)) << error.line << ": " << error.message;
+    EXPECT_EQ(std::memcmp(bytecode, expected, size), 0);
+}
+
+// Test errors name the line and the problem
+TEST(show_vm_test, reports_errors_with_line) {
+    struct bad_script {
+        char const* text;
+        uint32_t line;
+    };
+    bad_script const scripts[] = {
+        {"level 0 10\nlevel 0 256\n", 2},
+        {"fade 0 10\n", 1},
+        {"wait 1.2345s\n", 1},
+        {"blink 0 0 100\n", 1},
+        {"\n\nlevel ghost 3\n", 3},
+        {"repeat 2\nwait 1\n", 2},
+        {"end\n", 1},
+        {"loop\nlevel 0 on\nend\n", 3},
+        {"repeat 1\nrepeat 1\nrepeat 1\nrepeat 1\nrepeat 1\n", 5},
+        {"wait trigger 8\n", 1},
+        {"sparkle 0\n", 1},
+    };
+    for (std::size_t i = 0; i < sizeof(scripts) / sizeof(scripts[0]); ++i) {
+        uint8_t bytecode[64];
+        show_script_error error;
+        EXPECT_EQ(compile(scripts[i].text, bytecode, sizeof(bytecode), error), 0u) << i;
+        EXPECT_EQ(error.line, scripts[i].line) << i;
+        EXPECT_NE(error.message, nullptr) << i;
+    }
+
+    uint8_t small[8];
+    show_script_error error;
+    EXPECT_EQ(compile("wait 1\nwait 2\nwait 3\n", small, sizeof(small), error), 0u);
+    EXPECT_STREQ(error.message, "bytecode buffer full");
+}
+
+// Test levels, fades and waits land at their scheduled times
+TEST(show_vm_test, runs_levels_fades_and_waits) {
+    vm_rig rig;
+    ASSERT_TRUE(rig.load(
+        "level 0 on\n"
+        "wait 100\n"
+        "fade 1 200 1000\n"
+        "wait 2s\n"
+        "level 0 off\n"));
+    ASSERT_TRUE(rig.vm.start(1000));
+    rig.vm.update(1000);
+    EXPECT_EQ(rig.pins[0].get_level(), 255);
+    EXPECT_EQ(rig.pins[1].get_level(), 0);
+
+    rig.vm.update(1600);  // Fade started at 1100, half way
+    EXPECT_EQ(rig.pins[1].get_level(), 100);
+    rig.vm.update(2100);
+    EXPECT_EQ(rig.pins[1].get_level(), 200);
+    EXPECT_TRUE(rig.vm.is_running());
+
+    rig.vm.update(3099);
+    EXPECT_EQ(rig.pins[0].get_level(), 255);
+    rig.vm.update(3100);
+    EXPECT_EQ(rig.pins[0].get_level(), 0);
+    EXPECT_TRUE(rig.vm.is_halted());
+}
+
+// Test waits are scheduled from the previous wait, so late updates do not drift
+TEST(show_vm_test, late_updates_do_not_drift) {
+    vm_rig rig;
+    ASSERT_TRUE(rig.load(
+        "repeat 10\n"
+        "  level 0 on\n"
+        "  wait 50\n"
+        "  level 0 off\n"
+        "  wait 50\n"
+        "end\n"
+        "level 2 on\n"));
+    rig.vm.start(0);
+    for (uint32_t now = 0; now < 999; now += 37) {  // Late, irregular updates
+        rig.vm.update(now);
+        EXPECT_EQ(rig.pins[0].get_level(), now % 100 < 50 ? 255 : 0) << now;
+    }
+    rig.vm.update(999);
+    EXPECT_EQ(rig.pins[2].get_level(), 0);
+    rig.vm.update(1000);
+    EXPECT_EQ(rig.pins[2].get_level(), 255);
+    EXPECT_TRUE(rig.vm.is_halted());
+}
+
+// Test blinking runs on its own between instructions and stops on a new level
+TEST(show_vm_test, blink_runs_until_changed) {
+    vm_rig rig;
+    ASSERT_TRUE(rig.load(
+        "blink 3 100 300 90\n"
+        "wait 10s\n"
+        "level 3 20\n"));
+    rig.vm.start(0);
+    for (uint32_t now = 0; now < 10000; now += 10) {
+        rig.vm.update(now);
+        ASSERT_EQ(rig.pins[3].get_level(), now % 400 < 100 ? 90 : 0) << now;
+    }
+    rig.vm.update(123456);  // Far behind: skips whole periods
+    EXPECT_FALSE(rig.vm.is_blinking(3));
+    EXPECT_EQ(rig.pins[3].get_level(), 20);
+}
+
+// Test a trigger resumes only the wait for it, at the trigger time
+TEST(show_vm_test, triggers_resume_waiting_script) {
+    vm_rig rig;
+    ASSERT_TRUE(rig.load(
+        "loop\n"
+        "  wait trigger 2\n"
+        "  level 0 on\n"
+        "  wait 500\n"
+        "  level 0 off\n"
+        "end\n"));
+    rig.vm.start(0);
+    rig.vm.update(10);
+    EXPECT_TRUE(rig.vm.is_waiting_for_trigger());
+    EXPECT_FALSE(rig.vm.trigger(1, 20));
+    EXPECT_TRUE(rig.vm.trigger(2, 5000));
+    EXPECT_FALSE(rig.vm.trigger(2, 5001));  // Already resumed
+    rig.vm.update(5100);
+    EXPECT_EQ(rig.pins[0].get_level(), 255);
+    rig.vm.update(5500);
+    EXPECT_EQ(rig.pins[0].get_level(), 0);
+    EXPECT_TRUE(rig.vm.is_waiting_for_trigger());  // Back for the next scare
+}
+
+// Test load() rejects malformed bytecode, and whatever it accepts runs safely
+TEST(show_vm_test, load_rejects_malformed_bytecode) {
+    vm_rig rig;
+    ASSERT_TRUE(rig.load("channel x 3\nrepeat 2\nfade x 9 70000\nwait 5\nend\n"));
+    for (std::size_t length = 0; length < rig.size; ++length) {
+        // Only the header alone and everything but the final halt are whole programs
+        EXPECT_EQ(rig.vm.load(rig.bytecode, length), length == 3 || length == rig.size - 1)
+            << length;
+    }
+    ASSERT_TRUE(rig.load("level 3 1\n"));
+    rig.bytecode[4] = 4;  // Channel beyond channels_v
+    EXPECT_FALSE(rig.vm.load(rig.bytecode, rig.size));
+    EXPECT_FALSE(rig.vm.start(0));
+
+    // Never-waiting forever loop: update() returns after its instruction budget
+    uint8_t const spin[] = {'S', 'V', 1, 6, 0, 1, 0, 7, 7, 7};
+    EXPECT_FALSE(rig.vm.load(spin, sizeof(spin)));  // Extra end
+    ASSERT_TRUE(rig.vm.load(spin, sizeof(spin) - 1));
+    rig.vm.start(0);
+    rig.vm.update(0);
+    EXPECT_EQ(rig.vm.get_op_count(), 64u);
+
+    std::srand(11);
+    uint8_t noise[32] = {'S', 'V', 1};
+    for (int i = 0; i < 20000; ++i) {
+        std::size_t const length = 3 + static_cast<std::size_t>(std::rand() % 29);
+        for (std::size_t k = 3; k < length; ++k) {
+            noise[k] = static_cast<uint8_t>(std::rand() % 10);
+        }
+        if (rig.vm.load(noise, length)) {
+            rig.vm.start(0);
+            for (uint32_t now = 0; now < 5000; now += 250) {
+                rig.vm.update(now);
+                rig.vm.trigger(static_cast<uint8_t>(now % 8), now);
+            }
+        }
+    }
+}
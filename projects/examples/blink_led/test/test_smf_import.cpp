@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "smf_import.h"
+
+// Builds SMF bytes: header, then tracks of (delta, event bytes)
+struct smf_builder {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> track;
+
+    smf_builder(uint16_t format, uint16_t tracks, uint16_t division) {
+        uint8_t const header[14] = {'M', 'T', 'h', 'd', 0, 0, 0, 6,
+                                    0, static_cast<uint8_t>(format),
+                                    static_cast<uint8_t>(tracks >> 8),
+                                    static_cast<uint8_t>(tracks),
+                                    static_cast<uint8_t>(division >> 8),
+                                    static_cast<uint8_t>(division)};
+        bytes.assign(header, header + sizeof(header));
+    }
+
+    void delta(uint32_t ticks) {
+        uint8_t groups[5];
+        int count = 0;
+        do {
+            groups[count++] = ticks & 0x7F;
+            ticks >>= 7;
+        } while (ticks != 0);
+        while (count > 1) {
+            track.push_back(groups[--count] | 0x80);
+        }
+        track.push_back(groups[0]);
+    }
+
+    void event(uint32_t ticks, std::vector<uint8_t> const& data) {
+        delta(ticks);
+        track.insert(track.end(), data.begin(), data.end());
+    }
+
+    void tempo(uint32_t ticks, uint32_t us_per_quarter) {
+        event(ticks, {0xFF, 0x51, 0x03, static_cast<uint8_t>(us_per_quarter >> 16),
+                      static_cast<uint8_t>(us_per_quarter >> 8),
+                      static_cast<uint8_t>(us_per_quarter)});
+    }
+
+    void end_track(bool with_meta = true) {
+        if (with_meta) {
+            event(0, {0xFF, 0x2F, 0x00});
+        }
+        uint32_t const size = static_cast<uint32_t>(track.size());
+        uint8_t const chunk[8] = {'M', 'T', 'r', 'k', static_cast<uint8_t>(size >> 24),
+                                  static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 8),
+                                  static_cast<uint8_t>(size)};
+        bytes.insert(bytes.end(), chunk, chunk + sizeof(chunk));
+        bytes.insert(bytes.end(), track.begin(), track.end());
+        track.clear();
+    }
+};
+
+static std::vector<midi_cue> import_all(smf_importer<>& importer,
+                                        std::vector<uint8_t> const& file) {
+    std::size_t count = 0;
+    EXPECT_TRUE(importer.import(file.data(), file.size(), nullptr, 0, count));
+    std::vector<midi_cue> cues(count);
+    std::size_t written = 0;
+    EXPECT_TRUE(importer.import(file.data(), file.size(), cues.data(), cues.size(), written));
+    EXPECT_EQ(written, count);
+    return cues;
+}
+
+// Test channel events, running status and the default 120 BPM tempo
+TEST(smf_import_test, imports_channel_events) {
+    smf_builder smf(0, 1, 480);
+    smf.event(0, {0x90, 60, 100});  // Note on, channel 0
+    smf.event(480, {60, 0});        // Running status, velocity 0 = note off
+    smf.event(0, {0xB3, 7, 90});    // CC 7 on channel 3
+    smf.event(240, {0xC3, 5});      // Program change
+    smf.event(0, {0xE0, 0, 64});    // Pitch bend: skipped
+    smf.event(240, {0x80, 61, 0});
+    smf.end_track();
+
+    smf_importer<> importer;
+    std::vector<midi_cue> const cues = import_all(importer, smf.bytes);
+    EXPECT_EQ(importer.get_format(), 0u);
+    EXPECT_EQ(importer.get_division(), 480u);
+    ASSERT_EQ(cues.size(), 5u);
+    EXPECT_EQ(cues[0].type, midi_cue_type::note_on);
+    EXPECT_EQ(cues[0].number, 60);
+    EXPECT_EQ(cues[0].value, 100);
+    EXPECT_EQ(cues[0].time_ms, 0u);
+    EXPECT_EQ(cues[1].type, midi_cue_type::note_off);
+    EXPECT_EQ(cues[1].time_ms, 500u);
+    EXPECT_EQ(cues[2].type, midi_cue_type::control_change);
+    EXPECT_EQ(cues[2].channel, 3);
+    EXPECT_EQ(cues[2].number, 7);
+    EXPECT_EQ(cues[2].value, 90);
+    EXPECT_EQ(cues[3].type, midi_cue_type::program_change);
+    EXPECT_EQ(cues[3].number, 5);
+    EXPECT_EQ(cues[3].time_ms, 750u);
+    EXPECT_EQ(cues[4].time_ms, 1000u);
+    EXPECT_EQ(cues[0].cue, MIDI_CUE_NONE);
+    EXPECT_EQ(importer.get_skipped(), 1u);  // Pitch bend
+}
+
+// Test format 1 tracks are merged into time order through a tempo change
+TEST(smf_import_test, merges_tracks_through_tempo_changes) {
+    smf_builder smf(1, 3, 96);
+    smf.tempo(0, 500000);    // 120 BPM
+    smf.tempo(192, 1000000);  // 60 BPM from beat 2 (1000 ms)
+    smf.end_track();
+    smf.event(96, {0x90, 1, 1});   // 500 ms
+    smf.event(192, {0x90, 2, 1});  // tick 288: 1000 + 96 ticks at 60 BPM = 2000 ms
+    smf.end_track();
+    smf.event(96, {0x91, 3, 1});   // 500 ms, after track 1's event at the same tick
+    smf.event(96, {0x91, 4, 1});   // tick 192: 1000 ms
+    smf.end_track();
+
+    smf_importer<> importer;
+    std::vector<midi_cue> const cues = import_all(importer, smf.bytes);
+    ASSERT_EQ(cues.size(), 4u);
+    EXPECT_EQ(cues[0].number, 1);
+    EXPECT_EQ(cues[0].time_ms, 500u);
+    EXPECT_EQ(cues[1].number, 3);
+    EXPECT_EQ(cues[1].time_ms, 500u);
+    EXPECT_EQ(cues[2].number, 4);
+    EXPECT_EQ(cues[2].time_ms, 1000u);
+    EXPECT_EQ(cues[3].number, 2);
+    EXPECT_EQ(cues[3].time_ms, 2000u);
+
+    smf_tempo_map<512> const& map = importer.get_tempo_map();
+    EXPECT_EQ(map.get_segment_count(), 2u);
+    EXPECT_EQ(map.tick_to_ms(96), 500u);
+    EXPECT_EQ(map.tick_to_ms(480), 4000u);
+}
+
+// Test MSC SysEx becomes show-control cues with their cue numbers
+TEST(smf_import_test, imports_show_control) {
+    smf_builder smf(0, 1, 480);
+    // F0 <len> 7F <device 1> 02 <lighting 01> GO "12.5" F7
+    smf.event(960, {0xF0, 0x0A, 0x7F, 0x01, 0x02, 0x01, MSC_GO, '1', '2', '.', '5', 0xF7});
+    smf.event(0, {0xF0, 0x06, 0x7F, 0x01, 0x02, 0x01, MSC_ALL_OFF, 0xF7});
+    smf.event(0, {0xF0, 0x04, 0x7E, 0x01, 0x06, 0xF7});  // Non-MSC SysEx: skipped
+    smf.end_track();
+
+    smf_importer<> importer;
+    std::vector<midi_cue> const cues = import_all(importer, smf.bytes);
+    ASSERT_EQ(cues.size(), 2u);
+    EXPECT_EQ(cues[0].type, midi_cue_type::show_control);
+    EXPECT_EQ(cues[0].time_ms, 1000u);
+    EXPECT_EQ(cues[0].channel, 1);
+    EXPECT_EQ(cues[0].value, 1);
+    EXPECT_EQ(cues[0].number, MSC_GO);
+    EXPECT_EQ(cues[0].cue, 12500u);
+    EXPECT_EQ(cues[1].number, MSC_ALL_OFF);
+    EXPECT_EQ(cues[1].cue, MIDI_CUE_NONE);
+}
+
+// Test SMPTE division: 25 fps x 40 ticks per frame = 1 ms per tick
+TEST(smf_import_test, smpte_division) {
+    smf_builder smf(0, 1, 0xE728);
+    smf.tempo(0, 1000000);  // Ignored in SMPTE time
+    smf.event(1234, {0x90, 1, 1});
+    smf.end_track();
+
+    smf_importer<> importer;
+    std::vector<midi_cue> const cues = import_all(importer, smf.bytes);
+    ASSERT_EQ(cues.size(), 1u);
+    EXPECT_EQ(cues[0].time_ms, 1234u);
+}
+
+// Test hundreds of odd tempos: every tick maps to the exact rational time
+TEST(smf_import_test, tick_times_do_not_drift) {
+    uint16_t const division = 96;
+    smf_builder smf(1, 2, division);
+    uint32_t const SEGMENTS = 500;
+    std::vector<uint32_t> tempos;
+    for (uint32_t i = 0; i < SEGMENTS; ++i) {
+        tempos.push_back(333333 + i * 7919 % 200000);  // Not a multiple of the division
+        smf.tempo(i == 0 ? 0 : 37, tempos.back());
+    }
+    smf.end_track();
+    for (uint32_t i = 0; i < SEGMENTS * 37; ++i) {
+        smf.event(i == 0 ? 0 : 1, {0xB0, 1, static_cast<uint8_t>(i & 0x7F)});
+    }
+    smf.end_track();
+
+    smf_importer<32, 512> importer;
+    std::size_t count = 0;
+    std::vector<midi_cue> cues(SEGMENTS * 37);
+    ASSERT_TRUE(importer.import(smf.bytes.data(), smf.bytes.size(), cues.data(), cues.size(),
+                                count));
+    ASSERT_EQ(count, cues.size());
+
+    // Reference: exact sum of per-tick lengths in 1/division microseconds
+    uint64_t elapsed = 0;
+    for (uint32_t tick = 0; tick < count; ++tick) {
+        uint64_t const expected_ms = (elapsed + division * 500) / (division * 1000);
+        ASSERT_EQ(cues[tick].time_ms, expected_ms) << "tick " << tick;
+        ASSERT_EQ(importer.get_tempo_map().tick_to_ms(tick), expected_ms);
+        elapsed += tempos[tick / 37];
+    }
+}
+
+// Test malformed and unsupported files are rejected
+TEST(smf_import_test, rejects_bad_files) {
+    smf_builder smf(0, 1, 480);
+    smf.event(0, {0x90, 60, 100});
+    smf.end_track();
+    smf_importer<> importer;
+    std::size_t count = 0;
+    ASSERT_TRUE(importer.import(smf.bytes.data(), smf.bytes.size(), nullptr, 0, count));
+    midi_cue one;
+    EXPECT_TRUE(importer.import(smf.bytes.data(), smf.bytes.size(), &one, 1, count));
+    EXPECT_FALSE(importer.import(smf.bytes.data(), smf.bytes.size(), &one, 0, count));  // Full
+
+    std::vector<uint8_t> bad = smf.bytes;
+    bad[0] = 'X';
+    EXPECT_FALSE(importer.import(bad.data(), bad.size(), nullptr, 0, count));
+    bad = smf.bytes;
+    bad[9] = 2;  // Format 2
+    EXPECT_FALSE(importer.import(bad.data(), bad.size(), nullptr, 0, count));
+    bad = smf.bytes;
+    bad.resize(bad.size() - 2);  // Track shorter than its chunk header says
+    EXPECT_FALSE(importer.import(bad.data(), bad.size(), nullptr, 0, count));
+
+    smf_builder truncated(0, 1, 480);
+    truncated.event(0, {0x90, 60});  // Missing velocity
+    truncated.end_track(false);
+    EXPECT_FALSE(importer.import(truncated.bytes.data(), truncated.bytes.size(), nullptr, 0,
+                                 count));
+
+    smf_builder orphan(0, 1, 480);
+    orphan.event(0, {60, 100});  // Data bytes with no running status
+    orphan.end_track();
+    EXPECT_FALSE(importer.import(orphan.bytes.data(), orphan.bytes.size(), nullptr, 0, count));
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "blink_controller.h"
+#include "mock_hardware.h"
+#include "sound_mixer.h"
+#include "wav_file.h"
+
+typedef sound_mixer<4, 64> small_mixer;
+
+static sound_clip make_clip(std::vector<int16_t> const& samples, uint16_t channels = 1) {
+    sound_clip clip;
+    clip.samples = samples.data();
+    clip.frames = static_cast<uint32_t>(samples.size() / channels);
+    clip.channels = channels;
+    return clip;
+}
+
+static std::vector<int16_t> render(small_mixer& mixer, std::size_t frames, std::size_t chunk) {
+    std::vector<int16_t> out(frames * mixer.get_channels());
+    for (std::size_t done = 0; done < frames; done += chunk) {
+        std::size_t const n = frames - done < chunk ? frames - done : chunk;
+        mixer.render(&out[done * mixer.get_channels()], n);
+    }
+    return out;
+}
+
+// Test the SIMD mix kernel matches the scalar reference exactly
+TEST(mix_kernel_test, simd_matches_scalar) {
+    std::vector<int16_t> samples(1027);
+    std::srand(11);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<int16_t>(std::rand() % 65536 - 32768);
+    }
+    samples[3] = -32768;
+    int16_t const gains[5] = {0, 1, MIXER_UNITY_GAIN, 12345, 32767};
+    for (int g = 0; g < 5; ++g) {
+        for (std::size_t length = 0; length < 40; ++length) {
+            std::vector<int32_t> simd(length, 7);
+            std::vector<int32_t> scalar(length, 7);
+            mix_gain(simd.data(), samples.data() + 1, length, gains[g]);
+            mix_gain_scalar(scalar.data(), samples.data() + 1, length, gains[g]);
+            ASSERT_EQ(simd, scalar) << "gain " << gains[g] << " length " << length;
+        }
+    }
+    std::vector<int32_t> unity(samples.size(), 0);
+    mix_gain(unity.data(), samples.data(), samples.size(), MIXER_UNITY_GAIN);
+    EXPECT_EQ(unity[3], -32768);
+    EXPECT_EQ(unity[100], samples[100]);
+}
+
+// Test saturation clamps and counts clipped samples on both paths
+TEST(mix_kernel_test, saturates_and_counts_clipping) {
+    int32_t acc[19];
+    for (int i = 0; i < 19; ++i) {
+        acc[i] = (i % 3 == 0) ? 40000 : ((i % 3 == 1) ? -40000 : i * 100);
+    }
+    int16_t out[19];
+    EXPECT_EQ(mix_saturate(out, acc, 19), 13u);
+    EXPECT_EQ(out[0], 32767);
+    EXPECT_EQ(out[1], -32768);
+    EXPECT_EQ(out[2], 200);
+    EXPECT_EQ(out[18], 32767);  // Scalar tail
+}
+
+// Test a trigger lands on its exact frame inside a block, and late ones start at once
+TEST(sound_mixer_test, triggers_are_sample_accurate) {
+    std::vector<int16_t> const impulse = {1000, 2000};
+    small_mixer mixer(44100, 1);
+    mixer.start(500);
+    uint32_t const voice = mixer.trigger(make_clip(impulse), 503);  // 132.3 frames: 133
+    ASSERT_NE(voice, small_mixer::NO_VOICE);
+    EXPECT_TRUE(mixer.is_playing(voice));
+    std::vector<int16_t> const out = render(mixer, 200, 10);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        int16_t const expected = i == 133 ? 1000 : (i == 134 ? 2000 : 0);
+        ASSERT_EQ(out[i], expected) << "frame " << i;
+    }
+    EXPECT_FALSE(mixer.is_playing(voice));
+    EXPECT_EQ(mixer.get_time_ms(), 504u);
+
+    mixer.trigger(make_clip(impulse), 501);  // Already rendered
+    EXPECT_EQ(mixer.get_late(), 1u);
+    int16_t block[2];
+    mixer.render(block, 2);
+    EXPECT_EQ(block[0], 1000);
+    EXPECT_EQ(block[1], 2000);
+}
+
+// Test overlaps sum in 32 bits and clip once, independent of voice order
+TEST(sound_mixer_test, mixes_with_saturation) {
+    std::vector<int16_t> const loud(8, 30000);
+    std::vector<int16_t> const inverted(8, -30000);
+    small_mixer mixer(8000, 1);
+    mixer.start(0);
+    mixer.trigger(make_clip(loud), 0);
+    mixer.trigger(make_clip(loud), 0);
+    std::vector<int16_t> out = render(mixer, 8, 8);
+    EXPECT_EQ(out[0], 32767);
+    EXPECT_EQ(mixer.get_clipped(), 8u);
+
+    mixer.trigger(make_clip(loud), 1);
+    mixer.trigger(make_clip(loud), 1);
+    mixer.trigger(make_clip(inverted), 1);
+    out = render(mixer, 8, 8);
+    EXPECT_EQ(out[0], 30000);  // Not 32767 - 30000
+    EXPECT_EQ(mixer.get_clipped(), 8u);
+}
+
+// Test gain ramps are linear per frame and stop() frees the voice after its fade
+TEST(sound_mixer_test, ramps_gain_and_stops) {
+    std::vector<int16_t> const dc(1000, 16384);
+    small_mixer mixer(8000, 1);
+    mixer.start(0);
+    uint32_t const voice = mixer.trigger(make_clip(dc), 0);
+    ASSERT_TRUE(mixer.set_gain(voice, 0, 10));  // 80 frames
+    std::vector<int16_t> out = render(mixer, 100, 7);
+    EXPECT_EQ(out[0], 16384);
+    EXPECT_NEAR(out[40], 8192, 1);
+    for (std::size_t i = 1; i < 80; ++i) {
+        ASSERT_LT(out[i], out[i - 1]);
+    }
+    EXPECT_EQ(out[80], 0);
+    EXPECT_TRUE(mixer.is_playing(voice));  // Silent, still playing
+
+    ASSERT_TRUE(mixer.set_gain(voice, 32767, 0));  // Just under +6 dB, at once
+    out = render(mixer, 1, 1);
+    EXPECT_EQ(out[0], 32767);
+    ASSERT_TRUE(mixer.stop(voice, 5));  // 40 frames
+    out = render(mixer, 39, 39);
+    EXPECT_TRUE(mixer.is_playing(voice));
+    out = render(mixer, 1, 1);
+    EXPECT_FALSE(mixer.is_playing(voice));
+    EXPECT_FALSE(mixer.set_gain(voice, MIXER_UNITY_GAIN, 0));  // Stale handle
+}
+
+// Test voice exhaustion and channel mismatches are refused
+TEST(sound_mixer_test, refuses_when_busy_or_mismatched) {
+    std::vector<int16_t> const clip(100, 1);
+    small_mixer mixer(8000, 2);
+    mixer.start(0);
+    EXPECT_EQ(mixer.trigger(make_clip(clip, 1), 0), small_mixer::NO_VOICE);
+    for (int v = 0; v < 4; ++v) {
+        EXPECT_NE(mixer.trigger(make_clip(clip, 2), 0), small_mixer::NO_VOICE);
+    }
+    EXPECT_EQ(mixer.trigger(make_clip(clip, 2), 0), small_mixer::NO_VOICE);
+    EXPECT_EQ(mixer.get_dropped(), 1u);
+    EXPECT_EQ(mixer.get_active(), 4u);
+    render(mixer, 50, 50);
+    EXPECT_EQ(mixer.get_active(), 0u);
+}
+
+// Test a show loop on the mixer clock: a click on every LED ON edge, rendered to WAV
+TEST(sound_mixer_test, clicks_follow_blink_edges_into_wav) {
+    std::vector<int16_t> const click = {20000, -20000, 20000, -20000};  // Stereo
+    sound_mixer<8, 256> mixer(48000, 2);
+    mixer.start(0);
+    mock_pin pin;
+    blink_controller<mock_pin> blink(pin, 250, 250);
+
+    char path[] = "/tmp/sound_mixer_testXXXXXX";
+    int const fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+    wav_format format;
+    format.encoding = wav_format::IEEE_FLOAT;
+    format.channels = 2;
+    format.sample_rate = 48000;
+    wav_writer writer;
+    ASSERT_TRUE(writer.open(path, format));
+
+    int16_t block[48 * 2];  // 1 ms
+    bool was_on = false;
+    while (mixer.get_time_ms() < 1000) {
+        uint32_t const now = mixer.get_time_ms();
+        blink.update(now);
+        if (pin.get_state() && !was_on) {
+            mixer.trigger(make_clip(click, 2), now);
+        }
+        was_on = pin.get_state();
+        mixer.render(block, 48);
+        ASSERT_TRUE(writer.write(block, 48));
+    }
+    EXPECT_EQ(writer.get_frames_written(), 48000u);
+    ASSERT_TRUE(writer.close());
+
+    wav_reader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.get_format().encoding, format.encoding);
+    std::vector<int16_t> audio(48000 * 2 + 2);
+    ASSERT_EQ(reader.read(audio.data(), 48001), 48000u);  // Length patched on close
+    ::unlink(path);
+    std::vector<std::size_t> onsets;
+    for (std::size_t f = 0; f < 48000; ++f) {
+        if (audio[2 * f] == 20000 && audio[2 * f + 1] == -20000) {
+            onsets.push_back(f);
+        }
+    }
+    ASSERT_EQ(onsets.size(), 4u);  // Two clicks of two frames
+    EXPECT_EQ(onsets[0], 250u * 48);
+    EXPECT_EQ(onsets[2], 750u * 48);
+}
+
+// Test a streamed WAV through a pipe keeps the unknown length and reads to the end
+TEST(wav_writer_test, streams_to_pipe) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    wav_format format;
+    format.encoding = wav_format::PCM;
+    format.channels = 1;
+    format.sample_rate = 22050;
+    wav_writer writer;
+    ASSERT_TRUE(writer.open_fd(fds[1], format));
+    int16_t const samples[3] = {-32768, 0, 32767};
+    ASSERT_TRUE(writer.write(samples, 3));
+    writer.close();
+    ::close(fds[1]);
+
+    wav_reader reader;
+    ASSERT_TRUE(reader.open_fd(fds[0]));
+    int16_t frames[8] = {};
+    EXPECT_EQ(reader.read(frames, 8), 3u);
+    EXPECT_EQ(frames[0], -32768);
+    EXPECT_EQ(frames[2], 32767);
+    EXPECT_EQ(reader.read(frames, 8), 0u);
+    ::close(fds[0]);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include "tick_jitter.h"
+
+// Test empty histogram
+TEST(tick_jitter_histogram_test, empty_histogram_reports_zero) {
+    tick_jitter_histogram jitter;
+
+    EXPECT_EQ(jitter.get_count(), 0);
+    EXPECT_EQ(jitter.get_max_us(), 0);
+    EXPECT_EQ(jitter.percentile_us(99.0), 0);
+    EXPECT_DOUBLE_EQ(jitter.get_mean_us(), 0.0);
+}
+
+// Test count, mean and max
+TEST(tick_jitter_histogram_test, tracks_count_mean_and_max) {
+    tick_jitter_histogram jitter;
+    jitter.record(10);
+    jitter.record(20);
+    jitter.record(90);
+
+    EXPECT_EQ(jitter.get_count(), 3);
+    EXPECT_EQ(jitter.get_max_us(), 90);
+    EXPECT_DOUBLE_EQ(jitter.get_mean_us(), 40.0);
+}
+
+// Test percentiles resolve to bucket upper bounds
+TEST(tick_jitter_histogram_test, percentiles_use_bucket_resolution) {
+    tick_jitter_histogram jitter;
+    for (int i = 0; i < 99; ++i) {
+        jitter.record(2);  // bucket [0, 5)
+    }
+    jitter.record(503);  // bucket [500, 505)
+
+    EXPECT_EQ(jitter.percentile_us(50.0), 4);
+    EXPECT_EQ(jitter.percentile_us(98.0), 4);
+    EXPECT_EQ(jitter.percentile_us(100.0), 503);  // Clamped to the exact max
+}
+
+// Test lateness beyond the histogram range lands in overflow
+TEST(tick_jitter_histogram_test, overflow_reports_exact_max) {
+    tick_jitter_histogram jitter;
+    jitter.record(1);
+    jitter.record(50000);
+
+    EXPECT_EQ(jitter.get_overflow_count(), 1);
+    EXPECT_EQ(jitter.percentile_us(100.0), 50000);
+}
+
+// Test reset clears everything
+TEST(tick_jitter_histogram_test, reset_clears_state) {
+    tick_jitter_histogram jitter;
+    jitter.record(100);
+    jitter.reset();
+
+    EXPECT_EQ(jitter.get_count(), 0);
+    EXPECT_EQ(jitter.get_max_us(), 0);
+    EXPECT_EQ(jitter.get_overflow_count(), 0);
+}
+
+// Test ticker holds an absolute schedule
+TEST(periodic_ticker_test, ticks_follow_period) {
+    periodic_ticker ticker(std::chrono::milliseconds(2));
+    EXPECT_EQ(ticker.get_period(), std::chrono::milliseconds(2));
+
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        ticker.wait_next();
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+
+    // 10 ticks of 2ms: at least 18ms (first deadline set at construction)
+    EXPECT_GE(elapsed, std::chrono::milliseconds(18));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(200));
+}
+
+// Test missed deadlines skip ahead instead of bursting
+TEST(periodic_ticker_test, missed_deadline_skips_ahead) {
+    periodic_ticker ticker(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // First wakeup is late by roughly the sleep
+    EXPECT_GE(ticker.wait_next(), 15000u);
+
+    // Next one waits a full period rather than firing immediately
+    auto const start = std::chrono::steady_clock::now();
+    ticker.wait_next();
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(900));
+}
+
+// Test reset restarts the schedule
+TEST(periodic_ticker_test, reset_restarts_schedule) {
+    periodic_ticker ticker(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ticker.reset();
+
+    EXPECT_LT(ticker.wait_next(), 5000u);
+}
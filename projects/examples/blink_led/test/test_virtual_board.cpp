@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "fd_serial.h"
+#include "serial_protocol.h"
+#include "virtual_board.h"
+
+typedef std::chrono::steady_clock test_clock;
+
+static double elapsed_ms(test_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(test_clock::now() - start).count();
+}
+
+static std::vector<uint8_t> command_frame(serial_message type, uint8_t seq, uint8_t channel,
+                                          uint32_t on_ms = 0, uint32_t off_ms = 0) {
+    serial_frame_builder<> builder;
+    builder.begin(type, seq, channel);
+    if (type == serial_message::set_durations) {
+        builder.put_u32(on_ms);
+        builder.put_u32(off_ms);
+    }
+    uint8_t wire[serial_frame_builder<>::MAX_WIRE_SIZE];
+    std::size_t const length = builder.finish(wire, sizeof(wire));
+    return std::vector<uint8_t>(wire, wire + length);
+}
+
+// Read replies until count frames arrive or the timeout expires
+static std::size_t read_replies(fd_serial& host, serial_parser<>& parser, std::size_t count,
+                                int timeout_ms, serial_frame* last = nullptr) {
+    std::size_t received = 0;
+    test_clock::time_point const start = test_clock::now();
+    while (received < count && elapsed_ms(start) < timeout_ms) {
+        pollfd pfd = {host.get_fd(), POLLIN, 0};
+        ::poll(&pfd, 1, 5);
+        while (host.available() > 0) {
+            serial_frame frame;
+            if (parser.push(static_cast<uint8_t>(host.read()), frame)) {
+                ++received;
+                if (last != nullptr) {
+                    *last = frame;
+                }
+            }
+        }
+    }
+    return received;
+}
+
+// Test byte timing on the line model
+TEST(uart_line_model_test, bytes_queue_at_ten_bits_each) {
+    uart_line_model line(115200);
+    EXPECT_EQ(line.get_byte_time_ns(), 86805u);
+
+    EXPECT_EQ(line.schedule(1000), 1000 + 86805u);
+    EXPECT_EQ(line.schedule(1000), 1000 + 2 * 86805u);  // Behind the first byte
+    EXPECT_EQ(line.schedule(10000000), 10000000 + 86805u);  // Idle line starts fresh
+
+    uart_line_model ideal(0);
+    EXPECT_EQ(ideal.schedule(5), 5u);
+}
+
+// Test the virtual UART overruns like a fixed-size hardware ring
+TEST(virtual_uart_test, rx_buffer_overruns_when_full) {
+    virtual_uart uart(4);
+    for (uint8_t i = 0; i < 6; ++i) {
+        uart.deliver(i);
+    }
+    EXPECT_EQ(uart.available(), 4);
+    EXPECT_EQ(uart.get_overruns(), 2u);
+    EXPECT_EQ(uart.read(), 0);
+    EXPECT_EQ(uart.read(), 1);
+    uart.deliver(9);
+    EXPECT_EQ(uart.read(), 2);
+    EXPECT_EQ(uart.read(), 3);
+    EXPECT_EQ(uart.read(), 9);
+    EXPECT_EQ(uart.read(), -1);
+
+    uint8_t const reply[] = {1, 2, 3};
+    uart.write(reply, sizeof(reply));
+    uint8_t out[2];
+    EXPECT_EQ(uart.take_tx(out, sizeof(out)), 2u);
+    EXPECT_EQ(out[1], 2);
+    EXPECT_EQ(uart.take_tx(out, sizeof(out)), 1u);
+    EXPECT_EQ(out[0], 3);
+}
+
+// Stops the board's loop thread on scope exit; declare after the sketch so
+// the thread is joined before the sketch it runs is destroyed (ASSERTs too)
+struct board_stopper {
+    explicit board_stopper(virtual_board& board) : board_(board) {}
+    ~board_stopper() { board_.stop(); }
+
+    virtual_board& board_;
+};
+
+struct virtual_board_test : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        if (!board.open(115200)) {
+            GTEST_SKIP() << "no pty available";
+        }
+    }
+
+    void connect() {
+        fd = open_serial_device(board.get_device_path());
+        ASSERT_GE(fd, 0);
+    }
+
+    void TearDown() override {
+        board.close();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    virtual_board board;
+    int fd = -1;
+};
+
+// Test a command round trip through the device path, at wire speed
+TEST_F(virtual_board_test, query_round_trip_takes_wire_time) {
+    blink_board_sketch<4> sketch(board.get_serial(), 1000, 500);
+    board_stopper const stopper(board);
+    ASSERT_TRUE(board.start(&blink_board_sketch<4>::loop, &sketch));
+    connect();
+    fd_serial host(fd);
+    serial_parser<> parser;
+
+    std::vector<uint8_t> const set = command_frame(serial_message::set_durations, 1, 2, 300, 700);
+    ASSERT_EQ(host.write(set.data(), set.size()), set.size());
+    ASSERT_EQ(read_replies(host, parser, 1, 2000), 1u);
+
+    std::vector<uint8_t> const query = command_frame(serial_message::query, 2, 2);
+    test_clock::time_point const start = test_clock::now();
+    host.write(query.data(), query.size());
+    serial_frame reply;
+    ASSERT_EQ(read_replies(host, parser, 1, 2000, &reply), 1u);
+    double const rtt_ms = elapsed_ms(start);
+
+    EXPECT_EQ(reply.type, serial_message::state);
+    EXPECT_EQ(reply.seq, 2);
+    EXPECT_EQ(reply.read_u32(1), 300u);
+    EXPECT_EQ(reply.read_u32(5), 700u);
+
+    // 7-byte query + 20-byte state reply at 86.8 us per byte
+    EXPECT_GE(rtt_ms, 27 * 0.0868 * 0.95);
+    EXPECT_LT(rtt_ms, 500.0);
+
+    board.stop();
+    EXPECT_EQ(sketch.get_command_count(), 2u);
+    EXPECT_EQ(board.get_rx_overruns(), 0u);
+}
+
+// Test pipelined commands run at (not above) the line rate
+TEST_F(virtual_board_test, pipelined_throughput_is_line_limited) {
+    blink_board_sketch<8> sketch(board.get_serial(), 100, 100);
+    board_stopper const stopper(board);
+    ASSERT_TRUE(board.start(&blink_board_sketch<8>::loop, &sketch));
+    connect();
+    fd_serial host(fd);
+    serial_parser<> parser;
+
+    static std::size_t const COMMANDS = 100;
+    static std::size_t const WINDOW = 4;
+    std::size_t sent = 0;
+    std::size_t acked = 0;
+    std::size_t wire_bytes = 0;
+    test_clock::time_point const start = test_clock::now();
+    while (acked < COMMANDS && elapsed_ms(start) < 10000) {
+        while (sent < COMMANDS && sent - acked < WINDOW) {
+            std::vector<uint8_t> const frame =
+                command_frame(serial_message::set_durations, static_cast<uint8_t>(sent),
+                              static_cast<uint8_t>(sent % 8), 100 + sent, 200);
+            host.write(frame.data(), frame.size());
+            wire_bytes += frame.size();
+            ++sent;
+        }
+        acked += read_replies(host, parser, 1, 1000);
+    }
+    double const seconds = elapsed_ms(start) / 1000.0;
+    ASSERT_EQ(acked, COMMANDS);
+
+    double const line_rate = 11520.0 / (static_cast<double>(wire_bytes) / COMMANDS);
+    double const measured = COMMANDS / seconds;
+    EXPECT_LE(measured, line_rate * 1.02);
+    EXPECT_GE(measured, line_rate * 0.5);
+}
+
+// Test a board that polls too slowly overruns its 64-byte RX buffer
+TEST(virtual_board_overrun_test, slow_loop_overruns_rx_buffer) {
+    virtual_board board;
+    if (!board.open(1000000, 64)) {
+        GTEST_SKIP() << "no pty available";
+    }
+    blink_board_sketch<4> sketch(board.get_serial(), 100, 100);
+    board_stopper const stopper(board);
+    ASSERT_TRUE(board.start(&blink_board_sketch<4>::loop, &sketch, 50000));  // 50 ms loop
+    int const fd = open_serial_device(board.get_device_path());
+    ASSERT_GE(fd, 0);
+    fd_serial host(fd);
+
+    // 20 commands = 300 bytes, landing within 3 ms
+    std::vector<uint8_t> burst;
+    for (uint8_t i = 0; i < 20; ++i) {
+        std::vector<uint8_t> const frame =
+            command_frame(serial_message::set_durations, i, static_cast<uint8_t>(i % 4), 10, 10);
+        burst.insert(burst.end(), frame.begin(), frame.end());
+    }
+    host.write(burst.data(), burst.size());
+
+    test_clock::time_point const start = test_clock::now();
+    while (board.get_bytes_received() < burst.size() && elapsed_ms(start) < 2000) {
+        ::usleep(1000);
+    }
+    ::usleep(120000);  // Let the loop run at least twice more
+    board.stop();
+    ::close(fd);
+
+    EXPECT_GT(board.get_rx_overruns(), 0u);
+    EXPECT_LT(sketch.get_command_count(), 20u);
+}